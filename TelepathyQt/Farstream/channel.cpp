@@ -56,7 +56,7 @@ PendingChannel::PendingChannel(const CallChannelPtr &channel)
       mPriv(new PendingChannel::Private)
 {
     if (!channel->handlerStreamingRequired()) {
-        warning() << "Handler streaming not required";
+        TP_QT_WARNING() << "Handler streaming not required";
         setFinishedWithError(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Handler streaming not required"));
         return;
@@ -64,7 +64,7 @@ PendingChannel::PendingChannel(const CallChannelPtr &channel)
 
     TpDBusDaemon *dbus = tp_dbus_daemon_dup(nullptr);
     if (!dbus) {
-        warning() << "Unable to connect to D-Bus";
+        TP_QT_WARNING() << "Unable to connect to D-Bus";
         setFinishedWithError(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Unable to connect to D-Bus"));
         return;
@@ -72,7 +72,7 @@ PendingChannel::PendingChannel(const CallChannelPtr &channel)
 
     Tp::ConnectionPtr connection = channel->connection();
     if (connection.isNull()) {
-        warning() << "Connection not available";
+        TP_QT_WARNING() << "Connection not available";
         setFinishedWithError(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Connection not available"));
         g_object_unref(dbus);
@@ -82,7 +82,7 @@ PendingChannel::PendingChannel(const CallChannelPtr &channel)
     TpSimpleClientFactory *factory = (TpSimpleClientFactory *)
             tp_automatic_client_factory_new (dbus);
     if (!factory) {
-        warning() << "Unable to construct TpAutomaticClientFactory";
+        TP_QT_WARNING() << "Unable to construct TpAutomaticClientFactory";
         setFinishedWithError(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Unable to construct TpAutomaticClientFactory"));
         g_object_unref(dbus);
@@ -92,7 +92,7 @@ PendingChannel::PendingChannel(const CallChannelPtr &channel)
     TpConnection *gconnection = tp_simple_client_factory_ensure_connection (factory,
             connection->objectPath().toLatin1(), nullptr, nullptr);
     if (!gconnection) {
-        warning() << "Unable to construct TpConnection";
+        TP_QT_WARNING() << "Unable to construct TpConnection";
         setFinishedWithError(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Unable to construct TpConnection"));
         g_object_unref(factory);
@@ -113,7 +113,7 @@ PendingChannel::PendingChannel(const CallChannelPtr &channel)
     g_object_unref(gconnection);
     gconnection = nullptr;
     if (!gchannel) {
-        warning() << "Unable to construct TpChannel";
+        TP_QT_WARNING() << "Unable to construct TpChannel";
         setFinishedWithError(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Unable to construct TpChannel"));
         return;
@@ -136,7 +136,7 @@ void PendingChannel::Private::onTfChannelNewFinish(GObject *sourceObject,
     GError *error = nullptr;
     TfChannel *ret = tf_channel_new_finish(sourceObject, res, &error);
     if (error) {
-        warning() << "Fs::PendingChannel::Private::onTfChannelNewFinish: error " << error->message;
+        TP_QT_WARNING() << "Fs::PendingChannel::Private::onTfChannelNewFinish: error " << error->message;
         self->setFinishedWithError(TP_QT_ERROR_NOT_AVAILABLE, QLatin1String(error->message));
         g_clear_error(&error);
         return;
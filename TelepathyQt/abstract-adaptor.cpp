@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryService
+
 #include <TelepathyQt/AbstractAdaptor>
 
 #include "TelepathyQt/_gen/abstract-adaptor.moc.hpp"
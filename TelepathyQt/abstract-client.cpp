@@ -122,12 +122,14 @@ struct TP_QT_NO_EXPORT AbstractClientObserver::Private
 {
     Private(const ChannelClassList &channelFilter, bool shouldRecover)
         : channelFilter(channelFilter),
-          shouldRecover(shouldRecover)
+          shouldRecover(shouldRecover),
+          readinessTimeout(-1)
     {
     }
 
     ChannelClassList channelFilter;
     bool shouldRecover;
+    int readinessTimeout;
 };
 
 /**
@@ -343,6 +345,55 @@ bool AbstractClientObserver::shouldRecover() const
     return mPriv->shouldRecover;
 }
 
+/**
+ * Return how long, in milliseconds, the channels passed to observeChannels()
+ * are given to become ready before the observer is invoked with the ones that
+ * are ready.
+ *
+ * A negative value, which is the default, means that observeChannels() is
+ * only called once the account, the connection, all the channels, the channel
+ * dispatch operation and the channel requests are ready.
+ *
+ * \return The readiness timeout in milliseconds, or a negative value to wait
+ *         for all the objects.
+ * \sa setObserverReadinessTimeout()
+ */
+int AbstractClientObserver::observerReadinessTimeout() const
+{
+    return mPriv->readinessTimeout;
+}
+
+/**
+ * Set how long, in milliseconds, the objects passed to observeChannels() are
+ * given to become ready.
+ *
+ * The channel dispatcher, and every approver and handler behind it, waits for
+ * this observer to return from observeChannels(), so a single slow channel
+ * introspection delays all of them. With a non-negative \a msecs,
+ * observeChannels() is called as soon as everything is ready or, once \a msecs
+ * have passed, with only the channels, the channel dispatch operation and the
+ * channel requests which are ready by then. The rest is left out of the call,
+ * and a channel dispatch operation which is not ready is passed as a null
+ * pointer. The account and the connection are always ready when
+ * observeChannels() is called, as the call waits for them past the timeout if
+ * needed.
+ *
+ * In this mode the account and connection objects are also kept around by the
+ * client registrar until they are invalidated, so that the following
+ * invocations for the same account and connection don't need to introspect
+ * them again.
+ *
+ * This should be called before the observer is registered.
+ *
+ * \param msecs The readiness timeout in milliseconds, or a negative value to
+ *              wait for all the objects.
+ * \sa observerReadinessTimeout()
+ */
+void AbstractClientObserver::setObserverReadinessTimeout(int msecs)
+{
+    mPriv->readinessTimeout = msecs;
+}
+
 /**
  * \fn void AbstractClientObserver::observeChannels(
  *                  const MethodInvocationContextPtr<> &context,
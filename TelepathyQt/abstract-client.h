@@ -92,6 +92,8 @@ public:
 
     bool shouldRecover() const;
 
+    int observerReadinessTimeout() const;
+
     virtual void observeChannels(const MethodInvocationContextPtr<> &context,
             const AccountPtr &account,
             const ConnectionPtr &connection,
@@ -103,6 +105,8 @@ public:
 protected:
     AbstractClientObserver(const ChannelClassSpecList &channelFilter, bool shouldRecover = false);
 
+    void setObserverReadinessTimeout(int msecs);
+
 private:
     struct Private;
     friend struct Private;
@@ -176,7 +176,7 @@ void AbstractInterface::setMonitorProperties(bool monitorProperties)
     }
 
     if (!success) {
-        warning() << "Connection or disconnection to " << TP_QT_IFACE_PROPERTIES <<
+        TP_QT_WARNING() << "Connection or disconnection to " << TP_QT_IFACE_PROPERTIES <<
                 ".PropertiesChanged failed.";
     }
 }
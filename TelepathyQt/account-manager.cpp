@@ -103,18 +103,18 @@ AccountManager::Private::Private(AccountManager *parent,
       reintrospectionRetries(0),
       gotInitialAccounts(false)
 {
-    debug() << "Creating new AccountManager:" << parent->busName();
+    TP_QT_DEBUG() << "Creating new AccountManager:" << parent->busName();
 
     if (accFactory->dbusConnection().name() != parent->dbusConnection().name()) {
-        warning() << "  The D-Bus connection in the account factory is not the proxy connection";
+        TP_QT_WARNING() << "  The D-Bus connection in the account factory is not the proxy connection";
     }
 
     if (connFactory->dbusConnection().name() != parent->dbusConnection().name()) {
-        warning() << "  The D-Bus connection in the connection factory is not the proxy connection";
+        TP_QT_WARNING() << "  The D-Bus connection in the connection factory is not the proxy connection";
     }
 
     if (chanFactory->dbusConnection().name() != parent->dbusConnection().name()) {
-        warning() << "  The D-Bus connection in the channel factory is not the proxy connection";
+        TP_QT_WARNING() << "  The D-Bus connection in the channel factory is not the proxy connection";
     }
 
     ReadinessHelper::Introspectables introspectables;
@@ -155,7 +155,7 @@ void AccountManager::Private::init()
 
 void AccountManager::Private::introspectMain(AccountManager::Private *self)
 {
-    debug() << "Calling Properties::GetAll(AccountManager)";
+    TP_QT_DEBUG() << "Calling Properties::GetAll(AccountManager)";
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(
             self->properties->GetAll(
                 TP_QT_IFACE_ACCOUNT_MANAGER),
@@ -185,7 +185,7 @@ QSet<QString> AccountManager::Private::getAccountPathsFromProp(
          * an array of object paths? */
         QStringList wronglyTypedPaths = qdbus_cast<QStringList>(prop);
         if (wronglyTypedPaths.size() > 0) {
-            warning() << "AccountManager returned wrong type for"
+            TP_QT_WARNING() << "AccountManager returned wrong type for"
                 "Valid/InvalidAccounts (expected 'ao', got 'as'); "
                 "working around it";
             foreach (QString path, wronglyTypedPaths) {
@@ -623,7 +623,7 @@ AccountSetPtr AccountManager::offlineAccounts() const
 AccountSetPtr AccountManager::textChatAccounts() const
 {
     if (!accountFactory()->features().contains(Account::FeatureCapabilities)) {
-        warning() << "Account filtering by capabilities can only be used with an AccountFactory"
+        TP_QT_WARNING() << "Account filtering by capabilities can only be used with an AccountFactory"
             << "which makes Account::FeatureCapabilities ready";
         return filterAccounts(AccountFilterConstPtr());
     }
@@ -647,7 +647,7 @@ AccountSetPtr AccountManager::textChatAccounts() const
 AccountSetPtr AccountManager::textChatroomAccounts() const
 {
     if (!accountFactory()->features().contains(Account::FeatureCapabilities)) {
-        warning() << "Account filtering by capabilities can only be used with an AccountFactory"
+        TP_QT_WARNING() << "Account filtering by capabilities can only be used with an AccountFactory"
             << "which makes Account::FeatureCapabilities ready";
         return filterAccounts(AccountFilterConstPtr());
     }
@@ -671,7 +671,7 @@ AccountSetPtr AccountManager::textChatroomAccounts() const
 AccountSetPtr AccountManager::audioCallAccounts() const
 {
     if (!accountFactory()->features().contains(Account::FeatureCapabilities)) {
-        warning() << "Account filtering by capabilities can only be used with an AccountFactory"
+        TP_QT_WARNING() << "Account filtering by capabilities can only be used with an AccountFactory"
             << "which makes Account::FeatureCapabilities ready";
         return filterAccounts(AccountFilterConstPtr());
     }
@@ -695,7 +695,7 @@ AccountSetPtr AccountManager::audioCallAccounts() const
 AccountSetPtr AccountManager::videoCallAccounts() const
 {
     if (!accountFactory()->features().contains(Account::FeatureCapabilities)) {
-        warning() << "Account filtering by capabilities can only be used with an AccountFactory"
+        TP_QT_WARNING() << "Account filtering by capabilities can only be used with an AccountFactory"
             << "which makes Account::FeatureCapabilities ready";
         return filterAccounts(AccountFilterConstPtr());
     }
@@ -719,7 +719,7 @@ AccountSetPtr AccountManager::videoCallAccounts() const
 AccountSetPtr AccountManager::streamedMediaCallAccounts() const
 {
     if (!accountFactory()->features().contains(Account::FeatureCapabilities)) {
-        warning() << "Account filtering by capabilities can only be used with an AccountFactory"
+        TP_QT_WARNING() << "Account filtering by capabilities can only be used with an AccountFactory"
             << "which makes Account::FeatureCapabilities ready";
         return filterAccounts(AccountFilterConstPtr());
     }
@@ -743,7 +743,7 @@ AccountSetPtr AccountManager::streamedMediaCallAccounts() const
 AccountSetPtr AccountManager::streamedMediaAudioCallAccounts() const
 {
     if (!accountFactory()->features().contains(Account::FeatureCapabilities)) {
-        warning() << "Account filtering by capabilities can only be used with an AccountFactory"
+        TP_QT_WARNING() << "Account filtering by capabilities can only be used with an AccountFactory"
             << "which makes Account::FeatureCapabilities ready";
         return filterAccounts(AccountFilterConstPtr());
     }
@@ -767,7 +767,7 @@ AccountSetPtr AccountManager::streamedMediaAudioCallAccounts() const
 AccountSetPtr AccountManager::streamedMediaVideoCallAccounts() const
 {
     if (!accountFactory()->features().contains(Account::FeatureCapabilities)) {
-        warning() << "Account filtering by capabilities can only be used with an AccountFactory"
+        TP_QT_WARNING() << "Account filtering by capabilities can only be used with an AccountFactory"
             << "which makes Account::FeatureCapabilities ready";
         return filterAccounts(AccountFilterConstPtr());
     }
@@ -791,7 +791,7 @@ AccountSetPtr AccountManager::streamedMediaVideoCallAccounts() const
 AccountSetPtr AccountManager::streamedMediaVideoCallWithAudioAccounts() const
 {
     if (!accountFactory()->features().contains(Account::FeatureCapabilities)) {
-        warning() << "Account filtering by capabilities can only be used with an AccountFactory"
+        TP_QT_WARNING() << "Account filtering by capabilities can only be used with an AccountFactory"
             << "which makes Account::FeatureCapabilities ready";
         return filterAccounts(AccountFilterConstPtr());
     }
@@ -816,7 +816,7 @@ AccountSetPtr AccountManager::streamedMediaVideoCallWithAudioAccounts() const
 AccountSetPtr AccountManager::fileTransferAccounts() const
 {
     if (!accountFactory()->features().contains(Account::FeatureCapabilities)) {
-        warning() << "Account filtering by capabilities can only be used with an AccountFactory"
+        TP_QT_WARNING() << "Account filtering by capabilities can only be used with an AccountFactory"
             << "which makes Account::FeatureCapabilities ready";
         return filterAccounts(AccountFilterConstPtr());
     }
@@ -839,7 +839,7 @@ AccountSetPtr AccountManager::accountsByProtocol(
         const QString &protocolName) const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "Account filtering requires AccountManager to be ready";
+        TP_QT_WARNING() << "Account filtering requires AccountManager to be ready";
         return filterAccounts(AccountFilterConstPtr());
     }
 
@@ -865,7 +865,7 @@ AccountSetPtr AccountManager::accountsByProtocol(
 AccountSetPtr AccountManager::filterAccounts(const AccountFilterConstPtr &filter) const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "Account filtering requires AccountManager to be ready";
+        TP_QT_WARNING() << "Account filtering requires AccountManager to be ready";
         return AccountSetPtr(new AccountSet(AccountManagerPtr(
                         (AccountManager *) this), AccountFilterConstPtr()));
     }
@@ -921,7 +921,7 @@ AccountSetPtr AccountManager::filterAccounts(const AccountFilterConstPtr &filter
 AccountSetPtr AccountManager::filterAccounts(const QVariantMap &filter) const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "Account filtering requires AccountManager to be ready";
+        TP_QT_WARNING() << "Account filtering requires AccountManager to be ready";
         return AccountSetPtr(new AccountSet(AccountManagerPtr(
                         (AccountManager *) this), QVariantMap()));
     }
@@ -1057,7 +1057,7 @@ void AccountManager::gotMainProperties(QDBusPendingCallWatcher *watcher)
     if (!reply.isError()) {
         mPriv->gotInitialAccounts = true;
 
-        debug() << "Got reply to Properties.GetAll(AccountManager)";
+        TP_QT_DEBUG() << "Got reply to Properties.GetAll(AccountManager)";
         props = reply.value();
 
         if (props.contains(QLatin1String("Interfaces"))) {
@@ -1084,7 +1084,7 @@ void AccountManager::gotMainProperties(QDBusPendingCallWatcher *watcher)
             }
             QTimer::singleShot(retryInterval, this, SLOT(introspectMain()));
         } else {
-            warning() << "GetAll(AccountManager) failed with" <<
+            TP_QT_WARNING() << "GetAll(AccountManager) failed with" <<
                 reply.error().name() << ":" << reply.error().message();
             mPriv->readinessHelper->setIntrospectCompleted(FeatureCore,
                     false, reply.error());
@@ -1132,7 +1132,7 @@ void AccountManager::onAccountValidityChanged(const QDBusObjectPath &objectPath,
 
     if (!mPriv->incompleteAccounts.contains(path) &&
         !mPriv->accounts.contains(path)) {
-        debug() << "New account" << path;
+        TP_QT_DEBUG() << "New account" << path;
         mPriv->addAccountForPath(path);
     }
 }
@@ -1150,17 +1150,17 @@ void AccountManager::onAccountRemoved(const QDBusObjectPath &objectPath)
         mPriv->accounts.remove(path);
 
         if (isReady(FeatureCore)) {
-            debug() << "Account" << path << "removed";
+            TP_QT_DEBUG() << "Account" << path << "removed";
         } else {
-            debug() << "Account" << path << "removed while the AM "
+            TP_QT_DEBUG() << "Account" << path << "removed while the AM "
                 "was not completely introspected";
         }
     } else if (mPriv->incompleteAccounts.contains(path)) {
         mPriv->incompleteAccounts.remove(path);
-        debug() << "Account" << path << "was removed, but it was "
+        TP_QT_DEBUG() << "Account" << path << "was removed, but it was "
             "not completely introspected, ignoring";
     } else {
-        debug() << "Got AccountRemoved for unknown account" << path << ", ignoring";
+        TP_QT_DEBUG() << "Got AccountRemoved for unknown account" << path << ", ignoring";
     }
 }
 
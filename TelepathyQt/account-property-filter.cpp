@@ -24,9 +24,14 @@
 
 #include "TelepathyQt/debug-internal.h"
 
+#include <QByteArray>
 #include <QLatin1String>
-#include <QStringList>
+#include <QList>
 #include <QMetaObject>
+#include <QMetaProperty>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
 #include <QVariantMap>
 
 namespace Tp
@@ -39,15 +44,56 @@ struct TP_QT_NO_EXPORT AccountPropertyFilter::Private
         if (supportedAccountProperties.isEmpty()) {
             const QMetaObject metaObject = Account::staticMetaObject;
             for (int i = metaObject.propertyOffset(); i < metaObject.propertyCount(); ++i) {
-                supportedAccountProperties << QLatin1String(metaObject.property(i).name());
+                supportedAccountProperties.insert(QLatin1String(metaObject.property(i).name()));
             }
         }
     }
 
-    static QStringList supportedAccountProperties;
+    struct CompiledProperty
+    {
+        QMetaProperty property;
+        QByteArray name;
+        QVariant value;
+    };
+
+    QList<CompiledProperty> compiledFilter(const QVariantMap &filter);
+
+    static QSet<QString> supportedAccountProperties;
+
+    // The filter the compiled properties were resolved from. As QVariantMap is
+    // implicitly shared, any change to the filter detaches it from this copy.
+    QVariantMap compiledFrom;
+    QList<CompiledProperty> compiled;
+    QMutex compiledMutex;
 };
 
-QStringList AccountPropertyFilter::Private::supportedAccountProperties;
+QList<AccountPropertyFilter::Private::CompiledProperty> AccountPropertyFilter::Private::compiledFilter(
+        const QVariantMap &filter)
+{
+    // matches() may be called from several threads on a shared filter
+    QMutexLocker locker(&compiledMutex);
+
+    if (!filter.isSharedWith(compiledFrom)) {
+        // Resolve the property names to meta properties once, instead of looking
+        // them up by name on every match
+        compiled.clear();
+        for (QVariantMap::const_iterator i = filter.constBegin(); i != filter.constEnd(); ++i) {
+            CompiledProperty property;
+            property.name = i.key().toLatin1();
+            int index = Account::staticMetaObject.indexOfProperty(property.name.constData());
+            if (index >= 0) {
+                property.property = Account::staticMetaObject.property(index);
+            }
+            property.value = i.value();
+            compiled.append(property);
+        }
+        compiledFrom = filter;
+    }
+
+    return compiled;
+}
+
+QSet<QString> AccountPropertyFilter::Private::supportedAccountProperties;
 
 /**
  * \class Tp::AccountPropertyFilter
@@ -79,9 +125,9 @@ bool AccountPropertyFilter::isValid() const
     QVariantMap::const_iterator i = mFilter.constBegin();
     QVariantMap::const_iterator end = mFilter.constEnd();
     while (i != end) {
-        QString propertyName = i.key();
+        const QString &propertyName = i.key();
         if (!mPriv->supportedAccountProperties.contains(propertyName)) {
-            warning() << "Invalid filter key" << propertyName <<
+            TP_QT_WARNING() << "Invalid filter key" << propertyName <<
                 "while filtering account by properties";
             return false;
         }
@@ -91,4 +137,18 @@ bool AccountPropertyFilter::isValid() const
     return true;
 }
 
+bool AccountPropertyFilter::matches(const AccountPtr &account) const
+{
+    QList<Private::CompiledProperty> compiled = mPriv->compiledFilter(filter());
+    foreach (const Private::CompiledProperty &property, compiled) {
+        QVariant value = property.property.isValid() ?
+            property.property.read(account.data()) : account->property(property.name.constData());
+        if (value != property.value) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 } // Tp
@@ -46,6 +46,8 @@ public:
 
     bool isValid() const override;
 
+    bool matches(const AccountPtr &account) const override;
+
 private:
     AccountPropertyFilter();
 
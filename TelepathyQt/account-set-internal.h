@@ -21,6 +21,9 @@
  */
 
 #include <TelepathyQt/AccountPropertyFilter>
+#include <TelepathyQt/GenericPropertyFilter>
+
+#include <QSet>
 
 namespace Tp
 {
@@ -44,10 +47,16 @@ struct TP_QT_NO_EXPORT AccountSet::Private
     void wrapAccount(const AccountPtr &account);
     void filterAccount(const AccountPtr &account);
     bool accountMatchFilter(AccountWrapper *account);
+    void collectFilterDependencies(const AccountFilterConstPtr &filter);
+    bool filterDependsOnProperty(const QString &propertyName) const;
 
     AccountSet *parent;
     AccountManagerPtr accountManager;
     AccountFilterConstPtr filter;
+    // What the filter looks at, so that only relevant account changes cause it to be re-evaluated
+    QSet<QString> dependentProperties;
+    bool filterDependsOnAllProperties;
+    bool filterDependsOnCapabilities;
     QHash<QString, AccountWrapper *> wrappers;
     QHash<QString, AccountPtr> accounts;
     bool ready;
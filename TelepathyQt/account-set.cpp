@@ -29,10 +29,14 @@
 #include "TelepathyQt/debug-internal.h"
 
 #include <TelepathyQt/Account>
+#include <TelepathyQt/AccountCapabilityFilter>
 #include <TelepathyQt/AccountFilter>
 #include <TelepathyQt/AccountManager>
+#include <TelepathyQt/AndFilter>
 #include <TelepathyQt/ConnectionCapabilities>
 #include <TelepathyQt/ConnectionManager>
+#include <TelepathyQt/NotFilter>
+#include <TelepathyQt/OrFilter>
 
 namespace Tp
 {
@@ -43,6 +47,8 @@ AccountSet::Private::Private(AccountSet *parent,
     : parent(parent),
       accountManager(accountManager),
       filter(filter),
+      filterDependsOnAllProperties(false),
+      filterDependsOnCapabilities(false),
       ready(false)
 {
     init();
@@ -53,6 +59,8 @@ AccountSet::Private::Private(AccountSet *parent,
         const QVariantMap &filterMap)
     : parent(parent),
       accountManager(accountManager),
+      filterDependsOnAllProperties(false),
+      filterDependsOnCapabilities(false),
       ready(false)
 {
     AccountPropertyFilterPtr propertyFilter = AccountPropertyFilter::create();
@@ -67,6 +75,7 @@ AccountSet::Private::Private(AccountSet *parent,
 void AccountSet::Private::init()
 {
     if (filter->isValid()) {
+        collectFilterDependencies(filter);
         connectSignals();
         insertAccounts();
         ready = true;
@@ -114,12 +123,16 @@ void AccountSet::Private::wrapAccount(const AccountPtr &account)
     parent->connect(wrapper,
             SIGNAL(accountRemoved(Tp::AccountPtr)),
             SLOT(onAccountRemoved(Tp::AccountPtr)));
-    parent->connect(wrapper,
-            SIGNAL(accountPropertyChanged(Tp::AccountPtr,QString)),
-            SLOT(onAccountChanged(Tp::AccountPtr)));
-    parent->connect(wrapper,
-            SIGNAL(accountCapabilitiesChanged(Tp::AccountPtr,Tp::ConnectionCapabilities)),
-            SLOT(onAccountChanged(Tp::AccountPtr)));
+    if (filterDependsOnAllProperties || !dependentProperties.isEmpty()) {
+        parent->connect(wrapper,
+                SIGNAL(accountPropertyChanged(Tp::AccountPtr,QString)),
+                SLOT(onAccountPropertyChanged(Tp::AccountPtr,QString)));
+    }
+    if (filterDependsOnCapabilities) {
+        parent->connect(wrapper,
+                SIGNAL(accountCapabilitiesChanged(Tp::AccountPtr,Tp::ConnectionCapabilities)),
+                SLOT(onAccountChanged(Tp::AccountPtr)));
+    }
     wrappers.insert(account->objectPath(), wrapper);
 }
 
@@ -156,6 +169,105 @@ bool AccountSet::Private::accountMatchFilter(AccountWrapper *wrapper)
     return filter->matches(wrapper->account());
 }
 
+void AccountSet::Private::collectFilterDependencies(const AccountFilterConstPtr &filter)
+{
+    if (!filter) {
+        return;
+    }
+
+    SharedPtr<const GenericPropertyFilter<Account> > propertyFilter =
+        SharedPtr<const GenericPropertyFilter<Account> >::dynamicCast(filter);
+    if (propertyFilter) {
+        // Account properties whose changes are signalled through Account::propertyChanged(),
+        // keep in sync with the notify() calls in Account::Private
+        static const char *notifiedProperties[] = {
+            "serviceName", "profile", "displayName", "iconName", "nickname",
+            "normalizedName", "valid", "enabled", "connectsAutomatically", "hasBeenOnline",
+            "parameters", "automaticPresence", "currentPresence", "online",
+            "requestedPresence", "changingPresence", "connectionStatus",
+            "connectionStatusReason", "connectionError", "connectionErrorDetails",
+            "connection", "connectionObjectPath", "avatar", 0
+        };
+        // Account properties fixed for the lifetime of an account
+        static const char *constantProperties[] = {
+            "cmName", "protocolName", "uniqueIdentifier", 0
+        };
+
+        foreach (const QString &propertyName, propertyFilter->filter().keys()) {
+            if (propertyName == QLatin1String("capabilities")) {
+                filterDependsOnCapabilities = true;
+                continue;
+            }
+
+            bool notified = false;
+            for (int i = 0; notifiedProperties[i]; ++i) {
+                if (propertyName == QLatin1String(notifiedProperties[i])) {
+                    notified = true;
+                    break;
+                }
+            }
+
+            bool constant = false;
+            for (int i = 0; constantProperties[i]; ++i) {
+                if (propertyName == QLatin1String(constantProperties[i])) {
+                    constant = true;
+                    break;
+                }
+            }
+
+            if (constant) {
+                continue;
+            } else if (notified) {
+                dependentProperties.insert(propertyName);
+            } else {
+                // no dedicated change notification, so re-evaluate on any change
+                filterDependsOnAllProperties = true;
+                filterDependsOnCapabilities = true;
+            }
+        }
+        return;
+    }
+
+    if (AccountCapabilityFilterConstPtr::dynamicCast(filter)) {
+        filterDependsOnCapabilities = true;
+        return;
+    }
+
+    SharedPtr<const AndFilter<Account> > andFilter =
+        SharedPtr<const AndFilter<Account> >::dynamicCast(filter);
+    if (andFilter) {
+        foreach (const AccountFilterConstPtr &subFilter, andFilter->filters()) {
+            collectFilterDependencies(subFilter);
+        }
+        return;
+    }
+
+    SharedPtr<const OrFilter<Account> > orFilter =
+        SharedPtr<const OrFilter<Account> >::dynamicCast(filter);
+    if (orFilter) {
+        foreach (const AccountFilterConstPtr &subFilter, orFilter->filters()) {
+            collectFilterDependencies(subFilter);
+        }
+        return;
+    }
+
+    SharedPtr<const NotFilter<Account> > notFilter =
+        SharedPtr<const NotFilter<Account> >::dynamicCast(filter);
+    if (notFilter) {
+        collectFilterDependencies(notFilter->filter());
+        return;
+    }
+
+    // a custom filter may look at anything
+    filterDependsOnAllProperties = true;
+    filterDependsOnCapabilities = true;
+}
+
+bool AccountSet::Private::filterDependsOnProperty(const QString &propertyName) const
+{
+    return filterDependsOnAllProperties || dependentProperties.contains(propertyName);
+}
+
 AccountSet::Private::AccountWrapper::AccountWrapper(
         const AccountPtr &account, QObject *parent)
     : QObject(parent),
@@ -415,4 +527,12 @@ void AccountSet::onAccountChanged(const AccountPtr &account)
     mPriv->filterAccount(account);
 }
 
+void AccountSet::onAccountPropertyChanged(const AccountPtr &account,
+        const QString &propertyName)
+{
+    if (mPriv->filterDependsOnProperty(propertyName)) {
+        mPriv->filterAccount(account);
+    }
+}
+
 } // Tp
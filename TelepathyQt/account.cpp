@@ -29,6 +29,7 @@
 #include "TelepathyQt/debug-internal.h"
 
 #include "TelepathyQt/connection-internal.h"
+#include "TelepathyQt/connection-manager-internal.h"
 
 #include <TelepathyQt/AccountManager>
 #include <TelepathyQt/Channel>
@@ -503,12 +504,12 @@ QVariantMap contactSearchRequest(const ConnectionCapabilities &capabilities,
         request.insert(TP_QT_IFACE_CHANNEL_TYPE_CONTACT_SEARCH + QLatin1String(".Server"),
                        server);
     } else if (!server.isEmpty()) {
-        warning() << "Ignoring Server parameter for contact search, since the protocol does not support it.";
+        TP_QT_WARNING() << "Ignoring Server parameter for contact search, since the protocol does not support it.";
     }
     if (capabilities.contactSearchesWithLimit()) {
         request.insert(TP_QT_IFACE_CHANNEL_TYPE_CONTACT_SEARCH + QLatin1String(".Limit"), limit);
     } else if (limit > 0) {
-        warning() << "Ignoring Limit parameter for contact search, since the protocol does not support it.";
+        TP_QT_WARNING() << "Ignoring Limit parameter for contact search, since the protocol does not support it.";
     }
     return request;
 }
@@ -645,7 +646,7 @@ Account::Private::Private(Account *parent, const ConnectionFactoryConstPtr &conn
         cmName = rx.cap(1);
         protocolName = rx.cap(2).replace(QLatin1Char('_'), QLatin1Char('-'));
     } else {
-        warning() << "Account object path is not spec-compliant, "
+        TP_QT_WARNING() << "Account object path is not spec-compliant, "
             "trying again with a different account-specific part check";
 
         rx = QRegExp(QLatin1String("^") + TP_QT_ACCOUNT_OBJECT_PATH_BASE +
@@ -657,7 +658,7 @@ Account::Private::Private(Account *parent, const ConnectionFactoryConstPtr &conn
             cmName = rx.cap(1);
             protocolName = rx.cap(2).replace(QLatin1Char('_'), QLatin1Char('-'));
         } else {
-            warning() << "Not a valid Account object path:" <<
+            TP_QT_WARNING() << "Not a valid Account object path:" <<
                 parent->objectPath();
         }
     }
@@ -700,12 +701,12 @@ Account::Private::Private(Account *parent, const ConnectionFactoryConstPtr &conn
     readinessHelper->addIntrospectables(introspectables);
 
     if (connFactory->dbusConnection().name() != parent->dbusConnection().name()) {
-        warning() << "  The D-Bus connection in the conn factory is not the proxy connection for"
+        TP_QT_WARNING() << "  The D-Bus connection in the conn factory is not the proxy connection for"
             << parent->objectPath();
     }
 
     if (chanFactory->dbusConnection().name() != parent->dbusConnection().name()) {
-        warning() << "  The D-Bus connection in the channel factory is not the proxy connection for"
+        TP_QT_WARNING() << "  The D-Bus connection in the channel factory is not the proxy connection for"
             << parent->objectPath();
     }
 
@@ -1231,7 +1232,7 @@ PendingOperation *Account::setServiceName(const QString &value)
 ProfilePtr Account::profile() const
 {
     if (!isReady(FeatureProfile)) {
-        warning() << "Account::profile() requires Account::FeatureProfile to be ready";
+        TP_QT_WARNING() << "Account::profile() requires Account::FeatureProfile to be ready";
         return ProfilePtr();
     }
 
@@ -1245,7 +1246,7 @@ ProfilePtr Account::profile() const
                             mPriv->protocolName,
                             protocolInfo()));
             } else {
-                warning() << "Cannot create profile as neither a .profile is installed for service" <<
+                TP_QT_WARNING() << "Cannot create profile as neither a .profile is installed for service" <<
                     serviceName() << "nor protocol info can be retrieved";
             }
         }
@@ -1417,7 +1418,7 @@ AvatarSpec Account::avatarRequirements() const
 const Avatar &Account::avatar() const
 {
     if (!isReady(Features() << FeatureAvatar)) {
-        warning() << "Trying to retrieve avatar from account, but "
+        TP_QT_WARNING() << "Trying to retrieve avatar from account, but "
                      "avatar is not supported or was not requested. "
                      "Use becomeReady(FeatureAvatar)";
     }
@@ -1502,7 +1503,7 @@ PendingStringList *Account::updateParameters(const QVariantMap &set,
 ProtocolInfo Account::protocolInfo() const
 {
     if (!isReady(Features() << FeatureProtocolInfo)) {
-        warning() << "Trying to retrieve protocol info from account, but "
+        TP_QT_WARNING() << "Trying to retrieve protocol info from account, but "
                      "protocol info is not supported or was not requested. "
                      "Use becomeReady(FeatureProtocolInfo)";
         return ProtocolInfo();
@@ -1529,7 +1530,7 @@ ProtocolInfo Account::protocolInfo() const
 ConnectionCapabilities Account::capabilities() const
 {
     if (!isReady(FeatureCapabilities)) {
-        warning() << "Trying to retrieve capabilities from account, but "
+        TP_QT_WARNING() << "Trying to retrieve capabilities from account, but "
                      "FeatureCapabilities was not requested. "
                      "Use becomeReady(FeatureCapabilities)";
         return ConnectionCapabilities();
@@ -4204,7 +4205,7 @@ void Account::Private::introspectMain(Account::Private *self)
     }
 
     if (!self->dispatcherContext->introspectOp) {
-        debug() << "Discovering if the Channel Dispatcher supports request hints";
+        TP_QT_DEBUG() << "Discovering if the Channel Dispatcher supports request hints";
         self->dispatcherContext->introspectOp =
             self->dispatcherContext->iface->requestPropertySupportsRequestHints();
     }
@@ -4217,7 +4218,7 @@ void Account::Private::introspectMain(Account::Private *self)
 
 void Account::Private::introspectAvatar(Account::Private *self)
 {
-    debug() << "Calling GetAvatar(Account)";
+    TP_QT_DEBUG() << "Calling GetAvatar(Account)";
     // we already checked if avatar interface exists, so bypass avatar interface
     // checking
     Client::AccountInterfaceAvatarInterface *iface =
@@ -4237,9 +4238,12 @@ void Account::Private::introspectProtocolInfo(Account::Private *self)
 {
     Q_ASSERT(!self->cm);
 
-    self->cm = ConnectionManager::create(
-            self->parent->dbusConnection(), self->cmName,
-            self->connFactory, self->chanFactory, self->contactFactory);
+    // All the accounts on the same CM share one ConnectionManager, so that it is
+    // only introspected once. The account never uses it to request connections,
+    // so it doesn't matter which account's factories it was created with.
+    self->cm = ConnectionManagerRegistry::forConnection(self->parent->dbusConnection())->
+        connectionManager(self->cmName, self->connFactory, self->chanFactory,
+                self->contactFactory);
     self->parent->connect(self->cm->becomeReady(),
             SIGNAL(finished(Tp::PendingOperation*)),
             SLOT(onConnectionManagerReady(Tp::PendingOperation*)));
@@ -4260,11 +4264,11 @@ void Account::Private::introspectCapabilities(Account::Private *self)
 
 void Account::Private::updateProperties(const QVariantMap &props)
 {
-    debug() << "Account::updateProperties: changed:";
+    TP_QT_DEBUG() << "Account::updateProperties: changed:";
 
     if (props.contains(QLatin1String("Interfaces"))) {
         parent->setInterfaces(qdbus_cast<QStringList>(props[QLatin1String("Interfaces")]));
-        debug() << " Interfaces:" << parent->interfaces();
+        TP_QT_DEBUG() << " Interfaces:" << parent->interfaces();
     }
 
     QString oldIconName = parent->iconName();
@@ -4274,7 +4278,7 @@ void Account::Private::updateProperties(const QVariantMap &props)
         serviceName != qdbus_cast<QString>(props[QLatin1String("Service")])) {
         serviceNameChanged = true;
         serviceName = qdbus_cast<QString>(props[QLatin1String("Service")]);
-        debug() << " Service Name:" << parent->serviceName();
+        TP_QT_DEBUG() << " Service Name:" << parent->serviceName();
         /* use parent->serviceName() here as if the service name is empty we are going to use the
          * protocol name */
         emit parent->serviceNameChanged(parent->serviceName());
@@ -4293,7 +4297,7 @@ void Account::Private::updateProperties(const QVariantMap &props)
     if (props.contains(QLatin1String("DisplayName")) &&
         displayName != qdbus_cast<QString>(props[QLatin1String("DisplayName")])) {
         displayName = qdbus_cast<QString>(props[QLatin1String("DisplayName")]);
-        debug() << " Display Name:" << displayName;
+        TP_QT_DEBUG() << " Display Name:" << displayName;
         emit parent->displayNameChanged(displayName);
         parent->notify("displayName");
     }
@@ -4308,7 +4312,7 @@ void Account::Private::updateProperties(const QVariantMap &props)
 
         QString newIconName = parent->iconName();
         if (oldIconName != newIconName) {
-            debug() << " Icon:" << newIconName;
+            TP_QT_DEBUG() << " Icon:" << newIconName;
             emit parent->iconNameChanged(newIconName);
             parent->notify("iconName");
         }
@@ -4317,7 +4321,7 @@ void Account::Private::updateProperties(const QVariantMap &props)
     if (props.contains(QLatin1String("Nickname")) &&
         nickname != qdbus_cast<QString>(props[QLatin1String("Nickname")])) {
         nickname = qdbus_cast<QString>(props[QLatin1String("Nickname")]);
-        debug() << " Nickname:" << nickname;
+        TP_QT_DEBUG() << " Nickname:" << nickname;
         emit parent->nicknameChanged(nickname);
         parent->notify("nickname");
     }
@@ -4325,7 +4329,7 @@ void Account::Private::updateProperties(const QVariantMap &props)
     if (props.contains(QLatin1String("NormalizedName")) &&
         normalizedName != qdbus_cast<QString>(props[QLatin1String("NormalizedName")])) {
         normalizedName = qdbus_cast<QString>(props[QLatin1String("NormalizedName")]);
-        debug() << " Normalized Name:" << normalizedName;
+        TP_QT_DEBUG() << " Normalized Name:" << normalizedName;
         emit parent->normalizedNameChanged(normalizedName);
         parent->notify("normalizedName");
     }
@@ -4333,7 +4337,7 @@ void Account::Private::updateProperties(const QVariantMap &props)
     if (props.contains(QLatin1String("Valid")) &&
         valid != qdbus_cast<bool>(props[QLatin1String("Valid")])) {
         valid = qdbus_cast<bool>(props[QLatin1String("Valid")]);
-        debug() << " Valid:" << (valid ? "true" : "false");
+        TP_QT_DEBUG() << " Valid:" << (valid ? "true" : "false");
         emit parent->validityChanged(valid);
         parent->notify("valid");
     }
@@ -4341,7 +4345,7 @@ void Account::Private::updateProperties(const QVariantMap &props)
     if (props.contains(QLatin1String("Enabled")) &&
         enabled != qdbus_cast<bool>(props[QLatin1String("Enabled")])) {
         enabled = qdbus_cast<bool>(props[QLatin1String("Enabled")]);
-        debug() << " Enabled:" << (enabled ? "true" : "false");
+        TP_QT_DEBUG() << " Enabled:" << (enabled ? "true" : "false");
         emit parent->stateChanged(enabled);
         parent->notify("enabled");
     }
@@ -4351,7 +4355,7 @@ void Account::Private::updateProperties(const QVariantMap &props)
                 qdbus_cast<bool>(props[QLatin1String("ConnectAutomatically")])) {
         connectsAutomatically =
                 qdbus_cast<bool>(props[QLatin1String("ConnectAutomatically")]);
-        debug() << " Connects Automatically:" << (connectsAutomatically ? "true" : "false");
+        TP_QT_DEBUG() << " Connects Automatically:" << (connectsAutomatically ? "true" : "false");
         emit parent->connectsAutomaticallyPropertyChanged(connectsAutomatically);
         parent->notify("connectsAutomatically");
     }
@@ -4360,7 +4364,7 @@ void Account::Private::updateProperties(const QVariantMap &props)
         !hasBeenOnline &&
         qdbus_cast<bool>(props[QLatin1String("HasBeenOnline")])) {
         hasBeenOnline = true;
-        debug() << " HasBeenOnline changed to true";
+        TP_QT_DEBUG() << " HasBeenOnline changed to true";
         // don't emit firstOnline unless we're already ready, that would be
         // misleading - we'd emit it just before any already-used account
         // became ready
@@ -4382,7 +4386,7 @@ void Account::Private::updateProperties(const QVariantMap &props)
                 props[QLatin1String("AutomaticPresence")])) {
         automaticPresence = Presence(qdbus_cast<SimplePresence>(
                 props[QLatin1String("AutomaticPresence")]));
-        debug() << " Automatic Presence:" << automaticPresence.type() <<
+        TP_QT_DEBUG() << " Automatic Presence:" << automaticPresence.type() <<
             "-" << automaticPresence.status();
         emit parent->automaticPresenceChanged(automaticPresence);
         parent->notify("automaticPresence");
@@ -4393,7 +4397,7 @@ void Account::Private::updateProperties(const QVariantMap &props)
                 props[QLatin1String("CurrentPresence")])) {
         currentPresence = Presence(qdbus_cast<SimplePresence>(
                 props[QLatin1String("CurrentPresence")]));
-        debug() << " Current Presence:" << currentPresence.type() <<
+        TP_QT_DEBUG() << " Current Presence:" << currentPresence.type() <<
             "-" << currentPresence.status();
         emit parent->currentPresenceChanged(currentPresence);
         parent->notify("currentPresence");
@@ -4406,7 +4410,7 @@ void Account::Private::updateProperties(const QVariantMap &props)
                 props[QLatin1String("RequestedPresence")])) {
         requestedPresence = Presence(qdbus_cast<SimplePresence>(
                 props[QLatin1String("RequestedPresence")]));
-        debug() << " Requested Presence:" << requestedPresence.type() <<
+        TP_QT_DEBUG() << " Requested Presence:" << requestedPresence.type() <<
             "-" << requestedPresence.status();
         emit parent->requestedPresenceChanged(requestedPresence);
         parent->notify("requestedPresence");
@@ -4417,7 +4421,7 @@ void Account::Private::updateProperties(const QVariantMap &props)
                 props[QLatin1String("ChangingPresence")])) {
         changingPresence = qdbus_cast<bool>(
                 props[QLatin1String("ChangingPresence")]);
-        debug() << " Changing Presence:" << changingPresence;
+        TP_QT_DEBUG() << " Changing Presence:" << changingPresence;
         emit parent->changingPresence(changingPresence);
         parent->notify("changingPresence");
     }
@@ -4425,12 +4429,12 @@ void Account::Private::updateProperties(const QVariantMap &props)
     if (props.contains(QLatin1String("Connection"))) {
         QString path = qdbus_cast<QDBusObjectPath>(props[QLatin1String("Connection")]).path();
         if (path.isEmpty()) {
-            debug() << " The map contains \"Connection\" but it's empty as a QDBusObjectPath!";
-            debug() << " Trying QString (known bug in some MC/dbus-glib versions)";
+            TP_QT_DEBUG() << " The map contains \"Connection\" but it's empty as a QDBusObjectPath!";
+            TP_QT_DEBUG() << " Trying QString (known bug in some MC/dbus-glib versions)";
             path = qdbus_cast<QString>(props[QLatin1String("Connection")]);
         }
 
-        debug() << " Connection Object Path:" << path;
+        TP_QT_DEBUG() << " Connection Object Path:" << path;
         if (path == QLatin1String("/")) {
             path = QString();
         }
@@ -4457,7 +4461,7 @@ void Account::Private::updateProperties(const QVariantMap &props)
                     qdbus_cast<uint>(props[QLatin1String("ConnectionStatus")]))) {
             connectionStatus = ConnectionStatus(
                     qdbus_cast<uint>(props[QLatin1String("ConnectionStatus")]));
-            debug() << " Connection Status:" << connectionStatus;
+            TP_QT_DEBUG() << " Connection Status:" << connectionStatus;
             connectionStatusChanged = true;
         }
 
@@ -4466,7 +4470,7 @@ void Account::Private::updateProperties(const QVariantMap &props)
                     qdbus_cast<uint>(props[QLatin1String("ConnectionStatusReason")]))) {
             connectionStatusReason = ConnectionStatusReason(
                     qdbus_cast<uint>(props[QLatin1String("ConnectionStatusReason")]));
-            debug() << " Connection StatusReason:" << connectionStatusReason;
+            TP_QT_DEBUG() << " Connection StatusReason:" << connectionStatusReason;
             connectionStatusChanged = true;
         }
 
@@ -4480,7 +4484,7 @@ void Account::Private::updateProperties(const QVariantMap &props)
                 props[QLatin1String("ConnectionError")])) {
             connectionError = qdbus_cast<QString>(
                     props[QLatin1String("ConnectionError")]);
-            debug() << " Connection Error:" << connectionError;
+            TP_QT_DEBUG() << " Connection Error:" << connectionError;
             connectionStatusChanged = true;
         }
 
@@ -4489,7 +4493,7 @@ void Account::Private::updateProperties(const QVariantMap &props)
                 props[QLatin1String("ConnectionErrorDetails")])) {
             connectionErrorDetails = Connection::ErrorDetails(qdbus_cast<QVariantMap>(
                     props[QLatin1String("ConnectionErrorDetails")]));
-            debug() << " Connection Error Details:" << connectionErrorDetails.allDetails();
+            TP_QT_DEBUG() << " Connection Error Details:" << connectionErrorDetails.allDetails();
             connectionStatusChanged = true;
         }
 
@@ -4543,7 +4547,7 @@ bool Account::Private::processConnQueue()
         QString path = connObjPathQueue.head();
         if (path.isEmpty()) {
             if (!connection.isNull()) {
-                debug() << "Dropping connection for account" << parent->objectPath();
+                TP_QT_DEBUG() << "Dropping connection for account" << parent->objectPath();
 
                 connection.reset();
                 emit parent->connectionChanged(connection);
@@ -4553,10 +4557,10 @@ bool Account::Private::processConnQueue()
 
             connObjPathQueue.dequeue();
         } else {
-            debug() << "Building connection" << path << "for account" << parent->objectPath();
+            TP_QT_DEBUG() << "Building connection" << path << "for account" << parent->objectPath();
 
             if (connection && connection->objectPath() == path) {
-                debug() << "  Connection already built";
+                TP_QT_DEBUG() << "  Connection already built";
                 connObjPathQueue.dequeue();
                 continue;
             }
@@ -4587,13 +4591,13 @@ void Account::onDispatcherIntrospected(Tp::PendingOperation *op)
 
         if (pv->isValid()) {
             mPriv->dispatcherContext->supportsHints = qdbus_cast<bool>(pv->result());
-            debug() << "Discovered channel dispatcher support for request hints: "
+            TP_QT_DEBUG() << "Discovered channel dispatcher support for request hints: "
                 << mPriv->dispatcherContext->supportsHints;
         } else {
             if (pv->errorName() == TP_QT_ERROR_NOT_IMPLEMENTED) {
-                debug() << "Channel Dispatcher does not implement support for request hints";
+                TP_QT_DEBUG() << "Channel Dispatcher does not implement support for request hints";
             } else {
-                warning() << "(Too old?) Channel Dispatcher failed to tell us whether"
+                TP_QT_WARNING() << "(Too old?) Channel Dispatcher failed to tell us whether"
                     << "it supports request hints, assuming it doesn't:"
                     << pv->errorName() << ':' << pv->errorMessage();
             }
@@ -4601,7 +4605,7 @@ void Account::onDispatcherIntrospected(Tp::PendingOperation *op)
         }
     }
 
-    debug() << "Calling Properties::GetAll(Account) on " << objectPath();
+    TP_QT_DEBUG() << "Calling Properties::GetAll(Account) on " << objectPath();
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(
             mPriv->properties->GetAll(
                 TP_QT_IFACE_ACCOUNT), this);
@@ -4615,23 +4619,23 @@ void Account::gotMainProperties(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<QVariantMap> reply = *watcher;
 
     if (!reply.isError()) {
-        debug() << "Got reply to Properties.GetAll(Account) for" << objectPath();
+        TP_QT_DEBUG() << "Got reply to Properties.GetAll(Account) for" << objectPath();
         mPriv->updateProperties(reply.value());
 
         mPriv->readinessHelper->setInterfaces(interfaces());
         mPriv->mayFinishCore = true;
 
         if (mPriv->connObjPathQueue.isEmpty()) {
-            debug() << "Account basic functionality is ready";
+            TP_QT_DEBUG() << "Account basic functionality is ready";
             mPriv->coreFinished = true;
             mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, true);
         } else {
-            debug() << "Deferring finishing Account::FeatureCore until the connection is built";
+            TP_QT_DEBUG() << "Deferring finishing Account::FeatureCore until the connection is built";
         }
     } else {
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, false, reply.error());
 
-        warning().nospace() <<
+        TP_QT_WARNING().nospace() <<
             "GetAll(Account) failed: " <<
             reply.error().name() << ": " << reply.error().message();
     }
@@ -4644,7 +4648,7 @@ void Account::gotAvatar(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<QVariant> reply = *watcher;
 
     if (!reply.isError()) {
-        debug() << "Got reply to GetAvatar(Account)";
+        TP_QT_DEBUG() << "Got reply to GetAvatar(Account)";
         mPriv->avatar = qdbus_cast<Avatar>(reply);
 
         // It could be in either of actual or missing from the first time in corner cases like the
@@ -4667,7 +4671,7 @@ void Account::gotAvatar(QDBusPendingCallWatcher *watcher)
             mPriv->readinessHelper->setIntrospectCompleted(FeatureAvatar, false, reply.error());
         }
 
-        warning().nospace() <<
+        TP_QT_WARNING().nospace() <<
             "GetAvatar(Account) failed: " <<
             reply.error().name() << ": " << reply.error().message();
     }
@@ -4677,7 +4681,7 @@ void Account::gotAvatar(QDBusPendingCallWatcher *watcher)
 
 void Account::onAvatarChanged()
 {
-    debug() << "Avatar changed, retrieving it";
+    TP_QT_DEBUG() << "Avatar changed, retrieving it";
     mPriv->retrieveAvatar();
 }
 
@@ -4692,7 +4696,7 @@ void Account::onConnectionManagerReady(PendingOperation *operation)
         mPriv->readinessHelper->setIntrospectCompleted(FeatureProtocolInfo, true);
     }
     else {
-        warning() << "Failed to find the protocol in the CM protocols for account" << objectPath();
+        TP_QT_WARNING() << "Failed to find the protocol in the CM protocols for account" << objectPath();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureProtocolInfo, false,
                 operation->errorName(), operation->errorMessage());
     }
@@ -4732,7 +4736,7 @@ void Account::onConnectionBuilt(PendingOperation *op)
     Q_ASSERT(readyOp != nullptr);
 
     if (op->isError()) {
-        warning() << "Building connection" << mPriv->connObjPathQueue.head() << "failed with" <<
+        TP_QT_WARNING() << "Building connection" << mPriv->connObjPathQueue.head() << "failed with" <<
             op->errorName() << "-" << op->errorMessage();
 
         if (!mPriv->connection.isNull()) {
@@ -4748,7 +4752,7 @@ void Account::onConnectionBuilt(PendingOperation *op)
         mPriv->connection = ConnectionPtr::qObjectCast(readyOp->proxy());
         Q_ASSERT(mPriv->connection);
 
-        debug() << "Connection" << mPriv->connectionObjectPath() << "built for" << objectPath();
+        TP_QT_DEBUG() << "Connection" << mPriv->connectionObjectPath() << "built for" << objectPath();
 
         if (prevConn != mPriv->connection) {
             notify("connection");
@@ -4763,7 +4767,7 @@ void Account::onConnectionBuilt(PendingOperation *op)
     mPriv->connObjPathQueue.dequeue();
 
     if (mPriv->processConnQueue() && !mPriv->coreFinished && mPriv->mayFinishCore) {
-        debug() << "Account" << objectPath() << "basic functionality is ready (connections built)";
+        TP_QT_DEBUG() << "Account" << objectPath() << "basic functionality is ready (connections built)";
         mPriv->coreFinished = true;
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, true);
     }
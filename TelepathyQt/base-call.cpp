@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryService
+
 #include <TelepathyQt/BaseCall>
 #include <TelepathyQt/BaseChannel>
 #include "TelepathyQt/base-call-internal.h"
@@ -62,7 +64,7 @@ BaseCallContent::Adaptee::Adaptee(const QDBusConnection &dbusConnection,
     : QObject(content),
       mContent(content)
 {
-    debug() << "Creating service::CallContentAdaptor for " << content->dbusObject();
+    TP_QT_DEBUG() << "Creating service::CallContentAdaptor for " << content->dbusObject();
     mAdaptor = new Service::CallContentAdaptor(dbusConnection, this, content->dbusObject());
 }
 
@@ -176,14 +178,14 @@ bool BaseCallContent::registerObject(DBusError *error)
     QString busName = mPriv->channel->busName();
     QString objectPath = QString(QLatin1String("%1/%2"))
                          .arg(mPriv->channel->objectPath(), name);
-    debug() << "Registering Content: busName: " << busName << " objectName: " << objectPath;
+    TP_QT_DEBUG() << "Registering Content: busName: " << busName << " objectName: " << objectPath;
     DBusError _error;
 
-    debug() << "CallContent: registering interfaces  at " << dbusObject();
+    TP_QT_DEBUG() << "CallContent: registering interfaces  at " << dbusObject();
     foreach(const AbstractCallContentInterfacePtr & iface, mPriv->interfaces) {
         if (!iface->registerInterface(dbusObject())) {
             // lets not fail if an optional interface fails registering, lets warn only
-            warning() << "Unable to register interface" << iface->interfaceName();
+            TP_QT_WARNING() << "Unable to register interface" << iface->interfaceName();
         }
     }
 
@@ -211,24 +213,24 @@ QList<AbstractCallContentInterfacePtr> BaseCallContent::interfaces() const
 bool BaseCallContent::plugInterface(const AbstractCallContentInterfacePtr &interface)
 {
     if (isRegistered()) {
-        warning() << "Unable to plug protocol interface " << interface->interfaceName() <<
+        TP_QT_WARNING() << "Unable to plug protocol interface " << interface->interfaceName() <<
                   "- protocol already registered";
         return false;
     }
 
     if (interface->isRegistered()) {
-        warning() << "Unable to plug protocol interface" << interface->interfaceName() <<
+        TP_QT_WARNING() << "Unable to plug protocol interface" << interface->interfaceName() <<
                   "- interface already registered";
         return false;
     }
 
     if (mPriv->interfaces.contains(interface->interfaceName())) {
-        warning() << "Unable to plug protocol interface" << interface->interfaceName() <<
+        TP_QT_WARNING() << "Unable to plug protocol interface" << interface->interfaceName() <<
                   "- another interface with same name already plugged";
         return false;
     }
 
-    debug() << "Interface" << interface->interfaceName() << "plugged";
+    TP_QT_DEBUG() << "Interface" << interface->interfaceName() << "plugged";
     mPriv->interfaces.insert(interface->interfaceName(), interface);
     return true;
 }
@@ -304,7 +306,7 @@ void BaseCallMuteInterface::setMuteState(const Tp::LocalMuteState &state)
 {
     if (mPriv->state != state) {
         mPriv->state = state;
-        QMetaObject::invokeMethod(mPriv->adaptee, "muteStateChanged", Q_ARG(uint, state));
+        emit mPriv->adaptee->muteStateChanged(state);
     }
 }
 
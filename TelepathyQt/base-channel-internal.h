@@ -200,6 +200,7 @@ private Q_SLOTS:
             const Tp::Service::ChannelTypeFileTransferAdaptor::AcceptFileContextPtr &context);
     void provideFile(uint addressType, uint accessControl, const QDBusVariant &accessControlParam,
             const Tp::Service::ChannelTypeFileTransferAdaptor::ProvideFileContextPtr &context);
+    void notifyTransferredBytes();
 
 Q_SIGNALS:
     void fileTransferStateChanged(uint state, uint reason);
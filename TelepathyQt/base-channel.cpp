@@ -22,6 +22,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryService
+
 #include <TelepathyQt/BaseChannel>
 #include <TelepathyQt/BaseCall>
 #include "TelepathyQt/base-channel-internal.h"
@@ -39,10 +41,17 @@
 #include <TelepathyQt/Utils>
 #include <TelepathyQt/AbstractProtocolInterface>
 
+#include <QCoreApplication>
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QLocalServer>
+#include <QMetaMethod>
+#include <QPointer>
 #include <QString>
 #include <QTcpServer>
 #include <QTcpSocket>
+#include <QTimer>
 #include <QVariantMap>
 
 namespace Tp
@@ -94,7 +103,7 @@ BaseChannel::Adaptee::Adaptee(const QDBusConnection &dbusConnection,
     : QObject(channel),
       mChannel(channel)
 {
-    debug() << "Creating service::channelAdaptor for " << channel->dbusObject();
+    TP_QT_DEBUG() << "Creating service::channelAdaptor for " << channel->dbusObject();
     mAdaptor = new Service::ChannelAdaptor(dbusConnection, this, channel->dbusObject());
 }
 
@@ -173,14 +182,14 @@ bool BaseChannel::registerObject(DBusError *error)
     //        .arg(mPriv->connection->busName(),name);
     QString objectPath = QString(QLatin1String("%1/%2"))
                          .arg(mPriv->connection->objectPath(), name);
-    debug() << "Registering channel: busName: " << busName << " objectName: " << objectPath;
+    TP_QT_DEBUG() << "Registering channel: busName: " << busName << " objectName: " << objectPath;
     DBusError _error;
 
-    debug() << "Channel: registering interfaces  at " << dbusObject();
+    TP_QT_DEBUG() << "Channel: registering interfaces  at " << dbusObject();
     foreach(const AbstractChannelInterfacePtr & iface, mPriv->interfaces) {
         if (!iface->registerInterface(dbusObject())) {
             // lets not fail if an optional interface fails registering, lets warn only
-            warning() << "Unable to register interface" << iface->interfaceName();
+            TP_QT_WARNING() << "Unable to register interface" << iface->interfaceName();
         }
     }
 
@@ -259,8 +268,8 @@ void BaseChannel::close()
         iface->close();
     }
 
-    // Method is used in destructor, so (to be sure that adaptee is exists) we should use DirectConnection
-    QMetaObject::invokeMethod(mPriv->adaptee, "closed", Qt::DirectConnection);
+    // Method is used in destructor, so the signal has to be emitted while the adaptee still exists
+    emit mPriv->adaptee->closed();
     emit closed();
 }
 
@@ -336,24 +345,24 @@ AbstractChannelInterfacePtr BaseChannel::interface(const QString &interfaceName)
 bool BaseChannel::plugInterface(const AbstractChannelInterfacePtr &interface)
 {
     if (isRegistered()) {
-        warning() << "Unable to plug protocol interface " << interface->interfaceName() <<
+        TP_QT_WARNING() << "Unable to plug protocol interface " << interface->interfaceName() <<
                   "- protocol already registered";
         return false;
     }
 
     if (interface->isRegistered()) {
-        warning() << "Unable to plug protocol interface" << interface->interfaceName() <<
+        TP_QT_WARNING() << "Unable to plug protocol interface" << interface->interfaceName() <<
                   "- interface already registered";
         return false;
     }
 
     if (mPriv->interfaces.contains(interface->interfaceName())) {
-        warning() << "Unable to plug protocol interface" << interface->interfaceName() <<
+        TP_QT_WARNING() << "Unable to plug protocol interface" << interface->interfaceName() <<
                   "- another interface with same name already plugged";
         return false;
     }
 
-    debug() << "Interface" << interface->interfaceName() << "plugged";
+    TP_QT_DEBUG() << "Interface" << interface->interfaceName() << "plugged";
     mPriv->interfaces.insert(interface->interfaceName(), interface);
     interface->setBaseChannel(this);
     return true;
@@ -399,7 +408,7 @@ BaseChannelTextType::Adaptee::~Adaptee()
 void BaseChannelTextType::Adaptee::acknowledgePendingMessages(const Tp::UIntList &IDs,
         const Tp::Service::ChannelTypeTextAdaptor::AcknowledgePendingMessagesContextPtr &context)
 {
-    debug() << "BaseChannelTextType::acknowledgePendingMessages " << IDs;
+    TP_QT_DEBUG() << "BaseChannelTextType::acknowledgePendingMessages " << IDs;
     DBusError error;
     mInterface->acknowledgePendingMessages(IDs, &error);
     if (error.isValid()) {
@@ -461,13 +470,13 @@ void BaseChannelTextType::addReceivedMessage(const Tp::MessagePartList &msg)
 {
     MessagePartList message = msg;
     if (msg.empty()) {
-        warning() << "empty message: not sent";
+        TP_QT_WARNING() << "empty message: not sent";
         return;
     }
     MessagePart &header = message.front();
 
     if (header.count(QLatin1String("pending-message-id")))
-        warning() << "pending-message-id will be overwritten";
+        TP_QT_WARNING() << "pending-message-id will be overwritten";
 
     /* Add pending-message-id to header */
     uint pendingMessageId = mPriv->pendingMessagesId++;
@@ -497,23 +506,26 @@ void BaseChannelTextType::addReceivedMessage(const Tp::MessagePartList &msg)
             content = i->value(QLatin1String("content")).variant().toString();
             break;
         }
-    if (content.length() > 0)
-        QMetaObject::invokeMethod(mPriv->adaptee, "received",
-                                  Qt::QueuedConnection,
-                                  Q_ARG(uint, pendingMessageId),
-                                  Q_ARG(uint, timestamp),
-                                  Q_ARG(uint, handle),
-                                  Q_ARG(uint, type),
-                                  Q_ARG(uint, flags),
-                                  Q_ARG(QString, content));
+    if (content.length() > 0) {
+        static const QMetaMethod receivedSignal = QMetaMethod::fromSignal(&Adaptee::received);
+        receivedSignal.invoke(mPriv->adaptee, Qt::QueuedConnection,
+                              Q_ARG(uint, pendingMessageId),
+                              Q_ARG(uint, timestamp),
+                              Q_ARG(uint, handle),
+                              Q_ARG(uint, type),
+                              Q_ARG(uint, flags),
+                              Q_ARG(QString, content));
+    }
 
     /* Signal on ChannelMessagesInterface */
     BaseChannelMessagesInterfacePtr messagesIface = BaseChannelMessagesInterfacePtr::dynamicCast(
                 mPriv->channel->interface(TP_QT_IFACE_CHANNEL_INTERFACE_MESSAGES));
-    if (messagesIface)
-        QMetaObject::invokeMethod(messagesIface.data(), "messageReceived",
-                                  Qt::QueuedConnection,
-                                  Q_ARG(Tp::MessagePartList, message));
+    if (messagesIface) {
+        static const QMetaMethod messageReceivedSlot = BaseChannelMessagesInterface::staticMetaObject.method(
+                BaseChannelMessagesInterface::staticMetaObject.indexOfSlot("messageReceived(Tp::MessagePartList)"));
+        messageReceivedSlot.invoke(messagesIface.data(), Qt::QueuedConnection,
+                                   Q_ARG(Tp::MessagePartList, message));
+    }
 }
 
 Tp::MessagePartListList BaseChannelTextType::pendingMessages() const
@@ -579,21 +591,47 @@ void BaseChannelTextType::removePendingMessages(const UIntList &IDs)
     /* Signal on ChannelMessagesInterface */
     BaseChannelMessagesInterfacePtr messagesIface = BaseChannelMessagesInterfacePtr::dynamicCast(
                 mPriv->channel->interface(TP_QT_IFACE_CHANNEL_INTERFACE_MESSAGES));
-    if (messagesIface) //emit after return
-        QMetaObject::invokeMethod(messagesIface.data(), "pendingMessagesRemoved",
-                                  Qt::QueuedConnection,
-                                  Q_ARG(Tp::UIntList, IDs));
+    if (messagesIface) { //emit after return
+        static const QMetaMethod pendingMessagesRemovedSlot = BaseChannelMessagesInterface::staticMetaObject.method(
+                BaseChannelMessagesInterface::staticMetaObject.indexOfSlot("pendingMessagesRemoved(Tp::UIntList)"));
+        pendingMessagesRemovedSlot.invoke(messagesIface.data(), Qt::QueuedConnection,
+                                          Q_ARG(Tp::UIntList, IDs));
+    }
 }
 
 
 
 void BaseChannelTextType::sent(uint timestamp, uint type, QString text)
 {
-    QMetaObject::invokeMethod(mPriv->adaptee,"sent",Q_ARG(uint, timestamp), Q_ARG(uint, type), Q_ARG(QString, text)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->sent(timestamp, type, text);
 }
 
 
 // Chan.I.Messages
+namespace
+{
+
+struct SendMessageReply
+{
+    SendMessageReply(const Service::ChannelInterfaceMessagesAdaptor::SendMessageContextPtr &context)
+        : context(context)
+    {
+    }
+
+    void operator()(const CompletionHandle &completion, const QString &token) const
+    {
+        if (completion.isError()) {
+            context->setFinishedWithError(completion.errorName(), completion.errorMessage());
+            return;
+        }
+        context->setFinished(token);
+    }
+
+    Service::ChannelInterfaceMessagesAdaptor::SendMessageContextPtr context;
+};
+
+}
+
 BaseChannelMessagesInterface::Adaptee::Adaptee(BaseChannelMessagesInterface *interface)
     : QObject(interface),
       mInterface(interface)
@@ -607,13 +645,8 @@ BaseChannelMessagesInterface::Adaptee::~Adaptee()
 void BaseChannelMessagesInterface::Adaptee::sendMessage(const Tp::MessagePartList &message, uint flags,
         const Tp::Service::ChannelInterfaceMessagesAdaptor::SendMessageContextPtr &context)
 {
-    DBusError error;
-    QString token = mInterface->sendMessage(message, flags, &error);
-    if (error.isValid()) {
-        context->setFinishedWithError(error.name(), error.message());
-        return;
-    }
-    context->setFinished(token);
+    mInterface->sendMessage(message, flags, DeferredResultPtr<QString>(
+                new DeferredResult<QString>(SendMessageReply(context))));
 }
 
 struct TP_QT_NO_EXPORT BaseChannelMessagesInterface::Private {
@@ -637,9 +670,98 @@ struct TP_QT_NO_EXPORT BaseChannelMessagesInterface::Private {
     uint messagePartSupportFlags;
     uint deliveryReportingSupport;
     SendMessageCallback sendMessageCB;
+    SendMessageAsyncCallback sendMessageAsyncCB;
     BaseChannelMessagesInterface::Adaptee *adaptee;
+
+    void announceSentMessage(const Tp::MessagePartList &message, uint flags, const QString &token);
+
+    // Continuation of the result handed to the SendMessage async callback,
+    // which announces the message before finishing the outer result
+    struct MessageSending
+    {
+        MessageSending(BaseChannelMessagesInterface *interface, Private *priv,
+                const Tp::MessagePartList &message, uint flags,
+                const DeferredResultPtr<QString> &result)
+            : interface(interface),
+              priv(priv),
+              message(message),
+              flags(flags),
+              result(result)
+        {
+        }
+
+        void operator()(const CompletionHandle &sent, const QString &token) const
+        {
+            if (sent.isError()) {
+                result->setFinishedWithError(sent.errorName(), sent.errorMessage());
+                return;
+            }
+
+            if (interface) {
+                priv->announceSentMessage(message, flags, token);
+            }
+            result->setFinished(token);
+        }
+
+        QPointer<BaseChannelMessagesInterface> interface;
+        Private *priv;
+        Tp::MessagePartList message;
+        uint flags;
+        DeferredResultPtr<QString> result;
+    };
 };
 
+void BaseChannelMessagesInterface::Private::announceSentMessage(const Tp::MessagePartList &message,
+        uint flags, const QString &token)
+{
+    Tp::MessagePartList fixedMessage = message;
+
+    MessagePart header = fixedMessage.front();
+
+    uint timestamp = 0;
+    if (header.contains(QLatin1String("message-sent"))) {
+        timestamp = header[QLatin1String("message-sent")].variant().toUInt();
+    } else {
+        timestamp = QDateTime::currentMSecsSinceEpoch() / 1000;
+        header[QLatin1String("message-sent")] = QDBusVariant(timestamp);
+    }
+
+    fixedMessage.replace(0, header);
+
+    //emit after return
+    static const QMetaMethod messageSentSignal = QMetaMethod::fromSignal(
+            &BaseChannelMessagesInterface::Adaptee::messageSent);
+    messageSentSignal.invoke(adaptee, Qt::QueuedConnection,
+                             Q_ARG(Tp::MessagePartList, fixedMessage),
+                             Q_ARG(uint, flags),
+                             Q_ARG(QString, token));
+
+    if (message.empty()) {
+        TP_QT_WARNING() << "Sending empty message";
+        return;
+    }
+
+    uint type = ChannelTextMessageTypeNormal;
+    if (header.count(QLatin1String("message-type")))
+        type = header[QLatin1String("message-type")].variant().toUInt();
+
+    QString content;
+    for (MessagePartList::const_iterator i = message.begin() + 1; i != message.end(); ++i)
+        if (i->count(QLatin1String("content-type"))
+                && i->value(QLatin1String("content-type")).variant().toString() == QLatin1String("text/plain")
+                && i->count(QLatin1String("content"))) {
+            content = i->value(QLatin1String("content")).variant().toString();
+            break;
+        }
+    //emit after return
+    static const QMetaMethod sentSlot = BaseChannelTextType::staticMetaObject.method(
+            BaseChannelTextType::staticMetaObject.indexOfSlot("sent(uint,uint,QString)"));
+    sentSlot.invoke(textTypeInterface, Qt::QueuedConnection,
+                    Q_ARG(uint, timestamp),
+                    Q_ARG(uint, type),
+                    Q_ARG(QString, content));
+}
+
 /**
  * \class BaseChannelMessagesInterface
  * \ingroup servicechannel
@@ -727,17 +849,17 @@ Tp::MessagePartListList BaseChannelMessagesInterface::pendingMessages() const
 
 void BaseChannelMessagesInterface::messageSent(const Tp::MessagePartList &content, uint flags, const QString &messageToken)
 {
-    QMetaObject::invokeMethod(mPriv->adaptee, "messageSent", Q_ARG(Tp::MessagePartList, content), Q_ARG(uint, flags), Q_ARG(QString, messageToken)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->messageSent(content, flags, messageToken);
 }
 
 void BaseChannelMessagesInterface::pendingMessagesRemoved(const Tp::UIntList &messageIDs)
 {
-    QMetaObject::invokeMethod(mPriv->adaptee, "pendingMessagesRemoved", Q_ARG(Tp::UIntList, messageIDs)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->pendingMessagesRemoved(messageIDs);
 }
 
 void BaseChannelMessagesInterface::messageReceived(const Tp::MessagePartList &message)
 {
-    QMetaObject::invokeMethod(mPriv->adaptee, "messageReceived", Q_ARG(Tp::MessagePartList, message)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->messageReceived(message);
 }
 
 void BaseChannelMessagesInterface::setSendMessageCallback(const SendMessageCallback &cb)
@@ -753,51 +875,45 @@ QString BaseChannelMessagesInterface::sendMessage(const Tp::MessagePartList &mes
     }
     const QString token = mPriv->sendMessageCB(message, flags, error);
 
-    Tp::MessagePartList fixedMessage = message;
+    mPriv->announceSentMessage(message, flags, token);
+    return token;
+}
 
-    MessagePart header = fixedMessage.front();
+/**
+ * Set the callback used to send messages asynchronously.
+ *
+ * \a cb receives a DeferredResult which it should finish with the message
+ * token, or with an error, once the server has accepted the message, without
+ * blocking the other D-Bus calls made to the connection meanwhile. The
+ * MessageSent and Sent signals are emitted when it finishes successfully.
+ *
+ * When set, this callback is used instead of the one set with
+ * setSendMessageCallback().
+ *
+ * \param cb The callback to set.
+ */
+void BaseChannelMessagesInterface::setSendMessageAsyncCallback(const SendMessageAsyncCallback &cb)
+{
+    mPriv->sendMessageAsyncCB = cb;
+}
 
-    uint timestamp = 0;
-    if (header.contains(QLatin1String("message-sent"))) {
-        timestamp = header[QLatin1String("message-sent")].variant().toUInt();
-    } else {
-        timestamp = QDateTime::currentMSecsSinceEpoch() / 1000;
-        header[QLatin1String("message-sent")] = QDBusVariant(timestamp);
+void BaseChannelMessagesInterface::sendMessage(const Tp::MessagePartList &message, uint flags,
+        const DeferredResultPtr<QString> &result)
+{
+    if (mPriv->sendMessageAsyncCB.isValid()) {
+        mPriv->sendMessageAsyncCB(message, flags, DeferredResultPtr<QString>(
+                    new DeferredResult<QString>(
+                        Private::MessageSending(this, mPriv, message, flags, result))));
+        return;
     }
 
-    fixedMessage.replace(0, header);
-
-    //emit after return
-    QMetaObject::invokeMethod(mPriv->adaptee, "messageSent",
-                              Qt::QueuedConnection,
-                              Q_ARG(Tp::MessagePartList, fixedMessage),
-                              Q_ARG(uint, flags),
-                              Q_ARG(QString, token));
-
-    if (message.empty()) {
-        warning() << "Sending empty message";
-        return token;
+    DBusError error;
+    QString token = sendMessage(message, flags, &error);
+    if (error.isValid()) {
+        result->setFinishedWithError(error);
+        return;
     }
-
-    uint type = ChannelTextMessageTypeNormal;
-    if (header.count(QLatin1String("message-type")))
-        type = header[QLatin1String("message-type")].variant().toUInt();
-
-    QString content;
-    for (MessagePartList::const_iterator i = message.begin() + 1; i != message.end(); ++i)
-        if (i->count(QLatin1String("content-type"))
-                && i->value(QLatin1String("content-type")).variant().toString() == QLatin1String("text/plain")
-                && i->count(QLatin1String("content"))) {
-            content = i->value(QLatin1String("content")).variant().toString();
-            break;
-        }
-    //emit after return
-    QMetaObject::invokeMethod(mPriv->textTypeInterface, "sent",
-                              Qt::QueuedConnection,
-                              Q_ARG(uint, timestamp),
-                              Q_ARG(uint, type),
-                              Q_ARG(QString, content));
-    return token;
+    result->setFinished(token);
 }
 
 // Chan.T.FileTransfer
@@ -813,7 +929,12 @@ struct TP_QT_NO_EXPORT BaseChannelFileTransferType::Private {
           device(nullptr),
           weOpenedDevice(false),
           serverSocket(nullptr),
+          localServer(nullptr),
           clientSocket(nullptr),
+          transferStalled(false),
+          notificationInterval(1000),
+          notifiedBytes(0),
+          notificationTimer(nullptr),
           adaptee(new BaseChannelFileTransferType::Adaptee(parent))
     {
         contentType = request.value(TP_QT_IFACE_CHANNEL_TYPE_FILE_TRANSFER + QLatin1String(".ContentType")).toString();
@@ -858,14 +979,55 @@ struct TP_QT_NO_EXPORT BaseChannelFileTransferType::Private {
     QIODevice *device; // A socket to read or write file to underlying connection manager
     bool weOpenedDevice;
     QTcpServer *serverSocket; // Server socket is an implementation detail.
+    QLocalServer *localServer; // Used instead of serverSocket for Unix sockets
     QIODevice *clientSocket; // A socket to communicate with a Telepathy client
+    QByteArray transferBuffer;
+    bool transferStalled; // Waiting for the output to drain
     BaseChannelFileTransferType::Direction direction;
+
+    // TransferredBytesChanged is emitted at most once per notificationInterval
+    int notificationInterval;
+    qulonglong notifiedBytes;
+    QElapsedTimer lastNotification;
+    QTimer *notificationTimer;
+
     BaseChannelFileTransferType::Adaptee *adaptee;
 
+    void closeSockets();
+    void notifyTransferredBytes();
+
     friend class BaseChannelFileTransferType::Adaptee;
 
 };
 
+void BaseChannelFileTransferType::Private::closeSockets()
+{
+    if (clientSocket) {
+        clientSocket->close();
+    }
+    if (serverSocket) {
+        serverSocket->close();
+    }
+    if (localServer) {
+        localServer->close();
+    }
+}
+
+void BaseChannelFileTransferType::Private::notifyTransferredBytes()
+{
+    if (notificationTimer) {
+        notificationTimer->stop();
+    }
+
+    if (notifiedBytes == transferredBytes && lastNotification.isValid()) {
+        return;
+    }
+
+    notifiedBytes = transferredBytes;
+    lastNotification.start();
+    emit adaptee->transferredBytesChanged(transferredBytes);
+}
+
 BaseChannelFileTransferType::Adaptee::Adaptee(BaseChannelFileTransferType *interface)
     : QObject(interface),
       mInterface(interface)
@@ -950,10 +1112,15 @@ void BaseChannelFileTransferType::Adaptee::setUri(const QString &uri)
     mInterface->setUri(uri);
 }
 
+void BaseChannelFileTransferType::Adaptee::notifyTransferredBytes()
+{
+    mInterface->mPriv->notifyTransferredBytes();
+}
+
 void BaseChannelFileTransferType::Adaptee::acceptFile(uint addressType, uint accessControl, const QDBusVariant &accessControlParam, qulonglong offset,
         const Tp::Service::ChannelTypeFileTransferAdaptor::AcceptFileContextPtr &context)
 {
-    debug() << "BaseChannelFileTransferType::Adaptee::acceptFile";
+    TP_QT_DEBUG() << "BaseChannelFileTransferType::Adaptee::acceptFile";
 
     if (mInterface->mPriv->device) {
         context->setFinishedWithError(TP_QT_ERROR_NOT_AVAILABLE, QLatin1String("File transfer can only be started once in the same channel"));
@@ -973,7 +1140,7 @@ void BaseChannelFileTransferType::Adaptee::acceptFile(uint addressType, uint acc
     mInterface->setState(Tp::FileTransferStateAccepted, Tp::FileTransferStateChangeReasonNone);
 
     mInterface->mPriv->initialOffset = offset;
-    QMetaObject::invokeMethod(this, "initialOffsetDefined", Q_ARG(qulonglong, offset));
+    emit initialOffsetDefined(offset);
 
     context->setFinished(address);
 }
@@ -981,7 +1148,7 @@ void BaseChannelFileTransferType::Adaptee::acceptFile(uint addressType, uint acc
 void BaseChannelFileTransferType::Adaptee::provideFile(uint addressType, uint accessControl, const QDBusVariant &accessControlParam,
         const Tp::Service::ChannelTypeFileTransferAdaptor::ProvideFileContextPtr &context)
 {
-    debug() << "BaseChannelFileTransferType::Adaptee::provideFile";
+    TP_QT_DEBUG() << "BaseChannelFileTransferType::Adaptee::provideFile";
 
     DBusError error;
     mInterface->createSocket(addressType, accessControl, accessControlParam, &error);
@@ -1099,16 +1266,38 @@ bool BaseChannelFileTransferType::createSocket(uint addressType, uint accessCont
     case Tp::SocketAddressTypeIPv6:
         address = QHostAddress(QHostAddress::LocalHostIPv6);
         break;
+    case Tp::SocketAddressTypeUnix:
+        break;
     default:
         error->set(TP_QT_ERROR_NOT_IMPLEMENTED, QLatin1String("Requested address type is not supported."));
         return false;
     }
 
-    if (mPriv->serverSocket) {
+    if (mPriv->serverSocket || mPriv->localServer) {
         error->set(TP_QT_ERROR_NOT_AVAILABLE, QLatin1String("File transfer can only be started once in the same channel"));
         return false;
     }
 
+    if (addressType == Tp::SocketAddressTypeUnix) {
+        static uint lastSocketId = 0;
+
+        mPriv->localServer = new QLocalServer(this);
+        mPriv->localServer->setMaxPendingConnections(1);
+
+        connect(mPriv->localServer, SIGNAL(newConnection()), this, SLOT(onSocketConnection()));
+
+        QString name = QString(QLatin1String("tp-qt-ft-%1-%2"))
+            .arg(QCoreApplication::applicationPid()).arg(++lastSocketId);
+        QLocalServer::removeServer(name);
+
+        bool result = mPriv->localServer->listen(name);
+        if (!result) {
+            error->set(TP_QT_ERROR_NETWORK_ERROR, mPriv->localServer->errorString());
+        }
+
+        return result;
+    }
+
     mPriv->serverSocket = new QTcpServer(this);
     mPriv->serverSocket->setMaxPendingConnections(1);
 
@@ -1124,6 +1313,10 @@ bool BaseChannelFileTransferType::createSocket(uint addressType, uint accessCont
 
 QDBusVariant BaseChannelFileTransferType::socketAddress() const
 {
+    if (mPriv->localServer) {
+        return QDBusVariant(QVariant(QFile::encodeName(mPriv->localServer->fullServerName())));
+    }
+
     if (!mPriv->serverSocket) {
         return QDBusVariant();
     }
@@ -1155,12 +1348,62 @@ void BaseChannelFileTransferType::setTransferredBytes(qulonglong count)
     }
 
     mPriv->transferredBytes = count;
-    QMetaObject::invokeMethod(mPriv->adaptee, "transferredBytesChanged", Q_ARG(qulonglong, count)); //Can simply use emit in Qt5
 
     if (transferredBytes() == size()) {
-        mPriv->clientSocket->close();
-        mPriv->serverSocket->close();
+        // The final count is always signalled, before the state change
+        mPriv->notifyTransferredBytes();
+        mPriv->closeSockets();
         setState(Tp::FileTransferStateCompleted, Tp::FileTransferStateChangeReasonNone);
+        return;
+    }
+
+    if (mPriv->notificationInterval <= 0 || !mPriv->lastNotification.isValid() ||
+            mPriv->lastNotification.elapsed() >= mPriv->notificationInterval) {
+        mPriv->notifyTransferredBytes();
+        return;
+    }
+
+    if (!mPriv->notificationTimer) {
+        mPriv->notificationTimer = new QTimer(mPriv->adaptee);
+        mPriv->notificationTimer->setSingleShot(true);
+        mPriv->adaptee->connect(mPriv->notificationTimer,
+                SIGNAL(timeout()),
+                SLOT(notifyTransferredBytes()));
+    }
+
+    if (!mPriv->notificationTimer->isActive()) {
+        mPriv->notificationTimer->start(mPriv->notificationInterval -
+                int(mPriv->lastNotification.elapsed()));
+    }
+}
+
+/**
+ * Return the minimum interval between two TransferredBytesChanged signals.
+ *
+ * \return The interval in milliseconds.
+ * \sa setTransferredBytesNotificationInterval()
+ */
+int BaseChannelFileTransferType::transferredBytesNotificationInterval() const
+{
+    return mPriv->notificationInterval;
+}
+
+/**
+ * Set the minimum interval between two TransferredBytesChanged signals.
+ *
+ * The \telepathy_spec asks for the signal to be emitted at most once a second,
+ * which is the default. Changes made by setTransferredBytes() in between are
+ * coalesced, and the final count of a completed transfer is always signalled
+ * right away. Set to 0 to signal every change.
+ *
+ * \param msec The interval in milliseconds.
+ */
+void BaseChannelFileTransferType::setTransferredBytesNotificationInterval(int msec)
+{
+    mPriv->notificationInterval = msec;
+
+    if (msec <= 0 && mPriv->notificationTimer && mPriv->notificationTimer->isActive()) {
+        mPriv->notifyTransferredBytes();
     }
 }
 
@@ -1169,7 +1412,7 @@ void BaseChannelFileTransferType::setClientSocket(QIODevice *socket)
     mPriv->clientSocket = socket;
 
     if (!socket) {
-        warning() << "BaseChannelFileTransferType::setClientSocket() called with a null socket.";
+        TP_QT_WARNING() << "BaseChannelFileTransferType::setClientSocket() called with a null socket.";
         return;
     }
 
@@ -1191,7 +1434,11 @@ void BaseChannelFileTransferType::setClientSocket(QIODevice *socket)
 
 void BaseChannelFileTransferType::onSocketConnection()
 {
-    setClientSocket(mPriv->serverSocket->nextPendingConnection());
+    if (mPriv->localServer) {
+        setClientSocket(mPriv->localServer->nextPendingConnection());
+    } else {
+        setClientSocket(mPriv->serverSocket->nextPendingConnection());
+    }
 }
 
 void BaseChannelFileTransferType::doTransfer()
@@ -1218,13 +1465,33 @@ void BaseChannelFileTransferType::doTransfer()
         break;
     }
 
-    static const int c_blockSize = 16 * 1024;
-    char buffer[c_blockSize];
-    char *inputPointer = buffer;
+    // Copy as much as is available in one go, but stop once the output holds
+    // too much unwritten data, resuming from onOutputBytesWritten(), and once
+    // enough was copied, to let the event loop run.
+    static const int c_blockSize = 64 * 1024;
+    static const qint64 c_maxPendingOutput = 1024 * 1024;
+    static const qint64 c_maxBytesPerRun = 4 * 1024 * 1024;
+
+    if (mPriv->transferBuffer.size() != c_blockSize) {
+        mPriv->transferBuffer.resize(c_blockSize);
+    }
+
+    mPriv->transferStalled = false;
+    qint64 copied = 0;
+
+    while (copied < c_maxBytesPerRun) {
+        if (output->bytesToWrite() > c_maxPendingOutput) {
+            mPriv->transferStalled = true;
+            return;
+        }
 
-    qint64 length = input->read(buffer, sizeof(buffer));
+        char *inputPointer = mPriv->transferBuffer.data();
+        qint64 length = input->read(inputPointer, c_blockSize);
+        if (length <= 0) {
+            return;
+        }
+        copied += length;
 
-    if (length) {
         // deviceOffset is the number of already skipped bytes
         if (mPriv->deviceOffset + length > initialOffset()) {
             if (mPriv->deviceOffset < initialOffset()) {
@@ -1246,6 +1513,14 @@ void BaseChannelFileTransferType::doTransfer()
 void BaseChannelFileTransferType::onBytesWritten(qint64 count)
 {
     setTransferredBytes(transferredBytes() + count);
+    onOutputBytesWritten();
+}
+
+void BaseChannelFileTransferType::onOutputBytesWritten()
+{
+    if (mPriv->transferStalled) {
+        doTransfer();
+    }
 }
 
 /**
@@ -1311,8 +1586,15 @@ void BaseChannelFileTransferType::setState(uint state, uint reason)
         return;
     }
 
+    if (state == Tp::FileTransferStateCompleted || state == Tp::FileTransferStateCancelled) {
+        // Don't leave a throttled progress update behind the final state
+        if (mPriv->notificationTimer && mPriv->notificationTimer->isActive()) {
+            mPriv->notifyTransferredBytes();
+        }
+    }
+
     mPriv->state = state;
-    QMetaObject::invokeMethod(mPriv->adaptee, "fileTransferStateChanged", Q_ARG(uint, state), Q_ARG(uint, reason)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->fileTransferStateChanged(state, reason);
     emit stateChanged(state, reason);
 }
 
@@ -1355,6 +1637,7 @@ Tp::SupportedSocketMap BaseChannelFileTransferType::availableSocketTypes() const
 {
     Tp::SupportedSocketMap types;
     types.insert(Tp::SocketAddressTypeIPv4, Tp::UIntList() << Tp::SocketAccessControlLocalhost);
+    types.insert(Tp::SocketAddressTypeUnix, Tp::UIntList() << Tp::SocketAccessControlLocalhost);
 
     return types;
 }
@@ -1377,18 +1660,18 @@ QString BaseChannelFileTransferType::uri() const
 void BaseChannelFileTransferType::setUri(const QString &uri)
 {
     if (mPriv->direction == Outgoing) {
-        warning() << "BaseChannelFileTransferType::setUri(): Failed to set URI property for outgoing transfer.";
+        TP_QT_WARNING() << "BaseChannelFileTransferType::setUri(): Failed to set URI property for outgoing transfer.";
         return;
     }
 
     // The property can be written only before AcceptFile.
     if (state() != FileTransferStatePending) {
-        warning() << "BaseChannelFileTransferType::setUri(): Failed to set URI property after AcceptFile call.";
+        TP_QT_WARNING() << "BaseChannelFileTransferType::setUri(): Failed to set URI property after AcceptFile call.";
         return;
     }
 
     mPriv->uri = uri;
-    QMetaObject::invokeMethod(mPriv->adaptee, "uriDefined", Q_ARG(QString, uri)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->uriDefined(uri);
     emit uriDefined(uri);
 }
 QString BaseChannelFileTransferType::fileCollection() const
@@ -1458,7 +1741,7 @@ bool BaseChannelFileTransferType::remoteAcceptFile(QIODevice *output, qulonglong
 
     if (!errorText.isEmpty()) {
         errorLabel:
-        warning() << "BaseChannelFileTransferType::remoteAcceptFile(): Invalid call:" << errorText;
+        TP_QT_WARNING() << "BaseChannelFileTransferType::remoteAcceptFile(): Invalid call:" << errorText;
         setState(Tp::FileTransferStateCancelled, Tp::FileTransferStateChangeReasonLocalError);
 
         return false;
@@ -1469,7 +1752,9 @@ bool BaseChannelFileTransferType::remoteAcceptFile(QIODevice *output, qulonglong
     mPriv->weOpenedDevice = !deviceIsAlreadynOpened;
     mPriv->initialOffset = offset;
 
-    QMetaObject::invokeMethod(mPriv->adaptee, "initialOffsetDefined", Q_ARG(qulonglong, offset)); //Can simply use emit in Qt5
+    connect(mPriv->device, SIGNAL(bytesWritten(qint64)), this, SLOT(onOutputBytesWritten()));
+
+    emit mPriv->adaptee->initialOffsetDefined(offset);
     setState(Tp::FileTransferStateAccepted, Tp::FileTransferStateChangeReasonNone);
 
     return true;
@@ -1542,7 +1827,7 @@ bool BaseChannelFileTransferType::remoteProvideFile(QIODevice *input, qulonglong
 
     if (!errorText.isEmpty()) {
         errorLabel:
-        warning() << "BaseChannelFileTransferType::remoteProvideFile(): Invalid call:" << errorText;
+        TP_QT_WARNING() << "BaseChannelFileTransferType::remoteProvideFile(): Invalid call:" << errorText;
         setState(Tp::FileTransferStateCancelled, Tp::FileTransferStateChangeReasonLocalError);
 
         return false;
@@ -1628,7 +1913,7 @@ void BaseChannelRoomListType::Adaptee::getListingRooms(
 void BaseChannelRoomListType::Adaptee::listRooms(
         const Tp::Service::ChannelTypeRoomListAdaptor::ListRoomsContextPtr &context)
 {
-    debug() << "BaseChannelRoomListType::Adaptee::listRooms";
+    TP_QT_DEBUG() << "BaseChannelRoomListType::Adaptee::listRooms";
     DBusError error;
     mInterface->listRooms(&error);
     if (error.isValid()) {
@@ -1641,7 +1926,7 @@ void BaseChannelRoomListType::Adaptee::listRooms(
 void BaseChannelRoomListType::Adaptee::stopListing(
         const Tp::Service::ChannelTypeRoomListAdaptor::StopListingContextPtr &context)
 {
-    debug() << "BaseChannelRoomListType::Adaptee::stopListing";
+    TP_QT_DEBUG() << "BaseChannelRoomListType::Adaptee::stopListing";
     DBusError error;
     mInterface->stopListing(&error);
     if (error.isValid()) {
@@ -1715,7 +2000,7 @@ void BaseChannelRoomListType::setListingRooms(bool listing)
     }
 
     mPriv->listingRooms = listing;
-    QMetaObject::invokeMethod(mPriv->adaptee, "listingRooms", Q_ARG(bool, listing)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->listingRooms(listing);
 }
 
 void BaseChannelRoomListType::setListRoomsCallback(const ListRoomsCallback &cb)
@@ -1748,7 +2033,7 @@ void BaseChannelRoomListType::stopListing(DBusError *error)
 
 void BaseChannelRoomListType::gotRooms(const Tp::RoomInfoList &rooms)
 {
-    QMetaObject::invokeMethod(mPriv->adaptee, "gotRooms", Q_ARG(Tp::RoomInfoList, rooms)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->gotRooms(rooms);
 }
 
 //Chan.T.ServerAuthentication
@@ -1874,7 +2159,7 @@ QVariantMap BaseChannelCaptchaAuthenticationInterface::Adaptee::captchaErrorDeta
 
 void BaseChannelCaptchaAuthenticationInterface::Adaptee::getCaptchas(const Tp::Service::ChannelInterfaceCaptchaAuthenticationAdaptor::GetCaptchasContextPtr &context)
 {
-    debug() << "BaseChannelCaptchaAuthenticationInterface::Adaptee::getCaptchas";
+    TP_QT_DEBUG() << "BaseChannelCaptchaAuthenticationInterface::Adaptee::getCaptchas";
     DBusError error;
     Tp::CaptchaInfoList captchaInfo;
     uint numberRequired;
@@ -1889,7 +2174,7 @@ void BaseChannelCaptchaAuthenticationInterface::Adaptee::getCaptchas(const Tp::S
 
 void BaseChannelCaptchaAuthenticationInterface::Adaptee::getCaptchaData(uint ID, const QString& mimeType, const Tp::Service::ChannelInterfaceCaptchaAuthenticationAdaptor::GetCaptchaDataContextPtr &context)
 {
-    debug() << "BaseChannelCaptchaAuthenticationInterface::Adaptee::getCaptchaData " << ID << mimeType;
+    TP_QT_DEBUG() << "BaseChannelCaptchaAuthenticationInterface::Adaptee::getCaptchaData " << ID << mimeType;
     DBusError error;
     QByteArray captchaData = mInterface->mPriv->getCaptchaDataCB(ID, mimeType, &error);
     if (error.isValid()) {
@@ -1901,7 +2186,7 @@ void BaseChannelCaptchaAuthenticationInterface::Adaptee::getCaptchaData(uint ID,
 
 void BaseChannelCaptchaAuthenticationInterface::Adaptee::answerCaptchas(const Tp::CaptchaAnswers& answers, const Tp::Service::ChannelInterfaceCaptchaAuthenticationAdaptor::AnswerCaptchasContextPtr &context)
 {
-    debug() << "BaseChannelCaptchaAuthenticationInterface::Adaptee::answerCaptchas";
+    TP_QT_DEBUG() << "BaseChannelCaptchaAuthenticationInterface::Adaptee::answerCaptchas";
     DBusError error;
     mInterface->mPriv->answerCaptchasCB(answers, &error);
     if (error.isValid()) {
@@ -1913,7 +2198,7 @@ void BaseChannelCaptchaAuthenticationInterface::Adaptee::answerCaptchas(const Tp
 
 void BaseChannelCaptchaAuthenticationInterface::Adaptee::cancelCaptcha(uint reason, const QString& debugMessage, const Tp::Service::ChannelInterfaceCaptchaAuthenticationAdaptor::CancelCaptchaContextPtr &context)
 {
-    debug() << "BaseChannelCaptchaAuthenticationInterface::Adaptee::cancelCaptcha "
+    TP_QT_DEBUG() << "BaseChannelCaptchaAuthenticationInterface::Adaptee::cancelCaptcha "
              << reason << " " << debugMessage;
     DBusError error;
     mInterface->mPriv->cancelCaptchaCB(reason, debugMessage, &error);
@@ -2114,7 +2399,7 @@ bool BaseChannelSASLAuthenticationInterface::Adaptee::maySaveResponse() const
 void BaseChannelSASLAuthenticationInterface::Adaptee::startMechanism(const QString &mechanism,
         const Tp::Service::ChannelInterfaceSASLAuthenticationAdaptor::StartMechanismContextPtr &context)
 {
-    debug() << "BaseChannelSASLAuthenticationInterface::Adaptee::startMechanism";
+    TP_QT_DEBUG() << "BaseChannelSASLAuthenticationInterface::Adaptee::startMechanism";
     DBusError error;
     mInterface->startMechanism(mechanism, &error);
     if (error.isValid()) {
@@ -2127,7 +2412,7 @@ void BaseChannelSASLAuthenticationInterface::Adaptee::startMechanism(const QStri
 void BaseChannelSASLAuthenticationInterface::Adaptee::startMechanismWithData(const QString &mechanism, const QByteArray &initialData,
         const Tp::Service::ChannelInterfaceSASLAuthenticationAdaptor::StartMechanismWithDataContextPtr &context)
 {
-    debug() << "BaseChannelSASLAuthenticationInterface::Adaptee::startMechanismWithData";
+    TP_QT_DEBUG() << "BaseChannelSASLAuthenticationInterface::Adaptee::startMechanismWithData";
     DBusError error;
     mInterface->startMechanismWithData(mechanism, initialData, &error);
     if (error.isValid()) {
@@ -2140,7 +2425,7 @@ void BaseChannelSASLAuthenticationInterface::Adaptee::startMechanismWithData(con
 void BaseChannelSASLAuthenticationInterface::Adaptee::respond(const QByteArray &responseData,
         const Tp::Service::ChannelInterfaceSASLAuthenticationAdaptor::RespondContextPtr &context)
 {
-    debug() << "BaseChannelSASLAuthenticationInterface::Adaptee::respond";
+    TP_QT_DEBUG() << "BaseChannelSASLAuthenticationInterface::Adaptee::respond";
     DBusError error;
     mInterface->respond(responseData, &error);
     if (error.isValid()) {
@@ -2153,7 +2438,7 @@ void BaseChannelSASLAuthenticationInterface::Adaptee::respond(const QByteArray &
 void BaseChannelSASLAuthenticationInterface::Adaptee::acceptSasl(
         const Tp::Service::ChannelInterfaceSASLAuthenticationAdaptor::AcceptSASLContextPtr &context)
 {
-    debug() << "BaseChannelSASLAuthenticationInterface::Adaptee::acceptSasl";
+    TP_QT_DEBUG() << "BaseChannelSASLAuthenticationInterface::Adaptee::acceptSasl";
     DBusError error;
     mInterface->acceptSasl(&error);
     if (error.isValid()) {
@@ -2166,7 +2451,7 @@ void BaseChannelSASLAuthenticationInterface::Adaptee::acceptSasl(
 void BaseChannelSASLAuthenticationInterface::Adaptee::abortSasl(uint reason, const QString &debugMessage,
         const Tp::Service::ChannelInterfaceSASLAuthenticationAdaptor::AbortSASLContextPtr &context)
 {
-    debug() << "BaseChannelSASLAuthenticationInterface::Adaptee::abortSasl";
+    TP_QT_DEBUG() << "BaseChannelSASLAuthenticationInterface::Adaptee::abortSasl";
     DBusError error;
     mInterface->abortSasl(reason, debugMessage, &error);
     if (error.isValid()) {
@@ -2260,7 +2545,7 @@ void BaseChannelSASLAuthenticationInterface::setSaslStatus(uint status, const QS
     mPriv->saslStatus = status;
     mPriv->saslError = reason;
     mPriv->saslErrorDetails = details;
-    QMetaObject::invokeMethod(mPriv->adaptee, "saslStatusChanged", Q_ARG(uint, status), Q_ARG(QString, reason), Q_ARG(QVariantMap, details)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->saslStatusChanged(status, reason, details);
 }
 
 QString BaseChannelSASLAuthenticationInterface::saslError() const
@@ -2381,7 +2666,7 @@ void BaseChannelSASLAuthenticationInterface::abortSasl(uint reason, const QStrin
 
 void BaseChannelSASLAuthenticationInterface::newChallenge(const QByteArray &challengeData)
 {
-    QMetaObject::invokeMethod(mPriv->adaptee, "newChallenge", Q_ARG(QByteArray, challengeData)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->newChallenge(challengeData);
 }
 
 // Chan.I.Securable
@@ -2513,7 +2798,7 @@ Tp::ChatStateMap BaseChannelChatStateInterface::Adaptee::chatStates() const
 void BaseChannelChatStateInterface::Adaptee::setChatState(uint state,
         const Tp::Service::ChannelInterfaceChatStateAdaptor::SetChatStateContextPtr &context)
 {
-    debug() << "BaseChannelChatStateInterface::Adaptee::setChatState";
+    TP_QT_DEBUG() << "BaseChannelChatStateInterface::Adaptee::setChatState";
     DBusError error;
     mInterface->setChatState(state, &error);
     if (error.isValid()) {
@@ -2580,7 +2865,7 @@ void BaseChannelChatStateInterface::setChatState(uint state, DBusError *error)
 
 void BaseChannelChatStateInterface::chatStateChanged(uint contact, uint state)
 {
-    QMetaObject::invokeMethod(mPriv->adaptee, "chatStateChanged", Q_ARG(uint, contact), Q_ARG(uint, state)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->chatStateChanged(contact, state);
 }
 
 // Chan.I.Group
@@ -2658,7 +2943,7 @@ Tp::HandleIdentifierMap BaseChannelGroupInterface::Adaptee::memberIdentifiers()
 void BaseChannelGroupInterface::Adaptee::addMembers(const Tp::UIntList &contacts, const QString &message,
         const Tp::Service::ChannelInterfaceGroupAdaptor::AddMembersContextPtr &context)
 {
-    qDebug() << "BaseChannelGroupInterface::Adaptee::addMembers";
+    TP_QT_DEBUG() << "BaseChannelGroupInterface::Adaptee::addMembers";
     DBusError error;
     mInterface->addMembers(contacts, message, &error);
     if (error.isValid()) {
@@ -2671,7 +2956,7 @@ void BaseChannelGroupInterface::Adaptee::addMembers(const Tp::UIntList &contacts
 void BaseChannelGroupInterface::Adaptee::removeMembers(const Tp::UIntList &contacts, const QString &message,
         const Tp::Service::ChannelInterfaceGroupAdaptor::RemoveMembersContextPtr &context)
 {
-    qDebug() << "BaseChannelGroupInterface::Adaptee::removeMembers";
+    TP_QT_DEBUG() << "BaseChannelGroupInterface::Adaptee::removeMembers";
     DBusError error;
     mInterface->removeMembers(contacts, message, Tp::ChannelGroupChangeReasonNone, &error);
     if (error.isValid()) {
@@ -2684,7 +2969,7 @@ void BaseChannelGroupInterface::Adaptee::removeMembers(const Tp::UIntList &conta
 void BaseChannelGroupInterface::Adaptee::removeMembersWithReason(const Tp::UIntList &contacts, const QString &message, uint reason,
         const Tp::Service::ChannelInterfaceGroupAdaptor::RemoveMembersWithReasonContextPtr &context)
 {
-    qDebug() << "BaseChannelGroupInterface::Adaptee::removeMembersWithReason";
+    TP_QT_DEBUG() << "BaseChannelGroupInterface::Adaptee::removeMembersWithReason";
     DBusError error;
     mInterface->removeMembers(contacts, message, reason, &error);
     if (error.isValid()) {
@@ -2738,13 +3023,8 @@ void BaseChannelGroupInterface::Private::emitMembersChangedSignal(const UIntList
     const uint reason = details.value(QLatin1String("change-reason"), Tp::ChannelGroupChangeReasonNone).toUInt();
     const QString message = details.value(QLatin1String("message")).toString();
 
-    QMetaObject::invokeMethod(adaptee, "membersChanged",
-                              Q_ARG(QString, message),
-                              Q_ARG(Tp::UIntList, added),
-                              Q_ARG(Tp::UIntList, removed),
-                              Q_ARG(Tp::UIntList, localPending),
-                              Q_ARG(Tp::UIntList, remotePending),
-                              Q_ARG(uint, actor), Q_ARG(uint, reason)); //Can simply use emit in Qt5
+    emit adaptee->membersChanged(message, added, removed, localPending, remotePending,
+            actor, reason);
 
     if (!details.contains(QLatin1String("contact-ids"))) {
         HandleIdentifierMap contactIds;
@@ -2754,12 +3034,7 @@ void BaseChannelGroupInterface::Private::emitMembersChangedSignal(const UIntList
         details.insert(QLatin1String("contact-ids"), QVariant::fromValue(contactIds));
     }
 
-    QMetaObject::invokeMethod(adaptee, "membersChangedDetailed",
-                              Q_ARG(Tp::UIntList, added),
-                              Q_ARG(Tp::UIntList, removed),
-                              Q_ARG(Tp::UIntList, localPending),
-                              Q_ARG(Tp::UIntList, remotePending),
-                              Q_ARG(QVariantMap, details));
+    emit adaptee->membersChangedDetailed(added, removed, localPending, remotePending, details);
 }
 
 /**
@@ -2890,7 +3165,7 @@ void BaseChannelGroupInterface::setGroupFlags(const Tp::ChannelGroupFlags &flags
     const Tp::ChannelGroupFlags removed   = mPriv->groupFlags & ~keptFlags;
 
     mPriv->groupFlags = flags;
-    QMetaObject::invokeMethod(mPriv->adaptee, "groupFlagsChanged", Q_ARG(uint, added), Q_ARG(uint, removed)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->groupFlagsChanged(added, removed);
 }
 
 /**
@@ -3050,8 +3325,8 @@ void BaseChannelGroupInterface::setHandleOwners(const Tp::HandleOwnerMap &handle
         identifiers[ownerHandle] = mPriv->memberIdentifiers.value(ownerHandle);
     }
 
-    QMetaObject::invokeMethod(mPriv->adaptee, "handleOwnersChanged", Q_ARG(Tp::HandleOwnerMap, added), Q_ARG(Tp::UIntList, removed)); //Can simply use emit in Qt5
-    QMetaObject::invokeMethod(mPriv->adaptee, "handleOwnersChangedDetailed", Q_ARG(Tp::HandleOwnerMap, added), Q_ARG(Tp::UIntList, removed), Q_ARG(Tp::HandleIdentifierMap, identifiers)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->handleOwnersChanged(added, removed);
+    emit mPriv->adaptee->handleOwnersChangedDetailed(added, removed, identifiers);
 }
 
 /**
@@ -3185,14 +3460,14 @@ void BaseChannelGroupInterface::setSelfHandle(uint selfHandle)
     mPriv->selfHandle = selfHandle;
 
     // selfHandleChanged is deprecated since 0.23.4.
-    QMetaObject::invokeMethod(mPriv->adaptee, "selfHandleChanged", Q_ARG(uint, selfHandle)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->selfHandleChanged(selfHandle);
 
     if (mPriv->connection) {
         DBusError error;
         QStringList selfID = mPriv->connection->inspectHandles(Tp::HandleTypeContact, Tp::UIntList() << selfHandle, &error);
 
         if (!selfID.isEmpty()) {
-            QMetaObject::invokeMethod(mPriv->adaptee, "selfContactChanged", Q_ARG(uint, selfHandle), Q_ARG(QString, selfID.first())); //Can simply use emit in Qt5
+            emit mPriv->adaptee->selfContactChanged(selfHandle, selfID.first());
         }
     }
 }
@@ -3580,7 +3855,7 @@ bool BaseChannelRoomConfigInterface::Adaptee::configurationRetrieved() const
 void BaseChannelRoomConfigInterface::Adaptee::updateConfiguration(const QVariantMap &properties,
         const Tp::Service::ChannelInterfaceRoomConfigAdaptor::UpdateConfigurationContextPtr &context)
 {
-    debug() << "BaseChannelRoomConfigInterface::Adaptee::updateConfiguration";
+    TP_QT_DEBUG() << "BaseChannelRoomConfigInterface::Adaptee::updateConfiguration";
     DBusError error;
     mInterface->updateConfiguration(properties, &error);
     if (error.isValid()) {
@@ -4053,7 +4328,7 @@ void BaseChannelCallType::setCallState(const Tp::CallState &state, uint flags, c
     mPriv->callFlags = flags;
     mPriv->callStateReason = stateReason;
     mPriv->callStateDetails = callStateDetails;
-    QMetaObject::invokeMethod(mPriv->adaptee, "callStateChanged", Q_ARG(uint, state), Q_ARG(uint, flags), Q_ARG(Tp::CallStateReason, stateReason), Q_ARG(QVariantMap, callStateDetails));
+    emit mPriv->adaptee->callStateChanged(state, flags, stateReason, callStateDetails);
 }
 
 void BaseChannelCallType::setAcceptCallback(const AcceptCallback &cb)
@@ -4085,7 +4360,7 @@ void BaseChannelCallType::setMembersFlags(const Tp::CallMemberMap &flagsChanged,
 {
     mPriv->callMembers = flagsChanged;
     mPriv->memberIdentifiers = identifiers;
-    QMetaObject::invokeMethod(mPriv->adaptee, "callMembersChanged", Q_ARG(Tp::CallMemberMap, flagsChanged), Q_ARG(Tp::HandleIdentifierMap, identifiers), Q_ARG(Tp::UIntList, removed), Q_ARG(Tp::CallStateReason, reason));
+    emit mPriv->adaptee->callMembersChanged(flagsChanged, identifiers, removed, reason);
 }
 
 BaseCallContentPtr BaseChannelCallType::addContent(const QString &name, const Tp::MediaStreamType &type, const Tp::MediaStreamDirection &direction)
@@ -4096,7 +4371,7 @@ BaseCallContentPtr BaseChannelCallType::addContent(const QString &name, const Tp
     QDBusObjectPath objpath;
     objpath.setPath(ptr->objectPath());
     mPriv->contents.append(objpath);
-    QMetaObject::invokeMethod(mPriv->adaptee, "contentAdded", Q_ARG(QDBusObjectPath, objpath));
+    emit mPriv->adaptee->contentAdded(objpath);
 
     return ptr;
 }
@@ -4108,7 +4383,7 @@ void BaseChannelCallType::addContent(BaseCallContentPtr content)
     QDBusObjectPath objpath;
     objpath.setPath(content->objectPath());
     mPriv->contents.append(objpath);
-    QMetaObject::invokeMethod(mPriv->adaptee, "contentAdded", Q_ARG(QDBusObjectPath, objpath));
+    emit mPriv->adaptee->contentAdded(objpath);
 }
 
 // Chan.I.Hold
@@ -4196,7 +4471,7 @@ void BaseChannelHoldInterface::setHoldState(const Tp::LocalHoldState &state, con
     if (mPriv->state != state) {
         mPriv->state = state;
         mPriv->reason = reason;
-        QMetaObject::invokeMethod(mPriv->adaptee, "holdStateChanged", Q_ARG(uint, state), Q_ARG(uint, reason));
+        emit mPriv->adaptee->holdStateChanged(state, reason);
     }
 }
 
@@ -4452,7 +4727,7 @@ void BaseChannelConferenceInterface::mergeChannel(const QDBusObjectPath &channel
     if (channelHandle != 0) {
         mPriv->originalChannels[channelHandle] = channel;
     }
-    QMetaObject::invokeMethod(mPriv->adaptee, "channelMerged", Q_ARG(QDBusObjectPath, channel), Q_ARG(uint, channelHandle), Q_ARG(QVariantMap, properties));
+    emit mPriv->adaptee->channelMerged(channel, channelHandle, properties);
 }
 
 
@@ -4462,7 +4737,7 @@ void BaseChannelConferenceInterface::removeChannel(const QDBusObjectPath &channe
     if (mPriv->originalChannels.values().contains(channel)) {
         mPriv->originalChannels.remove(mPriv->originalChannels.key(channel));
     }
-    QMetaObject::invokeMethod(mPriv->adaptee, "channelRemoved", Q_ARG(QDBusObjectPath, channel), Q_ARG(QVariantMap, details));
+    emit mPriv->adaptee->channelRemoved(channel, details);
 }
 
 ChannelOriginatorMap BaseChannelConferenceInterface::originalChannels() const
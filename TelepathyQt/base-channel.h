@@ -30,6 +30,7 @@
 #include <TelepathyQt/Global>
 #include <TelepathyQt/Types>
 #include <TelepathyQt/Callbacks>
+#include <TelepathyQt/DeferredResult>
 #include <TelepathyQt/Constants>
 
 #include <QDBusConnection>
@@ -195,8 +196,12 @@ public:
 
     typedef Callback3<QString, const Tp::MessagePartList&, uint, DBusError*> SendMessageCallback;
     void setSendMessageCallback(const SendMessageCallback &cb);
+
+    typedef Callback3<void, const Tp::MessagePartList&, uint, const DeferredResultPtr<QString> &> SendMessageAsyncCallback;
+    void setSendMessageAsyncCallback(const SendMessageAsyncCallback &cb);
 protected:
     QString sendMessage(const Tp::MessagePartList &message, uint flags, DBusError* error);
+    void sendMessage(const Tp::MessagePartList &message, uint flags, const DeferredResultPtr<QString> &result);
 private Q_SLOTS:
     void pendingMessagesRemoved(const Tp::UIntList &messageIDs);
     void messageReceived(const Tp::MessagePartList &message);
@@ -256,6 +261,8 @@ public:
 
     qulonglong transferredBytes() const;
     void setTransferredBytes(qulonglong count);
+    int transferredBytesNotificationInterval() const;
+    void setTransferredBytesNotificationInterval(int msec);
     qulonglong initialOffset() const;
 
     QString uri() const;
@@ -284,6 +291,7 @@ private Q_SLOTS:
     TP_QT_NO_EXPORT void onSocketConnection();
     TP_QT_NO_EXPORT void doTransfer();
     TP_QT_NO_EXPORT void onBytesWritten(qint64 count);
+    TP_QT_NO_EXPORT void onOutputBytesWritten();
 
 private:
     TP_QT_NO_EXPORT void setUri(const QString &uri);
@@ -103,7 +103,7 @@ public:
     ~Adaptee() override;
     Tp::ChannelDetailsList channels() const;
     Tp::RequestableChannelClassList requestableChannelClasses() const {
-        debug() << "BaseConnectionRequestsInterface::requestableChannelClasses";
+        TP_QT_DEBUG() << "BaseConnectionRequestsInterface::requestableChannelClasses";
         return mInterface->requestableChannelClasses;
     }
 
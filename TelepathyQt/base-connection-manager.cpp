@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryService
+
 #include <TelepathyQt/BaseConnectionManager>
 #include "TelepathyQt/base-connection-manager-internal.h"
 
@@ -281,30 +283,30 @@ bool BaseConnectionManager::hasProtocol(const QString &protocolName) const
 bool BaseConnectionManager::addProtocol(const BaseProtocolPtr &protocol)
 {
     if (isRegistered()) {
-        warning() << "Unable to add protocol" << protocol->name() <<
+        TP_QT_WARNING() << "Unable to add protocol" << protocol->name() <<
             "- CM already registered";
         return false;
     }
 
     if (protocol->dbusConnection().name() != dbusConnection().name()) {
-        warning() << "Unable to add protocol" << protocol->name() <<
+        TP_QT_WARNING() << "Unable to add protocol" << protocol->name() <<
             "- protocol must have the same D-Bus connection as the owning CM";
         return false;
     }
 
     if (protocol->isRegistered()) {
-        warning() << "Unable to add protocol" << protocol->name() <<
+        TP_QT_WARNING() << "Unable to add protocol" << protocol->name() <<
             "- protocol already registered";
         return false;
     }
 
     if (mPriv->protocols.contains(protocol->name())) {
-        warning() << "Unable to add protocol" << protocol->name() <<
+        TP_QT_WARNING() << "Unable to add protocol" << protocol->name() <<
             "- another protocol with same name already added";
         return false;
     }
 
-    debug() << "Protocol" << protocol->name() << "added to CM";
+    TP_QT_DEBUG() << "Protocol" << protocol->name() << "added to CM";
     mPriv->protocols.insert(protocol->name(), protocol);
     return true;
 }
@@ -359,14 +361,14 @@ bool BaseConnectionManager::registerObject(const QString &busName, const QString
         escapedProtocolName.replace(QLatin1Char('-'), QLatin1Char('_'));
         QString protoObjectPath = QString(
                 QLatin1String("%1/%2")).arg(objectPath).arg(escapedProtocolName);
-        debug() << "Registering protocol" << protocol->name() << "at path" << protoObjectPath <<
+        TP_QT_DEBUG() << "Registering protocol" << protocol->name() << "at path" << protoObjectPath <<
             "for CM" << objectPath << "at bus name" << busName;
         if (!protocol->registerObject(busName, protoObjectPath, error)) {
             return false;
         }
     }
 
-    debug() << "Registering CM" << objectPath << "at bus name" << busName;
+    TP_QT_DEBUG() << "Registering CM" << objectPath << "at bus name" << busName;
     // Only call DBusService::registerObject after registering the protocols as we don't want to
     // advertise isRegistered if some protocol cannot be registered
     if (!DBusService::registerObject(busName, objectPath, error)) {
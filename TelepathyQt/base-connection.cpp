@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryService
+
 #include <TelepathyQt/BaseConnection>
 #include "TelepathyQt/base-connection-internal.h"
 
@@ -32,12 +34,142 @@
 #include <TelepathyQt/DBusObject>
 #include <TelepathyQt/Utils>
 #include <TelepathyQt/AbstractProtocolInterface>
+#include <QMetaMethod>
+#include <QPointer>
 #include <QString>
 #include <QVariantMap>
 
 namespace Tp
 {
 
+namespace
+{
+
+// Finishes a D-Bus method call once the DeferredResult handed to an
+// asynchronous callback is finished
+template<typename T, typename ContextPtr>
+struct DeferredReply
+{
+    DeferredReply(const ContextPtr &context)
+        : context(context)
+    {
+    }
+
+    void operator()(const CompletionHandle &completion, const T &result) const
+    {
+        if (completion.isError()) {
+            context->setFinishedWithError(completion.errorName(), completion.errorMessage());
+            return;
+        }
+        context->setFinished(result);
+    }
+
+    ContextPtr context;
+};
+
+template<typename T, typename ContextPtr>
+DeferredResultPtr<T> deferredReply(const ContextPtr &context)
+{
+    return DeferredResultPtr<T>(new DeferredResult<T>(DeferredReply<T, ContextPtr>(context)));
+}
+
+struct RequestChannelReply
+{
+    RequestChannelReply(const Service::ConnectionAdaptor::RequestChannelContextPtr &context)
+        : context(context)
+    {
+    }
+
+    void operator()(const CompletionHandle &completion, const BaseChannelPtr &channel) const
+    {
+        if (completion.isError()) {
+            context->setFinishedWithError(completion.errorName(), completion.errorMessage());
+            return;
+        }
+        context->setFinished(QDBusObjectPath(channel->objectPath()));
+    }
+
+    Service::ConnectionAdaptor::RequestChannelContextPtr context;
+};
+
+struct CreateChannelReply
+{
+    CreateChannelReply(const Service::ConnectionInterfaceRequestsAdaptor::CreateChannelContextPtr &context)
+        : context(context)
+    {
+    }
+
+    void operator()(const CompletionHandle &completion, const BaseChannelPtr &channel) const
+    {
+        if (completion.isError()) {
+            context->setFinishedWithError(completion.errorName(), completion.errorMessage());
+            return;
+        }
+        context->setFinished(QDBusObjectPath(channel->objectPath()), channel->details().properties);
+    }
+
+    Service::ConnectionInterfaceRequestsAdaptor::CreateChannelContextPtr context;
+};
+
+struct ContactByIDAttributes
+{
+    ContactByIDAttributes(uint handle,
+            const Service::ConnectionInterfaceContactsAdaptor::GetContactByIDContextPtr &context)
+        : handle(handle),
+          context(context)
+    {
+    }
+
+    void operator()(const CompletionHandle &completion, const Tp::ContactAttributesMap &attributes) const
+    {
+        if (completion.isError()) {
+            context->setFinishedWithError(completion.errorName(), completion.errorMessage());
+            return;
+        }
+        context->setFinished(handle, attributes.value(handle));
+    }
+
+    uint handle;
+    Service::ConnectionInterfaceContactsAdaptor::GetContactByIDContextPtr context;
+};
+
+struct ContactByIDHandles
+{
+    ContactByIDHandles(BaseConnectionContactsInterface *interface, const QStringList &interfaces,
+            const Service::ConnectionInterfaceContactsAdaptor::GetContactByIDContextPtr &context)
+        : interface(interface),
+          interfaces(interfaces),
+          context(context)
+    {
+    }
+
+    void operator()(const CompletionHandle &completion, const Tp::UIntList &handles) const
+    {
+        // The check for empty handles is paranoid, because the error must be set in such case.
+        if (completion.isError() || handles.isEmpty()) {
+            context->setFinishedWithError(TP_QT_ERROR_INVALID_HANDLE, QLatin1String("Could not process ID"));
+            return;
+        }
+
+        if (!interface) {
+            context->setFinishedWithError(TP_QT_ERROR_DISCONNECTED,
+                    QLatin1String("The connection was destroyed"));
+            return;
+        }
+
+        const uint handle = handles.first();
+        interface->getContactAttributes(Tp::UIntList() << handle, interfaces,
+                DeferredResultPtr<Tp::ContactAttributesMap>(new DeferredResult<Tp::ContactAttributesMap>(
+                        ContactByIDAttributes(handle, context))));
+    }
+
+    QPointer<BaseConnectionContactsInterface> interface;
+    QStringList interfaces;
+    Service::ConnectionInterfaceContactsAdaptor::GetContactByIDContextPtr context;
+};
+
+}
+
 struct TP_QT_NO_EXPORT BaseConnection::Private {
     Private(BaseConnection *connection, const QDBusConnection &dbusConnection,
             const QString &cmName, const QString &protocolName,
@@ -62,12 +194,216 @@ struct TP_QT_NO_EXPORT BaseConnection::Private {
     QString selfID;
     uint status;
     CreateChannelCallback createChannelCB;
+    CreateChannelAsyncCallback createChannelAsyncCB;
     ConnectCallback connectCB;
     InspectHandlesCallback inspectHandlesCB;
     RequestHandlesCallback requestHandlesCB;
+    RequestHandlesAsyncCallback requestHandlesAsyncCB;
+    NormalizeIdentifierCallback normalizeIdentifierCB;
+
+    bool setUpChannel(const BaseChannelPtr &channel, const QVariantMap &request,
+            bool suppressHandler, DBusError *error);
+
+    // Continuation of the result handed to the CreateChannel async callback,
+    // which completes the channel set up before finishing the outer result
+    struct ChannelCreation
+    {
+        ChannelCreation(BaseConnection *connection, Private *priv, const QVariantMap &request,
+                bool suppressHandler, const DeferredResultPtr<BaseChannelPtr> &result)
+            : connection(connection),
+              priv(priv),
+              request(request),
+              suppressHandler(suppressHandler),
+              result(result)
+        {
+        }
+
+        void operator()(const CompletionHandle &created, const BaseChannelPtr &channel) const;
+
+        QPointer<BaseConnection> connection;
+        Private *priv;
+        QVariantMap request;
+        bool suppressHandler;
+        DeferredResultPtr<BaseChannelPtr> result;
+    };
+
+    // Built-in handle repository, used when no InspectHandles/RequestHandles
+    // callbacks are set. Identifiers are normalized once, and the normalized
+    // string is shared by both directions of the mapping and by the cache.
+    // Handles are never released, but the cache of raw identifiers is bounded,
+    // as they can be anything the clients ask for.
+    struct HandleRepository
+    {
+        HandleRepository() : lastHandle(0) {}
+
+        enum { MaxNormalizedIdentifiers = 1024 };
+
+        uint lastHandle;
+        QHash<uint, QString> identifiers;
+        QHash<QString, uint> handles;
+        QHash<QString, QString> normalized;
+    };
+
+    HandleRepository &repository(uint handleType) { return repositories[handleType]; }
+    static bool checkHandleType(uint handleType, DBusError *error);
+    QString normalizeIdentifier(uint handleType, const QString &identifier, DBusError *error);
+
+    QHash<uint, HandleRepository> repositories;
+
     BaseConnection::Adaptee *adaptee;
 };
 
+bool BaseConnection::Private::setUpChannel(const BaseChannelPtr &channel,
+        const QVariantMap &request, bool suppressHandler, DBusError *error)
+{
+    if (request.contains(TP_QT_IFACE_CHANNEL + QLatin1String(".InitiatorHandle"))) {
+        channel->setInitiatorHandle(request.value(TP_QT_IFACE_CHANNEL + QLatin1String(".InitiatorHandle")).toUInt());
+    }
+
+    bool needTargetID = (channel->targetHandle() != 0) && channel->targetID().isEmpty();
+    bool needInitiatorID = (channel->initiatorHandle() != 0) && channel->initiatorID().isEmpty();
+
+    // Resolve both contacts with a single lookup where possible
+    if (needTargetID && needInitiatorID && channel->targetHandleType() == HandleTypeContact) {
+        QStringList list = connection->inspectHandles(HandleTypeContact,
+                UIntList() << channel->targetHandle() << channel->initiatorHandle(), error);
+        if (error->isValid() || list.count() != 2) {
+            TP_QT_DEBUG() << "BaseConnection::createChannel: could not resolve handles " << channel->targetHandle()
+                    << channel->initiatorHandle();
+            if (!error->isValid()) {
+                error->set(TP_QT_ERROR_INVALID_HANDLE, QString(QLatin1String("Could not resolve handles %1 and %2"))
+                        .arg(channel->targetHandle()).arg(channel->initiatorHandle()));
+            }
+            return false;
+        }
+        TP_QT_DEBUG() << "BaseConnection::createChannel: found targetID " << list.at(0) << "and initiatorID " << list.at(1);
+        channel->setTargetID(list.at(0));
+        channel->setInitiatorID(list.at(1));
+        needTargetID = needInitiatorID = false;
+    }
+
+    if (needTargetID) {
+        QStringList list = connection->inspectHandles(channel->targetHandleType(),  UIntList() << channel->targetHandle(), error);
+        if (error->isValid() || list.isEmpty()) {
+            TP_QT_DEBUG() << "BaseConnection::createChannel: could not resolve handle " << channel->targetHandle();
+            if (!error->isValid()) {
+                error->set(TP_QT_ERROR_INVALID_HANDLE, QString(QLatin1String("Could not resolve the target handle %1"))
+                        .arg(channel->targetHandle()));
+            }
+            return false;
+        } else {
+            TP_QT_DEBUG() << "BaseConnection::createChannel: found targetID " << *list.begin();
+            channel->setTargetID(*list.begin());
+        }
+    }
+
+    if (needInitiatorID) {
+        QStringList list = connection->inspectHandles(HandleTypeContact, UIntList() << channel->initiatorHandle(), error);
+        if (error->isValid() || list.isEmpty()) {
+            TP_QT_DEBUG() << "BaseConnection::createChannel: could not resolve handle " << channel->initiatorHandle();
+            if (!error->isValid()) {
+                error->set(TP_QT_ERROR_INVALID_HANDLE, QString(QLatin1String("Could not resolve the initiator handle %1"))
+                        .arg(channel->initiatorHandle()));
+            }
+            return false;
+        } else {
+            TP_QT_DEBUG() << "BaseConnection::createChannel: found initiatorID " << *list.begin();
+            channel->setInitiatorID(*list.begin());
+        }
+    }
+    channel->setRequested(suppressHandler);
+
+    channel->registerObject(error);
+    if (error->isValid())
+        return false;
+
+    connection->addChannel(channel, suppressHandler);
+    return true;
+}
+
+void BaseConnection::Private::ChannelCreation::operator()(const CompletionHandle &created,
+        const BaseChannelPtr &channel) const
+{
+    if (created.isError()) {
+        result->setFinishedWithError(created.errorName(), created.errorMessage());
+        return;
+    }
+
+    if (!connection) {
+        result->setFinishedWithError(TP_QT_ERROR_DISCONNECTED,
+                QLatin1String("The connection was destroyed before the channel was created"));
+        return;
+    }
+
+    if (!channel) {
+        result->setFinishedWithError(TP_QT_ERROR_NOT_AVAILABLE,
+                QLatin1String("No channel was created"));
+        return;
+    }
+
+    DBusError error;
+    if (!priv->setUpChannel(channel, request, suppressHandler, &error)) {
+        result->setFinishedWithError(error.name(), error.message());
+        return;
+    }
+    result->setFinished(channel);
+}
+
+bool BaseConnection::Private::checkHandleType(uint handleType, DBusError *error)
+{
+    if (handleType == HandleTypeContact || handleType == HandleTypeRoom) {
+        return true;
+    }
+
+    if (handleType == HandleTypeList || handleType == HandleTypeGroup) {
+        error->set(TP_QT_ERROR_NOT_IMPLEMENTED,
+                QString(QLatin1String("Handle type %1 is not supported")).arg(handleType));
+    } else {
+        error->set(TP_QT_ERROR_INVALID_ARGUMENT,
+                QString(QLatin1String("Invalid handle type %1")).arg(handleType));
+    }
+    return false;
+}
+
+QString BaseConnection::Private::normalizeIdentifier(uint handleType, const QString &identifier,
+        DBusError *error)
+{
+    HandleRepository &repo = repository(handleType);
+
+    QHash<QString, QString>::const_iterator i = repo.normalized.constFind(identifier);
+    if (i != repo.normalized.constEnd()) {
+        return i.value();
+    }
+
+    QString normalizedIdentifier = identifier;
+    if (normalizeIdentifierCB.isValid()) {
+        normalizedIdentifier = normalizeIdentifierCB(handleType, identifier, error);
+        if (error->isValid()) {
+            return QString();
+        }
+    }
+
+    if (normalizedIdentifier.isEmpty()) {
+        error->set(TP_QT_ERROR_INVALID_HANDLE, QLatin1String("Invalid identifier"));
+        return QString();
+    }
+
+    // Intern the normalized form, so that every identifier normalizing to it
+    // shares the same string data
+    QHash<QString, uint>::const_iterator known = repo.handles.constFind(normalizedIdentifier);
+    if (known != repo.handles.constEnd()) {
+        normalizedIdentifier = known.key();
+    }
+
+    if (repo.normalized.size() >= HandleRepository::MaxNormalizedIdentifiers) {
+        // Start over rather than keeping track of the least recently used
+        // identifiers, the cache only saves normalizing them again
+        repo.normalized.clear();
+    }
+    repo.normalized.insert(identifier, normalizedIdentifier);
+    return normalizedIdentifier;
+}
+
 BaseConnection::Adaptee::Adaptee(const QDBusConnection &dbusConnection,
                                  BaseConnection *connection)
     : QObject(connection),
@@ -129,7 +465,7 @@ void BaseConnection::Adaptee::connect(const Tp::Service::ConnectionAdaptor::Conn
 
 void BaseConnection::Adaptee::disconnect(const Tp::Service::ConnectionAdaptor::DisconnectContextPtr &context)
 {
-    debug() << "BaseConnection::Adaptee::disconnect";
+    TP_QT_DEBUG() << "BaseConnection::Adaptee::disconnect";
 
     foreach(const BaseChannelPtr &channel, mConnection->mPriv->channels) {
         /* BaseChannel::closed() signal triggers removeChannel() method call with proper cleanup */
@@ -192,7 +528,7 @@ void BaseConnection::Adaptee::listChannels(const Service::ConnectionAdaptor::Lis
 void BaseConnection::Adaptee::requestChannel(const QString &type, uint handleType, uint handle, bool suppressHandler,
         const Tp::Service::ConnectionAdaptor::RequestChannelContextPtr &context)
 {
-    debug() << "BaseConnection::Adaptee::requestChannel (deprecated)";
+    TP_QT_DEBUG() << "BaseConnection::Adaptee::requestChannel (deprecated)";
     DBusError error;
 
     QVariantMap request;
@@ -200,13 +536,18 @@ void BaseConnection::Adaptee::requestChannel(const QString &type, uint handleTyp
     request[TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandleType")] = handleType;
     request[TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandle")] = handle;
 
-    bool yours;
-    BaseChannelPtr channel = mConnection->ensureChannel(request, yours, suppressHandler, &error);
-    if (error.isValid() || !channel) {
+    BaseChannelPtr channel = mConnection->getExistingChannel(request, &error);
+    if (error.isValid()) {
         context->setFinishedWithError(error.name(), error.message());
         return;
     }
-    context->setFinished(QDBusObjectPath(channel->objectPath()));
+    if (channel) {
+        context->setFinished(QDBusObjectPath(channel->objectPath()));
+        return;
+    }
+
+    mConnection->createChannel(request, suppressHandler,
+            DeferredResultPtr<BaseChannelPtr>(new DeferredResult<BaseChannelPtr>(RequestChannelReply(context))));
 }
 
 void BaseConnection::Adaptee::releaseHandles(uint handleType, const UIntList &handles, const Service::ConnectionAdaptor::ReleaseHandlesContextPtr &context)
@@ -220,13 +561,7 @@ void BaseConnection::Adaptee::releaseHandles(uint handleType, const UIntList &ha
 void BaseConnection::Adaptee::requestHandles(uint handleType, const QStringList &identifiers,
         const Tp::Service::ConnectionAdaptor::RequestHandlesContextPtr &context)
 {
-    DBusError error;
-    Tp::UIntList handles = mConnection->requestHandles(handleType, identifiers, &error);
-    if (error.isValid()) {
-        context->setFinishedWithError(error.name(), error.message());
-        return;
-    }
-    context->setFinished(handles);
+    mConnection->requestHandles(handleType, identifiers, deferredReply<Tp::UIntList>(context));
 }
 
 /**
@@ -321,8 +656,8 @@ void BaseConnection::setSelfHandle(uint selfHandle)
     }
 
     mPriv->selfHandle = selfHandle;
-    QMetaObject::invokeMethod(mPriv->adaptee, "selfHandleChanged", Q_ARG(uint, mPriv->selfHandle)); //Can simply use emit in Qt5
-    QMetaObject::invokeMethod(mPriv->adaptee, "selfContactChanged", Q_ARG(uint, mPriv->selfHandle), Q_ARG(QString, mPriv->selfID)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->selfHandleChanged(mPriv->selfHandle);
+    emit mPriv->adaptee->selfContactChanged(mPriv->selfHandle, mPriv->selfID);
 }
 
 QString BaseConnection::selfID() const
@@ -337,7 +672,7 @@ void BaseConnection::setSelfID(const QString &selfID)
     }
 
     mPriv->selfID = selfID;
-    QMetaObject::invokeMethod(mPriv->adaptee, "selfContactChanged", Q_ARG(uint, mPriv->selfHandle), Q_ARG(QString, mPriv->selfID)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->selfContactChanged(mPriv->selfHandle, mPriv->selfID);
 }
 
 void BaseConnection::setSelfContact(uint selfHandle, const QString &selfID)
@@ -347,27 +682,27 @@ void BaseConnection::setSelfContact(uint selfHandle, const QString &selfID)
     }
 
     if (selfHandle != mPriv->selfHandle) {
-        QMetaObject::invokeMethod(mPriv->adaptee, "selfHandleChanged", Q_ARG(uint, mPriv->selfHandle)); //Can simply use emit in Qt5
+        emit mPriv->adaptee->selfHandleChanged(mPriv->selfHandle);
         mPriv->selfHandle = selfHandle;
     }
 
     mPriv->selfID = selfID;
-    QMetaObject::invokeMethod(mPriv->adaptee, "selfContactChanged", Q_ARG(uint, mPriv->selfHandle), Q_ARG(QString, mPriv->selfID)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->selfContactChanged(mPriv->selfHandle, mPriv->selfID);
 }
 
 uint BaseConnection::status() const
 {
-    debug() << "BaseConnection::status = " << mPriv->status << " " << this;
+    TP_QT_DEBUG() << "BaseConnection::status = " << mPriv->status << " " << this;
     return mPriv->status;
 }
 
 void BaseConnection::setStatus(uint newStatus, uint reason)
 {
-    debug() << "BaseConnection::setStatus " << newStatus << " " << reason << " " << this;
+    TP_QT_DEBUG() << "BaseConnection::setStatus " << newStatus << " " << reason << " " << this;
     bool changed = (newStatus != mPriv->status);
     mPriv->status = newStatus;
     if (changed)
-        QMetaObject::invokeMethod(mPriv->adaptee, "statusChanged", Q_ARG(uint, newStatus), Q_ARG(uint, reason)); //Can simply use emit in Qt5
+        emit mPriv->adaptee->statusChanged(newStatus, reason);
 }
 
 void BaseConnection::setCreateChannelCallback(const CreateChannelCallback &cb)
@@ -381,10 +716,6 @@ Tp::BaseChannelPtr BaseConnection::createChannel(const QVariantMap &request, boo
         error->set(TP_QT_ERROR_NOT_IMPLEMENTED, QLatin1String("Not implemented"));
         return BaseChannelPtr();
     }
-    if (!mPriv->inspectHandlesCB.isValid()) {
-        error->set(TP_QT_ERROR_NOT_IMPLEMENTED, QLatin1String("Not implemented"));
-        return BaseChannelPtr();
-    }
 
     if (request.contains(TP_QT_IFACE_CHANNEL + QLatin1String(".Requested"))) {
         error->set(TP_QT_ERROR_INVALID_ARGUMENT, QString(QLatin1String("The %1.Requested property must not be presented in the request details.")).arg(TP_QT_IFACE_CHANNEL));
@@ -398,44 +729,74 @@ Tp::BaseChannelPtr BaseConnection::createChannel(const QVariantMap &request, boo
     if (error->isValid())
         return BaseChannelPtr();
 
-    QString targetID = channel->targetID();
-    if ((channel->targetHandle() != 0) && targetID.isEmpty()) {
-        QStringList list = mPriv->inspectHandlesCB(channel->targetHandleType(),  UIntList() << channel->targetHandle(), error);
-        if (error->isValid()) {
-            debug() << "BaseConnection::createChannel: could not resolve handle " << channel->targetHandle();
-            return BaseChannelPtr();
-        } else {
-            debug() << "BaseConnection::createChannel: found targetID " << *list.begin();
-            targetID = *list.begin();
-        }
-        channel->setTargetID(targetID);
+    if (!channel) {
+        error->set(TP_QT_ERROR_NOT_AVAILABLE, QLatin1String("No channel was created"));
+        return BaseChannelPtr();
     }
 
-    if (request.contains(TP_QT_IFACE_CHANNEL + QLatin1String(".InitiatorHandle"))) {
-        channel->setInitiatorHandle(request.value(TP_QT_IFACE_CHANNEL + QLatin1String(".InitiatorHandle")).toUInt());
-    }
+    if (!mPriv->setUpChannel(channel, request, suppressHandler, error))
+        return BaseChannelPtr();
 
-    QString initiatorID = channel->initiatorID();
-    if ((channel->initiatorHandle() != 0) && initiatorID.isEmpty()) {
-        QStringList list = mPriv->inspectHandlesCB(HandleTypeContact, UIntList() << channel->initiatorHandle(), error);
-        if (error->isValid()) {
-            debug() << "BaseConnection::createChannel: could not resolve handle " << channel->initiatorHandle();
-            return BaseChannelPtr();
-        } else {
-            debug() << "BaseConnection::createChannel: found initiatorID " << *list.begin();
-            initiatorID = *list.begin();
+    return channel;
+}
+
+/**
+ * Set the callback used to create channels asynchronously.
+ *
+ * Unlike the callback set with setCreateChannelCallback(), \a cb does not
+ * have to return the channel right away. It receives a DeferredResult which it
+ * should finish with the new channel, or with an error, once the channel is
+ * ready, for instance after joining a chat room on the server. Meanwhile, the
+ * connection keeps serving other D-Bus calls.
+ *
+ * When set, this callback is used for channel requests coming from D-Bus
+ * instead of the one set with setCreateChannelCallback(), which is still used
+ * by the synchronous createChannel() and ensureChannel() overloads.
+ *
+ * \param cb The callback to set.
+ * \sa createChannel()
+ */
+void BaseConnection::setCreateChannelAsyncCallback(const CreateChannelAsyncCallback &cb)
+{
+    mPriv->createChannelAsyncCB = cb;
+}
+
+/**
+ * Create a new channel satisfying the given \a request, and finish \a result
+ * with it once it has been registered and announced.
+ *
+ * This uses the callback set with setCreateChannelAsyncCallback() if any, and
+ * the one set with setCreateChannelCallback() otherwise.
+ *
+ * \param request A dictionary containing the desirable properties.
+ * \param suppressHandler An option to suppress handler for the new channel.
+ * \param result The result to finish with the new channel, or with an error.
+ */
+void BaseConnection::createChannel(const QVariantMap &request, bool suppressHandler,
+        const DeferredResultPtr<BaseChannelPtr> &result)
+{
+    if (!mPriv->createChannelAsyncCB.isValid()) {
+        DBusError error;
+        BaseChannelPtr channel = createChannel(request, suppressHandler, &error);
+        if (error.isValid() || !channel) {
+            result->setFinishedWithError(error.name(), error.message());
+            return;
         }
-        channel->setInitiatorID(initiatorID);
+        result->setFinished(channel);
+        return;
     }
-    channel->setRequested(suppressHandler);
 
-    channel->registerObject(error);
-    if (error->isValid())
-        return BaseChannelPtr();
+    if (request.contains(TP_QT_IFACE_CHANNEL + QLatin1String(".Requested"))) {
+        result->setFinishedWithError(TP_QT_ERROR_INVALID_ARGUMENT, QString(QLatin1String("The %1.Requested property must not be presented in the request details.")).arg(TP_QT_IFACE_CHANNEL));
+        return;
+    }
 
-    addChannel(channel, suppressHandler);
+    QVariantMap requestDetails = request;
+    requestDetails[TP_QT_IFACE_CHANNEL + QLatin1String(".Requested")] = suppressHandler;
 
-    return channel;
+    mPriv->createChannelAsyncCB(requestDetails, DeferredResultPtr<BaseChannelPtr>(
+                new DeferredResult<BaseChannelPtr>(
+                    Private::ChannelCreation(this, mPriv, request, suppressHandler, result))));
 }
 
 void BaseConnection::setConnectCallback(const ConnectCallback &cb)
@@ -450,11 +811,26 @@ void BaseConnection::setInspectHandlesCallback(const InspectHandlesCallback &cb)
 
 QStringList BaseConnection::inspectHandles(uint handleType, const Tp::UIntList &handles, DBusError *error)
 {
-    if (!mPriv->inspectHandlesCB.isValid()) {
-        error->set(TP_QT_ERROR_NOT_IMPLEMENTED, QLatin1String("Not implemented"));
+    if (mPriv->inspectHandlesCB.isValid()) {
+        return mPriv->inspectHandlesCB(handleType, handles, error);
+    }
+
+    if (!Private::checkHandleType(handleType, error)) {
         return QStringList();
     }
-    return mPriv->inspectHandlesCB(handleType, handles, error);
+
+    const Private::HandleRepository &repo = mPriv->repository(handleType);
+    QStringList identifiers;
+    identifiers.reserve(handles.count());
+    foreach (uint handle, handles) {
+        QHash<uint, QString>::const_iterator i = repo.identifiers.constFind(handle);
+        if (i == repo.identifiers.constEnd()) {
+            error->set(TP_QT_ERROR_INVALID_HANDLE, QString(QLatin1String("Unknown handle %1")).arg(handle));
+            return QStringList();
+        }
+        identifiers << i.value();
+    }
+    return identifiers;
 }
 
 void BaseConnection::setRequestHandlesCallback(const RequestHandlesCallback &cb)
@@ -464,16 +840,148 @@ void BaseConnection::setRequestHandlesCallback(const RequestHandlesCallback &cb)
 
 Tp::UIntList BaseConnection::requestHandles(uint handleType, const QStringList &identifiers, DBusError *error)
 {
-    if (!mPriv->requestHandlesCB.isValid()) {
-        error->set(TP_QT_ERROR_NOT_IMPLEMENTED, QLatin1String("Not implemented"));
+    if (mPriv->requestHandlesCB.isValid()) {
+        return mPriv->requestHandlesCB(handleType, identifiers, error);
+    }
+
+    if (mPriv->requestHandlesAsyncCB.isValid()) {
+        // The built-in repository does not know about the handles given out
+        // by the asynchronous callback
+        error->set(TP_QT_ERROR_NOT_IMPLEMENTED, QLatin1String("Handles can only be requested asynchronously"));
         return Tp::UIntList();
     }
-    return mPriv->requestHandlesCB(handleType, identifiers, error);
+
+    Tp::UIntList handles;
+    handles.reserve(identifiers.count());
+    foreach (const QString &identifier, identifiers) {
+        uint handle = ensureHandle(handleType, identifier, error);
+        if (error->isValid()) {
+            return Tp::UIntList();
+        }
+        handles << handle;
+    }
+    return handles;
+}
+
+/**
+ * Set the callback used to request handles asynchronously.
+ *
+ * \a cb receives a DeferredResult which it should finish with the handles,
+ * or with an error, once they are known, without blocking the other D-Bus
+ * calls made to the connection meanwhile.
+ *
+ * When set, this callback is used instead of the one set with
+ * setRequestHandlesCallback() for RequestHandles calls coming from D-Bus.
+ *
+ * \param cb The callback to set.
+ * \sa requestHandles()
+ */
+void BaseConnection::setRequestHandlesAsyncCallback(const RequestHandlesAsyncCallback &cb)
+{
+    mPriv->requestHandlesAsyncCB = cb;
+}
+
+/**
+ * Request handles for \a identifiers, and finish \a result with them.
+ *
+ * This uses the callback set with setRequestHandlesAsyncCallback() if any,
+ * and falls back to the synchronous requestHandles() otherwise.
+ *
+ * \param handleType The handle type, as a Tp::HandleType.
+ * \param identifiers The identifiers to request handles for.
+ * \param result The result to finish with the handles, or with an error.
+ */
+void BaseConnection::requestHandles(uint handleType, const QStringList &identifiers,
+        const DeferredResultPtr<Tp::UIntList> &result)
+{
+    if (mPriv->requestHandlesAsyncCB.isValid()) {
+        mPriv->requestHandlesAsyncCB(handleType, identifiers, result);
+        return;
+    }
+
+    DBusError error;
+    Tp::UIntList handles = requestHandles(handleType, identifiers, &error);
+    if (error.isValid()) {
+        result->setFinishedWithError(error);
+        return;
+    }
+    result->setFinished(handles);
+}
+
+/**
+ * Set the callback used by the built-in handle repository to normalize
+ * identifiers before they are given a handle.
+ *
+ * The callback is called at most once per distinct identifier and handle type,
+ * as its results are cached. It should set \a error to
+ * TP_QT_ERROR_INVALID_HANDLE for identifiers which are not valid. Without a
+ * callback, identifiers are used as is.
+ *
+ * \param cb The callback to set.
+ * \sa ensureHandle()
+ */
+void BaseConnection::setNormalizeIdentifierCallback(const NormalizeIdentifierCallback &cb)
+{
+    mPriv->normalizeIdentifierCB = cb;
+}
+
+/**
+ * Return the handle for \a identifier in the built-in handle repository,
+ * allocating a new one if needed.
+ *
+ * The built-in repository backs inspectHandles() and requestHandles() unless
+ * the InspectHandles and RequestHandles callbacks are set, in which case it
+ * is only used by the connection manager itself, if at all.
+ *
+ * \param handleType The handle type, as a Tp::HandleType.
+ * \param identifier The identifier, which is normalized first.
+ * \param error Set if the handle type is not a contact or room one, or if the
+ *              identifier could not be normalized.
+ * \return The handle, or 0 on error.
+ * \sa setNormalizeIdentifierCallback(), handleIdentifier()
+ */
+uint BaseConnection::ensureHandle(uint handleType, const QString &identifier, DBusError *error)
+{
+    DBusError localError;
+    if (!error) {
+        error = &localError;
+    }
+
+    if (!Private::checkHandleType(handleType, error)) {
+        return 0;
+    }
+
+    QString normalizedIdentifier = mPriv->normalizeIdentifier(handleType, identifier, error);
+    if (error->isValid()) {
+        return 0;
+    }
+
+    Private::HandleRepository &repo = mPriv->repository(handleType);
+    uint handle = repo.handles.value(normalizedIdentifier);
+    if (!handle) {
+        handle = ++repo.lastHandle;
+        repo.handles.insert(normalizedIdentifier, handle);
+        repo.identifiers.insert(handle, normalizedIdentifier);
+    }
+    return handle;
+}
+
+/**
+ * Return the identifier of \a handle in the built-in handle repository.
+ *
+ * \param handleType The handle type, as a Tp::HandleType.
+ * \param handle The handle.
+ * \return The normalized identifier, or an empty string if \a handle is unknown.
+ * \sa ensureHandle()
+ */
+QString BaseConnection::handleIdentifier(uint handleType, uint handle) const
+{
+    return mPriv->repositories.value(handleType).identifiers.value(handle);
 }
 
 Tp::ChannelInfoList BaseConnection::channelsInfo()
 {
-    debug() << "BaseConnection::channelsInfo:";
+    TP_QT_DEBUG() << "BaseConnection::channelsInfo:";
     Tp::ChannelInfoList list;
     foreach(const BaseChannelPtr & c, mPriv->channels) {
         Tp::ChannelInfo info;
@@ -481,7 +989,7 @@ Tp::ChannelInfoList BaseConnection::channelsInfo()
         info.channelType = c->channelType();
         info.handle = c->targetHandle();
         info.handleType = c->targetHandleType();
-        debug() << "BaseConnection::channelsInfo " << info.channel.path();
+        TP_QT_DEBUG() << "BaseConnection::channelsInfo " << info.channel.path();
         list << info;
     }
     return list;
@@ -574,7 +1082,7 @@ Tp::BaseChannelPtr BaseConnection::ensureChannel(const QVariantMap &request, boo
 void BaseConnection::addChannel(BaseChannelPtr channel, bool suppressHandler)
 {
     if (mPriv->channels.contains(channel)) {
-        warning() << "BaseConnection::addChannel: Channel already added.";
+        TP_QT_WARNING() << "BaseConnection::addChannel: Channel already added.";
         return;
     }
 
@@ -585,19 +1093,20 @@ void BaseConnection::addChannel(BaseChannelPtr channel, bool suppressHandler)
 
     if (!reqIface.isNull()) {
         //emit after return
-        QMetaObject::invokeMethod(reqIface.data(), "newChannels",
-                                  Qt::QueuedConnection,
-                                  Q_ARG(Tp::ChannelDetailsList, ChannelDetailsList() << channel->details()));
+        static const QMetaMethod newChannelsSlot = BaseConnectionRequestsInterface::staticMetaObject.method(
+                BaseConnectionRequestsInterface::staticMetaObject.indexOfSlot("newChannels(Tp::ChannelDetailsList)"));
+        newChannelsSlot.invoke(reqIface.data(), Qt::QueuedConnection,
+                               Q_ARG(Tp::ChannelDetailsList, ChannelDetailsList() << channel->details()));
     }
 
     //emit after return
-    QMetaObject::invokeMethod(mPriv->adaptee, "newChannel",
-                              Qt::QueuedConnection,
-                              Q_ARG(QDBusObjectPath, QDBusObjectPath(channel->objectPath())),
-                              Q_ARG(QString, channel->channelType()),
-                              Q_ARG(uint, channel->targetHandleType()),
-                              Q_ARG(uint, channel->targetHandle()),
-                              Q_ARG(bool, suppressHandler));
+    static const QMetaMethod newChannelSignal = QMetaMethod::fromSignal(&Adaptee::newChannel);
+    newChannelSignal.invoke(mPriv->adaptee, Qt::QueuedConnection,
+                            Q_ARG(QDBusObjectPath, QDBusObjectPath(channel->objectPath())),
+                            Q_ARG(QString, channel->channelType()),
+                            Q_ARG(uint, channel->targetHandleType()),
+                            Q_ARG(uint, channel->targetHandle()),
+                            Q_ARG(bool, suppressHandler));
 
     QObject::connect(channel.data(),
                      SIGNAL(closed()),
@@ -665,24 +1174,24 @@ AbstractConnectionInterfacePtr BaseConnection::interface(const QString &interfac
 bool BaseConnection::plugInterface(const AbstractConnectionInterfacePtr &interface)
 {
     if (isRegistered()) {
-        warning() << "Unable to plug protocol interface " << interface->interfaceName() <<
+        TP_QT_WARNING() << "Unable to plug protocol interface " << interface->interfaceName() <<
                   "- protocol already registered";
         return false;
     }
 
     if (interface->isRegistered()) {
-        warning() << "Unable to plug protocol interface" << interface->interfaceName() <<
+        TP_QT_WARNING() << "Unable to plug protocol interface" << interface->interfaceName() <<
                   "- interface already registered";
         return false;
     }
 
     if (mPriv->interfaces.contains(interface->interfaceName())) {
-        warning() << "Unable to plug protocol interface" << interface->interfaceName() <<
+        TP_QT_WARNING() << "Unable to plug protocol interface" << interface->interfaceName() <<
                   "- another interface with same name already plugged";
         return false;
     }
 
-    debug() << "Interface" << interface->interfaceName() << "plugged";
+    TP_QT_DEBUG() << "Interface" << interface->interfaceName() << "plugged";
     mPriv->interfaces.insert(interface->interfaceName(), interface);
     interface->setBaseConnection(this);
     return true;
@@ -711,26 +1220,26 @@ bool BaseConnection::registerObject(DBusError *error)
             error->set(TP_QT_ERROR_INVALID_ARGUMENT,
                        mPriv->protocolName + QLatin1String("is not a valid protocol name"));
         }
-        debug() << "Unable to register connection - invalid protocol name";
+        TP_QT_DEBUG() << "Unable to register connection - invalid protocol name";
         return false;
     }
 
     QString escapedProtocolName = mPriv->protocolName;
     escapedProtocolName.replace(QLatin1Char('-'), QLatin1Char('_'));
     QString name = uniqueName();
-    debug() << "cmName: " << mPriv->cmName << " escapedProtocolName: " << escapedProtocolName << " name:" << name;
+    TP_QT_DEBUG() << "cmName: " << mPriv->cmName << " escapedProtocolName: " << escapedProtocolName << " name:" << name;
     QString busName = QString(QLatin1String("%1%2.%3.%4"))
                       .arg(TP_QT_CONNECTION_BUS_NAME_BASE, mPriv->cmName, escapedProtocolName, name);
     QString objectPath = QString(QLatin1String("%1%2/%3/%4"))
                          .arg(TP_QT_CONNECTION_OBJECT_PATH_BASE, mPriv->cmName, escapedProtocolName, name);
-    debug() << "busName: " << busName << " objectName: " << objectPath;
+    TP_QT_DEBUG() << "busName: " << busName << " objectName: " << objectPath;
     DBusError _error;
 
-    debug() << "Connection: registering interfaces  at " << dbusObject();
+    TP_QT_DEBUG() << "Connection: registering interfaces  at " << dbusObject();
     foreach(const AbstractConnectionInterfacePtr & iface, mPriv->interfaces) {
         if (!iface->registerInterface(dbusObject())) {
             // lets not fail if an optional interface fails registering, lets warn only
-            warning() << "Unable to register interface" << iface->interfaceName();
+            TP_QT_WARNING() << "Unable to register interface" << iface->interfaceName();
         }
     }
 
@@ -832,6 +1341,71 @@ void AbstractConnectionInterface::setBaseConnection(BaseConnection *connection)
 }
 
 // Conn.I.Requests
+struct TP_QT_NO_EXPORT BaseConnectionRequestsInterface::Private {
+    Private(BaseConnectionRequestsInterface *parent, BaseConnection *connection_)
+        : connection(connection_), adaptee(new BaseConnectionRequestsInterface::Adaptee(parent)) {
+    }
+
+    typedef Service::ConnectionInterfaceRequestsAdaptor::EnsureChannelContextPtr EnsureChannelContextPtr;
+
+    // Channel type, target handle type and target handle of an EnsureChannel
+    // request
+    typedef QPair<QString, QPair<uint, uint> > EnsureChannelKey;
+
+    // Continuation of the channel created for an EnsureChannel request, which
+    // also answers the requests for the same target made in the meantime
+    struct EnsureChannelReply
+    {
+        EnsureChannelReply(BaseConnectionRequestsInterface *interface, Private *priv,
+                const EnsureChannelKey &key, const EnsureChannelContextPtr &context)
+            : interface(interface),
+              priv(priv),
+              key(key),
+              context(context)
+        {
+        }
+
+        void operator()(const CompletionHandle &completion, const BaseChannelPtr &channel) const;
+
+        QPointer<BaseConnectionRequestsInterface> interface;
+        Private *priv;
+        EnsureChannelKey key;
+        EnsureChannelContextPtr context;
+    };
+
+    BaseConnection *connection;
+    BaseConnectionRequestsInterface::Adaptee *adaptee;
+
+    // EnsureChannel requests waiting for a channel which is still being
+    // created for an earlier request with the same key. Requests without a
+    // TargetHandle are not tracked.
+    QHash<EnsureChannelKey, QList<EnsureChannelContextPtr> > pendingEnsures;
+};
+
+void BaseConnectionRequestsInterface::Private::EnsureChannelReply::operator()(
+        const CompletionHandle &completion, const BaseChannelPtr &channel) const
+{
+    QList<EnsureChannelContextPtr> waiting;
+    if (interface) {
+        waiting = priv->pendingEnsures.take(key);
+    }
+
+    if (completion.isError()) {
+        context->setFinishedWithError(completion.errorName(), completion.errorMessage());
+        foreach (const EnsureChannelContextPtr &other, waiting) {
+            other->setFinishedWithError(completion.errorName(), completion.errorMessage());
+        }
+        return;
+    }
+
+    const QDBusObjectPath objectPath(channel->objectPath());
+    const QVariantMap properties = channel->details().properties;
+    context->setFinished(/* yours */ true, objectPath, properties);
+    foreach (const EnsureChannelContextPtr &other, waiting) {
+        other->setFinished(/* yours */ false, objectPath, properties);
+    }
+}
+
 BaseConnectionRequestsInterface::Adaptee::Adaptee(BaseConnectionRequestsInterface *interface)
     : QObject(interface),
       mInterface(interface)
@@ -846,40 +1420,51 @@ void BaseConnectionRequestsInterface::Adaptee::ensureChannel(const QVariantMap &
         const Tp::Service::ConnectionInterfaceRequestsAdaptor::EnsureChannelContextPtr &context)
 {
     DBusError error;
-    bool yours;
-    QDBusObjectPath channel;
-    QVariantMap details;
-
-    mInterface->ensureChannel(request, yours, channel, details, &error);
+    BaseConnection *connection = mInterface->mPriv->connection;
+    BaseChannelPtr channel = connection->getExistingChannel(request, &error);
     if (error.isValid()) {
         context->setFinishedWithError(error.name(), error.message());
         return;
     }
-    context->setFinished(yours, channel, details);
+    if (channel) {
+        context->setFinished(/* yours */ false, QDBusObjectPath(channel->objectPath()),
+                channel->details().properties);
+        return;
+    }
+
+    Private *priv = mInterface->mPriv;
+    const Private::EnsureChannelKey key(
+            request.value(TP_QT_IFACE_CHANNEL + QLatin1String(".ChannelType")).toString(),
+            qMakePair(request.value(TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandleType")).toUInt(),
+                      request.value(TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandle")).toUInt()));
+    const bool tracked = key.second.second != 0;
+
+    // A channel for the same target is already being created, so wait for it
+    // rather than creating another one
+    if (tracked && priv->pendingEnsures.contains(key)) {
+        priv->pendingEnsures[key].append(context);
+        return;
+    }
+
+    if (tracked) {
+        priv->pendingEnsures.insert(key, QList<Private::EnsureChannelContextPtr>());
+    }
+    connection->createChannel(request, /* suppressHandler */ true,
+            DeferredResultPtr<BaseChannelPtr>(new DeferredResult<BaseChannelPtr>(
+                    Private::EnsureChannelReply(mInterface, priv, key, context))));
 }
 
 void BaseConnectionRequestsInterface::Adaptee::createChannel(const QVariantMap &request,
         const Tp::Service::ConnectionInterfaceRequestsAdaptor::CreateChannelContextPtr &context)
 {
-    DBusError error;
-    QDBusObjectPath channel;
-    QVariantMap details;
-
-    mInterface->createChannel(request, channel, details, &error);
-    if (error.isValid()) {
-        context->setFinishedWithError(error.name(), error.message());
+    if (!request.contains(TP_QT_IFACE_CHANNEL + QLatin1String(".ChannelType"))) {
+        context->setFinishedWithError(TP_QT_ERROR_INVALID_ARGUMENT, QLatin1String("Missing parameters"));
         return;
     }
-    context->setFinished(channel, details);
-}
 
-struct TP_QT_NO_EXPORT BaseConnectionRequestsInterface::Private {
-    Private(BaseConnectionRequestsInterface *parent, BaseConnection *connection_)
-        : connection(connection_), adaptee(new BaseConnectionRequestsInterface::Adaptee(parent)) {
-    }
-    BaseConnection *connection;
-    BaseConnectionRequestsInterface::Adaptee *adaptee;
-};
+    mInterface->mPriv->connection->createChannel(request, /* suppressHandler */ true,
+            DeferredResultPtr<BaseChannelPtr>(new DeferredResult<BaseChannelPtr>(CreateChannelReply(context))));
+}
 
 /**
  * \class BaseConnectionRequestsInterface
@@ -935,12 +1520,12 @@ Tp::ChannelDetailsList BaseConnectionRequestsInterface::Adaptee::channels() cons
 
 void BaseConnectionRequestsInterface::newChannels(const Tp::ChannelDetailsList &channels)
 {
-    QMetaObject::invokeMethod(mPriv->adaptee,"newChannels", Q_ARG(Tp::ChannelDetailsList,channels)); //Can replace by a direct call in Qt5
+    emit mPriv->adaptee->newChannels(channels);
 }
 
 void BaseConnectionRequestsInterface::channelClosed(const QDBusObjectPath &removed)
 {
-    QMetaObject::invokeMethod(mPriv->adaptee,"channelClosed", Q_ARG(QDBusObjectPath, removed)); //Can replace by a direct call in Qt5
+    emit mPriv->adaptee->channelClosed(removed);
 }
 
 void BaseConnectionRequestsInterface::ensureChannel(const QVariantMap &request, bool &yours,
@@ -984,6 +1569,7 @@ struct TP_QT_NO_EXPORT BaseConnectionContactsInterface::Private {
 
     QStringList contactAttributeInterfaces;
     GetContactAttributesCallback getContactAttributesCB;
+    GetContactAttributesAsyncCallback getContactAttributesAsyncCB;
     BaseConnection *connection;
     BaseConnectionContactsInterface::Adaptee *adaptee;
 };
@@ -1006,29 +1592,17 @@ QStringList BaseConnectionContactsInterface::Adaptee::contactAttributeInterfaces
 void BaseConnectionContactsInterface::Adaptee::getContactAttributes(const Tp::UIntList &handles, const QStringList &interfaces, bool /* hold */,
         const Tp::Service::ConnectionInterfaceContactsAdaptor::GetContactAttributesContextPtr &context)
 {
-    DBusError error;
-    Tp::ContactAttributesMap attributes = mInterface->getContactAttributes(handles, interfaces, &error);
-    if (error.isValid()) {
-        context->setFinishedWithError(error.name(), error.message());
-        return;
-    }
-    context->setFinished(attributes);
+    mInterface->getContactAttributes(handles, interfaces,
+            deferredReply<Tp::ContactAttributesMap>(context));
 }
 
 void BaseConnectionContactsInterface::Adaptee::getContactByID(const QString &identifier, const QStringList &interfaces,
         const Tp::Service::ConnectionInterfaceContactsAdaptor::GetContactByIDContextPtr &context)
 {
-    debug() << "BaseConnectionContactsInterface::Adaptee::getContactByID";
-    DBusError error;
-    uint handle;
-    QVariantMap attributes;
-
-    mInterface->getContactByID(identifier, interfaces, handle, attributes, &error);
-    if (error.isValid()) {
-        context->setFinishedWithError(error.name(), error.message());
-        return;
-    }
-    context->setFinished(handle, attributes);
+    TP_QT_DEBUG() << "BaseConnectionContactsInterface::Adaptee::getContactByID";
+    mInterface->mPriv->connection->requestHandles(Tp::HandleTypeContact, QStringList() << identifier,
+            DeferredResultPtr<Tp::UIntList>(new DeferredResult<Tp::UIntList>(
+                    ContactByIDHandles(mInterface, interfaces, context))));
 }
 
 /**
@@ -1107,6 +1681,54 @@ Tp::ContactAttributesMap BaseConnectionContactsInterface::getContactAttributes(c
     return mPriv->getContactAttributesCB(handles, interfaces, error);
 }
 
+/**
+ * Set the callback used to retrieve contact attributes asynchronously.
+ *
+ * \a cb receives a DeferredResult which it should finish with the
+ * attributes, or with an error, once they are known, for instance after a
+ * roster lookup on the server, without blocking the other D-Bus calls made to
+ * the connection meanwhile.
+ *
+ * When set, this callback is used instead of the one set with
+ * setGetContactAttributesCallback() for GetContactAttributes and GetContactByID
+ * calls coming from D-Bus.
+ *
+ * \param cb The callback to set.
+ * \sa getContactAttributes()
+ */
+void BaseConnectionContactsInterface::setGetContactAttributesAsyncCallback(const GetContactAttributesAsyncCallback &cb)
+{
+    mPriv->getContactAttributesAsyncCB = cb;
+}
+
+/**
+ * Retrieve the attributes of the contacts with the given \a handles, and
+ * finish \a result with them.
+ *
+ * This uses the callback set with setGetContactAttributesAsyncCallback() if
+ * any, and the one set with setGetContactAttributesCallback() otherwise.
+ *
+ * \param handles The contact handles.
+ * \param interfaces The interfaces whose attributes to retrieve.
+ * \param result The result to finish with the attributes, or with an error.
+ */
+void BaseConnectionContactsInterface::getContactAttributes(const Tp::UIntList &handles,
+        const QStringList &interfaces, const DeferredResultPtr<Tp::ContactAttributesMap> &result)
+{
+    if (mPriv->getContactAttributesAsyncCB.isValid()) {
+        mPriv->getContactAttributesAsyncCB(handles, interfaces, result);
+        return;
+    }
+
+    DBusError error;
+    Tp::ContactAttributesMap attributes = getContactAttributes(handles, interfaces, &error);
+    if (error.isValid()) {
+        result->setFinishedWithError(error);
+        return;
+    }
+    result->setFinished(attributes);
+}
+
 void BaseConnectionContactsInterface::getContactByID(const QString &identifier, const QStringList &interfaces, uint &handle, QVariantMap &attributes, DBusError *error)
 {
     const Tp::UIntList handles = mPriv->connection->requestHandles(Tp::HandleTypeContact, QStringList() << identifier, error);
@@ -1196,7 +1818,7 @@ void BaseConnectionSimplePresenceInterface::setPresences(const Tp::SimpleContact
     }
 
     if (!newPresences.isEmpty()) {
-        QMetaObject::invokeMethod(mPriv->adaptee, "presencesChanged", Q_ARG(Tp::SimpleContactPresences, newPresences)); //Can simply use emit in Qt5
+        emit mPriv->adaptee->presencesChanged(newPresences);
     }
 }
 
@@ -1256,14 +1878,14 @@ void BaseConnectionSimplePresenceInterface::Adaptee::setPresence(const QString &
 
     SimpleStatusSpecMap::Iterator i = mInterface->mPriv->statuses.find(status);
     if (i == mInterface->mPriv->statuses.end()) {
-        warning() << "BaseConnectionSimplePresenceInterface::Adaptee::setPresence: status is not in statuses";
+        TP_QT_WARNING() << "BaseConnectionSimplePresenceInterface::Adaptee::setPresence: status is not in statuses";
         context->setFinishedWithError(TP_QT_ERROR_INVALID_ARGUMENT, QLatin1String("status not in statuses"));
         return;
     }
 
     QString statusMessage = statusMessage_;
     if ((uint)statusMessage.length() > mInterface->mPriv->maximumStatusMessageLength) {
-        debug() << "BaseConnectionSimplePresenceInterface::Adaptee::setPresence: "
+        TP_QT_DEBUG() << "BaseConnectionSimplePresenceInterface::Adaptee::setPresence: "
                 << "truncating status to " << mInterface->mPriv->maximumStatusMessageLength;
         statusMessage = statusMessage.left(mInterface->mPriv->maximumStatusMessageLength);
     }
@@ -1284,9 +1906,9 @@ void BaseConnectionSimplePresenceInterface::Adaptee::setPresence(const QString &
     SimpleContactPresences presences;
     presences[selfHandle] = presence;
     //emit after return
-    QMetaObject::invokeMethod(mInterface->mPriv->adaptee, "presencesChanged",
-                              Qt::QueuedConnection,
-                              Q_ARG(Tp::SimpleContactPresences, presences));
+    static const QMetaMethod presencesChangedSignal = QMetaMethod::fromSignal(&Adaptee::presencesChanged);
+    presencesChangedSignal.invoke(this, Qt::QueuedConnection,
+                                  Q_ARG(Tp::SimpleContactPresences, presences));
     context->setFinished();
 }
 
@@ -1361,7 +1983,7 @@ bool BaseConnectionContactListInterface::Adaptee::downloadAtConnection() const
 void BaseConnectionContactListInterface::Adaptee::getContactListAttributes(const QStringList &interfaces, bool hold,
         const Tp::Service::ConnectionInterfaceContactListAdaptor::GetContactListAttributesContextPtr &context)
 {
-    debug() << "BaseConnectionContactListInterface::Adaptee::getContactListAttributes";
+    TP_QT_DEBUG() << "BaseConnectionContactListInterface::Adaptee::getContactListAttributes";
     DBusError error;
     Tp::ContactAttributesMap attributes = mInterface->getContactListAttributes(interfaces, hold, &error);
     if (error.isValid()) {
@@ -1374,7 +1996,7 @@ void BaseConnectionContactListInterface::Adaptee::getContactListAttributes(const
 void BaseConnectionContactListInterface::Adaptee::requestSubscription(const Tp::UIntList &contacts, const QString &message,
         const Tp::Service::ConnectionInterfaceContactListAdaptor::RequestSubscriptionContextPtr &context)
 {
-    debug() << "BaseConnectionContactListInterface::Adaptee::requestSubscription";
+    TP_QT_DEBUG() << "BaseConnectionContactListInterface::Adaptee::requestSubscription";
     DBusError error;
     mInterface->requestSubscription(contacts, message, &error);
     if (error.isValid()) {
@@ -1387,7 +2009,7 @@ void BaseConnectionContactListInterface::Adaptee::requestSubscription(const Tp::
 void BaseConnectionContactListInterface::Adaptee::authorizePublication(const Tp::UIntList &contacts,
         const Tp::Service::ConnectionInterfaceContactListAdaptor::AuthorizePublicationContextPtr &context)
 {
-    debug() << "BaseConnectionContactListInterface::Adaptee::authorizePublication";
+    TP_QT_DEBUG() << "BaseConnectionContactListInterface::Adaptee::authorizePublication";
     DBusError error;
     mInterface->authorizePublication(contacts, &error);
     if (error.isValid()) {
@@ -1400,7 +2022,7 @@ void BaseConnectionContactListInterface::Adaptee::authorizePublication(const Tp:
 void BaseConnectionContactListInterface::Adaptee::removeContacts(const Tp::UIntList &contacts,
         const Tp::Service::ConnectionInterfaceContactListAdaptor::RemoveContactsContextPtr &context)
 {
-    debug() << "BaseConnectionContactListInterface::Adaptee::removeContacts";
+    TP_QT_DEBUG() << "BaseConnectionContactListInterface::Adaptee::removeContacts";
     DBusError error;
     mInterface->removeContacts(contacts, &error);
     if (error.isValid()) {
@@ -1413,7 +2035,7 @@ void BaseConnectionContactListInterface::Adaptee::removeContacts(const Tp::UIntL
 void BaseConnectionContactListInterface::Adaptee::unsubscribe(const Tp::UIntList &contacts,
         const Tp::Service::ConnectionInterfaceContactListAdaptor::UnsubscribeContextPtr &context)
 {
-    debug() << "BaseConnectionContactListInterface::Adaptee::unsubscribe";
+    TP_QT_DEBUG() << "BaseConnectionContactListInterface::Adaptee::unsubscribe";
     DBusError error;
     mInterface->unsubscribe(contacts, &error);
     if (error.isValid()) {
@@ -1426,7 +2048,7 @@ void BaseConnectionContactListInterface::Adaptee::unsubscribe(const Tp::UIntList
 void BaseConnectionContactListInterface::Adaptee::unpublish(const Tp::UIntList &contacts,
         const Tp::Service::ConnectionInterfaceContactListAdaptor::UnpublishContextPtr &context)
 {
-    debug() << "BaseConnectionContactListInterface::Adaptee::unpublish";
+    TP_QT_DEBUG() << "BaseConnectionContactListInterface::Adaptee::unpublish";
     DBusError error;
     mInterface->unpublish(contacts, &error);
     if (error.isValid()) {
@@ -1439,7 +2061,7 @@ void BaseConnectionContactListInterface::Adaptee::unpublish(const Tp::UIntList &
 void BaseConnectionContactListInterface::Adaptee::download(
         const Tp::Service::ConnectionInterfaceContactListAdaptor::DownloadContextPtr &context)
 {
-    debug() << "BaseConnectionContactListInterface::Adaptee::download";
+    TP_QT_DEBUG() << "BaseConnectionContactListInterface::Adaptee::download";
     DBusError error;
     mInterface->download(&error);
     if (error.isValid()) {
@@ -1486,7 +2108,7 @@ void BaseConnectionContactListInterface::setContactListState(uint contactListSta
     }
 
     mPriv->contactListState = contactListState;
-    QMetaObject::invokeMethod(mPriv->adaptee, "contactListStateChanged", Q_ARG(uint, contactListState)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->contactListStateChanged(contactListState);
 }
 
 bool BaseConnectionContactListInterface::contactListPersists() const
@@ -1635,7 +2257,7 @@ void BaseConnectionContactListInterface::download(DBusError *error)
 
 void BaseConnectionContactListInterface::contactsChangedWithID(const Tp::ContactSubscriptionMap &changes, const Tp::HandleIdentifierMap &identifiers, const Tp::HandleIdentifierMap &removals)
 {
-    QMetaObject::invokeMethod(mPriv->adaptee, "contactsChangedWithID", Q_ARG(Tp::ContactSubscriptionMap, changes), Q_ARG(Tp::HandleIdentifierMap, identifiers), Q_ARG(Tp::HandleIdentifierMap, removals)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->contactsChangedWithID(changes, identifiers, removals);
 }
 
 // Conn.I.ContactGroups
@@ -1688,7 +2310,7 @@ QStringList BaseConnectionContactGroupsInterface::Adaptee::groups() const
 void BaseConnectionContactGroupsInterface::Adaptee::setContactGroups(uint contact, const QStringList &groups,
         const Tp::Service::ConnectionInterfaceContactGroupsAdaptor::SetContactGroupsContextPtr &context)
 {
-    debug() << "BaseConnectionContactGroupsInterface::Adaptee::setContactGroups";
+    TP_QT_DEBUG() << "BaseConnectionContactGroupsInterface::Adaptee::setContactGroups";
     DBusError error;
     mInterface->setContactGroups(contact, groups, &error);
     if (error.isValid()) {
@@ -1701,7 +2323,7 @@ void BaseConnectionContactGroupsInterface::Adaptee::setContactGroups(uint contac
 void BaseConnectionContactGroupsInterface::Adaptee::setGroupMembers(const QString &group, const Tp::UIntList &members,
         const Tp::Service::ConnectionInterfaceContactGroupsAdaptor::SetGroupMembersContextPtr &context)
 {
-    debug() << "BaseConnectionContactGroupsInterface::Adaptee::setGroupMembers";
+    TP_QT_DEBUG() << "BaseConnectionContactGroupsInterface::Adaptee::setGroupMembers";
     DBusError error;
     mInterface->setGroupMembers(group, members, &error);
     if (error.isValid()) {
@@ -1714,7 +2336,7 @@ void BaseConnectionContactGroupsInterface::Adaptee::setGroupMembers(const QStrin
 void BaseConnectionContactGroupsInterface::Adaptee::addToGroup(const QString &group, const Tp::UIntList &members,
         const Tp::Service::ConnectionInterfaceContactGroupsAdaptor::AddToGroupContextPtr &context)
 {
-    debug() << "BaseConnectionContactGroupsInterface::Adaptee::addToGroup";
+    TP_QT_DEBUG() << "BaseConnectionContactGroupsInterface::Adaptee::addToGroup";
     DBusError error;
     mInterface->addToGroup(group, members, &error);
     if (error.isValid()) {
@@ -1727,7 +2349,7 @@ void BaseConnectionContactGroupsInterface::Adaptee::addToGroup(const QString &gr
 void BaseConnectionContactGroupsInterface::Adaptee::removeFromGroup(const QString &group, const Tp::UIntList &members,
         const Tp::Service::ConnectionInterfaceContactGroupsAdaptor::RemoveFromGroupContextPtr &context)
 {
-    debug() << "BaseConnectionContactGroupsInterface::Adaptee::removeFromGroup";
+    TP_QT_DEBUG() << "BaseConnectionContactGroupsInterface::Adaptee::removeFromGroup";
     DBusError error;
     mInterface->removeFromGroup(group, members, &error);
     if (error.isValid()) {
@@ -1740,7 +2362,7 @@ void BaseConnectionContactGroupsInterface::Adaptee::removeFromGroup(const QStrin
 void BaseConnectionContactGroupsInterface::Adaptee::removeGroup(const QString &group,
         const Tp::Service::ConnectionInterfaceContactGroupsAdaptor::RemoveGroupContextPtr &context)
 {
-    debug() << "BaseConnectionContactGroupsInterface::Adaptee::removeGroup";
+    TP_QT_DEBUG() << "BaseConnectionContactGroupsInterface::Adaptee::removeGroup";
     DBusError error;
     mInterface->removeGroup(group, &error);
     if (error.isValid()) {
@@ -1753,7 +2375,7 @@ void BaseConnectionContactGroupsInterface::Adaptee::removeGroup(const QString &g
 void BaseConnectionContactGroupsInterface::Adaptee::renameGroup(const QString &oldName, const QString &newName,
         const Tp::Service::ConnectionInterfaceContactGroupsAdaptor::RenameGroupContextPtr &context)
 {
-    debug() << "BaseConnectionContactGroupsInterface::Adaptee::renameGroup";
+    TP_QT_DEBUG() << "BaseConnectionContactGroupsInterface::Adaptee::renameGroup";
     DBusError error;
     mInterface->renameGroup(oldName, newName, &error);
     if (error.isValid()) {
@@ -1916,22 +2538,22 @@ void BaseConnectionContactGroupsInterface::renameGroup(const QString &oldName, c
 
 void BaseConnectionContactGroupsInterface::groupsCreated(const QStringList &names)
 {
-    QMetaObject::invokeMethod(mPriv->adaptee, "groupsCreated", Q_ARG(QStringList, names)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->groupsCreated(names);
 }
 
 void BaseConnectionContactGroupsInterface::groupRenamed(const QString &oldName, const QString &newName)
 {
-    QMetaObject::invokeMethod(mPriv->adaptee, "groupRenamed", Q_ARG(QString, oldName), Q_ARG(QString, newName)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->groupRenamed(oldName, newName);
 }
 
 void BaseConnectionContactGroupsInterface::groupsRemoved(const QStringList &names)
 {
-    QMetaObject::invokeMethod(mPriv->adaptee, "groupsRemoved", Q_ARG(QStringList, names)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->groupsRemoved(names);
 }
 
 void BaseConnectionContactGroupsInterface::groupsChanged(const Tp::UIntList &contact, const QStringList &added, const QStringList &removed)
 {
-    QMetaObject::invokeMethod(mPriv->adaptee, "groupsChanged", Q_ARG(Tp::UIntList, contact), Q_ARG(QStringList, added), Q_ARG(QStringList, removed)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->groupsChanged(contact, added, removed);
 }
 
 // Conn.I.ContactInfo
@@ -1973,7 +2595,7 @@ Tp::FieldSpecs BaseConnectionContactInfoInterface::Adaptee::supportedFields() co
 void BaseConnectionContactInfoInterface::Adaptee::getContactInfo(const Tp::UIntList &contacts,
         const Tp::Service::ConnectionInterfaceContactInfoAdaptor::GetContactInfoContextPtr &context)
 {
-    debug() << "BaseConnectionContactInfoInterface::Adaptee::getContactInfo";
+    TP_QT_DEBUG() << "BaseConnectionContactInfoInterface::Adaptee::getContactInfo";
     DBusError error;
     Tp::ContactInfoMap contactInfo = mInterface->getContactInfo(contacts, &error);
     if (error.isValid()) {
@@ -1986,7 +2608,7 @@ void BaseConnectionContactInfoInterface::Adaptee::getContactInfo(const Tp::UIntL
 void BaseConnectionContactInfoInterface::Adaptee::refreshContactInfo(const Tp::UIntList &contacts,
         const Tp::Service::ConnectionInterfaceContactInfoAdaptor::RefreshContactInfoContextPtr &context)
 {
-    debug() << "BaseConnectionContactInfoInterface::Adaptee::refreshContactInfo";
+    TP_QT_DEBUG() << "BaseConnectionContactInfoInterface::Adaptee::refreshContactInfo";
     DBusError error;
     mInterface->refreshContactInfo(contacts, &error);
     if (error.isValid()) {
@@ -1999,7 +2621,7 @@ void BaseConnectionContactInfoInterface::Adaptee::refreshContactInfo(const Tp::U
 void BaseConnectionContactInfoInterface::Adaptee::requestContactInfo(uint contact,
         const Tp::Service::ConnectionInterfaceContactInfoAdaptor::RequestContactInfoContextPtr &context)
 {
-    debug() << "BaseConnectionContactInfoInterface::Adaptee::requestContactInfo";
+    TP_QT_DEBUG() << "BaseConnectionContactInfoInterface::Adaptee::requestContactInfo";
     DBusError error;
     Tp::ContactInfoFieldList contactInfo = mInterface->requestContactInfo(contact, &error);
     if (error.isValid()) {
@@ -2012,7 +2634,7 @@ void BaseConnectionContactInfoInterface::Adaptee::requestContactInfo(uint contac
 void BaseConnectionContactInfoInterface::Adaptee::setContactInfo(const Tp::ContactInfoFieldList &contactInfo,
         const Tp::Service::ConnectionInterfaceContactInfoAdaptor::SetContactInfoContextPtr &context)
 {
-    debug() << "BaseConnectionContactInfoInterface::Adaptee::setContactInfo";
+    TP_QT_DEBUG() << "BaseConnectionContactInfoInterface::Adaptee::setContactInfo";
     DBusError error;
     mInterface->setContactInfo(contactInfo, &error);
     if (error.isValid()) {
@@ -2131,7 +2753,7 @@ void BaseConnectionContactInfoInterface::setContactInfo(const Tp::ContactInfoFie
 
 void BaseConnectionContactInfoInterface::contactInfoChanged(uint contact, const Tp::ContactInfoFieldList &contactInfo)
 {
-    QMetaObject::invokeMethod(mPriv->adaptee, "contactInfoChanged", Q_ARG(uint, contact), Q_ARG(Tp::ContactInfoFieldList, contactInfo)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->contactInfoChanged(contact, contactInfo);
 }
 
 // Conn.I.Addressing
@@ -2267,7 +2889,7 @@ BaseConnectionAliasingInterface::Adaptee::~Adaptee()
 void BaseConnectionAliasingInterface::Adaptee::getAliasFlags(
         const Tp::Service::ConnectionInterfaceAliasingAdaptor::GetAliasFlagsContextPtr &context)
 {
-    debug() << "BaseConnectionAliasingInterface::Adaptee::getAliasFlags";
+    TP_QT_DEBUG() << "BaseConnectionAliasingInterface::Adaptee::getAliasFlags";
     DBusError error;
     Tp::ConnectionAliasFlags aliasFlags = mInterface->getAliasFlags(&error);
     if (error.isValid()) {
@@ -2280,7 +2902,7 @@ void BaseConnectionAliasingInterface::Adaptee::getAliasFlags(
 void BaseConnectionAliasingInterface::Adaptee::requestAliases(const Tp::UIntList &contacts,
         const Tp::Service::ConnectionInterfaceAliasingAdaptor::RequestAliasesContextPtr &context)
 {
-    debug() << "BaseConnectionAliasingInterface::Adaptee::requestAliases";
+    TP_QT_DEBUG() << "BaseConnectionAliasingInterface::Adaptee::requestAliases";
     DBusError error;
     QStringList aliases = mInterface->requestAliases(contacts, &error);
     if (error.isValid()) {
@@ -2293,7 +2915,7 @@ void BaseConnectionAliasingInterface::Adaptee::requestAliases(const Tp::UIntList
 void BaseConnectionAliasingInterface::Adaptee::getAliases(const Tp::UIntList &contacts,
         const Tp::Service::ConnectionInterfaceAliasingAdaptor::GetAliasesContextPtr &context)
 {
-    debug() << "BaseConnectionAliasingInterface::Adaptee::getAliases";
+    TP_QT_DEBUG() << "BaseConnectionAliasingInterface::Adaptee::getAliases";
     DBusError error;
     Tp::AliasMap aliases = mInterface->getAliases(contacts, &error);
     if (error.isValid()) {
@@ -2306,7 +2928,7 @@ void BaseConnectionAliasingInterface::Adaptee::getAliases(const Tp::UIntList &co
 void BaseConnectionAliasingInterface::Adaptee::setAliases(const Tp::AliasMap &aliases,
         const Tp::Service::ConnectionInterfaceAliasingAdaptor::SetAliasesContextPtr &context)
 {
-    debug() << "BaseConnectionAliasingInterface::Adaptee::setAliases";
+    TP_QT_DEBUG() << "BaseConnectionAliasingInterface::Adaptee::setAliases";
     DBusError error;
     mInterface->setAliases(aliases, &error);
     if (error.isValid()) {
@@ -2405,7 +3027,7 @@ void BaseConnectionAliasingInterface::setAliases(const Tp::AliasMap &aliases, DB
 
 void BaseConnectionAliasingInterface::aliasesChanged(const Tp::AliasPairList &aliases)
 {
-    QMetaObject::invokeMethod(mPriv->adaptee, "aliasesChanged", Q_ARG(Tp::AliasPairList, aliases)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->aliasesChanged(aliases);
 }
 
 // Conn.I.Avatars
@@ -2478,7 +3100,7 @@ uint BaseConnectionAvatarsInterface::Adaptee::maximumAvatarBytes() const
 void BaseConnectionAvatarsInterface::Adaptee::getKnownAvatarTokens(const Tp::UIntList &contacts,
         const Tp::Service::ConnectionInterfaceAvatarsAdaptor::GetKnownAvatarTokensContextPtr &context)
 {
-    debug() << "BaseConnectionAvatarsInterface::Adaptee::getKnownAvatarTokens";
+    TP_QT_DEBUG() << "BaseConnectionAvatarsInterface::Adaptee::getKnownAvatarTokens";
     DBusError error;
     Tp::AvatarTokenMap tokens = mInterface->getKnownAvatarTokens(contacts, &error);
     if (error.isValid()) {
@@ -2491,7 +3113,7 @@ void BaseConnectionAvatarsInterface::Adaptee::getKnownAvatarTokens(const Tp::UIn
 void BaseConnectionAvatarsInterface::Adaptee::requestAvatars(const Tp::UIntList &contacts,
         const Tp::Service::ConnectionInterfaceAvatarsAdaptor::RequestAvatarsContextPtr &context)
 {
-    debug() << "BaseConnectionAvatarsInterface::Adaptee::requestAvatars";
+    TP_QT_DEBUG() << "BaseConnectionAvatarsInterface::Adaptee::requestAvatars";
     DBusError error;
     mInterface->requestAvatars(contacts, &error);
     if (error.isValid()) {
@@ -2504,7 +3126,7 @@ void BaseConnectionAvatarsInterface::Adaptee::requestAvatars(const Tp::UIntList
 void BaseConnectionAvatarsInterface::Adaptee::setAvatar(const QByteArray &avatar, const QString &mimeType,
         const Tp::Service::ConnectionInterfaceAvatarsAdaptor::SetAvatarContextPtr &context)
 {
-    debug() << "BaseConnectionAvatarsInterface::Adaptee::setAvatar";
+    TP_QT_DEBUG() << "BaseConnectionAvatarsInterface::Adaptee::setAvatar";
     DBusError error;
     QString token = mInterface->setAvatar(avatar, mimeType, &error);
     if (error.isValid()) {
@@ -2517,7 +3139,7 @@ void BaseConnectionAvatarsInterface::Adaptee::setAvatar(const QByteArray &avatar
 void BaseConnectionAvatarsInterface::Adaptee::clearAvatar(
         const Tp::Service::ConnectionInterfaceAvatarsAdaptor::ClearAvatarContextPtr &context)
 {
-    debug() << "BaseConnectionAvatarsInterface::Adaptee::clearAvatar";
+    TP_QT_DEBUG() << "BaseConnectionAvatarsInterface::Adaptee::clearAvatar";
     DBusError error;
     mInterface->clearAvatar(&error);
     if (error.isValid()) {
@@ -2626,12 +3248,12 @@ void BaseConnectionAvatarsInterface::clearAvatar(DBusError *error)
 
 void BaseConnectionAvatarsInterface::avatarUpdated(uint contact, const QString &newAvatarToken)
 {
-    QMetaObject::invokeMethod(mPriv->adaptee, "avatarUpdated", Q_ARG(uint, contact), Q_ARG(QString, newAvatarToken)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->avatarUpdated(contact, newAvatarToken);
 }
 
 void BaseConnectionAvatarsInterface::avatarRetrieved(uint contact, const QString &token, const QByteArray &avatar, const QString &type)
 {
-    QMetaObject::invokeMethod(mPriv->adaptee, "avatarRetrieved", Q_ARG(uint, contact), Q_ARG(QString, token), Q_ARG(QByteArray, avatar), Q_ARG(QString, type)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->avatarRetrieved(contact, token, avatar, type);
 }
 
 // Conn.I.ClientTypes
@@ -2660,7 +3282,7 @@ BaseConnectionClientTypesInterface::Adaptee::~Adaptee()
 void BaseConnectionClientTypesInterface::Adaptee::getClientTypes(const Tp::UIntList &contacts,
         const Tp::Service::ConnectionInterfaceClientTypesAdaptor::GetClientTypesContextPtr &context)
 {
-    debug() << "BaseConnectionClientTypesInterface::Adaptee::getClientTypes";
+    TP_QT_DEBUG() << "BaseConnectionClientTypesInterface::Adaptee::getClientTypes";
     DBusError error;
     Tp::ContactClientTypes clientTypes = mInterface->getClientTypes(contacts, &error);
     if (error.isValid()) {
@@ -2673,7 +3295,7 @@ void BaseConnectionClientTypesInterface::Adaptee::getClientTypes(const Tp::UIntL
 void BaseConnectionClientTypesInterface::Adaptee::requestClientTypes(uint contact,
         const Tp::Service::ConnectionInterfaceClientTypesAdaptor::RequestClientTypesContextPtr &context)
 {
-    debug() << "BaseConnectionClientTypesInterface::Adaptee::requestClientTypes";
+    TP_QT_DEBUG() << "BaseConnectionClientTypesInterface::Adaptee::requestClientTypes";
     DBusError error;
     QStringList clientTypes = mInterface->requestClientTypes(contact, &error);
     if (error.isValid()) {
@@ -2744,7 +3366,7 @@ QStringList BaseConnectionClientTypesInterface::requestClientTypes(uint contact,
 
 void BaseConnectionClientTypesInterface::clientTypesUpdated(uint contact, const QStringList &clientTypes)
 {
-    QMetaObject::invokeMethod(mPriv->adaptee, "clientTypesUpdated", Q_ARG(uint, contact), Q_ARG(QStringList, clientTypes)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->clientTypesUpdated(contact, clientTypes);
 }
 
 // Conn.I.ContactCapabilities
@@ -2773,7 +3395,7 @@ BaseConnectionContactCapabilitiesInterface::Adaptee::~Adaptee()
 void BaseConnectionContactCapabilitiesInterface::Adaptee::updateCapabilities(const Tp::HandlerCapabilitiesList &handlerCapabilities,
         const Tp::Service::ConnectionInterfaceContactCapabilitiesAdaptor::UpdateCapabilitiesContextPtr &context)
 {
-    debug() << "BaseConnectionContactCapabilitiesInterface::Adaptee::updateCapabilities";
+    TP_QT_DEBUG() << "BaseConnectionContactCapabilitiesInterface::Adaptee::updateCapabilities";
     DBusError error;
     mInterface->updateCapabilities(handlerCapabilities, &error);
     if (error.isValid()) {
@@ -2786,7 +3408,7 @@ void BaseConnectionContactCapabilitiesInterface::Adaptee::updateCapabilities(con
 void BaseConnectionContactCapabilitiesInterface::Adaptee::getContactCapabilities(const Tp::UIntList &handles,
         const Tp::Service::ConnectionInterfaceContactCapabilitiesAdaptor::GetContactCapabilitiesContextPtr &context)
 {
-    debug() << "BaseConnectionContactCapabilitiesInterface::Adaptee::getContactCapabilities";
+    TP_QT_DEBUG() << "BaseConnectionContactCapabilitiesInterface::Adaptee::getContactCapabilities";
     DBusError error;
     Tp::ContactCapabilitiesMap contactCapabilities = mInterface->getContactCapabilities(handles, &error);
     if (error.isValid()) {
@@ -2857,7 +3479,7 @@ Tp::ContactCapabilitiesMap BaseConnectionContactCapabilitiesInterface::getContac
 
 void BaseConnectionContactCapabilitiesInterface::contactCapabilitiesChanged(const Tp::ContactCapabilitiesMap &caps)
 {
-    QMetaObject::invokeMethod(mPriv->adaptee, "contactCapabilitiesChanged", Q_ARG(Tp::ContactCapabilitiesMap, caps)); //Can simply use emit in Qt5
+    emit mPriv->adaptee->contactCapabilitiesChanged(caps);
 }
 
 }
@@ -32,6 +32,7 @@
 #include <TelepathyQt/Global>
 #include <TelepathyQt/Types>
 #include <TelepathyQt/Callbacks>
+#include <TelepathyQt/DeferredResult>
 #include <TelepathyQt/Constants>
 
 #include <QDBusConnection>
@@ -85,6 +86,11 @@ public:
     void setCreateChannelCallback(const CreateChannelCallback &cb);
     BaseChannelPtr createChannel(const QVariantMap &request, bool suppressHandler, DBusError *error);
 
+    typedef Callback2<void, const QVariantMap &, const DeferredResultPtr<BaseChannelPtr> &> CreateChannelAsyncCallback;
+    void setCreateChannelAsyncCallback(const CreateChannelAsyncCallback &cb);
+    void createChannel(const QVariantMap &request, bool suppressHandler,
+            const DeferredResultPtr<BaseChannelPtr> &result);
+
     typedef Callback1<void, DBusError*> ConnectCallback;
     void setConnectCallback(const ConnectCallback &cb);
 
@@ -96,6 +102,16 @@ public:
     void setRequestHandlesCallback(const RequestHandlesCallback &cb);
     Tp::UIntList requestHandles(uint handleType, const QStringList &identifiers, DBusError *error);
 
+    typedef Callback3<void, uint, const QStringList &, const DeferredResultPtr<Tp::UIntList> &> RequestHandlesAsyncCallback;
+    void setRequestHandlesAsyncCallback(const RequestHandlesAsyncCallback &cb);
+    void requestHandles(uint handleType, const QStringList &identifiers,
+            const DeferredResultPtr<Tp::UIntList> &result);
+
+    typedef Callback3<QString, uint, const QString &, DBusError*> NormalizeIdentifierCallback;
+    void setNormalizeIdentifierCallback(const NormalizeIdentifierCallback &cb);
+    uint ensureHandle(uint handleType, const QString &identifier, DBusError *error = nullptr);
+    QString handleIdentifier(uint handleType, uint handle) const;
+
     Tp::ChannelInfoList channelsInfo();
     Tp::ChannelDetailsList channelsDetails();
 
@@ -225,6 +241,11 @@ public:
     void setGetContactAttributesCallback(const GetContactAttributesCallback &cb);
     Tp::ContactAttributesMap getContactAttributes(const Tp::UIntList &handles, const QStringList &interfaces, DBusError *error);
 
+    typedef Callback3<void, const Tp::UIntList &, const QStringList &, const DeferredResultPtr<Tp::ContactAttributesMap> &> GetContactAttributesAsyncCallback;
+    void setGetContactAttributesAsyncCallback(const GetContactAttributesAsyncCallback &cb);
+    void getContactAttributes(const Tp::UIntList &handles, const QStringList &interfaces,
+            const DeferredResultPtr<Tp::ContactAttributesMap> &result);
+
     void getContactByID(const QString &identifier, const QStringList &interfaces, uint &handle, QVariantMap &attributes, DBusError *error);
 
 protected:
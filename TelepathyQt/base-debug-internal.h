@@ -50,6 +50,7 @@ public Q_SLOTS:
 private Q_SLOTS:
     void getMessages(
             const Tp::Service::DebugAdaptor::GetMessagesContextPtr &context);
+    void flushPendingMessages();
 
 public:
     BaseDebug *mInterface;
@@ -19,6 +19,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryService
+
 #include <TelepathyQt/BaseDebug>
 #include "TelepathyQt/base-debug-internal.h"
 
@@ -27,31 +29,109 @@
 #include "TelepathyQt/_gen/base-debug.moc.hpp"
 #include "TelepathyQt/_gen/base-debug-internal.moc.hpp"
 
+#include <QDateTime>
+#include <QTimer>
+
 namespace Tp
 {
 
+// Upper bound for a single burst of NewDebugMessage signals, so that a flood of
+// messages does not have to wait for the batch timer to be delivered
+static const int maxPendingMessages = 1024;
+
 struct TP_QT_NO_EXPORT BaseDebug::Private
 {
     Private(BaseDebug *parent, const QDBusConnection &dbusConnection)
         : parent(parent),
           enabled(false),
           getMessagesLimit(0),
-          lastMessageIndex(-1),
+          oldestMessageIndex(0),
+          batchInterval(0),
+          batchTimer(nullptr),
           adaptee(new BaseDebug::Adaptee(dbusConnection, parent))
     {
     }
 
+    void appendMessage(const DebugMessage &message);
+    DebugMessageList orderedMessages(int count = -1) const;
+    void flushPendingMessages();
+
     BaseDebug *parent;
     bool enabled;
     int getMessagesLimit;
-    int lastMessageIndex;
 
+    // Fixed-size ring once getMessagesLimit is reached; oldestMessageIndex is
+    // always 0 before that
     DebugMessageList messages;
+    int oldestMessageIndex;
+
+    int batchInterval;
+    QTimer *batchTimer;
+    DebugMessageList pendingMessages;
 
     GetMessagesCallback getMessageCB;
     BaseDebug::Adaptee *adaptee;
 };
 
+void BaseDebug::Private::appendMessage(const DebugMessage &message)
+{
+    if (getMessagesLimit == 0) {
+        return;
+    }
+
+    // A negative limit means there is no limit at all
+    if (getMessagesLimit < 0 || messages.count() < getMessagesLimit) {
+        messages.append(message);
+        return;
+    }
+
+    messages[oldestMessageIndex] = message;
+    if (++oldestMessageIndex == messages.count()) {
+        oldestMessageIndex = 0;
+    }
+}
+
+// Returns the newest count messages (all of them for a negative count), oldest first
+DebugMessageList BaseDebug::Private::orderedMessages(int count) const
+{
+    int size = messages.count();
+    if (count < 0 || count > size) {
+        count = size;
+    }
+
+    // An ordered ring is returned as is, sharing its data
+    if (oldestMessageIndex == 0 && count == size) {
+        return messages;
+    }
+
+    // Otherwise walk the ring from the oldest wanted message, reading through
+    // const accessors so that the shared ring is neither detached nor reordered
+    DebugMessageList result;
+    result.reserve(count);
+    int index = (oldestMessageIndex + size - count) % size;
+    for (int i = 0; i < count; ++i) {
+        result.append(messages.at(index));
+        if (++index == size) {
+            index = 0;
+        }
+    }
+    return result;
+}
+
+void BaseDebug::Private::flushPendingMessages()
+{
+    if (batchTimer) {
+        batchTimer->stop();
+    }
+
+    DebugMessageList burst = pendingMessages;
+    pendingMessages.clear();
+    foreach (const DebugMessage &message, burst) {
+        emit adaptee->newDebugMessage(message.timestamp, message.domain,
+                message.level, message.message);
+    }
+}
+
 BaseDebug::Adaptee::Adaptee(const QDBusConnection &dbusConnection, BaseDebug *interface)
     : QObject(interface),
       mInterface(interface)
@@ -66,7 +146,7 @@ bool BaseDebug::Adaptee::isEnabled()
 
 void BaseDebug::Adaptee::setEnabled(bool enabled)
 {
-    mInterface->mPriv->enabled = enabled;
+    mInterface->setEnabled(enabled);
 }
 
 void BaseDebug::Adaptee::getMessages(const Service::DebugAdaptor::GetMessagesContextPtr &context)
@@ -81,6 +161,11 @@ void BaseDebug::Adaptee::getMessages(const Service::DebugAdaptor::GetMessagesCon
     context->setFinished(messages);
 }
 
+void BaseDebug::Adaptee::flushPendingMessages()
+{
+    mInterface->mPriv->flushPendingMessages();
+}
+
 BaseDebug::BaseDebug(const QDBusConnection &dbusConnection) :
     DBusService(dbusConnection),
     mPriv(new Private(this, dbusConnection))
@@ -97,6 +182,11 @@ int BaseDebug::getMessagesLimit() const
     return mPriv->getMessagesLimit;
 }
 
+int BaseDebug::newDebugMessageBatchInterval() const
+{
+    return mPriv->batchInterval;
+}
+
 void BaseDebug::setGetMessagesCallback(const BaseDebug::GetMessagesCallback &cb)
 {
     mPriv->getMessageCB = cb;
@@ -106,11 +196,7 @@ DebugMessageList BaseDebug::getMessages(Tp::DBusError *error) const
 {
     if (!mPriv->getMessageCB.isValid()) {
         if (mPriv->getMessagesLimit) {
-            if (mPriv->lastMessageIndex < 0) {
-                return mPriv->messages;
-            } else {
-                return mPriv->messages.mid(mPriv->lastMessageIndex + 1) + mPriv->messages.mid(0, mPriv->lastMessageIndex + 1);
-            }
+            return mPriv->orderedMessages();
         }
         error->set(TP_QT_ERROR_NOT_IMPLEMENTED, QLatin1String("Not implemented"));
         return DebugMessageList();
@@ -122,32 +208,54 @@ DebugMessageList BaseDebug::getMessages(Tp::DBusError *error) const
 void BaseDebug::setEnabled(bool enabled)
 {
     mPriv->enabled = enabled;
+
+    if (!enabled) {
+        // Nobody is monitoring anymore, so the queued signals are not wanted either
+        mPriv->pendingMessages.clear();
+        if (mPriv->batchTimer) {
+            mPriv->batchTimer->stop();
+        }
+    }
 }
 
 void BaseDebug::setGetMessagesLimit(int limit)
 {
     mPriv->getMessagesLimit = limit;
-    DebugMessageList messages;
 
-    if (mPriv->lastMessageIndex < 0) {
-        messages = mPriv->messages;
-    } else {
-        messages = mPriv->messages.mid(mPriv->lastMessageIndex + 1) + mPriv->messages.mid(0, mPriv->lastMessageIndex + 1);
+    if (limit == 0) {
+        mPriv->messages.clear();
+        mPriv->oldestMessageIndex = 0;
+    } else if (mPriv->oldestMessageIndex != 0 ||
+            (limit > 0 && mPriv->messages.count() > limit)) {
+        // Keep the newest messages, in order, so that the ring starts over at 0
+        mPriv->messages = mPriv->orderedMessages(limit);
+        mPriv->oldestMessageIndex = 0;
     }
+}
 
-    mPriv->lastMessageIndex = -1;
+void BaseDebug::setNewDebugMessageBatchInterval(int msec)
+{
+    mPriv->batchInterval = qMax(msec, 0);
 
-    if (mPriv->messages.count() <= limit) {
-        mPriv->messages = messages;
-    } else {
-        mPriv->messages = messages.mid(messages.count() - limit, limit);
+    if (mPriv->batchInterval == 0) {
+        mPriv->flushPendingMessages();
+        return;
     }
+
+    if (!mPriv->batchTimer) {
+        mPriv->batchTimer = new QTimer(mPriv->adaptee);
+        mPriv->batchTimer->setSingleShot(true);
+        mPriv->adaptee->connect(mPriv->batchTimer,
+                SIGNAL(timeout()),
+                SLOT(flushPendingMessages()));
+    }
+    mPriv->batchTimer->setInterval(mPriv->batchInterval);
 }
 
 void BaseDebug::clear()
 {
     mPriv->messages.clear();
-    mPriv->lastMessageIndex = -1;
+    mPriv->oldestMessageIndex = 0;
 }
 
 void BaseDebug::newDebugMessage(const QString &domain, DebugLevel level, const QString &message)
@@ -160,33 +268,33 @@ void BaseDebug::newDebugMessage(const QString &domain, DebugLevel level, const Q
 
 void BaseDebug::newDebugMessage(double time, const QString &domain, DebugLevel level, const QString &message)
 {
-    if (mPriv->getMessagesLimit != 0) {
-        DebugMessage newMessage;
-        newMessage.timestamp = time;
-        newMessage.domain = domain;
-        newMessage.level = level;
-        newMessage.message = message;
+    if (mPriv->getMessagesLimit == 0 && !isEnabled()) {
+        return;
+    }
 
-        if (mPriv->messages.count() == mPriv->getMessagesLimit) {
-            ++mPriv->lastMessageIndex;
+    DebugMessage newMessage;
+    newMessage.timestamp = time;
+    newMessage.domain = domain;
+    newMessage.level = level;
+    newMessage.message = message;
 
-            if (mPriv->lastMessageIndex >= mPriv->messages.count()) {
-                mPriv->lastMessageIndex = 0;
-            }
+    mPriv->appendMessage(newMessage);
 
-            mPriv->messages[mPriv->lastMessageIndex] = newMessage;
-        } else { // This works when the limit is not hitted yet, or when there is no limit at all (negative limit number)
-            mPriv->messages << newMessage;
-        }
+    if (!isEnabled()) {
+        return;
     }
 
-    if (!isEnabled()) {
+    if (mPriv->batchInterval == 0) {
+        emit mPriv->adaptee->newDebugMessage(time, domain, level, message);
         return;
     }
 
-    QMetaObject::invokeMethod(mPriv->adaptee, "newDebugMessage",
-                              Q_ARG(double, time), Q_ARG(QString, domain),
-                              Q_ARG(uint, level), Q_ARG(QString, message)); //Can simply use emit in Qt5
+    mPriv->pendingMessages.append(newMessage);
+    if (mPriv->pendingMessages.count() >= maxPendingMessages) {
+        mPriv->flushPendingMessages();
+    } else if (!mPriv->batchTimer->isActive()) {
+        mPriv->batchTimer->start();
+    }
 }
 
 QVariantMap BaseDebug::immutableProperties() const
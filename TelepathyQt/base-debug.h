@@ -43,6 +43,7 @@ public:
 
     bool isEnabled() const;
     int getMessagesLimit() const;
+    int newDebugMessageBatchInterval() const;
 
     typedef Callback1<DebugMessageList, DBusError*> GetMessagesCallback;
     void setGetMessagesCallback(const GetMessagesCallback &cb);
@@ -52,6 +53,7 @@ public:
 public Q_SLOTS:
     void setEnabled(bool enabled);
     void setGetMessagesLimit(int limit);
+    void setNewDebugMessageBatchInterval(int msec);
     void clear();
 
     void newDebugMessage(const QString &domain, DebugLevel level, const QString &message);
@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryService
+
 #include <TelepathyQt/BaseProtocol>
 #include "TelepathyQt/base-protocol-internal.h"
 
@@ -274,7 +276,7 @@ QStringList BaseProtocol::connectionInterfaces() const
 void BaseProtocol::setConnectionInterfaces(const QStringList &connInterfaces)
 {
     if (isRegistered()) {
-        warning() << "BaseProtocol::setConnectionInterfaces: cannot change property after "
+        TP_QT_WARNING() << "BaseProtocol::setConnectionInterfaces: cannot change property after "
             "registration, immutable property";
         return;
     }
@@ -312,7 +314,7 @@ ProtocolParameterList BaseProtocol::parameters() const
 void BaseProtocol::setParameters(const ProtocolParameterList &parameters)
 {
     if (isRegistered()) {
-        warning() << "BaseProtocol::setParameters: cannot change property after "
+        TP_QT_WARNING() << "BaseProtocol::setParameters: cannot change property after "
             "registration, immutable property";
         return;
     }
@@ -352,7 +354,7 @@ RequestableChannelClassSpecList BaseProtocol::requestableChannelClasses() const
 void BaseProtocol::setRequestableChannelClasses(const RequestableChannelClassSpecList &rccSpecs)
 {
     if (isRegistered()) {
-        warning() << "BaseProtocol::setRequestableChannelClasses: cannot change property after "
+        TP_QT_WARNING() << "BaseProtocol::setRequestableChannelClasses: cannot change property after "
             "registration, immutable property";
         return;
     }
@@ -393,7 +395,7 @@ QString BaseProtocol::vcardField() const
 void BaseProtocol::setVCardField(const QString &vcardField)
 {
     if (isRegistered()) {
-        warning() << "BaseProtocol::setVCardField: cannot change property after "
+        TP_QT_WARNING() << "BaseProtocol::setVCardField: cannot change property after "
             "registration, immutable property";
         return;
     }
@@ -435,7 +437,7 @@ QString BaseProtocol::englishName() const
 void BaseProtocol::setEnglishName(const QString &englishName)
 {
     if (isRegistered()) {
-        warning() << "BaseProtocol::setEnglishName: cannot change property after "
+        TP_QT_WARNING() << "BaseProtocol::setEnglishName: cannot change property after "
             "registration, immutable property";
         return;
     }
@@ -473,7 +475,7 @@ QString BaseProtocol::iconName() const
 void BaseProtocol::setIconName(const QString &iconName)
 {
     if (isRegistered()) {
-        warning() << "BaseProtocol::setIconName: cannot change property after "
+        TP_QT_WARNING() << "BaseProtocol::setIconName: cannot change property after "
             "registration, immutable property";
         return;
     }
@@ -514,7 +516,7 @@ QStringList BaseProtocol::authenticationTypes() const
 void BaseProtocol::setAuthenticationTypes(const QStringList &authenticationTypes)
 {
     if (isRegistered()) {
-        warning() << "BaseProtocol::setAuthenticationTypes: cannot change property after "
+        TP_QT_WARNING() << "BaseProtocol::setAuthenticationTypes: cannot change property after "
             "registration, immutable property";
         return;
     }
@@ -666,24 +668,24 @@ AbstractProtocolInterfacePtr BaseProtocol::interface(const QString &interfaceNam
 bool BaseProtocol::plugInterface(const AbstractProtocolInterfacePtr &interface)
 {
     if (isRegistered()) {
-        warning() << "Unable to plug protocol interface " << interface->interfaceName() <<
+        TP_QT_WARNING() << "Unable to plug protocol interface " << interface->interfaceName() <<
             "- protocol already registered";
         return false;
     }
 
     if (interface->isRegistered()) {
-        warning() << "Unable to plug protocol interface" << interface->interfaceName() <<
+        TP_QT_WARNING() << "Unable to plug protocol interface" << interface->interfaceName() <<
             "- interface already registered";
         return false;
     }
 
     if (mPriv->interfaces.contains(interface->interfaceName())) {
-        warning() << "Unable to plug protocol interface" << interface->interfaceName() <<
+        TP_QT_WARNING() << "Unable to plug protocol interface" << interface->interfaceName() <<
             "- another interface with same name already plugged";
         return false;
     }
 
-    debug() << "Interface" << interface->interfaceName() << "plugged";
+    TP_QT_DEBUG() << "Interface" << interface->interfaceName() << "plugged";
     mPriv->interfaces.insert(interface->interfaceName(), interface);
     return true;
 }
@@ -701,7 +703,7 @@ bool BaseProtocol::registerObject(const QString &busName, const QString &objectP
     foreach (const AbstractProtocolInterfacePtr &iface, mPriv->interfaces) {
         if (!iface->registerInterface(dbusObject())) {
             // lets not fail if an optional interface fails registering, lets warn only
-            warning() << "Unable to register interface" << iface->interfaceName() <<
+            TP_QT_WARNING() << "Unable to register interface" << iface->interfaceName() <<
                 "for protocol" << mPriv->name;
         }
     }
@@ -1100,7 +1102,7 @@ AvatarSpec BaseProtocolAvatarsInterface::avatarDetails() const
 void BaseProtocolAvatarsInterface::setAvatarDetails(const AvatarSpec &details)
 {
     if (isRegistered()) {
-        warning() << "BaseProtocolAvatarsInterface::setAvatarDetails: cannot change property after "
+        TP_QT_WARNING() << "BaseProtocolAvatarsInterface::setAvatarDetails: cannot change property after "
             "registration, immutable property";
         return;
     }
@@ -1214,7 +1216,7 @@ PresenceSpecList BaseProtocolPresenceInterface::statuses() const
 void BaseProtocolPresenceInterface::setStatuses(const PresenceSpecList &statuses)
 {
     if (isRegistered()) {
-        warning() << "BaseProtocolPresenceInterface::setStatuses: cannot change property after "
+        TP_QT_WARNING() << "BaseProtocolPresenceInterface::setStatuses: cannot change property after "
             "registration, immutable property";
         return;
     }
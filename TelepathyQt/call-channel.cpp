@@ -19,6 +19,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/CallChannel>
 
 #include "TelepathyQt/_gen/call-channel.moc.hpp"
@@ -34,6 +36,9 @@
 #include <TelepathyQt/PendingVariantMap>
 #include <TelepathyQt/PendingVariant>
 
+#include <QHash>
+#include <QSet>
+
 namespace Tp
 {
 
@@ -80,7 +85,9 @@ struct TP_QT_NO_EXPORT CallChannel::Private
 
     bool mutableContents;
     CallContents contents;
-    CallContents incompleteContents;
+    // contents which are not ready yet, and all known contents, by object path
+    QHash<QString, CallContentPtr> incompleteContents;
+    QHash<QString, CallContentPtr> contentsByPath;
 
     uint localHoldState;
     uint localHoldStateReason;
@@ -94,9 +101,12 @@ struct TP_QT_NO_EXPORT CallChannel::Private::CallMembersChangedInfo
             const CallStateReason &reason)
         : updates(updates),
           identifiers(identifiers),
-          removed(removed),
-          reason(reason)
+          updatesReason(reason),
+          removedReason(reason)
     {
+        foreach (uint handle, removed) {
+            this->removed.insert(handle);
+        }
     }
 
     static QSharedPointer<CallMembersChangedInfo> create(
@@ -110,10 +120,38 @@ struct TP_QT_NO_EXPORT CallChannel::Private::CallMembersChangedInfo
         return QSharedPointer<CallMembersChangedInfo>(info);
     }
 
+    // Fold a later change into this one, leaving the net change
+    void merge(const CallMembersChangedInfo &other)
+    {
+        for (CallMemberMap::const_iterator i = other.updates.constBegin();
+                i != other.updates.constEnd(); ++i) {
+            updates.insert(i.key(), i.value());
+            removed.remove(i.key());
+        }
+
+        foreach (uint handle, other.removed) {
+            updates.remove(handle);
+            removed.insert(handle);
+        }
+
+        for (HandleIdentifierMap::const_iterator i = other.identifiers.constBegin();
+                i != other.identifiers.constEnd(); ++i) {
+            identifiers.insert(i.key(), i.value());
+        }
+
+        if (!other.updates.isEmpty()) {
+            updatesReason = other.updatesReason;
+        }
+        if (!other.removed.isEmpty()) {
+            removedReason = other.removedReason;
+        }
+    }
+
     CallMemberMap updates;
     HandleIdentifierMap identifiers;
-    UIntList removed;
-    CallStateReason reason;
+    QSet<uint> removed;
+    CallStateReason updatesReason;
+    CallStateReason removedReason;
 };
 
 CallChannel::Private::Private(CallChannel *parent)
@@ -204,7 +242,7 @@ void CallChannel::Private::introspectCore(CallChannel::Private *self)
     }
 
     if (needIntrospectMainProps) {
-        debug() << "Introspecting immutable properties of CallChannel";
+        TP_QT_DEBUG() << "Introspecting immutable properties of CallChannel";
 
         parent->connect(self->callInterface->requestAllProperties(),
                 SIGNAL(finished(Tp::PendingOperation*)),
@@ -301,7 +339,12 @@ void CallChannel::Private::processCallMembersChanged()
         return;
     }
 
+    // Changes received while the previous ones were being resolved are
+    // merged, so that the whole backlog takes a single contact request
     currentCallMembersChangedInfo = callMembersChangedQueue.dequeue();
+    while (!callMembersChangedQueue.isEmpty()) {
+        currentCallMembersChangedInfo->merge(*callMembersChangedQueue.dequeue());
+    }
 
     QSet<uint> pendingCallMembers;
     for (ContactSendingStateMap::const_iterator i = currentCallMembersChangedInfo->updates.constBegin();
@@ -430,7 +473,7 @@ CallChannel::~CallChannel()
 CallState CallChannel::callState() const
 {
     if (!isReady(FeatureCallState)) {
-        warning() << "CallChannel::callState() used with FeatureCallState not ready";
+        TP_QT_WARNING() << "CallChannel::callState() used with FeatureCallState not ready";
     }
 
     return (CallState) mPriv->state;
@@ -448,7 +491,7 @@ CallState CallChannel::callState() const
 CallFlags CallChannel::callFlags() const
 {
     if (!isReady(FeatureCallState)) {
-        warning() << "CallChannel::callFlags() used with FeatureCallState not ready";
+        TP_QT_WARNING() << "CallChannel::callFlags() used with FeatureCallState not ready";
     }
 
     return (CallFlags) mPriv->flags;
@@ -465,7 +508,7 @@ CallFlags CallChannel::callFlags() const
 CallStateReason CallChannel::callStateReason() const
 {
     if (!isReady(FeatureCallState)) {
-        warning() << "CallChannel::callStateReason() used with FeatureCallState not ready";
+        TP_QT_WARNING() << "CallChannel::callStateReason() used with FeatureCallState not ready";
     }
 
     return mPriv->stateReason;
@@ -484,7 +527,7 @@ CallStateReason CallChannel::callStateReason() const
 QVariantMap CallChannel::callStateDetails() const
 {
     if (!isReady(FeatureCallState)) {
-        warning() << "CallChannel::callStateDetails() used with FeatureCallState not ready";
+        TP_QT_WARNING() << "CallChannel::callStateDetails() used with FeatureCallState not ready";
     }
 
     return mPriv->stateDetails;
@@ -501,7 +544,7 @@ QVariantMap CallChannel::callStateDetails() const
 Contacts CallChannel::remoteMembers() const
 {
     if (!isReady(FeatureCallMembers)) {
-        warning() << "CallChannel::remoteMembers() used with FeatureCallMembers not ready";
+        TP_QT_WARNING() << "CallChannel::remoteMembers() used with FeatureCallMembers not ready";
         return Contacts();
     }
 
@@ -520,7 +563,7 @@ Contacts CallChannel::remoteMembers() const
 CallMemberFlags CallChannel::remoteMemberFlags(const ContactPtr &member) const
 {
     if (!isReady(FeatureCallMembers)) {
-        warning() << "CallChannel::remoteMemberFlags() used with FeatureCallMembers not ready";
+        TP_QT_WARNING() << "CallChannel::remoteMemberFlags() used with FeatureCallMembers not ready";
         return (CallMemberFlags) nullptr;
     }
 
@@ -682,7 +725,7 @@ PendingOperation *CallChannel::hangup(CallStateChangeReason reason,
 CallContents CallChannel::contents() const
 {
     if (!isReady(FeatureContents)) {
-        warning() << "CallChannel::contents() used with FeatureContents not ready";
+        TP_QT_WARNING() << "CallChannel::contents() used with FeatureContents not ready";
         return CallContents();
     }
 
@@ -701,7 +744,7 @@ CallContents CallChannel::contents() const
 CallContents CallChannel::contentsForType(MediaStreamType type) const
 {
     if (!isReady(FeatureContents)) {
-        warning() << "CallChannel::contents() used with FeatureContents not ready";
+        TP_QT_WARNING() << "CallChannel::contents() used with FeatureContents not ready";
         return CallContents();
     }
 
@@ -726,7 +769,7 @@ CallContents CallChannel::contentsForType(MediaStreamType type) const
 CallContentPtr CallChannel::contentByName(const QString &contentName) const
 {
     if (!isReady(FeatureContents)) {
-        warning() << "CallChannel::contentByName() used with FeatureContents not ready";
+        TP_QT_WARNING() << "CallChannel::contentByName() used with FeatureContents not ready";
         return CallContentPtr();
     }
 
@@ -765,9 +808,9 @@ PendingCallContent *CallChannel::requestContent(const QString &name,
 LocalHoldState CallChannel::localHoldState() const
 {
     if (!isReady(FeatureLocalHoldState)) {
-        warning() << "CallChannel::localHoldState() used with FeatureLocalHoldState not ready";
+        TP_QT_WARNING() << "CallChannel::localHoldState() used with FeatureLocalHoldState not ready";
     } else if (!hasInterface(TP_QT_IFACE_CHANNEL_INTERFACE_HOLD)) {
-        warning() << "CallChannel::localHoldStateReason() used with no hold interface";
+        TP_QT_WARNING() << "CallChannel::localHoldStateReason() used with no hold interface";
     }
 
     return (LocalHoldState) mPriv->localHoldState;
@@ -784,9 +827,9 @@ LocalHoldState CallChannel::localHoldState() const
 LocalHoldStateReason CallChannel::localHoldStateReason() const
 {
     if (!isReady(FeatureLocalHoldState)) {
-        warning() << "CallChannel::localHoldStateReason() used with FeatureLocalHoldState not ready";
+        TP_QT_WARNING() << "CallChannel::localHoldStateReason() used with FeatureLocalHoldState not ready";
     } else if (!hasInterface(TP_QT_IFACE_CHANNEL_INTERFACE_HOLD)) {
-        warning() << "CallChannel::localHoldStateReason() used with no hold interface";
+        TP_QT_WARNING() << "CallChannel::localHoldStateReason() used with no hold interface";
     }
 
     return (LocalHoldStateReason) mPriv->localHoldStateReason;
@@ -827,7 +870,7 @@ LocalHoldStateReason CallChannel::localHoldStateReason() const
 PendingOperation *CallChannel::requestHold(bool hold)
 {
     if (!hasInterface(TP_QT_IFACE_CHANNEL_INTERFACE_HOLD)) {
-        warning() << "CallChannel::requestHold() used with no hold interface";
+        TP_QT_WARNING() << "CallChannel::requestHold() used with no hold interface";
         return new PendingFailure(TP_QT_ERROR_NOT_IMPLEMENTED,
                 QLatin1String("CallChannel does not support hold interface"),
                 CallChannelPtr(this));
@@ -841,14 +884,14 @@ PendingOperation *CallChannel::requestHold(bool hold)
 void CallChannel::gotMainProperties(PendingOperation *op)
 {
     if (op->isError()) {
-        warning().nospace() << "CallInterface::requestAllProperties() failed with " <<
+        TP_QT_WARNING().nospace() << "CallInterface::requestAllProperties() failed with " <<
             op->errorName() << ": " << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, false,
             op->errorName(), op->errorMessage());
         return;
     }
 
-    debug() << "Got reply to CallInterface::requestAllProperties()";
+    TP_QT_DEBUG() << "Got reply to CallInterface::requestAllProperties()";
 
     PendingVariantMap *pvm = qobject_cast<PendingVariantMap*>(op);
     Q_ASSERT(pvm);
@@ -869,14 +912,14 @@ void CallChannel::gotMainProperties(PendingOperation *op)
 void CallChannel::gotCallState(PendingOperation *op)
 {
     if (op->isError()) {
-        warning().nospace() << "CallInterface::requestAllProperties() failed with " <<
+        TP_QT_WARNING().nospace() << "CallInterface::requestAllProperties() failed with " <<
             op->errorName() << ": " << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCallState, false,
             op->errorName(), op->errorMessage());
         return;
     }
 
-    debug() << "Got reply to CallInterface::requestAllProperties()";
+    TP_QT_DEBUG() << "Got reply to CallInterface::requestAllProperties()";
 
     PendingVariantMap *pvm = qobject_cast<PendingVariantMap*>(op);
     Q_ASSERT(pvm);
@@ -920,14 +963,14 @@ void CallChannel::onCallStateChanged(uint state, uint flags,
 void CallChannel::gotCallMembers(PendingOperation *op)
 {
     if (op->isError()) {
-        warning().nospace() << "CallInterface::requestAllProperties() failed with " <<
+        TP_QT_WARNING().nospace() << "CallInterface::requestAllProperties() failed with " <<
             op->errorName() << ": " << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCallMembers, false,
             op->errorName(), op->errorMessage());
         return;
     }
 
-    debug() << "Got reply to CallInterface::requestAllProperties()";
+    TP_QT_DEBUG() << "Got reply to CallInterface::requestAllProperties()";
 
     PendingVariantMap *pvm = qobject_cast<PendingVariantMap*>(op);
     Q_ASSERT(pvm);
@@ -947,7 +990,7 @@ void CallChannel::gotCallMembersContacts(PendingOperation *op)
     PendingContacts *pc = qobject_cast<PendingContacts *>(op);
 
     if (!pc->isValid()) {
-        warning().nospace() << "Getting contacts failed with " <<
+        TP_QT_WARNING().nospace() << "Getting contacts failed with " <<
             pc->errorName() << ":" << pc->errorMessage() << ", ignoring";
         mPriv->currentCallMembersChangedInfo.clear();
         mPriv->processCallMembersChanged();
@@ -1004,12 +1047,12 @@ void CallChannel::gotCallMembersContacts(PendingOperation *op)
 
         if (!remoteMemberFlags.isEmpty()) {
             emit remoteMemberFlagsChanged(remoteMemberFlags,
-                    mPriv->currentCallMembersChangedInfo->reason);
+                    mPriv->currentCallMembersChangedInfo->updatesReason);
         }
 
         if (!removed.isEmpty()) {
             emit remoteMembersRemoved(removed.values().toSet(),
-                    mPriv->currentCallMembersChangedInfo->reason);
+                    mPriv->currentCallMembersChangedInfo->removedReason);
         }
     }
 
@@ -1023,11 +1066,11 @@ void CallChannel::onCallMembersChanged(const CallMemberMap &updates,
         const CallStateReason &reason)
 {
     if (updates.isEmpty() && removed.isEmpty()) {
-        debug() << "Received Call::CallMembersChanged with 0 removals and updates, skipping it";
+        TP_QT_DEBUG() << "Received Call::CallMembersChanged with 0 removals and updates, skipping it";
         return;
     }
 
-    debug() << "Received Call::CallMembersChanged with" << updates.size() <<
+    TP_QT_DEBUG() << "Received Call::CallMembersChanged with" << updates.size() <<
         "updated and" << removed.size() << "removed";
     mPriv->callMembersChangedQueue.enqueue(
             Private::CallMembersChangedInfo::create(updates, identifiers, removed, reason));
@@ -1037,14 +1080,14 @@ void CallChannel::onCallMembersChanged(const CallMemberMap &updates,
 void CallChannel::gotContents(PendingOperation *op)
 {
     if (op->isError()) {
-        warning().nospace() << "CallInterface::requestPropertyContents() failed with " <<
+        TP_QT_WARNING().nospace() << "CallInterface::requestPropertyContents() failed with " <<
             op->errorName() << ": " << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureContents, false,
             op->errorName(), op->errorMessage());
         return;
     }
 
-    debug() << "Got reply to CallInterface::requestPropertyContents()";
+    TP_QT_DEBUG() << "Got reply to CallInterface::requestPropertyContents()";
 
     PendingVariant *pv = qobject_cast<PendingVariant*>(op);
     Q_ASSERT(pv);
@@ -1064,10 +1107,10 @@ void CallChannel::gotContents(PendingOperation *op)
 
 void CallChannel::onContentAdded(const QDBusObjectPath &contentPath)
 {
-    debug() << "Received Call::ContentAdded for content" << contentPath.path();
+    TP_QT_DEBUG() << "Received Call::ContentAdded for content" << contentPath.path();
 
     if (lookupContent(contentPath)) {
-        debug() << "Content already exists, ignoring";
+        TP_QT_DEBUG() << "Content already exists, ignoring";
         return;
     }
 
@@ -1077,18 +1120,17 @@ void CallChannel::onContentAdded(const QDBusObjectPath &contentPath)
 void CallChannel::onContentRemoved(const QDBusObjectPath &contentPath,
         const CallStateReason &reason)
 {
-    debug() << "Received Call::ContentRemoved for content" << contentPath.path();
+    TP_QT_DEBUG() << "Received Call::ContentRemoved for content" << contentPath.path();
 
     CallContentPtr content = lookupContent(contentPath);
     if (!content) {
-        debug() << "Content does not exist, ignoring";
+        TP_QT_DEBUG() << "Content does not exist, ignoring";
         return;
     }
 
-    bool incomplete = mPriv->incompleteContents.contains(content);
-    if (incomplete) {
-        mPriv->incompleteContents.removeOne(content);
-    } else {
+    mPriv->contentsByPath.remove(contentPath.path());
+    bool incomplete = mPriv->incompleteContents.remove(contentPath.path()) > 0;
+    if (!incomplete) {
         mPriv->contents.removeOne(content);
     }
 
@@ -1098,8 +1140,8 @@ void CallChannel::onContentRemoved(const QDBusObjectPath &contentPath,
 
     // the content was added/removed before become ready
     if (!isReady(FeatureContents) &&
-        mPriv->contents.size() == 0 &&
-        mPriv->incompleteContents.size() == 0) {
+        mPriv->contents.isEmpty() &&
+        mPriv->incompleteContents.isEmpty()) {
         mPriv->readinessHelper->setIntrospectCompleted(FeatureContents, true);
     }
 }
@@ -1110,8 +1152,10 @@ void CallChannel::onContentReady(PendingOperation *op)
     CallContentPtr content = CallContentPtr::qObjectCast(pr->proxy());
 
     if (op->isError()) {
-        mPriv->incompleteContents.removeOne(content);
-        if (!isReady(FeatureContents) && mPriv->incompleteContents.size() == 0) {
+        if (mPriv->incompleteContents.remove(content->objectPath()) > 0) {
+            mPriv->contentsByPath.remove(content->objectPath());
+        }
+        if (!isReady(FeatureContents) && mPriv->incompleteContents.isEmpty()) {
             // let's not fail because a content could not become ready
             mPriv->readinessHelper->setIntrospectCompleted(FeatureContents, true);
         }
@@ -1119,22 +1163,21 @@ void CallChannel::onContentReady(PendingOperation *op)
     }
 
     // the content was removed before become ready
-    if (!mPriv->incompleteContents.contains(content)) {
+    if (mPriv->incompleteContents.remove(content->objectPath()) == 0) {
         if (!isReady(FeatureContents) &&
-            mPriv->incompleteContents.size() == 0) {
+            mPriv->incompleteContents.isEmpty()) {
             mPriv->readinessHelper->setIntrospectCompleted(FeatureContents, true);
         }
         return;
     }
 
-    mPriv->incompleteContents.removeOne(content);
     mPriv->contents.append(content);
 
     if (isReady(FeatureContents)) {
         emit contentAdded(content);
     }
 
-    if (!isReady(FeatureContents) && mPriv->incompleteContents.size() == 0) {
+    if (!isReady(FeatureContents) && mPriv->incompleteContents.isEmpty()) {
         mPriv->readinessHelper->setIntrospectCompleted(FeatureContents, true);
     }
 }
@@ -1143,15 +1186,15 @@ void CallChannel::gotLocalHoldState(QDBusPendingCallWatcher *watcher)
 {
     QDBusPendingReply<uint, uint> reply = *watcher;
     if (reply.isError()) {
-        warning().nospace() << "Call::Hold::GetHoldState() failed with " <<
+        TP_QT_WARNING().nospace() << "Call::Hold::GetHoldState() failed with " <<
             reply.error().name() << ": " << reply.error().message();
-        debug() << "Ignoring error getting hold state and assuming we're not on hold";
+        TP_QT_DEBUG() << "Ignoring error getting hold state and assuming we're not on hold";
         onLocalHoldStateChanged(mPriv->localHoldState, mPriv->localHoldStateReason);
         watcher->deleteLater();
         return;
     }
 
-    debug() << "Got reply to Call::Hold::GetHoldState()";
+    TP_QT_DEBUG() << "Got reply to Call::Hold::GetHoldState()";
     onLocalHoldStateChanged(reply.argumentAt<0>(), reply.argumentAt<1>());
     watcher->deleteLater();
 }
@@ -1181,7 +1224,8 @@ CallContentPtr CallChannel::addContent(const QDBusObjectPath &contentPath)
 {
     CallContentPtr content = CallContentPtr(
             new CallContent(CallChannelPtr(this), contentPath));
-    mPriv->incompleteContents.append(content);
+    mPriv->incompleteContents.insert(contentPath.path(), content);
+    mPriv->contentsByPath.insert(contentPath.path(), content);
     connect(content->becomeReady(),
             SIGNAL(finished(Tp::PendingOperation*)),
             SLOT(onContentReady(Tp::PendingOperation*)));
@@ -1190,17 +1234,7 @@ CallContentPtr CallChannel::addContent(const QDBusObjectPath &contentPath)
 
 CallContentPtr CallChannel::lookupContent(const QDBusObjectPath &contentPath) const
 {
-    foreach (const CallContentPtr &content, mPriv->contents) {
-        if (content->objectPath() == contentPath.path()) {
-            return content;
-        }
-    }
-    foreach (const CallContentPtr &content, mPriv->incompleteContents) {
-        if (content->objectPath() == contentPath.path()) {
-            return content;
-        }
-    }
-    return CallContentPtr();
+    return mPriv->contentsByPath.value(contentPath.path());
 }
 
 /**
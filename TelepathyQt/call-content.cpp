@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/CallContent>
 
 #include "TelepathyQt/_gen/call-content.moc.hpp"
@@ -36,6 +38,8 @@
 #include <TelepathyQt/PendingVariantMap>
 #include <TelepathyQt/ReadinessHelper>
 
+#include <QHash>
+
 namespace Tp
 {
 
@@ -65,7 +69,9 @@ struct TP_QT_NO_EXPORT CallContent::Private
     uint type;
     uint disposition;
     CallStreams streams;
-    CallStreams incompleteStreams;
+    // streams which are not ready yet, and all known streams, by object path
+    QHash<QString, CallStreamPtr> incompleteStreams;
+    QHash<QString, CallStreamPtr> streamsByPath;
 };
 
 CallContent::Private::Private(CallContent *parent, const CallChannelPtr &channel)
@@ -107,7 +113,7 @@ void CallContent::Private::introspectMainProperties(CallContent::Private *self)
 
 void CallContent::Private::checkIntrospectionCompleted()
 {
-    if (!parent->isReady(FeatureCore) && incompleteStreams.size() == 0) {
+    if (!parent->isReady(FeatureCore) && incompleteStreams.isEmpty()) {
         readinessHelper->setIntrospectCompleted(FeatureCore, true);
     }
 }
@@ -116,7 +122,8 @@ CallStreamPtr CallContent::Private::addStream(const QDBusObjectPath &streamPath)
 {
     CallStreamPtr stream = CallStreamPtr(
             new CallStream(CallContentPtr(parent), streamPath));
-    incompleteStreams.append(stream);
+    incompleteStreams.insert(streamPath.path(), stream);
+    streamsByPath.insert(streamPath.path(), stream);
     parent->connect(stream->becomeReady(),
             SIGNAL(finished(Tp::PendingOperation*)),
             SLOT(onStreamReady(Tp::PendingOperation*)));
@@ -125,17 +132,7 @@ CallStreamPtr CallContent::Private::addStream(const QDBusObjectPath &streamPath)
 
 CallStreamPtr CallContent::Private::lookupStream(const QDBusObjectPath &streamPath)
 {
-    foreach (const CallStreamPtr &stream, streams) {
-        if (stream->objectPath() == streamPath.path()) {
-            return stream;
-        }
-    }
-    foreach (const CallStreamPtr &stream, incompleteStreams) {
-        if (stream->objectPath() == streamPath.path()) {
-            return stream;
-        }
-    }
-    return CallStreamPtr();
+    return streamsByPath.value(streamPath.path());
 }
 
 /**
@@ -280,7 +277,7 @@ bool CallContent::supportsDTMF() const
 PendingOperation *CallContent::startDTMFTone(DTMFEvent event)
 {
     if (!supportsDTMF()) {
-        warning() << "CallContent::startDTMFTone() used with no dtmf interface";
+        TP_QT_WARNING() << "CallContent::startDTMFTone() used with no dtmf interface";
         return new PendingFailure(TP_QT_ERROR_NOT_IMPLEMENTED,
                 QLatin1String("This CallContent does not support the dtmf interface"),
                 CallContentPtr(this));
@@ -309,7 +306,7 @@ PendingOperation *CallContent::startDTMFTone(DTMFEvent event)
 PendingOperation *CallContent::stopDTMFTone()
 {
     if (!supportsDTMF()) {
-        warning() << "CallContent::stopDTMFTone() used with no dtmf interface";
+        TP_QT_WARNING() << "CallContent::stopDTMFTone() used with no dtmf interface";
         return new PendingFailure(TP_QT_ERROR_NOT_IMPLEMENTED,
                 QLatin1String("This CallContent does not support the dtmf interface"),
                 CallContentPtr(this));
@@ -323,14 +320,14 @@ PendingOperation *CallContent::stopDTMFTone()
 void CallContent::gotMainProperties(PendingOperation *op)
 {
     if (op->isError()) {
-        warning().nospace() << "CallContentInterface::requestAllProperties() failed with" <<
+        TP_QT_WARNING().nospace() << "CallContentInterface::requestAllProperties() failed with" <<
             op->errorName() << ": " << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, false,
             op->errorName(), op->errorMessage());
         return;
     }
 
-    debug() << "Got reply to CallContentInterface::requestAllProperties()";
+    TP_QT_DEBUG() << "Got reply to CallContentInterface::requestAllProperties()";
 
     PendingVariantMap *pvm = qobject_cast<PendingVariantMap*>(op);
     Q_ASSERT(pvm);
@@ -358,10 +355,10 @@ void CallContent::gotMainProperties(PendingOperation *op)
 void CallContent::onStreamsAdded(const ObjectPathList &streamsPaths)
 {
     foreach (const QDBusObjectPath &streamPath, streamsPaths) {
-        debug() << "Received Call::Content::StreamAdded for stream" << streamPath.path();
+        TP_QT_DEBUG() << "Received Call::Content::StreamAdded for stream" << streamPath.path();
 
         if (mPriv->lookupStream(streamPath)) {
-            debug() << "Stream already exists, ignoring";
+            TP_QT_DEBUG() << "Stream already exists, ignoring";
             return;
         }
 
@@ -373,18 +370,17 @@ void CallContent::onStreamsRemoved(const ObjectPathList &streamsPaths,
         const CallStateReason &reason)
 {
     foreach (const QDBusObjectPath &streamPath, streamsPaths) {
-        debug() << "Received Call::Content::StreamRemoved for stream" << streamPath.path();
+        TP_QT_DEBUG() << "Received Call::Content::StreamRemoved for stream" << streamPath.path();
 
         CallStreamPtr stream = mPriv->lookupStream(streamPath);
         if (!stream) {
-            debug() << "Stream does not exist, ignoring";
+            TP_QT_DEBUG() << "Stream does not exist, ignoring";
             return;
         }
 
-        bool incomplete = mPriv->incompleteStreams.contains(stream);
-        if (incomplete) {
-            mPriv->incompleteStreams.removeOne(stream);
-        } else {
+        mPriv->streamsByPath.remove(streamPath.path());
+        bool incomplete = mPriv->incompleteStreams.remove(streamPath.path()) > 0;
+        if (!incomplete) {
             mPriv->streams.removeOne(stream);
         }
 
@@ -401,13 +397,18 @@ void CallContent::onStreamReady(PendingOperation *op)
     PendingReady *pr = qobject_cast<PendingReady*>(op);
     CallStreamPtr stream = CallStreamPtr::qObjectCast(pr->proxy());
 
-    if (op->isError() || !mPriv->incompleteStreams.contains(stream)) {
-        mPriv->incompleteStreams.removeOne(stream);
+    // the stream may have been removed before becoming ready
+    if (mPriv->incompleteStreams.remove(stream->objectPath()) == 0) {
+        mPriv->checkIntrospectionCompleted();
+        return;
+    }
+
+    if (op->isError()) {
+        mPriv->streamsByPath.remove(stream->objectPath());
         mPriv->checkIntrospectionCompleted();
         return;
     }
 
-    mPriv->incompleteStreams.removeOne(stream);
     mPriv->streams.append(stream);
 
     if (isReady(FeatureCore)) {
@@ -486,7 +487,7 @@ void PendingCallContent::gotContent(QDBusPendingCallWatcher *watcher)
 {
     QDBusPendingReply<QDBusObjectPath> reply = *watcher;
     if (reply.isError()) {
-        warning().nospace() << "Call::AddContent failed with " <<
+        TP_QT_WARNING().nospace() << "Call::AddContent failed with " <<
             reply.error().name() << ": " << reply.error().message();
         setFinishedWithError(reply.error());
         watcher->deleteLater();
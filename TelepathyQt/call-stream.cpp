@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/CallStream>
 
 #include "TelepathyQt/_gen/call-stream.moc.hpp"
@@ -39,6 +41,8 @@
 #include <TelepathyQt/PendingVariantMap>
 #include <TelepathyQt/ReadinessHelper>
 
+#include <QSet>
+
 namespace Tp
 {
 
@@ -79,9 +83,12 @@ struct TP_QT_NO_EXPORT CallStream::Private::RemoteMembersChangedInfo
             const CallStateReason &reason)
         : updates(updates),
           identifiers(identifiers),
-          removed(removed),
-          reason(reason)
+          updatesReason(reason),
+          removedReason(reason)
     {
+        foreach (uint handle, removed) {
+            this->removed.insert(handle);
+        }
     }
 
     static QSharedPointer<RemoteMembersChangedInfo> create(
@@ -95,10 +102,38 @@ struct TP_QT_NO_EXPORT CallStream::Private::RemoteMembersChangedInfo
         return QSharedPointer<RemoteMembersChangedInfo>(info);
     }
 
+    // Fold a later change into this one, leaving the net change
+    void merge(const RemoteMembersChangedInfo &other)
+    {
+        for (ContactSendingStateMap::const_iterator i = other.updates.constBegin();
+                i != other.updates.constEnd(); ++i) {
+            updates.insert(i.key(), i.value());
+            removed.remove(i.key());
+        }
+
+        foreach (uint handle, other.removed) {
+            updates.remove(handle);
+            removed.insert(handle);
+        }
+
+        for (HandleIdentifierMap::const_iterator i = other.identifiers.constBegin();
+                i != other.identifiers.constEnd(); ++i) {
+            identifiers.insert(i.key(), i.value());
+        }
+
+        if (!other.updates.isEmpty()) {
+            updatesReason = other.updatesReason;
+        }
+        if (!other.removed.isEmpty()) {
+            removedReason = other.removedReason;
+        }
+    }
+
     ContactSendingStateMap updates;
     HandleIdentifierMap identifiers;
-    UIntList removed;
-    CallStateReason reason;
+    QSet<uint> removed;
+    CallStateReason updatesReason;
+    CallStateReason removedReason;
 };
 
 CallStream::Private::Private(CallStream *parent, const CallContentPtr &content)
@@ -152,7 +187,12 @@ void CallStream::Private::processRemoteMembersChanged()
         return;
     }
 
+    // Changes received while the previous ones were being resolved are
+    // merged, so that the whole backlog takes a single contact request
     currentRemoteMembersChangedInfo = remoteMembersChangedQueue.dequeue();
+    while (!remoteMembersChangedQueue.isEmpty()) {
+        currentRemoteMembersChangedInfo->merge(*remoteMembersChangedQueue.dequeue());
+    }
 
     QSet<uint> pendingRemoteMembers;
     for (ContactSendingStateMap::const_iterator i = currentRemoteMembersChangedInfo->updates.constBegin();
@@ -337,14 +377,14 @@ PendingOperation *CallStream::requestReceiving(const ContactPtr &contact, bool r
 void CallStream::gotMainProperties(PendingOperation *op)
 {
     if (op->isError()) {
-        warning().nospace() << "CallStreamInterface::requestAllProperties() failed with " <<
+        TP_QT_WARNING().nospace() << "CallStreamInterface::requestAllProperties() failed with " <<
             op->errorName() << ": " << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, false,
             op->errorName(), op->errorMessage());
         return;
     }
 
-    debug() << "Got reply to CallStreamInterface::requestAllProperties()";
+    TP_QT_DEBUG() << "Got reply to CallStreamInterface::requestAllProperties()";
 
     PendingVariantMap *pvm = qobject_cast<PendingVariantMap*>(op);
     Q_ASSERT(pvm);
@@ -369,7 +409,7 @@ void CallStream::gotRemoteMembersContacts(PendingOperation *op)
     PendingContacts *pc = qobject_cast<PendingContacts *>(op);
 
     if (!pc->isValid()) {
-        warning().nospace() << "Getting contacts failed with " <<
+        TP_QT_WARNING().nospace() << "Getting contacts failed with " <<
             pc->errorName() << ":" << pc->errorMessage() << ", ignoring";
         mPriv->currentRemoteMembersChangedInfo.clear();
         mPriv->processRemoteMembersChanged();
@@ -427,12 +467,12 @@ void CallStream::gotRemoteMembersContacts(PendingOperation *op)
 
         if (!remoteSendingStates.isEmpty()) {
             emit remoteSendingStateChanged(remoteSendingStates,
-                    mPriv->currentRemoteMembersChangedInfo->reason);
+                    mPriv->currentRemoteMembersChangedInfo->updatesReason);
         }
 
         if (!removed.isEmpty()) {
             emit remoteMembersRemoved(removed.values().toSet(),
-                    mPriv->currentRemoteMembersChangedInfo->reason);
+                    mPriv->currentRemoteMembersChangedInfo->removedReason);
         }
     }
 
@@ -452,12 +492,12 @@ void CallStream::onRemoteMembersChanged(const ContactSendingStateMap &updates,
         const CallStateReason &reason)
 {
     if (updates.isEmpty() && removed.isEmpty()) {
-        debug() << "Received Call::Stream::RemoteMembersChanged with 0 removals and "
+        TP_QT_DEBUG() << "Received Call::Stream::RemoteMembersChanged with 0 removals and "
             "updates, skipping it";
         return;
     }
 
-    debug() << "Received Call::Stream::RemoteMembersChanged with" << updates.size() <<
+    TP_QT_DEBUG() << "Received Call::Stream::RemoteMembersChanged with" << updates.size() <<
         "updated and" << removed.size() << "removed";
     mPriv->remoteMembersChangedQueue.enqueue(
             Private::RemoteMembersChangedInfo::create(updates, identifiers, removed, reason));
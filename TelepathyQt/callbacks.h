@@ -30,74 +30,150 @@
 #include <TelepathyQt/Functors>
 #include <TelepathyQt/Global>
 
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
 namespace Tp
 {
 
-struct TP_QT_EXPORT AbstractFunctorCaller
+struct TP_QT_EXPORT BaseCallback
 {
-    typedef void *(*HookType)(void*);
+    BaseCallback() : manager(nullptr) {}
+    BaseCallback(const BaseCallback &other) : manager(nullptr) { copyFrom(other); }
+    BaseCallback(BaseCallback &&other) noexcept : manager(nullptr) { moveFrom(other); }
+    virtual ~BaseCallback() { reset(); }
 
-    AbstractFunctorCaller(HookType invokeMethodHook) : invokeMethodHook(invokeMethodHook) {}
-    virtual ~AbstractFunctorCaller() {}
+    bool isValid() const { return manager != nullptr; }
 
-    virtual AbstractFunctorCaller *clone() const = 0;
+    BaseCallback &operator=(const BaseCallback &other)
+    {
+        if (this == &other) return *this;
+        reset();
+        copyFrom(other);
+        return *this;
+    }
 
-    HookType invokeMethodHook;
+    BaseCallback &operator=(BaseCallback &&other) noexcept
+    {
+        if (this == &other) return *this;
+        reset();
+        moveFrom(other);
+        return *this;
+    }
 
-private:
-    AbstractFunctorCaller(const AbstractFunctorCaller &other);
-    AbstractFunctorCaller &operator=(const AbstractFunctorCaller &other);
-};
+protected:
+    /* functors up to this size, which covers memFun(), ptrFun() and lambdas capturing a
+     * few pointers, are stored inline instead of being allocated on the heap */
+    enum { InlineSize = 4 * sizeof(void*) };
 
-template <class T, class Functor>
-struct BaseFunctorCaller : public AbstractFunctorCaller
-{
-    BaseFunctorCaller(const Functor &functor, AbstractFunctorCaller::HookType invokeMethodHook)
-        : AbstractFunctorCaller(invokeMethodHook),
-          functor(functor) {}
-    ~BaseFunctorCaller() override {}
+    union Storage
+    {
+        void *heap;
+        alignas(std::max_align_t) unsigned char buffer[InlineSize];
+    };
 
-    AbstractFunctorCaller *clone() const override { return new T(functor); }
+    enum Operation { Clone, Move, Destroy };
+    typedef void (*ManagerType)(Operation operation, Storage *dest, Storage *src);
 
-    Functor functor;
-};
+    template <class Functor, bool Inline = (sizeof(Functor) <= InlineSize &&
+            alignof(std::max_align_t) % alignof(Functor) == 0 &&
+            std::is_nothrow_move_constructible<Functor>::value)>
+    struct FunctorStorage
+    {
+        static Functor *get(const Storage &storage)
+        {
+            return static_cast<Functor*>(storage.heap);
+        }
 
-struct TP_QT_EXPORT BaseCallback
-{
-    BaseCallback() : caller(nullptr) {}
-    /* takes ownership of caller */
-    BaseCallback(AbstractFunctorCaller *caller) : caller(caller) {}
-    BaseCallback(const BaseCallback &other) : caller(other.caller->clone()) {}
-    virtual ~BaseCallback() { delete caller; }
+        static void create(Storage *storage, const Functor &functor)
+        {
+            storage->heap = new Functor(functor);
+        }
 
-    bool isValid() const { return caller != nullptr; }
+        static void manage(Operation operation, Storage *dest, Storage *src)
+        {
+            switch (operation) {
+            case Clone:
+                dest->heap = new Functor(*get(*src));
+                break;
+            case Move:
+                dest->heap = src->heap;
+                src->heap = nullptr;
+                break;
+            case Destroy:
+                delete get(*dest);
+                break;
+            }
+        }
+    };
 
-    BaseCallback &operator=(const BaseCallback &other)
+    template <class Functor>
+    struct FunctorStorage<Functor, true>
     {
-        if (caller == other.caller) return *this;
-        delete caller;
-        caller = other.caller->clone();
-        return *this;
+        static Functor *get(const Storage &storage)
+        {
+            return const_cast<Functor*>(reinterpret_cast<const Functor*>(storage.buffer));
+        }
+
+        static void create(Storage *storage, const Functor &functor)
+        {
+            new (storage->buffer) Functor(functor);
+        }
+
+        static void manage(Operation operation, Storage *dest, Storage *src)
+        {
+            switch (operation) {
+            case Clone:
+                new (dest->buffer) Functor(*get(*src));
+                break;
+            case Move:
+                new (dest->buffer) Functor(std::move(*get(*src)));
+                get(*src)->~Functor();
+                break;
+            case Destroy:
+                get(*dest)->~Functor();
+                break;
+            }
+        }
+    };
+
+    template <class Functor>
+    void create(const Functor &functor)
+    {
+        FunctorStorage<Functor>::create(&storage, functor);
+        manager = &FunctorStorage<Functor>::manage;
     }
 
-protected:
-    /* may be null */
-    AbstractFunctorCaller *caller;
-};
+    /* null for an invalid callback */
+    ManagerType manager;
+    Storage storage;
 
-template <class Functor, class R >
-struct FunctorCaller0 : public BaseFunctorCaller<FunctorCaller0<Functor, R >, Functor>
-{
-    typedef R ResultType;
-    typedef R (*InvokeType)(AbstractFunctorCaller* );
+private:
+    void reset()
+    {
+        if (manager) {
+            manager(Destroy, &storage, nullptr);
+            manager = nullptr;
+        }
+    }
 
-    explicit FunctorCaller0(const Functor &functor) : BaseFunctorCaller<FunctorCaller0, Functor>(functor, reinterpret_cast<AbstractFunctorCaller::HookType>(&FunctorCaller0<Functor, R >::invoke)) {}
+    void copyFrom(const BaseCallback &other)
+    {
+        if (other.manager) {
+            other.manager(Clone, &storage, const_cast<Storage*>(&other.storage));
+            manager = other.manager;
+        }
+    }
 
-    static ResultType invoke(AbstractFunctorCaller *call )
+    void moveFrom(BaseCallback &other)
     {
-        typedef FunctorCaller0<Functor, R > Type;
-        Type *typed = static_cast<Type*>(call);
-        return (typed->functor)();
+        if (other.manager) {
+            other.manager(Move, &storage, &other.storage);
+            manager = other.manager;
+            other.manager = nullptr;
+        }
     }
 };
 
@@ -107,35 +183,28 @@ struct Callback0 : public BaseCallback
     typedef R (*FunctionType)();
     typedef R ResultType;
 
-    Callback0() {}
+    Callback0() : invoker(nullptr) {}
     template <class Functor>
-    Callback0(const Functor &functor) : BaseCallback(new FunctorCaller0<Functor, R >(functor)) {}
+    Callback0(const Functor &functor) : invoker(&invoke<Functor>) { create(functor); }
 
     ResultType operator()() const
     {
-        if (caller) {
-            typedef R (*InvokeType)(AbstractFunctorCaller* );
-            InvokeType invokeMethod = reinterpret_cast<InvokeType>(caller->invokeMethodHook);
-            return invokeMethod(caller );
+        if (isValid()) {
+            return invoker(storage);
         }
         return ResultType();
     }
-};
-
-template <class Functor, class R , class Arg1>
-struct FunctorCaller1 : public BaseFunctorCaller<FunctorCaller1<Functor, R , Arg1>, Functor>
-{
-    typedef R ResultType;
-    typedef R (*InvokeType)(AbstractFunctorCaller* , Arg1);
 
-    explicit FunctorCaller1(const Functor &functor) : BaseFunctorCaller<FunctorCaller1, Functor>(functor, reinterpret_cast<AbstractFunctorCaller::HookType>(&FunctorCaller1<Functor, R , Arg1>::invoke)) {}
+private:
+    typedef R (*InvokeType)(const Storage &);
 
-    static ResultType invoke(AbstractFunctorCaller *call , Arg1 a1)
+    template <class Functor>
+    static ResultType invoke(const Storage &data)
     {
-        typedef FunctorCaller1<Functor, R , Arg1> Type;
-        Type *typed = static_cast<Type*>(call);
-        return (typed->functor)(a1);
+        return (*FunctorStorage<Functor>::get(data))();
     }
+
+    InvokeType invoker;
 };
 
 template <class R , class Arg1>
@@ -144,35 +213,28 @@ struct Callback1 : public BaseCallback
     typedef R (*FunctionType)(Arg1);
     typedef R ResultType;
 
-    Callback1() {}
+    Callback1() : invoker(nullptr) {}
     template <class Functor>
-    Callback1(const Functor &functor) : BaseCallback(new FunctorCaller1<Functor, R , Arg1>(functor)) {}
+    Callback1(const Functor &functor) : invoker(&invoke<Functor>) { create(functor); }
 
     ResultType operator()(Arg1 a1) const
     {
-        if (caller) {
-            typedef R (*InvokeType)(AbstractFunctorCaller* , Arg1);
-            InvokeType invokeMethod = reinterpret_cast<InvokeType>(caller->invokeMethodHook);
-            return invokeMethod(caller , a1);
+        if (isValid()) {
+            return invoker(storage, a1);
         }
         return ResultType();
     }
-};
 
-template <class Functor, class R , class Arg1, class Arg2>
-struct FunctorCaller2 : public BaseFunctorCaller<FunctorCaller2<Functor, R , Arg1, Arg2>, Functor>
-{
-    typedef R ResultType;
-    typedef R (*InvokeType)(AbstractFunctorCaller* , Arg1, Arg2);
-
-    explicit FunctorCaller2(const Functor &functor) : BaseFunctorCaller<FunctorCaller2, Functor>(functor, reinterpret_cast<AbstractFunctorCaller::HookType>(&FunctorCaller2<Functor, R , Arg1, Arg2>::invoke)) {}
+private:
+    typedef R (*InvokeType)(const Storage &, Arg1);
 
-    static ResultType invoke(AbstractFunctorCaller *call , Arg1 a1, Arg2 a2)
+    template <class Functor>
+    static ResultType invoke(const Storage &data, Arg1 a1)
     {
-        typedef FunctorCaller2<Functor, R , Arg1, Arg2> Type;
-        Type *typed = static_cast<Type*>(call);
-        return (typed->functor)(a1, a2);
+        return (*FunctorStorage<Functor>::get(data))(a1);
     }
+
+    InvokeType invoker;
 };
 
 template <class R , class Arg1, class Arg2>
@@ -181,35 +243,28 @@ struct Callback2 : public BaseCallback
     typedef R (*FunctionType)(Arg1, Arg2);
     typedef R ResultType;
 
-    Callback2() {}
+    Callback2() : invoker(nullptr) {}
     template <class Functor>
-    Callback2(const Functor &functor) : BaseCallback(new FunctorCaller2<Functor, R , Arg1, Arg2>(functor)) {}
+    Callback2(const Functor &functor) : invoker(&invoke<Functor>) { create(functor); }
 
     ResultType operator()(Arg1 a1, Arg2 a2) const
     {
-        if (caller) {
-            typedef R (*InvokeType)(AbstractFunctorCaller* , Arg1, Arg2);
-            InvokeType invokeMethod = reinterpret_cast<InvokeType>(caller->invokeMethodHook);
-            return invokeMethod(caller , a1, a2);
+        if (isValid()) {
+            return invoker(storage, a1, a2);
         }
         return ResultType();
     }
-};
-
-template <class Functor, class R , class Arg1, class Arg2, class Arg3>
-struct FunctorCaller3 : public BaseFunctorCaller<FunctorCaller3<Functor, R , Arg1, Arg2, Arg3>, Functor>
-{
-    typedef R ResultType;
-    typedef R (*InvokeType)(AbstractFunctorCaller* , Arg1, Arg2, Arg3);
 
-    explicit FunctorCaller3(const Functor &functor) : BaseFunctorCaller<FunctorCaller3, Functor>(functor, reinterpret_cast<AbstractFunctorCaller::HookType>(&FunctorCaller3<Functor, R , Arg1, Arg2, Arg3>::invoke)) {}
+private:
+    typedef R (*InvokeType)(const Storage &, Arg1, Arg2);
 
-    static ResultType invoke(AbstractFunctorCaller *call , Arg1 a1, Arg2 a2, Arg3 a3)
+    template <class Functor>
+    static ResultType invoke(const Storage &data, Arg1 a1, Arg2 a2)
     {
-        typedef FunctorCaller3<Functor, R , Arg1, Arg2, Arg3> Type;
-        Type *typed = static_cast<Type*>(call);
-        return (typed->functor)(a1, a2, a3);
+        return (*FunctorStorage<Functor>::get(data))(a1, a2);
     }
+
+    InvokeType invoker;
 };
 
 template <class R , class Arg1, class Arg2, class Arg3>
@@ -218,35 +273,28 @@ struct Callback3 : public BaseCallback
     typedef R (*FunctionType)(Arg1, Arg2, Arg3);
     typedef R ResultType;
 
-    Callback3() {}
+    Callback3() : invoker(nullptr) {}
     template <class Functor>
-    Callback3(const Functor &functor) : BaseCallback(new FunctorCaller3<Functor, R , Arg1, Arg2, Arg3>(functor)) {}
+    Callback3(const Functor &functor) : invoker(&invoke<Functor>) { create(functor); }
 
     ResultType operator()(Arg1 a1, Arg2 a2, Arg3 a3) const
     {
-        if (caller) {
-            typedef R (*InvokeType)(AbstractFunctorCaller* , Arg1, Arg2, Arg3);
-            InvokeType invokeMethod = reinterpret_cast<InvokeType>(caller->invokeMethodHook);
-            return invokeMethod(caller , a1, a2, a3);
+        if (isValid()) {
+            return invoker(storage, a1, a2, a3);
         }
         return ResultType();
     }
-};
-
-template <class Functor, class R , class Arg1, class Arg2, class Arg3, class Arg4>
-struct FunctorCaller4 : public BaseFunctorCaller<FunctorCaller4<Functor, R , Arg1, Arg2, Arg3, Arg4>, Functor>
-{
-    typedef R ResultType;
-    typedef R (*InvokeType)(AbstractFunctorCaller* , Arg1, Arg2, Arg3, Arg4);
 
-    explicit FunctorCaller4(const Functor &functor) : BaseFunctorCaller<FunctorCaller4, Functor>(functor, reinterpret_cast<AbstractFunctorCaller::HookType>(&FunctorCaller4<Functor, R , Arg1, Arg2, Arg3, Arg4>::invoke)) {}
+private:
+    typedef R (*InvokeType)(const Storage &, Arg1, Arg2, Arg3);
 
-    static ResultType invoke(AbstractFunctorCaller *call , Arg1 a1, Arg2 a2, Arg3 a3, Arg4 a4)
+    template <class Functor>
+    static ResultType invoke(const Storage &data, Arg1 a1, Arg2 a2, Arg3 a3)
     {
-        typedef FunctorCaller4<Functor, R , Arg1, Arg2, Arg3, Arg4> Type;
-        Type *typed = static_cast<Type*>(call);
-        return (typed->functor)(a1, a2, a3, a4);
+        return (*FunctorStorage<Functor>::get(data))(a1, a2, a3);
     }
+
+    InvokeType invoker;
 };
 
 template <class R , class Arg1, class Arg2, class Arg3, class Arg4>
@@ -255,35 +303,28 @@ struct Callback4 : public BaseCallback
     typedef R (*FunctionType)(Arg1, Arg2, Arg3, Arg4);
     typedef R ResultType;
 
-    Callback4() {}
+    Callback4() : invoker(nullptr) {}
     template <class Functor>
-    Callback4(const Functor &functor) : BaseCallback(new FunctorCaller4<Functor, R , Arg1, Arg2, Arg3, Arg4>(functor)) {}
+    Callback4(const Functor &functor) : invoker(&invoke<Functor>) { create(functor); }
 
     ResultType operator()(Arg1 a1, Arg2 a2, Arg3 a3, Arg4 a4) const
     {
-        if (caller) {
-            typedef R (*InvokeType)(AbstractFunctorCaller* , Arg1, Arg2, Arg3, Arg4);
-            InvokeType invokeMethod = reinterpret_cast<InvokeType>(caller->invokeMethodHook);
-            return invokeMethod(caller , a1, a2, a3, a4);
+        if (isValid()) {
+            return invoker(storage, a1, a2, a3, a4);
         }
         return ResultType();
     }
-};
-
-template <class Functor, class R , class Arg1, class Arg2, class Arg3, class Arg4, class Arg5>
-struct FunctorCaller5 : public BaseFunctorCaller<FunctorCaller5<Functor, R , Arg1, Arg2, Arg3, Arg4, Arg5>, Functor>
-{
-    typedef R ResultType;
-    typedef R (*InvokeType)(AbstractFunctorCaller* , Arg1, Arg2, Arg3, Arg4, Arg5);
 
-    explicit FunctorCaller5(const Functor &functor) : BaseFunctorCaller<FunctorCaller5, Functor>(functor, reinterpret_cast<AbstractFunctorCaller::HookType>(&FunctorCaller5<Functor, R , Arg1, Arg2, Arg3, Arg4, Arg5>::invoke)) {}
+private:
+    typedef R (*InvokeType)(const Storage &, Arg1, Arg2, Arg3, Arg4);
 
-    static ResultType invoke(AbstractFunctorCaller *call , Arg1 a1, Arg2 a2, Arg3 a3, Arg4 a4, Arg5 a5)
+    template <class Functor>
+    static ResultType invoke(const Storage &data, Arg1 a1, Arg2 a2, Arg3 a3, Arg4 a4)
     {
-        typedef FunctorCaller5<Functor, R , Arg1, Arg2, Arg3, Arg4, Arg5> Type;
-        Type *typed = static_cast<Type*>(call);
-        return (typed->functor)(a1, a2, a3, a4, a5);
+        return (*FunctorStorage<Functor>::get(data))(a1, a2, a3, a4);
     }
+
+    InvokeType invoker;
 };
 
 template <class R , class Arg1, class Arg2, class Arg3, class Arg4, class Arg5>
@@ -292,35 +333,28 @@ struct Callback5 : public BaseCallback
     typedef R (*FunctionType)(Arg1, Arg2, Arg3, Arg4, Arg5);
     typedef R ResultType;
 
-    Callback5() {}
+    Callback5() : invoker(nullptr) {}
     template <class Functor>
-    Callback5(const Functor &functor) : BaseCallback(new FunctorCaller5<Functor, R , Arg1, Arg2, Arg3, Arg4, Arg5>(functor)) {}
+    Callback5(const Functor &functor) : invoker(&invoke<Functor>) { create(functor); }
 
     ResultType operator()(Arg1 a1, Arg2 a2, Arg3 a3, Arg4 a4, Arg5 a5) const
     {
-        if (caller) {
-            typedef R (*InvokeType)(AbstractFunctorCaller* , Arg1, Arg2, Arg3, Arg4, Arg5);
-            InvokeType invokeMethod = reinterpret_cast<InvokeType>(caller->invokeMethodHook);
-            return invokeMethod(caller , a1, a2, a3, a4, a5);
+        if (isValid()) {
+            return invoker(storage, a1, a2, a3, a4, a5);
         }
         return ResultType();
     }
-};
 
-template <class Functor, class R , class Arg1, class Arg2, class Arg3, class Arg4, class Arg5, class Arg6>
-struct FunctorCaller6 : public BaseFunctorCaller<FunctorCaller6<Functor, R , Arg1, Arg2, Arg3, Arg4, Arg5, Arg6>, Functor>
-{
-    typedef R ResultType;
-    typedef R (*InvokeType)(AbstractFunctorCaller* , Arg1, Arg2, Arg3, Arg4, Arg5, Arg6);
-
-    explicit FunctorCaller6(const Functor &functor) : BaseFunctorCaller<FunctorCaller6, Functor>(functor, reinterpret_cast<AbstractFunctorCaller::HookType>(&FunctorCaller6<Functor, R , Arg1, Arg2, Arg3, Arg4, Arg5, Arg6>::invoke)) {}
+private:
+    typedef R (*InvokeType)(const Storage &, Arg1, Arg2, Arg3, Arg4, Arg5);
 
-    static ResultType invoke(AbstractFunctorCaller *call , Arg1 a1, Arg2 a2, Arg3 a3, Arg4 a4, Arg5 a5, Arg6 a6)
+    template <class Functor>
+    static ResultType invoke(const Storage &data, Arg1 a1, Arg2 a2, Arg3 a3, Arg4 a4, Arg5 a5)
     {
-        typedef FunctorCaller6<Functor, R , Arg1, Arg2, Arg3, Arg4, Arg5, Arg6> Type;
-        Type *typed = static_cast<Type*>(call);
-        return (typed->functor)(a1, a2, a3, a4, a5, a6);
+        return (*FunctorStorage<Functor>::get(data))(a1, a2, a3, a4, a5);
     }
+
+    InvokeType invoker;
 };
 
 template <class R , class Arg1, class Arg2, class Arg3, class Arg4, class Arg5, class Arg6>
@@ -329,35 +363,28 @@ struct Callback6 : public BaseCallback
     typedef R (*FunctionType)(Arg1, Arg2, Arg3, Arg4, Arg5, Arg6);
     typedef R ResultType;
 
-    Callback6() {}
+    Callback6() : invoker(nullptr) {}
     template <class Functor>
-    Callback6(const Functor &functor) : BaseCallback(new FunctorCaller6<Functor, R , Arg1, Arg2, Arg3, Arg4, Arg5, Arg6>(functor)) {}
+    Callback6(const Functor &functor) : invoker(&invoke<Functor>) { create(functor); }
 
     ResultType operator()(Arg1 a1, Arg2 a2, Arg3 a3, Arg4 a4, Arg5 a5, Arg6 a6) const
     {
-        if (caller) {
-            typedef R (*InvokeType)(AbstractFunctorCaller* , Arg1, Arg2, Arg3, Arg4, Arg5, Arg6);
-            InvokeType invokeMethod = reinterpret_cast<InvokeType>(caller->invokeMethodHook);
-            return invokeMethod(caller , a1, a2, a3, a4, a5, a6);
+        if (isValid()) {
+            return invoker(storage, a1, a2, a3, a4, a5, a6);
         }
         return ResultType();
     }
-};
 
-template <class Functor, class R , class Arg1, class Arg2, class Arg3, class Arg4, class Arg5, class Arg6, class Arg7>
-struct FunctorCaller7 : public BaseFunctorCaller<FunctorCaller7<Functor, R , Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7>, Functor>
-{
-    typedef R ResultType;
-    typedef R (*InvokeType)(AbstractFunctorCaller* , Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7);
-
-    explicit FunctorCaller7(const Functor &functor) : BaseFunctorCaller<FunctorCaller7, Functor>(functor, reinterpret_cast<AbstractFunctorCaller::HookType>(&FunctorCaller7<Functor, R , Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7>::invoke)) {}
+private:
+    typedef R (*InvokeType)(const Storage &, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6);
 
-    static ResultType invoke(AbstractFunctorCaller *call , Arg1 a1, Arg2 a2, Arg3 a3, Arg4 a4, Arg5 a5, Arg6 a6, Arg7 a7)
+    template <class Functor>
+    static ResultType invoke(const Storage &data, Arg1 a1, Arg2 a2, Arg3 a3, Arg4 a4, Arg5 a5, Arg6 a6)
     {
-        typedef FunctorCaller7<Functor, R , Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7> Type;
-        Type *typed = static_cast<Type*>(call);
-        return (typed->functor)(a1, a2, a3, a4, a5, a6, a7);
+        return (*FunctorStorage<Functor>::get(data))(a1, a2, a3, a4, a5, a6);
     }
+
+    InvokeType invoker;
 };
 
 template <class R , class Arg1, class Arg2, class Arg3, class Arg4, class Arg5, class Arg6, class Arg7>
@@ -366,19 +393,28 @@ struct Callback7 : public BaseCallback
     typedef R (*FunctionType)(Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7);
     typedef R ResultType;
 
-    Callback7() {}
+    Callback7() : invoker(nullptr) {}
     template <class Functor>
-    Callback7(const Functor &functor) : BaseCallback(new FunctorCaller7<Functor, R , Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7>(functor)) {}
+    Callback7(const Functor &functor) : invoker(&invoke<Functor>) { create(functor); }
 
     ResultType operator()(Arg1 a1, Arg2 a2, Arg3 a3, Arg4 a4, Arg5 a5, Arg6 a6, Arg7 a7) const
     {
-        if (caller) {
-            typedef R (*InvokeType)(AbstractFunctorCaller* , Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7);
-            InvokeType invokeMethod = reinterpret_cast<InvokeType>(caller->invokeMethodHook);
-            return invokeMethod(caller , a1, a2, a3, a4, a5, a6, a7);
+        if (isValid()) {
+            return invoker(storage, a1, a2, a3, a4, a5, a6, a7);
         }
         return ResultType();
     }
+
+private:
+    typedef R (*InvokeType)(const Storage &, Arg1, Arg2, Arg3, Arg4, Arg5, Arg6, Arg7);
+
+    template <class Functor>
+    static ResultType invoke(const Storage &data, Arg1 a1, Arg2 a2, Arg3 a3, Arg4 a4, Arg5 a5, Arg6 a6, Arg7 a7)
+    {
+        return (*FunctorStorage<Functor>::get(data))(a1, a2, a3, a4, a5, a6, a7);
+    }
+
+    InvokeType invoker;
 };
 
 }
@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/ChannelDispatchOperation>
 #include "TelepathyQt/channel-dispatch-operation-internal.h"
 
@@ -88,7 +90,7 @@ ChannelDispatchOperation::Private::Private(ChannelDispatchOperation *parent)
       readinessHelper(parent->readinessHelper()),
       gotPossibleHandlers(false)
 {
-    debug() << "Creating new ChannelDispatchOperation:" << parent->objectPath();
+    TP_QT_DEBUG() << "Creating new ChannelDispatchOperation:" << parent->objectPath();
 
     parent->connect(baseInterface,
             SIGNAL(Finished()),
@@ -132,13 +134,13 @@ void ChannelDispatchOperation::Private::introspectMain(ChannelDispatchOperation:
             && mainProps.contains(QLatin1String("Connection"))
             && mainProps.contains(QLatin1String("Interfaces"))
             && mainProps.contains(QLatin1String("PossibleHandlers"))) {
-        debug() << "Supplied properties were sufficient, not introspecting"
+        TP_QT_DEBUG() << "Supplied properties were sufficient, not introspecting"
             << self->parent->objectPath();
         self->extractMainProps(mainProps, true);
         return;
     }
 
-    debug() << "Calling Properties::GetAll(ChannelDispatchOperation)";
+    TP_QT_DEBUG() << "Calling Properties::GetAll(ChannelDispatchOperation)";
     QDBusPendingCallWatcher *watcher =
         new QDBusPendingCallWatcher(
                 self->properties->GetAll(TP_QT_IFACE_CHANNEL_DISPATCH_OPERATION),
@@ -210,7 +212,7 @@ void ChannelDispatchOperation::Private::extractMainProps(const QVariantMap &prop
     }
 
     if (readyOps.isEmpty()) {
-        debug() << "No proxies to prepare for CDO" << parent->objectPath();
+        TP_QT_DEBUG() << "No proxies to prepare for CDO" << parent->objectPath();
         readinessHelper->setIntrospectCompleted(FeatureCore, true);
     } else {
         parent->connect(new PendingComposite(readyOps, ChannelDispatchOperationPtr(parent)),
@@ -225,7 +227,7 @@ ChannelDispatchOperation::PendingClaim::PendingClaim(const ChannelDispatchOperat
       mDispatchOp(op),
       mHandler(handler)
 {
-    debug() << "Invoking CDO.Claim";
+    TP_QT_DEBUG() << "Invoking CDO.Claim";
     connect(new PendingVoid(op->baseInterface()->Claim(), op),
             SIGNAL(finished(Tp::PendingOperation*)),
             SLOT(onClaimFinished(Tp::PendingOperation*)));
@@ -239,7 +241,7 @@ void ChannelDispatchOperation::PendingClaim::onClaimFinished(
         PendingOperation *op)
 {
     if (!op->isError()) {
-        debug() << "CDO.Claim returned successfully, updating HandledChannels";
+        TP_QT_DEBUG() << "CDO.Claim returned successfully, updating HandledChannels";
         if (mHandler) {
             // register the channels in HandledChannels
             FakeHandlerManager::instance()->registerChannels(
@@ -247,7 +249,7 @@ void ChannelDispatchOperation::PendingClaim::onClaimFinished(
         }
         setFinished();
     } else {
-        warning() << "CDO.Claim failed with" << op->errorName() << "-" << op->errorMessage();
+        TP_QT_WARNING() << "CDO.Claim failed with" << op->errorName() << "-" << op->errorMessage();
         setFinishedWithError(op->errorName(), op->errorMessage());
     }
 }
@@ -366,15 +368,15 @@ ChannelDispatchOperation::ChannelDispatchOperation(const QDBusConnection &bus,
       mPriv(new Private(this))
 {
     if (accountFactory->dbusConnection().name() != bus.name()) {
-        warning() << "  The D-Bus connection in the account factory is not the proxy connection";
+        TP_QT_WARNING() << "  The D-Bus connection in the account factory is not the proxy connection";
     }
 
     if (connectionFactory->dbusConnection().name() != bus.name()) {
-        warning() << "  The D-Bus connection in the connection factory is not the proxy connection";
+        TP_QT_WARNING() << "  The D-Bus connection in the connection factory is not the proxy connection";
     }
 
     if (channelFactory->dbusConnection().name() != bus.name()) {
-        warning() << "  The D-Bus connection in the channel factory is not the proxy connection";
+        TP_QT_WARNING() << "  The D-Bus connection in the channel factory is not the proxy connection";
     }
 
     mPriv->channels = initialChannels;
@@ -431,7 +433,7 @@ AccountPtr ChannelDispatchOperation::account() const
 QList<ChannelPtr> ChannelDispatchOperation::channels() const
 {
     if (!isReady()) {
-        warning() << "ChannelDispatchOperation::channels called with channel "
+        TP_QT_WARNING() << "ChannelDispatchOperation::channels called with channel "
             "not ready";
     }
     return mPriv->channels;
@@ -573,7 +575,7 @@ Client::ChannelDispatchOperationInterface *ChannelDispatchOperation::baseInterfa
 
 void ChannelDispatchOperation::onFinished()
 {
-    debug() << "ChannelDispatchOperation finished and was removed";
+    TP_QT_DEBUG() << "ChannelDispatchOperation finished and was removed";
     invalidate(TP_QT_ERROR_OBJECT_REMOVED,
                QLatin1String("ChannelDispatchOperation finished and was removed"));
 }
@@ -584,12 +586,12 @@ void ChannelDispatchOperation::gotMainProperties(QDBusPendingCallWatcher *watche
 
     // Watcher is NULL if we didn't have to introspect at all
     if (!reply.isError()) {
-        debug() << "Got reply to Properties::GetAll(ChannelDispatchOperation)";
+        TP_QT_DEBUG() << "Got reply to Properties::GetAll(ChannelDispatchOperation)";
         mPriv->extractMainProps(reply.value(), false);
     } else {
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore,
                 false, reply.error());
-        warning().nospace() << "Properties::GetAll(ChannelDispatchOperation) failed with "
+        TP_QT_WARNING().nospace() << "Properties::GetAll(ChannelDispatchOperation) failed with "
             << reply.error().name() << ": " << reply.error().message();
     }
 }
@@ -610,7 +612,7 @@ void ChannelDispatchOperation::onChannelLost(
 void ChannelDispatchOperation::onProxiesPrepared(Tp::PendingOperation *op)
 {
     if (op->isError()) {
-        warning() << "Preparing proxies for CDO" << objectPath() << "failed with"
+        TP_QT_WARNING() << "Preparing proxies for CDO" << objectPath() << "failed with"
             << op->errorName() << ":" << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, false);
     } else {
@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/ChannelFactory>
 
 #include "TelepathyQt/_gen/channel-factory.moc.hpp"
@@ -594,7 +596,7 @@ void ChannelFactory::setConstructorFor(const ChannelClassSpec &channelClass,
         const ConstructorConstPtr &ctor)
 {
     if (ctor.isNull()) {
-        warning().nospace() << "Tried to set a NULL ctor for ChannelClass("
+        TP_QT_WARNING().nospace() << "Tried to set a NULL ctor for ChannelClass("
             << channelClass.channelType() << ", " << channelClass.targetHandleType() << ", "
             << channelClass.allProperties().size() << "props in total)";
         return;
@@ -40,8 +40,8 @@ public:
 private Q_SLOTS:
     TP_QT_NO_EXPORT void onChanInvalidated(Tp::DBusProxy *proxy);
     TP_QT_NO_EXPORT void onRemoveFinished(Tp::PendingOperation *);
-    TP_QT_NO_EXPORT void onMembersChanged(const Tp::Contacts &, const Tp::Contacts &, const Tp::Contacts &,
-            const Tp::Contacts &);
+    TP_QT_NO_EXPORT void onMemberHandlesChanged(const Tp::UIntList &, const Tp::UIntList &,
+            const Tp::UIntList &, const Tp::UIntList &);
     TP_QT_NO_EXPORT void onCloseFinished(Tp::PendingOperation *);
 };
 
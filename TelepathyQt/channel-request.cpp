@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/ChannelRequest>
 
 #include "TelepathyQt/_gen/cli-channel-request-body.hpp"
@@ -102,7 +104,7 @@ ChannelRequest::Private::Private(ChannelRequest *parent,
       propertiesDone(false),
       gotSWC(false)
 {
-    debug() << "Creating new ChannelRequest:" << parent->objectPath();
+    TP_QT_DEBUG() << "Creating new ChannelRequest:" << parent->objectPath();
 
     parent->connect(baseInterface,
             SIGNAL(Failed(QString,QString)),
@@ -166,7 +168,7 @@ void ChannelRequest::Private::introspectMain(ChannelRequest::Private *self)
     }
 
     if (needIntrospectMainProps) {
-        debug() << "Calling Properties::GetAll(ChannelRequest)";
+        TP_QT_DEBUG() << "Calling Properties::GetAll(ChannelRequest)";
         QDBusPendingCallWatcher *watcher =
             new QDBusPendingCallWatcher(
                     self->properties->GetAll(TP_QT_IFACE_CHANNEL_REQUEST),
@@ -199,7 +201,7 @@ void ChannelRequest::Private::extractMainProps(const QVariantMap &props, bool la
                 // Most often a no-op, but we want this to guarantee the old behavior in all cases
                 readyOp = account->becomeReady();
             } else {
-                warning() << "The account" << accountObjectPath.path() << "was not the expected"
+                TP_QT_WARNING() << "The account" << accountObjectPath.path() << "was not the expected"
                     << account->objectPath() << "for CR" << parent->objectPath();
                 // Construct a new one instead
                 account.reset();
@@ -251,7 +253,7 @@ void ChannelRequest::Private::extractMainProps(const QVariantMap &props, bool la
                 SIGNAL(finished(Tp::PendingOperation*)),
                 SLOT(onAccountReady(Tp::PendingOperation*)));
     } else if (lastCall) {
-        warning() << "No account for ChannelRequest" << parent->objectPath();
+        TP_QT_WARNING() << "No account for ChannelRequest" << parent->objectPath();
         readinessHelper->setIntrospectCompleted(FeatureCore, true);
     }
 }
@@ -352,15 +354,15 @@ ChannelRequest::ChannelRequest(const QDBusConnection &bus,
                   channelFactory, contactFactory))
 {
     if (accountFactory->dbusConnection().name() != bus.name()) {
-        warning() << "  The D-Bus connection in the account factory is not the proxy connection";
+        TP_QT_WARNING() << "  The D-Bus connection in the account factory is not the proxy connection";
     }
 
     if (connectionFactory->dbusConnection().name() != bus.name()) {
-        warning() << "  The D-Bus connection in the connection factory is not the proxy connection";
+        TP_QT_WARNING() << "  The D-Bus connection in the connection factory is not the proxy connection";
     }
 
     if (channelFactory->dbusConnection().name() != bus.name()) {
-        warning() << "  The D-Bus connection in the channel factory is not the proxy connection";
+        TP_QT_WARNING() << "  The D-Bus connection in the channel factory is not the proxy connection";
     }
 }
 
@@ -599,14 +601,14 @@ void ChannelRequest::gotMainProperties(QDBusPendingCallWatcher *watcher)
     QVariantMap props;
 
     if (!reply.isError()) {
-        debug() << "Got reply to Properties::GetAll(ChannelRequest)";
+        TP_QT_DEBUG() << "Got reply to Properties::GetAll(ChannelRequest)";
         props = reply.value();
 
         mPriv->extractMainProps(props, true);
     } else {
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore,
                 false, reply.error());
-        warning().nospace() << "Properties::GetAll(ChannelRequest) failed with "
+        TP_QT_WARNING().nospace() << "Properties::GetAll(ChannelRequest) failed with "
             << reply.error().name() << ": " << reply.error().message();
     }
 
@@ -616,7 +618,7 @@ void ChannelRequest::gotMainProperties(QDBusPendingCallWatcher *watcher)
 void ChannelRequest::onAccountReady(PendingOperation *op)
 {
     if (op->isError()) {
-        warning() << "Unable to make ChannelRequest.Account ready";
+        TP_QT_WARNING() << "Unable to make ChannelRequest.Account ready";
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, false,
                 op->errorName(), op->errorMessage());
         return;
@@ -643,7 +645,7 @@ void ChannelRequest::onSucceededWithChannel(
         const QVariantMap &chanProps)
 {
     if (mPriv->gotSWC) {
-        warning().nospace() << "Got SucceededWithChannel again for CR(" << objectPath() << ")!";
+        TP_QT_WARNING().nospace() << "Got SucceededWithChannel again for CR(" << objectPath() << ")!";
         return;
     }
 
@@ -670,7 +672,7 @@ void ChannelRequest::onSucceededWithChannel(
 void ChannelRequest::onChanBuilt(Tp::PendingOperation *op)
 {
     if (op->isError()) {
-        warning() << "Failed to build Channel which the ChannelRequest succeeded with,"
+        TP_QT_WARNING() << "Failed to build Channel which the ChannelRequest succeeded with,"
             << "succeeding with NULL channel:" << op->errorName() << ',' << op->errorMessage();
         mPriv->chan.reset();
     }
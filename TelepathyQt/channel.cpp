@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/Channel>
 #include "TelepathyQt/channel-internal.h"
 
@@ -76,6 +78,7 @@ struct TP_QT_NO_EXPORT Channel::Private
     void introspectConference();
 
     static void introspectConferenceInitialInviteeContacts(Private *self);
+    static void introspectGroupMemberHandles(Private *self);
 
     void continueIntrospection();
 
@@ -91,6 +94,7 @@ struct TP_QT_NO_EXPORT Channel::Private
     void doMembersChangedDetailed(const UIntList &, const UIntList &, const UIntList &,
             const UIntList &, const QVariantMap &);
     void processMembersChanged();
+    void updateMemberHandles();
     void updateContacts(const QList<ContactPtr> &contacts =
             QList<ContactPtr>());
     bool fakeGroupInterfaceIfNeeded();
@@ -159,6 +163,9 @@ struct TP_QT_NO_EXPORT Channel::Private
     // Group member introspection
     bool groupHaveMembers;
     bool buildingContacts;
+    // Whether FeatureGroupMemberHandles was requested before FeatureCore started introspecting,
+    // in which case no Contact objects are built for the members
+    bool groupMemberHandlesOnly;
 
     // Queue of received MCD signals to process
     QQueue<GroupMembersChangedInfo *> groupMembersChangedQueue;
@@ -182,6 +189,12 @@ struct TP_QT_NO_EXPORT Channel::Private
     QHash<uint, ContactPtr> groupLocalPendingContacts;
     QHash<uint, ContactPtr> groupRemotePendingContacts;
 
+    // Current members as handles, maintained in both modes
+    QSet<uint> groupMemberHandles;
+    QSet<uint> groupLocalPendingMemberHandles;
+    QSet<uint> groupRemotePendingMemberHandles;
+    HandleIdentifierMap groupMemberIds;
+
     // Stored change info
     QHash<uint, GroupMemberChangeDetails> groupLocalPendingContactsChangeInfo;
     GroupMemberChangeDetails groupSelfContactRemoveInfo;
@@ -277,6 +290,7 @@ Channel::Private::Private(Channel *parent, const ConnectionPtr &connection,
       usingMembersChangedDetailed(false),
       groupHaveMembers(false),
       buildingContacts(false),
+      groupMemberHandlesOnly(false),
       currentGroupMembersChangedInfo(nullptr),
       groupAreHandleOwnersAvailable(false),
       pendingRetrieveGroupSelfContact(false),
@@ -285,21 +299,21 @@ Channel::Private::Private(Channel *parent, const ConnectionPtr &connection,
       introspectingConference(false),
       buildingConferenceChannelRemovedActorContact(false)
 {
-    debug() << "Creating new Channel:" << parent->objectPath();
+    TP_QT_DEBUG() << "Creating new Channel:" << parent->objectPath();
 
     if (connection->isValid()) {
-        debug() << " Connecting to Channel::Closed() signal";
+        TP_QT_DEBUG() << " Connecting to Channel::Closed() signal";
         parent->connect(baseInterface,
                         SIGNAL(Closed()),
                         SLOT(onClosed()));
 
-        debug() << " Connection to owning connection's lifetime signals";
+        TP_QT_DEBUG() << " Connection to owning connection's lifetime signals";
         parent->connect(connection.data(),
                         SIGNAL(invalidated(Tp::DBusProxy*,QString,QString)),
                         SLOT(onConnectionInvalidated()));
     }
     else {
-        warning() << "Connection given as the owner for a Channel was "
+        TP_QT_WARNING() << "Connection given as the owner for a Channel was "
             "invalid! Channel will be stillborn.";
         parent->invalidate(TP_QT_ERROR_INVALID_ARGUMENT,
                 QLatin1String("Connection given as the owner of this channel was invalid"));
@@ -326,6 +340,15 @@ Channel::Private::Private(Channel *parent, const ConnectionPtr &connection,
     introspectables[FeatureConferenceInitialInviteeContacts] =
         introspectableConferenceInitialInviteeContacts;
 
+    // As Channel does not have predefined statuses let's simulate one (0)
+    ReadinessHelper::Introspectable introspectableGroupMemberHandles(
+        QSet<uint>() << 0,                                           // makesSenseForStatuses
+        Features() << FeatureCore,                                   // dependsOnFeatures
+        QStringList(),                                               // dependsOnInterfaces
+        (ReadinessHelper::IntrospectFunc) &Private::introspectGroupMemberHandles,
+        this);
+    introspectables[FeatureGroupMemberHandles] = introspectableGroupMemberHandles;
+
     readinessHelper->addIntrospectables(introspectables);
 }
 
@@ -342,9 +365,17 @@ Channel::Private::~Private()
 
 void Channel::Private::introspectMain(Channel::Private *self)
 {
+    // The membership mode has to be decided before the initial members are processed, so only
+    // honour FeatureGroupMemberHandles if it was requested along with the core feature
+    self->groupMemberHandlesOnly = self->readinessHelper->requestedFeatures().contains(
+            FeatureGroupMemberHandles);
+    if (self->groupMemberHandlesOnly) {
+        TP_QT_DEBUG() << "Tracking group members as handles only for" << self->parent->objectPath();
+    }
+
     // Make sure connection object is ready, as we need to use some methods that
     // are only available after connection object gets ready.
-    debug() << "Calling Connection::becomeReady()";
+    TP_QT_DEBUG() << "Calling Connection::becomeReady()";
     self->parent->connect(self->connection->becomeReady(),
             SIGNAL(finished(Tp::PendingOperation*)),
             SLOT(onConnectionReady(Tp::PendingOperation*)));
@@ -395,7 +426,7 @@ void Channel::Private::introspectMainProperties()
     }
 
     if (needIntrospectMainProps) {
-        debug() << "Calling Properties::GetAll(Channel)";
+        TP_QT_DEBUG() << "Calling Properties::GetAll(Channel)";
         QDBusPendingCallWatcher *watcher =
             new QDBusPendingCallWatcher(
                     properties->GetAll(TP_QT_IFACE_CHANNEL),
@@ -411,7 +442,7 @@ void Channel::Private::introspectMainProperties()
 
 void Channel::Private::introspectMainFallbackChannelType()
 {
-    debug() << "Calling Channel::GetChannelType()";
+    TP_QT_DEBUG() << "Calling Channel::GetChannelType()";
     QDBusPendingCallWatcher *watcher =
         new QDBusPendingCallWatcher(baseInterface->GetChannelType(), parent);
     parent->connect(watcher,
@@ -421,7 +452,7 @@ void Channel::Private::introspectMainFallbackChannelType()
 
 void Channel::Private::introspectMainFallbackHandle()
 {
-    debug() << "Calling Channel::GetHandle()";
+    TP_QT_DEBUG() << "Calling Channel::GetHandle()";
     QDBusPendingCallWatcher *watcher =
         new QDBusPendingCallWatcher(baseInterface->GetHandle(), parent);
     parent->connect(watcher,
@@ -431,7 +462,7 @@ void Channel::Private::introspectMainFallbackHandle()
 
 void Channel::Private::introspectMainFallbackInterfaces()
 {
-    debug() << "Calling Channel::GetInterfaces()";
+    TP_QT_DEBUG() << "Calling Channel::GetInterfaces()";
     QDBusPendingCallWatcher *watcher =
         new QDBusPendingCallWatcher(baseInterface->GetInterfaces(), parent);
     parent->connect(watcher,
@@ -448,7 +479,7 @@ void Channel::Private::introspectGroup()
         Q_ASSERT(group != nullptr);
     }
 
-    debug() << "Introspecting Channel.Interface.Group for" << parent->objectPath();
+    TP_QT_DEBUG() << "Introspecting Channel.Interface.Group for" << parent->objectPath();
 
     parent->connect(group,
                     SIGNAL(GroupFlagsChanged(uint,uint)),
@@ -479,7 +510,7 @@ void Channel::Private::introspectGroup()
                     SIGNAL(SelfHandleChanged(uint)),
                     SLOT(onSelfHandleChanged(uint)));
 
-    debug() << "Calling Properties::GetAll(Channel.Interface.Group)";
+    TP_QT_DEBUG() << "Calling Properties::GetAll(Channel.Interface.Group)";
     QDBusPendingCallWatcher *watcher =
         new QDBusPendingCallWatcher(
                 properties->GetAll(TP_QT_IFACE_CHANNEL_INTERFACE_GROUP),
@@ -493,7 +524,7 @@ void Channel::Private::introspectGroupFallbackFlags()
 {
     Q_ASSERT(group != nullptr);
 
-    debug() << "Calling Channel.Interface.Group::GetGroupFlags()";
+    TP_QT_DEBUG() << "Calling Channel.Interface.Group::GetGroupFlags()";
     QDBusPendingCallWatcher *watcher =
         new QDBusPendingCallWatcher(group->GetGroupFlags(), parent);
     parent->connect(watcher,
@@ -505,7 +536,7 @@ void Channel::Private::introspectGroupFallbackMembers()
 {
     Q_ASSERT(group != nullptr);
 
-    debug() << "Calling Channel.Interface.Group::GetAllMembers()";
+    TP_QT_DEBUG() << "Calling Channel.Interface.Group::GetAllMembers()";
     QDBusPendingCallWatcher *watcher =
         new QDBusPendingCallWatcher(group->GetAllMembers(), parent);
     parent->connect(watcher,
@@ -517,7 +548,7 @@ void Channel::Private::introspectGroupFallbackLocalPendingWithInfo()
 {
     Q_ASSERT(group != nullptr);
 
-    debug() << "Calling Channel.Interface.Group::GetLocalPendingMembersWithInfo()";
+    TP_QT_DEBUG() << "Calling Channel.Interface.Group::GetLocalPendingMembersWithInfo()";
     QDBusPendingCallWatcher *watcher =
         new QDBusPendingCallWatcher(group->GetLocalPendingMembersWithInfo(),
                 parent);
@@ -530,7 +561,7 @@ void Channel::Private::introspectGroupFallbackSelfHandle()
 {
     Q_ASSERT(group != nullptr);
 
-    debug() << "Calling Channel.Interface.Group::GetSelfHandle()";
+    TP_QT_DEBUG() << "Calling Channel.Interface.Group::GetSelfHandle()";
     QDBusPendingCallWatcher *watcher =
         new QDBusPendingCallWatcher(group->GetSelfHandle(), parent);
     parent->connect(watcher,
@@ -543,13 +574,13 @@ void Channel::Private::introspectConference()
     Q_ASSERT(properties != nullptr);
     Q_ASSERT(conference == nullptr);
 
-    debug() << "Introspecting Conference interface";
+    TP_QT_DEBUG() << "Introspecting Conference interface";
     conference = parent->interface<Client::ChannelInterfaceConferenceInterface>();
     Q_ASSERT(conference != nullptr);
 
     introspectingConference = true;
 
-    debug() << "Connecting to Channel.Interface.Conference.ChannelMerged/Removed";
+    TP_QT_DEBUG() << "Connecting to Channel.Interface.Conference.ChannelMerged/Removed";
     parent->connect(conference,
             SIGNAL(ChannelMerged(QDBusObjectPath,uint,QVariantMap)),
             SLOT(onConferenceChannelMerged(QDBusObjectPath,uint,QVariantMap)));
@@ -557,7 +588,7 @@ void Channel::Private::introspectConference()
             SIGNAL(ChannelRemoved(QDBusObjectPath,QVariantMap)),
             SLOT(onConferenceChannelRemoved(QDBusObjectPath,QVariantMap)));
 
-    debug() << "Calling Properties::GetAll(Channel.Interface.Conference)";
+    TP_QT_DEBUG() << "Calling Properties::GetAll(Channel.Interface.Conference)";
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(
             properties->GetAll(TP_QT_IFACE_CHANNEL_INTERFACE_CONFERENCE),
             parent);
@@ -581,6 +612,12 @@ void Channel::Private::introspectConferenceInitialInviteeContacts(Private *self)
     }
 }
 
+void Channel::Private::introspectGroupMemberHandles(Private *self)
+{
+    // The handle sets are kept up to date along with FeatureCore, whichever mode it runs in
+    self->readinessHelper->setIntrospectCompleted(FeatureGroupMemberHandles, true);
+}
+
 void Channel::Private::continueIntrospection()
 {
     if (introspectQueue.isEmpty()) {
@@ -588,10 +625,10 @@ void Channel::Private::continueIntrospection()
         if (!parent->isReady(Channel::FeatureCore)) {
             if (groupMembersChangedQueue.isEmpty() && !buildingContacts &&
                 !introspectingConference) {
-                debug() << "Both the IS and the MCD queue empty for the first time. Ready.";
+                TP_QT_DEBUG() << "Both the IS and the MCD queue empty for the first time. Ready.";
                 setReady();
             } else {
-                debug() << "Introspection done before contacts done - contacts sets ready";
+                TP_QT_DEBUG() << "Introspection done before contacts done - contacts sets ready";
             }
         }
     } else {
@@ -614,7 +651,7 @@ void Channel::Private::extractMainProps(const QVariantMap &props)
                   && props.contains(keyTargetHandleType);
 
     if (!haveProps) {
-        warning() << "Channel properties specified in 0.17.7 not found";
+        TP_QT_WARNING() << "Channel properties specified in 0.17.7 not found";
 
         introspectQueue.enqueue(&Private::introspectMainFallbackChannelType);
         introspectQueue.enqueue(&Private::introspectMainFallbackHandle);
@@ -665,7 +702,7 @@ void Channel::Private::extractMainProps(const QVariantMap &props)
         nowHaveInterfaces();
     }
 
-    debug() << "Have initiator handle:" << (initiatorHandle ? "yes" : "no");
+    TP_QT_DEBUG() << "Have initiator handle:" << (initiatorHandle ? "yes" : "no");
 }
 
 void Channel::Private::extract0176GroupProps(const QVariantMap &props)
@@ -674,6 +711,7 @@ void Channel::Private::extract0176GroupProps(const QVariantMap &props)
     const static QString keyHandleOwners(QLatin1String("HandleOwners"));
     const static QString keyLPMembers(QLatin1String("LocalPendingMembers"));
     const static QString keyMembers(QLatin1String("Members"));
+    const static QString keyMemberIds(QLatin1String("MemberIdentifiers"));
     const static QString keyRPMembers(QLatin1String("RemotePendingMembers"));
     const static QString keySelfHandle(QLatin1String("SelfHandle"));
 
@@ -688,15 +726,15 @@ void Channel::Private::extract0176GroupProps(const QVariantMap &props)
                   && props.contains(keySelfHandle);
 
     if (!haveProps) {
-        warning() << " Properties specified in 0.17.6 not found";
-        warning() << "  Handle owners and self handle tracking disabled";
+        TP_QT_WARNING() << " Properties specified in 0.17.6 not found";
+        TP_QT_WARNING() << "  Handle owners and self handle tracking disabled";
 
         introspectQueue.enqueue(&Private::introspectGroupFallbackFlags);
         introspectQueue.enqueue(&Private::introspectGroupFallbackMembers);
         introspectQueue.enqueue(&Private::introspectGroupFallbackLocalPendingWithInfo);
         introspectQueue.enqueue(&Private::introspectGroupFallbackSelfHandle);
     } else {
-        debug() << " Found properties specified in 0.17.6";
+        TP_QT_DEBUG() << " Found properties specified in 0.17.6";
 
         groupAreHandleOwnersAvailable = true;
         groupIsSelfHandleTracked = true;
@@ -708,6 +746,11 @@ void Channel::Private::extract0176GroupProps(const QVariantMap &props)
         groupInitialLP = qdbus_cast<LocalPendingInfoList>(props[keyLPMembers]);
         groupInitialRP = qdbus_cast<UIntList>(props[keyRPMembers]);
 
+        if (props.contains(keyMemberIds)) {
+            groupMemberIds = qdbus_cast<HandleIdentifierMap>(props[keyMemberIds]);
+            connection->lowlevel()->injectContactIds(groupMemberIds);
+        }
+
         uint propSelfHandle = qdbus_cast<uint>(props[keySelfHandle]);
         // Don't overwrite the self handle we got from the Connection with 0
         if (propSelfHandle) {
@@ -720,7 +763,7 @@ void Channel::Private::extract0176GroupProps(const QVariantMap &props)
 
 void Channel::Private::nowHaveInterfaces()
 {
-    debug() << "Channel has" << parent->interfaces().size() <<
+    TP_QT_DEBUG() << "Channel has" << parent->interfaces().size() <<
         "optional interfaces:" << parent->interfaces();
 
     QStringList interfaces = parent->interfaces();
@@ -800,7 +843,7 @@ bool Channel::Private::setGroupFlags(uint newGroupFlags)
     if ((groupFlags & ChannelGroupFlagMembersChangedDetailed) &&
         !usingMembersChangedDetailed) {
         usingMembersChangedDetailed = true;
-        debug() << "Starting to exclusively listen to MembersChangedDetailed for" <<
+        TP_QT_DEBUG() << "Starting to exclusively listen to MembersChangedDetailed for" <<
             parent->objectPath();
         parent->disconnect(group,
                            SIGNAL(MembersChanged(QString,Tp::UIntList,
@@ -812,7 +855,7 @@ bool Channel::Private::setGroupFlags(uint newGroupFlags)
                                    Tp::UIntList,uint,uint)));
     } else if (!(groupFlags & ChannelGroupFlagMembersChangedDetailed) &&
                usingMembersChangedDetailed) {
-        warning() << " Channel service did spec-incompliant removal of MCD from GroupFlags";
+        TP_QT_WARNING() << " Channel service did spec-incompliant removal of MCD from GroupFlags";
         usingMembersChangedDetailed = false;
         parent->connect(group,
                         SIGNAL(MembersChanged(QString,Tp::UIntList,
@@ -892,26 +935,26 @@ void Channel::Private::processMembersChanged()
 
         if (!parent->isReady(Channel::FeatureCore)) {
             if (introspectQueue.isEmpty()) {
-                debug() << "Both the MCD and the introspect queue empty for the first time. Ready!";
+                TP_QT_DEBUG() << "Both the MCD and the introspect queue empty for the first time. Ready!";
 
                 if (initiatorHandle && !initiatorContact) {
-                    warning() << " Unable to create contact object for initiator with handle" <<
+                    TP_QT_WARNING() << " Unable to create contact object for initiator with handle" <<
                         initiatorHandle;
                 }
 
                 if (targetHandleType == HandleTypeContact && targetHandle != 0 && !targetContact) {
-                    warning() << " Unable to create contact object for target with handle" <<
+                    TP_QT_WARNING() << " Unable to create contact object for target with handle" <<
                         targetHandle;
                 }
 
                 if (groupSelfHandle && !groupSelfContact) {
-                    warning() << " Unable to create contact object for self handle" <<
+                    TP_QT_WARNING() << " Unable to create contact object for self handle" <<
                         groupSelfHandle;
                 }
 
                 continueIntrospection();
             } else {
-                debug() << "Contact queue empty but introspect queue isn't. IS will set ready.";
+                TP_QT_DEBUG() << "Contact queue empty but introspect queue isn't. IS will set ready.";
             }
         }
 
@@ -929,6 +972,13 @@ void Channel::Private::processMembersChanged()
 
     currentGroupMembersChangedInfo = groupMembersChangedQueue.dequeue();
 
+    if (groupMemberHandlesOnly) {
+        // Membership is applied to the handle sets in updateMemberHandles(), but the actor, self,
+        // initiator and target contacts are still built
+        buildContacts();
+        return;
+    }
+
     foreach (uint handle, currentGroupMembersChangedInfo->added) {
         if (!groupContacts.contains(handle)) {
             pendingGroupMembers.insert(handle);
@@ -963,6 +1013,81 @@ void Channel::Private::processMembersChanged()
     buildContacts();
 }
 
+void Channel::Private::updateMemberHandles()
+{
+    if (!currentGroupMembersChangedInfo) {
+        return;
+    }
+
+    const GroupMembersChangedInfo *info = currentGroupMembersChangedInfo;
+    HandleIdentifierMap contactIds = qdbus_cast<HandleIdentifierMap>(
+            info->details.value(GroupMembersChangedInfo::keyContactIds));
+
+    UIntList membersAdded;
+    UIntList localPendingMembersAdded;
+    UIntList remotePendingMembersAdded;
+    UIntList membersRemoved;
+
+    // A handle is in at most one of the sets, so moving it to one removes it from the others
+    foreach (uint handle, info->added) {
+        if (!groupMemberHandles.contains(handle)) {
+            groupLocalPendingMemberHandles.remove(handle);
+            groupRemotePendingMemberHandles.remove(handle);
+            groupMemberHandles.insert(handle);
+            membersAdded.append(handle);
+        }
+    }
+
+    foreach (uint handle, info->localPending) {
+        if (!groupLocalPendingMemberHandles.contains(handle)) {
+            groupMemberHandles.remove(handle);
+            groupRemotePendingMemberHandles.remove(handle);
+            groupLocalPendingMemberHandles.insert(handle);
+            localPendingMembersAdded.append(handle);
+        }
+    }
+
+    foreach (uint handle, info->remotePending) {
+        if (!groupRemotePendingMemberHandles.contains(handle)) {
+            groupMemberHandles.remove(handle);
+            groupLocalPendingMemberHandles.remove(handle);
+            groupRemotePendingMemberHandles.insert(handle);
+            remotePendingMembersAdded.append(handle);
+        }
+    }
+
+    foreach (uint handle, info->removed) {
+        if (groupMemberHandles.remove(handle) ||
+            groupLocalPendingMemberHandles.remove(handle) ||
+            groupRemotePendingMemberHandles.remove(handle)) {
+            groupMemberIds.remove(handle);
+            membersRemoved.append(handle);
+        }
+    }
+
+    for (HandleIdentifierMap::const_iterator i = contactIds.constBegin();
+            i != contactIds.constEnd(); ++i) {
+        if (groupMemberHandles.contains(i.key()) ||
+            groupLocalPendingMemberHandles.contains(i.key()) ||
+            groupRemotePendingMemberHandles.contains(i.key())) {
+            groupMemberIds.insert(i.key(), i.value());
+        }
+    }
+
+    if ((!membersAdded.isEmpty() ||
+         !localPendingMembersAdded.isEmpty() ||
+         !remotePendingMembersAdded.isEmpty() ||
+         !membersRemoved.isEmpty()) &&
+        parent->isReady(Channel::FeatureCore)) {
+        emit parent->groupMemberHandlesChanged(
+                membersAdded,
+                localPendingMembersAdded,
+                remotePendingMembersAdded,
+                membersRemoved,
+                info->details);
+    }
+}
+
 void Channel::Private::updateContacts(const QList<ContactPtr> &contacts)
 {
     Contacts groupContactsAdded;
@@ -971,7 +1096,7 @@ void Channel::Private::updateContacts(const QList<ContactPtr> &contacts)
     ContactPtr actorContact;
     bool selfContactUpdated = false;
 
-    debug() << "Entering Chan::Priv::updateContacts() with" << contacts.size() << "contacts";
+    TP_QT_DEBUG() << "Entering Chan::Priv::updateContacts() with" << contacts.size() << "contacts";
 
     // FIXME: simplify. Some duplication of logic present.
     foreach (ContactPtr contact, contacts) {
@@ -1071,6 +1196,8 @@ void Channel::Private::updateContacts(const QList<ContactPtr> &contacts)
     }
     groupRemotePendingMembersToRemove.clear();
 
+    updateMemberHandles();
+
     if (!groupContactsAdded.isEmpty() ||
         !groupLocalPendingContactsAdded.isEmpty() ||
         !groupRemotePendingContactsAdded.isEmpty() ||
@@ -1123,12 +1250,12 @@ bool Channel::Private::fakeGroupInterfaceIfNeeded()
         groupSelfHandle = connection->selfHandle();
         groupInitialMembers = UIntList() << groupSelfHandle << targetHandle;
 
-        debug().nospace() << "Faking a group on channel with self handle=" <<
+        TP_QT_DEBUG().nospace() << "Faking a group on channel with self handle=" <<
             groupSelfHandle << " and other handle=" << targetHandle;
 
         nowHaveInitialMembers();
     } else {
-        warning() << "Connection::selfHandle is 0 or targetHandle is 0, "
+        TP_QT_WARNING() << "Connection::selfHandle is 0 or targetHandle is 0, "
             "not faking a group on channel";
     }
 
@@ -1139,27 +1266,29 @@ void Channel::Private::setReady()
 {
     Q_ASSERT(!parent->isReady(Channel::FeatureCore));
 
-    debug() << "Channel fully ready";
-    debug() << " Channel type" << channelType;
-    debug() << " Target handle" << targetHandle;
-    debug() << " Target handle type" << targetHandleType;
+    TP_QT_DEBUG() << "Channel fully ready";
+    TP_QT_DEBUG() << " Channel type" << channelType;
+    TP_QT_DEBUG() << " Target handle" << targetHandle;
+    TP_QT_DEBUG() << " Target handle type" << targetHandleType;
 
     if (parent->interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_GROUP)) {
-        debug() << " Group: flags" << groupFlags;
+        TP_QT_DEBUG() << " Group: flags" << groupFlags;
         if (groupAreHandleOwnersAvailable) {
-            debug() << " Group: Number of handle owner mappings" <<
+            TP_QT_DEBUG() << " Group: Number of handle owner mappings" <<
                 groupHandleOwners.size();
         }
         else {
-            debug() << " Group: No handle owners property present";
-        }
-        debug() << " Group: Number of current members" <<
-            groupContacts.size();
-        debug() << " Group: Number of local pending members" <<
-            groupLocalPendingContacts.size();
-        debug() << " Group: Number of remote pending members" <<
-            groupRemotePendingContacts.size();
-        debug() << " Group: Self handle" << groupSelfHandle <<
+            TP_QT_DEBUG() << " Group: No handle owners property present";
+        }
+        TP_QT_DEBUG() << " Group: Number of current members" <<
+            groupMemberHandles.size();
+        TP_QT_DEBUG() << " Group: Number of local pending members" <<
+            groupLocalPendingMemberHandles.size();
+        TP_QT_DEBUG() << " Group: Number of remote pending members" <<
+            groupRemotePendingMemberHandles.size();
+        TP_QT_DEBUG() << " Group: Members tracked as handles only:" <<
+            (groupMemberHandlesOnly ? "yes" : "no");
+        TP_QT_DEBUG() << " Group: Self handle" << groupSelfHandle <<
             "tracked:" << (groupIsSelfHandleTracked ? "yes" : "no");
     }
 
@@ -1546,6 +1675,26 @@ const Feature Channel::FeatureCore = Feature(QLatin1String(Channel::staticMetaOb
  */
 const Feature Channel::FeatureConferenceInitialInviteeContacts = Feature(QLatin1String(Channel::staticMetaObject.className()), 1, true);
 
+/**
+ * Feature used in order to track the group members as handles only.
+ *
+ * By default, FeatureCore builds a Contact object for every member, local pending member and
+ * remote pending member of the group before the channel becomes ready, which is expensive for
+ * rooms with thousands of members. If this feature is requested together with FeatureCore
+ * (for instance through the ChannelFactory features), the members are only tracked as handles
+ * and identifiers instead, and groupContacts(), groupLocalPendingContacts() and
+ * groupRemotePendingContacts() stay empty. Contact objects can then be built on demand for the
+ * members of interest with groupContactsForHandles().
+ *
+ * The self, initiator and target contacts are built in either case.
+ *
+ * Requesting this feature after FeatureCore has started becoming ready does not change how the
+ * members are tracked.
+ *
+ * \sa groupMemberHandles(), groupMemberIdentifiers(), groupMemberHandlesChanged()
+ */
+const Feature Channel::FeatureGroupMemberHandles = Feature(QLatin1String(Channel::staticMetaObject.className()), 2, true);
+
 /**
  * Create a new Channel object.
  *
@@ -1682,11 +1831,11 @@ QString Channel::channelType() const
     // Similarly, we don't want warnings triggered when using the type interface
     // proxies internally.
     if (!isReady(Channel::FeatureCore) && mPriv->channelType.isEmpty()) {
-        warning() << "Channel::channelType() before the channel type has "
+        TP_QT_WARNING() << "Channel::channelType() before the channel type has "
             "been received";
     }
     else if (!isValid()) {
-        warning() << "Channel::channelType() used with channel closed";
+        TP_QT_WARNING() << "Channel::channelType() used with channel closed";
     }
 
     return mPriv->channelType;
@@ -1704,7 +1853,7 @@ QString Channel::channelType() const
 HandleType Channel::targetHandleType() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::targetHandleType() used channel not ready";
+        TP_QT_WARNING() << "Channel::targetHandleType() used channel not ready";
     }
 
     return (HandleType) mPriv->targetHandleType;
@@ -1723,7 +1872,7 @@ HandleType Channel::targetHandleType() const
 uint Channel::targetHandle() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::targetHandle() used channel not ready";
+        TP_QT_WARNING() << "Channel::targetHandle() used channel not ready";
     }
 
     return mPriv->targetHandle;
@@ -1748,7 +1897,7 @@ uint Channel::targetHandle() const
 QString Channel::targetId() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::targetId() used, but the channel is not ready";
+        TP_QT_WARNING() << "Channel::targetId() used, but the channel is not ready";
     }
 
     return mPriv->targetId;
@@ -1766,9 +1915,9 @@ QString Channel::targetId() const
 ContactPtr Channel::targetContact() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::targetContact() used, but the channel is not ready";
+        TP_QT_WARNING() << "Channel::targetContact() used, but the channel is not ready";
     } else if (targetHandleType() != HandleTypeContact) {
-        warning() << "Channel::targetContact() used with targetHandleType() != Contact";
+        TP_QT_WARNING() << "Channel::targetContact() used with targetHandleType() != Contact";
     }
 
     return mPriv->targetContact;
@@ -1786,7 +1935,7 @@ ContactPtr Channel::targetContact() const
 bool Channel::isRequested() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::isRequested() used channel not ready";
+        TP_QT_WARNING() << "Channel::isRequested() used channel not ready";
     }
 
     return mPriv->requested;
@@ -1803,7 +1952,7 @@ bool Channel::isRequested() const
 ContactPtr Channel::initiatorContact() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::initiatorContact() used channel not ready";
+        TP_QT_WARNING() << "Channel::initiatorContact() used channel not ready";
     }
 
     return mPriv->initiatorContact;
@@ -1860,7 +2009,7 @@ void Channel::PendingLeave::onChanInvalidated(Tp::DBusProxy *proxy)
         return;
     }
 
-    debug() << "Finishing PendingLeave successfully as the channel was invalidated";
+    TP_QT_DEBUG() << "Finishing PendingLeave successfully as the channel was invalidated";
 
     setFinished();
 }
@@ -1874,19 +2023,20 @@ void Channel::PendingLeave::onRemoveFinished(Tp::PendingOperation *op)
     ChannelPtr chan = ChannelPtr::staticCast(object());
 
     if (op->isValid()) {
-        debug() << "We left the channel" << chan->objectPath();
+        TP_QT_DEBUG() << "We left the channel" << chan->objectPath();
 
-        ContactPtr c = chan->groupSelfContact();
+        uint selfHandle = chan->mPriv->groupSelfHandle;
 
-        if (chan->groupContacts().contains(c)
-                || chan->groupLocalPendingContacts().contains(c)
-                || chan->groupRemotePendingContacts().contains(c)) {
-            debug() << "Waiting for self remove to be picked up";
+        if (chan->mPriv->groupMemberHandles.contains(selfHandle)
+                || chan->mPriv->groupLocalPendingMemberHandles.contains(selfHandle)
+                || chan->mPriv->groupRemotePendingMemberHandles.contains(selfHandle)) {
+            TP_QT_DEBUG() << "Waiting for self remove to be picked up";
             connect(chan.data(),
-                    SIGNAL(groupMembersChanged(Tp::Contacts,Tp::Contacts,Tp::Contacts,Tp::Contacts,
-                            Tp::Channel::GroupMemberChangeDetails)),
+                    SIGNAL(groupMemberHandlesChanged(Tp::UIntList,Tp::UIntList,Tp::UIntList,
+                            Tp::UIntList,QVariantMap)),
                     this,
-                    SLOT(onMembersChanged(Tp::Contacts,Tp::Contacts,Tp::Contacts,Tp::Contacts)));
+                    SLOT(onMemberHandlesChanged(Tp::UIntList,Tp::UIntList,Tp::UIntList,
+                            Tp::UIntList)));
         } else {
             setFinished();
         }
@@ -1894,7 +2044,7 @@ void Channel::PendingLeave::onRemoveFinished(Tp::PendingOperation *op)
         return;
     }
 
-    debug() << "Leave RemoveMembersWithReason failed with " << op->errorName() << op->errorMessage()
+    TP_QT_DEBUG() << "Leave RemoveMembersWithReason failed with " << op->errorName() << op->errorMessage()
         << "- falling back to Close";
 
     // If the channel has been closed or otherwise invalidated already in this mainloop iteration,
@@ -1905,18 +2055,17 @@ void Channel::PendingLeave::onRemoveFinished(Tp::PendingOperation *op)
             SLOT(onCloseFinished(Tp::PendingOperation*)));
 }
 
-void Channel::PendingLeave::onMembersChanged(const Tp::Contacts &, const Tp::Contacts &,
-        const Tp::Contacts &, const Tp::Contacts &removed)
+void Channel::PendingLeave::onMemberHandlesChanged(const Tp::UIntList &, const Tp::UIntList &,
+        const Tp::UIntList &, const Tp::UIntList &removed)
 {
     if (isFinished()) {
         return;
     }
 
     ChannelPtr chan = ChannelPtr::staticCast(object());
-    ContactPtr c = chan->groupSelfContact();
 
-    if (removed.contains(c)) {
-        debug() << "Leave event picked up for" << chan->objectPath();
+    if (removed.contains(chan->mPriv->groupSelfHandle)) {
+        TP_QT_DEBUG() << "Leave event picked up for" << chan->objectPath();
         setFinished();
     }
 }
@@ -1930,12 +2079,12 @@ void Channel::PendingLeave::onCloseFinished(Tp::PendingOperation *op)
     ChannelPtr chan = ChannelPtr::staticCast(object());
 
     if (op->isError()) {
-        warning() << "Closing the channel" << chan->objectPath()
+        TP_QT_WARNING() << "Closing the channel" << chan->objectPath()
             << "as a fallback for leaving it failed with"
             << op->errorName() << op->errorMessage() << "- so didn't leave";
         setFinishedWithError(op->errorName(), op->errorMessage());
     } else {
-        debug() << "We left (by closing) the channel" << chan->objectPath();
+        TP_QT_DEBUG() << "We left (by closing) the channel" << chan->objectPath();
         setFinished();
     }
 }
@@ -1981,11 +2130,12 @@ PendingOperation *Channel::requestLeave(const QString &message, ChannelGroupChan
         return requestClose();
     }
 
-    ContactPtr self = groupSelfContact();
+    uint selfHandle = mPriv->groupSelfHandle;
 
-    if (!groupContacts().contains(self) && !groupLocalPendingContacts().contains(self)
-            && !groupRemotePendingContacts().contains(self)) {
-        debug() << "Channel::requestLeave() called for " << objectPath() <<
+    if (!mPriv->groupMemberHandles.contains(selfHandle)
+            && !mPriv->groupLocalPendingMemberHandles.contains(selfHandle)
+            && !mPriv->groupRemotePendingMemberHandles.contains(selfHandle)) {
+        TP_QT_DEBUG() << "Channel::requestLeave() called for " << objectPath() <<
             "which we aren't a member of";
         return new PendingSuccess(ChannelPtr(this));
     }
@@ -2032,7 +2182,7 @@ PendingOperation *Channel::requestLeave(const QString &message, ChannelGroupChan
 ChannelGroupFlags Channel::groupFlags() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupFlags() used channel not ready";
+        TP_QT_WARNING() << "Channel::groupFlags() used channel not ready";
     }
 
     return (ChannelGroupFlags) mPriv->groupFlags;
@@ -2052,7 +2202,7 @@ ChannelGroupFlags Channel::groupFlags() const
 bool Channel::groupCanAddContacts() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupCanAddContacts() used channel not ready";
+        TP_QT_WARNING() << "Channel::groupCanAddContacts() used channel not ready";
     }
 
     return mPriv->groupFlags & ChannelGroupFlagCanAdd;
@@ -2070,7 +2220,7 @@ bool Channel::groupCanAddContacts() const
 bool Channel::groupCanAddContactsWithMessage() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupCanAddContactsWithMessage() used when channel not ready";
+        TP_QT_WARNING() << "Channel::groupCanAddContactsWithMessage() used when channel not ready";
     }
 
     return mPriv->groupFlags & ChannelGroupFlagMessageAdd;
@@ -2088,7 +2238,7 @@ bool Channel::groupCanAddContactsWithMessage() const
 bool Channel::groupCanAcceptContactsWithMessage() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupCanAcceptContactsWithMessage() used when channel not ready";
+        TP_QT_WARNING() << "Channel::groupCanAcceptContactsWithMessage() used when channel not ready";
     }
 
     return mPriv->groupFlags & ChannelGroupFlagMessageAccept;
@@ -2120,12 +2270,12 @@ PendingOperation *Channel::groupAddContacts(const QList<ContactPtr> &contacts,
         const QString &message)
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupAddContacts() used channel not ready";
+        TP_QT_WARNING() << "Channel::groupAddContacts() used channel not ready";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Channel not ready"),
                 ChannelPtr(this));
     } else if (contacts.isEmpty()) {
-        warning() << "Channel::groupAddContacts() used with empty contacts param";
+        TP_QT_WARNING() << "Channel::groupAddContacts() used with empty contacts param";
         return new PendingFailure(TP_QT_ERROR_INVALID_ARGUMENT,
                 QLatin1String("contacts cannot be an empty list"),
                 ChannelPtr(this));
@@ -2133,7 +2283,7 @@ PendingOperation *Channel::groupAddContacts(const QList<ContactPtr> &contacts,
 
     foreach (const ContactPtr &contact, contacts) {
         if (!contact) {
-            warning() << "Channel::groupAddContacts() used but contacts param contains "
+            TP_QT_WARNING() << "Channel::groupAddContacts() used but contacts param contains "
                 "invalid contact";
             return new PendingFailure(TP_QT_ERROR_INVALID_ARGUMENT,
                     QLatin1String("Unable to add invalid contacts"),
@@ -2142,7 +2292,7 @@ PendingOperation *Channel::groupAddContacts(const QList<ContactPtr> &contacts,
     }
 
     if (!interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_GROUP)) {
-        warning() << "Channel::groupAddContacts() used with no group interface";
+        TP_QT_WARNING() << "Channel::groupAddContacts() used with no group interface";
         return new PendingFailure(TP_QT_ERROR_NOT_IMPLEMENTED,
                 QLatin1String("Channel does not support group interface"),
                 ChannelPtr(this));
@@ -2169,7 +2319,7 @@ PendingOperation *Channel::groupAddContacts(const QList<ContactPtr> &contacts,
 bool Channel::groupCanRescindContacts() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupCanRescindContacts() used channel not ready";
+        TP_QT_WARNING() << "Channel::groupCanRescindContacts() used channel not ready";
     }
 
     return mPriv->groupFlags & ChannelGroupFlagCanRescind;
@@ -2188,7 +2338,7 @@ bool Channel::groupCanRescindContacts() const
 bool Channel::groupCanRescindContactsWithMessage() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupCanRescindContactsWithMessage() used when channel not ready";
+        TP_QT_WARNING() << "Channel::groupCanRescindContactsWithMessage() used when channel not ready";
     }
 
     return mPriv->groupFlags & ChannelGroupFlagMessageRescind;
@@ -2210,7 +2360,7 @@ bool Channel::groupCanRescindContactsWithMessage() const
 bool Channel::groupCanRemoveContacts() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupCanRemoveContacts() used channel not ready";
+        TP_QT_WARNING() << "Channel::groupCanRemoveContacts() used channel not ready";
     }
 
     return mPriv->groupFlags & ChannelGroupFlagCanRemove;
@@ -2228,7 +2378,7 @@ bool Channel::groupCanRemoveContacts() const
 bool Channel::groupCanRemoveContactsWithMessage() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupCanRemoveContactsWithMessage() used when channel not ready";
+        TP_QT_WARNING() << "Channel::groupCanRemoveContactsWithMessage() used when channel not ready";
     }
 
     return mPriv->groupFlags & ChannelGroupFlagMessageRemove;
@@ -2247,7 +2397,7 @@ bool Channel::groupCanRemoveContactsWithMessage() const
 bool Channel::groupCanRejectContactsWithMessage() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupCanRejectContactsWithMessage() used when channel not ready";
+        TP_QT_WARNING() << "Channel::groupCanRejectContactsWithMessage() used when channel not ready";
     }
 
     return mPriv->groupFlags & ChannelGroupFlagMessageReject;
@@ -2263,7 +2413,7 @@ bool Channel::groupCanRejectContactsWithMessage() const
 bool Channel::groupCanDepartWithMessage() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupCanDepartWithMessage() used when channel not ready";
+        TP_QT_WARNING() << "Channel::groupCanDepartWithMessage() used when channel not ready";
     }
 
     return mPriv->groupFlags & ChannelGroupFlagMessageDepart;
@@ -2314,14 +2464,14 @@ PendingOperation *Channel::groupRemoveContacts(const QList<ContactPtr> &contacts
         const QString &message, ChannelGroupChangeReason reason)
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupRemoveContacts() used channel not ready";
+        TP_QT_WARNING() << "Channel::groupRemoveContacts() used channel not ready";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Channel not ready"),
                 ChannelPtr(this));
     }
 
     if (contacts.isEmpty()) {
-        warning() << "Channel::groupRemoveContacts() used with empty contacts param";
+        TP_QT_WARNING() << "Channel::groupRemoveContacts() used with empty contacts param";
         return new PendingFailure(TP_QT_ERROR_INVALID_ARGUMENT,
                 QLatin1String("contacts param cannot be an empty list"),
                 ChannelPtr(this));
@@ -2329,7 +2479,7 @@ PendingOperation *Channel::groupRemoveContacts(const QList<ContactPtr> &contacts
 
     foreach (const ContactPtr &contact, contacts) {
         if (!contact) {
-            warning() << "Channel::groupRemoveContacts() used but contacts param contains "
+            TP_QT_WARNING() << "Channel::groupRemoveContacts() used but contacts param contains "
                 "invalid contact:";
             return new PendingFailure(TP_QT_ERROR_INVALID_ARGUMENT,
                     QLatin1String("Unable to remove invalid contacts"),
@@ -2338,7 +2488,7 @@ PendingOperation *Channel::groupRemoveContacts(const QList<ContactPtr> &contacts
     }
 
     if (!interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_GROUP)) {
-        warning() << "Channel::groupRemoveContacts() used with no group interface";
+        TP_QT_WARNING() << "Channel::groupRemoveContacts() used with no group interface";
         return new PendingFailure(TP_QT_ERROR_NOT_IMPLEMENTED,
                 QLatin1String("Channel does not support group interface"),
                 ChannelPtr(this));
@@ -2360,6 +2510,9 @@ PendingOperation *Channel::groupRemoveContacts(const QList<ContactPtr> &contacts
  * the contact is in the set, by passing \c false as the parameter \a
  * includeSelfContact.
  *
+ * This set is empty if the members are tracked as handles only, see
+ * FeatureGroupMemberHandles.
+ *
  * Change notification is via the groupMembersChanged() signal.
  *
  * This method requires Channel::FeatureCore to be ready.
@@ -2371,7 +2524,7 @@ PendingOperation *Channel::groupRemoveContacts(const QList<ContactPtr> &contacts
 Contacts Channel::groupContacts(bool includeSelfContact) const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupMembers() used channel not ready";
+        TP_QT_WARNING() << "Channel::groupMembers() used channel not ready";
     }
 
     Contacts ret = mPriv->groupContacts.values().toSet();
@@ -2389,6 +2542,9 @@ Contacts Channel::groupContacts(bool includeSelfContact) const
  * the contact is in the set, by passing \c false as the parameter \a
  * includeSelfContact.
  *
+ * This set is empty if the members are tracked as handles only, see
+ * FeatureGroupMemberHandles.
+ *
  * Change notification is via the groupMembersChanged() signal.
  *
  * This method requires Channel::FeatureCore to be ready.
@@ -2400,9 +2556,9 @@ Contacts Channel::groupContacts(bool includeSelfContact) const
 Contacts Channel::groupLocalPendingContacts(bool includeSelfContact) const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupLocalPendingContacts() used channel not ready";
+        TP_QT_WARNING() << "Channel::groupLocalPendingContacts() used channel not ready";
     } else if (!interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_GROUP)) {
-        warning() << "Channel::groupLocalPendingContacts() used with no group interface";
+        TP_QT_WARNING() << "Channel::groupLocalPendingContacts() used with no group interface";
     }
 
     Contacts ret = mPriv->groupLocalPendingContacts.values().toSet();
@@ -2420,6 +2576,9 @@ Contacts Channel::groupLocalPendingContacts(bool includeSelfContact) const
  * the contact is in the set, by passing \c false as the parameter \a
  * includeSelfContact.
  *
+ * This set is empty if the members are tracked as handles only, see
+ * FeatureGroupMemberHandles.
+ *
  * Change notification is via the groupMembersChanged() signal.
  *
  * This method requires Channel::FeatureCore to be ready.
@@ -2431,9 +2590,9 @@ Contacts Channel::groupLocalPendingContacts(bool includeSelfContact) const
 Contacts Channel::groupRemotePendingContacts(bool includeSelfContact) const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupRemotePendingContacts() used channel not ready";
+        TP_QT_WARNING() << "Channel::groupRemotePendingContacts() used channel not ready";
     } else if (!interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_GROUP)) {
-        warning() << "Channel::groupRemotePendingContacts() used with no "
+        TP_QT_WARNING() << "Channel::groupRemotePendingContacts() used with no "
             "group interface";
     }
 
@@ -2444,6 +2603,127 @@ Contacts Channel::groupRemotePendingContacts(bool includeSelfContact) const
     return ret;
 }
 
+/**
+ * Return the handles of the current members of the group.
+ *
+ * Unlike groupContacts(), this is also available when the members are tracked
+ * as handles only, see FeatureGroupMemberHandles.
+ *
+ * Change notification is via the groupMemberHandlesChanged() signal.
+ *
+ * This method requires Channel::FeatureCore to be ready.
+ *
+ * \return The member handles.
+ * \sa groupLocalPendingMemberHandles(), groupRemotePendingMemberHandles()
+ */
+UIntList Channel::groupMemberHandles() const
+{
+    if (!isReady(Channel::FeatureCore)) {
+        TP_QT_WARNING() << "Channel::groupMemberHandles() used channel not ready";
+    }
+
+    return mPriv->groupMemberHandles.toList();
+}
+
+/**
+ * Return the handles of the contacts currently waiting for local approval to
+ * join the group.
+ *
+ * Change notification is via the groupMemberHandlesChanged() signal.
+ *
+ * This method requires Channel::FeatureCore to be ready.
+ *
+ * \return The local pending member handles.
+ * \sa groupMemberHandles(), groupRemotePendingMemberHandles()
+ */
+UIntList Channel::groupLocalPendingMemberHandles() const
+{
+    if (!isReady(Channel::FeatureCore)) {
+        TP_QT_WARNING() << "Channel::groupLocalPendingMemberHandles() used channel not ready";
+    } else if (!interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_GROUP)) {
+        TP_QT_WARNING() << "Channel::groupLocalPendingMemberHandles() used with no group interface";
+    }
+
+    return mPriv->groupLocalPendingMemberHandles.toList();
+}
+
+/**
+ * Return the handles of the contacts currently waiting for remote approval to
+ * join the group.
+ *
+ * Change notification is via the groupMemberHandlesChanged() signal.
+ *
+ * This method requires Channel::FeatureCore to be ready.
+ *
+ * \return The remote pending member handles.
+ * \sa groupMemberHandles(), groupLocalPendingMemberHandles()
+ */
+UIntList Channel::groupRemotePendingMemberHandles() const
+{
+    if (!isReady(Channel::FeatureCore)) {
+        TP_QT_WARNING() << "Channel::groupRemotePendingMemberHandles() used channel not ready";
+    } else if (!interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_GROUP)) {
+        TP_QT_WARNING() << "Channel::groupRemotePendingMemberHandles() used with no "
+            "group interface";
+    }
+
+    return mPriv->groupRemotePendingMemberHandles.toList();
+}
+
+/**
+ * Return the identifiers of the members, local pending members and remote
+ * pending members of the group, as far as the service has announced them.
+ *
+ * Handles for which the service did not provide an identifier are omitted.
+ *
+ * This method requires Channel::FeatureCore to be ready.
+ *
+ * \return A map from handles to identifiers.
+ * \sa groupMemberHandles()
+ */
+HandleIdentifierMap Channel::groupMemberIdentifiers() const
+{
+    if (!isReady(Channel::FeatureCore)) {
+        TP_QT_WARNING() << "Channel::groupMemberIdentifiers() used channel not ready";
+    }
+
+    return mPriv->groupMemberIds;
+}
+
+/**
+ * Build Contact objects for a subset of the group members.
+ *
+ * This is meant to be used together with FeatureGroupMemberHandles, to build
+ * contacts only for the members the application is actually going to show.
+ * The identifiers already announced by the service are reused, so no handle
+ * inspection is needed for them.
+ *
+ * This method requires Channel::FeatureCore to be ready.
+ *
+ * \param handles The handles of the members to build contacts for.
+ * \param features The Contact features to enable on the contacts, in addition to the ones
+ *                 set on the contact factory.
+ * \return A PendingContacts object which will emit PendingContacts::finished
+ *         when the contacts have been built.
+ */
+PendingContacts *Channel::groupContactsForHandles(const UIntList &handles,
+        const Features &features) const
+{
+    if (!isReady(Channel::FeatureCore)) {
+        TP_QT_WARNING() << "Channel::groupContactsForHandles() used channel not ready";
+    }
+
+    HandleIdentifierMap ids;
+    foreach (uint handle, handles) {
+        if (mPriv->groupMemberIds.contains(handle)) {
+            ids.insert(handle, mPriv->groupMemberIds.value(handle));
+        }
+    }
+
+    mPriv->connection->lowlevel()->injectContactIds(ids);
+    return mPriv->connection->contactManager()->contactsForHandles(handles, features);
+}
+
 /**
  * Return information of a local pending contact change. If
  * no information is available, an object for which
@@ -2458,11 +2738,11 @@ Channel::GroupMemberChangeDetails Channel::groupLocalPendingContactChangeInfo(
         const ContactPtr &contact) const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupLocalPendingContactChangeInfo() used channel not ready";
+        TP_QT_WARNING() << "Channel::groupLocalPendingContactChangeInfo() used channel not ready";
     } else if (!interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_GROUP)) {
-        warning() << "Channel::groupLocalPendingContactChangeInfo() used with no group interface";
+        TP_QT_WARNING() << "Channel::groupLocalPendingContactChangeInfo() used with no group interface";
     } else if (!contact) {
-        warning() << "Channel::groupLocalPendingContactChangeInfo() used with null contact param";
+        TP_QT_WARNING() << "Channel::groupLocalPendingContactChangeInfo() used with null contact param";
         return GroupMemberChangeDetails();
     }
 
@@ -2493,9 +2773,9 @@ Channel::GroupMemberChangeDetails Channel::groupSelfContactRemoveInfo() const
     // Oftentimes, the channel will be closed as a result from being left - so checking a channel's
     // self remove info when it has been closed and hence invalidated is valid
     if (isValid() && !isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupSelfContactRemoveInfo() used before Channel::FeatureCore is ready";
+        TP_QT_WARNING() << "Channel::groupSelfContactRemoveInfo() used before Channel::FeatureCore is ready";
     } else if (!interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_GROUP)) {
-        warning() << "Channel::groupSelfContactRemoveInfo() used with "
+        TP_QT_WARNING() << "Channel::groupSelfContactRemoveInfo() used with "
             "no group interface";
     }
 
@@ -2528,9 +2808,9 @@ Channel::GroupMemberChangeDetails Channel::groupSelfContactRemoveInfo() const
 bool Channel::groupAreHandleOwnersAvailable() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupAreHandleOwnersAvailable() used channel not ready";
+        TP_QT_WARNING() << "Channel::groupAreHandleOwnersAvailable() used channel not ready";
     } else if (!interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_GROUP)) {
-        warning() << "Channel::groupAreHandleOwnersAvailable() used with "
+        TP_QT_WARNING() << "Channel::groupAreHandleOwnersAvailable() used with "
             "no group interface";
     }
 
@@ -2556,13 +2836,13 @@ bool Channel::groupAreHandleOwnersAvailable() const
 HandleOwnerMap Channel::groupHandleOwners() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupHandleOwners() used channel not ready";
+        TP_QT_WARNING() << "Channel::groupHandleOwners() used channel not ready";
     } else if (!interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_GROUP)) {
-        warning() << "Channel::groupAreHandleOwnersAvailable() used with no "
+        TP_QT_WARNING() << "Channel::groupAreHandleOwnersAvailable() used with no "
             "group interface";
     }
     else if (!groupAreHandleOwnersAvailable()) {
-        warning() << "Channel::groupAreHandleOwnersAvailable() used, but handle "
+        TP_QT_WARNING() << "Channel::groupAreHandleOwnersAvailable() used, but handle "
             "owners not available";
     }
 
@@ -2586,9 +2866,9 @@ HandleOwnerMap Channel::groupHandleOwners() const
 bool Channel::groupIsSelfContactTracked() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupIsSelfHandleTracked() used channel not ready";
+        TP_QT_WARNING() << "Channel::groupIsSelfHandleTracked() used channel not ready";
     } else if (!interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_GROUP)) {
-        warning() << "Channel::groupIsSelfHandleTracked() used with "
+        TP_QT_WARNING() << "Channel::groupIsSelfHandleTracked() used with "
             "no group interface";
     }
 
@@ -2608,7 +2888,7 @@ bool Channel::groupIsSelfContactTracked() const
 ContactPtr Channel::groupSelfContact() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupSelfContact() used channel not ready";
+        TP_QT_WARNING() << "Channel::groupSelfContact() used channel not ready";
     }
 
     return mPriv->groupSelfContact;
@@ -2626,12 +2906,12 @@ ContactPtr Channel::groupSelfContact() const
 bool Channel::groupSelfHandleIsLocalPending() const
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupSelfHandleIsLocalPending() used when "
+        TP_QT_WARNING() << "Channel::groupSelfHandleIsLocalPending() used when "
             "channel not ready";
         return false;
     }
 
-    return mPriv->groupLocalPendingContacts.contains(mPriv->groupSelfHandle);
+    return mPriv->groupLocalPendingMemberHandles.contains(mPriv->groupSelfHandle);
 }
 
 /**
@@ -2647,7 +2927,7 @@ bool Channel::groupSelfHandleIsLocalPending() const
 PendingOperation *Channel::groupAddSelfHandle()
 {
     if (!isReady(Channel::FeatureCore)) {
-        warning() << "Channel::groupAddSelfHandle() used when channel not "
+        TP_QT_WARNING() << "Channel::groupAddSelfHandle() used when channel not "
             "ready";
         return new PendingFailure(TP_QT_ERROR_INVALID_ARGUMENT,
                 QLatin1String("Channel object not ready"),
@@ -2865,10 +3145,10 @@ void Channel::gotMainProperties(QDBusPendingCallWatcher *watcher)
     QVariantMap props;
 
     if (!reply.isError()) {
-        debug() << "Got reply to Properties::GetAll(Channel)";
+        TP_QT_DEBUG() << "Got reply to Properties::GetAll(Channel)";
         props = reply.value();
     } else {
-        warning().nospace() << "Properties::GetAll(Channel) failed with " <<
+        TP_QT_WARNING().nospace() << "Properties::GetAll(Channel) failed with " <<
             reply.error().name() << ": " << reply.error().message();
     }
 
@@ -2882,14 +3162,14 @@ void Channel::gotChannelType(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<QString> reply = *watcher;
 
     if (reply.isError()) {
-        warning().nospace() << "Channel::GetChannelType() failed with " <<
+        TP_QT_WARNING().nospace() << "Channel::GetChannelType() failed with " <<
             reply.error().name() << ": " << reply.error().message() <<
             ", Channel officially dead";
         invalidate(reply.error());
         return;
     }
 
-    debug() << "Got reply to fallback Channel::GetChannelType()";
+    TP_QT_DEBUG() << "Got reply to fallback Channel::GetChannelType()";
     mPriv->channelType = reply.value();
     mPriv->continueIntrospection();
 }
@@ -2899,14 +3179,14 @@ void Channel::gotHandle(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<uint, uint> reply = *watcher;
 
     if (reply.isError()) {
-        warning().nospace() << "Channel::GetHandle() failed with " <<
+        TP_QT_WARNING().nospace() << "Channel::GetHandle() failed with " <<
             reply.error().name() << ": " << reply.error().message() <<
             ", Channel officially dead";
         invalidate(reply.error());
         return;
     }
 
-    debug() << "Got reply to fallback Channel::GetHandle()";
+    TP_QT_DEBUG() << "Got reply to fallback Channel::GetHandle()";
     mPriv->targetHandleType = reply.argumentAt<0>();
     mPriv->targetHandle = reply.argumentAt<1>();
     mPriv->continueIntrospection();
@@ -2917,14 +3197,14 @@ void Channel::gotInterfaces(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<QStringList> reply = *watcher;
 
     if (reply.isError()) {
-        warning().nospace() << "Channel::GetInterfaces() failed with " <<
+        TP_QT_WARNING().nospace() << "Channel::GetInterfaces() failed with " <<
             reply.error().name() << ": " << reply.error().message() <<
             ", Channel officially dead";
         invalidate(reply.error());
         return;
     }
 
-    debug() << "Got reply to fallback Channel::GetInterfaces()";
+    TP_QT_DEBUG() << "Got reply to fallback Channel::GetInterfaces()";
     setInterfaces(reply.value());
     mPriv->readinessHelper->setInterfaces(interfaces());
     mPriv->nowHaveInterfaces();
@@ -2936,7 +3216,7 @@ void Channel::gotInterfaces(QDBusPendingCallWatcher *watcher)
 
 void Channel::onClosed()
 {
-    debug() << "Got Channel::Closed";
+    TP_QT_DEBUG() << "Got Channel::Closed";
 
     QString error;
     QString message;
@@ -2980,7 +3260,7 @@ void Channel::onConnectionReady(PendingOperation *op)
 
 void Channel::onConnectionInvalidated()
 {
-    debug() << "Owning connection died leaving an orphan Channel, "
+    TP_QT_DEBUG() << "Owning connection died leaving an orphan Channel, "
         "changing to closed";
     invalidate(TP_QT_ERROR_ORPHANED,
                QLatin1String("Connection given as the owner of this channel was invalidated"));
@@ -2992,11 +3272,11 @@ void Channel::gotGroupProperties(QDBusPendingCallWatcher *watcher)
     QVariantMap props;
 
     if (!reply.isError()) {
-        debug() << "Got reply to Properties::GetAll(Channel.Interface.Group)";
+        TP_QT_DEBUG() << "Got reply to Properties::GetAll(Channel.Interface.Group)";
         props = reply.value();
     }
     else {
-        warning().nospace() << "Properties::GetAll(Channel.Interface.Group) "
+        TP_QT_WARNING().nospace() << "Properties::GetAll(Channel.Interface.Group) "
             "failed with " << reply.error().name() << ": " <<
             reply.error().message();
     }
@@ -3012,15 +3292,15 @@ void Channel::gotGroupFlags(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<uint> reply = *watcher;
 
     if (reply.isError()) {
-        warning().nospace() << "Channel.Interface.Group::GetGroupFlags() failed with " <<
+        TP_QT_WARNING().nospace() << "Channel.Interface.Group::GetGroupFlags() failed with " <<
             reply.error().name() << ": " << reply.error().message();
     }
     else {
-        debug() << "Got reply to fallback Channel.Interface.Group::GetGroupFlags()";
+        TP_QT_DEBUG() << "Got reply to fallback Channel.Interface.Group::GetGroupFlags()";
         mPriv->setGroupFlags(reply.value());
 
         if (mPriv->groupFlags & ChannelGroupFlagProperties) {
-            warning() << " Reply included ChannelGroupFlagProperties, even "
+            TP_QT_WARNING() << " Reply included ChannelGroupFlagProperties, even "
                 "though properties specified in 0.17.7 didn't work! - unsetting";
             mPriv->groupFlags &= ~ChannelGroupFlagProperties;
         }
@@ -3034,10 +3314,10 @@ void Channel::gotAllMembers(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<UIntList, UIntList, UIntList> reply = *watcher;
 
     if (reply.isError()) {
-        warning().nospace() << "Channel.Interface.Group::GetAllMembers() failed with " <<
+        TP_QT_WARNING().nospace() << "Channel.Interface.Group::GetAllMembers() failed with " <<
             reply.error().name() << ": " << reply.error().message();
     } else {
-        debug() << "Got reply to fallback Channel.Interface.Group::GetAllMembers()";
+        TP_QT_DEBUG() << "Got reply to fallback Channel.Interface.Group::GetAllMembers()";
 
         mPriv->groupInitialMembers = reply.argumentAt<0>();
         mPriv->groupInitialRP = reply.argumentAt<2>();
@@ -3057,12 +3337,12 @@ void Channel::gotLocalPendingMembersWithInfo(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<LocalPendingInfoList> reply = *watcher;
 
     if (reply.isError()) {
-        warning().nospace() << "Channel.Interface.Group::GetLocalPendingMembersWithInfo() "
+        TP_QT_WARNING().nospace() << "Channel.Interface.Group::GetLocalPendingMembersWithInfo() "
             "failed with " << reply.error().name() << ": " << reply.error().message();
-        warning() << " Falling back to what GetAllMembers returned with no extended info";
+        TP_QT_WARNING() << " Falling back to what GetAllMembers returned with no extended info";
     }
     else {
-        debug() << "Got reply to fallback "
+        TP_QT_DEBUG() << "Got reply to fallback "
             "Channel.Interface.Group::GetLocalPendingMembersWithInfo()";
         // Overrides the previous vague list provided by gotAllMembers
         mPriv->groupInitialLP = reply.value();
@@ -3076,10 +3356,10 @@ void Channel::gotSelfHandle(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<uint> reply = *watcher;
 
     if (reply.isError()) {
-        warning().nospace() << "Channel.Interface.Group::GetSelfHandle() failed with " <<
+        TP_QT_WARNING().nospace() << "Channel.Interface.Group::GetSelfHandle() failed with " <<
             reply.error().name() << ": " << reply.error().message();
     } else {
-        debug() << "Got reply to fallback Channel.Interface.Group::GetSelfHandle()";
+        TP_QT_DEBUG() << "Got reply to fallback Channel.Interface.Group::GetSelfHandle()";
         // Don't overwrite the self handle we got from the connection with 0
         if (reply.value()) {
             mPriv->groupSelfHandle = reply.value();
@@ -3102,18 +3382,18 @@ void Channel::gotContacts(PendingOperation *op)
         contacts = pending->contacts();
 
         if (!pending->invalidHandles().isEmpty()) {
-            warning() << "Unable to construct Contact objects for handles:" <<
+            TP_QT_WARNING() << "Unable to construct Contact objects for handles:" <<
                 pending->invalidHandles();
 
             if (mPriv->groupSelfHandle &&
                 pending->invalidHandles().contains(mPriv->groupSelfHandle)) {
-                warning() << "Unable to retrieve self contact";
+                TP_QT_WARNING() << "Unable to retrieve self contact";
                 mPriv->groupSelfContact.reset();
                 emit groupSelfContactChanged();
             }
         }
     } else {
-        warning().nospace() << "Getting contacts failed with " <<
+        TP_QT_WARNING().nospace() << "Getting contacts failed with " <<
             pending->errorName() << ":" << pending->errorMessage();
     }
 
@@ -3122,13 +3402,13 @@ void Channel::gotContacts(PendingOperation *op)
 
 void Channel::onGroupFlagsChanged(uint added, uint removed)
 {
-    debug().nospace() << "Got Channel.Interface.Group::GroupFlagsChanged(" <<
+    TP_QT_DEBUG().nospace() << "Got Channel.Interface.Group::GroupFlagsChanged(" <<
         hex << added << ", " << removed << ")";
 
     added &= ~(mPriv->groupFlags);
     removed &= mPriv->groupFlags;
 
-    debug().nospace() << "Arguments after filtering (" << hex << added <<
+    TP_QT_DEBUG().nospace() << "Arguments after filtering (" << hex << added <<
         ", " << removed << ")";
 
     uint groupFlags = mPriv->groupFlags;
@@ -3137,26 +3417,26 @@ void Channel::onGroupFlagsChanged(uint added, uint removed)
     // just emit groupFlagsChanged and related signals if the flags really
     // changed and we are ready
     if (mPriv->setGroupFlags(groupFlags) && isReady(Channel::FeatureCore)) {
-        debug() << "Emitting groupFlagsChanged with" << mPriv->groupFlags <<
+        TP_QT_DEBUG() << "Emitting groupFlagsChanged with" << mPriv->groupFlags <<
             "value" << added << "added" << removed << "removed";
         emit groupFlagsChanged((ChannelGroupFlags) mPriv->groupFlags,
                 (ChannelGroupFlags) added, (ChannelGroupFlags) removed);
 
         if (added & ChannelGroupFlagCanAdd ||
             removed & ChannelGroupFlagCanAdd) {
-            debug() << "Emitting groupCanAddContactsChanged";
+            TP_QT_DEBUG() << "Emitting groupCanAddContactsChanged";
             emit groupCanAddContactsChanged(groupCanAddContacts());
         }
 
         if (added & ChannelGroupFlagCanRemove ||
             removed & ChannelGroupFlagCanRemove) {
-            debug() << "Emitting groupCanRemoveContactsChanged";
+            TP_QT_DEBUG() << "Emitting groupCanRemoveContactsChanged";
             emit groupCanRemoveContactsChanged(groupCanRemoveContacts());
         }
 
         if (added & ChannelGroupFlagCanRescind ||
             removed & ChannelGroupFlagCanRescind) {
-            debug() << "Emitting groupCanRescindContactsChanged";
+            TP_QT_DEBUG() << "Emitting groupCanRescindContactsChanged";
             emit groupCanRescindContactsChanged(groupCanRescindContacts());
         }
     }
@@ -3172,11 +3452,11 @@ void Channel::onMembersChanged(const QString &message,
         return;
     }
 
-    debug() << "Got Channel.Interface.Group::MembersChanged with" << added.size() <<
+    TP_QT_DEBUG() << "Got Channel.Interface.Group::MembersChanged with" << added.size() <<
         "added," << removed.size() << "removed," << localPending.size() <<
         "moved to LP," << remotePending.size() << "moved to RP," << actor <<
         "being the actor," << reason << "the reason and" << message << "the message";
-    debug() << " synthesizing a corresponding MembersChangedDetailed signal";
+    TP_QT_DEBUG() << " synthesizing a corresponding MembersChangedDetailed signal";
 
     QVariantMap details;
 
@@ -3203,7 +3483,7 @@ void Channel::onMembersChangedDetailed(
         return;
     }
 
-    debug() << "Got Channel.Interface.Group::MembersChangedDetailed with" << added.size() <<
+    TP_QT_DEBUG() << "Got Channel.Interface.Group::MembersChangedDetailed with" << added.size() <<
         "added," << removed.size() << "removed," << localPending.size() <<
         "moved to LP," << remotePending.size() << "moved to RP and with" << details.size() <<
         "details";
@@ -3217,14 +3497,14 @@ void Channel::Private::doMembersChangedDetailed(
         const QVariantMap &details)
 {
     if (!groupHaveMembers) {
-        debug() << "Still waiting for initial group members, "
+        TP_QT_DEBUG() << "Still waiting for initial group members, "
             "so ignoring delta signal...";
         return;
     }
 
     if (added.isEmpty() && removed.isEmpty() &&
         localPending.isEmpty() && remotePending.isEmpty()) {
-        debug() << "Nothing really changed, so skipping membersChanged";
+        TP_QT_DEBUG() << "Nothing really changed, so skipping membersChanged";
         return;
     }
 
@@ -3237,7 +3517,7 @@ void Channel::Private::doMembersChangedDetailed(
             if (removed.size() != 1 ||
                 (added.size() + localPending.size() + remotePending.size()) != 1) {
                 // spec-incompliant CM, ignoring members changed
-                warning() << "Received MembersChangedDetailed with reason "
+                TP_QT_WARNING() << "Received MembersChangedDetailed with reason "
                     "Renamed and removed.size != 1 or added.size + "
                     "localPending.size + remotePending.size != 1. Ignoring";
                 return;
@@ -3281,11 +3561,11 @@ void Channel::Private::doMembersChangedDetailed(
 void Channel::onHandleOwnersChanged(const HandleOwnerMap &added,
         const UIntList &removed)
 {
-    debug() << "Got Channel.Interface.Group::HandleOwnersChanged with" <<
+    TP_QT_DEBUG() << "Got Channel.Interface.Group::HandleOwnersChanged with" <<
         added.size() << "added," << removed.size() << "removed";
 
     if (!mPriv->groupAreHandleOwnersAvailable) {
-        debug() << "Still waiting for initial handle owners, so ignoring "
+        TP_QT_DEBUG() << "Still waiting for initial handle owners, so ignoring "
             "delta signal...";
         return;
     }
@@ -3301,7 +3581,7 @@ void Channel::onHandleOwnersChanged(const HandleOwnerMap &added,
 
         if (!mPriv->groupHandleOwners.contains(handle)
                 || mPriv->groupHandleOwners[handle] != global) {
-            debug() << " +++/changed" << handle << "->" << global;
+            TP_QT_DEBUG() << " +++/changed" << handle << "->" << global;
             mPriv->groupHandleOwners[handle] = global;
             emitAdded.append(handle);
         }
@@ -3309,7 +3589,7 @@ void Channel::onHandleOwnersChanged(const HandleOwnerMap &added,
 
     foreach (uint handle, removed) {
         if (mPriv->groupHandleOwners.contains(handle)) {
-            debug() << " ---" << handle;
+            TP_QT_DEBUG() << " ---" << handle;
             mPriv->groupHandleOwners.remove(handle);
             emitRemoved.append(handle);
         }
@@ -3318,7 +3598,7 @@ void Channel::onHandleOwnersChanged(const HandleOwnerMap &added,
     // just emit groupHandleOwnersChanged if it really changed and
     // we are ready
     if ((emitAdded.size() || emitRemoved.size()) && isReady(Channel::FeatureCore)) {
-        debug() << "Emitting groupHandleOwnersChanged with" << emitAdded.size() <<
+        TP_QT_DEBUG() << "Emitting groupHandleOwnersChanged with" << emitAdded.size() <<
             "added" << emitRemoved.size() << "removed";
         emit groupHandleOwnersChanged(mPriv->groupHandleOwners,
                 emitAdded, emitRemoved);
@@ -3327,11 +3607,11 @@ void Channel::onHandleOwnersChanged(const HandleOwnerMap &added,
 
 void Channel::onSelfHandleChanged(uint selfHandle)
 {
-    debug().nospace() << "Got Channel.Interface.Group::SelfHandleChanged";
+    TP_QT_DEBUG().nospace() << "Got Channel.Interface.Group::SelfHandleChanged";
 
     if (selfHandle != mPriv->groupSelfHandle) {
         mPriv->groupSelfHandle = selfHandle;
-        debug() << " Emitting groupSelfHandleChanged with new self handle" <<
+        TP_QT_DEBUG() << " Emitting groupSelfHandleChanged with new self handle" <<
             selfHandle;
 
         // FIXME: fix self contact building with no group
@@ -3347,7 +3627,7 @@ void Channel::gotConferenceProperties(QDBusPendingCallWatcher *watcher)
     mPriv->introspectingConference = false;
 
     if (!reply.isError()) {
-        debug() << "Got reply to Properties::GetAll(Channel.Interface.Conference)";
+        TP_QT_DEBUG() << "Got reply to Properties::GetAll(Channel.Interface.Conference)";
         props = reply.value();
 
         ConnectionPtr conn = connection();
@@ -3411,7 +3691,7 @@ void Channel::gotConferenceProperties(QDBusPendingCallWatcher *watcher)
             mPriv->conferenceOriginalChannels.insert(i.key(), channel);
         }
     } else {
-        warning().nospace() << "Properties::GetAll(Channel.Interface.Conference) "
+        TP_QT_WARNING().nospace() << "Properties::GetAll(Channel.Interface.Conference) "
             "failed with " << reply.error().name() << ": " <<
             reply.error().message();
     }
@@ -3426,7 +3706,7 @@ void Channel::gotConferenceInitialInviteeContacts(PendingOperation *op)
     if (pending->isValid()) {
         mPriv->conferenceInitialInviteeContacts = pending->contacts().toSet();
     } else {
-        warning().nospace() << "Getting conference initial invitee contacts "
+        TP_QT_WARNING().nospace() << "Getting conference initial invitee contacts "
             "failed with " << pending->errorName() << ":" <<
             pending->errorMessage();
     }
@@ -3494,7 +3774,7 @@ void Channel::gotConferenceChannelRemovedActorContact(PendingOperation *op)
             Q_ASSERT(pc->contacts().size() == 1);
             actorContact = pc->contacts().first();
         } else {
-            warning().nospace() << "Getting conference channel removed actor "
+            TP_QT_WARNING().nospace() << "Getting conference channel removed actor "
                 "failed with " << pc->errorName() << ":" <<
                 pc->errorMessage();
         }
@@ -3580,6 +3860,30 @@ void Channel::gotConferenceChannelRemovedActorContact(PendingOperation *op)
  *                the change.
  */
 
+/**
+ * \fn void Channel::groupMemberHandlesChanged(
+ *     const Tp::UIntList &groupMembersAdded,
+ *     const Tp::UIntList &groupLocalPendingMembersAdded,
+ *     const Tp::UIntList &groupRemotePendingMembersAdded,
+ *     const Tp::UIntList &groupMembersRemoved,
+ *     const QVariantMap &details)
+ *
+ * Emitted when the value returned by groupMemberHandles(), groupLocalPendingMemberHandles() or
+ * groupRemotePendingMemberHandles() changes.
+ *
+ * This is emitted whether or not FeatureGroupMemberHandles is enabled, before the
+ * corresponding groupMembersChanged() signal, if any.
+ *
+ * \param groupMembersAdded The handles of the members that were added to this channel.
+ * \param groupLocalPendingMembersAdded The handles of the local pending members that were
+ *                                      added to this channel.
+ * \param groupRemotePendingMembersAdded The handles of the remote pending members that were
+ *                                       added to this channel.
+ * \param groupMembersRemoved The handles of the members removed from this channel.
+ * \param details The details of the change, as given by the MembersChangedDetailed D-Bus
+ *                signal.
+ */
+
 /**
  * \fn void Channel::groupHandleOwnersChanged(const HandleOwnerMap &owners,
  *            const Tp::UIntList &added, const Tp::UIntList &removed)
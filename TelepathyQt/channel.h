@@ -45,6 +45,7 @@ namespace Tp
 {
 
 class Connection;
+class PendingContacts;
 class PendingOperation;
 class PendingReady;
 
@@ -57,6 +58,7 @@ class TP_QT_EXPORT Channel : public StatefulDBusProxy,
 public:
     static const Feature FeatureCore;
     static const Feature FeatureConferenceInitialInviteeContacts;
+    static const Feature FeatureGroupMemberHandles;
 
     static ChannelPtr create(const ConnectionPtr &connection,
             const QString &objectPath, const QVariantMap &immutableProperties);
@@ -102,6 +104,13 @@ public:
     Contacts groupLocalPendingContacts(bool includeSelfContact = true) const;
     Contacts groupRemotePendingContacts(bool includeSelfContact = true) const;
 
+    UIntList groupMemberHandles() const;
+    UIntList groupLocalPendingMemberHandles() const;
+    UIntList groupRemotePendingMemberHandles() const;
+    HandleIdentifierMap groupMemberIdentifiers() const;
+    PendingContacts *groupContactsForHandles(const UIntList &handles,
+            const Features &features = Features()) const;
+
     class GroupMemberChangeDetails
     {
     public:
@@ -178,6 +187,13 @@ Q_SIGNALS:
             const Tp::Contacts &groupMembersRemoved,
             const Tp::Channel::GroupMemberChangeDetails &details);
 
+    void groupMemberHandlesChanged(
+            const Tp::UIntList &groupMembersAdded,
+            const Tp::UIntList &groupLocalPendingMembersAdded,
+            const Tp::UIntList &groupRemotePendingMembersAdded,
+            const Tp::UIntList &groupMembersRemoved,
+            const QVariantMap &details);
+
     void groupHandleOwnersChanged(const Tp::HandleOwnerMap &owners,
             const Tp::UIntList &added, const Tp::UIntList &removed);
 
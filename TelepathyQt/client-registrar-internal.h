@@ -23,6 +23,8 @@
 #ifndef _TelepathyQt_client_registrar_internal_h_HEADER_GUARD_
 #define _TelepathyQt_client_registrar_internal_h_HEADER_GUARD_
 
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
 #include <QtCore/QObject>
 #include <QtDBus/QtDBus>
 
@@ -125,15 +127,25 @@ public Q_SLOTS: // Methods
 
 private Q_SLOTS:
     void onReadyOpFinished(Tp::PendingOperation *);
+    void onCoreReadyOpFinished(Tp::PendingOperation *);
+    void onReadinessTimeout();
+    void onCachedProxyInvalidated(Tp::DBusProxy *);
 
 private:
     struct InvocationData : RefCounted
     {
-        InvocationData() : readyOp(nullptr) {}
+        InvocationData() : readyOp(nullptr), readinessTimeout(-1), timedOut(false) {}
 
         PendingOperation *readyOp;
         QString error, message;
 
+        // Only used when the observer has a readiness timeout
+        int readinessTimeout;
+        QElapsedTimer elapsed;
+        bool timedOut;
+        Features accFeatures, connFeatures;
+        QList<Features> chanFeatures;
+
         MethodInvocationContextPtr<> ctx;
         AccountPtr acc;
         ConnectionPtr conn;
@@ -142,8 +154,23 @@ private:
         QList<ChannelRequestPtr> chanReqs;
         AbstractClientObserver::ObserverInfo observerInfo;
     };
+
+    bool isCoreReady(const SharedPtr<InvocationData> &invocation) const;
+    void cacheCoreProxies(const AccountPtr &acc, const ConnectionPtr &conn);
+    void invokeReadyObservers();
+
     QLinkedList<SharedPtr<InvocationData> > mInvocations;
 
+    // The proxies kept for the readiness timeout, by connection object path. An entry goes away
+    // as soon as its account or connection is invalidated, so there is at most one per live
+    // connection.
+    struct CachedProxies
+    {
+        AccountPtr acc;
+        ConnectionPtr conn;
+    };
+    QHash<QString, CachedProxies> mCachedProxies;
+
     ClientRegistrar *mRegistrar;
     QDBusConnection mBus;
     AbstractClientObserver *mClient;
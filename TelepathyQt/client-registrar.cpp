@@ -40,6 +40,8 @@
 #include <TelepathyQt/PendingComposite>
 #include <TelepathyQt/PendingReady>
 
+#include <QTimer>
+
 namespace Tp
 {
 
@@ -118,7 +120,7 @@ void ClientObserverAdaptor::ObserveChannels(const QDBusObjectPath &accountPath,
         const QVariantMap &observerInfo,
         const QDBusMessage &message)
 {
-    debug() << "ObserveChannels: account:" << accountPath.path() <<
+    TP_QT_DEBUG() << "ObserveChannels: account:" << accountPath.path() <<
         ", connection:" << connectionPath.path();
 
     AccountFactoryConstPtr accFactory = mRegistrar->accountFactory();
@@ -127,6 +129,7 @@ void ClientObserverAdaptor::ObserveChannels(const QDBusObjectPath &accountPath,
     ContactFactoryConstPtr contactFactory = mRegistrar->contactFactory();
 
     SharedPtr<InvocationData> invocation(new InvocationData());
+    invocation->readinessTimeout = mClient->observerReadinessTimeout();
 
     QList<PendingOperation *> readyOps;
 
@@ -136,6 +139,7 @@ void ClientObserverAdaptor::ObserveChannels(const QDBusObjectPath &accountPath,
             chanFactory,
             contactFactory);
     invocation->acc = AccountPtr::qObjectCast(accReady->proxy());
+    invocation->accFeatures = accReady->requestedFeatures();
     readyOps.append(accReady);
 
     QString connectionBusName = connectionPath.path().mid(1).replace(
@@ -143,6 +147,7 @@ void ClientObserverAdaptor::ObserveChannels(const QDBusObjectPath &accountPath,
     PendingReady *connReady = connFactory->proxy(connectionBusName, connectionPath.path(),
             chanFactory, contactFactory);
     invocation->conn = ConnectionPtr::qObjectCast(connReady->proxy());
+    invocation->connFeatures = connReady->requestedFeatures();
     readyOps.append(connReady);
 
     foreach (const ChannelDetails &channelDetails, channelDetailsList) {
@@ -150,6 +155,7 @@ void ClientObserverAdaptor::ObserveChannels(const QDBusObjectPath &accountPath,
                 channelDetails.channel.path(), channelDetails.properties);
         ChannelPtr channel = ChannelPtr::qObjectCast(chanReady->proxy());
         invocation->chans.append(channel);
+        invocation->chanFeatures.append(chanReady->requestedFeatures());
         readyOps.append(chanReady);
     }
 
@@ -207,14 +213,34 @@ void ClientObserverAdaptor::ObserveChannels(const QDBusObjectPath &accountPath,
 
     invocation->ctx = MethodInvocationContextPtr<>(new MethodInvocationContext<>(mBus, message));
 
-    invocation->readyOp = new PendingComposite(readyOps, invocation->ctx);
+    if (invocation->readinessTimeout >= 0) {
+        cacheCoreProxies(invocation->acc, invocation->conn);
+
+        // Wait for everything to finish even if some of it fails, the observer is given whatever
+        // became ready as long as the account and connection did
+        invocation->readyOp = new PendingComposite(readyOps, false, invocation->ctx);
+
+        // If the timeout passes before the account and connection are ready, this tells us when
+        // we can stop waiting for the rest
+        PendingOperation *coreReadyOp = new PendingComposite(
+                QList<PendingOperation *>() << accReady << connReady, invocation->ctx);
+        connect(coreReadyOp,
+                SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(onCoreReadyOpFinished(Tp::PendingOperation*)));
+
+        invocation->elapsed.start();
+        QTimer::singleShot(invocation->readinessTimeout, Qt::PreciseTimer,
+                this, SLOT(onReadinessTimeout()));
+    } else {
+        invocation->readyOp = new PendingComposite(readyOps, invocation->ctx);
+    }
     connect(invocation->readyOp,
             SIGNAL(finished(Tp::PendingOperation*)),
             SLOT(onReadyOpFinished(Tp::PendingOperation*)));
 
     mInvocations.append(invocation);
 
-    debug() << "Preparing proxies for ObserveChannels of" << channelDetailsList.size() << "channels"
+    TP_QT_DEBUG() << "Preparing proxies for ObserveChannels of" << channelDetailsList.size() << "channels"
         << "for client" << mClient;
 }
 
@@ -232,17 +258,104 @@ void ClientObserverAdaptor::onReadyOpFinished(Tp::PendingOperation *op)
         (*i)->readyOp = nullptr;
 
         if (op->isError()) {
-            warning() << "Preparing proxies for ObserveChannels failed with" << op->errorName()
-                << op->errorMessage();
-            (*i)->error = op->errorName();
-            (*i)->message = op->errorMessage();
+            if ((*i)->readinessTimeout >= 0 && isCoreReady(*i)) {
+                TP_QT_WARNING() << "Preparing some proxies for ObserveChannels failed with" <<
+                    op->errorName() << op->errorMessage() << "- leaving them out";
+            } else {
+                TP_QT_WARNING() << "Preparing proxies for ObserveChannels failed with" <<
+                    op->errorName() << op->errorMessage();
+                (*i)->error = op->errorName();
+                (*i)->message = op->errorMessage();
+            }
         }
 
         break;
     }
 
-    while (!mInvocations.isEmpty() && !mInvocations.first()->readyOp) {
-        SharedPtr<InvocationData> invocation = mInvocations.takeFirst();
+    invokeReadyObservers();
+}
+
+void ClientObserverAdaptor::onCoreReadyOpFinished(Tp::PendingOperation *op)
+{
+    if (op->isError()) {
+        // The invocation fails once the whole readiness operation finishes
+        return;
+    }
+
+    invokeReadyObservers();
+}
+
+void ClientObserverAdaptor::onReadinessTimeout()
+{
+    foreach (const SharedPtr<InvocationData> &invocation, mInvocations) {
+        if (invocation->readyOp && !invocation->timedOut &&
+                invocation->elapsed.elapsed() >= invocation->readinessTimeout) {
+            TP_QT_DEBUG() << "Readiness timeout passed for ObserveChannels on" << mClient;
+            invocation->timedOut = true;
+        }
+    }
+
+    invokeReadyObservers();
+}
+
+void ClientObserverAdaptor::onCachedProxyInvalidated(Tp::DBusProxy *proxy)
+{
+    QHash<QString, CachedProxies>::iterator i = mCachedProxies.begin();
+    while (i != mCachedProxies.end()) {
+        if (i->acc.data() == proxy || i->conn.data() == proxy) {
+            i = mCachedProxies.erase(i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+bool ClientObserverAdaptor::isCoreReady(const SharedPtr<InvocationData> &invocation) const
+{
+    return invocation->acc->isReady(invocation->accFeatures) &&
+        invocation->conn->isReady(invocation->connFeatures);
+}
+
+void ClientObserverAdaptor::cacheCoreProxies(const AccountPtr &acc, const ConnectionPtr &conn)
+{
+    // Holding a reference keeps the proxies in the factory caches, so the next invocations for the
+    // same account and connection get them back already introspected. Invalid proxies would never
+    // be released, as they won't signal invalidation again.
+    if (!acc->isValid() || !conn->isValid()) {
+        return;
+    }
+
+    QHash<QString, CachedProxies>::iterator i = mCachedProxies.find(conn->objectPath());
+    if (i != mCachedProxies.end() && i->acc == acc && i->conn == conn) {
+        return;
+    }
+
+    CachedProxies proxies;
+    proxies.acc = acc;
+    proxies.conn = conn;
+    mCachedProxies.insert(conn->objectPath(), proxies);
+
+    connect(acc.data(),
+            SIGNAL(invalidated(Tp::DBusProxy*,QString,QString)),
+            SLOT(onCachedProxyInvalidated(Tp::DBusProxy*)),
+            Qt::UniqueConnection);
+    connect(conn.data(),
+            SIGNAL(invalidated(Tp::DBusProxy*,QString,QString)),
+            SLOT(onCachedProxyInvalidated(Tp::DBusProxy*)),
+            Qt::UniqueConnection);
+}
+
+void ClientObserverAdaptor::invokeReadyObservers()
+{
+    while (!mInvocations.isEmpty()) {
+        SharedPtr<InvocationData> invocation = mInvocations.first();
+
+        if (invocation->readyOp &&
+                !(invocation->timedOut && isCoreReady(invocation))) {
+            break;
+        }
+
+        mInvocations.removeFirst();
 
         if (!invocation->error.isEmpty()) {
             // We guarantee that the proxies were ready - so we can't invoke the client if they
@@ -251,12 +364,42 @@ void ClientObserverAdaptor::onReadyOpFinished(Tp::PendingOperation *op)
             continue;
         }
 
-        debug() << "Invoking application observeChannels with" << invocation->chans.size()
+        QList<ChannelPtr> chans = invocation->chans;
+        ChannelDispatchOperationPtr dispatchOp = invocation->dispatchOp;
+        QList<ChannelRequestPtr> chanReqs = invocation->chanReqs;
+
+        if (invocation->readinessTimeout >= 0) {
+            // Only hand over what is ready, either because the timeout passed or because
+            // something failed to become ready
+            chans.clear();
+            for (int i = 0; i < invocation->chans.size(); ++i) {
+                if (invocation->chans[i]->isReady(invocation->chanFeatures[i])) {
+                    chans.append(invocation->chans[i]);
+                }
+            }
+
+            if (dispatchOp && !dispatchOp->isReady()) {
+                dispatchOp.reset();
+            }
+
+            chanReqs.clear();
+            foreach (const ChannelRequestPtr &chanReq, invocation->chanReqs) {
+                if (chanReq->isReady()) {
+                    chanReqs.append(chanReq);
+                }
+            }
+
+            if (chans.size() != invocation->chans.size()) {
+                TP_QT_DEBUG() << "Leaving" << (invocation->chans.size() - chans.size()) <<
+                    "channels which are not ready out of ObserveChannels";
+            }
+        }
+
+        TP_QT_DEBUG() << "Invoking application observeChannels with" << chans.size()
             << "channels on" << mClient;
 
         mClient->observeChannels(invocation->ctx, invocation->acc, invocation->conn,
-                invocation->chans, invocation->dispatchOp, invocation->chanReqs,
-                invocation->observerInfo);
+                chans, dispatchOp, chanReqs, invocation->observerInfo);
     }
 }
 
@@ -289,7 +432,7 @@ void ClientApproverAdaptor::AddDispatchOperation(const Tp::ChannelDetailsList &c
     QDBusObjectPath connectionPath = qdbus_cast<QDBusObjectPath>(
             properties.value(
                 TP_QT_IFACE_CHANNEL_DISPATCH_OPERATION + QLatin1String(".Connection")));
-    debug() << "addDispatchOperation: connection:" << connectionPath.path();
+    TP_QT_DEBUG() << "addDispatchOperation: connection:" << connectionPath.path();
     QString connectionBusName = connectionPath.path().mid(1).replace(
             QLatin1String("/"), QLatin1String("."));
     PendingReady *connReady = connFactory->proxy(connectionBusName, connectionPath.path(), chanFactory,
@@ -335,7 +478,7 @@ void ClientApproverAdaptor::onReadyOpFinished(Tp::PendingOperation *op)
         (*i)->readyOp = nullptr;
 
         if (op->isError()) {
-            warning() << "Preparing proxies for AddDispatchOperation failed with" << op->errorName()
+            TP_QT_WARNING() << "Preparing proxies for AddDispatchOperation failed with" << op->errorName()
                 << op->errorMessage();
             (*i)->error = op->errorName();
             (*i)->message = op->errorMessage();
@@ -354,7 +497,7 @@ void ClientApproverAdaptor::onReadyOpFinished(Tp::PendingOperation *op)
             continue;
         }
 
-        debug() << "Invoking application addDispatchOperation with CDO"
+        TP_QT_DEBUG() << "Invoking application addDispatchOperation with CDO"
             << invocation->dispatchOp->objectPath() << "on" << mClient;
 
         mClient->addDispatchOperation(invocation->ctx, invocation->dispatchOp);
@@ -395,7 +538,7 @@ void ClientHandlerAdaptor::HandleChannels(const QDBusObjectPath &accountPath,
         const QVariantMap &handlerInfo,
         const QDBusMessage &message)
 {
-    debug() << "HandleChannels: account:" << accountPath.path() <<
+    TP_QT_DEBUG() << "HandleChannels: account:" << accountPath.path() <<
         ", connection:" << connectionPath.path();
 
     AccountFactoryConstPtr accFactory = mRegistrar->accountFactory();
@@ -408,7 +551,7 @@ void ClientHandlerAdaptor::HandleChannels(const QDBusObjectPath &accountPath,
 
     RequestTemporaryHandler *tempHandler = dynamic_cast<RequestTemporaryHandler *>(mClient);
     if (tempHandler) {
-        debug() << "  This is a temporary handler for the Request & Handle API,"
+        TP_QT_DEBUG() << "  This is a temporary handler for the Request & Handle API,"
             << "giving an early signal of the invocation";
         tempHandler->setDBusHandlerInvoked();
     }
@@ -475,7 +618,7 @@ void ClientHandlerAdaptor::HandleChannels(const QDBusObjectPath &accountPath,
 
     mInvocations.append(invocation);
 
-    debug() << "Preparing proxies for HandleChannels of" << channelDetailsList.size() << "channels"
+    TP_QT_DEBUG() << "Preparing proxies for HandleChannels of" << channelDetailsList.size() << "channels"
         << "for client" << mClient;
 }
 
@@ -493,7 +636,7 @@ void ClientHandlerAdaptor::onReadyOpFinished(Tp::PendingOperation *op)
         (*i)->readyOp = nullptr;
 
         if (op->isError()) {
-            warning() << "Preparing proxies for HandleChannels failed with" << op->errorName()
+            TP_QT_WARNING() << "Preparing proxies for HandleChannels failed with" << op->errorName()
                 << op->errorMessage();
             (*i)->error = op->errorName();
             (*i)->message = op->errorMessage();
@@ -508,7 +651,7 @@ void ClientHandlerAdaptor::onReadyOpFinished(Tp::PendingOperation *op)
         if (!invocation->error.isEmpty()) {
             RequestTemporaryHandler *tempHandler = dynamic_cast<RequestTemporaryHandler *>(mClient);
             if (tempHandler) {
-                debug() << "  This is a temporary handler for the Request & Handle API, indicating failure";
+                TP_QT_DEBUG() << "  This is a temporary handler for the Request & Handle API, indicating failure";
                 tempHandler->setDBusHandlerErrored(invocation->error, invocation->message);
             }
 
@@ -518,7 +661,7 @@ void ClientHandlerAdaptor::onReadyOpFinished(Tp::PendingOperation *op)
             continue;
         }
 
-        debug() << "Invoking application handleChannels with" << invocation->chans.size()
+        TP_QT_DEBUG() << "Invoking application handleChannels with" << invocation->chans.size()
             << "channels on" << mClient;
 
         mClient->handleChannels(invocation->ctx, invocation->acc, invocation->conn,
@@ -531,7 +674,7 @@ void ClientHandlerAdaptor::onContextFinished(
         const QList<ChannelPtr> &channels, ClientHandlerAdaptor *self)
 {
     if (!context->isError()) {
-        debug() << "HandleChannels context finished successfully, "
+        TP_QT_DEBUG() << "HandleChannels context finished successfully, "
             "updating handled channels";
 
         // register the channels in FakeHandlerManager so we report HandledChannels correctly
@@ -559,7 +702,7 @@ void ClientHandlerRequestsAdaptor::AddRequest(
         const QVariantMap &requestProperties,
         const QDBusMessage &message)
 {
-    debug() << "AddRequest:" << request.path();
+    TP_QT_DEBUG() << "AddRequest:" << request.path();
     message.setDelayedReply(true);
     mBus.send(message.createReply());
     mClient->addRequest(ChannelRequest::create(mBus,
@@ -575,7 +718,7 @@ void ClientHandlerRequestsAdaptor::RemoveRequest(
         const QString &errorName, const QString &errorMessage,
         const QDBusMessage &message)
 {
-    debug() << "RemoveRequest:" << request.path() << "-" << errorName
+    TP_QT_DEBUG() << "RemoveRequest:" << request.path() << "-" << errorName
         << "-" << errorMessage;
     message.setDelayedReply(true);
     mBus.send(message.createReply());
@@ -596,15 +739,15 @@ struct TP_QT_NO_EXPORT ClientRegistrar::Private
         contactFactory(contactFactory)
     {
         if (accFactory->dbusConnection().name() != bus.name()) {
-            warning() << "  The D-Bus connection in the account factory is not the proxy connection";
+            TP_QT_WARNING() << "  The D-Bus connection in the account factory is not the proxy connection";
         }
 
         if (connFactory->dbusConnection().name() != bus.name()) {
-            warning() << "  The D-Bus connection in the connection factory is not the proxy connection";
+            TP_QT_WARNING() << "  The D-Bus connection in the connection factory is not the proxy connection";
         }
 
         if (chanFactory->dbusConnection().name() != bus.name()) {
-            warning() << "  The D-Bus connection in the channel factory is not the proxy connection";
+            TP_QT_WARNING() << "  The D-Bus connection in the channel factory is not the proxy connection";
         }
     }
 
@@ -886,12 +1029,12 @@ bool ClientRegistrar::registerClient(const AbstractClientPtr &client,
         const QString &clientName, bool unique)
 {
     if (!client) {
-        warning() << "Unable to register a null client";
+        TP_QT_WARNING() << "Unable to register a null client";
         return false;
     }
 
     if (mPriv->clients.contains(client)) {
-        debug() << "Client already registered";
+        TP_QT_DEBUG() << "Client already registered";
         return true;
     }
 
@@ -908,7 +1051,7 @@ bool ClientRegistrar::registerClient(const AbstractClientPtr &client,
     }
 
     if (mPriv->services.contains(busName)) {
-        warning() << "Unable to register client: busName" <<
+        TP_QT_WARNING() << "Unable to register client: busName" <<
             busName << "already registered";
         return false;
     }
@@ -951,7 +1094,7 @@ bool ClientRegistrar::registerClient(const AbstractClientPtr &client,
     }
 
     if (interfaces.isEmpty()) {
-        warning() << "Client does not implement any known interface";
+        TP_QT_WARNING() << "Client does not implement any known interface";
         // cleanup
         return false;
     }
@@ -963,7 +1106,7 @@ bool ClientRegistrar::registerClient(const AbstractClientPtr &client,
     objectPath.replace(QLatin1String("."), QLatin1String("/"));
     if (!mPriv->bus.registerObject(objectPath, object)) {
         // this shouldn't happen, but let's make sure
-        warning() << "Unable to register client: objectPath" <<
+        TP_QT_WARNING() << "Unable to register client: objectPath" <<
             objectPath << "already registered";
         // cleanup
         delete object;
@@ -971,7 +1114,7 @@ bool ClientRegistrar::registerClient(const AbstractClientPtr &client,
     }
 
     if (!mPriv->bus.registerService(busName)) {
-        warning() << "Unable to register service: busName" <<
+        TP_QT_WARNING() << "Unable to register service: busName" <<
             busName << "already registered";
         mPriv->bus.unregisterObject(objectPath, QDBusConnection::UnregisterTree);
         delete object;
@@ -983,7 +1126,7 @@ bool ClientRegistrar::registerClient(const AbstractClientPtr &client,
         handler->setRegistered(true);
     }
 
-    debug() << "Client registered - busName:" << busName <<
+    TP_QT_DEBUG() << "Client registered - busName:" << busName <<
         "objectPath:" << objectPath << "interfaces:" << interfaces;
 
     mPriv->services.insert(busName);
@@ -1006,7 +1149,7 @@ bool ClientRegistrar::registerClient(const AbstractClientPtr &client,
 bool ClientRegistrar::unregisterClient(const AbstractClientPtr &client)
 {
     if (!mPriv->clients.contains(client)) {
-        warning() << "Trying to unregister an unregistered client";
+        TP_QT_WARNING() << "Trying to unregister an unregistered client";
         return false;
     }
 
@@ -1030,7 +1173,7 @@ bool ClientRegistrar::unregisterClient(const AbstractClientPtr &client)
     mPriv->bus.unregisterService(busName);
     mPriv->services.remove(busName);
 
-    debug() << "Client unregistered - busName:" << busName <<
+    TP_QT_DEBUG() << "Client unregistered - busName:" << busName <<
         "objectPath:" << objectPath;
 
     return true;
@@ -0,0 +1,388 @@
+/**
+ * This file is part of TelepathyQt
+ *
+ * @copyright Copyright (C) 2012 Collabora Ltd. <http://www.collabora.co.uk/>
+ * @license LGPL 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <TelepathyQt/CompletionHandle>
+
+#include "TelepathyQt/debug-internal.h"
+
+#include <QDBusError>
+#include <QSharedData>
+#include <QSharedPointer>
+
+namespace Tp
+{
+
+struct TP_QT_NO_EXPORT CompletionHandle::Private : public QSharedData
+{
+    Private()
+        : finished(false)
+    {
+    }
+
+    void finish(const CompletionHandle &handle);
+
+    bool finished;
+    QString errorName;
+    QString errorMessage;
+    QList<Continuation> continuations;
+};
+
+void CompletionHandle::Private::finish(const CompletionHandle &handle)
+{
+    // Continuations registered from now on run immediately from then(), so this
+    // list is only walked once
+    QList<Continuation> pending = continuations;
+    continuations.clear();
+    foreach (const Continuation &continuation, pending) {
+        continuation(handle);
+    }
+}
+
+namespace
+{
+
+struct AllState
+{
+    AllState(const CompletionHandle &result, int remaining, bool failOnFirstError)
+        : result(result),
+          remaining(remaining),
+          failOnFirstError(failOnFirstError)
+    {
+    }
+
+    CompletionHandle result;
+    int remaining;
+    bool failOnFirstError;
+    QString errorName;
+    QString errorMessage;
+};
+
+struct AllContinuation
+{
+    AllContinuation(const QSharedPointer<AllState> &state)
+        : state(state)
+    {
+    }
+
+    void operator()(const CompletionHandle &handle) const
+    {
+        if (state->result.isFinished()) {
+            return;
+        }
+
+        if (handle.isError()) {
+            if (state->failOnFirstError) {
+                state->result.setFinishedWithError(handle.errorName(), handle.errorMessage());
+                return;
+            } else if (state->errorName.isEmpty()) {
+                state->errorName = handle.errorName();
+                state->errorMessage = handle.errorMessage();
+            }
+        }
+
+        if (--state->remaining == 0) {
+            if (state->errorName.isEmpty()) {
+                state->result.setFinished();
+            } else {
+                state->result.setFinishedWithError(state->errorName, state->errorMessage);
+            }
+        }
+    }
+
+    QSharedPointer<AllState> state;
+};
+
+}
+
+/**
+ * \class CompletionHandle
+ * \ingroup utils
+ * \headerfile TelepathyQt/completion-handle.h <TelepathyQt/CompletionHandle>
+ *
+ * \brief The CompletionHandle class is a lightweight, implicitly shared
+ * completion primitive for asynchronous operations.
+ *
+ * Unlike PendingOperation, a CompletionHandle is not a QObject, does not
+ * require the event loop to deliver its result and is not deleted
+ * with deleteLater(). Continuations registered with then() are invoked
+ * synchronously when the handle finishes, or immediately if it has already
+ * finished, which makes it suitable for chaining internal steps without
+ * allocating a QObject and scheduling timer events for each step.
+ *
+ * Copies of a CompletionHandle refer to the same completion state, so one
+ * copy can be handed to the producer, which calls setFinished() or
+ * setFinishedWithError(), while others are used to observe the result.
+ *
+ * When built with a C++20 compiler a CompletionHandle can also be awaited
+ * with \c co_await from a coroutine, which is resumed when the handle finishes.
+ *
+ * Use PendingCompletion to expose a CompletionHandle through the
+ * PendingOperation API, or PendingOperation::completion() to obtain a handle
+ * that finishes as soon as a PendingOperation does.
+ *
+ * See \ref async_model
+ */
+
+/**
+ * \typedef CompletionHandle::Continuation
+ *
+ * The type of callbacks passed to then(). The finished handle is passed as the
+ * only argument.
+ */
+
+/**
+ * Construct a new, unfinished CompletionHandle object.
+ */
+CompletionHandle::CompletionHandle()
+    : mPriv(new Private)
+{
+}
+
+/**
+ * Construct a new CompletionHandle object sharing the completion state of \a other.
+ *
+ * \param other The handle to copy.
+ */
+CompletionHandle::CompletionHandle(const CompletionHandle &other)
+    : mPriv(other.mPriv)
+{
+}
+
+/**
+ * Class destructor.
+ */
+CompletionHandle::~CompletionHandle()
+{
+}
+
+/**
+ * Return a CompletionHandle that has already finished successfully.
+ *
+ * \return The finished handle.
+ */
+CompletionHandle CompletionHandle::succeeded()
+{
+    CompletionHandle handle;
+    handle.setFinished();
+    return handle;
+}
+
+/**
+ * Return a CompletionHandle that has already finished with the given error.
+ *
+ * \param errorName The D-Bus error name, which must be non-empty.
+ * \param errorMessage The debugging message.
+ * \return The finished handle.
+ */
+CompletionHandle CompletionHandle::failed(const QString &errorName, const QString &errorMessage)
+{
+    CompletionHandle handle;
+    handle.setFinishedWithError(errorName, errorMessage);
+    return handle;
+}
+
+/**
+ * Return a CompletionHandle that finishes when all of \a handles have finished.
+ *
+ * If \a failOnFirstError is \c true the returned handle fails as soon as any
+ * of \a handles fails, otherwise it waits for all of them and fails with the
+ * first error seen, if any.
+ *
+ * This is the CompletionHandle counterpart of PendingComposite.
+ *
+ * \param handles The handles to track.
+ * \param failOnFirstError Whether to fail as soon as one of \a handles fails.
+ * \return The combined handle.
+ */
+CompletionHandle CompletionHandle::all(const QList<CompletionHandle> &handles,
+        bool failOnFirstError)
+{
+    if (handles.isEmpty()) {
+        return succeeded();
+    }
+
+    CompletionHandle result;
+    QSharedPointer<AllState> state(new AllState(result, handles.size(), failOnFirstError));
+    foreach (const CompletionHandle &handle, handles) {
+        handle.then(AllContinuation(state));
+    }
+    return result;
+}
+
+CompletionHandle &CompletionHandle::operator=(const CompletionHandle &other)
+{
+    mPriv = other.mPriv;
+    return *this;
+}
+
+/**
+ * Return whether this handle shares its completion state with \a other.
+ *
+ * \param other The handle to compare with.
+ * \return \c true if both handles refer to the same completion, \c false otherwise.
+ */
+bool CompletionHandle::operator==(const CompletionHandle &other) const
+{
+    return mPriv == other.mPriv;
+}
+
+bool CompletionHandle::operator!=(const CompletionHandle &other) const
+{
+    return mPriv != other.mPriv;
+}
+
+/**
+ * Return whether or not the operation has finished.
+ *
+ * \return \c true if the operation has finished, \c false otherwise.
+ */
+bool CompletionHandle::isFinished() const
+{
+    return mPriv->finished;
+}
+
+/**
+ * Return whether or not the operation finished successfully.
+ *
+ * Equivalent to <code>(isFinished() && !isError())</code>.
+ *
+ * \return \c true if the operation has finished successfully, \c false otherwise.
+ */
+bool CompletionHandle::isValid() const
+{
+    return mPriv->finished && mPriv->errorName.isEmpty();
+}
+
+/**
+ * Return whether or not the operation finished with an error.
+ *
+ * Equivalent to <code>(isFinished() && !isValid())</code>.
+ *
+ * \return \c true if the operation has finished with an error, \c false otherwise.
+ */
+bool CompletionHandle::isError() const
+{
+    return mPriv->finished && !mPriv->errorName.isEmpty();
+}
+
+/**
+ * If isError() returns \c true, returns the D-Bus error with which the
+ * operation failed. Otherwise, returns an empty string.
+ *
+ * \return A D-Bus error name, or an empty string.
+ */
+QString CompletionHandle::errorName() const
+{
+    return mPriv->errorName;
+}
+
+/**
+ * If isError() returns \c true, returns a debugging message associated with
+ * the error, which may be an empty string. Otherwise, returns an empty string.
+ *
+ * \return A debugging message, or an empty string.
+ */
+QString CompletionHandle::errorMessage() const
+{
+    return mPriv->errorMessage;
+}
+
+/**
+ * Record that the operation has finished successfully and synchronously invoke
+ * all continuations registered with then().
+ */
+void CompletionHandle::setFinished() const
+{
+    if (mPriv->finished) {
+        TP_QT_WARNING() << "CompletionHandle: trying to finish with success, but already finished";
+        return;
+    }
+
+    // Continuations may drop the last reference to the object we were
+    // called on, so keep our own one until they are done
+    CompletionHandle self(*this);
+    mPriv->finished = true;
+    self.mPriv->finish(self);
+}
+
+/**
+ * Record that the operation has finished with an error and synchronously invoke
+ * all continuations registered with then().
+ *
+ * \param name The D-Bus error name, which must be non-empty.
+ * \param message The debugging message.
+ */
+void CompletionHandle::setFinishedWithError(const QString &name, const QString &message) const
+{
+    if (mPriv->finished) {
+        TP_QT_WARNING() << "CompletionHandle: trying to fail with" << name <<
+            "but already finished";
+        return;
+    }
+
+    if (name.isEmpty()) {
+        TP_QT_WARNING() << "CompletionHandle: should be given a non-empty error name";
+        mPriv->errorName = QLatin1String("org.freedesktop.Telepathy.Qt.ErrorHandlingError");
+    } else {
+        mPriv->errorName = name;
+    }
+
+    CompletionHandle self(*this);
+    mPriv->errorMessage = message;
+    mPriv->finished = true;
+    self.mPriv->finish(self);
+}
+
+/**
+ * Record that the operation has finished with an error and synchronously invoke
+ * all continuations registered with then().
+ *
+ * \param error The error.
+ */
+void CompletionHandle::setFinishedWithError(const QDBusError &error) const
+{
+    setFinishedWithError(error.name(), error.message());
+}
+
+/**
+ * Register \a continuation to be invoked with this handle once it has finished.
+ *
+ * If the handle has already finished, \a continuation is invoked immediately,
+ * before this method returns. Continuations are invoked in the order in which
+ * they were registered.
+ *
+ * \param continuation The callback to invoke.
+ */
+void CompletionHandle::then(const Continuation &continuation) const
+{
+    if (!continuation.isValid()) {
+        return;
+    }
+
+    if (mPriv->finished) {
+        continuation(*this);
+        return;
+    }
+
+    mPriv->continuations.append(continuation);
+}
+
+} // Tp
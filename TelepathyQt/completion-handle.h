@@ -0,0 +1,109 @@
+/**
+ * This file is part of TelepathyQt
+ *
+ * @copyright Copyright (C) 2012 Collabora Ltd. <http://www.collabora.co.uk/>
+ * @license LGPL 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _TelepathyQt_completion_handle_h_HEADER_GUARD_
+#define _TelepathyQt_completion_handle_h_HEADER_GUARD_
+
+#ifndef IN_TP_QT_HEADER
+#error IN_TP_QT_HEADER
+#endif
+
+#include <TelepathyQt/Callbacks>
+#include <TelepathyQt/Global>
+
+#include <QList>
+#include <QSharedDataPointer>
+#include <QString>
+
+class QDBusError;
+
+namespace Tp
+{
+
+class TP_QT_EXPORT CompletionHandle
+{
+public:
+    typedef Callback1<void, const CompletionHandle &> Continuation;
+
+    CompletionHandle();
+    CompletionHandle(const CompletionHandle &other);
+    ~CompletionHandle();
+
+    static CompletionHandle succeeded();
+    static CompletionHandle failed(const QString &errorName, const QString &errorMessage);
+    static CompletionHandle all(const QList<CompletionHandle> &handles,
+            bool failOnFirstError = true);
+
+    CompletionHandle &operator=(const CompletionHandle &other);
+    bool operator==(const CompletionHandle &other) const;
+    bool operator!=(const CompletionHandle &other) const;
+
+    bool isFinished() const;
+
+    bool isValid() const;
+
+    bool isError() const;
+    QString errorName() const;
+    QString errorMessage() const;
+
+    void setFinished() const;
+    void setFinishedWithError(const QString &name, const QString &message) const;
+    void setFinishedWithError(const QDBusError &error) const;
+
+    void then(const Continuation &continuation) const;
+
+private:
+    struct Private;
+    friend struct Private;
+    QExplicitlySharedDataPointer<Private> mPriv;
+};
+
+} // Tp
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#include <coroutine>
+
+namespace Tp
+{
+
+struct CompletionHandleAwaiter
+{
+    CompletionHandle handle;
+
+    bool await_ready() const { return handle.isFinished(); }
+
+    void await_suspend(std::coroutine_handle<> coroutine) const
+    {
+        handle.then([coroutine](const CompletionHandle &) { coroutine.resume(); });
+    }
+
+    CompletionHandle await_resume() const { return handle; }
+};
+
+inline CompletionHandleAwaiter operator co_await(const CompletionHandle &handle)
+{
+    return CompletionHandleAwaiter{handle};
+}
+
+} // Tp
+#endif
+
+#endif
@@ -26,10 +26,15 @@
 #include <TelepathyQt/PendingStringList>
 
 #include <QDBusConnection>
+#include <QHash>
 #include <QLatin1String>
+#include <QObject>
 #include <QQueue>
 #include <QSet>
 #include <QString>
+#include <QStringList>
+
+class QDBusServiceWatcher;
 
 namespace Tp
 {
@@ -101,15 +106,14 @@ public:
 
 private Q_SLOTS:
     void onCallFinished(QDBusPendingCallWatcher *);
-    void continueProcessing();
 
 private:
     void invokeMethod(const QLatin1String &method);
     void parseResult(const QStringList &names);
 
-    QQueue<QLatin1String> mMethodsQueue;
     QSet<QString> mResult;
     QDBusConnection mBus;
+    int mPendingCalls;
 };
 
 class TP_QT_NO_EXPORT ConnectionManager::Private::ProtocolWrapper :
@@ -179,7 +183,47 @@ private:
     bool mHasAvatarsProps;
     bool mHasPresenceProps;
     bool mHasAddressingProps;
-    QQueue<void (ProtocolWrapper::*)()> introspectQueue;
+    bool mInterfacesIntrospected;
+    int mPendingIntrospections;
+};
+
+// Process-wide registry of ConnectionManager objects, one per bus and CM name,
+// so that all the accounts on a connection manager share a single introspected
+// ConnectionManager and its protocol info. An entry is dropped as soon as the
+// CM's bus name changes owner or the ConnectionManager is invalidated, so that
+// a restarted CM is introspected again.
+class TP_QT_NO_EXPORT ConnectionManagerRegistry : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(ConnectionManagerRegistry)
+
+public:
+    static ConnectionManagerRegistry *forConnection(const QDBusConnection &bus);
+
+    ~ConnectionManagerRegistry() override;
+
+    ConnectionManagerPtr connectionManager(const QString &name,
+            const ConnectionFactoryConstPtr &connFactory,
+            const ChannelFactoryConstPtr &chanFactory,
+            const ContactFactoryConstPtr &contactFactory);
+
+private Q_SLOTS:
+    void onServiceOwnerChanged(const QString &busName, const QString &oldOwner,
+            const QString &newOwner);
+    void onConnectionManagerInvalidated(Tp::DBusProxy *proxy);
+
+private:
+    ConnectionManagerRegistry(const QDBusConnection &bus);
+
+    void remove(const QString &name);
+    void removeExpired();
+
+    // The registries are never removed, so that there is only ever one watcher per bus
+    static QHash<QString, ConnectionManagerRegistry*> registries;
+
+    QDBusConnection mBus;
+    QDBusServiceWatcher *mWatcher;
+    QHash<QString, WeakPtr<ConnectionManager> > mCMs;
 };
 
 } // Tp
@@ -43,31 +43,42 @@
 #include <TelepathyQt/Utils>
 
 #include <QDBusConnectionInterface>
+#include <QDBusServiceWatcher>
 #include <QQueue>
 #include <QStringList>
-#include <QTimer>
 
 namespace Tp
 {
 
 ConnectionManager::Private::PendingNames::PendingNames(const QDBusConnection &bus)
     : PendingStringList(SharedPtr<RefCounted>()),
-      mBus(bus)
+      mBus(bus),
+      mPendingCalls(0)
 {
-    mMethodsQueue.enqueue(QLatin1String("ListNames"));
-    mMethodsQueue.enqueue(QLatin1String("ListActivatableNames"));
-    QTimer::singleShot(0, this, SLOT(continueProcessing()));
+    // Both lists are independent, so ask for them at once and merge the
+    // replies as they arrive
+    invokeMethod(QLatin1String("ListNames"));
+    invokeMethod(QLatin1String("ListActivatableNames"));
 }
 
 void ConnectionManager::Private::PendingNames::onCallFinished(QDBusPendingCallWatcher *watcher)
 {
     QDBusPendingReply<QStringList> reply = *watcher;
 
-    if (!reply.isError()) {
+    --mPendingCalls;
+
+    if (isFinished()) {
+        // an earlier call already failed
+    } else if (!reply.isError()) {
         parseResult(reply.value());
-        continueProcessing();
+
+        if (mPendingCalls == 0) {
+            TP_QT_DEBUG() << "Success: list" << mResult;
+            setResult(mResult.toList());
+            setFinished();
+        }
     } else {
-        warning() << "Failure: error " << reply.error().name() <<
+        TP_QT_WARNING() << "Failure: error " << reply.error().name() <<
             ": " << reply.error().message();
         setFinishedWithError(reply.error());
     }
@@ -75,19 +86,6 @@ void ConnectionManager::Private::PendingNames::onCallFinished(QDBusPendingCallWa
     watcher->deleteLater();
 }
 
-void ConnectionManager::Private::PendingNames::continueProcessing()
-{
-    if (!mMethodsQueue.isEmpty()) {
-        QLatin1String method = mMethodsQueue.dequeue();
-        invokeMethod(method);
-    }
-    else {
-        debug() << "Success: list" << mResult;
-        setResult(mResult.toList());
-        setFinished();
-    }
-}
-
 void ConnectionManager::Private::PendingNames::invokeMethod(const QLatin1String &method)
 {
     QDBusPendingCall call = mBus.interface()->asyncCallWithArgumentList(
@@ -96,6 +94,7 @@ void ConnectionManager::Private::PendingNames::invokeMethod(const QLatin1String
     connect(watcher,
             SIGNAL(finished(QDBusPendingCallWatcher*)),
             SLOT(onCallFinished(QDBusPendingCallWatcher*)));
+    ++mPendingCalls;
 }
 
 void ConnectionManager::Private::PendingNames::parseResult(const QStringList &names)
@@ -123,7 +122,9 @@ ConnectionManager::Private::ProtocolWrapper::ProtocolWrapper(
       mHasMainProps(false),
       mHasAvatarsProps(false),
       mHasPresenceProps(false),
-      mHasAddressingProps(false)
+      mHasAddressingProps(false),
+      mInterfacesIntrospected(false),
+      mPendingIntrospections(0)
 {
     fillRCCs();
 
@@ -149,15 +150,21 @@ void ConnectionManager::Private::ProtocolWrapper::introspectMain(
         ConnectionManager::Private::ProtocolWrapper *self)
 {
     if (self->extractImmutableProperties()) {
-        debug() << "Got everything we want from the immutable props for" <<
+        TP_QT_DEBUG() << "Got everything we want from the immutable props for" <<
             self->info().name();
         self->continueIntrospection();
         return;
     }
 
+    // The GetAll calls for the main and the optional interfaces are independent
+    // of each other, so issue all of them at once, as long as the interface list
+    // is known upfront
     if (!self->mHasMainProps) {
-        self->introspectQueue.enqueue(&ProtocolWrapper::introspectMainProperties);
-    } else {
+        self->introspectMainProperties();
+    }
+
+    if (self->mHasMainProps ||
+        self->mImmutableProps.contains(TP_QT_IFACE_PROTOCOL + QLatin1String(".Interfaces"))) {
         self->introspectInterfaces();
     }
 
@@ -169,36 +176,39 @@ void ConnectionManager::Private::ProtocolWrapper::introspectMainProperties()
     Client::ProtocolInterface *protocol = baseInterface();
     Q_ASSERT(protocol != nullptr);
 
-    debug() << "Calling Properties::GetAll(Protocol) for" << info().name();
+    TP_QT_DEBUG() << "Calling Properties::GetAll(Protocol) for" << info().name();
     PendingVariantMap *pvm = protocol->requestAllProperties();
     connect(pvm,
             SIGNAL(finished(Tp::PendingOperation*)),
             SLOT(gotMainProperties(Tp::PendingOperation*)));
+    ++mPendingIntrospections;
 }
 
 void ConnectionManager::Private::ProtocolWrapper::introspectInterfaces()
 {
+    mInterfacesIntrospected = true;
+
     if (!mHasAvatarsProps) {
         if (hasInterface(TP_QT_IFACE_PROTOCOL_INTERFACE_AVATARS)) {
-            introspectQueue.enqueue(&ProtocolWrapper::introspectAvatars);
+            introspectAvatars();
         } else {
-            debug() << "Full functionality requires CM support for the Protocol.Avatars interface";
+            TP_QT_DEBUG() << "Full functionality requires CM support for the Protocol.Avatars interface";
         }
     }
 
     if (!mHasPresenceProps) {
         if (hasInterface(TP_QT_IFACE_PROTOCOL_INTERFACE_PRESENCE)) {
-            introspectQueue.enqueue(&ProtocolWrapper::introspectPresence);
+            introspectPresence();
         } else {
-            debug() << "Full functionality requires CM support for the Protocol.Presence interface";
+            TP_QT_DEBUG() << "Full functionality requires CM support for the Protocol.Presence interface";
         }
     }
 
     if (!mHasAddressingProps) {
         if (hasInterface(TP_QT_IFACE_PROTOCOL_INTERFACE_ADDRESSING)) {
-            introspectQueue.enqueue(&ProtocolWrapper::introspectAddressing);
+            introspectAddressing();
         } else {
-            debug() << "Full functionality requires CM support for the Protocol.Addressing interface";
+            TP_QT_DEBUG() << "Full functionality requires CM support for the Protocol.Addressing interface";
         }
     }
 }
@@ -208,11 +218,12 @@ void ConnectionManager::Private::ProtocolWrapper::introspectAvatars()
     Client::ProtocolInterfaceAvatarsInterface *avatars = avatarsInterface();
     Q_ASSERT(avatars != nullptr);
 
-    debug() << "Calling Properties::GetAll(Protocol.Avatars) for" << info().name();
+    TP_QT_DEBUG() << "Calling Properties::GetAll(Protocol.Avatars) for" << info().name();
     PendingVariantMap *pvm = avatars->requestAllProperties();
     connect(pvm,
             SIGNAL(finished(Tp::PendingOperation*)),
             SLOT(gotAvatarsProperties(Tp::PendingOperation*)));
+    ++mPendingIntrospections;
 }
 
 void ConnectionManager::Private::ProtocolWrapper::introspectPresence()
@@ -220,11 +231,12 @@ void ConnectionManager::Private::ProtocolWrapper::introspectPresence()
     Client::ProtocolInterfacePresenceInterface *presence = presenceInterface();
     Q_ASSERT(presence != nullptr);
 
-    debug() << "Calling Properties::GetAll(Protocol.Presence) for" << info().name();
+    TP_QT_DEBUG() << "Calling Properties::GetAll(Protocol.Presence) for" << info().name();
     PendingVariantMap *pvm = presence->requestAllProperties();
     connect(pvm,
             SIGNAL(finished(Tp::PendingOperation*)),
             SLOT(gotPresenceProperties(Tp::PendingOperation*)));
+    ++mPendingIntrospections;
 }
 
 void ConnectionManager::Private::ProtocolWrapper::introspectAddressing()
@@ -232,19 +244,18 @@ void ConnectionManager::Private::ProtocolWrapper::introspectAddressing()
     Client::ProtocolInterfaceAddressingInterface *addressing = addressingInterface();
     Q_ASSERT(addressing != nullptr);
 
-    debug() << "Calling Properties::GetAll(Protocol.Addressing) for" << info().name();
+    TP_QT_DEBUG() << "Calling Properties::GetAll(Protocol.Addressing) for" << info().name();
     PendingVariantMap *pvm = addressing->requestAllProperties();
     connect(pvm,
             SIGNAL(finished(Tp::PendingOperation*)),
             SLOT(gotAddressingProperties(Tp::PendingOperation*)));
+    ++mPendingIntrospections;
 }
 
 void ConnectionManager::Private::ProtocolWrapper::continueIntrospection()
 {
-    if (introspectQueue.isEmpty()) {
+    if (mPendingIntrospections == 0) {
         mReadinessHelper->setIntrospectCompleted(FeatureCore, true);
-    } else {
-        (this->*(introspectQueue.dequeue()))();
     }
 }
 
@@ -252,20 +263,23 @@ void ConnectionManager::Private::ProtocolWrapper::gotMainProperties(
         Tp::PendingOperation *op)
 {
     if (!op->isError()) {
-        debug() << "Got reply to Properties.GetAll(Protocol)";
+        TP_QT_DEBUG() << "Got reply to Properties.GetAll(Protocol)";
         PendingVariantMap *pvm = qobject_cast<PendingVariantMap*>(op);
         QVariantMap unqualifiedProps = pvm->result();
 
         extractMainProperties(qualifyProperties(TP_QT_IFACE_PROTOCOL, unqualifiedProps));
 
-        introspectInterfaces();
+        if (!mInterfacesIntrospected) {
+            introspectInterfaces();
+        }
     } else {
-        warning().nospace() <<
+        TP_QT_WARNING().nospace() <<
             "Properties.GetAll(Protocol) failed: " <<
             op->errorName() << ": " << op->errorMessage();
-        warning() << "  Full functionality requires CM support for the Protocol interface";
+        TP_QT_WARNING() << "  Full functionality requires CM support for the Protocol interface";
     }
 
+    --mPendingIntrospections;
     continueIntrospection();
 }
 
@@ -273,19 +287,20 @@ void ConnectionManager::Private::ProtocolWrapper::gotAvatarsProperties(
         Tp::PendingOperation *op)
 {
     if (!op->isError()) {
-        debug() << "Got reply to Properties.GetAll(Protocol.Avatars)";
+        TP_QT_DEBUG() << "Got reply to Properties.GetAll(Protocol.Avatars)";
         PendingVariantMap *pvm = qobject_cast<PendingVariantMap*>(op);
         QVariantMap unqualifiedProps = pvm->result();
 
         extractAvatarsProperties(qualifyProperties(TP_QT_IFACE_PROTOCOL_INTERFACE_AVATARS,
                     unqualifiedProps));
     } else {
-        warning().nospace() <<
+        TP_QT_WARNING().nospace() <<
             "Properties.GetAll(Protocol.Avatars) failed: " <<
             op->errorName() << ": " << op->errorMessage();
-        warning() << "  Full functionality requires CM support for the Protocol.Avatars interface";
+        TP_QT_WARNING() << "  Full functionality requires CM support for the Protocol.Avatars interface";
     }
 
+    --mPendingIntrospections;
     continueIntrospection();
 }
 
@@ -293,19 +308,20 @@ void ConnectionManager::Private::ProtocolWrapper::gotPresenceProperties(
         Tp::PendingOperation *op)
 {
     if (!op->isError()) {
-        debug() << "Got reply to Properties.GetAll(Protocol.Presence)";
+        TP_QT_DEBUG() << "Got reply to Properties.GetAll(Protocol.Presence)";
         PendingVariantMap *pvm = qobject_cast<PendingVariantMap*>(op);
         QVariantMap unqualifiedProps = pvm->result();
 
         extractPresenceProperties(qualifyProperties(TP_QT_IFACE_PROTOCOL_INTERFACE_PRESENCE,
                     unqualifiedProps));
     } else {
-        warning().nospace() <<
+        TP_QT_WARNING().nospace() <<
             "Properties.GetAll(Protocol.Presence) failed: " <<
             op->errorName() << ": " << op->errorMessage();
-        warning() << "  Full functionality requires CM support for the Protocol.Presence interface";
+        TP_QT_WARNING() << "  Full functionality requires CM support for the Protocol.Presence interface";
     }
 
+    --mPendingIntrospections;
     continueIntrospection();
 }
 
@@ -315,19 +331,20 @@ void ConnectionManager::Private::ProtocolWrapper::gotAddressingProperties(
     QVariantMap unqualifiedProps;
 
     if (!op->isError()) {
-        debug() << "Got reply to Properties.GetAll(Protocol.Addressing)";
+        TP_QT_DEBUG() << "Got reply to Properties.GetAll(Protocol.Addressing)";
         PendingVariantMap *pvm = qobject_cast<PendingVariantMap*>(op);
         QVariantMap unqualifiedProps = pvm->result();
 
         extractAddressingProperties(qualifyProperties(TP_QT_IFACE_PROTOCOL_INTERFACE_ADDRESSING,
                     unqualifiedProps));
     } else {
-        warning().nospace() <<
+        TP_QT_WARNING().nospace() <<
             "Properties.GetAll(Protocol.Addressing) failed: " <<
             op->errorName() << ": " << op->errorMessage();
-        warning() << "  Full functionality requires CM support for the Protocol.Addressing interface";
+        TP_QT_WARNING() << "  Full functionality requires CM support for the Protocol.Addressing interface";
     }
 
+    --mPendingIntrospections;
     continueIntrospection();
 }
 
@@ -532,14 +549,14 @@ ConnectionManager::Private::Private(ConnectionManager *parent, const QString &na
       chanFactory(chanFactory),
       contactFactory(contactFactory)
 {
-    debug() << "Creating new ConnectionManager:" << parent->busName();
+    TP_QT_DEBUG() << "Creating new ConnectionManager:" << parent->busName();
 
     if (connFactory->dbusConnection().name() != parent->dbusConnection().name()) {
-        warning() << "  The D-Bus connection in the connection factory is not the proxy connection";
+        TP_QT_WARNING() << "  The D-Bus connection in the connection factory is not the proxy connection";
     }
 
     if (chanFactory->dbusConnection().name() != parent->dbusConnection().name()) {
-        warning() << "  The D-Bus connection in the channel factory is not the proxy connection";
+        TP_QT_WARNING() << "  The D-Bus connection in the channel factory is not the proxy connection";
     }
 
     ReadinessHelper::Introspectables introspectables;
@@ -597,10 +614,10 @@ void ConnectionManager::Private::introspectMain(ConnectionManager::Private *self
         return;
     }
 
-    warning() << "Error parsing config file for connection manager"
+    TP_QT_WARNING() << "Error parsing config file for connection manager"
         << self->name << "- introspecting";
 
-    debug() << "Calling Properties::GetAll(ConnectionManager)";
+    TP_QT_DEBUG() << "Calling Properties::GetAll(ConnectionManager)";
     PendingVariantMap *pvm = self->baseInterface->requestAllProperties();
     self->parent->connect(pvm,
             SIGNAL(finished(Tp::PendingOperation*)),
@@ -609,7 +626,7 @@ void ConnectionManager::Private::introspectMain(ConnectionManager::Private *self
 
 void ConnectionManager::Private::introspectProtocolsLegacy()
 {
-    debug() << "Calling ConnectionManager::ListProtocols";
+    TP_QT_DEBUG() << "Calling ConnectionManager::ListProtocols";
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(
             baseInterface->ListProtocols(), parent);
     parent->connect(watcher,
@@ -620,7 +637,7 @@ void ConnectionManager::Private::introspectProtocolsLegacy()
 void ConnectionManager::Private::introspectParametersLegacy()
 {
     foreach (const QString &protocolName, parametersQueue) {
-        debug() << "Calling ConnectionManager::GetParameters(" << protocolName << ")";
+        TP_QT_DEBUG() << "Calling ConnectionManager::GetParameters(" << protocolName << ")";
         QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(
                 baseInterface->GetParameters(protocolName), parent);
         parent->connect(watcher,
@@ -668,6 +685,112 @@ ConnectionManagerPtr ConnectionManagerLowlevel::connectionManager() const
     return ConnectionManagerPtr(mPriv->cm);
 }
 
+QHash<QString, ConnectionManagerRegistry*> ConnectionManagerRegistry::registries;
+
+ConnectionManagerRegistry *ConnectionManagerRegistry::forConnection(const QDBusConnection &bus)
+{
+    ConnectionManagerRegistry *registry = registries.value(bus.name());
+    if (!registry) {
+        registry = new ConnectionManagerRegistry(bus);
+        registries.insert(bus.name(), registry);
+    }
+    return registry;
+}
+
+ConnectionManagerRegistry::ConnectionManagerRegistry(const QDBusConnection &bus)
+    : QObject(),
+      mBus(bus),
+      mWatcher(new QDBusServiceWatcher(this))
+{
+    mWatcher->setConnection(bus);
+    mWatcher->setWatchMode(QDBusServiceWatcher::WatchForOwnerChange);
+    connect(mWatcher,
+            SIGNAL(serviceOwnerChanged(QString,QString,QString)),
+            SLOT(onServiceOwnerChanged(QString,QString,QString)));
+}
+
+ConnectionManagerRegistry::~ConnectionManagerRegistry()
+{
+}
+
+ConnectionManagerPtr ConnectionManagerRegistry::connectionManager(const QString &name,
+        const ConnectionFactoryConstPtr &connFactory,
+        const ChannelFactoryConstPtr &chanFactory,
+        const ContactFactoryConstPtr &contactFactory)
+{
+    removeExpired();
+
+    ConnectionManagerPtr cm = ConnectionManagerPtr(mCMs.value(name));
+    // A CM whose introspection failed is not shared, so that the next user
+    // gets a chance to retry
+    if (cm && !cm->missingFeatures().contains(ConnectionManager::FeatureCore)) {
+        return cm;
+    }
+
+    cm = ConnectionManager::create(mBus, name, connFactory, chanFactory, contactFactory);
+    if (!mCMs.contains(name)) {
+        mWatcher->addWatchedService(
+                QString(TP_QT_CONNECTION_MANAGER_BUS_NAME_BASE).append(name));
+    }
+    mCMs.insert(name, WeakPtr<ConnectionManager>(cm));
+    connect(cm.data(),
+            SIGNAL(invalidated(Tp::DBusProxy*,QString,QString)),
+            SLOT(onConnectionManagerInvalidated(Tp::DBusProxy*)));
+    return cm;
+}
+
+void ConnectionManagerRegistry::remove(const QString &name)
+{
+    if (mCMs.remove(name)) {
+        mWatcher->removeWatchedService(
+                QString(TP_QT_CONNECTION_MANAGER_BUS_NAME_BASE).append(name));
+    }
+}
+
+void ConnectionManagerRegistry::removeExpired()
+{
+    // Drop the entries of the CMs that are not used anymore, along with their
+    // bus name watches
+    QHash<QString, WeakPtr<ConnectionManager> >::iterator i = mCMs.begin();
+    while (i != mCMs.end()) {
+        if (i.value().isNull()) {
+            mWatcher->removeWatchedService(
+                    QString(TP_QT_CONNECTION_MANAGER_BUS_NAME_BASE).append(i.key()));
+            i = mCMs.erase(i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+void ConnectionManagerRegistry::onServiceOwnerChanged(const QString &busName,
+        const QString &oldOwner, const QString &newOwner)
+{
+    Q_UNUSED(oldOwner);
+    Q_UNUSED(newOwner);
+
+    QString name = busName.mid(TP_QT_CONNECTION_MANAGER_BUS_NAME_BASE.size());
+    if (mCMs.contains(name)) {
+        TP_QT_DEBUG() << "Connection manager" << name << "changed owner, dropping shared instance";
+        remove(name);
+    }
+}
+
+void ConnectionManagerRegistry::onConnectionManagerInvalidated(DBusProxy *proxy)
+{
+    // only drop the entry if it still refers to the invalidated instance, and
+    // not to a newer one created after a failed introspection
+    QHash<QString, WeakPtr<ConnectionManager> >::const_iterator i = mCMs.constBegin();
+    for (; i != mCMs.constEnd(); ++i) {
+        if (ConnectionManagerPtr(i.value()).data() == proxy) {
+            QString name = i.key();
+            TP_QT_DEBUG() << "Connection manager" << name << "invalidated, dropping shared instance";
+            remove(name);
+            return;
+        }
+    }
+}
+
 /**
  * \class ConnectionManager
  * \ingroup clientcm
@@ -989,7 +1112,7 @@ void ConnectionManager::gotMainProperties(Tp::PendingOperation *op)
     QVariantMap props;
 
     if (!op->isError()) {
-        debug() << "Got reply to Properties.GetAll(ConnectionManager)";
+        TP_QT_DEBUG() << "Got reply to Properties.GetAll(ConnectionManager)";
         PendingVariantMap *pvm = qobject_cast<PendingVariantMap*>(op);
 
         props = pvm->result();
@@ -1001,7 +1124,7 @@ void ConnectionManager::gotMainProperties(Tp::PendingOperation *op)
             mPriv->readinessHelper->setInterfaces(interfaces());
         }
     } else {
-        warning().nospace() <<
+        TP_QT_WARNING().nospace() <<
             "Properties.GetAll(ConnectionManager) failed: " <<
             op->errorName() << ": " << op->errorMessage();
 
@@ -1018,7 +1141,7 @@ void ConnectionManager::gotMainProperties(Tp::PendingOperation *op)
         while (i != end) {
             QString protocolName = i.key();
             if (!checkValidProtocolName(protocolName)) {
-                warning() << "Protocol has an invalid name" << protocolName << "- ignoring";
+                TP_QT_WARNING() << "Protocol has an invalid name" << protocolName << "- ignoring";
                 continue;
             }
 
@@ -1046,7 +1169,7 @@ void ConnectionManager::gotProtocolsLegacy(QDBusPendingCallWatcher *watcher)
     QStringList protocolsNames;
 
     if (!reply.isError()) {
-        debug() << "Got reply to ConnectionManager.ListProtocols";
+        TP_QT_DEBUG() << "Got reply to ConnectionManager.ListProtocols";
         protocolsNames = reply.value();
 
         if (!protocolsNames.isEmpty()) {
@@ -1063,7 +1186,7 @@ void ConnectionManager::gotProtocolsLegacy(QDBusPendingCallWatcher *watcher)
     } else {
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, false, reply.error());
 
-        warning().nospace() <<
+        TP_QT_WARNING().nospace() <<
             "ConnectionManager.ListProtocols failed: " <<
             reply.error().name() << ": " << reply.error().message();
 
@@ -1090,11 +1213,11 @@ void ConnectionManager::gotParametersLegacy(QDBusPendingCallWatcher *watcher)
     Q_UNUSED(found);
 
     if (!reply.isError()) {
-        debug() << QString(QLatin1String("Got reply to ConnectionManager.GetParameters(%1)")).arg(protocolName);
+        TP_QT_DEBUG() << QString(QLatin1String("Got reply to ConnectionManager.GetParameters(%1)")).arg(protocolName);
         ParamSpecList parameters = reply.value();
         ProtocolInfo &info = mPriv->protocols[pos];
         foreach (const ParamSpec &spec, parameters) {
-            debug() << "Parameter" << spec.name << "has flags" << spec.flags
+            TP_QT_DEBUG() << "Parameter" << spec.name << "has flags" << spec.flags
                 << "and signature" << spec.signature;
 
             info.addParameter(spec);
@@ -1103,7 +1226,7 @@ void ConnectionManager::gotParametersLegacy(QDBusPendingCallWatcher *watcher)
         // let's remove this protocol as we can't get the params
         mPriv->protocols.removeAt(pos);
 
-        warning().nospace() <<
+        TP_QT_WARNING().nospace() <<
             QString(QLatin1String("ConnectionManager.GetParameters(%1) failed: ")).arg(protocolName) <<
             reply.error().name() << ": " << reply.error().message();
     }
@@ -1132,7 +1255,7 @@ void ConnectionManager::onProtocolReady(Tp::PendingOperation *op)
     if (!op->isError()) {
         mPriv->protocols.append(info);
     } else {
-        warning().nospace() << "Protocol(" << info.name() << ")::becomeReady "
+        TP_QT_WARNING().nospace() << "Protocol(" << info.name() << ")::becomeReady "
             "failed: " << op->errorName() << ": " << op->errorMessage();
     }
 
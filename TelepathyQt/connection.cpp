@@ -222,7 +222,7 @@ Connection::Private::Private(Connection *parent,
     Q_ASSERT(properties != nullptr);
 
     if (chanFactory->dbusConnection().name() != parent->dbusConnection().name()) {
-        warning() << "  The D-Bus connection in the channel factory is not the proxy connection";
+        TP_QT_WARNING() << "  The D-Bus connection in the channel factory is not the proxy connection";
     }
 
     init();
@@ -309,7 +309,7 @@ Connection::Private::Private(Connection *parent,
         cmName = rx.cap(1);
         protocolName = rx.cap(2);
     } else {
-        warning() << "Connection object path is not spec-compliant, "
+        TP_QT_WARNING() << "Connection object path is not spec-compliant, "
             "trying again with a different account-specific part check";
 
         rx = QRegExp(QLatin1String("^") + TP_QT_CONNECTION_OBJECT_PATH_BASE + QLatin1String(
@@ -321,7 +321,7 @@ Connection::Private::Private(Connection *parent,
             cmName = rx.cap(1);
             protocolName = rx.cap(2);
         } else {
-            warning() << "Not a valid Connection object path:" <<
+            TP_QT_WARNING() << "Not a valid Connection object path:" <<
                 parent->objectPath();
         }
     }
@@ -339,19 +339,19 @@ Connection::Private::~Private()
     // All handle contexts locked, so safe
     if (!--handleContext->refcount) {
         if (!immortalHandles) {
-            debug() << "Destroying HandleContext";
+            TP_QT_DEBUG() << "Destroying HandleContext";
 
             foreach (uint handleType, handleContext->types.keys()) {
                 HandleContext::Type type = handleContext->types[handleType];
 
                 if (!type.refcounts.empty()) {
-                    debug() << " Still had references to" <<
+                    TP_QT_DEBUG() << " Still had references to" <<
                         type.refcounts.size() << "handles, releasing now";
                     baseInterface->ReleaseHandles(handleType, type.refcounts.keys());
                 }
 
                 if (!type.toRelease.empty()) {
-                    debug() << " Was going to release" <<
+                    TP_QT_DEBUG() << " Was going to release" <<
                         type.toRelease.size() << "handles, doing that now";
                     baseInterface->ReleaseHandles(handleType, type.toRelease.toList());
                 }
@@ -369,15 +369,15 @@ Connection::Private::~Private()
 
 void Connection::Private::init()
 {
-    debug() << "Connecting to ConnectionError()";
+    TP_QT_DEBUG() << "Connecting to ConnectionError()";
     parent->connect(baseInterface,
             SIGNAL(ConnectionError(QString,QVariantMap)),
             SLOT(onConnectionError(QString,QVariantMap)));
-    debug() << "Connecting to StatusChanged()";
+    TP_QT_DEBUG() << "Connecting to StatusChanged()";
     parent->connect(baseInterface,
             SIGNAL(StatusChanged(uint,uint)),
             SLOT(onStatusChanged(uint,uint)));
-    debug() << "Connecting to SelfHandleChanged()";
+    TP_QT_DEBUG() << "Connecting to SelfHandleChanged()";
     parent->connect(baseInterface,
             SIGNAL(SelfHandleChanged(uint)),
             SLOT(onSelfHandleChanged(uint)));
@@ -386,11 +386,11 @@ void Connection::Private::init()
     QString busConnectionName = baseInterface->connection().name();
 
     if (handleContexts.contains(qMakePair(busConnectionName, parent->objectPath()))) {
-        debug() << "Reusing existing HandleContext for" << parent->objectPath();
+        TP_QT_DEBUG() << "Reusing existing HandleContext for" << parent->objectPath();
         handleContext = handleContexts[
             qMakePair(busConnectionName, parent->objectPath())];
     } else {
-        debug() << "Creating new HandleContext for" << parent->objectPath();
+        TP_QT_DEBUG() << "Creating new HandleContext for" << parent->objectPath();
         handleContext = new HandleContext;
         handleContexts[
             qMakePair(busConnectionName, parent->objectPath())] = handleContext;
@@ -402,7 +402,7 @@ void Connection::Private::init()
 
 void Connection::Private::introspectMain(Connection::Private *self)
 {
-    debug() << "Calling Properties::GetAll(Connection)";
+    TP_QT_DEBUG() << "Calling Properties::GetAll(Connection)";
     QDBusPendingCallWatcher *watcher =
         new QDBusPendingCallWatcher(
                 self->properties->GetAll(TP_QT_IFACE_CONNECTION),
@@ -414,7 +414,7 @@ void Connection::Private::introspectMain(Connection::Private *self)
 
 void Connection::Private::introspectMainFallbackStatus()
 {
-    debug() << "Calling GetStatus()";
+    TP_QT_DEBUG() << "Calling GetStatus()";
     QDBusPendingCallWatcher *watcher =
         new QDBusPendingCallWatcher(baseInterface->GetStatus(),
                 parent);
@@ -425,7 +425,7 @@ void Connection::Private::introspectMainFallbackStatus()
 
 void Connection::Private::introspectMainFallbackInterfaces()
 {
-    debug() << "Calling GetInterfaces()";
+    TP_QT_DEBUG() << "Calling GetInterfaces()";
     QDBusPendingCallWatcher *watcher =
         new QDBusPendingCallWatcher(baseInterface->GetInterfaces(),
                 parent);
@@ -436,7 +436,7 @@ void Connection::Private::introspectMainFallbackInterfaces()
 
 void Connection::Private::introspectMainFallbackSelfHandle()
 {
-    debug() << "Calling GetSelfHandle()";
+    TP_QT_DEBUG() << "Calling GetSelfHandle()";
     QDBusPendingCallWatcher *watcher =
         new QDBusPendingCallWatcher(baseInterface->GetSelfHandle(),
                 parent);
@@ -447,7 +447,7 @@ void Connection::Private::introspectMainFallbackSelfHandle()
 
 void Connection::Private::introspectCapabilities()
 {
-    debug() << "Retrieving capabilities";
+    TP_QT_DEBUG() << "Retrieving capabilities";
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(
             properties->Get(
                 TP_QT_IFACE_CONNECTION_INTERFACE_REQUESTS,
@@ -459,7 +459,7 @@ void Connection::Private::introspectCapabilities()
 
 void Connection::Private::introspectContactAttributeInterfaces()
 {
-    debug() << "Retrieving contact attribute interfaces";
+    TP_QT_DEBUG() << "Retrieving contact attribute interfaces";
     QDBusPendingCall call =
         properties->Get(
                 TP_QT_IFACE_CONNECTION_INTERFACE_CONTACTS,
@@ -473,7 +473,7 @@ void Connection::Private::introspectContactAttributeInterfaces()
 
 void Connection::Private::introspectSelfContact(Connection::Private *self)
 {
-    debug() << "Building self contact";
+    TP_QT_DEBUG() << "Building self contact";
 
     Q_ASSERT(!self->introspectingSelfContact);
 
@@ -491,7 +491,7 @@ void Connection::Private::introspectSimplePresence(Connection::Private *self)
 {
     Q_ASSERT(self->properties != nullptr);
 
-    debug() << "Calling Properties::Get("
+    TP_QT_DEBUG() << "Calling Properties::Get("
         "Connection.I.SimplePresence.Statuses)";
     QDBusPendingCall call =
         self->properties->GetAll(
@@ -505,7 +505,7 @@ void Connection::Private::introspectSimplePresence(Connection::Private *self)
 
 void Connection::Private::introspectRoster(Connection::Private *self)
 {
-    debug() << "Introspecting roster";
+    TP_QT_DEBUG() << "Introspecting roster";
 
     PendingOperation *op = self->contactManager->introspectRoster();
     self->parent->connect(op,
@@ -515,7 +515,7 @@ void Connection::Private::introspectRoster(Connection::Private *self)
 
 void Connection::Private::introspectRosterGroups(Connection::Private *self)
 {
-    debug() << "Introspecting roster groups";
+    TP_QT_DEBUG() << "Introspecting roster groups";
 
     PendingOperation *op = self->contactManager->introspectRosterGroups();
     self->parent->connect(op,
@@ -525,19 +525,19 @@ void Connection::Private::introspectRosterGroups(Connection::Private *self)
 
 void Connection::Private::introspectBalance(Connection::Private *self)
 {
-    debug() << "Introspecting balance";
+    TP_QT_DEBUG() << "Introspecting balance";
 
     // we already checked if balance interface exists, so bypass requests
     // interface checking
     Client::ConnectionInterfaceBalanceInterface *iface =
         self->parent->interface<Client::ConnectionInterfaceBalanceInterface>();
 
-    debug() << "Connecting to Balance.BalanceChanged";
+    TP_QT_DEBUG() << "Connecting to Balance.BalanceChanged";
     self->parent->connect(iface,
             SIGNAL(BalanceChanged(Tp::CurrencyAmount)),
             SLOT(onBalanceChanged(Tp::CurrencyAmount)));
 
-    debug() << "Retrieving balance";
+    TP_QT_DEBUG() << "Retrieving balance";
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(
             self->properties->Get(
                 TP_QT_IFACE_CONNECTION_INTERFACE_BALANCE,
@@ -561,7 +561,7 @@ void Connection::Private::introspectConnected(Connection::Private *self)
 void Connection::Private::continueMainIntrospection()
 {
     if (!parent->isValid()) {
-        debug() << parent << "stopping main introspection, as it has been invalidated";
+        TP_QT_DEBUG() << parent << "stopping main introspection, as it has been invalidated";
         return;
     }
 
@@ -586,7 +586,7 @@ void Connection::Private::setCurrentStatus(uint status)
     if (introspectingConnected) {
         // On the other hand, we have to finish the Connected introspection for now, as
         // ReadinessHelper would otherwise wait indefinitely for it to land
-        debug() << "Finishing FeatureConnected for status" << this->status <<
+        TP_QT_DEBUG() << "Finishing FeatureConnected for status" << this->status <<
             "to allow ReadinessHelper to introspect new status" << status;
         readinessHelper->setIntrospectCompleted(FeatureConnected, true);
         introspectingConnected = false;
@@ -599,7 +599,7 @@ void Connection::Private::forceCurrentStatus(uint status)
 {
     // only update the status if we did not get it from StatusChanged
     if (pendingStatus == (uint) -1) {
-        debug() << "Got status:" << status;
+        TP_QT_DEBUG() << "Got status:" << status;
         pendingStatus = status;
         // No need to re-run introspection as we just received the status. Let
         // the introspection continue normally but update readinessHelper with
@@ -610,7 +610,7 @@ void Connection::Private::forceCurrentStatus(uint status)
 
 void Connection::Private::setInterfaces(const QStringList &interfaces)
 {
-    debug() << "Got interfaces:" << interfaces;
+    TP_QT_DEBUG() << "Got interfaces:" << interfaces;
     parent->setInterfaces(interfaces);
     readinessHelper->setInterfaces(interfaces);
 }
@@ -678,7 +678,7 @@ void Connection::PendingConnect::onConnectReply(QDBusPendingCallWatcher *watcher
     ConnectionPtr connection = ConnectionPtr::qObjectCast(proxy());
 
     if (watcher->isError()) {
-        debug() << "Connect failed with" <<
+        TP_QT_DEBUG() << "Connect failed with" <<
             watcher->error().name() << ": " << watcher->error().message();
         setFinishedWithError(watcher->error());
         connection->disconnect(
@@ -710,7 +710,7 @@ void Connection::PendingConnect::onStatusChanged(ConnectionStatus newStatus)
     ConnectionPtr connection = ConnectionPtr::qObjectCast(proxy());
 
     if (newStatus == ConnectionStatusDisconnected) {
-        debug() << "Connection became disconnected while a PendingConnect was underway";
+        TP_QT_DEBUG() << "Connection became disconnected while a PendingConnect was underway";
         setFinishedWithError(connection->invalidationReason(), connection->invalidationMessage());
 
         connection->disconnect(this,
@@ -739,16 +739,16 @@ void Connection::PendingConnect::onBecomeReadyReply(Tp::PendingOperation *op)
             SLOT(onConnInvalidated(Tp::DBusProxy*,QString,QString)));
 
     if (op->isError()) {
-        debug() << "Connection->becomeReady failed with" <<
+        TP_QT_DEBUG() << "Connection->becomeReady failed with" <<
             op->errorName() << ": " << op->errorMessage();
         setFinishedWithError(op->errorName(), op->errorMessage());
     } else {
-        debug() << "Connected";
+        TP_QT_DEBUG() << "Connected";
 
         if (connection->isValid()) {
             setFinished();
         } else {
-            debug() << "  ... but the Connection was immediately invalidated!";
+            TP_QT_DEBUG() << "  ... but the Connection was immediately invalidated!";
             setFinishedWithError(connection->invalidationReason(), connection->invalidationMessage());
         }
     }
@@ -762,7 +762,7 @@ void Connection::PendingConnect::onConnInvalidated(Tp::DBusProxy *proxy, const Q
     Q_ASSERT(proxy == connection.data());
 
     if (!isFinished()) {
-        debug() << "Unable to connect. Connection invalidated";
+        TP_QT_DEBUG() << "Unable to connect. Connection invalidated";
         setFinishedWithError(error, message);
     }
 
@@ -1257,7 +1257,7 @@ QVariantMap Connection::ErrorDetails::allDetails() const
 const Connection::ErrorDetails &Connection::errorDetails() const
 {
     if (isValid()) {
-        warning() << "Connection::errorDetails() used on" << objectPath() << "which is valid";
+        TP_QT_WARNING() << "Connection::errorDetails() used on" << objectPath() << "which is valid";
     }
 
     return mPriv->errorDetails;
@@ -1295,14 +1295,14 @@ uint Connection::selfHandle() const
 SimpleStatusSpecMap ConnectionLowlevel::allowedPresenceStatuses() const
 {
     if (!isValid()) {
-        warning() << "ConnectionLowlevel::selfHandle() "
+        TP_QT_WARNING() << "ConnectionLowlevel::selfHandle() "
             "called for a connection which is already destroyed";
         return SimpleStatusSpecMap();
     }
 
     ConnectionPtr conn(connection());
     if (!conn->isReady(Connection::FeatureSimplePresence)) {
-        warning() << "Trying to retrieve allowed presence statuses from connection, but "
+        TP_QT_WARNING() << "Trying to retrieve allowed presence statuses from connection, but "
                      "simple presence is not supported or was not requested. "
                      "Enable FeatureSimplePresence in this connection";
     }
@@ -1324,14 +1324,14 @@ SimpleStatusSpecMap ConnectionLowlevel::allowedPresenceStatuses() const
 uint ConnectionLowlevel::maxPresenceStatusMessageLength() const
 {
     if (!isValid()) {
-        warning() << "ConnectionLowlevel::maxPresenceStatusMessageLength() "
+        TP_QT_WARNING() << "ConnectionLowlevel::maxPresenceStatusMessageLength() "
             "called for a connection which is already destroyed";
         return 0;
     }
 
     ConnectionPtr conn(connection());
     if (!conn->isReady(Connection::FeatureSimplePresence)) {
-        warning() << "Trying to retrieve max presence status message length connection, but "
+        TP_QT_WARNING() << "Trying to retrieve max presence status message length connection, but "
                      "simple presence is not supported or was not requested. "
                      "Enable FeatureSimplePresence in this connection";
     }
@@ -1362,7 +1362,7 @@ PendingOperation *ConnectionLowlevel::setSelfPresence(const QString &status,
         const QString &statusMessage)
 {
     if (!isValid()) {
-        warning() << "ConnectionLowlevel::selfHandle() called for a connection which is already destroyed";
+        TP_QT_WARNING() << "ConnectionLowlevel::selfHandle() called for a connection which is already destroyed";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE, QLatin1String("Connection already destroyed"),
                 ConnectionPtr());
     }
@@ -1395,7 +1395,7 @@ PendingOperation *ConnectionLowlevel::setSelfPresence(const QString &status,
 ContactPtr Connection::selfContact() const
 {
     if (!isReady(FeatureSelfContact)) {
-        warning() << "Connection::selfContact() used, but becomeReady(FeatureSelfContact) "
+        TP_QT_WARNING() << "Connection::selfContact() used, but becomeReady(FeatureSelfContact) "
             "hasn't been completed!";
     }
 
@@ -1418,7 +1418,7 @@ ContactPtr Connection::selfContact() const
 CurrencyAmount Connection::accountBalance() const
 {
     if (!isReady(FeatureAccountBalance)) {
-        warning() << "Connection::accountBalance() used before connection "
+        TP_QT_WARNING() << "Connection::accountBalance() used before connection "
             "FeatureAccountBalance is ready";
     }
 
@@ -1440,7 +1440,7 @@ CurrencyAmount Connection::accountBalance() const
 ConnectionCapabilities Connection::capabilities() const
 {
     if (!isReady(Connection::FeatureCore)) {
-        warning() << "Connection::capabilities() used before connection "
+        TP_QT_WARNING() << "Connection::capabilities() used before connection "
             "FeatureCore is ready";
     }
 
@@ -1461,17 +1461,17 @@ void Connection::onStatusReady(uint status)
     if (isValid()) {
         emit statusChanged((ConnectionStatus) mPriv->status);
     } else {
-        debug() << this << " not emitting statusChanged because it has been invalidated";
+        TP_QT_DEBUG() << this << " not emitting statusChanged because it has been invalidated";
     }
 }
 
 void Connection::onStatusChanged(uint status, uint reason)
 {
-    debug() << "StatusChanged from" << mPriv->pendingStatus
+    TP_QT_DEBUG() << "StatusChanged from" << mPriv->pendingStatus
             << "to" << status << "with reason" << reason;
 
     if (mPriv->pendingStatus == status) {
-        warning() << "New status was the same as the old status! Ignoring"
+        TP_QT_WARNING() << "New status was the same as the old status! Ignoring"
             "redundant StatusChanged";
         return;
     }
@@ -1482,7 +1482,7 @@ void Connection::onStatusChanged(uint status, uint reason)
 
     switch (status) {
         case ConnectionStatusConnected:
-            debug() << "Performing introspection for the Connected status";
+            TP_QT_DEBUG() << "Performing introspection for the Connected status";
             mPriv->setCurrentStatus(status);
             break;
 
@@ -1508,7 +1508,7 @@ void Connection::onStatusChanged(uint status, uint reason)
             break;
 
         default:
-            warning() << "Unknown connection status" << status;
+            TP_QT_WARNING() << "Unknown connection status" << status;
             break;
     }
 }
@@ -1516,7 +1516,7 @@ void Connection::onStatusChanged(uint status, uint reason)
 void Connection::onConnectionError(const QString &error,
         const QVariantMap &details)
 {
-    debug().nospace() << "Connection(" << objectPath() << ") got ConnectionError(" << error
+    TP_QT_DEBUG().nospace() << "Connection(" << objectPath() << ") got ConnectionError(" << error
         << ") with " << details.size() << " details";
 
     mPriv->errorDetails = details;
@@ -1532,7 +1532,7 @@ void Connection::gotMainProperties(QDBusPendingCallWatcher *watcher)
     if (!reply.isError()) {
         props = reply.value();
     } else {
-        warning().nospace() << "Properties::GetAll(Connection) failed with " <<
+        TP_QT_WARNING().nospace() << "Properties::GetAll(Connection) failed with " <<
             reply.error().name() << ": " << reply.error().message();
         // let's try to fallback first before failing
     }
@@ -1594,7 +1594,7 @@ void Connection::gotStatus(QDBusPendingCallWatcher *watcher)
 
         mPriv->continueMainIntrospection();
     } else {
-        warning().nospace() << "GetStatus() failed with " <<
+        TP_QT_WARNING().nospace() << "GetStatus() failed with " <<
             reply.error().name() << ": " << reply.error().message();
         mPriv->invalidateResetCaps(reply.error().name(), reply.error().message());
     }
@@ -1610,7 +1610,7 @@ void Connection::gotInterfaces(QDBusPendingCallWatcher *watcher)
         mPriv->setInterfaces(reply.value());
     }
     else {
-        warning().nospace() << "GetInterfaces() failed with " <<
+        TP_QT_WARNING().nospace() << "GetInterfaces() failed with " <<
             reply.error().name() << ": " << reply.error().message() <<
             " - assuming no new interfaces";
         // let's not fail if GetInterfaces fail
@@ -1627,11 +1627,11 @@ void Connection::gotSelfHandle(QDBusPendingCallWatcher *watcher)
 
     if (!reply.isError()) {
         mPriv->selfHandle = reply.value();
-        debug() << "Got self handle:" << mPriv->selfHandle;
+        TP_QT_DEBUG() << "Got self handle:" << mPriv->selfHandle;
 
         mPriv->continueMainIntrospection();
     } else {
-        warning().nospace() << "GetSelfHandle() failed with " <<
+        TP_QT_WARNING().nospace() << "GetSelfHandle() failed with " <<
             reply.error().name() << ": " << reply.error().message();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore,
                 false, reply.error());
@@ -1645,11 +1645,11 @@ void Connection::gotCapabilities(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<QDBusVariant> reply = *watcher;
 
     if (!reply.isError()) {
-        debug() << "Got capabilities";
+        TP_QT_DEBUG() << "Got capabilities";
         mPriv->caps.updateRequestableChannelClasses(
                 qdbus_cast<RequestableChannelClassList>(reply.value().variant()));
     } else {
-        warning().nospace() << "Getting capabilities failed with " <<
+        TP_QT_WARNING().nospace() << "Getting capabilities failed with " <<
             reply.error().name() << ": " << reply.error().message();
         // let's not fail if retrieving capabilities fail
     }
@@ -1664,10 +1664,10 @@ void Connection::gotContactAttributeInterfaces(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<QDBusVariant> reply = *watcher;
 
     if (!reply.isError()) {
-        debug() << "Got contact attribute interfaces";
+        TP_QT_DEBUG() << "Got contact attribute interfaces";
         mPriv->contactAttributeInterfaces = qdbus_cast<QStringList>(reply.value().variant());
     } else {
-        warning().nospace() << "Getting contact attribute interfaces failed with " <<
+        TP_QT_WARNING().nospace() << "Getting contact attribute interfaces failed with " <<
             reply.error().name() << ": " << reply.error().message();
         // let's not fail if retrieving contact attribute interfaces fail
         // TODO should we remove Contacts interface from interfaces?
@@ -1690,14 +1690,14 @@ void Connection::gotSimpleStatuses(QDBusPendingCallWatcher *watcher)
         mPriv->maxPresenceStatusMessageLength = qdbus_cast<uint>(
                 props[QLatin1String("MaximumStatusMessageLength")]);
 
-        debug() << "Got" << mPriv->simplePresenceStatuses.size() <<
+        TP_QT_DEBUG() << "Got" << mPriv->simplePresenceStatuses.size() <<
             "simple presence statuses - max status message length is" <<
             mPriv->maxPresenceStatusMessageLength;
 
         mPriv->readinessHelper->setIntrospectCompleted(FeatureSimplePresence, true);
     }
     else {
-        warning().nospace() << "Getting simple presence statuses failed with " <<
+        TP_QT_WARNING().nospace() << "Getting simple presence statuses failed with " <<
             reply.error().name() << ":" << reply.error().message();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureSimplePresence, false, reply.error());
     }
@@ -1723,7 +1723,7 @@ void Connection::gotSelfContact(PendingOperation *op)
             emit selfContactChanged();
         }
     } else {
-        warning().nospace() << "Getting self contact failed with " <<
+        TP_QT_WARNING().nospace() << "Getting self contact failed with " <<
             pending->errorName() << ":" << pending->errorMessage();
 
         // check if the feature is already there, and for some reason introspectSelfContact
@@ -1749,28 +1749,28 @@ void Connection::gotSelfContact(PendingOperation *op)
 void Connection::onIntrospectRosterFinished(PendingOperation *op)
 {
     if (op->isError()) {
-        warning().nospace() << "Introspecting roster failed with " <<
+        TP_QT_WARNING().nospace() << "Introspecting roster failed with " <<
             op->errorName() << ": " << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureRoster, false,
                 op->errorName(), op->errorMessage());
         return;
     }
 
-    debug() << "Introspecting roster finished";
+    TP_QT_DEBUG() << "Introspecting roster finished";
     mPriv->readinessHelper->setIntrospectCompleted(FeatureRoster, true);
 }
 
 void Connection::onIntrospectRosterGroupsFinished(PendingOperation *op)
 {
     if (op->isError()) {
-        warning().nospace() << "Introspecting roster groups failed with " <<
+        TP_QT_WARNING().nospace() << "Introspecting roster groups failed with " <<
             op->errorName() << ": " << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureRosterGroups, false,
                 op->errorName(), op->errorMessage());
         return;
     }
 
-    debug() << "Introspecting roster groups finished";
+    TP_QT_DEBUG() << "Introspecting roster groups finished";
     mPriv->readinessHelper->setIntrospectCompleted(FeatureRosterGroups, true);
 }
 
@@ -1779,11 +1779,11 @@ void Connection::gotBalance(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<QVariant> reply = *watcher;
 
     if (!reply.isError()) {
-        debug() << "Got balance";
+        TP_QT_DEBUG() << "Got balance";
         mPriv->accountBalance = qdbus_cast<CurrencyAmount>(reply.value());
         mPriv->readinessHelper->setIntrospectCompleted(FeatureAccountBalance, true);
     } else {
-        warning().nospace() << "Getting balance failed with " <<
+        TP_QT_WARNING().nospace() << "Getting balance failed with " <<
             reply.error().name() << ":" << reply.error().message();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureAccountBalance, false,
                 reply.error().name(), reply.error().message());
@@ -1853,14 +1853,14 @@ PendingChannel *ConnectionLowlevel::createChannel(const QVariantMap &request,
 
     ConnectionPtr conn(connection());
     if (conn->mPriv->pendingStatus != ConnectionStatusConnected) {
-        warning() << "Calling createChannel with connection not yet connected";
+        TP_QT_WARNING() << "Calling createChannel with connection not yet connected";
         return new PendingChannel(conn,
                 TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Connection not yet connected"));
     }
 
     if (!conn->interfaces().contains(TP_QT_IFACE_CONNECTION_INTERFACE_REQUESTS)) {
-        warning() << "Requests interface is not support by this connection";
+        TP_QT_WARNING() << "Requests interface is not support by this connection";
         return new PendingChannel(conn,
                 TP_QT_ERROR_NOT_IMPLEMENTED,
                 QLatin1String("Connection does not support Requests Interface"));
@@ -1872,7 +1872,7 @@ PendingChannel *ConnectionLowlevel::createChannel(const QVariantMap &request,
                 QLatin1String("Invalid 'request' argument"));
     }
 
-    debug() << "Creating a Channel";
+    TP_QT_DEBUG() << "Creating a Channel";
     PendingChannel *channel = new PendingChannel(conn, request, true, timeout);
     return channel;
 }
@@ -1924,14 +1924,14 @@ PendingChannel *ConnectionLowlevel::ensureChannel(const QVariantMap &request,
 
     ConnectionPtr conn(connection());
     if (conn->mPriv->pendingStatus != ConnectionStatusConnected) {
-        warning() << "Calling ensureChannel with connection not yet connected";
+        TP_QT_WARNING() << "Calling ensureChannel with connection not yet connected";
         return new PendingChannel(conn,
                 TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Connection not yet connected"));
     }
 
     if (!conn->interfaces().contains(TP_QT_IFACE_CONNECTION_INTERFACE_REQUESTS)) {
-        warning() << "Requests interface is not support by this connection";
+        TP_QT_WARNING() << "Requests interface is not support by this connection";
         return new PendingChannel(conn,
                 TP_QT_ERROR_NOT_IMPLEMENTED,
                 QLatin1String("Connection does not support Requests Interface"));
@@ -1943,7 +1943,7 @@ PendingChannel *ConnectionLowlevel::ensureChannel(const QVariantMap &request,
                 QLatin1String("Invalid 'request' argument"));
     }
 
-    debug() << "Creating a Channel";
+    TP_QT_DEBUG() << "Creating a Channel";
     PendingChannel *channel = new PendingChannel(conn, request, false, timeout);
     return channel;
 }
@@ -1980,7 +1980,7 @@ PendingChannel *ConnectionLowlevel::ensureChannel(const QVariantMap &request,
  */
 PendingHandles *ConnectionLowlevel::requestHandles(HandleType handleType, const QStringList &names)
 {
-    debug() << "Request for" << names.length() << "handles of type" << handleType;
+    TP_QT_DEBUG() << "Request for" << names.length() << "handles of type" << handleType;
 
     if (!isValid()) {
         return new PendingHandles(TP_QT_ERROR_NOT_AVAILABLE,
@@ -2032,7 +2032,7 @@ PendingHandles *ConnectionLowlevel::requestHandles(HandleType handleType, const
  */
 PendingHandles *ConnectionLowlevel::referenceHandles(HandleType handleType, const UIntList &handles)
 {
-    debug() << "Reference of" << handles.length() << "handles of type" << handleType;
+    TP_QT_DEBUG() << "Reference of" << handles.length() << "handles of type" << handleType;
 
     if (!isValid()) {
         return new PendingHandles(TP_QT_ERROR_NOT_AVAILABLE,
@@ -2056,7 +2056,7 @@ PendingHandles *ConnectionLowlevel::referenceHandles(HandleType handleType, cons
             }
         }
 
-        debug() << " Already holding" << alreadyHeld.size() <<
+        TP_QT_DEBUG() << " Already holding" << alreadyHeld.size() <<
             "of the handles -" << notYetHeld.size() << "to go";
     } else {
         alreadyHeld = handles;
@@ -2160,7 +2160,7 @@ PendingOperation *ConnectionLowlevel::requestDisconnect()
 PendingContactAttributes *ConnectionLowlevel::contactAttributes(const UIntList &handles,
         const QStringList &interfaces, bool reference)
 {
-    debug() << "Request for attributes for" << handles.size() << "contacts";
+    TP_QT_DEBUG() << "Request for attributes for" << handles.size() << "contacts";
 
     if (!isValid()) {
         PendingContactAttributes *pending = new PendingContactAttributes(ConnectionPtr(),
@@ -2175,17 +2175,17 @@ PendingContactAttributes *ConnectionLowlevel::contactAttributes(const UIntList &
         new PendingContactAttributes(conn,
                 handles, interfaces, reference);
     if (!conn->isReady(Connection::FeatureCore)) {
-        warning() << "ConnectionLowlevel::contactAttributes() used when not ready";
+        TP_QT_WARNING() << "ConnectionLowlevel::contactAttributes() used when not ready";
         pending->failImmediately(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("The connection isn't ready"));
         return pending;
     } else if (conn->mPriv->pendingStatus != ConnectionStatusConnected) {
-        warning() << "ConnectionLowlevel::contactAttributes() used with status" << conn->status() << "!= ConnectionStatusConnected";
+        TP_QT_WARNING() << "ConnectionLowlevel::contactAttributes() used with status" << conn->status() << "!= ConnectionStatusConnected";
         pending->failImmediately(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("The connection isn't Connected"));
         return pending;
     } else if (!conn->interfaces().contains(TP_QT_IFACE_CONNECTION_INTERFACE_CONTACTS)) {
-        warning() << "ConnectionLowlevel::contactAttributes() used without the remote object supporting"
+        TP_QT_WARNING() << "ConnectionLowlevel::contactAttributes() used without the remote object supporting"
                   << "the Contacts interface";
         pending->failImmediately(TP_QT_ERROR_NOT_IMPLEMENTED,
                 QLatin1String("The connection doesn't support the Contacts interface"));
@@ -2211,16 +2211,16 @@ PendingContactAttributes *ConnectionLowlevel::contactAttributes(const UIntList &
 QStringList ConnectionLowlevel::contactAttributeInterfaces() const
 {
     if (!isValid()) {
-        warning() << "ConnectionLowlevel::contactAttributeInterfaces() called for a destroyed Connection";
+        TP_QT_WARNING() << "ConnectionLowlevel::contactAttributeInterfaces() called for a destroyed Connection";
         return QStringList();
     }
 
     ConnectionPtr conn(connection());
     if (conn->mPriv->pendingStatus != ConnectionStatusConnected) {
-        warning() << "ConnectionLowlevel::contactAttributeInterfaces() used with status"
+        TP_QT_WARNING() << "ConnectionLowlevel::contactAttributeInterfaces() used with status"
             << conn->status() << "!= ConnectionStatusConnected";
     } else if (!conn->interfaces().contains(TP_QT_IFACE_CONNECTION_INTERFACE_CONTACTS)) {
-        warning() << "ConnectionLowlevel::contactAttributeInterfaces() used without the remote object supporting"
+        TP_QT_WARNING() << "ConnectionLowlevel::contactAttributeInterfaces() used without the remote object supporting"
                   << "the Contacts interface";
     }
 
@@ -2242,7 +2242,7 @@ void ConnectionLowlevel::injectContactIds(const HandleIdentifierMap &contactIds)
             QString currentId = mPriv->contactsIds.value(handle);
 
             if (!currentId.isEmpty() && id != currentId) {
-                warning() << "Trying to overwrite contact id from" << currentId << "to" << id
+                TP_QT_WARNING() << "Trying to overwrite contact id from" << currentId << "to" << id
                     << "for the same handle" << handle << ", ignoring";
             } else {
                 mPriv->contactsIds.insert(handle, id);
@@ -2335,7 +2335,7 @@ void Connection::unrefHandle(HandleType handleType, uint handle)
 
         if (!handleContext->types[handleType].releaseScheduled) {
             if (!handleContext->types[handleType].requestsInFlight) {
-                debug() << "Lost last reference to at least one handle of type" <<
+                TP_QT_DEBUG() << "Lost last reference to at least one handle of type" <<
                     handleType <<
                     "and no requests in flight for that type - scheduling a release sweep";
                 QMetaObject::invokeMethod(this, "doReleaseSweep",
@@ -2358,20 +2358,20 @@ void Connection::doReleaseSweep(uint handleType)
     Q_ASSERT(handleContext->types.contains(handleType));
     Q_ASSERT(handleContext->types[handleType].releaseScheduled);
 
-    debug() << "Entering handle release sweep for type" << handleType;
+    TP_QT_DEBUG() << "Entering handle release sweep for type" << handleType;
     handleContext->types[handleType].releaseScheduled = false;
 
     if (handleContext->types[handleType].requestsInFlight > 0) {
-        debug() << " There are requests in flight, deferring sweep to when they have been completed";
+        TP_QT_DEBUG() << " There are requests in flight, deferring sweep to when they have been completed";
         return;
     }
 
     if (handleContext->types[handleType].toRelease.isEmpty()) {
-        debug() << " No handles to release - every one has been resurrected";
+        TP_QT_DEBUG() << " No handles to release - every one has been resurrected";
         return;
     }
 
-    debug() << " Releasing" << handleContext->types[handleType].toRelease.size() << "handles";
+    TP_QT_DEBUG() << " Releasing" << handleContext->types[handleType].toRelease.size() << "handles";
 
     mPriv->baseInterface->ReleaseHandles(handleType, handleContext->types[handleType].toRelease.toList());
     handleContext->types[handleType].toRelease.clear();
@@ -2392,7 +2392,7 @@ void Connection::handleRequestLanded(HandleType handleType)
     if (!--handleContext->types[handleType].requestsInFlight &&
         !handleContext->types[handleType].toRelease.isEmpty() &&
         !handleContext->types[handleType].releaseScheduled) {
-        debug() << "All handle requests for type" << handleType <<
+        TP_QT_DEBUG() << "All handle requests for type" << handleType <<
             "landed and there are handles of that type to release - scheduling a release sweep";
         QMetaObject::invokeMethod(this, "doReleaseSweep", Qt::QueuedConnection, Q_ARG(uint, handleType));
         handleContext->types[handleType].releaseScheduled = true;
@@ -2406,11 +2406,11 @@ void Connection::onSelfHandleChanged(uint handle)
     }
 
     if (mPriv->pendingStatus != ConnectionStatusConnected || !mPriv->selfHandle) {
-        debug() << "Got a self handle change before we have the initial self handle, ignoring";
+        TP_QT_DEBUG() << "Got a self handle change before we have the initial self handle, ignoring";
         return;
     }
 
-    debug() << "Connection self handle changed to" << handle;
+    TP_QT_DEBUG() << "Connection self handle changed to" << handle;
     mPriv->selfHandle = handle;
     emit selfHandleChanged(handle);
 
@@ -2418,13 +2418,13 @@ void Connection::onSelfHandleChanged(uint handle)
         // We're currently introspecting the SelfContact feature, but have started building the
         // contact with the old handle, so we need to do it again with the new handle.
 
-        debug() << "The self contact is being built, will rebuild with the new handle shortly";
+        TP_QT_DEBUG() << "The self contact is being built, will rebuild with the new handle shortly";
         mPriv->reintrospectSelfContactRequired = true;
     } else if (isReady(FeatureSelfContact)) {
         // We've already introspected the SelfContact feature, so we can reinvoke the introspection
         // logic directly to rebuild with the new handle.
 
-        debug() << "Re-building self contact for handle" << handle;
+        TP_QT_DEBUG() << "Re-building self contact for handle" << handle;
         Private::introspectSelfContact(mPriv);
     }
 
@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryRoster
+
 #include "TelepathyQt/contact-manager-internal.h"
 
 #include "TelepathyQt/_gen/contact-manager-internal.moc.hpp"
@@ -79,19 +81,19 @@ PendingOperation *ContactManager::Roster::introspect()
     ConnectionPtr conn(contactManager->connection());
 
     if (conn->hasInterface(TP_QT_IFACE_CONNECTION_INTERFACE_CONTACT_LIST)) {
-        debug() << "Connection.ContactList found, using it";
+        TP_QT_DEBUG() << "Connection.ContactList found, using it";
 
         usingFallbackContactList = false;
 
         if (conn->hasInterface(TP_QT_IFACE_CONNECTION_INTERFACE_CONTACT_BLOCKING)) {
-            debug() << "Connection.ContactBlocking found. using it";
+            TP_QT_DEBUG() << "Connection.ContactBlocking found. using it";
             hasContactBlockingInterface = true;
             introspectContactBlocking();
         } else {
-            debug() << "Connection.ContactBlocking not found, falling back "
+            TP_QT_DEBUG() << "Connection.ContactBlocking not found, falling back "
                 "to contact list deny channel";
 
-            debug() << "Requesting handle for deny channel";
+            TP_QT_DEBUG() << "Requesting handle for deny channel";
 
             contactListChannels.insert(ChannelInfo::TypeDeny,
                     ChannelInfo(ChannelInfo::TypeDeny));
@@ -104,7 +106,7 @@ PendingOperation *ContactManager::Roster::introspect()
                     SLOT(gotContactListChannelHandle(Tp::PendingOperation*)));
         }
     } else {
-        debug() << "Connection.ContactList not found, falling back to contact list channels";
+        TP_QT_DEBUG() << "Connection.ContactList not found, falling back to contact list channels";
 
         usingFallbackContactList = true;
 
@@ -112,7 +114,7 @@ PendingOperation *ContactManager::Roster::introspect()
             QString channelId = ChannelInfo::identifierForType(
                     (ChannelInfo::Type) i);
 
-            debug() << "Requesting handle for" << channelId << "channel";
+            TP_QT_DEBUG() << "Requesting handle for" << channelId << "channel";
 
             contactListChannels.insert(i,
                     ChannelInfo((ChannelInfo::Type) i));
@@ -142,10 +144,10 @@ PendingOperation *ContactManager::Roster::introspectGroups()
                     QLatin1String("Roster groups not supported"), conn);
         }
 
-        debug() << "Connection.ContactGroups found, using it";
+        TP_QT_DEBUG() << "Connection.ContactGroups found, using it";
 
         if (!gotContactListInitialContacts) {
-            debug() << "Initial ContactList contacts not retrieved. Postponing introspection";
+            TP_QT_DEBUG() << "Initial ContactList contacts not retrieved. Postponing introspection";
             groupsReintrospectionRequired = true;
             return new PendingSuccess(conn);
         }
@@ -171,7 +173,7 @@ PendingOperation *ContactManager::Roster::introspectGroups()
                 SIGNAL(finished(Tp::PendingOperation*)),
                 SLOT(gotContactListGroupsProperties(Tp::PendingOperation*)));
     } else {
-        debug() << "Connection.ContactGroups not found, falling back to contact list group channels";
+        TP_QT_DEBUG() << "Connection.ContactGroups not found, falling back to contact list group channels";
 
         ++featureContactListGroupsTodo; // decremented in gotChannels
 
@@ -180,12 +182,12 @@ PendingOperation *ContactManager::Roster::introspectGroups()
         Client::ConnectionInterfaceRequestsInterface *iface =
             conn->interface<Client::ConnectionInterfaceRequestsInterface>();
 
-        debug() << "Connecting to Requests.NewChannels";
+        TP_QT_DEBUG() << "Connecting to Requests.NewChannels";
         connect(iface,
                 SIGNAL(NewChannels(Tp::ChannelDetailsList)),
                 SLOT(onNewChannels(Tp::ChannelDetailsList)));
 
-        debug() << "Retrieving channels";
+        TP_QT_DEBUG() << "Retrieving channels";
         Client::DBus::PropertiesInterface *properties =
             contactManager->connection()->interface<Client::DBus::PropertiesInterface>();
         QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(
@@ -594,19 +596,19 @@ PendingOperation *ContactManager::Roster::removeContacts(
          */
 
         if (storedChannel && storedChannel->groupCanRemoveContacts()) {
-            debug() << "Removing contacts from stored list";
+            TP_QT_DEBUG() << "Removing contacts from stored list";
             return storedChannel->groupRemoveContacts(contacts, message);
         }
 
         QList<PendingOperation*> operations;
 
         if (canRemovePresenceSubscription()) {
-            debug() << "Removing contacts from subscribe list";
+            TP_QT_DEBUG() << "Removing contacts from subscribe list";
             operations << removePresenceSubscription(contacts, message);
         }
 
         if (canRemovePresencePublication()) {
-            debug() << "Removing contacts from publish list";
+            TP_QT_DEBUG() << "Removing contacts from publish list";
             operations << removePresencePublication(contacts, message);
         }
 
@@ -694,13 +696,13 @@ PendingOperation *ContactManager::Roster::blockContacts(
 void ContactManager::Roster::gotContactBlockingCapabilities(PendingOperation *op)
 {
     if (op->isError()) {
-        warning() << "Getting ContactBlockingCapabilities property failed with" <<
+        TP_QT_WARNING() << "Getting ContactBlockingCapabilities property failed with" <<
             op->errorName() << ":" << op->errorMessage();
         introspectContactList();
         return;
     }
 
-    debug() << "Got ContactBlockingCapabilities property";
+    TP_QT_DEBUG() << "Got ContactBlockingCapabilities property";
 
     PendingVariant *pv = qobject_cast<PendingVariant*>(op);
 
@@ -717,14 +719,14 @@ void ContactManager::Roster::gotContactBlockingBlockedContacts(
     QDBusPendingReply<HandleIdentifierMap> reply = *watcher;
 
     if (watcher->isError()) {
-        warning() << "Getting initial ContactBlocking blocked "
+        TP_QT_WARNING() << "Getting initial ContactBlocking blocked "
             "contacts failed with" <<
             watcher->error().name() << ":" << watcher->error().message();
         introspectContactList();
         return;
     }
 
-    debug() << "Got initial ContactBlocking blocked contacts";
+    TP_QT_DEBUG() << "Got initial ContactBlocking blocked contacts";
 
     gotContactBlockingInitialBlockedContacts = true;
 
@@ -776,7 +778,7 @@ void ContactManager::Roster::gotContactListProperties(PendingOperation *op)
         return;
     }
 
-    debug() << "Got ContactList properties";
+    TP_QT_DEBUG() << "Got ContactList properties";
 
     PendingVariantMap *pvm = qobject_cast<PendingVariantMap*>(op);
 
@@ -797,10 +799,10 @@ void ContactManager::Roster::gotContactListContacts(QDBusPendingCallWatcher *wat
     QDBusPendingReply<ContactAttributesMap> reply = *watcher;
 
     if (watcher->isError()) {
-        warning() << "Failed introspecting ContactList contacts";
+        TP_QT_WARNING() << "Failed introspecting ContactList contacts";
 
         contactListState = ContactListStateFailure;
-        debug() << "Setting state to failure";
+        TP_QT_DEBUG() << "Setting state to failure";
         emit contactManager->stateChanged((Tp::ContactListState) contactListState);
 
         // We may have been in state Failure and then Success, and FeatureRoster is already ready
@@ -812,7 +814,7 @@ void ContactManager::Roster::gotContactListContacts(QDBusPendingCallWatcher *wat
         return;
     }
 
-    debug() << "Got initial ContactList contacts";
+    TP_QT_DEBUG() << "Got initial ContactList contacts";
 
     gotContactListInitialContacts = true;
 
@@ -868,7 +870,7 @@ void ContactManager::Roster::gotContactListContacts(QDBusPendingCallWatcher *wat
 void ContactManager::Roster::setStateSuccess()
 {
     if (contactManager->connection()->isValid()) {
-        debug() << "State is now success";
+        TP_QT_DEBUG() << "State is now success";
         contactListState = ContactListStateSuccess;
         emit contactManager->stateChanged((Tp::ContactListState) contactListState);
     }
@@ -891,7 +893,7 @@ void ContactManager::Roster::onContactListStateChanged(uint state)
     contactListState = state;
 
     if (state == ContactListStateFailure) {
-        debug() << "State changed to failure, finishing roster introspection";
+        TP_QT_DEBUG() << "State changed to failure, finishing roster introspection";
     }
 
     emit contactManager->stateChanged((Tp::ContactListState) state);
@@ -908,13 +910,13 @@ void ContactManager::Roster::onContactListStateChanged(uint state)
 void ContactManager::Roster::onContactListContactsChangedWithId(const Tp::ContactSubscriptionMap &changes,
         const Tp::HandleIdentifierMap &ids, const Tp::HandleIdentifierMap &removals)
 {
-    debug() << "Got ContactList.ContactsChangedWithID with" << changes.size() <<
+    TP_QT_DEBUG() << "Got ContactList.ContactsChangedWithID with" << changes.size() <<
         "changes and" << removals.size() << "removals";
 
     gotContactListContactsChangedWithId = true;
 
     if (!gotContactListInitialContacts) {
-        debug() << "Ignoring ContactList changes until initial contacts are retrieved";
+        TP_QT_DEBUG() << "Ignoring ContactList changes until initial contacts are retrieved";
         return;
     }
 
@@ -933,11 +935,11 @@ void ContactManager::Roster::onContactListContactsChanged(const Tp::ContactSubsc
         return;
     }
 
-    debug() << "Got ContactList.ContactsChanged with" << changes.size() <<
+    TP_QT_DEBUG() << "Got ContactList.ContactsChanged with" << changes.size() <<
         "changes and" << removals.size() << "removals";
 
     if (!gotContactListInitialContacts) {
-        debug() << "Ignoring ContactList changes until initial contacts are retrieved";
+        TP_QT_DEBUG() << "Ignoring ContactList changes until initial contacts are retrieved";
         return;
     }
 
@@ -974,11 +976,11 @@ void ContactManager::Roster::onContactListBlockedContactsConstructed(Tp::Pending
 
         ContactPtr contact = contactManager->lookupContactByHandle(bareHandle);
         if (!contact) {
-            warning() << "Unable to construct contact for handle" << bareHandle;
+            TP_QT_WARNING() << "Unable to construct contact for handle" << bareHandle;
             continue;
         }
 
-        debug() << "Contact" << contact->id() << "is now blocked";
+        TP_QT_DEBUG() << "Contact" << contact->id() << "is now blocked";
         blockedContacts.insert(contact);
         newBlockedContacts.insert(contact);
         contact->setBlocked(true);
@@ -991,11 +993,11 @@ void ContactManager::Roster::onContactListBlockedContactsConstructed(Tp::Pending
 
         ContactPtr contact = contactManager->lookupContactByHandle(bareHandle);
         if (!contact) {
-            warning() << "Unable to construct contact for handle" << bareHandle;
+            TP_QT_WARNING() << "Unable to construct contact for handle" << bareHandle;
             continue;
         }
 
-        debug() << "Contact" << contact->id() << "is now unblocked";
+        TP_QT_DEBUG() << "Contact" << contact->id() << "is now unblocked";
         blockedContacts.remove(contact);
         unblockedContacts.insert(contact);
         contact->setBlocked(false);
@@ -1037,7 +1039,7 @@ void ContactManager::Roster::onContactListNewContactsConstructed(Tp::PendingOper
 
         ContactPtr contact = contactManager->lookupContactByHandle(bareHandle);
         if (!contact) {
-            warning() << "Unable to construct contact for handle" << bareHandle;
+            TP_QT_WARNING() << "Unable to construct contact for handle" << bareHandle;
             continue;
         }
 
@@ -1068,12 +1070,12 @@ void ContactManager::Roster::onContactListNewContactsConstructed(Tp::PendingOper
     foreach (uint bareHandle, info.removals.keys()) {
         ContactPtr contact = contactManager->lookupContactByHandle(bareHandle);
         if (!contact) {
-            warning() << "Unable to find removed contact with handle" << bareHandle;
+            TP_QT_WARNING() << "Unable to find removed contact with handle" << bareHandle;
             continue;
         }
 
         if (!contactListContacts.contains(contact)) {
-            warning() << "Contact" << contact->id() << "removed from ContactList "
+            TP_QT_WARNING() << "Contact" << contact->id() << "removed from ContactList "
                 "but it wasn't present, ignoring.";
             continue;
         }
@@ -1173,7 +1175,7 @@ void ContactManager::Roster::gotContactListChannelHandle(PendingOperation *op)
 
     if (op->isError()) {
         // let's not fail, because the contact lists are not supported
-        debug() << "Unable to retrieve handle for" << channelId << "channel, ignoring";
+        TP_QT_DEBUG() << "Unable to retrieve handle for" << channelId << "channel, ignoring";
         contactListChannels.remove(type);
         onContactListChannelReady();
         return;
@@ -1181,7 +1183,7 @@ void ContactManager::Roster::gotContactListChannelHandle(PendingOperation *op)
 
     if (ph->invalidNames().size() == 1) {
         // let's not fail, because the contact lists are not supported
-        debug() << "Unable to retrieve handle for" << channelId << "channel, ignoring";
+        TP_QT_DEBUG() << "Unable to retrieve handle for" << channelId << "channel, ignoring";
         contactListChannels.remove(type);
         onContactListChannelReady();
         return;
@@ -1189,7 +1191,7 @@ void ContactManager::Roster::gotContactListChannelHandle(PendingOperation *op)
 
     Q_ASSERT(ph->handles().size() == 1);
 
-    debug() << "Got handle for" << channelId << "channel";
+    TP_QT_DEBUG() << "Got handle for" << channelId << "channel";
 
     if (!usingFallbackContactList) {
         Q_ASSERT(type == ChannelInfo::TypeDeny);
@@ -1200,7 +1202,7 @@ void ContactManager::Roster::gotContactListChannelHandle(PendingOperation *op)
     ReferencedHandles handle = ph->handles();
     contactListChannels[type].handle = handle;
 
-    debug() << "Requesting channel for" << channelId << "channel";
+    TP_QT_DEBUG() << "Requesting channel for" << channelId << "channel";
     QVariantMap request;
     request.insert(TP_QT_IFACE_CHANNEL + QLatin1String(".ChannelType"),
             TP_QT_IFACE_CHANNEL_TYPE_CONTACT_LIST);
@@ -1220,7 +1222,7 @@ void ContactManager::Roster::gotContactListChannelHandle(PendingOperation *op)
 void ContactManager::Roster::gotContactListChannel(PendingOperation *op)
 {
     if (op->isError()) {
-        debug() << "Unable to create channel, ignoring";
+        TP_QT_DEBUG() << "Unable to create channel, ignoring";
         onContactListChannelReady();
         return;
     }
@@ -1265,7 +1267,7 @@ void ContactManager::Roster::onContactListChannelReady()
     } else if (++contactListChannelsReady == ChannelInfo::LastType) {
         if (contactListChannels.isEmpty()) {
             contactListState = ContactListStateFailure;
-            debug() << "State is failure, roster not supported";
+            TP_QT_DEBUG() << "State is failure, roster not supported";
             emit contactManager->stateChanged((Tp::ContactListState) contactListState);
 
             Q_ASSERT(introspectPendingOp);
@@ -1323,7 +1325,7 @@ void ContactManager::Roster::gotContactListGroupsProperties(PendingOperation *op
     }
 
     if (op->isError()) {
-        warning() << "Getting contact list groups properties failed:" << op->errorName() << '-'
+        TP_QT_WARNING() << "Getting contact list groups properties failed:" << op->errorName() << '-'
             << op->errorMessage();
 
         introspectGroupsPendingOp->setFinishedWithError(
@@ -1333,7 +1335,7 @@ void ContactManager::Roster::gotContactListGroupsProperties(PendingOperation *op
         return;
     }
 
-    debug() << "Got contact list groups properties";
+    TP_QT_DEBUG() << "Got contact list groups properties";
     PendingVariantMap *pvm = qobject_cast<PendingVariantMap*>(op);
 
     QVariantMap props = pvm->result();
@@ -1358,7 +1360,7 @@ void ContactManager::Roster::onContactListContactsUpgraded(PendingOperation *op)
     Q_ASSERT(introspectGroupsPendingOp != nullptr);
 
     if (op->isError()) {
-        warning() << "Upgrading contacts with group membership failed:" << op->errorName() << '-'
+        TP_QT_WARNING() << "Upgrading contacts with group membership failed:" << op->errorName() << '-'
             << op->errorMessage();
 
         introspectGroupsPendingOp->setFinishedWithError(
@@ -1430,10 +1432,10 @@ void ContactManager::Roster::gotChannels(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<QVariant> reply = *watcher;
 
     if (!reply.isError()) {
-        debug() << "Got channels";
+        TP_QT_DEBUG() << "Got channels";
         onNewChannels(qdbus_cast<ChannelDetailsList>(reply.value()));
     } else {
-        warning().nospace() << "Getting channels failed with " <<
+        TP_QT_WARNING().nospace() << "Getting channels failed with " <<
             reply.error().name() << ":" << reply.error().message();
     }
 
@@ -1452,19 +1454,19 @@ void ContactManager::Roster::onStoredChannelMembersChanged(
         const Channel::GroupMemberChangeDetails &details)
 {
     if (!groupLocalPendingMembersAdded.isEmpty()) {
-        warning() << "Found local pending contacts on stored list";
+        TP_QT_WARNING() << "Found local pending contacts on stored list";
     }
 
     if (!groupRemotePendingMembersAdded.isEmpty()) {
-        warning() << "Found remote pending contacts on stored list";
+        TP_QT_WARNING() << "Found remote pending contacts on stored list";
     }
 
     foreach (ContactPtr contact, groupMembersAdded) {
-        debug() << "Contact" << contact->id() << "on stored list";
+        TP_QT_DEBUG() << "Contact" << contact->id() << "on stored list";
     }
 
     foreach (ContactPtr contact, groupMembersRemoved) {
-        debug() << "Contact" << contact->id() << "removed from stored list";
+        TP_QT_DEBUG() << "Contact" << contact->id() << "removed from stored list";
     }
 
     // Perform the needed computation for allKnownContactsChanged
@@ -1481,21 +1483,21 @@ void ContactManager::Roster::onSubscribeChannelMembersChanged(
         const Channel::GroupMemberChangeDetails &details)
 {
     if (!groupLocalPendingMembersAdded.isEmpty()) {
-        warning() << "Found local pending contacts on subscribe list";
+        TP_QT_WARNING() << "Found local pending contacts on subscribe list";
     }
 
     foreach (ContactPtr contact, groupMembersAdded) {
-        debug() << "Contact" << contact->id() << "on subscribe list";
+        TP_QT_DEBUG() << "Contact" << contact->id() << "on subscribe list";
         contact->setSubscriptionState(SubscriptionStateYes);
     }
 
     foreach (ContactPtr contact, groupRemotePendingMembersAdded) {
-        debug() << "Contact" << contact->id() << "added to subscribe list";
+        TP_QT_DEBUG() << "Contact" << contact->id() << "added to subscribe list";
         contact->setSubscriptionState(SubscriptionStateAsk);
     }
 
     foreach (ContactPtr contact, groupMembersRemoved) {
-        debug() << "Contact" << contact->id() << "removed from subscribe list";
+        TP_QT_DEBUG() << "Contact" << contact->id() << "removed from subscribe list";
         contact->setSubscriptionState(SubscriptionStateNo);
     }
 
@@ -1513,21 +1515,21 @@ void ContactManager::Roster::onPublishChannelMembersChanged(
         const Channel::GroupMemberChangeDetails &details)
 {
     if (!groupRemotePendingMembersAdded.isEmpty()) {
-        warning() << "Found remote pending contacts on publish list";
+        TP_QT_WARNING() << "Found remote pending contacts on publish list";
     }
 
     foreach (ContactPtr contact, groupMembersAdded) {
-        debug() << "Contact" << contact->id() << "on publish list";
+        TP_QT_DEBUG() << "Contact" << contact->id() << "on publish list";
         contact->setPublishState(SubscriptionStateYes);
     }
 
     foreach (ContactPtr contact, groupLocalPendingMembersAdded) {
-        debug() << "Contact" << contact->id() << "added to publish list";
+        TP_QT_DEBUG() << "Contact" << contact->id() << "added to publish list";
         contact->setPublishState(SubscriptionStateAsk, details.message());
     }
 
     foreach (ContactPtr contact, groupMembersRemoved) {
-        debug() << "Contact" << contact->id() << "removed from publish list";
+        TP_QT_DEBUG() << "Contact" << contact->id() << "removed from publish list";
         contact->setPublishState(SubscriptionStateNo);
     }
 
@@ -1549,20 +1551,20 @@ void ContactManager::Roster::onDenyChannelMembersChanged(
         const Channel::GroupMemberChangeDetails &details)
 {
     if (!groupLocalPendingMembersAdded.isEmpty()) {
-        warning() << "Found local pending contacts on deny list";
+        TP_QT_WARNING() << "Found local pending contacts on deny list";
     }
 
     if (!groupRemotePendingMembersAdded.isEmpty()) {
-        warning() << "Found remote pending contacts on deny list";
+        TP_QT_WARNING() << "Found remote pending contacts on deny list";
     }
 
     foreach (ContactPtr contact, groupMembersAdded) {
-        debug() << "Contact" << contact->id() << "added to deny list";
+        TP_QT_DEBUG() << "Contact" << contact->id() << "added to deny list";
         contact->setBlocked(true);
     }
 
     foreach (ContactPtr contact, groupMembersRemoved) {
-        debug() << "Contact" << contact->id() << "removed from deny list";
+        TP_QT_DEBUG() << "Contact" << contact->id() << "removed from deny list";
         contact->setBlocked(false);
     }
 
@@ -1615,7 +1617,7 @@ void ContactManager::Roster::onContactListGroupRemoved(Tp::DBusProxy *proxy,
 
 void ContactManager::Roster::introspectContactBlocking()
 {
-    debug() << "Requesting ContactBlockingCapabilities property";
+    TP_QT_DEBUG() << "Requesting ContactBlockingCapabilities property";
 
     ConnectionPtr conn(contactManager->connection());
 
@@ -1650,7 +1652,7 @@ void ContactManager::Roster::introspectContactBlockingBlockedContacts()
 
 void ContactManager::Roster::introspectContactList()
 {
-    debug() << "Requesting ContactList properties";
+    TP_QT_DEBUG() << "Requesting ContactList properties";
 
     ConnectionPtr conn(contactManager->connection());
 
@@ -1771,7 +1773,7 @@ void ContactManager::Roster::processContactListGroupsUpdates()
         foreach (uint bareHandle, info.contacts) {
             ContactPtr contact = contactManager->lookupContactByHandle(bareHandle);
             if (!contact) {
-                warning() << "contact with handle" << bareHandle << "was added to a group but "
+                TP_QT_WARNING() << "contact with handle" << bareHandle << "was added to a group but "
                     "never added to the contact list, ignoring";
                 continue;
             }
@@ -1788,7 +1790,7 @@ void ContactManager::Roster::processContactListGroupsUpdates()
         foreach (uint bareHandle, info.contacts) {
             ContactPtr contact = contactManager->lookupContactByHandle(bareHandle);
             if (!contact) {
-                warning() << "contact with handle" << bareHandle << "was removed from a group but "
+                TP_QT_WARNING() << "contact with handle" << bareHandle << "was removed from a group but "
                     "never added to the contact list, ignoring";
                 continue;
             }
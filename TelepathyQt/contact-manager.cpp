@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryContacts
+
 #include <TelepathyQt/ContactManager>
 #include "TelepathyQt/contact-manager-internal.h"
 
@@ -57,14 +59,20 @@ struct TP_QT_NO_EXPORT ContactManager::Private
     Features realFeatures(const Features &features);
     QSet<QString> interfacesForFeatures(const Features &features);
 
+    void emitContactsChanged(const Contacts &contacts, const Feature &feature);
+
     ContactManager *parent;
     WeakPtr<Connection> connection;
     ContactManager::Roster *roster;
 
     QHash<uint, WeakPtr<Contact> > contacts;
+    // the same contacts by identifier, and by the possibly unnormalized identifiers
+    // they were requested with, to answer contactsForIdentifiers() locally
+    QHash<QString, WeakPtr<Contact> > contactsById;
 
     QHash<Feature, bool> tracking;
     Features supportedFeatures;
+    bool contactSignalsEnabled;
 
     // avatar
     QSet<ContactPtr> requestAvatarsQueue;
@@ -78,6 +86,7 @@ ContactManager::Private::Private(ContactManager *parent, Connection *connection)
     : parent(parent),
       connection(connection),
       roster(new ContactManager::Roster(parent)),
+      contactSignalsEnabled(true),
       requestAvatarsIdle(false),
       refreshInfoOp(nullptr)
 {
@@ -89,6 +98,14 @@ ContactManager::Private::~Private()
     delete roster;
 }
 
+void ContactManager::Private::emitContactsChanged(const Contacts &contacts,
+        const Feature &feature)
+{
+    if (!contacts.isEmpty()) {
+        emit parent->contactsChanged(contacts, Features() << feature);
+    }
+}
+
 bool ContactManager::Private::buildAvatarFileName(QString token, bool createDir,
         QString &avatarFileName, QString &mimeTypeFileName)
 {
@@ -169,7 +186,7 @@ void ContactManager::PendingRefreshContactInfo::refreshInfo()
         return;
     }
 
-    debug() << "Calling ContactInfo.RefreshContactInfo for" << mToRequest.size() << "handles";
+    TP_QT_DEBUG() << "Calling ContactInfo.RefreshContactInfo for" << mToRequest.size() << "handles";
     Client::ConnectionInterfaceContactInfoInterface *contactInfoInterface =
         mConn->interface<Client::ConnectionInterfaceContactInfoInterface>();
     Q_ASSERT(contactInfoInterface);
@@ -184,11 +201,11 @@ void ContactManager::PendingRefreshContactInfo::refreshInfo()
 void ContactManager::PendingRefreshContactInfo::onRefreshInfoFinished(PendingOperation *op)
 {
     if (op->isError()) {
-        warning() << "ContactInfo.RefreshContactInfo failed with" <<
+        TP_QT_WARNING() << "ContactInfo.RefreshContactInfo failed with" <<
             op->errorName() << "-" << op->errorMessage();
         setFinishedWithError(op->errorName(), op->errorMessage());
     } else {
-        debug() << "Got reply to ContactInfo.RefreshContactInfo";
+        TP_QT_DEBUG() << "Got reply to ContactInfo.RefreshContactInfo";
         setFinished();
     }
 }
@@ -261,7 +278,7 @@ Features ContactManager::supportedFeatures() const
             }
         }
 
-        debug() << mPriv->supportedFeatures.size() << "contact features supported using" << this;
+        TP_QT_DEBUG() << mPriv->supportedFeatures.size() << "contact features supported using" << this;
     }
 
     return mPriv->supportedFeatures;
@@ -308,7 +325,7 @@ ContactListState ContactManager::state() const
 Contacts ContactManager::allKnownContacts() const
 {
     if (!connection()->isReady(Connection::FeatureRoster)) {
-        warning() << "Calling allKnownContacts() before FeatureRoster is ready";
+        TP_QT_WARNING() << "Calling allKnownContacts() before FeatureRoster is ready";
         return Contacts();
     }
 
@@ -1079,8 +1096,18 @@ PendingContacts *ContactManager::contactsForIdentifiers(const QStringList &ident
 
     Features realFeatures = mPriv->realFeatures(features);
 
+    QHash<QString, ContactPtr> satisfyingContacts;
+    foreach (const QString &id, identifiers) {
+        ContactPtr contact = lookupContactById(id);
+        if (contact && (realFeatures - contact->requestedFeatures()).isEmpty()) {
+            satisfyingContacts.insert(id, contact);
+        }
+    }
+
+    QSet<QString> interfaces = mPriv->interfacesForFeatures(realFeatures);
+
     PendingContacts *contacts = new PendingContacts(ContactManagerPtr(this), identifiers,
-            PendingContacts::ForIdentifiers, realFeatures, QStringList());
+            realFeatures, interfaces.toList(), satisfyingContacts);
     return contacts;
 }
 
@@ -1189,6 +1216,27 @@ ContactPtr ContactManager::lookupContactByHandle(uint handle)
     return contact;
 }
 
+ContactPtr ContactManager::lookupContactById(const QString &id)
+{
+    ContactPtr contact;
+
+    QHash<QString, WeakPtr<Contact> >::iterator it = mPriv->contactsById.find(id);
+    if (it != mPriv->contactsById.end()) {
+        contact = ContactPtr(it.value());
+        if (!contact) {
+            // Dangling weak pointer, remove it
+            mPriv->contactsById.erase(it);
+        }
+    }
+
+    return contact;
+}
+
+void ContactManager::indexContactById(const QString &id, const ContactPtr &contact)
+{
+    mPriv->contactsById.insert(id, contact);
+}
+
 /**
  * Start a request to retrieve the avatar for the given \a contacts.
  *
@@ -1244,17 +1292,49 @@ PendingOperation *ContactManager::refreshContactInfo(const QList<ContactPtr> &co
     return mPriv->refreshInfoOp;
 }
 
+/**
+ * Return whether the Contact objects of this manager emit their own change
+ * signals for updates which are also reported through contactsChanged().
+ *
+ * \return \c true if the per-contact signals are emitted, \c false otherwise.
+ * \sa setContactSignalsEnabled()
+ */
+bool ContactManager::contactSignalsEnabled() const
+{
+    return mPriv->contactSignalsEnabled;
+}
+
+/**
+ * Set whether the Contact objects of this manager emit their own change signals,
+ * such as Contact::presenceChanged() and Contact::aliasChanged(), for updates
+ * which are also reported through contactsChanged().
+ *
+ * Models which only listen to contactsChanged() can disable the per-contact
+ * signals, so that an update for thousands of contacts is delivered as one
+ * signal emission rather than thousands. The default is \c true.
+ *
+ * \param enabled Whether the per-contact signals should be emitted.
+ * \sa contactsChanged()
+ */
+void ContactManager::setContactSignalsEnabled(bool enabled)
+{
+    mPriv->contactSignalsEnabled = enabled;
+}
+
 void ContactManager::onAliasesChanged(const AliasPairList &aliases)
 {
-    debug() << "Got AliasesChanged for" << aliases.size() << "contacts";
+    TP_QT_DEBUG() << "Got AliasesChanged for" << aliases.size() << "contacts";
 
+    Contacts changed;
     foreach (AliasPair pair, aliases) {
         ContactPtr contact = lookupContactByHandle(pair.handle);
 
-        if (contact) {
-            contact->receiveAlias(pair.alias);
+        if (contact && contact->receiveAlias(pair.alias, mPriv->contactSignalsEnabled)) {
+            changed.insert(contact);
         }
     }
+
+    mPriv->emitContactsChanged(changed, Contact::FeatureAlias);
 }
 
 void ContactManager::doRequestAvatars()
@@ -1297,14 +1377,14 @@ void ContactManager::doRequestAvatars()
     }
 
     if (found > 0) {
-        debug() << "Avatar(s) found in cache for" << found << "contact(s)";
+        TP_QT_DEBUG() << "Avatar(s) found in cache for" << found << "contact(s)";
     }
 
     if (found == contacts.size()) {
         return;
     }
 
-    debug() << "Requesting avatar(s) for" << contacts.size() - found << "contact(s)";
+    TP_QT_DEBUG() << "Requesting avatar(s) for" << contacts.size() - found << "contact(s)";
 
     Client::ConnectionInterfaceAvatarsInterface *avatarsInterface =
         connection()->interface<Client::ConnectionInterfaceAvatarsInterface>();
@@ -1317,7 +1397,7 @@ void ContactManager::doRequestAvatars()
 
 void ContactManager::onAvatarUpdated(uint handle, const QString &token)
 {
-    debug() << "Got AvatarUpdate for contact with handle" << handle;
+    TP_QT_DEBUG() << "Got AvatarUpdate for contact with handle" << handle;
 
     ContactPtr contact = lookupContactByHandle(handle);
     if (contact) {
@@ -1331,15 +1411,15 @@ void ContactManager::onAvatarRetrieved(uint handle, const QString &token,
     QString avatarFileName;
     QString mimeTypeFileName;
 
-    debug() << "Got AvatarRetrieved for contact with handle" << handle;
+    TP_QT_DEBUG() << "Got AvatarRetrieved for contact with handle" << handle;
 
     bool success = mPriv->buildAvatarFileName(token, true, avatarFileName,
         mimeTypeFileName);
 
     if (success) {
-        debug() << "Write avatar in cache for handle" << handle;
-        debug() << "Filename:" << avatarFileName;
-        debug() << "MimeType:" << mimeType;
+        TP_QT_DEBUG() << "Write avatar in cache for handle" << handle;
+        TP_QT_DEBUG() << "Filename:" << avatarFileName;
+        TP_QT_DEBUG() << "MimeType:" << mimeType;
 
         if (!QFile::exists(mimeTypeFileName)) {
             QTemporaryFile mimeTypeFile(mimeTypeFileName);
@@ -1373,60 +1453,68 @@ void ContactManager::onAvatarRetrieved(uint handle, const QString &token,
 
 void ContactManager::onPresencesChanged(const SimpleContactPresences &presences)
 {
-    debug() << "Got PresencesChanged for" << presences.size() << "contacts";
+    TP_QT_DEBUG() << "Got PresencesChanged for" << presences.size() << "contacts";
 
-    foreach (uint handle, presences.keys()) {
-        ContactPtr contact = lookupContactByHandle(handle);
+    Contacts changed;
+    for (SimpleContactPresences::const_iterator it = presences.constBegin();
+            it != presences.constEnd(); ++it) {
+        ContactPtr contact = lookupContactByHandle(it.key());
 
-        if (contact) {
-            contact->receiveSimplePresence(presences[handle]);
+        if (contact && contact->receiveSimplePresence(it.value(), mPriv->contactSignalsEnabled)) {
+            changed.insert(contact);
         }
     }
+
+    mPriv->emitContactsChanged(changed, Contact::FeatureSimplePresence);
 }
 
 void ContactManager::onCapabilitiesChanged(const ContactCapabilitiesMap &caps)
 {
-    debug() << "Got ContactCapabilitiesChanged for" << caps.size() << "contacts";
+    TP_QT_DEBUG() << "Got ContactCapabilitiesChanged for" << caps.size() << "contacts";
 
-    foreach (uint handle, caps.keys()) {
-        ContactPtr contact = lookupContactByHandle(handle);
+    Contacts changed;
+    for (ContactCapabilitiesMap::const_iterator it = caps.constBegin();
+            it != caps.constEnd(); ++it) {
+        ContactPtr contact = lookupContactByHandle(it.key());
 
-        if (contact) {
-            contact->receiveCapabilities(caps[handle]);
+        if (contact && contact->receiveCapabilities(it.value(), mPriv->contactSignalsEnabled)) {
+            changed.insert(contact);
         }
     }
+
+    mPriv->emitContactsChanged(changed, Contact::FeatureCapabilities);
 }
 
 void ContactManager::onLocationUpdated(uint handle, const QVariantMap &location)
 {
-    debug() << "Got LocationUpdated for contact with handle" << handle;
+    TP_QT_DEBUG() << "Got LocationUpdated for contact with handle" << handle;
 
     ContactPtr contact = lookupContactByHandle(handle);
 
-    if (contact) {
-        contact->receiveLocation(location);
+    if (contact && contact->receiveLocation(location, mPriv->contactSignalsEnabled)) {
+        mPriv->emitContactsChanged(Contacts() << contact, Contact::FeatureLocation);
     }
 }
 
 void ContactManager::onContactInfoChanged(uint handle, const Tp::ContactInfoFieldList &info)
 {
-    debug() << "Got ContactInfoChanged for contact with handle" << handle;
+    TP_QT_DEBUG() << "Got ContactInfoChanged for contact with handle" << handle;
 
     ContactPtr contact = lookupContactByHandle(handle);
 
-    if (contact) {
-        contact->receiveInfo(info);
+    if (contact && contact->receiveInfo(info, mPriv->contactSignalsEnabled)) {
+        mPriv->emitContactsChanged(Contacts() << contact, Contact::FeatureInfo);
     }
 }
 
 void ContactManager::onClientTypesUpdated(uint handle, const QStringList &clientTypes)
 {
-    debug() << "Got ClientTypesUpdated for contact with handle" << handle;
+    TP_QT_DEBUG() << "Got ClientTypesUpdated for contact with handle" << handle;
 
     ContactPtr contact = lookupContactByHandle(handle);
 
-    if (contact) {
-        contact->receiveClientTypes(clientTypes);
+    if (contact && contact->receiveClientTypes(clientTypes, mPriv->contactSignalsEnabled)) {
+        mPriv->emitContactsChanged(Contacts() << contact, Contact::FeatureClientTypes);
     }
 }
 
@@ -1447,6 +1535,9 @@ ContactPtr ContactManager::ensureContact(const ReferencedHandles &handle,
     if (!contact) {
         contact = connection()->contactFactory()->construct(this, handle, features, attributes);
         mPriv->contacts.insert(bareHandle, contact);
+        if (!contact->id().isEmpty()) {
+            mPriv->contactsById.insert(contact->id(), contact);
+        }
     }
 
     contact->augment(features, attributes);
@@ -1467,6 +1558,7 @@ ContactPtr ContactManager::ensureContact(uint bareHandle, const QString &id,
                 ReferencedHandles(connection(), HandleTypeContact, UIntList() << bareHandle),
                 features, attributes);
         mPriv->contacts.insert(bareHandle, contact);
+        mPriv->contactsById.insert(id, contact);
 
         // do not call augment here as this is a fake contact
     }
@@ -1497,7 +1589,7 @@ QString ContactManager::featureToInterface(const Feature &feature)
     } else if (feature == Contact::FeatureClientTypes) {
         return TP_QT_IFACE_CONNECTION_INTERFACE_CLIENT_TYPES;
     } else {
-        warning() << "ContactManager doesn't know which interface corresponds to feature"
+        TP_QT_WARNING() << "ContactManager doesn't know which interface corresponds to feature"
             << feature;
         return QString();
     }
@@ -1571,7 +1663,7 @@ void ContactManager::ensureTracking(const Feature &feature)
         // nothing to do here, but we don't want to warn
         ;
     } else {
-        warning() << " Unknown feature" << feature
+        TP_QT_WARNING() << " Unknown feature" << feature
             << "when trying to figure out how to connect change notification!";
     }
 
@@ -1664,4 +1756,21 @@ void ContactManager::resetRoster()
  * \sa allKnownContacts()
  */
 
+/**
+ * \fn void ContactManager::contactsChanged(const Tp::Contacts &contacts,
+ *          const Tp::Features &changedFeatures)
+ *
+ * Emitted once for each change notification from the connection manager, with
+ * all the contacts whose alias, presence, capabilities, location, contact info
+ * or client types were changed by it.
+ *
+ * This lets list models apply a whole batch of changes at once, instead of
+ * reacting to the individual change signals of each Contact.
+ *
+ * \param contacts The contacts which changed.
+ * \param changedFeatures The Contact features whose values changed, such as
+ *                        Contact::FeatureSimplePresence.
+ * \sa setContactSignalsEnabled()
+ */
+
 } // Tp
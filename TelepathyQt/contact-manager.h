@@ -129,6 +129,9 @@ public:
 
     PendingOperation *refreshContactInfo(const QList<ContactPtr> &contact);
 
+    bool contactSignalsEnabled() const;
+    void setContactSignalsEnabled(bool enabled);
+
 Q_SIGNALS:
     void stateChanged(Tp::ContactListState state);
 
@@ -147,6 +150,8 @@ Q_SIGNALS:
             const Tp::Contacts &contactsRemoved,
             const Tp::Channel::GroupMemberChangeDetails &details);
 
+    void contactsChanged(const Tp::Contacts &contacts, const Tp::Features &changedFeatures);
+
 private Q_SLOTS:
     TP_QT_NO_EXPORT void onAliasesChanged(const Tp::AliasPairList &);
     TP_QT_NO_EXPORT void doRequestAvatars();
@@ -166,11 +171,14 @@ private:
     friend class Connection;
     friend class PendingContacts;
     friend class PendingRefreshContactInfo;
+    friend class QueuedContactFactory;
     friend class Roster;
 
     TP_QT_NO_EXPORT ContactManager(Connection *parent);
 
     TP_QT_NO_EXPORT ContactPtr lookupContactByHandle(uint handle);
+    TP_QT_NO_EXPORT ContactPtr lookupContactById(const QString &id);
+    TP_QT_NO_EXPORT void indexContactById(const QString &id, const ContactPtr &contact);
 
     TP_QT_NO_EXPORT ContactPtr ensureContact(const ReferencedHandles &handle,
             const Features &features,
@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryContacts
+
 #include <TelepathyQt/ContactMessenger>
 
 #include "TelepathyQt/_gen/contact-messenger.moc.hpp"
@@ -104,7 +106,7 @@ ContactMessengerPtr ContactMessenger::create(const AccountPtr &account,
         const ContactPtr &contact)
 {
     if (!contact) {
-        warning() << "Contact used to create a ContactMessenger object must be "
+        TP_QT_WARNING() << "Contact used to create a ContactMessenger object must be "
             "valid";
         return ContactMessengerPtr();
     }
@@ -123,7 +125,7 @@ ContactMessengerPtr ContactMessenger::create(const AccountPtr &account,
         const QString &contactIdentifier)
 {
     if (contactIdentifier.isEmpty()) {
-        warning() << "Contact identifier used to create a ContactMessenger object must be "
+        TP_QT_WARNING() << "Contact identifier used to create a ContactMessenger object must be "
             "non-empty";
         return ContactMessengerPtr();
     }
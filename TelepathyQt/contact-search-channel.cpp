@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/ContactSearchChannel>
 #include "TelepathyQt/contact-search-channel-internal.h"
 
@@ -51,6 +53,20 @@ struct TP_QT_NO_EXPORT ContactSearchChannel::Private
     void processSearchStateChangeQueue();
     void processSearchResultQueue();
 
+    struct SearchResultInfo
+    {
+        SearchResultInfo(const ContactSearchResultMap &result)
+            : result(result), pendingContacts(nullptr), resolved(result.isEmpty()), valid(true)
+        {
+        }
+
+        ContactSearchResultMap result;
+        PendingContacts *pendingContacts;
+        bool resolved;
+        bool valid;
+        QList<ContactPtr> contacts;
+    };
+
     struct SearchStateChangeInfo
     {
         SearchStateChangeInfo(uint state, const QString &errorName,
@@ -82,8 +98,12 @@ struct TP_QT_NO_EXPORT ContactSearchChannel::Private
 
     QQueue<void (Private::*)()> signalsQueue;
     QQueue<SearchStateChangeInfo> searchStateChangeQueue;
-    QQueue<ContactSearchResultMap> searchResultQueue;
+    // Contacts for every batch are requested as soon as it arrives, but the
+    // batches are still signalled in arrival order
+    QQueue<SearchResultInfo> searchResultQueue;
     bool processingSignalsQueue;
+    bool waitingForSearchResultContacts;
+    bool contactResolutionEnabled;
 };
 
 ContactSearchChannel::Private::Private(ContactSearchChannel *parent,
@@ -95,7 +115,9 @@ ContactSearchChannel::Private::Private(ContactSearchChannel *parent,
       readinessHelper(parent->readinessHelper()),
       searchState(ChannelContactSearchStateNotStarted),
       limit(0),
-      processingSignalsQueue(false)
+      processingSignalsQueue(false),
+      waitingForSearchResultContacts(false),
+      contactResolutionEnabled(true)
 {
     ReadinessHelper::Introspectables introspectables;
 
@@ -202,22 +224,30 @@ void ContactSearchChannel::Private::processSearchStateChangeQueue()
 
 void ContactSearchChannel::Private::processSearchResultQueue()
 {
-    const ContactSearchResultMap &result = searchResultQueue.first();
-    if (!result.isEmpty()) {
-        ContactManagerPtr manager = parent->connection()->contactManager();
-        PendingContacts *pendingContacts = manager->contactsForIdentifiers(
-                result.keys());
-        parent->connect(pendingContacts,
-                SIGNAL(finished(Tp::PendingOperation*)),
-                SLOT(gotSearchResultContacts(Tp::PendingOperation*)));
-    } else {
-        searchResultQueue.dequeue();
-
-        emit parent->searchResultReceived(SearchResult());
+    const SearchResultInfo &info = searchResultQueue.head();
+    if (!info.resolved) {
+        // gotSearchResultContacts() resumes processing once the contacts are ready
+        waitingForSearchResultContacts = true;
+        return;
+    }
 
-        processingSignalsQueue = false;
-        processSignalsQueue();
+    SearchResultInfo resolvedInfo = searchResultQueue.dequeue();
+    if (resolvedInfo.valid) {
+        Q_ASSERT(resolvedInfo.result.count() == resolvedInfo.contacts.count());
+
+        SearchResult ret;
+        ret.reserve(resolvedInfo.contacts.count());
+        int i = 0;
+        for (ContactSearchResultMap::const_iterator it = resolvedInfo.result.constBegin();
+                                                    it != resolvedInfo.result.constEnd();
+                                                    ++it, ++i) {
+            ret.insert(resolvedInfo.contacts.at(i), Contact::InfoFields(it.value()));
+        }
+        emit parent->searchResultReceived(ret);
     }
+
+    processingSignalsQueue = false;
+    processSignalsQueue();
 }
 
 struct TP_QT_NO_EXPORT ContactSearchChannel::SearchStateChangeDetails::Private : public QSharedData
@@ -448,6 +478,36 @@ QString ContactSearchChannel::server() const
     return mPriv->server;
 }
 
+/**
+ * Return whether Contact objects are built for the search results.
+ *
+ * \return \c true if searchResultReceived() is emitted, \c false if the
+ *         results are only signalled by rawSearchResultReceived().
+ * \sa setContactResolutionEnabled()
+ */
+bool ContactSearchChannel::isContactResolutionEnabled() const
+{
+    return mPriv->contactResolutionEnabled;
+}
+
+/**
+ * Set whether Contact objects are built for the search results.
+ *
+ * Applications which only display the identifiers and vCard fields of the
+ * results can disable contact resolution and use rawSearchResultReceived(),
+ * which saves requesting the contacts from the connection manager.
+ *
+ * This only affects results received after this call. Contact resolution is
+ * enabled by default.
+ *
+ * \param enabled Whether to build Contact objects for the search results.
+ * \sa isContactResolutionEnabled(), searchResultReceived(), rawSearchResultReceived()
+ */
+void ContactSearchChannel::setContactResolutionEnabled(bool enabled)
+{
+    mPriv->contactResolutionEnabled = enabled;
+}
+
 /**
  * Send a request to start a search for contacts on this connection.
  *
@@ -499,7 +559,7 @@ PendingOperation *ContactSearchChannel::search(const ContactSearchMap &terms)
     }
 
     if (searchState() != ChannelContactSearchStateNotStarted) {
-        warning() << "ContactSearchChannel::search called with "
+        TP_QT_WARNING() << "ContactSearchChannel::search called with "
             "searchState() != ChannelContactSearchStateNotStarted. Doing nothing";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Search already started"),
@@ -522,7 +582,7 @@ void ContactSearchChannel::continueSearch()
     }
 
     if (searchState() != ChannelContactSearchStateMoreAvailable) {
-        warning() << "ContactSearchChannel::continueSearch called with "
+        TP_QT_WARNING() << "ContactSearchChannel::continueSearch called with "
             "searchState() != ChannelContactSearchStateMoreAvailable. Doing nothing";
         return;
     }
@@ -551,7 +611,7 @@ void ContactSearchChannel::stopSearch()
 
     if (searchState() != ChannelContactSearchStateInProgress &&
         searchState() != ChannelContactSearchStateMoreAvailable) {
-        warning() << "ContactSearchChannel::stopSearch called with "
+        TP_QT_WARNING() << "ContactSearchChannel::stopSearch called with "
             "searchState() != ChannelContactSearchStateInProgress or "
             "ChannelContactSearchStateMoreAvailable. Doing nothing";
         return;
@@ -571,10 +631,10 @@ void ContactSearchChannel::gotProperties(QDBusPendingCallWatcher *watcher)
 
         mPriv->searchState = qdbus_cast<uint>(props[QLatin1String("SearchState")]);
 
-        debug() << "Got reply to Properties::GetAll(ContactSearchChannel)";
+        TP_QT_DEBUG() << "Got reply to Properties::GetAll(ContactSearchChannel)";
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, true);
     } else {
-        warning().nospace() << "Properties::GetAll(ContactSearchChannel) failed "
+        TP_QT_WARNING().nospace() << "Properties::GetAll(ContactSearchChannel) failed "
             "with " << reply.error().name() << ": " << reply.error().message();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, false,
                 reply.error());
@@ -590,10 +650,10 @@ void ContactSearchChannel::gotSearchState(QDBusPendingCallWatcher *watcher)
     if (!reply.isError()) {
         mPriv->searchState = qdbus_cast<uint>(reply.value());
 
-        debug() << "Got reply to Properties::Get(SearchState)";
+        TP_QT_DEBUG() << "Got reply to Properties::Get(SearchState)";
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, true);
     } else {
-        warning().nospace() << "Properties::Get(SearchState) failed "
+        TP_QT_WARNING().nospace() << "Properties::Get(SearchState) failed "
             "with " << reply.error().name() << ": " << reply.error().message();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, false,
                 reply.error());
@@ -612,7 +672,22 @@ void ContactSearchChannel::onSearchStateChanged(uint state, const QString &error
 
 void ContactSearchChannel::onSearchResultReceived(const ContactSearchResultMap &result)
 {
-    mPriv->searchResultQueue.enqueue(result);
+    emit rawSearchResultReceived(result);
+
+    if (!mPriv->contactResolutionEnabled) {
+        return;
+    }
+
+    Private::SearchResultInfo info(result);
+    if (!result.isEmpty()) {
+        ContactManagerPtr manager = connection()->contactManager();
+        info.pendingContacts = manager->contactsForIdentifiers(result.keys());
+        connect(info.pendingContacts,
+                SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(gotSearchResultContacts(Tp::PendingOperation*)));
+    }
+
+    mPriv->searchResultQueue.enqueue(info);
     mPriv->signalsQueue.enqueue(&Private::processSearchResultQueue);
     mPriv->processSignalsQueue();
 }
@@ -621,31 +696,33 @@ void ContactSearchChannel::gotSearchResultContacts(PendingOperation *op)
 {
     PendingContacts *pc = qobject_cast<PendingContacts *>(op);
 
-    const ContactSearchResultMap &result = mPriv->searchResultQueue.dequeue();
+    // Record the contacts now, as batches behind a slower one may finish first
+    // and the PendingContacts is gone once it is signalled
+    QQueue<Private::SearchResultInfo>::iterator it = mPriv->searchResultQueue.begin();
+    for (; it != mPriv->searchResultQueue.end(); ++it) {
+        if (it->pendingContacts == pc) {
+            break;
+        }
+    }
+    if (it == mPriv->searchResultQueue.end()) {
+        return;
+    }
 
-    if (!pc->isValid()) {
-        warning().nospace() << "Getting search result contacts "
+    it->pendingContacts = nullptr;
+    it->resolved = true;
+    if (pc->isValid()) {
+        it->contacts = pc->contacts();
+    } else {
+        TP_QT_WARNING().nospace() << "Getting search result contacts "
             "failed with " << pc->errorName() << ":" <<
             pc->errorMessage() << ". Ignoring search result";
-        mPriv->processingSignalsQueue = false;
-        mPriv->processSignalsQueue();
-        return;
+        it->valid = false;
     }
 
-    const QList<ContactPtr> &contacts = pc->contacts();
-    Q_ASSERT(result.count() == contacts.count());
-
-    SearchResult ret;
-    uint i = 0;
-    for (ContactSearchResultMap::const_iterator it = result.constBegin();
-                                                it != result.constEnd();
-                                                ++it, ++i) {
-        ret.insert(contacts.at(i), Contact::InfoFields(it.value()));
+    if (mPriv->waitingForSearchResultContacts && mPriv->searchResultQueue.head().resolved) {
+        mPriv->waitingForSearchResultContacts = false;
+        mPriv->processSearchResultQueue();
     }
-    emit searchResultReceived(ret);
-
-    mPriv->processingSignalsQueue = false;
-    mPriv->processSignalsQueue();
 }
 
 /**
@@ -669,8 +746,29 @@ void ContactSearchChannel::gotSearchResultContacts(PendingOperation *op)
  * until the searchState() goes to #ChannelContactSearchStateCompleted or
  * #ChannelContactSearchStateFailed.
  *
+ * The contacts for each result are requested as soon as it is received, so
+ * that several results are resolved concurrently, but this signal is still
+ * emitted in the order in which the results were received.
+ *
+ * This signal is not emitted while contact resolution is disabled.
+ *
  * \param result The search result.
- * \sa searchState()
+ * \sa searchState(), rawSearchResultReceived(), setContactResolutionEnabled()
+ */
+
+/**
+ * \fn void ContactSearchChannel::rawSearchResultReceived(
+ *          const Tp::ContactSearchResultMap &result)
+ *
+ * Emitted as soon as a result for a search is received, with the contact identifiers
+ * and their vCard fields, before any Contact object is built for them.
+ *
+ * Unlike searchResultReceived(), this signal does not wait for the contacts
+ * of earlier results to be resolved, so it may be emitted before
+ * searchStateChanged() is emitted for a state change received earlier.
+ *
+ * \param result The search result, mapping contact identifiers to their vCard fields.
+ * \sa searchResultReceived(), setContactResolutionEnabled()
  */
 
 } // Tp
@@ -80,6 +80,9 @@ public:
     QStringList availableSearchKeys() const;
     QString server() const;
 
+    bool isContactResolutionEnabled() const;
+    void setContactResolutionEnabled(bool enabled);
+
     PendingOperation *search(const QString &searchKey, const QString &searchTerm);
     PendingOperation *search(const ContactSearchMap &searchTerms);
     void continueSearch();
@@ -89,6 +92,7 @@ Q_SIGNALS:
     void searchStateChanged(Tp::ChannelContactSearchState state, const QString &errorName,
             const Tp::ContactSearchChannel::SearchStateChangeDetails &details);
     void searchResultReceived(const Tp::ContactSearchChannel::SearchResult &result);
+    void rawSearchResultReceived(const Tp::ContactSearchResultMap &result);
 
 protected:
     ContactSearchChannel(const ConnectionPtr &connection, const QString &objectPath,
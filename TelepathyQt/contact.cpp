@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryContacts
+
 #include <TelepathyQt/Contact>
 
 #include "TelepathyQt/_gen/contact.moc.hpp"
@@ -107,7 +109,7 @@ void Contact::Private::updateAvatarData()
 
     /* If token is empty (""), it means the contact has no avatar. */
     if (avatarToken.isEmpty()) {
-        debug() << "Contact" << parent->id() << "has no avatar";
+        TP_QT_DEBUG() << "Contact" << parent->id() << "has no avatar";
         avatarData = AvatarData();
         emit parent->avatarDataChanged(avatarData);
         return;
@@ -331,7 +333,7 @@ Contact::Contact(ContactManager *manager, const ReferencedHandles &handle,
  */
 Contact::~Contact()
 {
-    debug() << "Contact" << id() << "destroyed";
+    TP_QT_DEBUG() << "Contact" << id() << "destroyed";
     delete mPriv;
 }
 
@@ -397,7 +399,7 @@ Features Contact::actualFeatures() const
 QString Contact::alias() const
 {
     if (!mPriv->requestedFeatures.contains(FeatureAlias)) {
-        warning() << "Contact::alias() used on" << this
+        TP_QT_WARNING() << "Contact::alias() used on" << this
             << "for which FeatureAlias hasn't been requested - returning id";
         return id();
     }
@@ -442,7 +444,7 @@ QStringList Contact::uris() const
 bool Contact::isAvatarTokenKnown() const
 {
     if (!mPriv->requestedFeatures.contains(FeatureAvatarToken)) {
-        warning() << "Contact::isAvatarTokenKnown() used on" << this
+        TP_QT_WARNING() << "Contact::isAvatarTokenKnown() used on" << this
             << "for which FeatureAvatarToken hasn't been requested - returning false";
         return false;
     }
@@ -463,11 +465,11 @@ bool Contact::isAvatarTokenKnown() const
 QString Contact::avatarToken() const
 {
     if (!mPriv->requestedFeatures.contains(FeatureAvatarToken)) {
-        warning() << "Contact::avatarToken() used on" << this
+        TP_QT_WARNING() << "Contact::avatarToken() used on" << this
             << "for which FeatureAvatarToken hasn't been requested - returning \"\"";
         return QString();
     } else if (!isAvatarTokenKnown()) {
-        warning() << "Contact::avatarToken() used on" << this
+        TP_QT_WARNING() << "Contact::avatarToken() used on" << this
             << "for which the avatar token is not (yet) known - returning \"\"";
         return QString();
     }
@@ -488,7 +490,7 @@ QString Contact::avatarToken() const
 AvatarData Contact::avatarData() const
 {
     if (!mPriv->requestedFeatures.contains(FeatureAvatarData)) {
-        warning() << "Contact::avatarData() used on" << this
+        TP_QT_WARNING() << "Contact::avatarData() used on" << this
             << "for which FeatureAvatarData hasn't been requested - returning \"\"";
         return AvatarData();
     }
@@ -514,7 +516,7 @@ AvatarData Contact::avatarData() const
 void Contact::requestAvatarData()
 {
     if (!mPriv->requestedFeatures.contains(FeatureAvatarData)) {
-        warning() << "Contact::requestAvatarData() used on" << this
+        TP_QT_WARNING() << "Contact::requestAvatarData() used on" << this
             << "for which FeatureAvatarData hasn't been requested - returning \"\"";
         return;
     }
@@ -534,7 +536,7 @@ void Contact::requestAvatarData()
 Presence Contact::presence() const
 {
     if (!mPriv->requestedFeatures.contains(FeatureSimplePresence)) {
-        warning() << "Contact::presence() used on" << this
+        TP_QT_WARNING() << "Contact::presence() used on" << this
             << "for which FeatureSimplePresence hasn't been requested - returning Unknown";
         return Presence();
     }
@@ -563,7 +565,7 @@ Presence Contact::presence() const
 ContactCapabilities Contact::capabilities() const
 {
     if (!mPriv->requestedFeatures.contains(FeatureCapabilities)) {
-        warning() << "Contact::capabilities() used on" << this
+        TP_QT_WARNING() << "Contact::capabilities() used on" << this
             << "for which FeatureCapabilities hasn't been requested - returning 0";
         return ContactCapabilities(false);
     }
@@ -583,7 +585,7 @@ ContactCapabilities Contact::capabilities() const
 LocationInfo Contact::location() const
 {
     if (!mPriv->requestedFeatures.contains(FeatureLocation)) {
-        warning() << "Contact::location() used on" << this
+        TP_QT_WARNING() << "Contact::location() used on" << this
             << "for which FeatureLocation hasn't been requested - returning 0";
         return LocationInfo();
     }
@@ -606,7 +608,7 @@ LocationInfo Contact::location() const
 bool Contact::isContactInfoKnown() const
 {
     if (!mPriv->requestedFeatures.contains(FeatureInfo)) {
-        warning() << "Contact::isContactInfoKnown() used on" << this
+        TP_QT_WARNING() << "Contact::isContactInfoKnown() used on" << this
             << "for which FeatureInfo hasn't been requested - returning false";
         return false;
     }
@@ -629,7 +631,7 @@ bool Contact::isContactInfoKnown() const
 Contact::InfoFields Contact::infoFields() const
 {
     if (!mPriv->requestedFeatures.contains(FeatureInfo)) {
-        warning() << "Contact::infoFields() used on" << this
+        TP_QT_WARNING() << "Contact::infoFields() used on" << this
             << "for which FeatureInfo hasn't been requested - returning empty "
                "InfoFields";
         return InfoFields();
@@ -653,7 +655,7 @@ PendingOperation *Contact::refreshInfo()
 {
     ConnectionPtr conn = manager()->connection();
     if (!mPriv->requestedFeatures.contains(FeatureInfo)) {
-        warning() << "Contact::refreshInfo() used on" << this
+        TP_QT_WARNING() << "Contact::refreshInfo() used on" << this
             << "for which FeatureInfo hasn't been requested - failing";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("FeatureInfo needs to be ready in order to "
@@ -948,7 +950,7 @@ PendingOperation *Contact::removeFromGroup(const QString &group)
 QStringList Contact::clientTypes() const
 {
     if (!mPriv->requestedFeatures.contains(FeatureClientTypes)) {
-        warning() << "Contact::clientTypes() used on" << this
+        TP_QT_WARNING() << "Contact::clientTypes() used on" << this
             << "for which FeatureClientTypes hasn't been requested - returning an empty list";
         return QStringList();
     }
@@ -973,7 +975,7 @@ QStringList Contact::clientTypes() const
 PendingStringList *Contact::requestClientTypes()
 {
     if (!mPriv->requestedFeatures.contains(FeatureClientTypes)) {
-        warning() << "Contact::requestClientTypes() used on" << this
+        TP_QT_WARNING() << "Contact::requestClientTypes() used on" << this
             << "for which FeatureClientTypes hasn't been requested - the operation will fail";
     }
 
@@ -1125,23 +1127,28 @@ void Contact::augment(const Features &requestedFeatures, const QVariantMap &attr
                 }
             }
         } else {
-            warning() << "Unknown feature" << feature << "encountered when augmenting Contact";
+            TP_QT_WARNING() << "Unknown feature" << feature << "encountered when augmenting Contact";
         }
     }
 }
 
-void Contact::receiveAlias(const QString &alias)
+bool Contact::receiveAlias(const QString &alias, bool notify)
 {
     if (!mPriv->requestedFeatures.contains(FeatureAlias)) {
-        return;
+        return false;
     }
 
     mPriv->actualFeatures.insert(FeatureAlias);
 
     if (mPriv->alias != alias) {
         mPriv->alias = alias;
-        emit aliasChanged(alias);
+        if (notify) {
+            emit aliasChanged(alias);
+        }
+        return true;
     }
+
+    return false;
 }
 
 void Contact::receiveAvatarToken(const QString &token)
@@ -1176,10 +1183,10 @@ void Contact::receiveAvatarData(const AvatarData &avatar)
     }
 }
 
-void Contact::receiveSimplePresence(const SimplePresence &presence)
+bool Contact::receiveSimplePresence(const SimplePresence &presence, bool notify)
 {
     if (!mPriv->requestedFeatures.contains(FeatureSimplePresence)) {
-        return;
+        return false;
     }
 
     mPriv->actualFeatures.insert(FeatureSimplePresence);
@@ -1187,42 +1194,57 @@ void Contact::receiveSimplePresence(const SimplePresence &presence)
     if (mPriv->presence.status() != presence.status ||
         mPriv->presence.statusMessage() != presence.statusMessage) {
         mPriv->presence.setStatus(presence);
-        emit presenceChanged(mPriv->presence);
+        if (notify) {
+            emit presenceChanged(mPriv->presence);
+        }
+        return true;
     }
+
+    return false;
 }
 
-void Contact::receiveCapabilities(const RequestableChannelClassList &caps)
+bool Contact::receiveCapabilities(const RequestableChannelClassList &caps, bool notify)
 {
     if (!mPriv->requestedFeatures.contains(FeatureCapabilities)) {
-        return;
+        return false;
     }
 
     mPriv->actualFeatures.insert(FeatureCapabilities);
 
     if (mPriv->caps.allClassSpecs().bareClasses() != caps) {
         mPriv->caps.updateRequestableChannelClasses(caps);
-        emit capabilitiesChanged(mPriv->caps);
+        if (notify) {
+            emit capabilitiesChanged(mPriv->caps);
+        }
+        return true;
     }
+
+    return false;
 }
 
-void Contact::receiveLocation(const QVariantMap &location)
+bool Contact::receiveLocation(const QVariantMap &location, bool notify)
 {
     if (!mPriv->requestedFeatures.contains(FeatureLocation)) {
-        return;
+        return false;
     }
 
     mPriv->actualFeatures.insert(FeatureLocation);
 
     if (mPriv->location.allDetails() != location) {
         mPriv->location.updateData(location);
-        emit locationUpdated(mPriv->location);
+        if (notify) {
+            emit locationUpdated(mPriv->location);
+        }
+        return true;
     }
+
+    return false;
 }
 
-void Contact::receiveInfo(const ContactInfoFieldList &info)
+bool Contact::receiveInfo(const ContactInfoFieldList &info, bool notify)
 {
     if (!mPriv->requestedFeatures.contains(FeatureInfo)) {
-        return;
+        return false;
     }
 
     mPriv->actualFeatures.insert(FeatureInfo);
@@ -1230,8 +1252,13 @@ void Contact::receiveInfo(const ContactInfoFieldList &info)
 
     if (mPriv->info.allFields() != info) {
         mPriv->info = InfoFields(info);
-        emit infoFieldsChanged(mPriv->info);
+        if (notify) {
+            emit infoFieldsChanged(mPriv->info);
+        }
+        return true;
     }
+
+    return false;
 }
 
 void Contact::receiveAddresses(const QMap<QString, QString> &addresses,
@@ -1246,18 +1273,23 @@ void Contact::receiveAddresses(const QMap<QString, QString> &addresses,
     mPriv->uris = uris;
 }
 
-void Contact::receiveClientTypes(const QStringList &clientTypes)
+bool Contact::receiveClientTypes(const QStringList &clientTypes, bool notify)
 {
     if (!mPriv->requestedFeatures.contains(FeatureClientTypes)) {
-        return;
+        return false;
     }
 
     mPriv->actualFeatures.insert(FeatureClientTypes);
 
     if (mPriv->clientTypes != clientTypes) {
         mPriv->clientTypes = clientTypes;
-        emit clientTypesChanged(mPriv->clientTypes);
+        if (notify) {
+            emit clientTypesChanged(mPriv->clientTypes);
+        }
+        return true;
     }
+
+    return false;
 }
 
 Contact::PresenceState Contact::subscriptionStateToPresenceState(uint subscriptionState)
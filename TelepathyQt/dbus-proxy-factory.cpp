@@ -240,10 +240,10 @@ DBusProxyPtr DBusProxyFactory::Cache::get(const Key &key) const
 void DBusProxyFactory::Cache::put(const DBusProxyPtr &proxy)
 {
     if (proxy->busName().isEmpty()) {
-        debug() << "Not inserting proxy" << proxy.data() << "with no bus name to factory cache";
+        TP_QT_DEBUG() << "Not inserting proxy" << proxy.data() << "with no bus name to factory cache";
         return;
     } else if (!proxy->isValid()) {
-        debug() << "Not inserting to factory cache invalid proxy - proxy is for" <<
+        TP_QT_DEBUG() << "Not inserting to factory cache invalid proxy - proxy is for" <<
             proxy->busName() << ',' << proxy->objectPath();
         return;
     }
@@ -266,7 +266,7 @@ void DBusProxyFactory::Cache::put(const DBusProxyPtr &proxy)
                     this,
                     SLOT(onProxyInvalidated(Tp::DBusProxy*)));
 
-            debug() << "Replacing invalidated proxy" << existingProxy.data() << "in cache for name"
+            TP_QT_DEBUG() << "Replacing invalidated proxy" << existingProxy.data() << "in cache for name"
                 << existingProxy->busName() << ',' << existingProxy->objectPath();
         }
 
@@ -274,7 +274,7 @@ void DBusProxyFactory::Cache::put(const DBusProxyPtr &proxy)
                 SIGNAL(invalidated(Tp::DBusProxy*,QString,QString)),
                 SLOT(onProxyInvalidated(Tp::DBusProxy*)));
 
-        debug() << "Inserting to factory cache proxy for" << key;
+        TP_QT_DEBUG() << "Inserting to factory cache proxy for" << key;
         proxies.insert(key, proxy);
     }
 }
@@ -287,7 +287,7 @@ void DBusProxyFactory::Cache::onProxyInvalidated(Tp::DBusProxy *proxy)
     // connected to two proxies with the same key, neither of which should happen
     Q_ASSERT(proxies.contains(key));
 
-    debug() << "Removing from factory cache invalidated proxy for" << key;
+    TP_QT_DEBUG() << "Removing from factory cache invalidated proxy for" << key;
 
     proxies.remove(key);
 }
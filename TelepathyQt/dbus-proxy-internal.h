@@ -0,0 +1,111 @@
+/**
+ * This file is part of TelepathyQt
+ *
+ * @copyright Copyright (C) 2008-2010 Collabora Ltd. <http://www.collabora.co.uk/>
+ * @copyright Copyright (C) 2008-2010 Nokia Corporation
+ * @license LGPL 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _TelepathyQt_dbus_proxy_internal_h_HEADER_GUARD_
+#define _TelepathyQt_dbus_proxy_internal_h_HEADER_GUARD_
+
+#include <TelepathyQt/DBusProxy>
+#include <TelepathyQt/Global>
+
+#include <QDBusConnection>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPair>
+#include <QString>
+
+class QDBusPendingCallWatcher;
+class QDBusServiceWatcher;
+
+namespace Tp
+{
+
+class PendingString;
+
+// Process-wide registry of bus name owners, one per QDBusConnection. All
+// StatefulDBusProxy objects for the same bus name share one watched service
+// and one cached owner, instead of each installing its own match rule and
+// calling GetNameOwner.
+//
+// Like the proxies using it, the registry is only meant to be used from the
+// main thread, and is therefore not locked.
+class TP_QT_NO_EXPORT DBusNameOwnerTracker : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(DBusNameOwnerTracker)
+
+public:
+    static DBusNameOwnerTracker *forConnection(const QDBusConnection &bus);
+
+    static QString resolveOwner(const QDBusConnection &bus, const QString &name,
+            QString &error, QString &message);
+    static PendingString *resolveOwnerAsync(const QDBusConnection &bus, const QString &name);
+
+    ~DBusNameOwnerTracker() override;
+
+    void addProxy(const QString &name, StatefulDBusProxy *proxy);
+    void removeProxy(const QString &name, StatefulDBusProxy *proxy);
+
+    bool isWatched(const QString &name) const;
+    QString cachedOwner(const QString &name) const;
+
+private Q_SLOTS:
+    void onServiceOwnerChanged(const QString &name, const QString &oldOwner,
+            const QString &newOwner);
+    void onGetNameOwnerFinished(QDBusPendingCallWatcher *watcher);
+
+private:
+    struct NameInfo
+    {
+        NameInfo() : generation(0) {}
+
+        QString owner;
+        // renewed on every owner change, to discard outdated GetNameOwner replies
+        uint generation;
+        QList<StatefulDBusProxy*> proxies;
+    };
+
+    // the name of the connection and its unique name on the bus, which identify
+    // a live connection even if a connection with the same name is recreated
+    typedef QPair<QString, QString> Key;
+
+    DBusNameOwnerTracker(const QDBusConnection &bus, const Key &key);
+
+    static Key keyFor(const QDBusConnection &bus);
+    static DBusNameOwnerTracker *find(const QDBusConnection &bus);
+    void unregister();
+
+    // Trackers are removed when their last proxy goes away, or when they are
+    // looked up again after their connection has been disconnected
+    static QHash<Key, DBusNameOwnerTracker*> trackers;
+
+    QDBusConnection mBus;
+    Key mKey;
+    QDBusServiceWatcher *mWatcher;
+    QHash<QString, NameInfo> mNames;
+    uint mLastGeneration;
+    QHash<QDBusPendingCallWatcher*, QPair<QString, uint> > mPendingLookups;
+};
+
+} // Tp
+
+#endif
@@ -23,16 +23,23 @@
 #include "config.h"
 
 #include <TelepathyQt/DBusProxy>
+#include "TelepathyQt/dbus-proxy-internal.h"
 
 #include "TelepathyQt/_gen/dbus-proxy.moc.hpp"
+#include "TelepathyQt/_gen/dbus-proxy-internal.moc.hpp"
 
 #include "TelepathyQt/debug-internal.h"
 
 #include <TelepathyQt/Constants>
+#include <TelepathyQt/PendingString>
 
 #include <QDBusConnection>
 #include <QDBusConnectionInterface>
 #include <QDBusError>
+#include <QDBusMessage>
+#include <QDBusPendingCall>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
 #include <QDBusServiceWatcher>
 #include <QTimer>
 
@@ -67,7 +74,7 @@ DBusProxy::Private::Private(const QDBusConnection &dbusConnection,
       busName(busName),
       objectPath(objectPath)
 {
-    debug() << "Creating new DBusProxy";
+    TP_QT_DEBUG() << "Creating new DBusProxy";
 }
 
 /**
@@ -196,7 +203,7 @@ QString DBusProxy::invalidationMessage() const
 void DBusProxy::invalidate(const QString &reason, const QString &message)
 {
     if (!isValid()) {
-        debug().nospace() << "Already invalidated by "
+        TP_QT_DEBUG().nospace() << "Already invalidated by "
             << mPriv->invalidationReason
             << ", not replacing with " << reason
             << " \"" << message << "\"";
@@ -205,7 +212,7 @@ void DBusProxy::invalidate(const QString &reason, const QString &message)
 
     Q_ASSERT(!reason.isEmpty());
 
-    debug().nospace() << "proxy invalidated: " << reason
+    TP_QT_DEBUG().nospace() << "proxy invalidated: " << reason
         << ": " << message;
 
     mPriv->invalidationReason = reason;
@@ -245,14 +252,218 @@ void DBusProxy::emitInvalidated()
  * \param errorMessage A debugging message associated with the error.
  */
 
+// ==== DBusNameOwnerTracker ===========================================
+
+QHash<DBusNameOwnerTracker::Key, DBusNameOwnerTracker*> DBusNameOwnerTracker::trackers;
+
+DBusNameOwnerTracker::Key DBusNameOwnerTracker::keyFor(const QDBusConnection &bus)
+{
+    return qMakePair(bus.name(), bus.baseService());
+}
+
+DBusNameOwnerTracker *DBusNameOwnerTracker::find(const QDBusConnection &bus)
+{
+    Key key = keyFor(bus);
+    DBusNameOwnerTracker *tracker = trackers.value(key);
+    if (tracker && !tracker->mBus.isConnected()) {
+        // the connection went away, the proxies still bound to it will clean
+        // up the tracker when they are destroyed
+        tracker->unregister();
+        return nullptr;
+    }
+    return tracker;
+}
+
+DBusNameOwnerTracker *DBusNameOwnerTracker::forConnection(const QDBusConnection &bus)
+{
+    DBusNameOwnerTracker *tracker = find(bus);
+    if (!tracker) {
+        Key key = keyFor(bus);
+        tracker = new DBusNameOwnerTracker(bus, key);
+        trackers.insert(key, tracker);
+    }
+    return tracker;
+}
+
+DBusNameOwnerTracker::DBusNameOwnerTracker(const QDBusConnection &bus, const Key &key)
+    : QObject(),
+      mBus(bus),
+      mKey(key),
+      mWatcher(new QDBusServiceWatcher(this)),
+      mLastGeneration(0)
+{
+    mWatcher->setConnection(bus);
+    mWatcher->setWatchMode(QDBusServiceWatcher::WatchForOwnerChange);
+    connect(mWatcher,
+            SIGNAL(serviceOwnerChanged(QString,QString,QString)),
+            SLOT(onServiceOwnerChanged(QString,QString,QString)));
+}
+
+DBusNameOwnerTracker::~DBusNameOwnerTracker()
+{
+    unregister();
+}
+
+void DBusNameOwnerTracker::unregister()
+{
+    QHash<Key, DBusNameOwnerTracker*>::iterator i = trackers.find(mKey);
+    if (i != trackers.end() && i.value() == this) {
+        trackers.erase(i);
+    }
+}
+
+void DBusNameOwnerTracker::addProxy(const QString &name, StatefulDBusProxy *proxy)
+{
+    QHash<QString, NameInfo>::iterator i = mNames.find(name);
+    if (i == mNames.end()) {
+        // Watch the name before resolving its owner, so that an owner change
+        // between the two is not missed
+        i = mNames.insert(name, NameInfo());
+        i->generation = ++mLastGeneration;
+        mWatcher->addWatchedService(name);
+    }
+    i->proxies.append(proxy);
+}
+
+void DBusNameOwnerTracker::removeProxy(const QString &name, StatefulDBusProxy *proxy)
+{
+    QHash<QString, NameInfo>::iterator i = mNames.find(name);
+    if (i == mNames.end()) {
+        return;
+    }
+
+    i->proxies.removeOne(proxy);
+    if (i->proxies.isEmpty()) {
+        mNames.erase(i);
+        mWatcher->removeWatchedService(name);
+    }
+
+    if (mNames.isEmpty()) {
+        // Proxies may be destroyed while this tracker notifies them of an owner
+        // change, so it cannot be deleted right away
+        unregister();
+        deleteLater();
+    }
+}
+
+bool DBusNameOwnerTracker::isWatched(const QString &name) const
+{
+    return mNames.contains(name);
+}
+
+QString DBusNameOwnerTracker::cachedOwner(const QString &name) const
+{
+    // the owner is only kept up to date while the name is watched
+    QHash<QString, NameInfo>::const_iterator i = mNames.constFind(name);
+    return i != mNames.constEnd() ? i->owner : QString();
+}
+
+QString DBusNameOwnerTracker::resolveOwner(const QDBusConnection &bus, const QString &name,
+        QString &error, QString &message)
+{
+    if (name.startsWith(QLatin1String(":"))) {
+        return name;
+    }
+
+    DBusNameOwnerTracker *tracker = find(bus);
+    if (tracker) {
+        QString owner = tracker->cachedOwner(name);
+        if (!owner.isEmpty()) {
+            return owner;
+        }
+    }
+
+    QDBusReply<QString> reply = bus.interface()->serviceOwner(name);
+    if (!reply.isValid()) {
+        error = reply.error().name();
+        message = reply.error().message();
+        return QString();
+    }
+
+    if (tracker) {
+        QHash<QString, NameInfo>::iterator i = tracker->mNames.find(name);
+        if (i != tracker->mNames.end()) {
+            i->owner = reply.value();
+        }
+    }
+    return reply.value();
+}
+
+PendingString *DBusNameOwnerTracker::resolveOwnerAsync(const QDBusConnection &bus,
+        const QString &name)
+{
+    DBusNameOwnerTracker *tracker = find(bus);
+    QString owner = name;
+    if (!name.startsWith(QLatin1String(":"))) {
+        owner = tracker ? tracker->cachedOwner(name) : QString();
+    }
+
+    if (!owner.isEmpty()) {
+        QDBusMessage call = QDBusMessage::createMethodCall(
+                QLatin1String("org.freedesktop.DBus"), QLatin1String("/org/freedesktop/DBus"),
+                QLatin1String("org.freedesktop.DBus"), QLatin1String("GetNameOwner"));
+        return new PendingString(QDBusPendingCall::fromCompletedCall(call.createReply(owner)),
+                SharedPtr<RefCounted>());
+    }
+
+    QDBusPendingCall call = bus.interface()->asyncCall(QLatin1String("GetNameOwner"), name);
+    if (tracker) {
+        QHash<QString, NameInfo>::const_iterator i = tracker->mNames.constFind(name);
+        if (i != tracker->mNames.constEnd()) {
+            QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(call, tracker);
+            tracker->mPendingLookups.insert(watcher, qMakePair(name, i->generation));
+            tracker->connect(watcher,
+                    SIGNAL(finished(QDBusPendingCallWatcher*)),
+                    SLOT(onGetNameOwnerFinished(QDBusPendingCallWatcher*)));
+        }
+    }
+    return new PendingString(call, SharedPtr<RefCounted>());
+}
+
+void DBusNameOwnerTracker::onServiceOwnerChanged(const QString &name, const QString &oldOwner,
+        const QString &newOwner)
+{
+    QHash<QString, NameInfo>::iterator i = mNames.find(name);
+    if (i == mNames.end()) {
+        return;
+    }
+
+    i->owner = newOwner;
+    i->generation = ++mLastGeneration;
+
+    // copy, as proxies may unregister themselves while being notified
+    QList<StatefulDBusProxy*> proxies = i->proxies;
+    foreach (StatefulDBusProxy *proxy, proxies) {
+        proxy->onServiceOwnerChanged(name, oldOwner, newOwner);
+    }
+}
+
+void DBusNameOwnerTracker::onGetNameOwnerFinished(QDBusPendingCallWatcher *watcher)
+{
+    QPair<QString, uint> lookup = mPendingLookups.take(watcher);
+    QDBusPendingReply<QString> reply = *watcher;
+    watcher->deleteLater();
+
+    if (reply.isError()) {
+        return;
+    }
+
+    QHash<QString, NameInfo>::iterator i = mNames.find(lookup.first);
+    if (i != mNames.end() && i->generation == lookup.second) {
+        i->owner = reply.value();
+    }
+}
+
 // ==== StatefulDBusProxy ==============================================
 
 struct TP_QT_NO_EXPORT StatefulDBusProxy::Private
 {
-    Private(const QString &originalName)
-        : originalName(originalName) {}
+    Private(const QString &originalName, DBusNameOwnerTracker *tracker)
+        : originalName(originalName),
+          tracker(tracker) {}
 
     QString originalName;
+    DBusNameOwnerTracker *tracker;
 };
 
 /**
@@ -280,16 +491,13 @@ struct TP_QT_NO_EXPORT StatefulDBusProxy::Private
 StatefulDBusProxy::StatefulDBusProxy(const QDBusConnection &dbusConnection,
         const QString &busName, const QString &objectPath, const Feature &featureCore)
     : DBusProxy(dbusConnection, busName, objectPath, featureCore),
-      mPriv(new Private(busName))
+      mPriv(new Private(busName, DBusNameOwnerTracker::forConnection(dbusConnection)))
 {
-    QDBusServiceWatcher *serviceWatcher = new QDBusServiceWatcher(busName,
-            dbusConnection, QDBusServiceWatcher::WatchForUnregistration, this);
-    connect(serviceWatcher,
-            SIGNAL(serviceOwnerChanged(QString,QString,QString)),
-            SLOT(onServiceOwnerChanged(QString,QString,QString)));
+    mPriv->tracker->addProxy(busName, this);
 
     QString error, message;
-    QString uniqueName = uniqueNameFrom(dbusConnection, busName, error, message);
+    QString uniqueName = DBusNameOwnerTracker::resolveOwner(dbusConnection, busName,
+            error, message);
 
     if (uniqueName.isEmpty()) {
         invalidate(error, message);
@@ -304,6 +512,7 @@ StatefulDBusProxy::StatefulDBusProxy(const QDBusConnection &dbusConnection,
  */
 StatefulDBusProxy::~StatefulDBusProxy()
 {
+    mPriv->tracker->removeProxy(mPriv->originalName, this);
     delete mPriv;
 }
 
@@ -312,8 +521,8 @@ QString StatefulDBusProxy::uniqueNameFrom(const QDBusConnection &bus, const QStr
     QString error, message;
     QString uniqueName = uniqueNameFrom(bus, name, error, message);
     if (uniqueName.isEmpty()) {
-        warning() << "StatefulDBusProxy::uniqueNameFrom(): Failed to get unique name of" << name;
-        warning() << "  error:" << error << "message:" << message;
+        TP_QT_WARNING() << "StatefulDBusProxy::uniqueNameFrom(): Failed to get unique name of" << name;
+        TP_QT_WARNING() << "  error:" << error << "message:" << message;
     }
 
     return uniqueName;
@@ -322,20 +531,30 @@ QString StatefulDBusProxy::uniqueNameFrom(const QDBusConnection &bus, const QStr
 QString StatefulDBusProxy::uniqueNameFrom(const QDBusConnection &bus, const QString &name,
         QString &error, QString &message)
 {
-    if (name.startsWith(QLatin1String(":"))) {
-        return name;
-    }
-
     // For a stateful interface, it makes no sense to follow name-owner
     // changes, so we want to bind to the unique name.
-    QDBusReply<QString> reply = bus.interface()->serviceOwner(name);
-    if (reply.isValid()) {
-        return reply.value();
-    } else {
-        error = reply.error().name();
-        message = reply.error().message();
-        return QString();
-    }
+    return DBusNameOwnerTracker::resolveOwner(bus, name, error, message);
+}
+
+/**
+ * Asynchronously resolve \a wellKnownOrUnique to the unique name of its current owner.
+ *
+ * If \a wellKnownOrUnique is already a unique name, or another StatefulDBusProxy
+ * on \a bus is bound to it and its owner is therefore already known, no D-Bus call
+ * is made. Otherwise a single non-blocking GetNameOwner call is issued.
+ *
+ * Resolving a name this way before constructing proxies for it does not block
+ * the calling thread, unlike uniqueNameFrom().
+ *
+ * \param bus The D-Bus connection to use.
+ * \param wellKnownOrUnique The bus name to resolve.
+ * \return A PendingString which will emit PendingString::finished when the unique
+ *         name has been resolved.
+ */
+PendingString *StatefulDBusProxy::uniqueNameFromAsync(const QDBusConnection &bus,
+        const QString &wellKnownOrUnique)
+{
+    return DBusNameOwnerTracker::resolveOwnerAsync(bus, wellKnownOrUnique);
 }
 
 void StatefulDBusProxy::onServiceOwnerChanged(const QString &name, const QString &oldOwner, const QString &newOwner)
@@ -378,7 +597,7 @@ StatelessDBusProxy::StatelessDBusProxy(const QDBusConnection &dbusConnection,
       mPriv(nullptr)
 {
     if (busName.startsWith(QLatin1String(":"))) {
-        warning() <<
+        TP_QT_WARNING() <<
             "Using StatelessDBusProxy for a unique name does not make sense";
     }
 }
@@ -37,6 +37,8 @@ class QDBusError;
 namespace Tp
 {
 
+class DBusNameOwnerTracker;
+class PendingString;
 class TestBackdoors;
 
 class TP_QT_EXPORT DBusProxy : public Object, public ReadyObject
@@ -106,12 +108,16 @@ public:
     static QString uniqueNameFrom(const QDBusConnection &bus, const QString &wellKnownOrUnique);
     static QString uniqueNameFrom(const QDBusConnection &bus, const QString &wellKnownOrUnique,
             QString &error, QString &message);
+    static PendingString *uniqueNameFromAsync(const QDBusConnection &bus,
+            const QString &wellKnownOrUnique);
 
 private Q_SLOTS:
     TP_QT_NO_EXPORT void onServiceOwnerChanged(const QString &name, const QString &oldOwner,
             const QString &newOwner);
 
 private:
+    friend class DBusNameOwnerTracker;
+
     struct Private;
     friend struct Private;
     Private *mPriv;
@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryService
+
 #include <TelepathyQt/DBusService>
 
 #include "TelepathyQt/_gen/dbus-service.moc.hpp"
@@ -168,7 +170,7 @@ bool DBusService::registerObject(const QString &busName, const QString &objectPa
         error->set(TP_QT_ERROR_INVALID_ARGUMENT,
                 QString(QLatin1String("Object at path %1 already registered"))
                     .arg(objectPath));
-        warning() << "Unable to register object" << objectPath <<
+        TP_QT_WARNING() << "Unable to register object" << objectPath <<
             "- path already registered";
         return false;
     }
@@ -178,12 +180,12 @@ bool DBusService::registerObject(const QString &busName, const QString &objectPa
         error->set(TP_QT_ERROR_INVALID_ARGUMENT,
                 QString(QLatin1String("Name %1 already in use by another process"))
                     .arg(busName));
-        warning() << "Unable to register service" << busName <<
+        TP_QT_WARNING() << "Unable to register service" << busName <<
             "- name already registered by another process";
         return false;
     }
 
-    debug() << "Registered object" << objectPath << "at bus name" << busName;
+    TP_QT_DEBUG() << "Registered object" << objectPath << "at bus name" << busName;
 
     mPriv->busName = busName;
     mPriv->dbusObject->setObjectPath(objectPath);
@@ -19,6 +19,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/DBusTubeChannel>
 
 #include "TelepathyQt/_gen/dbus-tube-channel.moc.hpp"
@@ -53,10 +55,13 @@ struct TP_QT_NO_EXPORT DBusTubeChannel::Private
     UIntList accessControls;
     QString serviceName;
     QHash<QString, Tp::ContactPtr> contactsForBusNames;
+    // Reverse index of contactsForBusNames, so that removing a participant
+    // doesn't need to scan all the others
+    QHash<Tp::ContactPtr, QString> busNamesForContacts;
     QString address;
 
     QHash<QUuid, QString> pendingNewBusNamesToAdd;
-    QList<QUuid> pendingNewBusNamesToRemove;
+    QSet<QUuid> pendingNewBusNamesToRemove;
 
     QueuedContactFactory *queuedContactFactory;
 };
@@ -102,6 +107,7 @@ void DBusTubeChannel::Private::extractProperties(const QVariantMap &props)
 void DBusTubeChannel::Private::extractParticipants(const Tp::DBusTubeParticipants &participants)
 {
     contactsForBusNames.clear();
+    busNamesForContacts.clear();
     for (DBusTubeParticipants::const_iterator i = participants.constBegin();
          i != participants.constEnd();
          ++i) {
@@ -129,7 +135,7 @@ void DBusTubeChannel::Private::introspectBusNamesMonitoring(DBusTubeChannel::Pri
         connect(dbusTubeInterface->requestPropertyDBusNames(), SIGNAL(finished(Tp::PendingOperation*)),
                 parent, SLOT(onRequestPropertyDBusNamesFinished(Tp::PendingOperation*)));
     } else {
-        debug() << "FeatureBusNameMonitoring does not make sense in a P2P context";
+        TP_QT_DEBUG() << "FeatureBusNameMonitoring does not make sense in a P2P context";
         self->readinessHelper->setIntrospectCompleted(DBusTubeChannel::FeatureBusNameMonitoring, false);
     }
 }
@@ -138,7 +144,7 @@ void DBusTubeChannel::Private::introspectDBusTube(DBusTubeChannel::Private *self
 {
     DBusTubeChannel *parent = self->parent;
 
-    debug() << "Introspect dbus tube properties";
+    TP_QT_DEBUG() << "Introspect dbus tube properties";
 
     if (parent->immutableProperties().contains(TP_QT_IFACE_CHANNEL_TYPE_DBUS_TUBE + QLatin1String(".ServiceName")) &&
         parent->immutableProperties().contains(TP_QT_IFACE_CHANNEL_TYPE_DBUS_TUBE + QLatin1String(".SupportedAccessControls"))) {
@@ -245,7 +251,7 @@ DBusTubeChannel::~DBusTubeChannel()
 QString DBusTubeChannel::serviceName() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "DBusTubeChannel::serviceName() used with "
+        TP_QT_WARNING() << "DBusTubeChannel::serviceName() used with "
             "FeatureCore not ready";
         return QString();
     }
@@ -277,7 +283,7 @@ QString DBusTubeChannel::serviceName() const
 bool DBusTubeChannel::supportsRestrictingToCurrentUser() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "DBusTubeChannel::supportsRestrictingToCurrentUser() used with "
+        TP_QT_WARNING() << "DBusTubeChannel::supportsRestrictingToCurrentUser() used with "
             "FeatureCore not ready";
         return false;
     }
@@ -303,7 +309,7 @@ bool DBusTubeChannel::supportsRestrictingToCurrentUser() const
 QString DBusTubeChannel::address() const
 {
     if (state() != TubeChannelStateOpen) {
-        warning() << "DBusTubeChannel::address() can be called only if "
+        TP_QT_WARNING() << "DBusTubeChannel::address() can be called only if "
             "the tube has already been opened";
         return QString();
     }
@@ -328,7 +334,7 @@ QString DBusTubeChannel::address() const
 QHash<QString, Tp::ContactPtr> DBusTubeChannel::contactsForBusNames() const
 {
     if (!isReady(FeatureBusNameMonitoring)) {
-        warning() << "DBusTubeChannel::contactsForBusNames() used with "
+        TP_QT_WARNING() << "DBusTubeChannel::contactsForBusNames() used with "
             "FeatureBusNameMonitoring not ready";
         return QHash<QString, Tp::ContactPtr>();
     }
@@ -339,7 +345,7 @@ QHash<QString, Tp::ContactPtr> DBusTubeChannel::contactsForBusNames() const
 void DBusTubeChannel::onRequestAllPropertiesFinished(PendingOperation *op)
 {
     if (!op->isError()) {
-        debug() << "RequestAllProperties succeeded";
+        TP_QT_DEBUG() << "RequestAllProperties succeeded";
         PendingVariantMap *result = qobject_cast<PendingVariantMap*>(op);
 
         QVariantMap map = result->result();
@@ -353,7 +359,7 @@ void DBusTubeChannel::onRequestAllPropertiesFinished(PendingOperation *op)
         mPriv->extractProperties(qualifiedMap);
         mPriv->readinessHelper->setIntrospectCompleted(DBusTubeChannel::FeatureCore, true);
     } else {
-        warning().nospace() << "RequestAllProperties failed "
+        TP_QT_WARNING().nospace() << "RequestAllProperties failed "
             "with " << op->errorName() << ": " << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(DBusTubeChannel::FeatureCore, false);
     }
@@ -362,7 +368,7 @@ void DBusTubeChannel::onRequestAllPropertiesFinished(PendingOperation *op)
 void DBusTubeChannel::onRequestPropertyDBusNamesFinished(PendingOperation *op)
 {
     if (!op->isError()) {
-        debug() << "RequestPropertyDBusNames succeeded";
+        TP_QT_DEBUG() << "RequestPropertyDBusNames succeeded";
         PendingVariant *result = qobject_cast<PendingVariant*>(op);
         DBusTubeParticipants participants = qdbus_cast<DBusTubeParticipants>(result->result());
 
@@ -378,7 +384,7 @@ void DBusTubeChannel::onRequestPropertyDBusNamesFinished(PendingOperation *op)
             mPriv->extractParticipants(participants);
         }
     } else {
-        warning().nospace() << "RequestPropertyDBusNames failed "
+        TP_QT_WARNING().nospace() << "RequestPropertyDBusNames failed "
             "with " << op->errorName() << ": " << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(DBusTubeChannel::FeatureBusNameMonitoring, false);
     }
@@ -386,7 +392,7 @@ void DBusTubeChannel::onRequestPropertyDBusNamesFinished(PendingOperation *op)
 
 void DBusTubeChannel::onQueueCompleted()
 {
-    debug() << "Queue was completed";
+    TP_QT_DEBUG() << "Queue was completed";
 
     // Set the feature as completed, and disconnect the signal as it's no longer useful
     mPriv->readinessHelper->setIntrospectCompleted(DBusTubeChannel::FeatureBusNameMonitoring, true);
@@ -409,7 +415,7 @@ void DBusTubeChannel::onDBusNamesChanged(const Tp::DBusTubeParticipants &added,
     foreach (uint handle, removed) {
         QUuid uuid = mPriv->queuedContactFactory->appendNewRequest(UIntList() << handle);
         // Add it to pending removed as well
-        mPriv->pendingNewBusNamesToRemove << uuid;
+        mPriv->pendingNewBusNamesToRemove.insert(uuid);
     }
 }
 
@@ -421,20 +427,25 @@ void DBusTubeChannel::onContactsRetrieved(const QUuid &uuid, const QList<Contact
 
         // Add it to our connections hash
         foreach (const Tp::ContactPtr &contact, contacts) {
+            Tp::ContactPtr previous = mPriv->contactsForBusNames.value(busName);
+            if (previous && mPriv->busNamesForContacts.value(previous) == busName) {
+                mPriv->busNamesForContacts.remove(previous);
+            }
             mPriv->contactsForBusNames.insert(busName, contact);
+            mPriv->busNamesForContacts.insert(contact, busName);
 
             // Time for us to emit the signal - if the feature is ready
             if (isReady(FeatureBusNameMonitoring)) {
                 emit busNameAdded(busName, contact);
             }
         }
-    } else if (mPriv->pendingNewBusNamesToRemove.contains(uuid)) {
-        mPriv->pendingNewBusNamesToRemove.removeOne(uuid);
-
+    } else if (mPriv->pendingNewBusNamesToRemove.remove(uuid)) {
         // Remove it from our connections hash
         foreach (const Tp::ContactPtr &contact, contacts) {
-            if (mPriv->contactsForBusNames.values().contains(contact)) {
-                QString busName = mPriv->contactsForBusNames.key(contact);
+            QHash<Tp::ContactPtr, QString>::iterator i = mPriv->busNamesForContacts.find(contact);
+            if (i != mPriv->busNamesForContacts.end()) {
+                QString busName = i.value();
+                mPriv->busNamesForContacts.erase(i);
                 mPriv->contactsForBusNames.remove(busName);
 
                 // Time for us to emit the signal - if the feature is ready
@@ -442,12 +453,12 @@ void DBusTubeChannel::onContactsRetrieved(const QUuid &uuid, const QList<Contact
                     emit busNameRemoved(busName, contact);
                 }
             } else {
-                warning() << "Trying to remove a bus name for contact " << contact->id()
+                TP_QT_WARNING() << "Trying to remove a bus name for contact " << contact->id()
                           << " which has not been retrieved previously!";
             }
         }
     } else {
-        warning() << "Contacts retrieved but no pending bus names were found";
+        TP_QT_WARNING() << "Contacts retrieved but no pending bus names were found";
         return;
     }
 }
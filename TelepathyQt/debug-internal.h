@@ -25,8 +25,15 @@
 
 #include <QDebug>
 
+#include <TelepathyQt/Debug>
 #include <TelepathyQt/Global>
 
+// Source files may define this before their first include to have their debug
+// output enabled together with a subsystem, rather than with the general category
+#ifndef TP_QT_DEBUG_CATEGORY
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryGeneral
+#endif
+
 namespace Tp
 {
 
@@ -35,24 +42,19 @@ class TP_QT_EXPORT Debug
 public:
     inline Debug() : debug(nullptr) { }
     inline Debug(QtMsgType type) : type(type), debug(new QDebug(&msg)) { }
-    inline Debug(const Debug &a) : type(a.type), debug(a.debug ? new QDebug(&msg) : nullptr)
+    inline Debug(const Debug &a) : msg(a.msg), type(a.type), debug(a.debug ? new QDebug(&msg) : nullptr)
     {
-        if (debug) {
-            (*debug) << qPrintable(a.msg);
-        }
+        // QDebug appends to msg, so the message so far is copied as is rather
+        // than streamed again
     }
 
     inline Debug &operator=(const Debug &a)
     {
         if (this != &a) {
+            msg = a.msg;
             type = a.type;
             delete debug;
-            debug = nullptr;
-
-            if (a.debug) {
-                debug = new QDebug(&msg);
-                (*debug) << qPrintable(a.msg);
-            }
+            debug = a.debug ? new QDebug(&msg) : nullptr;
         }
 
         return *this;
@@ -94,7 +96,7 @@ public:
     }
 
     template <typename T>
-    inline Debug &operator<<(T a)
+    inline Debug &operator<<(const T &a)
     {
         if (debug) {
             (*debug) << a;
@@ -117,19 +119,9 @@ private:
 TP_QT_EXPORT Debug enabledDebug();
 TP_QT_EXPORT Debug enabledWarning();
 
-#ifdef ENABLE_DEBUG
-
-inline Debug debug()
-{
-    return enabledDebug();
-}
-
-inline Debug warning()
-{
-    return enabledWarning();
-}
-
-#else /* #ifdef ENABLE_DEBUG */
+// Also used by the service library, which cannot reach unexported symbols
+TP_QT_EXPORT bool isDebugEnabled(DebugCategory category);
+TP_QT_EXPORT bool isWarningEnabled();
 
 struct NoDebug
 {
@@ -155,18 +147,29 @@ struct NoDebug
     }
 };
 
-inline NoDebug debug()
-{
-    return NoDebug();
-}
+} // Tp
 
-inline NoDebug warning()
-{
-    return NoDebug();
-}
+// TP_QT_DEBUG() and TP_QT_WARNING() are macros rather than functions, so that
+// the operands streamed into them are not even evaluated when the output is
+// disabled. The one-iteration loops keep them usable as single statements,
+// including before an else.
+#ifdef ENABLE_DEBUG
 
-#endif /* #ifdef ENABLE_DEBUG */
+#define TP_QT_DEBUG() \
+    for (bool tpQtDebugEnabled = Tp::isDebugEnabled(TP_QT_DEBUG_CATEGORY); \
+            tpQtDebugEnabled; tpQtDebugEnabled = false) \
+        Tp::Debug(QtDebugMsg)
 
-} // Tp
+#define TP_QT_WARNING() \
+    for (bool tpQtWarningEnabled = Tp::isWarningEnabled(); \
+            tpQtWarningEnabled; tpQtWarningEnabled = false) \
+        Tp::Debug(QtWarningMsg)
+
+#else /* #ifdef ENABLE_DEBUG */
+
+#define TP_QT_DEBUG() while (false) Tp::NoDebug()
+#define TP_QT_WARNING() while (false) Tp::NoDebug()
+
+#endif /* #ifdef ENABLE_DEBUG */
 
 #endif
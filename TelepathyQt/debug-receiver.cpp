@@ -150,7 +150,7 @@ PendingDebugMessageList *DebugReceiver::fetchMessages()
 PendingOperation *DebugReceiver::setMonitoringEnabled(bool enabled)
 {
     if (!isReady()) {
-        warning() << "DebugReceiver::setMonitoringEnabled called without DebugReceiver being ready";
+        TP_QT_WARNING() << "DebugReceiver::setMonitoringEnabled called without DebugReceiver being ready";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("FeatureCore is not ready"), DebugReceiverPtr(this));
     }
@@ -37,6 +37,11 @@
  * warning messages. Normal debug output results in the normal operation of the
  * library, warning messages are output only when something goes wrong. Each
  * category can be invidually enabled.
+ *
+ * Normal debug output is further divided by subsystem, see DebugCategory,
+ * so that for instance only the contact handling of the library can be traced.
+ * Debug statements for disabled categories cost a single check: what they
+ * would have printed is not even evaluated.
  */
 
 namespace Tp
@@ -52,9 +57,46 @@ namespace Tp
  *
  * The default is <code>false</code> ie. no debug output.
  *
+ * This enables or disables all of the categories listed in DebugCategory.
+ *
+ * \param enable Whether debug output should be enabled or not.
+ */
+
+/**
+ * \enum DebugCategory
+ * \ingroup debug
+ *
+ * The subsystems whose debug output can be enabled separately.
+ *
+ * \value DebugCategoryGeneral Output not covered by any other category.
+ * \value DebugCategoryContacts Contact objects, contact attributes and handles.
+ * \value DebugCategoryChannels Channel proxies, channel requests and dispatching.
+ * \value DebugCategoryRoster The contact list of ContactManager.
+ * \value DebugCategoryService The Base* classes of the service library.
+ * \value DebugCategoryAll All of the above.
+ */
+
+/**
+ * \fn void enableDebug(DebugCategories categories, bool enable)
+ * \ingroup debug
+ *
+ * Enable or disable normal debug output from the library for the given
+ * \a categories only, leaving the other categories as they are. If the library
+ * is not compiled with debug support enabled, this has no effect.
+ *
+ * \param categories The categories to change.
  * \param enable Whether debug output should be enabled or not.
  */
 
+/**
+ * \fn DebugCategories enabledDebugCategories()
+ * \ingroup debug
+ *
+ * Return the categories for which normal debug output is enabled.
+ *
+ * \return The enabled categories.
+ */
+
 /**
  * \fn void enableWarnings(bool enable)
  * \ingroup debug
@@ -98,14 +140,28 @@ namespace Tp
 
 namespace
 {
-bool debugEnabled = false;
+DebugCategories debugCategories;
 bool warningsEnabled = true;
 DebugCallback debugCallback = nullptr;
 }
 
 void enableDebug(bool enable)
 {
-    debugEnabled = enable;
+    debugCategories = enable ? DebugCategories(DebugCategoryAll) : DebugCategories();
+}
+
+void enableDebug(DebugCategories categories, bool enable)
+{
+    if (enable) {
+        debugCategories |= categories;
+    } else {
+        debugCategories &= ~categories;
+    }
+}
+
+DebugCategories enabledDebugCategories()
+{
+    return debugCategories;
 }
 
 void enableWarnings(bool enable)
@@ -118,9 +174,19 @@ void setDebugCallback(DebugCallback cb)
     debugCallback = cb;
 }
 
+bool isDebugEnabled(DebugCategory category)
+{
+    return debugCategories.testFlag(category);
+}
+
+bool isWarningEnabled()
+{
+    return warningsEnabled;
+}
+
 Debug enabledDebug()
 {
-    if (debugEnabled) {
+    if (debugCategories) {
         return Debug(QtDebugMsg);
     } else {
         return Debug();
@@ -160,6 +226,25 @@ void enableDebug(bool enable)
 {
 }
 
+void enableDebug(DebugCategories categories, bool enable)
+{
+}
+
+DebugCategories enabledDebugCategories()
+{
+    return DebugCategories();
+}
+
+bool isDebugEnabled(DebugCategory category)
+{
+    return false;
+}
+
+bool isWarningEnabled()
+{
+    return false;
+}
+
 void enableWarnings(bool enable)
 {
 }
@@ -29,10 +29,25 @@
 
 #include <TelepathyQt/Global>
 
+#include <QFlags>
+
 namespace Tp
 {
 
+enum DebugCategory
+{
+    DebugCategoryGeneral = 0x01,
+    DebugCategoryContacts = 0x02,
+    DebugCategoryChannels = 0x04,
+    DebugCategoryRoster = 0x08,
+    DebugCategoryService = 0x10,
+    DebugCategoryAll = 0x1f
+};
+Q_DECLARE_FLAGS(DebugCategories, DebugCategory)
+
 TP_QT_EXPORT void enableDebug(bool enable);
+TP_QT_EXPORT void enableDebug(DebugCategories categories, bool enable);
+TP_QT_EXPORT DebugCategories enabledDebugCategories();
 TP_QT_EXPORT void enableWarnings(bool enable);
 
 typedef void (*DebugCallback)(const QString &libraryName,
@@ -43,4 +58,6 @@ TP_QT_EXPORT void setDebugCallback(DebugCallback cb);
 
 } // Tp
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(Tp::DebugCategories)
+
 #endif
@@ -0,0 +1,141 @@
+/**
+ * This file is part of TelepathyQt
+ *
+ * @copyright Copyright (C) 2012 Collabora Ltd. <http://www.collabora.co.uk/>
+ * @license LGPL 2.1
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _TelepathyQt_deferred_result_h_HEADER_GUARD_
+#define _TelepathyQt_deferred_result_h_HEADER_GUARD_
+
+#ifndef IN_TP_QT_HEADER
+#error IN_TP_QT_HEADER
+#endif
+
+#include <TelepathyQt/Callbacks>
+#include <TelepathyQt/CompletionHandle>
+#include <TelepathyQt/DBusError>
+#include <TelepathyQt/Global>
+#include <TelepathyQt/SharedPtr>
+
+#include <QSharedPointer>
+#include <QString>
+
+namespace Tp
+{
+
+// The result of a service-side method call which is completed later, handed
+// to the asynchronous callbacks of the Base* classes. The callback keeps a
+// reference and calls setFinished() or setFinishedWithError() once the
+// result is known, without blocking the event loop meanwhile.
+//
+// The completion state is a CompletionHandle, which the continuation
+// receives together with the value. Neither refers back to the
+// DeferredResult, so like MethodInvocationContext a result which is dropped
+// without being finished can fail its continuation with a generic error.
+template<typename T>
+class DeferredResult : public RefCounted
+{
+    Q_DISABLE_COPY(DeferredResult)
+
+public:
+    typedef Callback2<void, const CompletionHandle &, const T &> Continuation;
+
+    explicit DeferredResult(const Continuation &continuation)
+        : mValue(new T())
+    {
+        mCompletion.then(Reply(continuation, mValue));
+    }
+
+    ~DeferredResult() override
+    {
+        if (!mCompletion.isFinished()) {
+            mCompletion.setFinishedWithError(
+                    QLatin1String("org.freedesktop.Telepathy.Qt.ErrorHandlingError"),
+                    QLatin1String("The result was dropped without being finished"));
+        }
+    }
+
+    CompletionHandle completion() const { return mCompletion; }
+
+    bool isFinished() const { return mCompletion.isFinished(); }
+    bool isError() const { return mCompletion.isError(); }
+    QString errorName() const { return mCompletion.errorName(); }
+    QString errorMessage() const { return mCompletion.errorMessage(); }
+
+    T result() const { return *mValue; }
+
+    void setFinished(const T &result = T())
+    {
+        if (mCompletion.isFinished()) {
+            return;
+        }
+
+        *mValue = result;
+        mCompletion.setFinished();
+    }
+
+    void setFinishedWithError(const QString &errorName, const QString &errorMessage)
+    {
+        if (mCompletion.isFinished()) {
+            return;
+        }
+
+        mCompletion.setFinishedWithError(errorName, errorMessage);
+    }
+
+    void setFinishedWithError(const DBusError &error)
+    {
+        setFinishedWithError(error.name(), error.message());
+    }
+
+private:
+    struct Reply
+    {
+        Reply(const Continuation &continuation, const QSharedPointer<T> &value)
+            : continuation(continuation),
+              value(value)
+        {
+        }
+
+        void operator()(const CompletionHandle &completion) const
+        {
+            continuation(completion, *value);
+        }
+
+        Continuation continuation;
+        QSharedPointer<T> value;
+    };
+
+    CompletionHandle mCompletion;
+    QSharedPointer<T> mValue;
+};
+
+template<typename T>
+class DeferredResultPtr : public SharedPtr<DeferredResult<T> >
+{
+public:
+    inline DeferredResultPtr() { }
+    explicit inline DeferredResultPtr(DeferredResult<T> *d)
+        : SharedPtr<DeferredResult<T> >(d) { }
+    inline DeferredResultPtr(const SharedPtr<DeferredResult<T> > &o)
+        : SharedPtr<DeferredResult<T> >(o) { }
+};
+
+} // Tp
+
+#endif
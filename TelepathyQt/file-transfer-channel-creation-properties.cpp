@@ -61,7 +61,7 @@ struct TP_QT_NO_EXPORT FileTransferChannelCreationProperties::Private : public Q
             // Set optional parameters
             lastModificationTime = fileInfo.lastModified();
         } else {
-            warning() << path << "is not a local file.";
+            TP_QT_WARNING() << path << "is not a local file.";
         }
     }
 
@@ -433,7 +433,7 @@ QString FileTransferChannelCreationProperties::uri() const
 QVariantMap FileTransferChannelCreationProperties::createRequest() const
 {
     if (!isValid()) {
-        warning() << "Invalid file transfer creation properties";
+        TP_QT_WARNING() << "Invalid file transfer creation properties";
         return QVariantMap();
     }
 
@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/FileTransferChannel>
 
 #include "TelepathyQt/_gen/file-transfer-channel.moc.hpp"
@@ -232,7 +234,7 @@ FileTransferChannel::~FileTransferChannel()
 FileTransferState FileTransferChannel::state() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        TP_QT_WARNING() << "FileTransferChannel::FeatureCore must be ready before "
             "calling state";
     }
 
@@ -252,7 +254,7 @@ FileTransferState FileTransferChannel::state() const
 FileTransferStateChangeReason FileTransferChannel::stateReason() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        TP_QT_WARNING() << "FileTransferChannel::FeatureCore must be ready before "
             "calling stateReason";
     }
 
@@ -276,7 +278,7 @@ FileTransferStateChangeReason FileTransferChannel::stateReason() const
 QString FileTransferChannel::fileName() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        TP_QT_WARNING() << "FileTransferChannel::FeatureCore must be ready before "
             "calling fileName";
     }
 
@@ -295,7 +297,7 @@ QString FileTransferChannel::fileName() const
 QString FileTransferChannel::contentType() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        TP_QT_WARNING() << "FileTransferChannel::FeatureCore must be ready before "
             "calling contentType";
     }
 
@@ -320,7 +322,7 @@ QString FileTransferChannel::contentType() const
 qulonglong FileTransferChannel::size() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        TP_QT_WARNING() << "FileTransferChannel::FeatureCore must be ready before "
             "calling size";
     }
 
@@ -344,7 +346,7 @@ qulonglong FileTransferChannel::size() const
 QString FileTransferChannel::uri() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        TP_QT_WARNING() << "FileTransferChannel::FeatureCore must be ready before "
             "calling uri";
     }
 
@@ -362,7 +364,7 @@ QString FileTransferChannel::uri() const
 FileHashType FileTransferChannel::contentHashType() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        TP_QT_WARNING() << "FileTransferChannel::FeatureCore must be ready before "
             "calling contentHashType";
     }
 
@@ -385,7 +387,7 @@ FileHashType FileTransferChannel::contentHashType() const
 QString FileTransferChannel::contentHash() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        TP_QT_WARNING() << "FileTransferChannel::FeatureCore must be ready before "
             "calling contentHash";
     }
 
@@ -408,7 +410,7 @@ QString FileTransferChannel::contentHash() const
 QString FileTransferChannel::description() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        TP_QT_WARNING() << "FileTransferChannel::FeatureCore must be ready before "
             "calling description";
     }
 
@@ -426,7 +428,7 @@ QString FileTransferChannel::description() const
 QDateTime FileTransferChannel::lastModificationTime() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        TP_QT_WARNING() << "FileTransferChannel::FeatureCore must be ready before "
             "calling lastModificationTime";
     }
 
@@ -444,7 +446,7 @@ QDateTime FileTransferChannel::lastModificationTime() const
 qulonglong FileTransferChannel::initialOffset() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        TP_QT_WARNING() << "FileTransferChannel::FeatureCore must be ready before "
             "calling initialOffset";
     }
 
@@ -464,7 +466,7 @@ qulonglong FileTransferChannel::initialOffset() const
 qulonglong FileTransferChannel::transferredBytes() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        TP_QT_WARNING() << "FileTransferChannel::FeatureCore must be ready before "
             "calling transferredBytes";
     }
 
@@ -487,7 +489,7 @@ qulonglong FileTransferChannel::transferredBytes() const
 SupportedSocketMap FileTransferChannel::availableSocketTypes() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        TP_QT_WARNING() << "FileTransferChannel::FeatureCore must be ready before "
             "calling availableSocketTypes";
     }
 
@@ -584,11 +586,11 @@ void FileTransferChannel::gotProperties(QDBusPendingCallWatcher *watcher)
     if (!reply.isError()) {
         QVariantMap props = reply.value();
         mPriv->extractProperties(props);
-        debug() << "Got reply to Properties::GetAll(FileTransferChannel)";
+        TP_QT_DEBUG() << "Got reply to Properties::GetAll(FileTransferChannel)";
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, true);
     }
     else {
-        warning().nospace() << "Properties::GetAll(FileTransferChannel) failed "
+        TP_QT_WARNING().nospace() << "Properties::GetAll(FileTransferChannel) failed "
             "with " << reply.error().name() << ": " << reply.error().message();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, false,
                 reply.error());
@@ -613,7 +615,7 @@ void FileTransferChannel::onStateChanged(uint state, uint stateReason)
         return;
     }
 
-    debug() << "File transfer state changed to" << state <<
+    TP_QT_DEBUG() << "File transfer state changed to" << state <<
         "with reason" << stateReason;
     mPriv->pendingState = (FileTransferState) state;
     mPriv->pendingStateReason = (FileTransferStateChangeReason) stateReason;
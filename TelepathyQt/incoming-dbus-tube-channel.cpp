@@ -19,6 +19,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/IncomingDBusTubeChannel>
 
 #include "TelepathyQt/_gen/incoming-dbus-tube-channel.moc.hpp"
@@ -153,7 +155,7 @@ PendingDBusTubeConnection *IncomingDBusTubeChannel::acceptTube(bool allowOtherUs
                                         SocketAccessControlCredentials;
 
     if (!isReady(DBusTubeChannel::FeatureCore)) {
-        warning() << "DBusTubeChannel::FeatureCore must be ready before "
+        TP_QT_WARNING() << "DBusTubeChannel::FeatureCore must be ready before "
             "calling acceptTube";
         return new PendingDBusTubeConnection(QLatin1String(TP_QT_ERROR_NOT_AVAILABLE),
                 QLatin1String("Channel not ready"), IncomingDBusTubeChannelPtr(this));
@@ -161,14 +163,14 @@ PendingDBusTubeConnection *IncomingDBusTubeChannel::acceptTube(bool allowOtherUs
 
     // The tube must be in local pending state
     if (state() != TubeChannelStateLocalPending) {
-        warning() << "You can accept tubes only when they are in LocalPending state";
+        TP_QT_WARNING() << "You can accept tubes only when they are in LocalPending state";
         return new PendingDBusTubeConnection(QLatin1String(TP_QT_ERROR_NOT_AVAILABLE),
                 QLatin1String("Channel busy"), IncomingDBusTubeChannelPtr(this));
     }
 
     // Let's accept the tube
     if (!allowOtherUsers && !supportsRestrictingToCurrentUser()) {
-        warning() << "Current user restriction is not available for this tube, "
+        TP_QT_WARNING() << "Current user restriction is not available for this tube, "
             "falling back to allowing any connection";
         accessControl = SocketAccessControlLocalhost;
     }
@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/IncomingFileTransferChannel>
 
 #include "TelepathyQt/_gen/incoming-file-transfer-channel.moc.hpp"
@@ -166,7 +168,7 @@ IncomingFileTransferChannel::~IncomingFileTransferChannel()
 PendingOperation *IncomingFileTransferChannel::setUri(const QString& uri)
 {
     if (!isReady(FileTransferChannel::FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        TP_QT_WARNING() << "FileTransferChannel::FeatureCore must be ready before "
             "calling setUri";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Channel not ready"),
@@ -174,7 +176,7 @@ PendingOperation *IncomingFileTransferChannel::setUri(const QString& uri)
     }
 
     if (state() != FileTransferStatePending) {
-        warning() << "setUri must be called before calling acceptFile";
+        TP_QT_WARNING() << "setUri must be called before calling acceptFile";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Cannot set URI after calling acceptFile"),
                 IncomingFileTransferChannelPtr(this));
@@ -218,7 +220,7 @@ PendingOperation *IncomingFileTransferChannel::acceptFile(qulonglong offset,
         QIODevice *output)
 {
     if (!isReady(FileTransferChannel::FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        TP_QT_WARNING() << "FileTransferChannel::FeatureCore must be ready before "
             "calling acceptFile";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Channel not ready"),
@@ -227,7 +229,7 @@ PendingOperation *IncomingFileTransferChannel::acceptFile(qulonglong offset,
 
     // let's fail here direclty as we may only have one device to handle
     if (mPriv->output) {
-        warning() << "File transfer can only be started once in the same "
+        TP_QT_WARNING() << "File transfer can only be started once in the same "
             "channel";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("File transfer can only be started once in the same channel"),
@@ -242,7 +244,7 @@ PendingOperation *IncomingFileTransferChannel::acceptFile(qulonglong offset,
 
     if (!output->isWritable()) {
         mPriv->weOpenedDevice = false;
-        warning() << "Unable to open IO device for writing";
+        TP_QT_WARNING() << "Unable to open IO device for writing";
         return new PendingFailure(TP_QT_ERROR_PERMISSION_DENIED,
                                   QLatin1String("Unable to open IO device for writing"),
                                   IncomingFileTransferChannelPtr(this));
@@ -266,7 +268,7 @@ PendingOperation *IncomingFileTransferChannel::acceptFile(qulonglong offset,
 void IncomingFileTransferChannel::onAcceptFileFinished(PendingOperation *op)
 {
     if (op->isError()) {
-        warning() << "Error accepting file transfer " <<
+        TP_QT_WARNING() << "Error accepting file transfer " <<
             op->errorName() << ":" << op->errorMessage();
         invalidate(op->errorName(), op->errorMessage());
         return;
@@ -274,7 +276,7 @@ void IncomingFileTransferChannel::onAcceptFileFinished(PendingOperation *op)
 
     PendingVariant *pv = qobject_cast<PendingVariant *>(op);
     mPriv->addr = qdbus_cast<SocketAddressIPv4>(pv->result());
-    debug().nospace() << "Got address " << mPriv->addr.address <<
+    TP_QT_DEBUG().nospace() << "Got address " << mPriv->addr.address <<
         ":" << mPriv->addr.port;
 
     if (state() == FileTransferStateOpen) {
@@ -295,7 +297,7 @@ void IncomingFileTransferChannel::connectToHost()
     if (initialOffset() > mPriv->requestedOffset) {
         // either the CM or the sender is doing something really wrong here,
         // cancel the transfer.
-        warning() << "InitialOffset bigger than requested offset, "
+        TP_QT_WARNING() << "InitialOffset bigger than requested offset, "
             "cancelling the transfer";
         cancel();
         invalidate(TP_QT_ERROR_INCONSISTENT,
@@ -316,14 +318,14 @@ void IncomingFileTransferChannel::connectToHost()
     connect(mPriv->socket, SIGNAL(readyRead()),
             SLOT(doTransfer()));
 
-    debug().nospace() << "Connecting to host " <<
+    TP_QT_DEBUG().nospace() << "Connecting to host " <<
         mPriv->addr.address << ":" << mPriv->addr.port << "...";
     mPriv->socket->connectToHost(mPriv->addr.address, mPriv->addr.port);
 }
 
 void IncomingFileTransferChannel::onSocketConnected()
 {
-    debug() << "Connected to host";
+    TP_QT_DEBUG() << "Connected to host";
     setConnected();
 
     doTransfer();
@@ -331,7 +333,7 @@ void IncomingFileTransferChannel::onSocketConnected()
 
 void IncomingFileTransferChannel::onSocketDisconnected()
 {
-    debug() << "Disconnected from host";
+    TP_QT_DEBUG() << "Disconnected from host";
     setFinished();
 }
 
@@ -19,6 +19,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/IncomingStreamTubeChannel>
 
 #include "TelepathyQt/_gen/incoming-stream-tube-channel.moc.hpp"
@@ -168,7 +170,7 @@ PendingStreamTubeConnection *IncomingStreamTubeChannel::acceptTubeAsTcpSocket(
         quint16 allowedPort)
 {
     if (!isReady(IncomingStreamTubeChannel::FeatureCore)) {
-        warning() << "IncomingStreamTubeChannel::FeatureCore must be ready before "
+        TP_QT_WARNING() << "IncomingStreamTubeChannel::FeatureCore must be ready before "
                 "calling acceptTubeAsTcpSocket";
         return new PendingStreamTubeConnection(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Channel not ready"),
@@ -177,7 +179,7 @@ PendingStreamTubeConnection *IncomingStreamTubeChannel::acceptTubeAsTcpSocket(
 
     // The tube must be in local pending state
     if (state() != TubeChannelStateLocalPending) {
-        warning() << "You can accept tubes only when they are in LocalPending state";
+        TP_QT_WARNING() << "You can accept tubes only when they are in LocalPending state";
         return new PendingStreamTubeConnection(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Channel not ready"),
                 IncomingStreamTubeChannelPtr(this));
@@ -201,7 +203,7 @@ PendingStreamTubeConnection *IncomingStreamTubeChannel::acceptTubeAsTcpSocket(
         hostAddress != QHostAddress::AnyIPv6) {
         // We need to have a valid QHostAddress AND Port.
         if (hostAddress.isNull() || allowedPort == 0) {
-            warning() << "You have to set a valid allowed address+port to use Port access control";
+            TP_QT_WARNING() << "You have to set a valid allowed address+port to use Port access control";
             return new PendingStreamTubeConnection(TP_QT_ERROR_INVALID_ARGUMENT,
                     QLatin1String("The supplied allowed address and/or port was invalid"),
                     IncomingStreamTubeChannelPtr(this));
@@ -226,7 +228,7 @@ PendingStreamTubeConnection *IncomingStreamTubeChannel::acceptTubeAsTcpSocket(
             controlParameter = QVariant::fromValue(addr);
         } else {
             // We're handling an IPv4/IPv6 socket only
-            warning() << "acceptTubeAsTcpSocket can be called only with a QHostAddress "
+            TP_QT_WARNING() << "acceptTubeAsTcpSocket can be called only with a QHostAddress "
                     "representing an IPv4 or IPv6 address";
             return new PendingStreamTubeConnection(TP_QT_ERROR_INVALID_ARGUMENT,
                     QLatin1String("Invalid host given"),
@@ -258,7 +260,7 @@ PendingStreamTubeConnection *IncomingStreamTubeChannel::acceptTubeAsTcpSocket(
         (accessControl == SocketAccessControlPort &&
             addressType() == SocketAddressTypeIPv6 &&
             !supportsIPv6SocketsWithSpecifiedAddress())) {
-        warning() << "You requested an address type/access control combination "
+        TP_QT_WARNING() << "You requested an address type/access control combination "
                 "not supported by this channel";
         return new PendingStreamTubeConnection(TP_QT_ERROR_NOT_IMPLEMENTED,
                 QLatin1String("The requested address type/access control "
@@ -338,7 +340,7 @@ PendingStreamTubeConnection *IncomingStreamTubeChannel::acceptTubeAsUnixSocket(
         bool requireCredentials)
 {
     if (!isReady(IncomingStreamTubeChannel::FeatureCore)) {
-        warning() << "IncomingStreamTubeChannel::FeatureCore must be ready before "
+        TP_QT_WARNING() << "IncomingStreamTubeChannel::FeatureCore must be ready before "
                 "calling acceptTubeAsUnixSocket";
         return new PendingStreamTubeConnection(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Channel not ready"),
@@ -347,7 +349,7 @@ PendingStreamTubeConnection *IncomingStreamTubeChannel::acceptTubeAsUnixSocket(
 
     // The tube must be in local pending state
     if (state() != TubeChannelStateLocalPending) {
-        warning() << "You can accept tubes only when they are in LocalPending state";
+        TP_QT_WARNING() << "You can accept tubes only when they are in LocalPending state";
         return new PendingStreamTubeConnection(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Channel not ready"),
                 IncomingStreamTubeChannelPtr(this));
@@ -372,7 +374,7 @@ PendingStreamTubeConnection *IncomingStreamTubeChannel::acceptTubeAsUnixSocket(
         (accessControl == SocketAccessControlCredentials &&
            addressType() == SocketAddressTypeAbstractUnix &&
            !supportsAbstractUnixSocketsWithCredentials())) {
-        warning() << "You requested an address type/access control combination "
+        TP_QT_WARNING() << "You requested an address type/access control combination "
                 "not supported by this channel";
         return new PendingStreamTubeConnection(TP_QT_ERROR_NOT_IMPLEMENTED,
                 QLatin1String("The requested address type/access control "
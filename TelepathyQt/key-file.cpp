@@ -83,7 +83,7 @@ void KeyFile::Private::setFileName(const QString &fName)
 
 void KeyFile::Private::setError(KeyFile::Status st, const QString &reason)
 {
-    warning() << QString(QLatin1String("ERROR: filename(%1) reason(%2)"))
+    TP_QT_WARNING() << QString(QLatin1String("ERROR: filename(%1) reason(%2)"))
                          .arg(fileName).arg(reason);
     status = st;
     groups.clear();
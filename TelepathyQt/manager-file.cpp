@@ -28,8 +28,12 @@
 #include <TelepathyQt/Constants>
 #include <TelepathyQt/Utils>
 
+#include <QtCore/QDateTime>
 #include <QtCore/QDir>
+#include <QtCore/QFileInfo>
 #include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
 #include <QtCore/QString>
 #include <QtCore/QStringList>
 #include <QtDBus/QDBusVariant>
@@ -43,6 +47,7 @@ struct TP_QT_NO_EXPORT ManagerFile::Private
     Private(const QString &cnName);
 
     void init();
+    bool parseCached(const QString &fileName);
     bool parse(const QString &fileName);
     bool isValid() const;
 
@@ -77,8 +82,27 @@ struct TP_QT_NO_EXPORT ManagerFile::Private
     KeyFile keyFile;
     QHash<QString, ProtocolInfo> protocolsMap;
     bool valid;
+
+    // Parsed manager files, keyed by file name and shared by every ManagerFile
+    // in the process, so that a file is only parsed again if it changed on disk
+    struct CachedFile
+    {
+        CachedFile() : size(0), parsed(false) {}
+
+        QDateTime lastModified;
+        qint64 size;
+        KeyFile keyFile;
+        QHash<QString, ProtocolInfo> protocolsMap;
+        bool parsed;
+    };
+
+    static QMutex cacheLock;
+    static QHash<QString, CachedFile> cache;
 };
 
+QMutex ManagerFile::Private::cacheLock;
+QHash<QString, ManagerFile::Private::CachedFile> ManagerFile::Private::cache;
+
 ManagerFile::Private::Private()
     : valid(false)
 {
@@ -119,10 +143,10 @@ void ManagerFile::Private::init()
     foreach (const QString configDir, configDirs) {
         QString fileName = configDir + cmName + QLatin1String(".manager");
         if (QFile::exists(fileName)) {
-            debug() << "parsing manager file" << fileName;
+            TP_QT_DEBUG() << "parsing manager file" << fileName;
             protocolsMap.clear();
-            if (!parse(fileName)) {
-                warning() << "error parsing manager file" << fileName;
+            if (!parseCached(fileName)) {
+                TP_QT_WARNING() << "error parsing manager file" << fileName;
                 continue;
             }
             valid = true;
@@ -131,6 +155,33 @@ void ManagerFile::Private::init()
     }
 }
 
+bool ManagerFile::Private::parseCached(const QString &fileName)
+{
+    QFileInfo fi(fileName);
+    QDateTime lastModified = fi.lastModified();
+    qint64 size = fi.size();
+
+    QMutexLocker locker(&cacheLock);
+    QHash<QString, CachedFile>::const_iterator i = cache.constFind(fileName);
+    if (i != cache.constEnd() && i->lastModified == lastModified && i->size == size) {
+        keyFile = i->keyFile;
+        protocolsMap = i->protocolsMap;
+        return i->parsed;
+    }
+    locker.unlock();
+
+    CachedFile entry;
+    entry.lastModified = lastModified;
+    entry.size = size;
+    entry.parsed = parse(fileName);
+    entry.keyFile = keyFile;
+    entry.protocolsMap = protocolsMap;
+
+    locker.relock();
+    cache.insert(fileName, entry);
+    return entry.parsed;
+}
+
 bool ManagerFile::Private::parse(const QString &fileName)
 {
     keyFile.setFileName(fileName);
@@ -161,7 +212,7 @@ bool ManagerFile::Private::parse(const QString &fileName)
                     spec.name = param.right(param.length() - 6);
 
                     if (values.length() == 0) {
-                        warning() << "param" << spec.name << "set but no signature defined";
+                        TP_QT_WARNING() << "param" << spec.name << "set but no signature defined";
                         return false;
                     }
 
@@ -192,14 +243,14 @@ bool ManagerFile::Private::parse(const QString &fileName)
                     QString statusName = param.right(param.length() - 7);
 
                     if (values.length() == 0) {
-                        warning() << "status" << statusName << "set but no type defined";
+                        TP_QT_WARNING() << "status" << statusName << "set but no type defined";
                         return false;
                     }
 
                     bool ok;
                     status.type = values[0].toUInt(&ok);
                     if (!ok) {
-                        warning() << "status" << statusName << "set but type is not an uint";
+                        TP_QT_WARNING() << "status" << statusName << "set but type is not an uint";
                         return false;
                     }
 
@@ -216,7 +267,7 @@ bool ManagerFile::Private::parse(const QString &fileName)
                     }
 
                     if (statuses.contains(statusName)) {
-                        warning() << "status" << statusName << "defined more than once, "
+                        TP_QT_WARNING() << "status" << statusName << "defined more than once, "
                             "replacing it";
                     }
 
@@ -232,7 +283,7 @@ bool ManagerFile::Private::parse(const QString &fileName)
                     QString paramName = param.right(param.length() - 8);
 
                     if (!hasParameter(protocol, paramName)) {
-                        warning() << "param" << paramName
+                        TP_QT_WARNING() << "param" << paramName
                                   << "has default value set, but not a definition";
                         continue;
                     }
@@ -245,7 +296,7 @@ bool ManagerFile::Private::parse(const QString &fileName)
                      * QString */
                     QVariant value = valueForKey(param, spec->signature);
                     if (value.type() == QVariant::Invalid) {
-                        warning() << "param" << paramName
+                        TP_QT_WARNING() << "param" << paramName
                                   << "has invalid signature";
                         protocolsMap.clear();
                         return false;
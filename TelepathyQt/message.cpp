@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/Message>
 #include <TelepathyQt/ReceivedMessage>
 
@@ -401,7 +403,7 @@ QString Message::text() const
                 text += content.toString();
             } else {
                 // O RLY?
-                debug() << "allegedly text/plain part wasn't";
+                TP_QT_DEBUG() << "allegedly text/plain part wasn't";
             }
         }
     }
@@ -119,20 +119,19 @@ public:
 
         mFinished = true;
 
-        setReplyValue(0, QVariant::fromValue(t1));
-        setReplyValue(1, QVariant::fromValue(t2));
-        setReplyValue(2, QVariant::fromValue(t3));
-        setReplyValue(3, QVariant::fromValue(t4));
-        setReplyValue(4, QVariant::fromValue(t5));
-        setReplyValue(5, QVariant::fromValue(t6));
-        setReplyValue(6, QVariant::fromValue(t7));
-        setReplyValue(7, QVariant::fromValue(t8));
-
-        if (mReply.isEmpty()) {
-            mBus.send(mMessage.createReply());
-        } else {
-            mBus.send(mMessage.createReply(mReply));
-        }
+        // Only the real output arguments are boxed, the unused trailing ones
+        // are Nil and skipped by overload resolution
+        mReply.reserve(Count);
+        appendReplyValue(t1);
+        appendReplyValue(t2);
+        appendReplyValue(t3);
+        appendReplyValue(t4);
+        appendReplyValue(t5);
+        appendReplyValue(t6);
+        appendReplyValue(t7);
+        appendReplyValue(t8);
+
+        mBus.send(mMessage.createReply(mReply));
         onFinished();
     }
 
@@ -169,12 +168,14 @@ protected:
 private:
     Q_DISABLE_COPY(MethodInvocationContext)
 
-    void setReplyValue(int index, const QVariant &value)
+    template<typename T>
+    void appendReplyValue(const T &value)
+    {
+        mReply.append(QVariant::fromValue(value));
+    }
+
+    void appendReplyValue(const MethodInvocationContextTypes::Nil &)
     {
-        if (index >= Count) {
-            return;
-        }
-        mReply.insert(index, value);
     }
 
     QDBusConnection mBus;
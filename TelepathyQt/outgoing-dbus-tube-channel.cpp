@@ -19,6 +19,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/OutgoingDBusTubeChannel>
 
 #include "TelepathyQt/_gen/outgoing-dbus-tube-channel.moc.hpp"
@@ -151,7 +153,7 @@ PendingDBusTubeConnection *OutgoingDBusTubeChannel::offerTube(const QVariantMap
                                         SocketAccessControlCredentials;
 
     if (!isReady(DBusTubeChannel::FeatureCore)) {
-        warning() << "DBusTubeChannel::FeatureCore must be ready before "
+        TP_QT_WARNING() << "DBusTubeChannel::FeatureCore must be ready before "
             "calling offerTube";
         return new PendingDBusTubeConnection(QLatin1String(TP_QT_ERROR_NOT_AVAILABLE),
                 QLatin1String("Channel not ready"), OutgoingDBusTubeChannelPtr(this));
@@ -159,14 +161,14 @@ PendingDBusTubeConnection *OutgoingDBusTubeChannel::offerTube(const QVariantMap
 
     // The tube must be not offered
     if (state() != TubeChannelStateNotOffered) {
-        warning() << "You can not expose more than a bus for each DBus Tube";
+        TP_QT_WARNING() << "You can not expose more than a bus for each DBus Tube";
         return new PendingDBusTubeConnection(QLatin1String(TP_QT_ERROR_NOT_AVAILABLE),
                 QLatin1String("Channel busy"), OutgoingDBusTubeChannelPtr(this));
     }
 
     // Let's offer the tube
     if (!allowOtherUsers && !supportsRestrictingToCurrentUser()) {
-        warning() << "Current user restriction is not available for this tube, "
+        TP_QT_WARNING() << "Current user restriction is not available for this tube, "
             "falling back to allowing any connection";
         accessControl = SocketAccessControlLocalhost;
     }
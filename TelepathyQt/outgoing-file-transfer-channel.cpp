@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/OutgoingFileTransferChannel>
 
 #include "TelepathyQt/_gen/outgoing-file-transfer-channel.moc.hpp"
@@ -166,7 +168,7 @@ OutgoingFileTransferChannel::~OutgoingFileTransferChannel()
 PendingOperation *OutgoingFileTransferChannel::provideFile(QIODevice *input)
 {
     if (!isReady(FileTransferChannel::FeatureCore)) {
-        warning() << "FileTransferChannel::FeatureCore must be ready before "
+        TP_QT_WARNING() << "FileTransferChannel::FeatureCore must be ready before "
             "calling provideFile";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Channel not ready"),
@@ -175,7 +177,7 @@ PendingOperation *OutgoingFileTransferChannel::provideFile(QIODevice *input)
 
     // let's fail here direclty as we may only have one device to handle
     if (mPriv->input) {
-        warning() << "File transfer can only be started once in the same "
+        TP_QT_WARNING() << "File transfer can only be started once in the same "
             "channel";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("File transfer can only be started once in the same channel"),
@@ -190,7 +192,7 @@ PendingOperation *OutgoingFileTransferChannel::provideFile(QIODevice *input)
 
     if (!input->isReadable()) {
         mPriv->weOpenedDevice = false;
-        warning() << "Unable to open IO device for reading";
+        TP_QT_WARNING() << "Unable to open IO device for reading";
         return new PendingFailure(TP_QT_ERROR_PERMISSION_DENIED,
                 QLatin1String("Unable to open IO device for reading"),
                 OutgoingFileTransferChannelPtr(this));
@@ -216,7 +218,7 @@ PendingOperation *OutgoingFileTransferChannel::provideFile(QIODevice *input)
 void OutgoingFileTransferChannel::onProvideFileFinished(PendingOperation *op)
 {
     if (op->isError()) {
-        warning() << "Error providing file transfer " <<
+        TP_QT_WARNING() << "Error providing file transfer " <<
             op->errorName() << ":" << op->errorMessage();
         invalidate(op->errorName(), op->errorMessage());
         return;
@@ -224,7 +226,7 @@ void OutgoingFileTransferChannel::onProvideFileFinished(PendingOperation *op)
 
     PendingVariant *pv = qobject_cast<PendingVariant *>(op);
     mPriv->addr = qdbus_cast<SocketAddressIPv4>(pv->result());
-    debug().nospace() << "Got address " << mPriv->addr.address <<
+    TP_QT_DEBUG().nospace() << "Got address " << mPriv->addr.address <<
         ":" << mPriv->addr.port;
 
     if (state() == FileTransferStateOpen) {
@@ -251,14 +253,14 @@ void OutgoingFileTransferChannel::connectToHost()
     connect(mPriv->socket, SIGNAL(bytesWritten(qint64)),
             SLOT(doTransfer()));
 
-    debug().nospace() << "Connecting to host " <<
+    TP_QT_DEBUG().nospace() << "Connecting to host " <<
         mPriv->addr.address << ":" << mPriv->addr.port << "...";
     mPriv->socket->connectToHost(mPriv->addr.address, mPriv->addr.port);
 }
 
 void OutgoingFileTransferChannel::onSocketConnected()
 {
-    debug() << "Connected to host";
+    TP_QT_DEBUG() << "Connected to host";
     setConnected();
 
     connect(mPriv->input, SIGNAL(readyRead()),
@@ -269,25 +271,25 @@ void OutgoingFileTransferChannel::onSocketConnected()
         mPriv->input->seek(initialOffset());
     }
 
-    debug() << "Starting transfer...";
+    TP_QT_DEBUG() << "Starting transfer...";
     doTransfer();
 }
 
 void OutgoingFileTransferChannel::onSocketDisconnected()
 {
-    debug() << "Disconnected from host";
+    TP_QT_DEBUG() << "Disconnected from host";
     setFinished();
 }
 
 void OutgoingFileTransferChannel::onSocketError(QAbstractSocket::SocketError error)
 {
-    debug() << "Socket error" << error;
+    TP_QT_DEBUG() << "Socket error" << error;
     setFinished();
 }
 
 void OutgoingFileTransferChannel::onInputAboutToClose()
 {
-    debug() << "Input closed";
+    TP_QT_DEBUG() << "Input closed";
 
     // read all remaining data from input device and write to output device
     if (isConnected()) {
@@ -315,7 +317,7 @@ void OutgoingFileTransferChannel::doTransfer()
                 (qulonglong) len);
 
         mPriv->pos += skip;
-        debug() << "skipping" << skip << "bytes";
+        TP_QT_DEBUG() << "skipping" << skip << "bytes";
         if (skip == len) {
             // nothing to write, all data read was skipped
             // schedule a transfer, as readyRead may never be called and
@@ -51,6 +51,10 @@ private:
     Private *mPriv;
 };
 
+// Resolves the handles of tube events to contacts, delivering the results in the
+// order in which the requests were made. All the handles queued while the event
+// loop is busy are resolved with a single contactsForHandles() call, and
+// contacts already known to the ContactManager are used directly.
 class TP_QT_NO_EXPORT QueuedContactFactory : public QObject
 {
     Q_OBJECT
@@ -68,7 +72,7 @@ Q_SIGNALS:
 
 private Q_SLOTS:
     void onPendingContactsFinished(Tp::PendingOperation *operation);
-    void processNextRequest();
+    void processQueue();
 
 private:
     struct Entry {
@@ -76,9 +80,18 @@ private:
         UIntList handles;
     };
 
-    bool m_isProcessing;
+    bool isResolved(const Entry &entry) const;
+    void deliverResolved();
+
+    bool m_processScheduled;
+    uint m_lastId;
     ContactManagerPtr m_manager;
     QQueue<Entry> m_queue;
+    // Handles waiting for the next contactsForHandles() call, and the ones already
+    // requested; resolved handles map to a null ContactPtr if they were invalid
+    UIntList m_unrequestedHandles;
+    QSet<uint> m_requestedHandles;
+    QHash<uint, ContactPtr> m_contacts;
 };
 
 struct TP_QT_NO_EXPORT PendingOpenTube::Private
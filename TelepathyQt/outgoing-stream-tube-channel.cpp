@@ -19,6 +19,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/OutgoingStreamTubeChannel>
 #include "TelepathyQt/outgoing-stream-tube-channel-internal.h"
 
@@ -58,7 +60,7 @@ PendingOpenTube::PendingOpenTube(
 
     // FIXME: connect to channel invalidation here also
 
-    debug() << "Calling StreamTube.Offer";
+    TP_QT_DEBUG() << "Calling StreamTube.Offer";
     if (offerOperation->isFinished()) {
         onOfferFinished(offerOperation);
     } else {
@@ -76,17 +78,17 @@ PendingOpenTube::~PendingOpenTube()
 void PendingOpenTube::onOfferFinished(PendingOperation *op)
 {
     if (op->isError()) {
-        warning().nospace() << "StreamTube.Offer failed with " <<
+        TP_QT_WARNING().nospace() << "StreamTube.Offer failed with " <<
             op->errorName() << ": " << op->errorMessage();
         setFinishedWithError(op->errorName(), op->errorMessage());
         return;
     }
 
-    debug() << "StreamTube.Offer returned successfully";
+    TP_QT_DEBUG() << "StreamTube.Offer returned successfully";
 
     // It might have been already opened - check
     if (mPriv->tube->state() != TubeChannelStateOpen) {
-        debug() << "Awaiting tube to be opened";
+        TP_QT_DEBUG() << "Awaiting tube to be opened";
         // Wait until the tube gets opened on the other side
         connect(mPriv->tube.data(),
                 SIGNAL(stateChanged(Tp::TubeChannelState)),
@@ -99,26 +101,27 @@ void PendingOpenTube::onOfferFinished(PendingOperation *op)
 void PendingOpenTube::onTubeStateChanged(TubeChannelState state)
 {
     if (state == TubeChannelStateOpen) {
-        debug() << "Tube is now opened";
+        TP_QT_DEBUG() << "Tube is now opened";
         // Inject the parameters into the tube
         mPriv->tube->setParameters(mPriv->parameters);
         // The tube is ready: let's notify
         setFinished();
     } else {
         if (state != TubeChannelStateRemotePending) {
-            warning() << "Offering tube failed with" << TP_QT_ERROR_CONNECTION_REFUSED;
+            TP_QT_WARNING() << "Offering tube failed with" << TP_QT_ERROR_CONNECTION_REFUSED;
             // Something happened
             setFinishedWithError(TP_QT_ERROR_CONNECTION_REFUSED,
                     QLatin1String("The connection to this tube was refused"));
         } else {
-            debug() << "Awaiting remote to accept the tube";
+            TP_QT_DEBUG() << "Awaiting remote to accept the tube";
         }
     }
 }
 
 QueuedContactFactory::QueuedContactFactory(Tp::ContactManagerPtr contactManager, QObject* parent)
     : QObject(parent),
-      m_isProcessing(false),
+      m_processScheduled(false),
+      m_lastId(0),
       m_manager(contactManager)
 {
 }
@@ -127,59 +130,106 @@ QueuedContactFactory::~QueuedContactFactory()
 {
 }
 
-void QueuedContactFactory::processNextRequest()
+QUuid QueuedContactFactory::appendNewRequest(const Tp::UIntList &handles)
 {
-    if (m_isProcessing) {
-        // Return, nothing to do
-        return;
-    }
+    // The identifiers only need to be unique for this factory, so there is no
+    // need to generate random ones
+    Entry entry;
+    entry.uuid = QUuid(++m_lastId, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    entry.handles = handles;
+    m_queue.enqueue(entry);
 
-    if (m_queue.isEmpty()) {
-        // Queue completed, notify and return
-        emit queueCompleted();
-        return;
-    }
+    foreach (uint handle, handles) {
+        if (m_contacts.contains(handle) || m_requestedHandles.contains(handle)) {
+            continue;
+        }
 
-    m_isProcessing = true;
+        ContactPtr contact = m_manager->lookupContactByHandle(handle);
+        if (contact) {
+            m_contacts.insert(handle, contact);
+        } else {
+            // TODO: pass id hints to ContactManager if we ever gain support to retrieve
+            //       contact ids from NewRemoteConnection.
+            m_requestedHandles.insert(handle);
+            m_unrequestedHandles.append(handle);
+        }
+    }
 
-    Entry entry = m_queue.dequeue();
+    // The results can't be delivered before the caller knows the UUID, so this
+    // is done from the event loop, together with all the other queued requests
+    if (!m_processScheduled) {
+        m_processScheduled = true;
+        QTimer::singleShot(0, this, SLOT(processQueue()));
+    }
 
-    // TODO: pass id hints to ContactManager if we ever gain support to retrieve contact ids
-    //       from NewRemoteConnection.
-    PendingContacts *pc = m_manager->contactsForHandles(entry.handles);
-    pc->setProperty("__TpQt__QueuedContactFactoryUuid", entry.uuid.toString());
-    connect(pc, SIGNAL(finished(Tp::PendingOperation*)),
-            this, SLOT(onPendingContactsFinished(Tp::PendingOperation*)));
+    return entry.uuid;
 }
 
-QUuid QueuedContactFactory::appendNewRequest(const Tp::UIntList &handles)
+void QueuedContactFactory::processQueue()
 {
-    // Create a new entry
-    Entry entry;
-    entry.uuid = QUuid::createUuid();
-    entry.handles = handles;
-    m_queue.enqueue(entry);
+    m_processScheduled = false;
 
-    // Enqueue a process request in the event loop
-    QTimer::singleShot(0, this, SLOT(processNextRequest()));
+    if (!m_unrequestedHandles.isEmpty()) {
+        PendingContacts *pc = m_manager->contactsForHandles(m_unrequestedHandles);
+        m_unrequestedHandles.clear();
+        connect(pc, SIGNAL(finished(Tp::PendingOperation*)),
+                this, SLOT(onPendingContactsFinished(Tp::PendingOperation*)));
+    }
 
-    // Return the UUID
-    return entry.uuid;
+    deliverResolved();
 }
 
 void QueuedContactFactory::onPendingContactsFinished(PendingOperation *op)
 {
     PendingContacts *pc = qobject_cast<PendingContacts*>(op);
 
-    QUuid uuid = QUuid(pc->property("__TpQt__QueuedContactFactoryUuid").toString());
+    foreach (const ContactPtr &contact, pc->contacts()) {
+        m_contacts.insert(contact->handle()[0], contact);
+    }
+
+    // Mark the handles which could not be resolved as done too
+    foreach (uint handle, pc->handles()) {
+        m_requestedHandles.remove(handle);
+        if (!m_contacts.contains(handle)) {
+            m_contacts.insert(handle, ContactPtr());
+        }
+    }
+
+    deliverResolved();
+}
+
+bool QueuedContactFactory::isResolved(const Entry &entry) const
+{
+    foreach (uint handle, entry.handles) {
+        if (!m_contacts.contains(handle)) {
+            return false;
+        }
+    }
+    return true;
+}
 
-    emit contactsRetrieved(uuid, pc->contacts());
+void QueuedContactFactory::deliverResolved()
+{
+    while (!m_queue.isEmpty() && isResolved(m_queue.head())) {
+        Entry entry = m_queue.dequeue();
+
+        QList<ContactPtr> contacts;
+        foreach (uint handle, entry.handles) {
+            ContactPtr contact = m_contacts.value(handle);
+            if (contact) {
+                contacts << contact;
+            }
+        }
 
-    // No longer processing
-    m_isProcessing = false;
+        emit contactsRetrieved(entry.uuid, contacts);
+    }
 
-    // Go for next one
-    processNextRequest();
+    if (m_queue.isEmpty()) {
+        // Nothing refers to the resolved contacts anymore, except for those still
+        // being requested
+        m_contacts.clear();
+        emit queueCompleted();
+    }
 }
 
 OutgoingStreamTubeChannel::Private::Private(OutgoingStreamTubeChannel *parent)
@@ -306,7 +356,7 @@ PendingOperation *OutgoingStreamTubeChannel::offerTcpSocket(
         const QVariantMap &parameters)
 {
     if (!isReady(OutgoingStreamTubeChannel::FeatureCore)) {
-        warning() << "OutgoingStreamTubeChannel::FeatureCore must be ready before "
+        TP_QT_WARNING() << "OutgoingStreamTubeChannel::FeatureCore must be ready before "
                 "calling offerTube";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Channel not ready"),
@@ -315,7 +365,7 @@ PendingOperation *OutgoingStreamTubeChannel::offerTcpSocket(
 
     // The tube must be not offered
     if (state() != TubeChannelStateNotOffered) {
-        warning() << "You can not expose more than a socket for each Stream Tube";
+        TP_QT_WARNING() << "You can not expose more than a socket for each Stream Tube";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Channel busy"),
                 OutgoingStreamTubeChannelPtr(this));
@@ -343,7 +393,7 @@ PendingOperation *OutgoingStreamTubeChannel::offerTcpSocket(
             accessControl = SocketAccessControlLocalhost;
         } else {
             // There are no combinations supported for this socket
-            warning() << "You requested an address type/access control combination "
+            TP_QT_WARNING() << "You requested an address type/access control combination "
                     "not supported by this channel";
             return new PendingFailure(TP_QT_ERROR_NOT_IMPLEMENTED,
                     QLatin1String("The requested address type/access control "
@@ -379,7 +429,7 @@ PendingOperation *OutgoingStreamTubeChannel::offerTcpSocket(
             accessControl = SocketAccessControlLocalhost;
         } else {
             // There are no combinations supported for this socket
-            warning() << "You requested an address type/access control combination "
+            TP_QT_WARNING() << "You requested an address type/access control combination "
                     "not supported by this channel";
             return new PendingFailure(TP_QT_ERROR_NOT_IMPLEMENTED,
                     QLatin1String("The requested address type/access control "
@@ -407,7 +457,7 @@ PendingOperation *OutgoingStreamTubeChannel::offerTcpSocket(
         return op;
     } else {
         // We're handling an IPv4/IPv6 socket only
-        warning() << "offerTube can be called only with a QHostAddress representing "
+        TP_QT_WARNING() << "offerTube can be called only with a QHostAddress representing "
                 "an IPv4 or IPv6 address";
         return new PendingFailure(TP_QT_ERROR_INVALID_ARGUMENT,
                 QLatin1String("Invalid host given"),
@@ -483,7 +533,7 @@ PendingOperation *OutgoingStreamTubeChannel::offerUnixSocket(
             SocketAccessControlLocalhost;
 
     if (!isReady(OutgoingStreamTubeChannel::FeatureCore)) {
-        warning() << "OutgoingStreamTubeChannel::FeatureCore must be ready before "
+        TP_QT_WARNING() << "OutgoingStreamTubeChannel::FeatureCore must be ready before "
                 "calling offerTube";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Channel not ready"),
@@ -492,7 +542,7 @@ PendingOperation *OutgoingStreamTubeChannel::offerUnixSocket(
 
     // The tube must be not offered
     if (state() != TubeChannelStateNotOffered) {
-        warning() << "You can not expose more than a socket for each Stream Tube";
+        TP_QT_WARNING() << "You can not expose more than a socket for each Stream Tube";
         return new PendingFailure(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Channel busy"), OutgoingStreamTubeChannelPtr(this));
     }
@@ -505,7 +555,7 @@ PendingOperation *OutgoingStreamTubeChannel::offerUnixSocket(
                 !supportsAbstractUnixSocketsOnLocalhost()) ||
             (accessControl == SocketAccessControlCredentials &&
                 !supportsAbstractUnixSocketsWithCredentials()) ) {
-            warning() << "You requested an address type/access control combination "
+            TP_QT_WARNING() << "You requested an address type/access control combination "
                     "not supported by this channel";
             return new PendingFailure(TP_QT_ERROR_NOT_IMPLEMENTED,
                     QLatin1String("The requested address type/access control "
@@ -536,7 +586,7 @@ PendingOperation *OutgoingStreamTubeChannel::offerUnixSocket(
                 !supportsUnixSocketsWithCredentials()) ||
             (accessControl != SocketAccessControlLocalhost &&
                 accessControl != SocketAccessControlCredentials) ) {
-            warning() << "You requested an address type/access control combination "
+            TP_QT_WARNING() << "You requested an address type/access control combination "
                 "not supported by this channel";
             return new PendingFailure(TP_QT_ERROR_NOT_IMPLEMENTED,
                     QLatin1String("The requested address type/access control "
@@ -614,7 +664,7 @@ PendingOperation *OutgoingStreamTubeChannel::offerUnixSocket(
 QHash<QPair<QHostAddress, quint16>, uint> OutgoingStreamTubeChannel::connectionsForSourceAddresses() const
 {
     if (addressType() != SocketAddressTypeIPv4 && addressType() != SocketAddressTypeIPv6) {
-        warning() << "OutgoingStreamTubeChannel::connectionsForSourceAddresses() makes sense "
+        TP_QT_WARNING() << "OutgoingStreamTubeChannel::connectionsForSourceAddresses() makes sense "
                 "just when offering a TCP socket";
         return QHash<QPair<QHostAddress, quint16>, uint>();
     }
@@ -622,13 +672,13 @@ QHash<QPair<QHostAddress, quint16>, uint> OutgoingStreamTubeChannel::connections
     if (isValid() || !isDroppingConnections() ||
             !requestedFeatures().contains(StreamTubeChannel::FeatureConnectionMonitoring)) {
         if (!isReady(StreamTubeChannel::FeatureConnectionMonitoring)) {
-            warning() << "StreamTubeChannel::FeatureConnectionMonitoring must be ready before "
+            TP_QT_WARNING() << "StreamTubeChannel::FeatureConnectionMonitoring must be ready before "
                 "   calling connectionsForSourceAddresses";
             return QHash<QPair<QHostAddress, quint16>, uint>();
         }
 
         if (state() != TubeChannelStateOpen) {
-            warning() << "OutgoingStreamTubeChannel::connectionsForSourceAddresses() makes sense "
+            TP_QT_WARNING() << "OutgoingStreamTubeChannel::connectionsForSourceAddresses() makes sense "
                 "just when the tube is open";
             return QHash<QPair<QHostAddress, quint16>, uint>();
         }
@@ -657,13 +707,13 @@ QHash<QPair<QHostAddress, quint16>, uint> OutgoingStreamTubeChannel::connections
 QHash<uchar, uint> OutgoingStreamTubeChannel::connectionsForCredentials() const
 {
     if (addressType() != SocketAddressTypeUnix && addressType() != SocketAddressTypeAbstractUnix) {
-        warning() << "OutgoingStreamTubeChannel::connectionsForCredentials() makes sense "
+        TP_QT_WARNING() << "OutgoingStreamTubeChannel::connectionsForCredentials() makes sense "
                 "just when offering an Unix socket";
         return QHash<uchar, uint>();
     }
 
     if (accessControl() != SocketAccessControlCredentials) {
-        warning() << "OutgoingStreamTubeChannel::connectionsForCredentials() makes sense "
+        TP_QT_WARNING() << "OutgoingStreamTubeChannel::connectionsForCredentials() makes sense "
                 "just when offering an Unix socket requiring credentials";
         return QHash<uchar, uint>();
     }
@@ -671,13 +721,13 @@ QHash<uchar, uint> OutgoingStreamTubeChannel::connectionsForCredentials() const
     if (isValid() || !isDroppingConnections() ||
             !requestedFeatures().contains(StreamTubeChannel::FeatureConnectionMonitoring)) {
         if (!isReady(StreamTubeChannel::FeatureConnectionMonitoring)) {
-            warning() << "StreamTubeChannel::FeatureConnectionMonitoring must be ready before "
+            TP_QT_WARNING() << "StreamTubeChannel::FeatureConnectionMonitoring must be ready before "
                 "calling OutgoingStreamTubeChannel::connectionsForCredentials()";
             return QHash<uchar, uint>();
         }
 
         if (state() != TubeChannelStateOpen) {
-            warning() << "OutgoingStreamTubeChannel::connectionsForCredentials() makes sense "
+            TP_QT_WARNING() << "OutgoingStreamTubeChannel::connectionsForCredentials() makes sense "
                 "just when the tube is opened";
             return QHash<uchar, uint>();
         }
@@ -702,13 +752,13 @@ QHash<uint, ContactPtr> OutgoingStreamTubeChannel::contactsForConnections() cons
     if (isValid() || !isDroppingConnections() ||
             !requestedFeatures().contains(StreamTubeChannel::FeatureConnectionMonitoring)) {
         if (!isReady(StreamTubeChannel::FeatureConnectionMonitoring)) {
-            warning() << "StreamTubeChannel::FeatureConnectionMonitoring must be ready before "
+            TP_QT_WARNING() << "StreamTubeChannel::FeatureConnectionMonitoring must be ready before "
                 "calling contactsForConnections";
             return QHash<uint, ContactPtr>();
         }
 
         if (state() != TubeChannelStateOpen) {
-            warning() << "OutgoingStreamTubeChannel::contactsForConnections() makes sense "
+            TP_QT_WARNING() << "OutgoingStreamTubeChannel::contactsForConnections() makes sense "
                 "just when the tube is open";
             return QHash<uint, ContactPtr>();
         }
@@ -734,7 +784,7 @@ void OutgoingStreamTubeChannel::onContactsRetrieved(
         const QList<Tp::ContactPtr> &contacts)
 {
     if (!isValid()) {
-        debug() << "Invalidated OutgoingStreamTubeChannel not emitting queued connection event";
+        TP_QT_DEBUG() << "Invalidated OutgoingStreamTubeChannel not emitting queued connection event";
         return;
     }
 
@@ -769,7 +819,7 @@ void OutgoingStreamTubeChannel::onContactsRetrieved(
                 }
             }
         } else {
-            warning() << "No pending connections found in OSTC" << objectPath() << "for contacts"
+            TP_QT_WARNING() << "No pending connections found in OSTC" << objectPath() << "for contacts"
                 << contacts;
         }
 
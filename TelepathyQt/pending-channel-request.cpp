@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/PendingChannelRequest>
 #include "TelepathyQt/pending-channel-request-internal.h"
 
@@ -111,7 +113,7 @@ PendingChannelRequest::PendingChannelRequest(const AccountPtr &account,
 #endif
                         preferredHandler, hints.allHints()), this);
             } else {
-                warning() << "Hints passed to channel request won't have an effect"
+                TP_QT_WARNING() << "Hints passed to channel request won't have an effect"
                     << "because the Channel Dispatcher service in use is too old";
             }
         }
@@ -142,7 +144,7 @@ PendingChannelRequest::PendingChannelRequest(const AccountPtr &account,
 #endif
                         preferredHandler, hints.allHints()), this);
             } else {
-                warning() << "Hints passed to channel request won't have an effect"
+                TP_QT_WARNING() << "Hints passed to channel request won't have an effect"
                     << "because the Channel Dispatcher service in use is too old";
             }
         }
@@ -240,7 +242,7 @@ void PendingChannelRequest::onWatcherFinished(QDBusPendingCallWatcher *watcher)
 
     if (!reply.isError()) {
         QDBusObjectPath objectPath = reply.argumentAt<0>();
-        debug() << "Got reply to ChannelDispatcher.Ensure/CreateChannel "
+        TP_QT_DEBUG() << "Got reply to ChannelDispatcher.Ensure/CreateChannel "
             "- object path:" << objectPath.path();
 
         if (!account().isNull()) {
@@ -265,7 +267,7 @@ void PendingChannelRequest::onWatcherFinished(QDBusPendingCallWatcher *watcher)
                     SLOT(onProceedOperationFinished(Tp::PendingOperation*)));
         }
     } else {
-        debug().nospace() << "Ensure/CreateChannel failed:" <<
+        TP_QT_DEBUG().nospace() << "Ensure/CreateChannel failed:" <<
             reply.error().name() << ": " << reply.error().message();
         setFinishedWithError(reply.error());
     }
@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/PendingChannel>
 
 #include "TelepathyQt/_gen/pending-channel.moc.hpp"
@@ -81,7 +83,7 @@ protected:
             const ContactFactoryConstPtr &contactFactory) const override
     {
         if (mAccount->objectPath() != objectPath) {
-            warning() << "Account received by the fake factory is different from original account";
+            TP_QT_WARNING() << "Account received by the fake factory is different from original account";
         }
         return mAccount;
     }
@@ -196,7 +198,7 @@ PendingChannel::PendingChannel(const AccountPtr &account,
             .replace(QLatin1String("."), QLatin1String("_")))
         .arg(Private::numHandlers++);
     if (!mPriv->cr->registerClient(mPriv->handler, handlerName, false)) {
-        warning() << "Unable to register handler" << handlerName;
+        TP_QT_WARNING() << "Unable to register handler" << handlerName;
         setFinishedWithError(TP_QT_ERROR_NOT_AVAILABLE,
                 QLatin1String("Unable to register handler"));
         return;
@@ -211,7 +213,7 @@ PendingChannel::PendingChannel(const AccountPtr &account,
 
     handlerName = QString(QLatin1String("org.freedesktop.Telepathy.Client.%1")).arg(handlerName);
 
-    debug() << "Requesting channel through account using handler" << handlerName;
+    TP_QT_DEBUG() << "Requesting channel through account using handler" << handlerName;
     PendingChannelRequest *pcr;
     if (create) {
         pcr = account->createChannel(request, userActionTime, handlerName, ChannelRequestHints());
@@ -268,10 +270,10 @@ ConnectionPtr PendingChannel::connection() const
 bool PendingChannel::yours() const
 {
     if (!isFinished()) {
-        warning() << "PendingChannel::yours called before finished, returning undefined value";
+        TP_QT_WARNING() << "PendingChannel::yours called before finished, returning undefined value";
     }
     else if (!isValid()) {
-        warning() << "PendingChannel::yours called when not valid, returning undefined value";
+        TP_QT_WARNING() << "PendingChannel::yours called when not valid, returning undefined value";
     }
 
     return mPriv->yours;
@@ -345,7 +347,7 @@ QVariantMap PendingChannel::immutableProperties() const
     // This is a reasonable guess - if it's Yours it's guaranteedly Requested by us, and if it's not
     // it could be either Requested by somebody else but also an incoming channel just as well.
     if (!props.contains(TP_QT_IFACE_CHANNEL + QLatin1String(".Requested"))) {
-        debug() << "CM didn't provide Requested in channel immutable props, guessing"
+        TP_QT_DEBUG() << "CM didn't provide Requested in channel immutable props, guessing"
             << mPriv->yours;
         props[TP_QT_IFACE_CHANNEL + QLatin1String(".Requested")] =
             mPriv->yours;
@@ -356,7 +358,7 @@ QVariantMap PendingChannel::immutableProperties() const
     if (!props.contains(TP_QT_IFACE_CHANNEL + QLatin1String(".InitiatorHandle"))) {
         if (qdbus_cast<bool>(props.value(TP_QT_IFACE_CHANNEL + QLatin1String(".Requested")))) {
             if (connection() && connection()->isReady(Connection::FeatureCore)) {
-                debug() << "CM didn't provide InitiatorHandle in channel immutable props, but we "
+                TP_QT_DEBUG() << "CM didn't provide InitiatorHandle in channel immutable props, but we "
                     "know it's the conn's self handle (and have it)";
                 props[TP_QT_IFACE_CHANNEL + QLatin1String(".InitiatorHandle")] =
                     connection()->selfHandle();
@@ -375,10 +377,10 @@ QVariantMap PendingChannel::immutableProperties() const
 ChannelPtr PendingChannel::channel() const
 {
     if (!isFinished()) {
-        warning() << "PendingChannel::channel called before finished, returning 0";
+        TP_QT_WARNING() << "PendingChannel::channel called before finished, returning 0";
         return ChannelPtr();
     } else if (!isValid()) {
-        warning() << "PendingChannel::channel called when not valid, returning 0";
+        TP_QT_WARNING() << "PendingChannel::channel called when not valid, returning 0";
         return ChannelPtr();
     }
 
@@ -394,10 +396,10 @@ ChannelPtr PendingChannel::channel() const
 HandledChannelNotifier *PendingChannel::handledChannelNotifier() const
 {
     if (!isFinished()) {
-        warning() << "PendingChannel::handledChannelNotifier called before finished, returning 0";
+        TP_QT_WARNING() << "PendingChannel::handledChannelNotifier called before finished, returning 0";
         return nullptr;
     } else if (!isValid()) {
-        warning() << "PendingChannel::handledChannelNotifier called when not valid, returning 0";
+        TP_QT_WARNING() << "PendingChannel::handledChannelNotifier called when not valid, returning 0";
         return nullptr;
     }
 
@@ -415,7 +417,7 @@ void PendingChannel::onConnectionCreateChannelFinished(QDBusPendingCallWatcher *
         QString objectPath = reply.argumentAt<0>().path();
         QVariantMap map = reply.argumentAt<1>();
 
-        debug() << "Got reply to Connection.CreateChannel - object path:" << objectPath;
+        TP_QT_DEBUG() << "Got reply to Connection.CreateChannel - object path:" << objectPath;
 
         PendingReady *channelReady =
             connection()->channelFactory()->proxy(connection(), objectPath, map);
@@ -430,7 +432,7 @@ void PendingChannel::onConnectionCreateChannelFinished(QDBusPendingCallWatcher *
                 SIGNAL(finished(Tp::PendingOperation*)),
                 SLOT(onChannelReady(Tp::PendingOperation*)));
     } else {
-        debug().nospace() << "CreateChannel failed:" <<
+        TP_QT_DEBUG().nospace() << "CreateChannel failed:" <<
             reply.error().name() << ": " << reply.error().message();
         setFinishedWithError(reply.error());
     }
@@ -447,7 +449,7 @@ void PendingChannel::onConnectionEnsureChannelFinished(QDBusPendingCallWatcher *
         QString objectPath = reply.argumentAt<1>().path();
         QVariantMap map = reply.argumentAt<2>();
 
-        debug() << "Got reply to Connection.EnsureChannel - object path:" << objectPath;
+        TP_QT_DEBUG() << "Got reply to Connection.EnsureChannel - object path:" << objectPath;
 
         PendingReady *channelReady =
             connection()->channelFactory()->proxy(connection(), objectPath, map);
@@ -462,7 +464,7 @@ void PendingChannel::onConnectionEnsureChannelFinished(QDBusPendingCallWatcher *
                 SIGNAL(finished(Tp::PendingOperation*)),
                 SLOT(onChannelReady(Tp::PendingOperation*)));
     } else {
-        debug().nospace() << "EnsureChannel failed:" <<
+        TP_QT_DEBUG().nospace() << "EnsureChannel failed:" <<
             reply.error().name() << ": " << reply.error().message();
         setFinishedWithError(reply.error());
     }
@@ -475,7 +477,7 @@ void PendingChannel::onChannelReady(PendingOperation *op)
     if (!op->isError()) {
         setFinished();
     } else {
-        debug() << "Making the channel ready for" << this << "failed with" << op->errorName()
+        TP_QT_DEBUG() << "Making the channel ready for" << this << "failed with" << op->errorName()
             << ":" << op->errorMessage();
         setFinishedWithError(op->errorName(), op->errorMessage());
     }
@@ -487,7 +489,7 @@ void PendingChannel::onHandlerError(const QString &errorName, const QString &err
         return;
     }
 
-    warning() << "Creating/ensuring channel failed with" << errorName
+    TP_QT_WARNING() << "Creating/ensuring channel failed with" << errorName
         << ":" << errorMessage;
     setFinishedWithError(errorName, errorMessage);
 }
@@ -495,7 +497,7 @@ void PendingChannel::onHandlerError(const QString &errorName, const QString &err
 void PendingChannel::onHandlerChannelReceived(const ChannelPtr &channel)
 {
     if (isFinished()) {
-        warning() << "Handler received the channel but this operation already finished due "
+        TP_QT_WARNING() << "Handler received the channel but this operation already finished due "
             "to failure in the channel request";
         return;
     }
@@ -519,14 +521,14 @@ void PendingChannel::onAccountCreateChannelFinished(PendingOperation *op)
 {
     if (isFinished()) {
         if (isError()) {
-            warning() << "Creating/ensuring channel finished with a failure after the internal "
+            TP_QT_WARNING() << "Creating/ensuring channel finished with a failure after the internal "
                 "handler already got a channel, ignoring";
         }
         return;
     }
 
     if (op->isError()) {
-        warning() << "Creating/ensuring channel failed with" << op->errorName()
+        TP_QT_WARNING() << "Creating/ensuring channel failed with" << op->errorName()
             << ":" << op->errorMessage();
         setFinishedWithError(op->errorName(), op->errorMessage());
         return;
@@ -536,14 +538,14 @@ void PendingChannel::onAccountCreateChannelFinished(PendingOperation *op)
         // Our handler hasn't be called but the channel request is complete.
         // That means another handler handled the channels so we don't own it.
         if (mPriv->create) {
-            warning() << "Creating/ensuring channel failed with" << TP_QT_ERROR_SERVICE_CONFUSED
+            TP_QT_WARNING() << "Creating/ensuring channel failed with" << TP_QT_ERROR_SERVICE_CONFUSED
                 << ":" << QLatin1String("CD.CreateChannel/WithHints returned successfully and "
                         "the handler didn't receive the channel yet");
             setFinishedWithError(TP_QT_ERROR_SERVICE_CONFUSED,
                     QLatin1String("CD.CreateChannel/WithHints returned successfully and "
                         "the handler didn't receive the channel yet"));
         } else {
-            warning() << "Creating/ensuring channel failed with" << TP_QT_ERROR_NOT_YOURS
+            TP_QT_WARNING() << "Creating/ensuring channel failed with" << TP_QT_ERROR_NOT_YOURS
                 << ":" << QLatin1String("Another handler is handling this channel");
             setFinishedWithError(TP_QT_ERROR_NOT_YOURS,
                     QLatin1String("Another handler is handling this channel"));
@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryContacts
+
 #include <TelepathyQt/PendingContactAttributes>
 
 #include "TelepathyQt/_gen/pending-contact-attributes.moc.hpp"
@@ -131,11 +133,11 @@ bool PendingContactAttributes::shouldReference() const
 ReferencedHandles PendingContactAttributes::validHandles() const
 {
     if (!isFinished()) {
-        warning() << "PendingContactAttributes::validHandles() called before finished";
+        TP_QT_WARNING() << "PendingContactAttributes::validHandles() called before finished";
     } else if (isError()) {
-        warning() << "PendingContactAttributes::validHandles() called when errored";
+        TP_QT_WARNING() << "PendingContactAttributes::validHandles() called when errored";
     } else if (!shouldReference()) {
-        warning() << "PendingContactAttributes::validHandles() called but weren't asked to"
+        TP_QT_WARNING() << "PendingContactAttributes::validHandles() called but weren't asked to"
                   << "reference handles";
     }
 
@@ -152,9 +154,9 @@ ReferencedHandles PendingContactAttributes::validHandles() const
 UIntList PendingContactAttributes::invalidHandles() const
 {
     if (!isFinished()) {
-        warning() << "PendingContactAttributes::validHandles() called before finished";
+        TP_QT_WARNING() << "PendingContactAttributes::validHandles() called before finished";
     } else if (isError()) {
-        warning() << "PendingContactAttributes::validHandles() called when errored";
+        TP_QT_WARNING() << "PendingContactAttributes::validHandles() called when errored";
     }
 
     return mPriv->invalidHandles;
@@ -171,9 +173,9 @@ UIntList PendingContactAttributes::invalidHandles() const
 ContactAttributesMap PendingContactAttributes::attributes() const
 {
     if (!isFinished()) {
-        warning() << "PendingContactAttributes::validHandles() called before finished";
+        TP_QT_WARNING() << "PendingContactAttributes::validHandles() called before finished";
     } else if (isError()) {
-        warning() << "PendingContactAttributes::validHandles() called when errored";
+        TP_QT_WARNING() << "PendingContactAttributes::validHandles() called when errored";
     }
 
     return mPriv->attributes;
@@ -184,7 +186,7 @@ void PendingContactAttributes::onCallFinished(QDBusPendingCallWatcher* watcher)
     QDBusPendingReply<ContactAttributesMap> reply = *watcher;
 
     if (reply.isError()) {
-        debug().nospace() << "GetCAs: error " << reply.error().name() << ": " << reply.error().message();
+        TP_QT_DEBUG().nospace() << "GetCAs: error " << reply.error().name() << ": " << reply.error().message();
         setFinishedWithError(reply.error());
     } else {
         mPriv->attributes = reply.value();
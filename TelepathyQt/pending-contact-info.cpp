@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryContacts
+
 #include <TelepathyQt/PendingContactInfo>
 
 #include "TelepathyQt/_gen/pending-contact-info.moc.hpp"
@@ -99,9 +101,9 @@ ContactPtr PendingContactInfo::contact() const
 Contact::InfoFields PendingContactInfo::infoFields() const
 {
     if (!isFinished()) {
-        warning() << "PendingContactInfo::info called before finished";
+        TP_QT_WARNING() << "PendingContactInfo::info called before finished";
     } else if (!isValid()) {
-        warning() << "PendingContactInfo::info called when not valid";
+        TP_QT_WARNING() << "PendingContactInfo::info called when not valid";
     }
 
     return mPriv->info;
@@ -113,10 +115,10 @@ void PendingContactInfo::onCallFinished(QDBusPendingCallWatcher *watcher)
 
     if (!reply.isError()) {
         mPriv->info = Contact::InfoFields(reply.value());
-        debug() << "Got reply to ContactInfo.RequestContactInfo";
+        TP_QT_DEBUG() << "Got reply to ContactInfo.RequestContactInfo";
         setFinished();
     } else {
-        debug().nospace() <<
+        TP_QT_DEBUG().nospace() <<
             "ContactInfo.RequestContactInfo failed: " <<
             reply.error().name() << ": " << reply.error().message();
         setFinishedWithError(reply.error());
@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryContacts
+
 #include <TelepathyQt/PendingContacts>
 #include "TelepathyQt/pending-contacts-internal.h"
 
@@ -42,6 +44,10 @@
 namespace Tp
 {
 
+// Up to this many unknown identifiers are resolved with concurrent GetContactByID
+// calls, more are resolved with a single RequestHandles and GetContactAttributes
+static const int maxContactByIDCalls = 4;
+
 struct TP_QT_NO_EXPORT PendingContacts::Private
 {
     Private(PendingContacts *parent, const ContactManagerPtr &manager, const UIntList &handles,
@@ -100,6 +106,8 @@ struct TP_QT_NO_EXPORT PendingContacts::Private
     }
 
     void setFinished();
+    void requestHandlesForIdentifiers(const QStringList &identifiers);
+    void finishForIdentifiers();
 
     bool checkRequestTypeAndState(const char *methodName, const char *debug, RequestType type);
 
@@ -120,6 +128,13 @@ struct TP_QT_NO_EXPORT PendingContacts::Private
     QList<ContactPtr> contactsToUpgrade;
     PendingContacts *nested;
 
+    // ForIdentifiers: the contacts found so far, the GetContactByID calls in
+    // flight, and the identifiers left to RequestHandles
+    QHash<QString, ContactPtr> contactsById;
+    QHash<QDBusPendingCallWatcher*, QString> identifierLookups;
+    QStringList fallbackIdentifiers;
+    QMultiHash<uint, QString> identifiersByHandle;
+
     // Results
     QList<ContactPtr> contacts;
     UIntList invalidHandles;
@@ -146,18 +161,40 @@ void PendingContacts::Private::setFinished()
     parent->setFinished();
 }
 
+void PendingContacts::Private::requestHandlesForIdentifiers(const QStringList &identifiers)
+{
+    PendingHandles *handles = manager->connection()->lowlevel()->requestHandles(
+            HandleTypeContact, identifiers);
+    parent->connect(handles,
+            SIGNAL(finished(Tp::PendingOperation*)),
+            SLOT(onRequestHandlesFinished(Tp::PendingOperation*)));
+}
+
+void PendingContacts::Private::finishForIdentifiers()
+{
+    foreach (const QString &id, addresses) {
+        ContactPtr contact = contactsById.value(id);
+        if (contact) {
+            contacts.append(contact);
+            validIds.append(id);
+        }
+    }
+
+    parent->setFinished();
+}
+
 bool PendingContacts::Private::checkRequestTypeAndState(const char *methodName,
         const char *debug,
         RequestType type)
 {
     if (!parent->isFinished()) {
-        warning().nospace() << "PendingContacts::" << methodName << "() called before finished";
+        TP_QT_WARNING().nospace() << "PendingContacts::" << methodName << "() called before finished";
         return false;
     } else if (parent->isError()) {
-        warning().nospace() << "PendingContacts::" << methodName << "() called when errored";
+        TP_QT_WARNING().nospace() << "PendingContacts::" << methodName << "() called when errored";
         return false;
     } else if (requestType != type) {
-        warning().nospace() << "PendingContacts::" << methodName << "() called for" <<
+        TP_QT_WARNING().nospace() << "PendingContacts::" << methodName << "() called for" <<
             this << "which is not for " << debug;
         return false;
     }
@@ -232,10 +269,7 @@ PendingContacts::PendingContacts(const ContactManagerPtr &manager,
 
     if (type == ForIdentifiers) {
         Q_ASSERT(interfaces.isEmpty());
-        PendingHandles *handles = conn->lowlevel()->requestHandles(HandleTypeContact, list);
-        connect(handles,
-                SIGNAL(finished(Tp::PendingOperation*)),
-                SLOT(onRequestHandlesFinished(Tp::PendingOperation*)));
+        mPriv->requestHandlesForIdentifiers(list);
     } else if (type == ForUris) {
         Client::ConnectionInterfaceAddressingInterface *connAddressingIface =
             conn->optionalInterface<Client::ConnectionInterfaceAddressingInterface>(
@@ -253,6 +287,51 @@ PendingContacts::PendingContacts(const ContactManagerPtr &manager,
     }
 }
 
+PendingContacts::PendingContacts(const ContactManagerPtr &manager,
+        const QStringList &identifiers, const Features &features,
+        const QStringList &interfaces, const QHash<QString, ContactPtr> &satisfyingContacts)
+    : PendingOperation(manager->connection()),
+      mPriv(new Private(this, manager, identifiers, ForIdentifiers, features))
+{
+    mPriv->contactsById = satisfyingContacts;
+
+    QStringList unknownIdentifiers;
+    QSet<QString> seen;
+    foreach (const QString &id, identifiers) {
+        if (!satisfyingContacts.contains(id) && !seen.contains(id)) {
+            unknownIdentifiers.append(id);
+            seen.insert(id);
+        }
+    }
+
+    if (unknownIdentifiers.isEmpty()) {
+        mPriv->finishForIdentifiers();
+        return;
+    }
+
+    ConnectionPtr conn = manager->connection();
+    Client::ConnectionInterfaceContactsInterface *connContactsIface =
+        conn->optionalInterface<Client::ConnectionInterfaceContactsInterface>(
+                OptionalInterfaceFactory<Connection>::CheckInterfaceSupported);
+    if (!connContactsIface || unknownIdentifiers.size() > maxContactByIDCalls) {
+        mPriv->requestHandlesForIdentifiers(unknownIdentifiers);
+        return;
+    }
+
+    // GetContactByID returns the handle together with the attributes, and the
+    // calls are all in flight at once, so this takes a single round trip instead
+    // of RequestHandles followed by GetContactAttributes. That is only worth it
+    // for a few identifiers, as each of them is a separate D-Bus call.
+    foreach (const QString &id, unknownIdentifiers) {
+        QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(
+                connContactsIface->GetContactByID(id, interfaces), this);
+        mPriv->identifierLookups.insert(watcher, id);
+        connect(watcher,
+                SIGNAL(finished(QDBusPendingCallWatcher*)),
+                SLOT(onGetContactByIDFinished(QDBusPendingCallWatcher*)));
+    }
+}
+
 PendingContacts::PendingContacts(const ContactManagerPtr &manager,
         const QString &vcardField, const QStringList &vcardAddresses,
         const Features &features, const QStringList &interfaces,
@@ -331,7 +410,7 @@ bool PendingContacts::isForHandles() const
 UIntList PendingContacts::handles() const
 {
     if (!isForHandles()) {
-        warning() << "Tried to get handles from" << this << "which is not for handles!";
+        TP_QT_WARNING() << "Tried to get handles from" << this << "which is not for handles!";
     }
 
     return mPriv->handles;
@@ -345,7 +424,7 @@ bool PendingContacts::isForIdentifiers() const
 QStringList PendingContacts::identifiers() const
 {
     if (!isForIdentifiers()) {
-        warning() << "Tried to get identifiers from" << this << "which is not for identifiers!";
+        TP_QT_WARNING() << "Tried to get identifiers from" << this << "which is not for identifiers!";
         return QStringList();
     }
 
@@ -360,7 +439,7 @@ bool PendingContacts::isForVCardAddresses() const
 QString PendingContacts::vcardField() const
 {
     if (!isForVCardAddresses()) {
-        warning() << "Tried to get vcard field from" << this << "which is not for vcard addresses!";
+        TP_QT_WARNING() << "Tried to get vcard field from" << this << "which is not for vcard addresses!";
     }
 
     return mPriv->vcardField;
@@ -369,7 +448,7 @@ QString PendingContacts::vcardField() const
 QStringList PendingContacts::vcardAddresses() const
 {
     if (!isForVCardAddresses()) {
-        warning() << "Tried to get vcard addresses from" << this << "which is not for vcard addresses!";
+        TP_QT_WARNING() << "Tried to get vcard addresses from" << this << "which is not for vcard addresses!";
         return QStringList();
     }
 
@@ -384,7 +463,7 @@ bool PendingContacts::isForUris() const
 QStringList PendingContacts::uris() const
 {
     if (!isForUris()) {
-        warning() << "Tried to get uris from" << this << "which is not for uris!";
+        TP_QT_WARNING() << "Tried to get uris from" << this << "which is not for uris!";
         return QStringList();
     }
 
@@ -399,7 +478,7 @@ bool PendingContacts::isUpgrade() const
 QList<ContactPtr> PendingContacts::contactsToUpgrade() const
 {
     if (!isUpgrade()) {
-        warning() << "Tried to get contacts to upgrade from" << this << "which is not an upgrade!";
+        TP_QT_WARNING() << "Tried to get contacts to upgrade from" << this << "which is not an upgrade!";
     }
 
     return mPriv->contactsToUpgrade;
@@ -408,9 +487,9 @@ QList<ContactPtr> PendingContacts::contactsToUpgrade() const
 QList<ContactPtr> PendingContacts::contacts() const
 {
     if (!isFinished()) {
-        warning() << "PendingContacts::contacts() called before finished";
+        TP_QT_WARNING() << "PendingContacts::contacts() called before finished";
     } else if (isError()) {
-        warning() << "PendingContacts::contacts() called when errored";
+        TP_QT_WARNING() << "PendingContacts::contacts() called when errored";
     }
 
     return mPriv->contacts;
@@ -485,7 +564,7 @@ void PendingContacts::onAttributesFinished(PendingOperation *operation)
         qobject_cast<PendingContactAttributes *>(operation);
 
     if (pendingAttributes->isError()) {
-        debug() << "PendingAttrs error" << pendingAttributes->errorName()
+        TP_QT_DEBUG() << "PendingAttrs error" << pendingAttributes->errorName()
                 << "message" << pendingAttributes->errorMessage();
         setFinishedWithError(pendingAttributes->errorName(), pendingAttributes->errorMessage());
         return;
@@ -515,16 +594,27 @@ void PendingContacts::onRequestHandlesFinished(PendingOperation *operation)
 {
     PendingHandles *pendingHandles = qobject_cast<PendingHandles *>(operation);
 
-    mPriv->validIds = pendingHandles->validNames();
-    mPriv->invalidIds = pendingHandles->invalidNames();
-
     if (pendingHandles->isError()) {
-        debug() << "RequestHandles error" << operation->errorName()
+        TP_QT_DEBUG() << "RequestHandles error" << operation->errorName()
                 << "message" << operation->errorMessage();
         setFinishedWithError(operation->errorName(), operation->errorMessage());
         return;
     }
 
+    // the identifiers may only be the ones GetContactByID could not resolve,
+    // so merge with what is known already
+    QHash<QString, QPair<QString, QString> > invalidNames = pendingHandles->invalidNames();
+    QHash<QString, QPair<QString, QString> >::const_iterator it = invalidNames.constBegin();
+    for (; it != invalidNames.constEnd(); ++it) {
+        mPriv->invalidIds.insert(it.key(), it.value());
+    }
+
+    QStringList validNames = pendingHandles->validNames();
+    ReferencedHandles handles = pendingHandles->handles();
+    for (int i = 0; i < validNames.size() && i < handles.size(); ++i) {
+        mPriv->identifiersByHandle.insert(handles[i], validNames[i]);
+    }
+
     mPriv->nested = manager()->contactsForHandles(pendingHandles->handles(), features());
     connect(mPriv->nested,
             SIGNAL(finished(Tp::PendingOperation*)),
@@ -567,7 +657,7 @@ void PendingContacts::onReferenceHandlesFinished(PendingOperation *operation)
     PendingHandles *pendingHandles = qobject_cast<PendingHandles *>(operation);
 
     if (pendingHandles->isError()) {
-        debug() << "ReferenceHandles error" << operation->errorName()
+        TP_QT_DEBUG() << "ReferenceHandles error" << operation->errorName()
                 << "message" << operation->errorMessage();
         setFinishedWithError(operation->errorName(), operation->errorMessage());
         return;
@@ -604,14 +694,28 @@ void PendingContacts::onNestedFinished(PendingOperation *operation)
     Q_ASSERT(operation == mPriv->nested);
 
     if (operation->isError()) {
-        debug() << " error" << operation->errorName()
+        TP_QT_DEBUG() << " error" << operation->errorName()
                 << "message" << operation->errorMessage();
         setFinishedWithError(operation->errorName(), operation->errorMessage());
         return;
     }
 
-    mPriv->contacts = mPriv->nested->contacts();
+    QList<ContactPtr> contacts = mPriv->nested->contacts();
     mPriv->nested = nullptr;
+
+    if (mPriv->requestType == ForIdentifiers) {
+        foreach (const ContactPtr &contact, contacts) {
+            // identifiers normalizing to the same contact share its handle
+            foreach (const QString &id, mPriv->identifiersByHandle.values(contact->handle()[0])) {
+                manager()->indexContactById(id, contact);
+                mPriv->contactsById.insert(id, contact);
+            }
+        }
+        mPriv->finishForIdentifiers();
+        return;
+    }
+
+    mPriv->contacts = contacts;
     mPriv->setFinished();
 }
 
@@ -620,7 +724,7 @@ void PendingContacts::onInspectHandlesFinished(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<QStringList> reply = *watcher;
 
     if (reply.isError()) {
-        debug().nospace() << "InspectHandles: error " << reply.error().name() << ": "
+        TP_QT_DEBUG().nospace() << "InspectHandles: error " << reply.error().name() << ": "
             << reply.error().message();
         setFinishedWithError(reply.error());
         return;
@@ -644,6 +748,54 @@ void PendingContacts::onInspectHandlesFinished(QDBusPendingCallWatcher *watcher)
     watcher->deleteLater();
 }
 
+void PendingContacts::onGetContactByIDFinished(QDBusPendingCallWatcher *watcher)
+{
+    QDBusPendingReply<uint, QVariantMap> reply = *watcher;
+    QString id = mPriv->identifierLookups.take(watcher);
+    watcher->deleteLater();
+
+    if (isFinished()) {
+        // another lookup failed already
+        return;
+    }
+
+    if (reply.isError()) {
+        QDBusError error = reply.error();
+        if (error.type() == QDBusError::UnknownMethod ||
+            error.name() == TP_QT_ERROR_NOT_IMPLEMENTED) {
+            // the CM predates GetContactByID or does not implement it
+            mPriv->fallbackIdentifiers.append(id);
+        } else if (error.name() == TP_QT_ERROR_INVALID_HANDLE ||
+                   error.name() == TP_QT_ERROR_INVALID_ARGUMENT ||
+                   error.name() == TP_QT_ERROR_NOT_AVAILABLE) {
+            mPriv->invalidIds.insert(id, QPair<QString, QString>(error.name(), error.message()));
+        } else {
+            TP_QT_DEBUG().nospace() << "GetContactByID: error " << error.name() << ": "
+                << error.message();
+            setFinishedWithError(error);
+            return;
+        }
+    } else {
+        ReferencedHandles referencedHandle(mPriv->manager->connection(), HandleTypeContact,
+                UIntList() << reply.argumentAt<0>());
+        ContactPtr contact = manager()->ensureContact(referencedHandle,
+                mPriv->missingFeatures, reply.argumentAt<1>());
+        manager()->indexContactById(id, contact);
+        mPriv->contactsById.insert(id, contact);
+    }
+
+    if (!mPriv->identifierLookups.isEmpty()) {
+        return;
+    }
+
+    if (!mPriv->fallbackIdentifiers.isEmpty()) {
+        mPriv->requestHandlesForIdentifiers(mPriv->fallbackIdentifiers);
+        return;
+    }
+
+    mPriv->finishForIdentifiers();
+}
+
 void PendingContacts::allAttributesFetched()
 {
     foreach (uint handle, mPriv->handles) {
@@ -712,7 +864,7 @@ void PendingAddressingGetContacts::onGetContactsFinished(QDBusPendingCallWatcher
         mAttributes = reply.argumentAt<1>();
         setFinished();
     } else {
-        debug().nospace() << "GetContactsBy* failed: " <<
+        TP_QT_DEBUG().nospace() << "GetContactsBy* failed: " <<
             reply.error().name() << ": " << reply.error().message();
         setFinishedWithError(reply.error());
     }
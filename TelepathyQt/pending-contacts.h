@@ -86,6 +86,7 @@ private Q_SLOTS:
     TP_QT_NO_EXPORT void onReferenceHandlesFinished(Tp::PendingOperation *);
     TP_QT_NO_EXPORT void onNestedFinished(Tp::PendingOperation *);
     TP_QT_NO_EXPORT void onInspectHandlesFinished(QDBusPendingCallWatcher *);
+    TP_QT_NO_EXPORT void onGetContactByIDFinished(QDBusPendingCallWatcher *);
 
 private:
     friend class ContactManager;
@@ -114,6 +115,10 @@ private:
             const QStringList &interfaces,
             const QString &errorName = QString(),
             const QString &errorMessage = QString());
+    TP_QT_NO_EXPORT PendingContacts(const ContactManagerPtr &manager, const QStringList &identifiers,
+            const Features &features,
+            const QStringList &interfaces,
+            const QHash<QString, ContactPtr> &satisfyingContacts);
     TP_QT_NO_EXPORT PendingContacts(const ContactManagerPtr &manager, const QString &vcardField,
             const QStringList &vcardAddresses,
             const Features &features,
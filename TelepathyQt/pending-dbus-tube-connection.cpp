@@ -19,6 +19,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/PendingDBusTubeConnection>
 
 #include "TelepathyQt/_gen/pending-dbus-tube-connection.moc.hpp"
@@ -162,11 +164,11 @@ void PendingDBusTubeConnection::onConnectionFinished(PendingOperation *op)
         return;
     }
 
-    debug() << "Accept/Offer tube finished successfully";
+    TP_QT_DEBUG() << "Accept/Offer tube finished successfully";
 
     // Now get the address and set it
     PendingString *ps = qobject_cast<PendingString*>(op);
-    debug() << "Got address " << ps->result();
+    TP_QT_DEBUG() << "Got address " << ps->result();
     mPriv->tube->setAddress(ps->result());
 
     // It might have been already opened - check
@@ -181,7 +183,7 @@ void PendingDBusTubeConnection::onConnectionFinished(PendingOperation *op)
 
 void PendingDBusTubeConnection::onStateChanged(TubeChannelState state)
 {
-    debug() << "Tube state changed to " << state;
+    TP_QT_DEBUG() << "Tube state changed to " << state;
     if (state == TubeChannelStateOpen) {
         if (!mPriv->parameters.isEmpty()) {
             // Inject the parameters into the tube
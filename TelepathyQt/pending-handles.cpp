@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryContacts
+
 #include <TelepathyQt/PendingHandles>
 
 #include "TelepathyQt/_gen/pending-handles.moc.hpp"
@@ -70,7 +72,7 @@ PendingHandles::PendingHandles(const ConnectionPtr &connection, HandleType handl
     : PendingOperation(connection),
       mPriv(new Private)
 {
-    debug() << "PendingHandles(request)";
+    TP_QT_DEBUG() << "PendingHandles(request)";
 
     mPriv->handleType = handleType;
     mPriv->isRequest = true;
@@ -93,7 +95,7 @@ PendingHandles::PendingHandles(const ConnectionPtr &connection, HandleType handl
     : PendingOperation(connection),
       mPriv(new Private)
 {
-    debug() << "PendingHandles(reference)";
+    TP_QT_DEBUG() << "PendingHandles(reference)";
 
     mPriv->handleType = handleType;
     mPriv->isRequest = false;
@@ -102,11 +104,11 @@ PendingHandles::PendingHandles(const ConnectionPtr &connection, HandleType handl
     mPriv->requestsFinished = 0;
 
     if (notYetHeld.isEmpty()) {
-        debug() << " All handles already held, finishing up instantly";
+        TP_QT_DEBUG() << " All handles already held, finishing up instantly";
         mPriv->handles = mPriv->alreadyHeld;
         setFinished();
     } else {
-        debug() << " Calling HoldHandles";
+        TP_QT_DEBUG() << " Calling HoldHandles";
 
         QDBusPendingCallWatcher *watcher =
             new QDBusPendingCallWatcher(
@@ -191,10 +193,10 @@ const QStringList &PendingHandles::namesRequested() const
 QStringList PendingHandles::validNames() const
 {
     if (!isFinished()) {
-        warning() << "PendingHandles::validNames called before finished";
+        TP_QT_WARNING() << "PendingHandles::validNames called before finished";
         return QStringList();
     } else if (!isValid()) {
-        warning() << "PendingHandles::validNames called when not valid";
+        TP_QT_WARNING() << "PendingHandles::validNames called when not valid";
         return QStringList();
     }
 
@@ -204,7 +206,7 @@ QStringList PendingHandles::validNames() const
 QHash<QString, QPair<QString, QString> > PendingHandles::invalidNames() const
 {
     if (!isFinished()) {
-        warning() << "PendingHandles::invalidNames called before finished";
+        TP_QT_WARNING() << "PendingHandles::invalidNames called before finished";
         return QHash<QString, QPair<QString, QString> >();
     }
 
@@ -238,10 +240,10 @@ const UIntList &PendingHandles::handlesToReference() const
 ReferencedHandles PendingHandles::handles() const
 {
     if (!isFinished()) {
-        warning() << "PendingHandles::handles() called before finished";
+        TP_QT_WARNING() << "PendingHandles::handles() called before finished";
         return ReferencedHandles();
     } else if (!isValid()) {
-        warning() << "PendingHandles::handles() called when not valid";
+        TP_QT_WARNING() << "PendingHandles::handles() called when not valid";
         return ReferencedHandles();
     }
 
@@ -251,7 +253,7 @@ ReferencedHandles PendingHandles::handles() const
 UIntList PendingHandles::invalidHandles() const
 {
     if (!isFinished()) {
-        warning() << "PendingHandles::invalidHandles called before finished";
+        TP_QT_WARNING() << "PendingHandles::invalidHandles called before finished";
     }
 
     return mPriv->invalidHandles;
@@ -279,7 +281,7 @@ void PendingHandles::onRequestHandlesFinished(QDBusPendingCallWatcher *watcher)
         }
 
         if (mPriv->namesRequested.size() == 1) {
-            debug().nospace() << " Failure: error " <<
+            TP_QT_DEBUG().nospace() << " Failure: error " <<
                 reply.error().name() << ": " <<
                 reply.error().message();
 
@@ -306,7 +308,7 @@ void PendingHandles::onRequestHandlesFinished(QDBusPendingCallWatcher *watcher)
             mPriv->idsForWatchers.insert(watcher, name);
         }
     } else {
-        debug() << "Received reply to RequestHandles";
+        TP_QT_DEBUG() << "Received reply to RequestHandles";
         mPriv->handles = ReferencedHandles(connection(),
                 mPriv->handleType, reply.value());
         mPriv->validNames.append(mPriv->namesRequested);
@@ -319,10 +321,10 @@ void PendingHandles::onHoldHandlesFinished(QDBusPendingCallWatcher *watcher)
 {
     QDBusPendingReply<void> reply = *watcher;
 
-    debug() << "Received reply to HoldHandles";
+    TP_QT_DEBUG() << "Received reply to HoldHandles";
 
     if (reply.isError()) {
-        debug().nospace() << " Failure: error " <<
+        TP_QT_DEBUG().nospace() << " Failure: error " <<
             reply.error().name() << ": " <<
             reply.error().message();
 
@@ -338,7 +340,7 @@ void PendingHandles::onHoldHandlesFinished(QDBusPendingCallWatcher *watcher)
         }
 
         if (mPriv->handlesToReference.size() == 1) {
-            debug().nospace() << " Failure: error " <<
+            TP_QT_DEBUG().nospace() << " Failure: error " <<
                 reply.error().name() << ": " <<
                 reply.error().message();
 
@@ -377,10 +379,10 @@ void PendingHandles::onRequestHandlesFallbackFinished(QDBusPendingCallWatcher *w
     Q_ASSERT(mPriv->idsForWatchers.contains(watcher));
     QString id = mPriv->idsForWatchers.value(watcher);
 
-    debug() << "Received reply to RequestHandles(" << id << ")";
+    TP_QT_DEBUG() << "Received reply to RequestHandles(" << id << ")";
 
     if (reply.isError()) {
-        debug().nospace() << " Failure: error " << reply.error().name() << ": "
+        TP_QT_DEBUG().nospace() << " Failure: error " << reply.error().name() << ": "
             << reply.error().message();
 
         // if the error is disconnected for example, fail immediately
@@ -430,9 +432,9 @@ void PendingHandles::onRequestHandlesFallbackFinished(QDBusPendingCallWatcher *w
             setFinished();
         }
 
-        debug() << " namesRequested:" << mPriv->namesRequested;
-        debug() << " invalidNames  :" << mPriv->invalidNames;
-        debug() << " validNames    :" << mPriv->validNames;
+        TP_QT_DEBUG() << " namesRequested:" << mPriv->namesRequested;
+        TP_QT_DEBUG() << " invalidNames  :" << mPriv->invalidNames;
+        TP_QT_DEBUG() << " validNames    :" << mPriv->validNames;
 
         connection()->handleRequestLanded(mPriv->handleType);
     }
@@ -447,10 +449,10 @@ void PendingHandles::onHoldHandlesFallbackFinished(QDBusPendingCallWatcher *watc
     Q_ASSERT(mPriv->handlesForWatchers.contains(watcher));
     uint handle = mPriv->handlesForWatchers.value(watcher);
 
-    debug() << "Received reply to HoldHandles(" << handle << ")";
+    TP_QT_DEBUG() << "Received reply to HoldHandles(" << handle << ")";
 
     if (reply.isError()) {
-        debug().nospace() << " Failure: error " << reply.error().name() << ": "
+        TP_QT_DEBUG().nospace() << " Failure: error " << reply.error().name() << ": "
             << reply.error().message();
 
         // if the error is disconnected for example, fail immediately
@@ -22,6 +22,8 @@
 
 #include <TelepathyQt/PendingOperation>
 
+#include <TelepathyQt/CompletionHandle>
+
 #define IN_TP_QT_HEADER
 #include "simple-pending-operations.h"
 #undef IN_TP_QT_HEADER
@@ -33,6 +35,7 @@
 
 #include <QDBusPendingCall>
 #include <QDBusPendingCallWatcher>
+#include <QPointer>
 #include <QTimer>
 
 namespace Tp
@@ -42,16 +45,39 @@ struct TP_QT_NO_EXPORT PendingOperation::Private
 {
     Private(const SharedPtr<RefCounted> &object)
         : object(object),
-          finished(false)
+          finished(false),
+          completion(nullptr)
     {
     }
 
+    ~Private()
+    {
+        delete completion;
+    }
+
+    void finishCompletion();
+
     SharedPtr<RefCounted> object;
     QString errorName;
     QString errorMessage;
     bool finished;
+    // created on demand by PendingOperation::completion()
+    CompletionHandle *completion;
 };
 
+void PendingOperation::Private::finishCompletion()
+{
+    if (!completion) {
+        return;
+    }
+
+    if (errorName.isEmpty()) {
+        completion->setFinished();
+    } else {
+        completion->setFinishedWithError(errorName, errorMessage);
+    }
+}
+
 /**
  * \class PendingOperation
  * \headerfile TelepathyQt/pending-operation.h <TelepathyQt/PendingOperation>
@@ -99,7 +125,7 @@ PendingOperation::PendingOperation(const SharedPtr<RefCounted> &object)
 PendingOperation::~PendingOperation()
 {
     if (!mPriv->finished) {
-        warning() << this <<
+        TP_QT_WARNING() << this <<
             "still pending when it was deleted - finished will "
             "never be emitted";
     }
@@ -132,10 +158,10 @@ void PendingOperation::setFinished()
 {
     if (mPriv->finished) {
         if (!mPriv->errorName.isEmpty()) {
-            warning() << this << "trying to finish with success, but already"
+            TP_QT_WARNING() << this << "trying to finish with success, but already"
                 " failed with" << mPriv->errorName << ":" << mPriv->errorMessage;
         } else {
-            warning() << this << "trying to finish with success, but already"
+            TP_QT_WARNING() << this << "trying to finish with success, but already"
                 " succeeded";
         }
         return;
@@ -144,6 +170,7 @@ void PendingOperation::setFinished()
     mPriv->finished = true;
     Q_ASSERT(isValid());
     QTimer::singleShot(0, this, SLOT(emitFinished()));
+    mPriv->finishCompletion();
 }
 
 /**
@@ -158,18 +185,18 @@ void PendingOperation::setFinishedWithError(const QString &name,
 {
     if (mPriv->finished) {
         if (mPriv->errorName.isEmpty()) {
-            warning() << this << "trying to fail with" << name <<
+            TP_QT_WARNING() << this << "trying to fail with" << name <<
                 "but already failed with" << errorName() << ":" <<
                 errorMessage();
         } else {
-            warning() << this << "trying to fail with" << name <<
+            TP_QT_WARNING() << this << "trying to fail with" << name <<
                 "but already succeeded";
         }
         return;
     }
 
     if (name.isEmpty()) {
-        warning() << this << "should be given a non-empty error name";
+        TP_QT_WARNING() << this << "should be given a non-empty error name";
         mPriv->errorName = QLatin1String("org.freedesktop.Telepathy.Qt.ErrorHandlingError");
     } else {
         mPriv->errorName = name;
@@ -179,6 +206,7 @@ void PendingOperation::setFinishedWithError(const QString &name,
     mPriv->finished = true;
     Q_ASSERT(isError());
     QTimer::singleShot(0, this, SLOT(emitFinished()));
+    mPriv->finishCompletion();
 }
 
 /**
@@ -266,6 +294,31 @@ QString PendingOperation::errorMessage() const
     return mPriv->errorMessage;
 }
 
+/**
+ * Return a CompletionHandle that finishes together with this operation.
+ *
+ * Unlike the finished() signal, which is emitted the next time the event loop
+ * runs, the continuations of the returned handle are invoked synchronously
+ * from setFinished() or setFinishedWithError(). This allows internal code to
+ * chain further work on this operation without waiting for the event loop.
+ *
+ * Note that the operation itself is still deleted after finished() is
+ * emitted, so continuations must not store pointers to it.
+ *
+ * \return A CompletionHandle tracking this operation.
+ * \sa PendingCompletion
+ */
+CompletionHandle PendingOperation::completion() const
+{
+    if (!mPriv->completion) {
+        mPriv->completion = new CompletionHandle;
+        if (mPriv->finished) {
+            mPriv->finishCompletion();
+        }
+    }
+    return *mPriv->completion;
+}
+
 /**
  * \fn void PendingOperation::finished(Tp::PendingOperation* operation)
  *
@@ -333,22 +386,49 @@ void PendingVoid::watcherFinished(QDBusPendingCallWatcher *watcher)
 
 struct TP_QT_NO_EXPORT PendingComposite::Private
 {
-    Private(bool failOnFirstError, uint nOperations)
-        : failOnFirstError(failOnFirstError),
-          error(false),
-          nOperations(nOperations),
-          nOperationsFinished(0)
+    struct Continuation
     {
-    }
+        Continuation(PendingComposite *parent)
+            : parent(parent)
+        {
+        }
 
-    bool failOnFirstError;
-    bool error;
-    QString errorName;
-    QString errorMessage;
-    uint nOperations;
-    uint nOperationsFinished;
+        void operator()(const CompletionHandle &handle) const
+        {
+            if (!parent) {
+                return;
+            }
+
+            if (handle.isError()) {
+                parent->setFinishedWithError(handle.errorName(), handle.errorMessage());
+            } else {
+                parent->setFinished();
+            }
+        }
+
+        QPointer<PendingComposite> parent;
+    };
+
+    Private(const QList<PendingOperation*> &operations, bool failOnFirstError);
+
+    // finishes together with the last of the tracked operations
+    CompletionHandle handle;
 };
 
+PendingComposite::Private::Private(const QList<PendingOperation*> &operations,
+        bool failOnFirstError)
+{
+    // Track the operations through their completion handles, so that the composite
+    // finishes as soon as the last operation does, without waiting for each of
+    // their finished() signals to go through the event loop.
+    QList<CompletionHandle> handles;
+    foreach (PendingOperation *operation, operations) {
+        handles.append(operation->completion());
+    }
+
+    handle = CompletionHandle::all(handles, failOnFirstError);
+}
+
 /**
  * \class PendingComposite
  * \ingroup utils
@@ -356,30 +436,25 @@ struct TP_QT_NO_EXPORT PendingComposite::Private
  *
  * \brief The PendingComposite class is a PendingOperation that can be used
  * to track multiple pending operations at once.
+ *
+ * A PendingComposite constructed with an empty list of operations has nothing
+ * to wait for, and finishes successfully straight away.
  */
 
 PendingComposite::PendingComposite(const QList<PendingOperation*> &operations,
          const SharedPtr<RefCounted> &object)
     : PendingOperation(object),
-      mPriv(new Private(true, operations.size()))
+      mPriv(new Private(operations, true))
 {
-    foreach (PendingOperation *operation, operations) {
-        connect(operation,
-                SIGNAL(finished(Tp::PendingOperation*)),
-                SLOT(onOperationFinished(Tp::PendingOperation*)));
-    }
+    mPriv->handle.then(Private::Continuation(this));
 }
 
 PendingComposite::PendingComposite(const QList<PendingOperation*> &operations,
          bool failOnFirstError, const SharedPtr<RefCounted> &object)
     : PendingOperation(object),
-      mPriv(new Private(failOnFirstError, operations.size()))
+      mPriv(new Private(operations, failOnFirstError))
 {
-    foreach (PendingOperation *operation, operations) {
-        connect(operation,
-                SIGNAL(finished(Tp::PendingOperation*)),
-                SLOT(onOperationFinished(Tp::PendingOperation*)));
-    }
+    mPriv->handle.then(Private::Continuation(this));
 }
 
 PendingComposite::~PendingComposite()
@@ -387,28 +462,78 @@ PendingComposite::~PendingComposite()
     delete mPriv;
 }
 
-void PendingComposite::onOperationFinished(Tp::PendingOperation *op)
+struct TP_QT_NO_EXPORT PendingCompletion::Private
 {
-    if (op->isError()) {
-        if (mPriv->failOnFirstError) {
-            setFinishedWithError(op->errorName(), op->errorMessage());
-            return;
-        } else if (!mPriv->error) {
-            /* only save the first error that will be used on setFinishedWithError when all
-             * pending operations finish */
-            mPriv->error = true;
-            mPriv->errorName = op->errorName();
-            mPriv->errorMessage = op->errorMessage();
+    struct Continuation
+    {
+        Continuation(PendingCompletion *parent)
+            : parent(parent)
+        {
         }
-    }
 
-    if (++mPriv->nOperationsFinished == mPriv->nOperations) {
-        if (!mPriv->error) {
-            setFinished();
-        } else {
-            setFinishedWithError(mPriv->errorName, mPriv->errorMessage);
+        void operator()(const CompletionHandle &handle) const
+        {
+            if (!parent) {
+                return;
+            }
+
+            if (handle.isError()) {
+                parent->setFinishedWithError(handle.errorName(), handle.errorMessage());
+            } else {
+                parent->setFinished();
+            }
         }
+
+        QPointer<PendingCompletion> parent;
+    };
+
+    Private(const CompletionHandle &handle)
+        : handle(handle)
+    {
     }
+
+    CompletionHandle handle;
+};
+
+/**
+ * \class PendingCompletion
+ * \ingroup utils
+ * \headerfile TelepathyQt/simple-pending-operations.h <TelepathyQt/PendingCompletion>
+ *
+ * \brief The PendingCompletion class is a PendingOperation that finishes
+ * when a CompletionHandle finishes.
+ *
+ * This allows code built on CompletionHandle to be exposed through the public
+ * PendingOperation based API.
+ */
+
+/**
+ * Construct a new PendingCompletion object.
+ *
+ * \param handle The handle to wrap.
+ * \param object The object on which this pending operation takes place.
+ */
+PendingCompletion::PendingCompletion(const CompletionHandle &handle,
+        const SharedPtr<RefCounted> &object)
+    : PendingOperation(object),
+      mPriv(new Private(handle))
+{
+    handle.then(Private::Continuation(this));
+}
+
+PendingCompletion::~PendingCompletion()
+{
+    delete mPriv;
+}
+
+/**
+ * Return the CompletionHandle wrapped by this operation.
+ *
+ * \return The wrapped handle.
+ */
+CompletionHandle PendingCompletion::handle() const
+{
+    return mPriv->handle;
 }
 
 } // Tp
@@ -40,6 +40,7 @@ class QDBusPendingCallWatcher;
 namespace Tp
 {
 
+class CompletionHandle;
 class ReadinessHelper;
 
 class TP_QT_EXPORT PendingOperation : public QObject
@@ -58,6 +59,8 @@ public:
     QString errorName() const;
     QString errorMessage() const;
 
+    CompletionHandle completion() const;
+
 Q_SIGNALS:
     void finished(Tp::PendingOperation *operation);
 
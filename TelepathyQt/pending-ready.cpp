@@ -139,7 +139,7 @@ void PendingReady::onNestedFinished(Tp::PendingOperation *nested)
     if (nested->isValid()) {
         setFinished();
     } else {
-        warning() << "Nested PendingReady for" << object() << "failed with"
+        TP_QT_WARNING() << "Nested PendingReady for" << object() << "failed with"
             << nested->errorName() << ":" << nested->errorMessage();
         setFinishedWithError(nested->errorName(), nested->errorMessage());
     }
@@ -85,11 +85,11 @@ void PendingStringList::watcherFinished(QDBusPendingCallWatcher* watcher)
     QDBusPendingReply<QStringList> reply = *watcher;
 
     if (!reply.isError()) {
-        debug() << "Got reply to PendingStringList call";
+        TP_QT_DEBUG() << "Got reply to PendingStringList call";
         setResult(reply.value());
         setFinished();
     } else {
-        debug().nospace() << "PendingStringList call failed: " <<
+        TP_QT_DEBUG().nospace() << "PendingStringList call failed: " <<
             reply.error().name() << ": " << reply.error().message();
         setFinishedWithError(reply.error());
     }
@@ -86,11 +86,11 @@ void PendingString::watcherFinished(QDBusPendingCallWatcher* watcher)
     QDBusPendingReply<QString> reply = *watcher;
 
     if (!reply.isError()) {
-        debug() << "Got reply to PendingString call";
+        TP_QT_DEBUG() << "Got reply to PendingString call";
         setResult(reply.value());
         setFinished();
     } else {
-        debug().nospace() << "PendingString call failed: " <<
+        TP_QT_DEBUG().nospace() << "PendingString call failed: " <<
             reply.error().name() << ": " << reply.error().message();
         setFinishedWithError(reply.error());
     }
@@ -76,11 +76,11 @@ void PendingVariantMap::watcherFinished(QDBusPendingCallWatcher* watcher)
     QDBusPendingReply<QVariantMap> reply = *watcher;
 
     if (!reply.isError()) {
-        debug() << "Got reply to PendingVariantMap call";
+        TP_QT_DEBUG() << "Got reply to PendingVariantMap call";
         mPriv->result = reply.value();
         setFinished();
     } else {
-        debug().nospace() << "PendingVariantMap call failed: " <<
+        TP_QT_DEBUG().nospace() << "PendingVariantMap call failed: " <<
             reply.error().name() << ": " << reply.error().message();
         setFinishedWithError(reply.error());
     }
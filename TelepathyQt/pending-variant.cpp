@@ -76,11 +76,11 @@ void PendingVariant::watcherFinished(QDBusPendingCallWatcher* watcher)
     QDBusPendingReply<QDBusVariant> reply = *watcher;
 
     if (!reply.isError()) {
-        debug() << "Got reply to PendingVariant call";
+        TP_QT_DEBUG() << "Got reply to PendingVariant call";
         mPriv->result = reply.value().variant();
         setFinished();
     } else {
-        debug().nospace() << "PendingVariant call failed: " <<
+        TP_QT_DEBUG().nospace() << "PendingVariant call failed: " <<
             reply.error().name() << ": " << reply.error().message();
         setFinishedWithError(reply.error());
     }
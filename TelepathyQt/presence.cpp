@@ -423,7 +423,7 @@ Presence PresenceSpec::presence(const QString &statusMessage) const
     }
 
     if (!canHaveStatusMessage() && !statusMessage.isEmpty()) {
-        warning() << "Passing a status message to PresenceSpec with "
+        TP_QT_WARNING() << "Passing a status message to PresenceSpec with "
             "canHaveStatusMessage() being false";
     }
 
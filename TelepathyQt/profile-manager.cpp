@@ -32,59 +32,87 @@
 #include <TelepathyQt/Profile>
 #include <TelepathyQt/ReadinessHelper>
 
+#include <QDateTime>
+#include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QString>
 #include <QStringList>
+#include <QThread>
 
 namespace Tp
 {
 
-struct TP_QT_NO_EXPORT ProfileManager::Private
+namespace
 {
-    Private(ProfileManager *parent, const QDBusConnection &bus);
 
-    static void introspectMain(Private *self);
-    static void introspectFakeProfiles(Private *self);
+// Parsed profiles, keyed by absolute file name and shared by every
+// ProfileManager in the process, so that a profile is only parsed again if it
+// changed on disk
+struct CachedProfile
+{
+    CachedProfile() : size(0) {}
 
-    ProfileManager *parent;
-    ReadinessHelper *readinessHelper;
-    QDBusConnection bus;
-    QHash<QString, ProfilePtr> profiles;
-    QList<ConnectionManagerPtr> cms;
+    QDateTime lastModified;
+    qint64 size;
+    ProfilePtr profile;
 };
 
-ProfileManager::Private::Private(ProfileManager *parent, const QDBusConnection &bus)
-    : parent(parent),
-      readinessHelper(parent->readinessHelper()),
-      bus(bus)
-{
-    ReadinessHelper::Introspectables introspectables;
+QMutex profileCacheLock;
+QHash<QString, CachedProfile> profileCache;
 
-    ReadinessHelper::Introspectable introspectableCore(
-        QSet<uint>() << 0,                                           // makesSenseForStatuses
-        Features(),                                                  // dependsOnFeatures
-        QStringList(),                                               // dependsOnInterfaces
-        (ReadinessHelper::IntrospectFunc) &Private::introspectMain,
-        this);
-    introspectables[FeatureCore] = introspectableCore;
+ProfilePtr cachedProfileForFileInfo(const QFileInfo &fi)
+{
+    QString fileName = fi.absoluteFilePath();
+    QDateTime lastModified = fi.lastModified();
+    qint64 size = fi.size();
+
+    QMutexLocker locker(&profileCacheLock);
+    QHash<QString, CachedProfile>::const_iterator i = profileCache.constFind(fileName);
+    if (i != profileCache.constEnd() && i->lastModified == lastModified && i->size == size) {
+        return i->profile;
+    }
+    locker.unlock();
 
-    ReadinessHelper::Introspectable introspectableFakeProfiles(
-        QSet<uint>() << 0,                                           // makesSenseForStatuses
-        Features() << FeatureCore,                                   // dependsOnFeatures
-        QStringList(),                                               // dependsOnInterfaces
-        (ReadinessHelper::IntrospectFunc) &Private::introspectFakeProfiles,
-        this);
-    introspectables[FeatureFakeProfiles] = introspectableFakeProfiles;
+    CachedProfile entry;
+    entry.lastModified = lastModified;
+    entry.size = size;
+    entry.profile = Profile::createForFileName(fileName);
 
-    readinessHelper->addIntrospectables(introspectables);
+    locker.relock();
+    profileCache.insert(fileName, entry);
+    return entry.profile;
 }
 
-void ProfileManager::Private::introspectMain(ProfileManager::Private *self)
+// Scans the profile directories and parses the profiles off the main thread.
+// Profile objects are immutable once parsed, so they can be handed over to the
+// thread owning the ProfileManager as is.
+class ProfileLoader : public QThread
 {
-    QStringList searchDirs = Profile::searchDirs();
+public:
+    ProfileLoader(const QStringList &searchDirs)
+        : mSearchDirs(searchDirs)
+    {
+    }
+
+    QHash<QString, ProfilePtr> profiles() const
+    {
+        return mProfiles;
+    }
+
+protected:
+    void run() override;
 
-    foreach (const QString searchDir, searchDirs) {
+private:
+    QStringList mSearchDirs;
+    QHash<QString, ProfilePtr> mProfiles;
+};
+
+void ProfileLoader::run()
+{
+    foreach (const QString searchDir, mSearchDirs) {
         QDir dir(searchDir);
         dir.setFilter(QDir::Files);
 
@@ -99,30 +127,86 @@ void ProfileManager::Private::introspectMain(ProfileManager::Private *self)
             QString fileName = fi.absoluteFilePath();
             QString serviceName = fi.baseName();
 
-            if (self->profiles.contains(serviceName)) {
-                debug() << "Profile for service" << serviceName << "already "
+            if (mProfiles.contains(serviceName)) {
+                TP_QT_DEBUG() << "Profile for service" << serviceName << "already "
                     "exists. Ignoring profile file:" << fileName;
                 continue;
             }
 
-            ProfilePtr profile = Profile::createForFileName(fileName);
+            ProfilePtr profile = cachedProfileForFileInfo(fi);
             if (!profile->isValid()) {
                 continue;
             }
 
             if (profile->type() != QLatin1String("IM")) {
-                debug() << "Ignoring profile for service" << serviceName <<
+                TP_QT_DEBUG() << "Ignoring profile for service" << serviceName <<
                     ": type != IM. Profile file:" << fileName;
                 continue;
             }
 
-            debug() << "Found profile for service" << serviceName <<
+            TP_QT_DEBUG() << "Found profile for service" << serviceName <<
                 "- profile file:" << fileName;
-            self->profiles.insert(serviceName, profile);
+            mProfiles.insert(serviceName, profile);
         }
     }
+}
+
+}
 
-    self->readinessHelper->setIntrospectCompleted(FeatureCore, true);
+struct TP_QT_NO_EXPORT ProfileManager::Private
+{
+    Private(ProfileManager *parent, const QDBusConnection &bus);
+
+    static void introspectMain(Private *self);
+    static void introspectFakeProfiles(Private *self);
+
+    ProfileManager *parent;
+    ReadinessHelper *readinessHelper;
+    QDBusConnection bus;
+    QHash<QString, ProfilePtr> profiles;
+    QList<ConnectionManagerPtr> cms;
+    ProfileLoader *loader;
+};
+
+ProfileManager::Private::Private(ProfileManager *parent, const QDBusConnection &bus)
+    : parent(parent),
+      readinessHelper(parent->readinessHelper()),
+      bus(bus),
+      loader(nullptr)
+{
+    ReadinessHelper::Introspectables introspectables;
+
+    ReadinessHelper::Introspectable introspectableCore(
+        QSet<uint>() << 0,                                           // makesSenseForStatuses
+        Features(),                                                  // dependsOnFeatures
+        QStringList(),                                               // dependsOnInterfaces
+        (ReadinessHelper::IntrospectFunc) &Private::introspectMain,
+        this);
+    introspectables[FeatureCore] = introspectableCore;
+
+    ReadinessHelper::Introspectable introspectableFakeProfiles(
+        QSet<uint>() << 0,                                           // makesSenseForStatuses
+        Features() << FeatureCore,                                   // dependsOnFeatures
+        QStringList(),                                               // dependsOnInterfaces
+        (ReadinessHelper::IntrospectFunc) &Private::introspectFakeProfiles,
+        this);
+    introspectables[FeatureFakeProfiles] = introspectableFakeProfiles;
+
+    readinessHelper->addIntrospectables(introspectables);
+}
+
+void ProfileManager::Private::introspectMain(ProfileManager::Private *self)
+{
+    // The loader is not parented to the manager, as it must not be deleted while
+    // running; it deletes itself once done, even if the manager is already gone
+    self->loader = new ProfileLoader(Profile::searchDirs());
+    self->parent->connect(self->loader,
+            SIGNAL(finished()),
+            SLOT(onProfilesLoaded()));
+    self->loader->connect(self->loader,
+            SIGNAL(finished()),
+            SLOT(deleteLater()));
+    self->loader->start();
 }
 
 void ProfileManager::Private::introspectFakeProfiles(ProfileManager::Private *self)
@@ -260,10 +344,17 @@ ProfilePtr ProfileManager::profileForService(const QString &serviceName) const
     return mPriv->profiles.value(serviceName);
 }
 
+void ProfileManager::onProfilesLoaded()
+{
+    mPriv->profiles = mPriv->loader->profiles();
+    mPriv->loader = nullptr;
+    mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, true);
+}
+
 void ProfileManager::onCmNamesRetrieved(Tp::PendingOperation *op)
 {
     if (op->isError()) {
-        warning().nospace() << "Getting available CMs failed with " <<
+        TP_QT_WARNING().nospace() << "Getting available CMs failed with " <<
             op->errorName() << ":" << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureFakeProfiles, false,
                 op->errorName(), op->errorMessage());
@@ -293,7 +384,7 @@ void ProfileManager::onCmNamesRetrieved(Tp::PendingOperation *op)
 void ProfileManager::onCMsReady(Tp::PendingOperation *op)
 {
     if (op->isError()) {
-        warning() << "Failed introspecting all CMs, trying to create fake profiles anyway";
+        TP_QT_WARNING() << "Failed introspecting all CMs, trying to create fake profiles anyway";
     }
 
     ProfilePtr profile;
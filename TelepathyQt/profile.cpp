@@ -199,7 +199,7 @@ bool Profile::Private::XmlHandler::startElement(const QString &namespaceURI,
 
     if (namespaceURI != xmlNs) {
         // ignore all elements with unknown xmlns
-        debug() << "Ignoring unknown xmlns" << namespaceURI;
+        TP_QT_DEBUG() << "Ignoring unknown xmlns" << namespaceURI;
         return true;
     }
 
@@ -333,7 +333,7 @@ bool Profile::Private::XmlHandler::startElement(const QString &namespaceURI,
         mCurrentPropertyType = attributes.value(elemAttrType);
     } else {
         if (qName != elemName) {
-            Tp::warning() << "Ignoring unknown element" << qName;
+            TP_QT_WARNING() << "Ignoring unknown element" << qName;
         } else {
             // check if we are inside <service>
             CHECK_ELEMENT_IS_CHILD_OF(elemService);
@@ -357,7 +357,7 @@ bool Profile::Private::XmlHandler::endElement(const QString &namespaceURI,
 {
     if (namespaceURI != xmlNs) {
         // ignore all elements with unknown xmlns
-        debug() << "Ignoring unknown xmlns" << namespaceURI;
+        TP_QT_DEBUG() << "Ignoring unknown xmlns" << namespaceURI;
         return true;
     } else if (qName == elemName) {
         mData->name = mCurrentText;
@@ -437,30 +437,30 @@ void Profile::Private::setFileName(const QString &fileName)
     QFileInfo fi(fileName);
     serviceName = fi.baseName();
 
-    debug() << "Loading profile file" << fileName;
+    TP_QT_DEBUG() << "Loading profile file" << fileName;
 
     QFile file(fileName);
     if (!file.exists()) {
-        warning() << QString(QLatin1String("Error parsing profile file %1: file does not exist"))
+        TP_QT_WARNING() << QString(QLatin1String("Error parsing profile file %1: file does not exist"))
             .arg(file.fileName());
         return;
     }
 
     if (!file.open(QFile::ReadOnly)) {
-        warning() << QString(QLatin1String("Error parsing profile file %1: "
+        TP_QT_WARNING() << QString(QLatin1String("Error parsing profile file %1: "
                     "cannot open file for readonly access"))
             .arg(file.fileName());
         return;
     }
 
     if (parse(&file)) {
-        debug() << "Profile file" << fileName << "loaded successfully";
+        TP_QT_DEBUG() << "Profile file" << fileName << "loaded successfully";
     }
 }
 
 void Profile::Private::lookupProfile()
 {
-    debug() << "Searching profile for service" << serviceName;
+    TP_QT_DEBUG() << "Searching profile for service" << serviceName;
 
     QStringList searchDirs = Profile::searchDirs();
     bool found = false;
@@ -477,14 +477,14 @@ void Profile::Private::lookupProfile()
         }
 
         if (parse(&file)) {
-            debug() << "Profile for service" << serviceName << "found:" << fileName;
+            TP_QT_DEBUG() << "Profile for service" << serviceName << "found:" << fileName;
             found = true;
             break;
         }
     }
 
     if (!found) {
-        debug() << "Cannot find valid profile for service" << serviceName;
+        TP_QT_DEBUG() << "Cannot find valid profile for service" << serviceName;
     }
 }
 
@@ -502,7 +502,7 @@ bool Profile::Private::parse(QFile *file)
 
     QXmlInputSource xmlInputSource(file);
     if (!xmlReader.parse(xmlInputSource)) {
-        warning() << QString(QLatin1String("Error parsing profile file %1: %2"))
+        TP_QT_WARNING() << QString(QLatin1String("Error parsing profile file %1: %2"))
             .arg(file->fileName())
             .arg(xmlHandler.errorString());
         invalidate();
@@ -55,7 +55,7 @@ struct TP_QT_NO_EXPORT ProtocolParameter::Private : public QSharedData
             if (spec.defaultValue.variant() == QVariant::Invalid) {
                 // flags contains HasDefault but no default value is passed,
                 // lets warn and build a default value from signature
-                warning() << "Building ProtocolParameter with flags containing ConnMgrParamFlagHasDefault"
+                TP_QT_WARNING() << "Building ProtocolParameter with flags containing ConnMgrParamFlagHasDefault"
                     " and no default value, generating a dummy one from signature";
                 spec.defaultValue = QDBusVariant(
                         parseValueWithDBusSignature(QString(), spec.signature));
@@ -64,7 +64,7 @@ struct TP_QT_NO_EXPORT ProtocolParameter::Private : public QSharedData
             if (spec.defaultValue.variant() != QVariant::Invalid) {
                 // flags does not contain HasDefault but a default value is passed,
                 // lets add HasDefault to flags
-                debug() << "Building ProtocolParameter with flags not containing ConnMgrParamFlagHasDefault"
+                TP_QT_DEBUG() << "Building ProtocolParameter with flags not containing ConnMgrParamFlagHasDefault"
                     " and a default value, updating flags to contain ConnMgrParamFlagHasDefault";
                 spec.flags |= ConnMgrParamFlagHasDefault;
             }
@@ -210,7 +210,7 @@ void ReadinessHelper::Private::setCurrentStatus(uint newStatus)
             emit parent->statusReady(currentStatus);
         }
     } else {
-        debug() << "status changed while introspection process was running";
+        TP_QT_DEBUG() << "status changed while introspection process was running";
         pendingStatusChange = true;
         pendingStatus = newStatus;
     }
@@ -219,10 +219,10 @@ void ReadinessHelper::Private::setCurrentStatus(uint newStatus)
 void ReadinessHelper::Private::setIntrospectCompleted(const Feature &feature,
         bool success, const QString &errorName, const QString &errorMessage)
 {
-    debug() << "ReadinessHelper::setIntrospectCompleted: feature:" << feature <<
+    TP_QT_DEBUG() << "ReadinessHelper::setIntrospectCompleted: feature:" << feature <<
         "- success:" << success;
     if (pendingStatusChange) {
-        debug() << "ReadinessHelper::setIntrospectCompleted called while there is "
+        TP_QT_DEBUG() << "ReadinessHelper::setIntrospectCompleted called while there is "
             "a pending status change - ignoring";
 
         inFlightFeatures.remove(feature);
@@ -247,7 +247,7 @@ void ReadinessHelper::Private::setIntrospectCompleted(const Feature &feature,
         missingFeaturesErrors.insert(feature,
                 QPair<QString, QString>(errorName, errorMessage));
         if (errorName.isEmpty()) {
-            warning() << "ReadinessHelper::setIntrospectCompleted: Feature" <<
+            TP_QT_WARNING() << "ReadinessHelper::setIntrospectCompleted: Feature" <<
                 feature << "introspection failed but no error message was given";
         }
     }
@@ -261,7 +261,7 @@ void ReadinessHelper::Private::setIntrospectCompleted(const Feature &feature,
 void ReadinessHelper::Private::iterateIntrospection()
 {
     if (proxy && !proxy->isValid()) {
-        debug() << "ReadinessHelper: not iterating as the proxy is invalidated";
+        TP_QT_DEBUG() << "ReadinessHelper: not iterating as the proxy is invalidated";
         return;
     }
 
@@ -276,7 +276,7 @@ void ReadinessHelper::Private::iterateIntrospection()
     //
     //  So we can safely skip the rest of this function here.
     if (pendingStatusChange) {
-        debug() << "ReadinessHelper: not iterating as a status change is pending";
+        TP_QT_DEBUG() << "ReadinessHelper: not iterating as a status change is pending";
         return;
     }
 
@@ -359,7 +359,7 @@ void ReadinessHelper::Private::iterateIntrospection()
             if (!interfaces.contains(interface)) {
                 // If a feature is ready to introspect and depends on a interface
                 // that is not present the feature can't possibly be satisfied
-                debug() << "feature" << feature << "depends on interfaces" <<
+                TP_QT_DEBUG() << "feature" << feature << "depends on interfaces" <<
                     introspectable.mPriv->dependsOnInterfaces << ", but interface" << interface <<
                     "is not present";
                 setIntrospectCompleted(feature, false,
@@ -446,7 +446,7 @@ void ReadinessHelper::addIntrospectables(const Introspectables &introspectables)
             i != introspectables.constEnd(); ++i) {
         Feature feature = i.key();
         if (mPriv->introspectables.contains(feature)) {
-            warning() << "ReadinessHelper::addIntrospectables: trying to add an "
+            TP_QT_WARNING() << "ReadinessHelper::addIntrospectables: trying to add an "
                 "introspectable for feature" << feature << "but introspectable "
                 "for this feature already exists";
         } else {
@@ -457,8 +457,8 @@ void ReadinessHelper::addIntrospectables(const Introspectables &introspectables)
         }
     }
 
-    debug() << "ReadinessHelper: new supportedStatuses =" << mPriv->supportedStatuses;
-    debug() << "ReadinessHelper: new supportedFeatures =" << mPriv->supportedFeatures;
+    TP_QT_DEBUG() << "ReadinessHelper: new supportedStatuses =" << mPriv->supportedStatuses;
+    TP_QT_DEBUG() << "ReadinessHelper: new supportedFeatures =" << mPriv->supportedFeatures;
 }
 
 uint ReadinessHelper::currentStatus() const
@@ -606,7 +606,7 @@ PendingReady *ReadinessHelper::becomeReady(const Features &requestedFeatures)
 
     Features supportedFeatures = mPriv->supportedFeatures;
     if (supportedFeatures.intersect(requestedFeatures) != requestedFeatures) {
-        warning() << "ReadinessHelper::becomeReady called with invalid features: requestedFeatures =" <<
+        TP_QT_WARNING() << "ReadinessHelper::becomeReady called with invalid features: requestedFeatures =" <<
             requestedFeatures << "- supportedFeatures =" << mPriv->supportedFeatures;
         PendingReady *operation = new PendingReady(SharedPtr<RefCounted>(mPriv->object),
                 requestedFeatures);
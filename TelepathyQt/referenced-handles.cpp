@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryContacts
+
 #include <TelepathyQt/ReferencedHandles>
 
 #include "TelepathyQt/debug-internal.h"
@@ -63,7 +65,7 @@ struct TP_QT_NO_EXPORT ReferencedHandles::Private : public QSharedData
         if (!handles.isEmpty()) {
             ConnectionPtr conn(connection);
             if (!conn) {
-                debug() << "  Destroyed after Connection, so the Connection "
+                TP_QT_DEBUG() << "  Destroyed after Connection, so the Connection "
                     "has already released the handles";
                 return;
             }
@@ -79,7 +81,7 @@ struct TP_QT_NO_EXPORT ReferencedHandles::Private : public QSharedData
         if (!handles.isEmpty()) {
             ConnectionPtr conn(connection);
             if (!conn) {
-                debug() << "  Destroyed after Connection, so the Connection "
+                TP_QT_DEBUG() << "  Destroyed after Connection, so the Connection "
                     "has already released the handles";
                 return;
             }
@@ -202,7 +204,7 @@ void ReferencedHandles::clear()
                 conn->unrefHandle(handleType(), handle);
             }
         } else {
-            warning() << "Connection already destroyed in "
+            TP_QT_WARNING() << "Connection already destroyed in "
                 "ReferencedHandles::clear() so can't unref!";
         }
     }
@@ -226,7 +228,7 @@ int ReferencedHandles::removeAll(uint handle)
                 conn->unrefHandle(handleType(), handle);
             }
         } else {
-            warning() << "Connection already destroyed in "
+            TP_QT_WARNING() << "Connection already destroyed in "
                 "ReferencedHandles::removeAll() with handle ==" <<
                 handle << "so can't unref!";
         }
@@ -241,7 +243,7 @@ void ReferencedHandles::removeAt(int i)
     if (conn) {
         conn->unrefHandle(handleType(), at(i));
     } else {
-        warning() << "Connection already destroyed in "
+        TP_QT_WARNING() << "Connection already destroyed in "
             "ReferencedHandles::removeAt() with i ==" <<
             i << "so can't unref!";
     }
@@ -258,7 +260,7 @@ bool ReferencedHandles::removeOne(uint handle)
         if (conn) {
             conn->unrefHandle(handleType(), handle);
         } else {
-            warning() << "Connection already destroyed in "
+            TP_QT_WARNING() << "Connection already destroyed in "
                 "ReferencedHandles::removeOne() with handle ==" <<
                 handle << "so can't unref!";
         }
@@ -282,7 +284,7 @@ uint ReferencedHandles::takeAt(int i)
     if (conn) {
         conn->unrefHandle(handleType(), at(i));
     } else {
-        warning() << "Connection already destroyed in "
+        TP_QT_WARNING() << "Connection already destroyed in "
             "ReferencedHandles::takeAt() with i ==" <<
             i << "so can't unref!";
     }
@@ -294,7 +296,7 @@ ReferencedHandles ReferencedHandles::operator+(const ReferencedHandles &another)
 {
     if (connection() != another.connection() ||
         handleType() != another.handleType()) {
-        warning() << "Tried to concatenate ReferencedHandles instances "
+        TP_QT_WARNING() << "Tried to concatenate ReferencedHandles instances "
             "with different connection and/or handle type";
         return *this;
     }
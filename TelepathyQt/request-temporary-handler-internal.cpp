@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include "TelepathyQt/request-temporary-handler-internal.h"
 
 #include "TelepathyQt/_gen/request-temporary-handler-internal.moc.hpp"
@@ -76,7 +78,7 @@ void RequestTemporaryHandler::handleChannels(
     }
 
     if (!errorMessage.isEmpty()) {
-        warning() << "Handling channel failed with" << TP_QT_ERROR_SERVICE_CONFUSED << ":" <<
+        TP_QT_WARNING() << "Handling channel failed with" << TP_QT_ERROR_SERVICE_CONFUSED << ":" <<
             errorMessage;
 
         // Only emit error if we didn't receive any channel yet.
@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/ServerAuthenticationChannel>
 
 #include "TelepathyQt/_gen/server-authentication-channel.moc.hpp"
@@ -165,7 +167,7 @@ ServerAuthenticationChannel::~ServerAuthenticationChannel()
 bool ServerAuthenticationChannel::hasCaptchaInterface() const
 {
     if (!isReady(ServerAuthenticationChannel::FeatureCore)) {
-        warning() << "ServerAuthenticationChannel::hasCaptchaInterface() used with FeatureCore not ready";
+        TP_QT_WARNING() << "ServerAuthenticationChannel::hasCaptchaInterface() used with FeatureCore not ready";
         return false;
     }
 
@@ -183,7 +185,7 @@ bool ServerAuthenticationChannel::hasCaptchaInterface() const
 bool ServerAuthenticationChannel::hasSaslInterface() const
 {
     if (!isReady(ServerAuthenticationChannel::FeatureCore)) {
-        warning() << "ServerAuthenticationChannel::hasSaslInterface() used with FeatureCore not ready";
+        TP_QT_WARNING() << "ServerAuthenticationChannel::hasSaslInterface() used with FeatureCore not ready";
         return false;
     }
 
@@ -207,7 +209,7 @@ bool ServerAuthenticationChannel::hasSaslInterface() const
 CaptchaAuthenticationPtr ServerAuthenticationChannel::captchaAuthentication() const
 {
     if (!isReady(ServerAuthenticationChannel::FeatureCore)) {
-        warning() << "ServerAuthenticationChannel::captchaAuthentication() used with FeatureCore not ready";
+        TP_QT_WARNING() << "ServerAuthenticationChannel::captchaAuthentication() used with FeatureCore not ready";
         return CaptchaAuthenticationPtr();
     }
 
@@ -221,10 +223,10 @@ void ServerAuthenticationChannel::gotCaptchaAuthenticationProperties(Tp::Pending
 
         mPriv->captchaAuthentication->mPriv->extractCaptchaAuthenticationProperties(pvm->result());
 
-        debug() << "Got reply to Properties::GetAll(CaptchaAuthentication)";
+        TP_QT_DEBUG() << "Got reply to Properties::GetAll(CaptchaAuthentication)";
         mPriv->readinessHelper->setIntrospectCompleted(ServerAuthenticationChannel::FeatureCore, true);
     } else {
-        warning().nospace() << "Properties::GetAll(CaptchaAuthentication) failed "
+        TP_QT_WARNING().nospace() << "Properties::GetAll(CaptchaAuthentication) failed "
             "with " << op->errorName() << ": " << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(ServerAuthenticationChannel::FeatureCore, false,
                 op->errorName(), op->errorMessage());
@@ -236,7 +238,7 @@ void ServerAuthenticationChannel::gotServerAuthenticationProperties(Tp::PendingO
     if (!op->isError()) {
         PendingVariantMap *pvm = qobject_cast<PendingVariantMap *>(op);
 
-        debug() << "Got reply to Properties::GetAll(ServerAuthentication)";
+        TP_QT_DEBUG() << "Got reply to Properties::GetAll(ServerAuthentication)";
         mPriv->authMethod = qdbus_cast<QString>(pvm->result()[QLatin1String("AuthenticationMethod")]);
 
         if (mPriv->authMethod == TP_QT_IFACE_CHANNEL_INTERFACE_CAPTCHA_AUTHENTICATION) {
@@ -262,7 +264,7 @@ void ServerAuthenticationChannel::gotServerAuthenticationProperties(Tp::PendingO
             mPriv->readinessHelper->setIntrospectCompleted(ServerAuthenticationChannel::FeatureCore, true);
         }
     } else {
-        warning().nospace() << "Properties::GetAll(ServerAuthentication) failed "
+        TP_QT_WARNING().nospace() << "Properties::GetAll(ServerAuthentication) failed "
             "with " << op->errorName() << ": " << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(ServerAuthenticationChannel::FeatureCore, false,
                 op->errorName(), op->errorMessage());
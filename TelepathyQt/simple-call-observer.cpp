@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/SimpleCallObserver>
 
 #include "TelepathyQt/_gen/simple-call-observer.moc.hpp"
@@ -65,7 +67,7 @@ SimpleCallObserver::Private::Private(SimpleCallObserver *parent,
       contactIdentifier(contactIdentifier),
       direction(direction)
 {
-    debug() << "Creating a new SimpleCallObserver";
+    TP_QT_DEBUG() << "Creating a new SimpleCallObserver";
     ChannelClassSpec channelFilterSMC = ChannelClassSpec::streamedMediaCall();
     ChannelClassSpec channelFilterCall = ChannelClassSpec::mediaCall();
     if (direction == CallDirectionIncoming) {
@@ -262,7 +264,7 @@ void SimpleCallObserver::onNewChannels(const QList<ChannelPtr> &channels)
         if (channel->channelType() == TP_QT_IFACE_CHANNEL_TYPE_CALL) {
             CallChannelPtr callChannel = CallChannelPtr::qObjectCast(channel);
             if (!callChannel) {
-                warning() << "Channel received to observe is not a subclass of "
+                TP_QT_WARNING() << "Channel received to observe is not a subclass of "
                     "CallChannel. ChannelFactory set on this observer's account must "
                     "construct CallChannel subclasses for channels of type Call. "
                     "Ignoring channel";
@@ -273,7 +275,7 @@ void SimpleCallObserver::onNewChannels(const QList<ChannelPtr> &channels)
         } else if (channel->channelType() == TP_QT_IFACE_CHANNEL_TYPE_STREAMED_MEDIA) {
             StreamedMediaChannelPtr smChannel = StreamedMediaChannelPtr::qObjectCast(channel);
             if (!smChannel) {
-                warning() << "Channel received to observe is not a subclass of "
+                TP_QT_WARNING() << "Channel received to observe is not a subclass of "
                     "StreamedMediaChannel. ChannelFactory set on this observer's account must "
                     "construct StreamedMediaChannel subclasses for channels of type StreamedMedia. "
                     "Ignoring channel";
@@ -282,7 +284,7 @@ void SimpleCallObserver::onNewChannels(const QList<ChannelPtr> &channels)
 
             emit streamedMediaCallStarted(smChannel);
         } else {
-            warning() << "Channel received to observe is not of type Call or StreamedMedia, "
+            TP_QT_WARNING() << "Channel received to observe is not of type Call or StreamedMedia, "
                     "service confused. Ignoring channel";
             continue;
         }
@@ -295,7 +297,7 @@ void SimpleCallObserver::onChannelInvalidated(const ChannelPtr &channel,
     if (channel->channelType() == TP_QT_IFACE_CHANNEL_TYPE_CALL) {
         CallChannelPtr callChannel = CallChannelPtr::qObjectCast(channel);
         if (!callChannel) {
-            warning() << "Channel received to observe is not a subclass of "
+            TP_QT_WARNING() << "Channel received to observe is not a subclass of "
                 "CallChannel. ChannelFactory set on this observer's account must "
                 "construct CallChannel subclasses for channels of type Call. "
                 "Ignoring channel";
@@ -306,7 +308,7 @@ void SimpleCallObserver::onChannelInvalidated(const ChannelPtr &channel,
     } else if (channel->channelType() == TP_QT_IFACE_CHANNEL_TYPE_STREAMED_MEDIA) {
         StreamedMediaChannelPtr smChannel = StreamedMediaChannelPtr::qObjectCast(channel);
         if (!smChannel) {
-            warning() << "Channel received to observe is not a subclass of "
+            TP_QT_WARNING() << "Channel received to observe is not a subclass of "
                 "StreamedMediaChannel. ChannelFactory set on this observer's account must "
                 "construct StreamedMediaChannel subclasses for channels of type StreamedMedia. "
                 "Ignoring channel";
@@ -315,7 +317,7 @@ void SimpleCallObserver::onChannelInvalidated(const ChannelPtr &channel,
 
         emit streamedMediaCallEnded(smChannel, errorName, errorMessage);
     } else {
-        warning() << "Channel received to observe is not of type Call or StreamedMedia, "
+        TP_QT_WARNING() << "Channel received to observe is not of type Call or StreamedMedia, "
                 "service confused. Ignoring channel";
     }
 }
@@ -40,6 +40,12 @@ struct TP_QT_NO_EXPORT SimpleObserver::Private
             const QString &contactIdentifier,
             bool requiresNormalization,
             const QList<ChannelClassFeatures> &extraChannelFeatures);
+    ~Private();
+
+    bool isSubscriberResolved() const;
+    void notifyNewChannels(const AccountPtr &channelsAccount, const QList<ChannelPtr> &channels);
+    void notifyChannelInvalidated(const AccountPtr &channelAccount, const ChannelPtr &channel,
+            const QString &errorName, const QString &errorMessage);
 
     bool filterChannel(const AccountPtr &channelAccount, const ChannelPtr &channel);
     void insertChannels(const AccountPtr &channelsAccount, const QList<ChannelPtr> &channels);
@@ -164,6 +170,9 @@ public:
 
     QHash<ChannelPtr, ChannelWrapper*> channels() const { return mChannels; }
 
+    void addSubscriber(SimpleObserver::Private *subscriber);
+    void removeSubscriber(SimpleObserver::Private *subscriber);
+
     void observeChannels(
             const MethodInvocationContextPtr<> &context,
             const AccountPtr &account,
@@ -173,18 +182,22 @@ public:
             const QList<ChannelRequestPtr> &requestsSatisfied,
             const ObserverInfo &observerInfo) override;
 
-Q_SIGNALS:
-    void newChannels(const Tp::AccountPtr &channelsAccount, const QList<Tp::ChannelPtr> &channels);
-    void channelInvalidated(const Tp::AccountPtr &channelAccount, const Tp::ChannelPtr &channel,
-            const QString &errorName, const QString &errorMessage);
-
 private Q_SLOTS:
     void onChannelInvalidated(const Tp::AccountPtr &channelAccount, const Tp::ChannelPtr &channel,
             const QString &errorName, const QString &errorMessage);
     void onChannelsReady(Tp::PendingOperation *op);
 
 private:
+    // Subscribers are indexed by account and normalized target ID, with an
+    // empty ID for the ones interested in all channels of their account
+    typedef QPair<AccountPtr, QString> SubscriberKey;
+
+    static SubscriberKey subscriberKey(const SimpleObserver::Private *subscriber);
+
     Features featuresFor(const ChannelClassSpec &channelClass) const;
+    void notifyNewChannels(const AccountPtr &channelsAccount, const QList<ChannelPtr> &channels);
+    void notifyChannelInvalidated(const AccountPtr &channelAccount, const ChannelPtr &channel,
+            const QString &errorName, const QString &errorMessage);
 
     WeakPtr<ClientRegistrar> mCr;
     SharedPtr<FakeAccountFactory> mFakeAccountFactory;
@@ -194,6 +207,11 @@ private:
     QHash<ChannelPtr, ChannelWrapper*> mChannels;
     QHash<ChannelPtr, ChannelWrapper*> mIncompleteChannels;
     QHash<PendingOperation*, ContextInfo*> mObserveChannelsInfo;
+    QHash<SubscriberKey, QList<SimpleObserver::Private*> > mSubscribers;
+    // subscribers whose contact identifier is still being normalized, which
+    // queue all events and filter them once it is known
+    QList<SimpleObserver::Private*> mUnresolvedSubscribers;
+    QSet<SimpleObserver::Private*> mAllSubscribers;
 };
 
 class TP_QT_NO_EXPORT SimpleObserver::Private::ChannelWrapper :
@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/SimpleObserver>
 #include "TelepathyQt/simple-observer-internal.h"
 
@@ -78,16 +80,16 @@ SimpleObserver::Private::Private(SimpleObserver *parent,
         observer = SharedPtr<Observer>(new Observer(cr, fakeAccountFactory,
                     normalizedChannelFilter.toList(), observerName));
         if (!cr->registerClient(observer, observerName, false)) {
-            warning() << "Unable to register observer" << observerName;
+            TP_QT_WARNING() << "Unable to register observer" << observerName;
             observer.reset();
             cr.reset();
             return;
         }
 
-        debug() << "Observer" << observerName << "registered";
+        TP_QT_DEBUG() << "Observer" << observerName << "registered";
         observers.insert(observerUniqueId, observer);
     } else {
-        debug() << "Observer" << observer->observerName() <<
+        TP_QT_DEBUG() << "Observer" << observer->observerName() <<
             "already registered and matches filter, using it";
         cr = ClientRegistrarPtr(observer->clientRegistrar());
     }
@@ -103,12 +105,31 @@ SimpleObserver::Private::Private(SimpleObserver *parent,
                 SLOT(onAccountConnectionChanged(Tp::ConnectionPtr)));
     }
 
-    parent->connect(observer.data(),
-            SIGNAL(newChannels(Tp::AccountPtr,QList<Tp::ChannelPtr>)),
-            SLOT(onNewChannels(Tp::AccountPtr,QList<Tp::ChannelPtr>)));
-    parent->connect(observer.data(),
-            SIGNAL(channelInvalidated(Tp::AccountPtr,Tp::ChannelPtr,QString,QString)),
-            SLOT(onChannelInvalidated(Tp::AccountPtr,Tp::ChannelPtr,QString,QString)));
+    observer->addSubscriber(this);
+}
+
+SimpleObserver::Private::~Private()
+{
+    if (observer) {
+        observer->removeSubscriber(this);
+    }
+}
+
+bool SimpleObserver::Private::isSubscriberResolved() const
+{
+    return contactIdentifier.isEmpty() || !normalizedContactIdentifier.isEmpty();
+}
+
+void SimpleObserver::Private::notifyNewChannels(const AccountPtr &channelsAccount,
+        const QList<ChannelPtr> &channels)
+{
+    parent->onNewChannels(channelsAccount, channels);
+}
+
+void SimpleObserver::Private::notifyChannelInvalidated(const AccountPtr &channelAccount,
+        const ChannelPtr &channel, const QString &errorName, const QString &errorMessage)
+{
+    parent->onChannelInvalidated(channelAccount, channel, errorName, errorMessage);
 }
 
 bool SimpleObserver::Private::filterChannel(const AccountPtr &channelAccount,
@@ -234,7 +255,7 @@ void SimpleObserver::Private::Observer::observeChannels(
 
         // this shouldn't happen, but in any case
         if (!channel->isValid()) {
-            warning() << "Channel received to observe is invalid. "
+            TP_QT_WARNING() << "Channel received to observe is invalid. "
                 "Ignoring channel";
             continue;
         }
@@ -264,6 +285,97 @@ void SimpleObserver::Private::Observer::observeChannels(
             SLOT(onChannelsReady(Tp::PendingOperation*)));
 }
 
+void SimpleObserver::Private::Observer::addSubscriber(SimpleObserver::Private *subscriber)
+{
+    if (subscriber->isSubscriberResolved()) {
+        mSubscribers[subscriberKey(subscriber)].append(subscriber);
+    } else {
+        mUnresolvedSubscribers.append(subscriber);
+    }
+    mAllSubscribers.insert(subscriber);
+}
+
+void SimpleObserver::Private::Observer::removeSubscriber(SimpleObserver::Private *subscriber)
+{
+    if (!mAllSubscribers.remove(subscriber)) {
+        return;
+    }
+
+    if (mUnresolvedSubscribers.removeOne(subscriber)) {
+        return;
+    }
+
+    SubscriberKey key = subscriberKey(subscriber);
+    QHash<SubscriberKey, QList<SimpleObserver::Private*> >::iterator it = mSubscribers.find(key);
+    if (it != mSubscribers.end()) {
+        it->removeOne(subscriber);
+        if (it->isEmpty()) {
+            mSubscribers.erase(it);
+        }
+    }
+}
+
+SimpleObserver::Private::Observer::SubscriberKey SimpleObserver::Private::Observer::subscriberKey(
+        const SimpleObserver::Private *subscriber)
+{
+    return SubscriberKey(subscriber->account, subscriber->normalizedContactIdentifier);
+}
+
+void SimpleObserver::Private::Observer::notifyNewChannels(const AccountPtr &channelsAccount,
+        const QList<ChannelPtr> &channels)
+{
+    // subscribers may go away, or take this observer with them, while being notified
+    SharedPtr<Observer> self(this);
+
+    QList<SimpleObserver::Private*> subscribers =
+        mSubscribers.value(SubscriberKey(channelsAccount, QString())) + mUnresolvedSubscribers;
+    foreach (SimpleObserver::Private *subscriber, subscribers) {
+        if (mAllSubscribers.contains(subscriber)) {
+            subscriber->notifyNewChannels(channelsAccount, channels);
+        }
+    }
+
+    // only the subscribers for the channels' targets are told about them
+    QHash<QString, QList<ChannelPtr> > channelsByTarget;
+    foreach (const ChannelPtr &channel, channels) {
+        QString targetId = channel->immutableProperties().value(
+                TP_QT_IFACE_CHANNEL + QLatin1String(".TargetID")).toString();
+        if (!targetId.isEmpty() && mSubscribers.contains(SubscriberKey(channelsAccount, targetId))) {
+            channelsByTarget[targetId].append(channel);
+        }
+    }
+
+    QHash<QString, QList<ChannelPtr> >::const_iterator it = channelsByTarget.constBegin();
+    for (; it != channelsByTarget.constEnd(); ++it) {
+        subscribers = mSubscribers.value(SubscriberKey(channelsAccount, it.key()));
+        foreach (SimpleObserver::Private *subscriber, subscribers) {
+            if (mAllSubscribers.contains(subscriber)) {
+                subscriber->notifyNewChannels(channelsAccount, it.value());
+            }
+        }
+    }
+}
+
+void SimpleObserver::Private::Observer::notifyChannelInvalidated(const AccountPtr &channelAccount,
+        const ChannelPtr &channel, const QString &errorName, const QString &errorMessage)
+{
+    SharedPtr<Observer> self(this);
+
+    QList<SimpleObserver::Private*> subscribers =
+        mSubscribers.value(SubscriberKey(channelAccount, QString())) + mUnresolvedSubscribers;
+    QString targetId = channel->immutableProperties().value(
+            TP_QT_IFACE_CHANNEL + QLatin1String(".TargetID")).toString();
+    if (!targetId.isEmpty()) {
+        subscribers += mSubscribers.value(SubscriberKey(channelAccount, targetId));
+    }
+
+    foreach (SimpleObserver::Private *subscriber, subscribers) {
+        if (mAllSubscribers.contains(subscriber)) {
+            subscriber->notifyChannelInvalidated(channelAccount, channel, errorName, errorMessage);
+        }
+    }
+}
+
 void SimpleObserver::Private::Observer::onChannelInvalidated(const AccountPtr &channelAccount,
         const ChannelPtr &channel, const QString &errorName, const QString &errorMessage)
 {
@@ -272,9 +384,9 @@ void SimpleObserver::Private::Observer::onChannelInvalidated(const AccountPtr &c
         // it from mChannels
         return;
     }
-    emit channelInvalidated(channelAccount, channel, errorName, errorMessage);
     Q_ASSERT(mChannels.contains(channel));
     delete mChannels.take(channel);
+    notifyChannelInvalidated(channelAccount, channel, errorName, errorMessage);
 }
 
 void SimpleObserver::Private::Observer::onChannelsReady(PendingOperation *op)
@@ -286,13 +398,13 @@ void SimpleObserver::Private::Observer::onChannelsReady(PendingOperation *op)
         ChannelWrapper *wrapper = mIncompleteChannels.take(channel);
         mChannels.insert(channel, wrapper);
     }
-    emit newChannels(info->account, info->channels);
+    notifyNewChannels(info->account, info->channels);
 
     foreach (const ChannelPtr &channel, info->channels) {
         ChannelWrapper *wrapper = mChannels.value(channel);
         if (!channel->isValid()) {
             mChannels.remove(channel);
-            emit channelInvalidated(info->account, channel, channel->invalidationReason(),
+            notifyChannelInvalidated(info->account, channel, channel->invalidationReason(),
                     channel->invalidationMessage());
             delete wrapper;
         }
@@ -477,7 +589,7 @@ SimpleObserver::SimpleObserver(const AccountPtr &account,
         }
 
         if (requiresNormalization) {
-            debug() << "Contact id requires normalization. "
+            TP_QT_DEBUG() << "Contact id requires normalization. "
                 "Queueing events until it is normalized";
             onAccountConnectionChanged(account->connection());
         }
@@ -561,7 +673,7 @@ void SimpleObserver::onAccountConnectionConnected()
         return;
     }
 
-    debug() << "Normalizing contact id" << mPriv->contactIdentifier;
+    TP_QT_DEBUG() << "Normalizing contact id" << mPriv->contactIdentifier;
     ContactManagerPtr contactManager = conn->contactManager();
     connect(contactManager->contactsForIdentifiers(QStringList() << mPriv->contactIdentifier),
             SIGNAL(finished(Tp::PendingOperation*)),
@@ -572,7 +684,7 @@ void SimpleObserver::onContactConstructed(Tp::PendingOperation *op)
 {
     if (op->isError()) {
         // what should we do here? retry? wait for a new connection?
-        warning() << "Normalizing contact id failed with" <<
+        TP_QT_WARNING() << "Normalizing contact id failed with" <<
             op->errorName() << " : " << op->errorMessage();
         return;
     }
@@ -580,15 +692,18 @@ void SimpleObserver::onContactConstructed(Tp::PendingOperation *op)
     PendingContacts *pc = qobject_cast<PendingContacts*>(op);
     Q_ASSERT((pc->contacts().size() + pc->invalidIdentifiers().size()) == 1);
     if (!pc->invalidIdentifiers().isEmpty()) {
-        warning() << "Normalizing contact id failed with invalid id" <<
+        TP_QT_WARNING() << "Normalizing contact id failed with invalid id" <<
             mPriv->contactIdentifier;
         return;
     }
 
     ContactPtr contact = pc->contacts().first();
-    debug() << "Contact id" << mPriv->contactIdentifier <<
+    TP_QT_DEBUG() << "Contact id" << mPriv->contactIdentifier <<
         "normalized to" << contact->id();
+    // the subscription moves from the unresolved ones to the target's index entry
+    mPriv->observer->removeSubscriber(mPriv);
     mPriv->normalizedContactIdentifier = contact->id();
+    mPriv->observer->addSubscriber(mPriv);
     mPriv->processChannelsQueue();
 
     // disconnect all account signals we are handling
@@ -29,6 +29,7 @@
 
 #include <QObject>
 
+#include <TelepathyQt/CompletionHandle>
 #include <TelepathyQt/PendingOperation>
 
 namespace Tp
@@ -96,8 +97,22 @@ public:
             const SharedPtr<RefCounted> &object);
     ~PendingComposite() override ;
 
-private Q_SLOTS:
-    TP_QT_NO_EXPORT void onOperationFinished(Tp::PendingOperation *);
+private:
+    struct Private;
+    friend struct Private;
+    Private *mPriv;
+};
+
+class TP_QT_EXPORT PendingCompletion : public PendingOperation
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(PendingCompletion)
+
+public:
+    PendingCompletion(const CompletionHandle &handle, const SharedPtr<RefCounted> &object);
+    ~PendingCompletion() override;
+
+    CompletionHandle handle() const;
 
 private:
     struct Private;
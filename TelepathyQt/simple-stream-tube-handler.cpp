@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include "TelepathyQt/simple-stream-tube-handler.h"
 
 #include "TelepathyQt/_gen/simple-stream-tube-handler.moc.hpp"
@@ -94,7 +96,7 @@ SimpleStreamTubeHandler::SimpleStreamTubeHandler(
 SimpleStreamTubeHandler::~SimpleStreamTubeHandler()
 {
     if (!mTubes.empty()) {
-        debug() << "~SSTubeHandler(): Closing" << mTubes.size() << "leftover tubes";
+        TP_QT_DEBUG() << "~SSTubeHandler(): Closing" << mTubes.size() << "leftover tubes";
 
         foreach (const StreamTubeChannelPtr &tube, mTubes.keys()) {
             tube->requestClose();
@@ -111,7 +113,7 @@ void SimpleStreamTubeHandler::handleChannels(
         const QDateTime &userActionTime,
         const HandlerInfo &handlerInfo)
 {
-    debug() << "SimpleStreamTubeHandler::handleChannels() invoked for " <<
+    TP_QT_DEBUG() << "SimpleStreamTubeHandler::handleChannels() invoked for " <<
         channels.size() << "channels on account" << account->objectPath();
 
     SharedPtr<InvocationData> invocation(new InvocationData());
@@ -127,10 +129,10 @@ void SimpleStreamTubeHandler::handleChannels(
                 chan->immutableProperties()[TP_QT_IFACE_CHANNEL + QLatin1String(".ChannelType")].toString();
 
             if (channelType != TP_QT_IFACE_CHANNEL_TYPE_STREAM_TUBE) {
-                debug() << "We got a non-StreamTube channel" << chan->objectPath() <<
+                TP_QT_DEBUG() << "We got a non-StreamTube channel" << chan->objectPath() <<
                     "of type" << channelType << ", ignoring";
             } else {
-                warning() << "The channel factory used for a simple StreamTube handler must" <<
+                TP_QT_WARNING() << "The channel factory used for a simple StreamTube handler must" <<
                     "construct StreamTubeChannel subclasses for stream tubes";
             }
             continue;
@@ -156,7 +158,7 @@ void SimpleStreamTubeHandler::handleChannels(
     mInvocations.append(invocation);
 
     if (invocation->tubes.isEmpty()) {
-        warning() << "SSTH::HandleChannels got no suitable channels, admitting we're Confused";
+        TP_QT_WARNING() << "SSTH::HandleChannels got no suitable channels, admitting we're Confused";
         invocation->readyOp = nullptr;
         invocation->error = TP_QT_ERROR_CONFUSED;
         invocation->message = QLatin1String("Got no suitable channels");
@@ -183,7 +185,7 @@ void SimpleStreamTubeHandler::onReadyOpFinished(Tp::PendingOperation *op)
         (*i)->readyOp = nullptr;
 
         if (op->isError()) {
-            warning() << "Preparing proxies for SSTubeHandler failed with" << op->errorName()
+            TP_QT_WARNING() << "Preparing proxies for SSTubeHandler failed with" << op->errorName()
                 << op->errorMessage();
             (*i)->error = op->errorName();
             (*i)->message = op->errorMessage();
@@ -202,12 +204,12 @@ void SimpleStreamTubeHandler::onReadyOpFinished(Tp::PendingOperation *op)
             continue;
         }
 
-        debug() << "Emitting SSTubeHandler::invokedForTube for" << invocation->tubes.size()
+        TP_QT_DEBUG() << "Emitting SSTubeHandler::invokedForTube for" << invocation->tubes.size()
             << "tubes";
 
         foreach (const StreamTubeChannelPtr &tube, invocation->tubes) {
             if (!tube->isValid()) {
-                debug() << "Skipping already invalidated tube" << tube->objectPath();
+                TP_QT_DEBUG() << "Skipping already invalidated tube" << tube->objectPath();
                 continue;
             }
 
@@ -238,7 +240,7 @@ void SimpleStreamTubeHandler::onTubeInvalidated(DBusProxy *proxy,
     Q_ASSERT(!tube.isNull());
     Q_ASSERT(mTubes.contains(tube));
 
-    debug() << "Tube" << tube->objectPath() << "invalidated - " << errorName << ':' << errorMessage;
+    TP_QT_DEBUG() << "Tube" << tube->objectPath() << "invalidated - " << errorName << ':' << errorMessage;
 
     AccountPtr acc = mTubes.value(tube);
     mTubes.remove(tube);
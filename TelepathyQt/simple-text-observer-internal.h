@@ -25,6 +25,8 @@
 #include <TelepathyQt/SimpleObserver>
 #include <TelepathyQt/TextChannel>
 
+#include <QPointer>
+
 namespace Tp
 {
 
@@ -36,6 +38,9 @@ struct TP_QT_NO_EXPORT SimpleTextObserver::Private
 
     class TextChannelWrapper;
 
+    static bool emitMessagesReceived(const QPointer<SimpleTextObserver> &observer,
+            QList<ReceivedMessage> messages, TextChannelPtr channel);
+
     SimpleTextObserver *parent;
     AccountPtr account;
     QString contactIdentifier;
@@ -50,20 +55,21 @@ class TP_QT_NO_EXPORT SimpleTextObserver::Private::TextChannelWrapper :
     Q_DISABLE_COPY(TextChannelWrapper)
 
 public:
-    TextChannelWrapper(const Tp::TextChannelPtr &channel);
+    TextChannelWrapper(SimpleTextObserver *observer,
+            const Tp::TextChannelPtr &channel);
     ~TextChannelWrapper() override { }
 
 Q_SIGNALS:
     void channelMessageSent(const Tp::Message &message, Tp::MessageSendingFlags flags,
             const QString &sentMessageToken, const Tp::TextChannelPtr &channel);
-    void channelMessageReceived(const Tp::ReceivedMessage &message, const Tp::TextChannelPtr &channel);
 
 private Q_SLOTS:
     void onChannelMessageSent(const Tp::Message &message, Tp::MessageSendingFlags flags,
             const QString &sentMessageToken);
-    void onChannelMessageReceived(const Tp::ReceivedMessage &message);
+    void onChannelMessagesReceived(const QList<Tp::ReceivedMessage> &messages);
 
 private:
+    QPointer<SimpleTextObserver> mObserver;
     TextChannelPtr mChannel;
 };
 
@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/SimpleTextObserver>
 #include "TelepathyQt/simple-text-observer-internal.h"
 
@@ -49,7 +51,7 @@ SimpleTextObserver::Private::Private(SimpleTextObserver *parent,
       account(account),
       contactIdentifier(contactIdentifier)
 {
-    debug() << "Creating a new SimpleTextObserver";
+    TP_QT_DEBUG() << "Creating a new SimpleTextObserver";
     ChannelClassSpec channelFilter = ChannelClassSpec::textChat();
     observer = SimpleObserver::create(account, ChannelClassSpecList() << channelFilter,
             contactIdentifier, requiresNormalization,
@@ -71,15 +73,39 @@ SimpleTextObserver::Private::~Private()
     }
 }
 
-SimpleTextObserver::Private::TextChannelWrapper::TextChannelWrapper(const TextChannelPtr &channel)
-    : mChannel(channel)
+// A slot may delete the observer, and with it the wrapper which called this, so the
+// arguments are copies and nothing is emitted once the observer is gone. Returns
+// whether the observer is still alive.
+bool SimpleTextObserver::Private::emitMessagesReceived(const QPointer<SimpleTextObserver> &observer,
+        QList<ReceivedMessage> messages, TextChannelPtr channel)
+{
+    QPointer<SimpleTextObserver> guard(observer);
+    foreach (const ReceivedMessage &message, messages) {
+        if (!guard) {
+            return false;
+        }
+        emit guard->messageReceived(message, channel);
+    }
+
+    if (!guard) {
+        return false;
+    }
+    emit guard->messagesReceived(messages, channel);
+    return !guard.isNull();
+}
+
+SimpleTextObserver::Private::TextChannelWrapper::TextChannelWrapper(
+        SimpleTextObserver *observer, const TextChannelPtr &channel)
+    : mObserver(observer),
+      mChannel(channel)
 {
     connect(mChannel.data(),
             SIGNAL(messageSent(Tp::Message,Tp::MessageSendingFlags,QString)),
             SLOT(onChannelMessageSent(Tp::Message,Tp::MessageSendingFlags,QString)));
+    // Only listen to the batched signal, the per-message one is emitted from it
     connect(mChannel.data(),
-            SIGNAL(messageReceived(Tp::ReceivedMessage)),
-            SLOT(onChannelMessageReceived(Tp::ReceivedMessage)));
+            SIGNAL(messagesReceived(QList<Tp::ReceivedMessage>)),
+            SLOT(onChannelMessagesReceived(QList<Tp::ReceivedMessage>)));
 }
 
 void SimpleTextObserver::Private::TextChannelWrapper::onChannelMessageSent(
@@ -89,10 +115,10 @@ void SimpleTextObserver::Private::TextChannelWrapper::onChannelMessageSent(
     emit channelMessageSent(message, flags, sentMessageToken, mChannel);
 }
 
-void SimpleTextObserver::Private::TextChannelWrapper::onChannelMessageReceived(
-        const Tp::ReceivedMessage &message)
+void SimpleTextObserver::Private::TextChannelWrapper::onChannelMessagesReceived(
+        const QList<Tp::ReceivedMessage> &messages)
 {
-    emit channelMessageReceived(message, mChannel);
+    Private::emitMessagesReceived(mObserver, messages, mChannel);
 }
 
 /**
@@ -229,10 +255,10 @@ void SimpleTextObserver::onNewChannels(const QList<ChannelPtr> &channels)
         TextChannelPtr textChannel = TextChannelPtr::qObjectCast(channel);
         if (!textChannel) {
             if (channel->channelType() != TP_QT_IFACE_CHANNEL_TYPE_TEXT) {
-                warning() << "Channel received to observe is not of type Text, service confused. "
+                TP_QT_WARNING() << "Channel received to observe is not of type Text, service confused. "
                     "Ignoring channel";
             } else {
-                warning() << "Channel received to observe is not a subclass of TextChannel. "
+                TP_QT_WARNING() << "Channel received to observe is not a subclass of TextChannel. "
                     "ChannelFactory set on this observer's account must construct TextChannel "
                     "subclasses for channels of type Text. Ignoring channel";
             }
@@ -244,17 +270,17 @@ void SimpleTextObserver::onNewChannels(const QList<ChannelPtr> &channels)
             continue;
         }
 
-        Private::TextChannelWrapper *wrapper = new Private::TextChannelWrapper(textChannel);
+        Private::TextChannelWrapper *wrapper = new Private::TextChannelWrapper(this,
+                textChannel);
         mPriv->channels.insert(channel, wrapper);
         connect(wrapper,
                 SIGNAL(channelMessageSent(Tp::Message,Tp::MessageSendingFlags,QString,Tp::TextChannelPtr)),
                 SIGNAL(messageSent(Tp::Message,Tp::MessageSendingFlags,QString,Tp::TextChannelPtr)));
-        connect(wrapper,
-                SIGNAL(channelMessageReceived(Tp::ReceivedMessage,Tp::TextChannelPtr)),
-                SIGNAL(messageReceived(Tp::ReceivedMessage,Tp::TextChannelPtr)));
 
-        foreach (const ReceivedMessage &message, textChannel->messageQueue()) {
-            emit messageReceived(message, textChannel);
+        QList<ReceivedMessage> queue = textChannel->messageQueue();
+        if (!queue.isEmpty() && !Private::emitMessagesReceived(this, queue, textChannel)) {
+            // deleted by a slot connected to the signals
+            return;
         }
     }
 }
@@ -295,4 +321,20 @@ void SimpleTextObserver::onChannelInvalidated(const ChannelPtr &channel)
  * \param channel The channel which received the message.
  */
 
+/**
+ * \fn void SimpleTextObserver::messagesReceived(const QList<Tp::ReceivedMessage> &messages,
+ *                  const Tp::TextChannelPtr &channel);
+ *
+ * Emitted once for all the text messages received on \a channel at the same time, right after
+ * messageReceived() has been emitted for each of them. This includes the messages already
+ * queued on a channel when it starts being observed.
+ *
+ * This is more efficient than messageReceived() for clients handling messages in bulk, such
+ * as loggers.
+ *
+ * \param messages The messages received, in the order they were received.
+ * \param channel The channel which received the messages.
+ * \sa TextChannel::messagesReceived()
+ */
+
 } // Tp
@@ -58,6 +58,8 @@ Q_SIGNALS:
     void messageSent(const Tp::Message &message, Tp::MessageSendingFlags flags,
             const QString &sentMessageToken, const Tp::TextChannelPtr &channel);
     void messageReceived(const Tp::ReceivedMessage &message, const Tp::TextChannelPtr &channel);
+    void messagesReceived(const QList<Tp::ReceivedMessage> &messages,
+            const Tp::TextChannelPtr &channel);
 
 private Q_SLOTS:
     TP_QT_NO_EXPORT void onNewChannels(const QList<Tp::ChannelPtr> &channels);
@@ -19,6 +19,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/StreamTubeChannel>
 
 #include "TelepathyQt/_gen/stream-tube-channel.moc.hpp"
@@ -101,7 +103,7 @@ void StreamTubeChannel::Private::introspectStreamTube(
 {
     StreamTubeChannel *parent = self->parent;
 
-    debug() << "Introspecting stream tube properties";
+    TP_QT_DEBUG() << "Introspecting stream tube properties";
     Client::ChannelTypeStreamTubeInterface *streamTubeInterface =
             parent->interface<Client::ChannelTypeStreamTubeInterface>();
 
@@ -237,7 +239,7 @@ StreamTubeChannel::~StreamTubeChannel()
 QString StreamTubeChannel::service() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "StreamTubeChannel::service() used with "
+        TP_QT_WARNING() << "StreamTubeChannel::service() used with "
                 "FeatureCore not ready";
         return QString();
     }
@@ -264,7 +266,7 @@ QString StreamTubeChannel::service() const
 bool StreamTubeChannel::supportsIPv4SocketsOnLocalhost() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "StreamTubeChannel::supportsIPv4SocketsOnLocalhost() used with "
+        TP_QT_WARNING() << "StreamTubeChannel::supportsIPv4SocketsOnLocalhost() used with "
                 "FeatureCore not ready";
         return false;
     }
@@ -307,7 +309,7 @@ bool StreamTubeChannel::supportsIPv4SocketsOnLocalhost() const
 bool StreamTubeChannel::supportsIPv4SocketsWithSpecifiedAddress() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "StreamTubeChannel::supportsIPv4SocketsWithSpecifiedAddress() used with "
+        TP_QT_WARNING() << "StreamTubeChannel::supportsIPv4SocketsWithSpecifiedAddress() used with "
                 "FeatureCore not ready";
         return false;
     }
@@ -335,7 +337,7 @@ bool StreamTubeChannel::supportsIPv4SocketsWithSpecifiedAddress() const
 bool StreamTubeChannel::supportsIPv6SocketsOnLocalhost() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "StreamTubeChannel::supportsIPv6SocketsOnLocalhost() used with "
+        TP_QT_WARNING() << "StreamTubeChannel::supportsIPv6SocketsOnLocalhost() used with "
                 "FeatureCore not ready";
         return false;
     }
@@ -378,7 +380,7 @@ bool StreamTubeChannel::supportsIPv6SocketsOnLocalhost() const
 bool StreamTubeChannel::supportsIPv6SocketsWithSpecifiedAddress() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "StreamTubeChannel::supportsIPv6SocketsWithSpecifiedAddress() used with "
+        TP_QT_WARNING() << "StreamTubeChannel::supportsIPv6SocketsWithSpecifiedAddress() used with "
                 "FeatureCore not ready";
         return false;
     }
@@ -408,7 +410,7 @@ bool StreamTubeChannel::supportsIPv6SocketsWithSpecifiedAddress() const
 bool StreamTubeChannel::supportsUnixSocketsOnLocalhost() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "StreamTubeChannel::supportsUnixSocketsOnLocalhost() used with "
+        TP_QT_WARNING() << "StreamTubeChannel::supportsUnixSocketsOnLocalhost() used with "
                 "FeatureCore not ready";
         return false;
     }
@@ -447,7 +449,7 @@ bool StreamTubeChannel::supportsUnixSocketsOnLocalhost() const
 bool StreamTubeChannel::supportsUnixSocketsWithCredentials() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "StreamTubeChannel::supportsUnixSocketsWithCredentials() used with "
+        TP_QT_WARNING() << "StreamTubeChannel::supportsUnixSocketsWithCredentials() used with "
                 "FeatureCore not ready";
         return false;
     }
@@ -477,7 +479,7 @@ bool StreamTubeChannel::supportsUnixSocketsWithCredentials() const
 bool StreamTubeChannel::supportsAbstractUnixSocketsOnLocalhost() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "StreamTubeChannel::supportsAbstractUnixSocketsOnLocalhost() used with "
+        TP_QT_WARNING() << "StreamTubeChannel::supportsAbstractUnixSocketsOnLocalhost() used with "
                 "FeatureCore not ready";
         return false;
     }
@@ -516,7 +518,7 @@ bool StreamTubeChannel::supportsAbstractUnixSocketsOnLocalhost() const
 bool StreamTubeChannel::supportsAbstractUnixSocketsWithCredentials() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "StreamTubeChannel::supportsAbstractUnixSocketsWithCredentials() used with "
+        TP_QT_WARNING() << "StreamTubeChannel::supportsAbstractUnixSocketsWithCredentials() used with "
                 "FeatureCore not ready";
         return false;
     }
@@ -540,7 +542,7 @@ bool StreamTubeChannel::supportsAbstractUnixSocketsWithCredentials() const
 QSet<uint> StreamTubeChannel::connections() const
 {
     if (!isReady(FeatureConnectionMonitoring)) {
-        warning() << "StreamTubeChannel::connections() used with "
+        TP_QT_WARNING() << "StreamTubeChannel::connections() used with "
                 "FeatureConnectionMonitoring not ready";
         return QSet<uint>();
     }
@@ -589,7 +591,7 @@ SocketAccessControl StreamTubeChannel::accessControl() const
 QPair<QHostAddress, quint16> StreamTubeChannel::ipAddress() const
 {
     if (state() != TubeChannelStateOpen) {
-        warning() << "Tube not open, returning invalid IP address";
+        TP_QT_WARNING() << "Tube not open, returning invalid IP address";
         return qMakePair<QHostAddress, quint16>(QHostAddress::Null, 0);
     }
 
@@ -611,7 +613,7 @@ QPair<QHostAddress, quint16> StreamTubeChannel::ipAddress() const
 QString StreamTubeChannel::localAddress() const
 {
     if (state() != TubeChannelStateOpen) {
-        warning() << "Tube not open, returning invalid local socket address";
+        TP_QT_WARNING() << "Tube not open, returning invalid local socket address";
         return QString();
     }
 
@@ -624,7 +626,7 @@ void StreamTubeChannel::addConnection(uint connection)
         mPriv->connections.insert(connection);
         emit newConnection(connection);
     } else {
-        warning() << "Tried to add connection" << connection << "on StreamTube" << objectPath()
+        TP_QT_WARNING() << "Tried to add connection" << connection << "on StreamTube" << objectPath()
             << "but it already was there";
     }
 }
@@ -636,7 +638,7 @@ void StreamTubeChannel::removeConnection(uint connection, const QString &error,
         mPriv->connections.remove(connection);
         emit connectionClosed(connection, error, message);
     } else {
-        warning() << "Tried to remove connection" << connection << "from StreamTube" << objectPath()
+        TP_QT_WARNING() << "Tried to remove connection" << connection << "from StreamTube" << objectPath()
             << "but it wasn't there";
     }
 }
@@ -673,11 +675,11 @@ void StreamTubeChannel::gotStreamTubeProperties(PendingOperation *op)
 
         mPriv->extractStreamTubeProperties(pvm->result());
 
-        debug() << "Got reply to Properties::GetAll(StreamTubeChannel)";
+        TP_QT_DEBUG() << "Got reply to Properties::GetAll(StreamTubeChannel)";
         mPriv->readinessHelper->setIntrospectCompleted(StreamTubeChannel::FeatureCore, true);
     }
     else {
-        warning().nospace() << "Properties::GetAll(StreamTubeChannel) failed "
+        TP_QT_WARNING().nospace() << "Properties::GetAll(StreamTubeChannel) failed "
                 "with " << op->errorName() << ": " << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(StreamTubeChannel::FeatureCore, false,
                 op->errorName(), op->errorMessage());
@@ -693,7 +695,7 @@ void StreamTubeChannel::onConnectionClosed(uint connId, const QString &error,
 void StreamTubeChannel::dropConnections()
 {
     if (!mPriv->connections.isEmpty()) {
-        debug() << "StreamTubeChannel invalidated with" << mPriv->connections.size()
+        TP_QT_DEBUG() << "StreamTubeChannel invalidated with" << mPriv->connections.size()
             << "connections remaining, synthesizing close events";
         mPriv->droppingConnections = true;
         foreach (uint connId, mPriv->connections) {
@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/StreamTubeClient>
 
 #include "TelepathyQt/stream-tube-client-internal.h"
@@ -221,12 +223,12 @@ struct TP_QT_NO_EXPORT StreamTubeClient::Private
             return;
         }
 
-        debug() << "Register StreamTubeClient with name " << clientName;
+        TP_QT_DEBUG() << "Register StreamTubeClient with name " << clientName;
 
         if (registrar->registerClient(handler, clientName)) {
             isRegistered = true;
         } else {
-            warning() << "StreamTubeClient" << clientName
+            TP_QT_WARNING() << "StreamTubeClient" << clientName
                 << "registration failed";
         }
     }
@@ -265,7 +267,7 @@ StreamTubeClient::TubeWrapper::TubeWrapper(
                     !tube->supportsIPv4SocketsWithSpecifiedAddress()) ||
                 (hostAddress.protocol() == QAbstractSocket::IPv6Protocol &&
                  !tube->supportsIPv6SocketsWithSpecifiedAddress())) {
-            debug() << "StreamTubeClient falling back to Localhost AC for tube" <<
+            TP_QT_DEBUG() << "StreamTubeClient falling back to Localhost AC for tube" <<
                 tube->objectPath();
             mSourceAddress = sourceAddress.protocol() == QAbstractSocket::IPv4Protocol ?
                  QHostAddress::Any : QHostAddress::AnyIPv6;
@@ -292,7 +294,7 @@ StreamTubeClient::TubeWrapper::TubeWrapper(
     : QObject(parent), mAcc(acc), mTube(tube), mSourcePort(0)
 {
     if (requireCredentials && !tube->supportsUnixSocketsWithCredentials()) {
-        debug() << "StreamTubeClient falling back to Localhost AC for tube" << tube->objectPath();
+        TP_QT_DEBUG() << "StreamTubeClient falling back to Localhost AC for tube" << tube->objectPath();
         requireCredentials = false;
     }
 
@@ -524,7 +526,7 @@ StreamTubeClientPtr StreamTubeClient::create(
         bool bypassApproval)
 {
     if (p2pServices.isEmpty() && roomServices.isEmpty()) {
-        warning() << "Tried to create a StreamTubeClient with no services, returning NULL";
+        TP_QT_WARNING() << "Tried to create a StreamTubeClient with no services, returning NULL";
         return StreamTubeClientPtr();
     }
 
@@ -647,7 +649,7 @@ bool StreamTubeClient::acceptsAsTcp() const
 StreamTubeClient::TcpSourceAddressGenerator *StreamTubeClient::tcpGenerator() const
 {
     if (!acceptsAsTcp()) {
-        warning() << "StreamTubeClient::tcpGenerator() used, but not accepting as TCP, returning 0";
+        TP_QT_WARNING() << "StreamTubeClient::tcpGenerator() used, but not accepting as TCP, returning 0";
         return nullptr;
     }
 
@@ -781,7 +783,7 @@ QHash<StreamTubeClient::Tube, QSet<uint> > StreamTubeClient::connections() const
 {
     QHash<Tube, QSet<uint> > conns;
     if (!monitorsConnections()) {
-        warning() << "StreamTubeClient::connections() used, but connection monitoring is disabled";
+        TP_QT_WARNING() << "StreamTubeClient::connections() used, but connection monitoring is disabled";
         return conns;
     }
 
@@ -813,14 +815,14 @@ void StreamTubeClient::onInvokedForTube(
     Q_ASSERT(tube->isValid()); // SSTH won't emit invalid tubes
 
     if (mPriv->tubes.contains(tube)) {
-        debug() << "Ignoring StreamTubeClient reinvocation for tube" << tube->objectPath();
+        TP_QT_DEBUG() << "Ignoring StreamTubeClient reinvocation for tube" << tube->objectPath();
         return;
     }
 
     IncomingStreamTubeChannelPtr incoming = IncomingStreamTubeChannelPtr::qObjectCast(tube);
 
     if (!incoming) {
-        warning() << "The ChannelFactory used by StreamTubeClient must construct" <<
+        TP_QT_WARNING() << "The ChannelFactory used by StreamTubeClient must construct" <<
             "IncomingStreamTubeChannel subclasses for Requested=false StreamTubes";
         tube->requestClose();
         return;
@@ -869,13 +871,13 @@ void StreamTubeClient::onAcceptFinished(TubeWrapper *wrapper, PendingStreamTubeC
     Q_ASSERT(conn != nullptr);
 
     if (!mPriv->tubes.contains(wrapper->mTube)) {
-        debug() << "StreamTubeClient ignoring Accept result for invalidated tube"
+        TP_QT_DEBUG() << "StreamTubeClient ignoring Accept result for invalidated tube"
             << wrapper->mTube->objectPath();
         return;
     }
 
     if (conn->isError()) {
-        warning() << "StreamTubeClient couldn't accept tube" << wrapper->mTube->objectPath() << '-'
+        TP_QT_WARNING() << "StreamTubeClient couldn't accept tube" << wrapper->mTube->objectPath() << '-'
             << conn->errorName() << ':' << conn->errorMessage();
 
         if (wrapper->mTube->isValid()) {
@@ -889,7 +891,7 @@ void StreamTubeClient::onAcceptFinished(TubeWrapper *wrapper, PendingStreamTubeC
         return;
     }
 
-    debug() << "StreamTubeClient accepted tube" << wrapper->mTube->objectPath();
+    TP_QT_DEBUG() << "StreamTubeClient accepted tube" << wrapper->mTube->objectPath();
 
     if (conn->addressType() == SocketAddressTypeIPv4
             || conn->addressType() == SocketAddressTypeIPv6) {
@@ -914,7 +916,7 @@ void StreamTubeClient::onTubeInvalidated(Tp::DBusProxy *proxy, const QString &er
         return;
     }
 
-    debug() << "Client StreamTube" << tube->objectPath() << "invalidated - " << error << ':'
+    TP_QT_DEBUG() << "Client StreamTube" << tube->objectPath() << "invalidated - " << error << ':'
         << message;
 
     emit tubeClosed(wrapper->mAcc, wrapper->mTube, error, message);
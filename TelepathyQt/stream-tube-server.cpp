@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/StreamTubeServer>
 #include "TelepathyQt/stream-tube-server-internal.h"
 
@@ -317,12 +319,12 @@ struct StreamTubeServer::Private
             return;
         }
 
-        debug() << "Register StreamTubeServer with name " << clientName;
+        TP_QT_DEBUG() << "Register StreamTubeServer with name " << clientName;
 
         if (registrar->registerClient(handler, clientName)) {
             isRegistered = true;
         } else {
-            warning() << "StreamTubeServer" << clientName
+            TP_QT_WARNING() << "StreamTubeServer" << clientName
                 << "registration failed";
         }
     }
@@ -723,7 +725,7 @@ void StreamTubeServer::exportTcpSocket(
         const QVariantMap &parameters)
 {
     if (address.isNull() || port == 0) {
-        warning() << "Attempted to export null TCP socket address or zero port, ignoring";
+        TP_QT_WARNING() << "Attempted to export null TCP socket address or zero port, ignoring";
         return;
     }
 
@@ -760,7 +762,7 @@ void StreamTubeServer::exportTcpSocket(
         const QVariantMap &parameters)
 {
     if (!server->isListening()) {
-        warning() << "Attempted to export non-listening QTcpServer, ignoring";
+        TP_QT_WARNING() << "Attempted to export non-listening QTcpServer, ignoring";
         return;
     }
 
@@ -796,7 +798,7 @@ void StreamTubeServer::exportTcpSocket(
         ParametersGenerator *generator)
 {
     if (address.isNull() || port == 0) {
-        warning() << "Attempted to export null TCP socket address or zero port, ignoring";
+        TP_QT_WARNING() << "Attempted to export null TCP socket address or zero port, ignoring";
         return;
     }
 
@@ -823,7 +825,7 @@ void StreamTubeServer::exportTcpSocket(
         ParametersGenerator *generator)
 {
     if (!server->isListening()) {
-        warning() << "Attempted to export non-listening QTcpServer, ignoring";
+        TP_QT_WARNING() << "Attempted to export non-listening QTcpServer, ignoring";
         return;
     }
 
@@ -880,7 +882,7 @@ QHash<QPair<QHostAddress, quint16>,
 {
     QHash<QPair<QHostAddress /* sourceAddress */, quint16 /* sourcePort */>, RemoteContact> conns;
     if (!monitorsConnections()) {
-        warning() << "StreamTubeServer::tcpConnections() used, but connection monitoring is disabled";
+        TP_QT_WARNING() << "StreamTubeServer::tcpConnections() used, but connection monitoring is disabled";
         return conns;
     }
 
@@ -936,14 +938,14 @@ void StreamTubeServer::onInvokedForTube(
     if (outgoing) {
         emit tubeRequested(acc, outgoing, time, hints);
     } else {
-        warning() << "The ChannelFactory used by StreamTubeServer must construct" <<
+        TP_QT_WARNING() << "The ChannelFactory used by StreamTubeServer must construct" <<
             "OutgoingStreamTubeChannel subclasses for Requested=true StreamTubes";
         tube->requestClose();
         return;
     }
 
     if (!mPriv->tubes.contains(tube)) {
-        debug().nospace() << "Offering socket " << mPriv->exportedAddr << ":" << mPriv->exportedPort
+        TP_QT_DEBUG().nospace() << "Offering socket " << mPriv->exportedAddr << ":" << mPriv->exportedPort
             << " on tube " << tube->objectPath();
 
         QVariantMap params;
@@ -983,7 +985,7 @@ void StreamTubeServer::onOfferFinished(
     OutgoingStreamTubeChannelPtr tube = wrapper->mTube;
 
     if (op->isError()) {
-        warning() << "Offer() failed, closing tube" << tube->objectPath() << '-' <<
+        TP_QT_WARNING() << "Offer() failed, closing tube" << tube->objectPath() << '-' <<
             op->errorName() << ':' << op->errorMessage();
 
         if (wrapper->mTube->isValid()) {
@@ -995,7 +997,7 @@ void StreamTubeServer::onOfferFinished(
         mPriv->tubes.remove(wrapper->mTube);
         wrapper->deleteLater();
     } else {
-        debug() << "Tube" << tube->objectPath() << "offered successfully";
+        TP_QT_DEBUG() << "Tube" << tube->objectPath() << "offered successfully";
     }
 }
 
@@ -1013,7 +1015,7 @@ void StreamTubeServer::onTubeInvalidated(
         return;
     }
 
-    debug() << "Tube" << tube->objectPath() << "invalidated with" << error << ':' << message;
+    TP_QT_DEBUG() << "Tube" << tube->objectPath() << "invalidated with" << error << ':' << message;
 
     emit tubeClosed(wrapper->mAcc, wrapper->mTube, error, message);
     mPriv->tubes.remove(tube);
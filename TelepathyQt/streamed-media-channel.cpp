@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/StreamedMediaChannel>
 
 #include "TelepathyQt/_gen/streamed-media-channel.moc.hpp"
@@ -119,11 +121,11 @@ StreamedMediaChannelPtr PendingStreamedMediaStreams::channel() const
 StreamedMediaStreams PendingStreamedMediaStreams::streams() const
 {
     if (!isFinished()) {
-        warning() << "PendingStreamedMediaStreams::streams called before finished, "
+        TP_QT_WARNING() << "PendingStreamedMediaStreams::streams called before finished, "
             "returning empty list";
         return StreamedMediaStreams();
     } else if (!isValid()) {
-        warning() << "PendingStreamedMediaStreams::streams called when not valid, "
+        TP_QT_WARNING() << "PendingStreamedMediaStreams::streams called when not valid, "
             "returning empty list";
         return StreamedMediaStreams();
     }
@@ -135,7 +137,7 @@ void PendingStreamedMediaStreams::gotStreams(QDBusPendingCallWatcher *watcher)
 {
     QDBusPendingReply<MediaStreamInfoList> reply = *watcher;
     if (reply.isError()) {
-        warning().nospace() << "StreamedMedia::RequestStreams()"
+        TP_QT_WARNING().nospace() << "StreamedMedia::RequestStreams()"
             " failed with " << reply.error().name() << ": " <<
             reply.error().message();
         setFinishedWithError(reply.error());
@@ -143,7 +145,7 @@ void PendingStreamedMediaStreams::gotStreams(QDBusPendingCallWatcher *watcher)
         return;
     }
 
-    debug() << "Got reply to StreamedMedia::RequestStreams()";
+    TP_QT_DEBUG() << "Got reply to StreamedMedia::RequestStreams()";
 
     MediaStreamInfoList list = reply.value();
     foreach (const MediaStreamInfo &streamInfo, list) {
@@ -194,11 +196,11 @@ void PendingStreamedMediaStreams::onStreamReady(PendingOperation *op)
     }
 
     mPriv->streamsReady++;
-    debug() << "PendingStreamedMediaStreams:";
-    debug() << "  Streams count:" << mPriv->numStreams;
-    debug() << "  Streams ready:" << mPriv->streamsReady;
+    TP_QT_DEBUG() << "PendingStreamedMediaStreams:";
+    TP_QT_DEBUG() << "  Streams count:" << mPriv->numStreams;
+    TP_QT_DEBUG() << "  Streams ready:" << mPriv->streamsReady;
     if (mPriv->streamsReady == mPriv->numStreams) {
-        debug() << "All streams are ready";
+        TP_QT_DEBUG() << "All streams are ready";
         setFinished();
     }
 }
@@ -256,17 +258,17 @@ StreamedMediaStream::Private::Private(StreamedMediaStream *parent,
 
 void StreamedMediaStream::Private::introspectContact(StreamedMediaStream::Private *self)
 {
-    debug() << "Introspecting stream";
+    TP_QT_DEBUG() << "Introspecting stream";
     if (self->contactHandle == 0) {
-        debug() << "Stream ready";
+        TP_QT_DEBUG() << "Stream ready";
         self->readinessHelper->setIntrospectCompleted(FeatureCore, true);
         return;
     }
 
-    debug() << "Introspecting stream contact";
+    TP_QT_DEBUG() << "Introspecting stream contact";
     ContactManagerPtr contactManager =
         self->parent->channel()->connection()->contactManager();
-    debug() << "contact manager" << contactManager;
+    TP_QT_DEBUG() << "contact manager" << contactManager;
     // TODO: pass id hints to ContactManager if we ever gain support to retrieve contact ids
     //       from MediaStreamInfo or something similar.
     self->parent->connect(contactManager->contactsForHandles(
@@ -531,7 +533,7 @@ PendingOperation *StreamedMediaStream::startDTMFTone(DTMFEvent event)
 {
     StreamedMediaChannelPtr chan(channel());
     if (!chan->interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_DTMF)) {
-        warning() << "StreamedMediaStream::startDTMFTone() used with no dtmf interface";
+        TP_QT_WARNING() << "StreamedMediaStream::startDTMFTone() used with no dtmf interface";
         return new PendingFailure(TP_QT_ERROR_NOT_IMPLEMENTED,
                 QLatin1String("StreamedMediaChannel does not support dtmf interface"),
                 StreamedMediaStreamPtr(this));
@@ -566,7 +568,7 @@ PendingOperation *StreamedMediaStream::stopDTMFTone()
 {
     StreamedMediaChannelPtr chan(channel());
     if (!chan->interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_DTMF)) {
-        warning() << "StreamedMediaStream::stopDTMFTone() used with no dtmf interface";
+        TP_QT_WARNING() << "StreamedMediaStream::stopDTMFTone() used with no dtmf interface";
         return new PendingFailure(TP_QT_ERROR_NOT_IMPLEMENTED,
                 QLatin1String("StreamedMediaChannel does not support dtmf interface"),
                 StreamedMediaStreamPtr(this));
@@ -679,7 +681,7 @@ void StreamedMediaStream::gotContact(PendingOperation *op)
     Q_ASSERT(pc->isForHandles());
 
     if (op->isError()) {
-        warning().nospace() << "Gathering media stream contact failed: "
+        TP_QT_WARNING().nospace() << "Gathering media stream contact failed: "
             << op->errorName() << ": " << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, false,
                 op->errorName(), op->errorMessage());
@@ -693,12 +695,12 @@ void StreamedMediaStream::gotContact(PendingOperation *op)
         Q_ASSERT(invalidHandles.size() == 0);
         mPriv->contact = contacts.first();
 
-        debug() << "Got stream contact";
-        debug() << "Stream ready";
+        TP_QT_DEBUG() << "Got stream contact";
+        TP_QT_DEBUG() << "Stream ready";
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, true);
     } else {
         Q_ASSERT(invalidHandles.size() == 1);
-        warning().nospace() << "Error retrieving media stream contact (invalid handle)";
+        TP_QT_WARNING().nospace() << "Error retrieving media stream contact (invalid handle)";
         mPriv->readinessHelper->setIntrospectCompleted(FeatureCore, false,
                 TP_QT_ERROR_INVALID_ARGUMENT,
                 QLatin1String("Invalid contact handle"));
@@ -990,7 +992,7 @@ bool StreamedMediaChannel::awaitingLocalAnswer() const
  */
 bool StreamedMediaChannel::awaitingRemoteAnswer() const
 {
-    return !groupRemotePendingContacts().isEmpty();
+    return !groupRemotePendingMemberHandles().isEmpty();
 }
 
 /**
@@ -1149,9 +1151,9 @@ bool StreamedMediaChannel::handlerStreamingRequired() const
 LocalHoldState StreamedMediaChannel::localHoldState() const
 {
     if (!isReady(FeatureLocalHoldState)) {
-        warning() << "StreamedMediaChannel::localHoldState() used with FeatureLocalHoldState not ready";
+        TP_QT_WARNING() << "StreamedMediaChannel::localHoldState() used with FeatureLocalHoldState not ready";
     } else if (!interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_HOLD)) {
-        warning() << "StreamedMediaChannel::localHoldStateReason() used with no hold interface";
+        TP_QT_WARNING() << "StreamedMediaChannel::localHoldStateReason() used with no hold interface";
     }
 
     return mPriv->localHoldState;
@@ -1168,9 +1170,9 @@ LocalHoldState StreamedMediaChannel::localHoldState() const
 LocalHoldStateReason StreamedMediaChannel::localHoldStateReason() const
 {
     if (!isReady(FeatureLocalHoldState)) {
-        warning() << "StreamedMediaChannel::localHoldStateReason() used with FeatureLocalHoldState not ready";
+        TP_QT_WARNING() << "StreamedMediaChannel::localHoldStateReason() used with FeatureLocalHoldState not ready";
     } else if (!interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_HOLD)) {
-        warning() << "StreamedMediaChannel::localHoldStateReason() used with no hold interface";
+        TP_QT_WARNING() << "StreamedMediaChannel::localHoldStateReason() used with no hold interface";
     }
 
     return mPriv->localHoldStateReason;
@@ -1211,7 +1213,7 @@ LocalHoldStateReason StreamedMediaChannel::localHoldStateReason() const
 PendingOperation *StreamedMediaChannel::requestHold(bool hold)
 {
     if (!interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_HOLD)) {
-        warning() << "StreamedMediaChannel::requestHold() used with no hold interface";
+        TP_QT_WARNING() << "StreamedMediaChannel::requestHold() used with no hold interface";
         return new PendingFailure(TP_QT_ERROR_NOT_IMPLEMENTED,
                 QLatin1String("StreamedMediaChannel does not support hold interface"),
                 StreamedMediaChannelPtr(this));
@@ -1325,7 +1327,7 @@ void StreamedMediaChannel::gotStreams(QDBusPendingCallWatcher *watcher)
 {
     QDBusPendingReply<MediaStreamInfoList> reply = *watcher;
     if (reply.isError()) {
-        warning().nospace() << "StreamedMedia.ListStreams failed with" <<
+        TP_QT_WARNING().nospace() << "StreamedMedia.ListStreams failed with" <<
             reply.error().name() << ": " << reply.error().message();
 
         mPriv->readinessHelper->setIntrospectCompleted(FeatureStreams,
@@ -1334,7 +1336,7 @@ void StreamedMediaChannel::gotStreams(QDBusPendingCallWatcher *watcher)
         return;
     }
 
-    debug() << "Got reply to StreamedMedia::ListStreams()";
+    TP_QT_DEBUG() << "Got reply to StreamedMedia::ListStreams()";
 
     MediaStreamInfoList streamInfoList = reply.value();
     if (streamInfoList.size() > 0) {
@@ -1361,7 +1363,7 @@ void StreamedMediaChannel::onStreamAdded(uint streamId,
         uint contactHandle, uint streamType)
 {
     if (lookupStreamById(streamId)) {
-        debug() << "Received StreamedMedia.StreamAdded for an existing "
+        TP_QT_DEBUG() << "Received StreamedMedia.StreamAdded for an existing "
             "stream, ignoring";
         return;
     }
@@ -1379,7 +1381,7 @@ void StreamedMediaChannel::onStreamAdded(uint streamId,
 
 void StreamedMediaChannel::onStreamRemoved(uint streamId)
 {
-    debug() << "Received StreamedMedia.StreamRemoved for stream" <<
+    TP_QT_DEBUG() << "Received StreamedMedia.StreamRemoved for stream" <<
         streamId;
 
     StreamedMediaStreamPtr stream = lookupStreamById(streamId);
@@ -1408,7 +1410,7 @@ void StreamedMediaChannel::onStreamRemoved(uint streamId)
 void StreamedMediaChannel::onStreamDirectionChanged(uint streamId,
         uint streamDirection, uint streamPendingFlags)
 {
-    debug() << "Received StreamedMedia.StreamDirectionChanged for stream" <<
+    TP_QT_DEBUG() << "Received StreamedMedia.StreamDirectionChanged for stream" <<
         streamId << "with direction changed to" << streamDirection;
 
     StreamedMediaStreamPtr stream = lookupStreamById(streamId);
@@ -1432,7 +1434,7 @@ void StreamedMediaChannel::onStreamDirectionChanged(uint streamId,
 void StreamedMediaChannel::onStreamStateChanged(uint streamId,
         uint streamState)
 {
-    debug() << "Received StreamedMedia.StreamStateChanged for stream" <<
+    TP_QT_DEBUG() << "Received StreamedMedia.StreamStateChanged for stream" <<
         streamId << "with state changed to" << streamState;
 
     StreamedMediaStreamPtr stream = lookupStreamById(streamId);
@@ -1452,7 +1454,7 @@ void StreamedMediaChannel::onStreamStateChanged(uint streamId,
 void StreamedMediaChannel::onStreamError(uint streamId,
         uint errorCode, const QString &errorMessage)
 {
-    debug() << "Received StreamedMedia.StreamError for stream" <<
+    TP_QT_DEBUG() << "Received StreamedMedia.StreamError for stream" <<
         streamId << "with error code" << errorCode <<
         "and message:" << errorMessage;
 
@@ -1468,11 +1470,11 @@ void StreamedMediaChannel::gotLocalHoldState(QDBusPendingCallWatcher *watcher)
 {
     QDBusPendingReply<uint, uint> reply = *watcher;
     if (reply.isError()) {
-        warning().nospace() << "StreamedMedia::Hold::GetHoldState()"
+        TP_QT_WARNING().nospace() << "StreamedMedia::Hold::GetHoldState()"
             " failed with " << reply.error().name() << ": " <<
             reply.error().message();
 
-        debug() << "Ignoring error getting hold state and assuming we're not "
+        TP_QT_DEBUG() << "Ignoring error getting hold state and assuming we're not "
             "on hold";
         onLocalHoldStateChanged(mPriv->localHoldState,
                 mPriv->localHoldStateReason);
@@ -1480,7 +1482,7 @@ void StreamedMediaChannel::gotLocalHoldState(QDBusPendingCallWatcher *watcher)
         return;
     }
 
-    debug() << "Got reply to StreamedMedia::Hold::GetHoldState()";
+    TP_QT_DEBUG() << "Got reply to StreamedMedia::Hold::GetHoldState()";
     onLocalHoldStateChanged(reply.argumentAt<0>(), reply.argumentAt<1>());
     watcher->deleteLater();
 }
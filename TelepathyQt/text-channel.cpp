@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/TextChannel>
 
 #include "TelepathyQt/_gen/text-channel.moc.hpp"
@@ -301,7 +303,7 @@ void TextChannel::Private::updateInitialMessages()
     MessagePartListList messages = qdbus_cast<MessagePartListList>(
             props[QLatin1String("PendingMessages")]);
     if (messages.isEmpty()) {
-        debug() << "Message queue empty: FeatureMessageQueue is now ready";
+        TP_QT_DEBUG() << "Message queue empty: FeatureMessageQueue is now ready";
         readinessHelper->setIntrospectCompleted(FeatureMessageQueue, true);
     } else {
         foreach (const MessagePartList &message, messages) {
@@ -344,9 +346,10 @@ void TextChannel::Private::processMessageQueue()
     // and message-removal events; message IDs aren't necessarily globally
     // unique, so we need to process them in the correct order relative
     // to incoming messages
+    QList<ReceivedMessage> received;
     while (!incompleteMessages.isEmpty()) {
         const MessageEvent *e = incompleteMessages.first();
-        debug() << "MessageEvent:" << reinterpret_cast<const void *>(e);
+        TP_QT_DEBUG() << "MessageEvent:" << reinterpret_cast<const void *>(e);
 
         if (e->isMessage) {
             if (e->message.senderHandle() != 0 &&
@@ -358,10 +361,18 @@ void TextChannel::Private::processMessageQueue()
             }
 
             // if we reach here, the message is ready
-            debug() << "Message is usable, copying to main queue";
+            TP_QT_DEBUG() << "Message is usable, copying to main queue";
             messages << e->message;
+            received << e->message;
             emit parent->messageReceived(e->message);
         } else {
+            // deliver the batch so far first, so removals are still signalled after the
+            // corresponding messages
+            if (!received.isEmpty()) {
+                emit parent->messagesReceived(received);
+                received.clear();
+            }
+
             // forget about the message(s) with ID e->removed (there should be
             // at most one under normal circumstances)
             int i = 0;
@@ -376,14 +387,18 @@ void TextChannel::Private::processMessageQueue()
             }
         }
 
-        debug() << "Dropping first event";
+        TP_QT_DEBUG() << "Dropping first event";
         delete incompleteMessages.takeFirst();
     }
 
+    if (!received.isEmpty()) {
+        emit parent->messagesReceived(received);
+    }
+
     if (incompleteMessages.isEmpty()) {
         if (readinessHelper->requestedFeatures().contains(FeatureMessageQueue) &&
             !readinessHelper->isReady(Features() << FeatureMessageQueue)) {
-            debug() << "incompleteMessages empty for the first time: "
+            TP_QT_DEBUG() << "incompleteMessages empty for the first time: "
                 "FeatureMessageQueue is now ready";
             readinessHelper->setIntrospectCompleted(FeatureMessageQueue, true);
         }
@@ -422,7 +437,7 @@ void TextChannel::Private::processChatStateQueue()
 {
     while (!chatStateQueue.isEmpty()) {
         const ChatStateEvent *e = chatStateQueue.first();
-        debug() << "ChatStateEvent:" << reinterpret_cast<const void *>(e);
+        TP_QT_DEBUG() << "ChatStateEvent:" << reinterpret_cast<const void *>(e);
 
         if (e->contact.isNull()) {
             // the chat state Contact object wasn't retrieved yet, but needs
@@ -436,7 +451,7 @@ void TextChannel::Private::processChatStateQueue()
         // if we reach here, the Contact object is ready
         emit parent->chatStateChanged(e->contact, (ChannelChatState) e->state);
 
-        debug() << "Dropping first event";
+        TP_QT_DEBUG() << "Dropping first event";
         delete chatStateQueue.takeFirst();
     }
 
@@ -595,6 +610,22 @@ const Feature TextChannel::FeatureChatState = Feature(QLatin1String(TextChannel:
  * \sa messageQueue(), acknowledge(), forget()
  */
 
+/**
+ * \fn void TextChannel::messagesReceived(const QList<Tp::ReceivedMessage> &messages)
+ *
+ * Emitted once for all the messages added to messageQueue() at the same time,
+ * if the TextChannel::FeatureMessageQueue Feature has been enabled.
+ *
+ * This carries the same messages as messageReceived(), which is still emitted
+ * for each of them beforehand, and is more efficient for clients which handle
+ * messages in bulk, such as loggers. Messages are only grouped until the next
+ * pendingMessageRemoved() signal, so that signal is always emitted after the
+ * batch containing the removed message.
+ *
+ * \param messages The messages received, in the order they were received.
+ * \sa messageQueue(), messageReceived()
+ */
+
 /**
  * \fn void TextChannel::pendingMessageRemoved(
  *      const Tp::ReceivedMessage &message)
@@ -745,7 +776,7 @@ QStringList TextChannel::supportedContentTypes() const
 QList<ChannelTextMessageType> TextChannel::supportedMessageTypes() const
 {
     if (!isReady(FeatureMessageCapabilities)) {
-        warning() << "TextChannel::supportedMessageTypes() used with "
+        TP_QT_WARNING() << "TextChannel::supportedMessageTypes() used with "
                 "FeatureMessageCapabilities not ready";
     }
 
@@ -763,7 +794,7 @@ QList<ChannelTextMessageType> TextChannel::supportedMessageTypes() const
 bool TextChannel::supportsMessageType(ChannelTextMessageType messageType) const
 {
     if (!isReady(FeatureMessageCapabilities)) {
-        warning() << "TextChannel::supportsMessageType() used with "
+        TP_QT_WARNING() << "TextChannel::supportsMessageType() used with "
                 "FeatureMessageCapabilities not ready";
     }
 
@@ -841,7 +872,7 @@ QList<ReceivedMessage> TextChannel::messageQueue() const
 ChannelChatState TextChannel::chatState(const ContactPtr &contact) const
 {
     if (!isReady(FeatureChatState)) {
-        warning() << "TextChannel::chatState() used with "
+        TP_QT_WARNING() << "TextChannel::chatState() used with "
             "FeatureChatState not ready";
         return ChannelChatStateInactive;
     }
@@ -861,7 +892,7 @@ void TextChannel::onAcknowledgePendingMessagesReply(
     if (reply.isError()) {
         // One of the IDs was bad, and we can't know which one. Recover by
         // doing as much as possible, and hope for the best...
-        debug() << "Recovering from AcknowledgePendingMessages failure for: "
+        TP_QT_DEBUG() << "Recovering from AcknowledgePendingMessages failure for: "
             << ids;
         foreach (uint id, ids) {
             mPriv->textInterface->AcknowledgePendingMessages(UIntList() << id);
@@ -896,7 +927,7 @@ void TextChannel::acknowledge(const QList<ReceivedMessage> &messages)
         if (m.isFromChannel(TextChannelPtr(this))) {
             ids << m.pendingId();
         } else {
-            warning() << "message did not come from this channel, ignoring";
+            TP_QT_WARNING() << "message did not come from this channel, ignoring";
         }
     }
 
@@ -935,7 +966,7 @@ void TextChannel::forget(const QList<ReceivedMessage> &messages)
 {
     foreach (const ReceivedMessage &m, messages) {
         if (!m.isFromChannel(TextChannelPtr(this))) {
-            warning() << "message did not come from this channel, ignoring";
+            TP_QT_WARNING() << "message did not come from this channel, ignoring";
         } else if (mPriv->messages.removeOne(m)) {
             emit pendingMessageRemoved(m);
         }
@@ -1049,7 +1080,7 @@ PendingSendMessage *TextChannel::send(const MessagePartList &parts,
 PendingOperation *TextChannel::requestChatState(ChannelChatState state)
 {
     if (!interfaces().contains(TP_QT_IFACE_CHANNEL_INTERFACE_CHAT_STATE)) {
-        warning() << "TextChannel::requestChatState() used with no chat "
+        TP_QT_WARNING() << "TextChannel::requestChatState() used with no chat "
             "state interface";
         return new PendingFailure(TP_QT_ERROR_NOT_IMPLEMENTED,
                 QLatin1String("TextChannel does not support chat state interface"),
@@ -1082,7 +1113,7 @@ void TextChannel::onContactsFinished(PendingOperation *op)
     }
 
     if (pc->isError()) {
-        warning().nospace() << "Gathering contacts failed: "
+        TP_QT_WARNING().nospace() << "Gathering contacts failed: "
             << pc->errorName() << ": " << pc->errorMessage();
         foreach (uint handle, pc->handles()) {
             mPriv->contactLost(handle);
@@ -1259,7 +1290,7 @@ void TextChannel::gotProperties(QDBusPendingCallWatcher *watcher)
 
     QDBusPendingReply<QVariantMap> reply = *watcher;
     if (reply.isError()) {
-        warning().nospace() << "Properties::GetAll(Channel.Interface.Messages)"
+        TP_QT_WARNING().nospace() << "Properties::GetAll(Channel.Interface.Messages)"
             " failed with " << reply.error().name() << ": " <<
             reply.error().message();
 
@@ -1276,7 +1307,7 @@ void TextChannel::gotProperties(QDBusPendingCallWatcher *watcher)
         return;
     }
 
-    debug() << "Properties::GetAll(Channel.Interface.Messages) returned";
+    TP_QT_DEBUG() << "Properties::GetAll(Channel.Interface.Messages) returned";
     mPriv->props = reply.value();
 
     mPriv->updateInitialMessages();
@@ -1292,7 +1323,7 @@ void TextChannel::gotPendingMessages(QDBusPendingCallWatcher *watcher)
 
     QDBusPendingReply<PendingTextMessageList> reply = *watcher;
     if (reply.isError()) {
-        warning().nospace() << "Properties::GetAll(Channel.Interface.Messages)"
+        TP_QT_WARNING().nospace() << "Properties::GetAll(Channel.Interface.Messages)"
             " failed with " << reply.error().name() << ": " <<
             reply.error().message();
 
@@ -1301,7 +1332,7 @@ void TextChannel::gotPendingMessages(QDBusPendingCallWatcher *watcher)
         return;
     }
 
-    debug() << "Text::ListPendingMessages returned";
+    TP_QT_DEBUG() << "Text::ListPendingMessages returned";
     PendingTextMessageList list = reply.value();
 
     if (!list.isEmpty()) {
@@ -100,6 +100,7 @@ Q_SIGNALS:
 
     // FeatureMessageQueue
     void messageReceived(const Tp::ReceivedMessage &message);
+    void messagesReceived(const QList<Tp::ReceivedMessage> &messages);
     void pendingMessageRemoved(
             const Tp::ReceivedMessage &message);
 
@@ -19,6 +19,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryChannels
+
 #include <TelepathyQt/TubeChannel>
 
 #include "TelepathyQt/_gen/tube-channel.moc.hpp"
@@ -70,7 +72,7 @@ void TubeChannel::Private::introspectTube(TubeChannel::Private *self)
 {
     TubeChannel *parent = self->parent;
 
-    debug() << "Introspecting tube properties";
+    TP_QT_DEBUG() << "Introspecting tube properties";
     Client::ChannelInterfaceTubeInterface *tubeInterface =
             parent->interface<Client::ChannelInterfaceTubeInterface>();
 
@@ -175,7 +177,7 @@ TubeChannel::~TubeChannel()
 QVariantMap TubeChannel::parameters() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "TubeChannel::parameters() used with FeatureCore not ready";
+        TP_QT_WARNING() << "TubeChannel::parameters() used with FeatureCore not ready";
         return QVariantMap();
     }
 
@@ -195,7 +197,7 @@ QVariantMap TubeChannel::parameters() const
 TubeChannelState TubeChannel::state() const
 {
     if (!isReady(FeatureCore)) {
-        warning() << "TubeChannel::state() used with FeatureCore not ready";
+        TP_QT_WARNING() << "TubeChannel::state() used with FeatureCore not ready";
         return TubeChannelStateNotOffered;
     }
 
@@ -215,7 +217,7 @@ void TubeChannel::onTubeChannelStateChanged(uint newState)
 
     uint oldState = mPriv->state;
 
-    debug() << "Tube state changed to" << newState;
+    TP_QT_DEBUG() << "Tube state changed to" << newState;
     mPriv->state = (Tp::TubeChannelState) newState;
 
     /* only emit stateChanged if we already received the state from initial introspection */
@@ -231,10 +233,10 @@ void TubeChannel::gotTubeProperties(PendingOperation *op)
 
         mPriv->extractTubeProperties(pvm->result());
 
-        debug() << "Got reply to Properties::GetAll(TubeChannel)";
+        TP_QT_DEBUG() << "Got reply to Properties::GetAll(TubeChannel)";
         mPriv->readinessHelper->setIntrospectCompleted(TubeChannel::FeatureCore, true);
     } else {
-        warning().nospace() << "Properties::GetAll(TubeChannel) failed "
+        TP_QT_WARNING().nospace() << "Properties::GetAll(TubeChannel) failed "
             "with " << op->errorName() << ": " << op->errorMessage();
         mPriv->readinessHelper->setIntrospectCompleted(TubeChannel::FeatureCore, false,
                 op->errorName(), op->errorMessage());
@@ -102,6 +102,17 @@
 #       and optional argument a set of additional libraries the target will link to. Please remember that you need to
 #       set up the DBus environment by calling TPQT_SETUP_DBUS_TEST_ENVIRONMENT BEFORE you call this macro.
 #
+# macro TPQT_ADD_DBUS_BENCHMARK (fancyName name [libraries ...])
+#       This macro takes care of building a QtTest benchmark requiring DBus emulation, contained in a single source
+#       file named ${name}.cpp. As benchmarks report timings rather than a pass or fail result, they are not added
+#       to the CTest suite: instead, a benchmark-${fancyName} target runs the benchmark on a private session bus, and
+#       is added to the "benchmark" target, which must exist. As for TPQT_ADD_DBUS_UNIT_TEST, the DBus environment
+#       must have been set up with TPQT_SETUP_DBUS_TEST_ENVIRONMENT before.
+#
+# macro TPQT_ADD_GENERIC_BENCHMARK (fancyName name [libraries ...])
+#       Same as TPQT_ADD_DBUS_BENCHMARK, for benchmarks which do not need DBus: the benchmark-${fancyName} target
+#       runs the benchmark directly.
+#
 # macro _TPQT_ADD_CHECK_TARGETS (fancyName name command [args])
 #       This is an internal macro which is meant to be used by TPQT_ADD_DBUS_UNIT_TEST and TPQT_ADD_GENERIC_UNIT_TEST.
 #       It takes care of generating a check target for each test method available (currently normal execution, valgrind and
@@ -430,6 +441,24 @@ macro(tpqt_add_dbus_unit_test _fancyName _name)
     _tpqt_add_check_targets(${_fancyName} ${_name} ${with_session_bus} ${CMAKE_CURRENT_BINARY_DIR}/test-${_name})
 endmacro()
 
+macro(tpqt_add_dbus_benchmark _fancyName _name)
+    tpqt_generate_moc_i(${_name}.cpp ${CMAKE_CURRENT_BINARY_DIR}/_gen/${_name}.cpp.moc.hpp)
+    add_executable(benchmark-${_name} ${_name}.cpp ${CMAKE_CURRENT_BINARY_DIR}/_gen/${_name}.cpp.moc.hpp)
+    target_link_libraries(benchmark-${_name} ${QT_QTCORE_LIBRARY} ${QT_QTDBUS_LIBRARY} ${QT_QTNETWORK_LIBRARY} ${QT_QTXML_LIBRARY} ${QT_QTTEST_LIBRARY} telepathy-qt${QT_VERSION_MAJOR} tp-qt-tests ${TP_QT_EXECUTABLE_LINKER_FLAGS} ${ARGN})
+    add_custom_target(benchmark-${_fancyName} ${SH} ${CMAKE_CURRENT_BINARY_DIR}/runDbusTest.sh ${CMAKE_CURRENT_BINARY_DIR}/benchmark-${_name})
+    add_dependencies(benchmark-${_fancyName} benchmark-${_name})
+    add_dependencies(benchmark benchmark-${_fancyName})
+endmacro()
+
+macro(tpqt_add_generic_benchmark _fancyName _name)
+    tpqt_generate_moc_i(${_name}.cpp ${CMAKE_CURRENT_BINARY_DIR}/_gen/${_name}.cpp.moc.hpp)
+    add_executable(benchmark-${_name} ${_name}.cpp ${CMAKE_CURRENT_BINARY_DIR}/_gen/${_name}.cpp.moc.hpp)
+    target_link_libraries(benchmark-${_name} ${QT_QTCORE_LIBRARY} ${QT_QTTEST_LIBRARY} telepathy-qt${QT_VERSION_MAJOR} ${TP_QT_EXECUTABLE_LINKER_FLAGS} ${ARGN})
+    add_custom_target(benchmark-${_fancyName} ${CMAKE_CURRENT_BINARY_DIR}/benchmark-${_name})
+    add_dependencies(benchmark-${_fancyName} benchmark-${_name})
+    add_dependencies(benchmark benchmark-${_fancyName})
+endmacro()
+
 macro(_tpqt_add_check_targets _fancyName _name _runnerScript)
     set_tests_properties(${_fancyName}
         PROPERTIES
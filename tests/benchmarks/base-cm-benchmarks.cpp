@@ -0,0 +1,683 @@
+#include <tests/lib/test.h>
+
+#define TP_QT_ENABLE_LOWLEVEL_API
+
+#include <TelepathyQt/BaseConnectionManager>
+#include <TelepathyQt/BaseProtocol>
+#include <TelepathyQt/BaseConnection>
+#include <TelepathyQt/BaseChannel>
+#include <TelepathyQt/IODevice>
+
+#include <TelepathyQt/ChannelFactory>
+#include <TelepathyQt/Connection>
+#include <TelepathyQt/ConnectionLowlevel>
+#include <TelepathyQt/ConnectionManager>
+#include <TelepathyQt/ConnectionManagerLowlevel>
+#include <TelepathyQt/Contact>
+#include <TelepathyQt/ContactFactory>
+#include <TelepathyQt/ContactManager>
+#include <TelepathyQt/Debug>
+#include <TelepathyQt/FileTransferChannelCreationProperties>
+#include <TelepathyQt/OutgoingFileTransferChannel>
+#include <TelepathyQt/PendingChannel>
+#include <TelepathyQt/PendingConnection>
+#include <TelepathyQt/PendingReady>
+#include <TelepathyQt/ReceivedMessage>
+#include <TelepathyQt/TextChannel>
+
+// Benchmarks of the client side classes against an in-process connection manager
+// built from the service side Base* classes, so that they run offline on the
+// private bus set up by tools/with-session-bus.sh and do not depend on the
+// timing of a real CM. Each benchmark only measures what happens inside
+// QBENCHMARK, with the service side state prepared beforehand.
+
+static Tp::RequestableChannelClass createRequestableChannelClass(const QString &channelType)
+{
+    Tp::RequestableChannelClass rcc;
+    rcc.fixedProperties[TP_QT_IFACE_CHANNEL + QLatin1String(".ChannelType")] = channelType;
+    rcc.fixedProperties[TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandleType")] = Tp::HandleTypeContact;
+    rcc.allowedProperties.append(TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandle"));
+    rcc.allowedProperties.append(TP_QT_IFACE_CHANNEL + QLatin1String(".TargetID"));
+    if (channelType == TP_QT_IFACE_CHANNEL_TYPE_FILE_TRANSFER) {
+        rcc.allowedProperties.append(TP_QT_IFACE_CHANNEL_TYPE_FILE_TRANSFER + QLatin1String(".ContentType"));
+        rcc.allowedProperties.append(TP_QT_IFACE_CHANNEL_TYPE_FILE_TRANSFER + QLatin1String(".Filename"));
+        rcc.allowedProperties.append(TP_QT_IFACE_CHANNEL_TYPE_FILE_TRANSFER + QLatin1String(".Size"));
+    }
+    return rcc;
+}
+
+static Tp::MessagePartList createMessage(uint sender, const QString &senderID, int serial)
+{
+    Tp::MessagePart header;
+    header[QLatin1String("message-token")] = QDBusVariant(QString::number(serial));
+    header[QLatin1String("message-sender")] = QDBusVariant(sender);
+    header[QLatin1String("message-sender-id")] = QDBusVariant(senderID);
+    header[QLatin1String("message-type")] = QDBusVariant(uint(Tp::ChannelTextMessageTypeNormal));
+
+    Tp::MessagePart body;
+    body[QLatin1String("content-type")] = QDBusVariant(QString(QLatin1String("text/plain")));
+    body[QLatin1String("content")] = QDBusVariant(
+            QString(QLatin1String("Benchmark message number %1")).arg(serial));
+
+    return Tp::MessagePartList() << header << body;
+}
+
+namespace BenchmarkCM // The namespace is needed to avoid class name collisions with other tests and examples
+{
+
+class Connection;
+typedef Tp::SharedPtr<Connection> ConnectionPtr;
+
+static const QString selfID(QLatin1String("self@benchmark"));
+
+class Connection : public Tp::BaseConnection
+{
+    Q_OBJECT
+public:
+    Connection(const QDBusConnection &dbusConnection,
+            const QString &cmName, const QString &protocolName,
+            const QVariantMap &parameters)
+        : Tp::BaseConnection(dbusConnection, cmName, protocolName, parameters),
+          mRosterSize(0)
+    {
+        /* Connection.Interface.Contacts */
+        mContactsIface = Tp::BaseConnectionContactsInterface::create();
+        mContactsIface->setGetContactAttributesCallback(Tp::memFun(this, &Connection::getContactAttributes));
+        mContactsIface->setContactAttributeInterfaces(QStringList()
+                << TP_QT_IFACE_CONNECTION
+                << TP_QT_IFACE_CONNECTION_INTERFACE_CONTACT_LIST
+                << TP_QT_IFACE_CONNECTION_INTERFACE_SIMPLE_PRESENCE);
+        plugInterface(Tp::AbstractConnectionInterfacePtr::dynamicCast(mContactsIface));
+
+        /* Connection.Interface.SimplePresence */
+        Tp::SimpleStatusSpec available;
+        available.type = Tp::ConnectionPresenceTypeAvailable;
+        available.maySetOnSelf = true;
+        available.canHaveMessage = true;
+        Tp::SimpleStatusSpec away;
+        away.type = Tp::ConnectionPresenceTypeAway;
+        away.maySetOnSelf = true;
+        away.canHaveMessage = true;
+        Tp::SimpleStatusSpecMap statuses;
+        statuses.insert(QLatin1String("available"), available);
+        statuses.insert(QLatin1String("away"), away);
+
+        mSimplePresenceIface = Tp::BaseConnectionSimplePresenceInterface::create();
+        mSimplePresenceIface->setStatuses(statuses);
+        plugInterface(Tp::AbstractConnectionInterfacePtr::dynamicCast(mSimplePresenceIface));
+
+        /* Connection.Interface.ContactList */
+        mContactListIface = Tp::BaseConnectionContactListInterface::create();
+        mContactListIface->setGetContactListAttributesCallback(Tp::memFun(this, &Connection::getContactListAttributes));
+        plugInterface(Tp::AbstractConnectionInterfacePtr::dynamicCast(mContactListIface));
+
+        /* Connection.Interface.Requests */
+        mRequestsIface = Tp::BaseConnectionRequestsInterface::create(this);
+        mRequestsIface->requestableChannelClasses
+            << createRequestableChannelClass(TP_QT_IFACE_CHANNEL_TYPE_TEXT)
+            << createRequestableChannelClass(TP_QT_IFACE_CHANNEL_TYPE_FILE_TRANSFER);
+        plugInterface(Tp::AbstractConnectionInterfacePtr::dynamicCast(mRequestsIface));
+
+        setConnectCallback(Tp::memFun(this, &Connection::connectCB));
+        setCreateChannelCallback(Tp::memFun(this, &Connection::createChannelCB));
+
+        // Handles come from the built-in repository of BaseConnection
+        setSelfContact(ensureHandle(Tp::HandleTypeContact, selfID), selfID);
+    }
+    ~Connection() override { }
+
+    Tp::BaseConnectionSimplePresenceInterfacePtr simplePresenceInterface() const
+    {
+        return mSimplePresenceIface;
+    }
+
+    Tp::UIntList roster() const
+    {
+        return mRoster.mid(0, mRosterSize);
+    }
+
+    void setRosterSize(int size)
+    {
+        while (mRoster.size() < size) {
+            mRoster << ensureHandle(Tp::HandleTypeContact,
+                    QString(QLatin1String("contact%1@benchmark")).arg(mRoster.size()));
+        }
+        mRosterSize = size;
+        mRosterHandles = roster().toSet();
+    }
+
+    Tp::BaseChannelPtr lastChannel() const
+    {
+        return mLastChannel;
+    }
+
+    Tp::BaseChannelPtr createTextChannel(uint targetHandleType, uint targetHandle)
+    {
+        Tp::BaseChannelPtr channel = Tp::BaseChannel::create(this, TP_QT_IFACE_CHANNEL_TYPE_TEXT,
+                Tp::HandleType(targetHandleType), targetHandle);
+        channel->setTargetID(handleIdentifier(targetHandleType, targetHandle));
+
+        Tp::BaseChannelTextTypePtr textType = Tp::BaseChannelTextType::create(channel.data());
+        channel->plugInterface(Tp::AbstractChannelInterfacePtr::dynamicCast(textType));
+
+        Tp::BaseChannelMessagesInterfacePtr messages = Tp::BaseChannelMessagesInterface::create(
+                textType.data(),
+                QStringList() << QLatin1String("text/plain"),
+                Tp::UIntList() << Tp::ChannelTextMessageTypeNormal,
+                0, 0);
+        channel->plugInterface(Tp::AbstractChannelInterfacePtr::dynamicCast(messages));
+
+        return channel;
+    }
+
+    Tp::BaseChannelPtr joinRoom(const QString &name, int memberCount)
+    {
+        uint roomHandle = ensureHandle(Tp::HandleTypeRoom, name);
+        Tp::BaseChannelPtr channel = createTextChannel(Tp::HandleTypeRoom, roomHandle);
+
+        Tp::BaseChannelGroupInterfacePtr group = Tp::BaseChannelGroupInterface::create();
+        channel->plugInterface(Tp::AbstractChannelInterfacePtr::dynamicCast(group));
+
+        Tp::UIntList members;
+        members << selfHandle();
+        for (int i = 0; i < memberCount; ++i) {
+            members << ensureHandle(Tp::HandleTypeContact,
+                    QString(QLatin1String("member%1@%2")).arg(i).arg(name));
+        }
+        group->setSelfHandle(selfHandle());
+        group->setMembers(members, QVariantMap());
+
+        return registerChannel(channel);
+    }
+
+    Tp::BaseChannelPtr registerChannel(const Tp::BaseChannelPtr &channel)
+    {
+        Tp::DBusError error;
+        channel->registerObject(&error);
+        if (error.isValid()) {
+            qWarning() << "Unable to register channel:" << error.message();
+            return Tp::BaseChannelPtr();
+        }
+
+        addChannel(channel);
+        return channel;
+    }
+
+protected:
+    void connectCB(Tp::DBusError *error)
+    {
+        Q_UNUSED(error)
+        mContactListIface->setContactListState(Tp::ContactListStateSuccess);
+        setStatus(Tp::ConnectionStatusConnected, Tp::ConnectionStatusReasonRequested);
+    }
+
+    Tp::BaseChannelPtr createChannelCB(const QVariantMap &request, Tp::DBusError *error)
+    {
+        const QString channelType = request.value(TP_QT_IFACE_CHANNEL + QLatin1String(".ChannelType")).toString();
+        uint targetHandleType = request.value(TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandleType")).toUInt();
+        uint targetHandle = request.value(TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandle")).toUInt();
+
+        if (targetHandleType != Tp::HandleTypeContact) {
+            error->set(TP_QT_ERROR_INVALID_ARGUMENT, QLatin1String("Unexpected target handle type"));
+            return Tp::BaseChannelPtr();
+        }
+
+        if (!targetHandle) {
+            targetHandle = ensureHandle(Tp::HandleTypeContact,
+                    request.value(TP_QT_IFACE_CHANNEL + QLatin1String(".TargetID")).toString(), error);
+            if (error->isValid()) {
+                return Tp::BaseChannelPtr();
+            }
+        }
+
+        if (channelType == TP_QT_IFACE_CHANNEL_TYPE_TEXT) {
+            mLastChannel = createTextChannel(targetHandleType, targetHandle);
+        } else if (channelType == TP_QT_IFACE_CHANNEL_TYPE_FILE_TRANSFER) {
+            mLastChannel = Tp::BaseChannel::create(this, channelType,
+                    Tp::HandleType(targetHandleType), targetHandle);
+            Tp::BaseChannelFileTransferTypePtr fileTransfer = Tp::BaseChannelFileTransferType::create(request);
+            mLastChannel->plugInterface(Tp::AbstractChannelInterfacePtr::dynamicCast(fileTransfer));
+        } else {
+            error->set(TP_QT_ERROR_NOT_IMPLEMENTED, QLatin1String("Unexpected channel type"));
+            return Tp::BaseChannelPtr();
+        }
+
+        return mLastChannel;
+    }
+
+    QVariantMap contactAttributes(uint handle, const QStringList &interfaces)
+    {
+        QVariantMap attributes;
+        attributes[TP_QT_IFACE_CONNECTION + QLatin1String("/contact-id")] =
+            handleIdentifier(Tp::HandleTypeContact, handle);
+
+        if (interfaces.contains(TP_QT_IFACE_CONNECTION_INTERFACE_SIMPLE_PRESENCE)) {
+            attributes[TP_QT_IFACE_CONNECTION_INTERFACE_SIMPLE_PRESENCE + QLatin1String("/presence")] =
+                QVariant::fromValue(mSimplePresenceIface->getPresences(Tp::UIntList() << handle).value(handle));
+        }
+
+        if (interfaces.contains(TP_QT_IFACE_CONNECTION_INTERFACE_CONTACT_LIST)) {
+            uint state = mRosterHandles.contains(handle) ? Tp::SubscriptionStateYes : Tp::SubscriptionStateNo;
+            attributes[TP_QT_IFACE_CONNECTION_INTERFACE_CONTACT_LIST + QLatin1String("/subscribe")] = state;
+            attributes[TP_QT_IFACE_CONNECTION_INTERFACE_CONTACT_LIST + QLatin1String("/publish")] = state;
+        }
+
+        return attributes;
+    }
+
+    Tp::ContactAttributesMap getContactAttributes(const Tp::UIntList &handles,
+            const QStringList &interfaces, Tp::DBusError *error)
+    {
+        Tp::ContactAttributesMap attributes;
+
+        foreach (uint handle, handles) {
+            if (handleIdentifier(Tp::HandleTypeContact, handle).isEmpty()) {
+                error->set(TP_QT_ERROR_INVALID_HANDLE, QLatin1String("Unknown handle"));
+                return Tp::ContactAttributesMap();
+            }
+
+            attributes[handle] = contactAttributes(handle, interfaces);
+        }
+
+        return attributes;
+    }
+
+    Tp::ContactAttributesMap getContactListAttributes(const QStringList &interfaces,
+            bool hold, Tp::DBusError *error)
+    {
+        Q_UNUSED(hold)
+        Q_UNUSED(error)
+
+        Tp::ContactAttributesMap attributes;
+        foreach (uint handle, roster()) {
+            attributes[handle] = contactAttributes(handle, interfaces);
+        }
+
+        return attributes;
+    }
+
+private:
+    Tp::BaseConnectionContactsInterfacePtr mContactsIface;
+    Tp::BaseConnectionSimplePresenceInterfacePtr mSimplePresenceIface;
+    Tp::BaseConnectionContactListInterfacePtr mContactListIface;
+    Tp::BaseConnectionRequestsInterfacePtr mRequestsIface;
+
+    Tp::UIntList mRoster;
+    int mRosterSize;
+    QSet<uint> mRosterHandles;
+
+    Tp::BaseChannelPtr mLastChannel;
+};
+
+} // namespace BenchmarkCM
+
+using namespace Tp;
+
+class TestBaseCmBenchmarks : public Test
+{
+    Q_OBJECT
+
+public:
+    TestBaseCmBenchmarks(QObject *parent = nullptr)
+        : Test(parent),
+          mPendingSignals(0)
+    { }
+
+protected Q_SLOTS:
+    void onPendingSignal();
+    void onFileTransferBytesWritten(qint64 bytes);
+    void onFileTransferStateChanged(Tp::FileTransferState state);
+    void onProvideFileFinished(Tp::PendingOperation *op);
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+
+    void rosterLoad_data();
+    void rosterLoad();
+    void mucJoin_data();
+    void mucJoin();
+    void messageBurst_data();
+    void messageBurst();
+    void presenceStorm_data();
+    void presenceStorm();
+    void fileTransferThroughput_data();
+    void fileTransferThroughput();
+
+    void cleanup();
+    void cleanupTestCase();
+
+private:
+    BaseConnectionPtr createConnectionCb(const QVariantMap &parameters, DBusError *error)
+    {
+        Q_UNUSED(error)
+        mSvcConnection = BaseConnection::create<BenchmarkCM::Connection>(
+                mConnectionManager->name(), mProtocol->name(), parameters);
+        return mSvcConnection;
+    }
+
+    ConnectionPtr createClientConnection() const;
+    bool waitForReady(PendingReady *pr);
+
+    BaseProtocolPtr mProtocol;
+    BaseConnectionManagerPtr mConnectionManager;
+    BenchmarkCM::ConnectionPtr mSvcConnection;
+
+    ConnectionPtr mCliConnection;
+
+    int mPendingSignals;
+    BaseChannelFileTransferTypePtr mSvcTransferChannel;
+};
+
+void TestBaseCmBenchmarks::onPendingSignal()
+{
+    if (--mPendingSignals == 0) {
+        mLoop->exit(0);
+    }
+}
+
+void TestBaseCmBenchmarks::onFileTransferBytesWritten(qint64 bytes)
+{
+    mSvcTransferChannel->setTransferredBytes(mSvcTransferChannel->transferredBytes() + bytes);
+}
+
+void TestBaseCmBenchmarks::onFileTransferStateChanged(Tp::FileTransferState state)
+{
+    if (state == FileTransferStateCompleted) {
+        mLoop->exit(0);
+    } else if (state == FileTransferStateCancelled) {
+        mLoop->exit(1);
+    }
+}
+
+void TestBaseCmBenchmarks::onProvideFileFinished(Tp::PendingOperation *op)
+{
+    if (op->isError()) {
+        qWarning().nospace() << op->errorName() << ": " << op->errorMessage();
+        mLoop->exit(2);
+    }
+}
+
+ConnectionPtr TestBaseCmBenchmarks::createClientConnection() const
+{
+    return Connection::create(mSvcConnection->busName(), mSvcConnection->objectPath(),
+            ChannelFactory::create(QDBusConnection::sessionBus()),
+            ContactFactory::create(Features() << Contact::FeatureSimplePresence));
+}
+
+bool TestBaseCmBenchmarks::waitForReady(PendingReady *pr)
+{
+    connect(pr,
+            SIGNAL(finished(Tp::PendingOperation*)),
+            SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+    return mLoop->exec() == 0;
+}
+
+void TestBaseCmBenchmarks::initTestCase()
+{
+    initTestCaseImpl();
+
+    // The debug output would dominate the measurements
+    Tp::enableDebug(false);
+
+    mProtocol = BaseProtocol::create(QLatin1String("benchmark"));
+    mProtocol->setCreateConnectionCallback(memFun(this, &TestBaseCmBenchmarks::createConnectionCb));
+
+    mConnectionManager = BaseConnectionManager::create(QLatin1String("benchmarkcm"));
+    mConnectionManager->addProtocol(mProtocol);
+
+    DBusError err;
+    QVERIFY(mConnectionManager->registerObject(&err));
+    QVERIFY(!err.isValid());
+
+    ConnectionManagerPtr cliCM = ConnectionManager::create(mConnectionManager->name());
+    QVERIFY(waitForReady(cliCM->becomeReady()));
+
+    PendingConnection *pendingConnection = cliCM->lowlevel()->requestConnection(
+            mProtocol->name(), QVariantMap());
+    connect(pendingConnection,
+            SIGNAL(finished(Tp::PendingOperation*)),
+            SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+    QCOMPARE(mLoop->exec(), 0);
+
+    mCliConnection = pendingConnection->connection();
+    QVERIFY(waitForReady(mCliConnection->lowlevel()->requestConnect()));
+    QCOMPARE(mCliConnection->status(), ConnectionStatusConnected);
+    QVERIFY(!mSvcConnection.isNull());
+}
+
+void TestBaseCmBenchmarks::init()
+{
+    initImpl();
+}
+
+void TestBaseCmBenchmarks::rosterLoad_data()
+{
+    QTest::addColumn<int>("contacts");
+
+    QTest::newRow("100 contacts") << 100;
+    QTest::newRow("1000 contacts") << 1000;
+}
+
+void TestBaseCmBenchmarks::rosterLoad()
+{
+    QFETCH(int, contacts);
+
+    mSvcConnection->setRosterSize(contacts);
+
+    QBENCHMARK {
+        ConnectionPtr connection = createClientConnection();
+        QVERIFY(waitForReady(connection->becomeReady(
+                        Features() << Connection::FeatureCore << Connection::FeatureRoster)));
+        QVERIFY(connection->contactManager()->allKnownContacts().size() >= contacts);
+    }
+}
+
+void TestBaseCmBenchmarks::mucJoin_data()
+{
+    QTest::addColumn<int>("members");
+    QTest::addColumn<bool>("handlesOnly");
+
+    QTest::newRow("50 members") << 50 << false;
+    QTest::newRow("500 members") << 500 << false;
+    QTest::newRow("500 members, handles only") << 500 << true;
+}
+
+void TestBaseCmBenchmarks::mucJoin()
+{
+    QFETCH(int, members);
+    QFETCH(bool, handlesOnly);
+
+    BaseChannelPtr svcChannel = mSvcConnection->joinRoom(
+            QString(QLatin1String("room%1")).arg(QTest::currentDataTag()).remove(QLatin1Char(' ')),
+            members);
+    QVERIFY(!svcChannel.isNull());
+
+    Features features;
+    features << Channel::FeatureCore;
+    if (handlesOnly) {
+        features << Channel::FeatureGroupMemberHandles;
+    }
+
+    QBENCHMARK {
+        TextChannelPtr channel = TextChannel::create(mCliConnection,
+                svcChannel->objectPath(), svcChannel->immutableProperties());
+        QVERIFY(waitForReady(channel->becomeReady(features)));
+        QCOMPARE(channel->groupMemberHandles().size(), members + 1);
+    }
+
+    svcChannel->close();
+}
+
+void TestBaseCmBenchmarks::messageBurst_data()
+{
+    QTest::addColumn<int>("messages");
+
+    QTest::newRow("100 messages") << 100;
+    QTest::newRow("1000 messages") << 1000;
+}
+
+void TestBaseCmBenchmarks::messageBurst()
+{
+    QFETCH(int, messages);
+
+    uint sender = mSvcConnection->ensureHandle(HandleTypeContact, QLatin1String("burst@benchmark"));
+    BaseChannelPtr svcChannel = mSvcConnection->registerChannel(
+            mSvcConnection->createTextChannel(HandleTypeContact, sender));
+    QVERIFY(!svcChannel.isNull());
+    BaseChannelTextTypePtr svcTextType = BaseChannelTextTypePtr::dynamicCast(
+            svcChannel->interface(TP_QT_IFACE_CHANNEL_TYPE_TEXT));
+
+    TextChannelPtr channel = TextChannel::create(mCliConnection,
+            svcChannel->objectPath(), svcChannel->immutableProperties());
+    QVERIFY(waitForReady(channel->becomeReady(
+                    Features() << TextChannel::FeatureCore << TextChannel::FeatureMessageQueue)));
+    connect(channel.data(),
+            SIGNAL(messageReceived(Tp::ReceivedMessage)),
+            SLOT(onPendingSignal()));
+
+    int serial = 0;
+    QBENCHMARK {
+        mPendingSignals = messages;
+        for (int i = 0; i < messages; ++i) {
+            svcTextType->addReceivedMessage(createMessage(sender, QLatin1String("burst@benchmark"), serial++));
+        }
+        QCOMPARE(mLoop->exec(), 0);
+        QCOMPARE(channel->messageQueue().size(), messages);
+
+        // Acknowledge the burst, so that every iteration starts with an empty queue
+        connect(channel->acknowledge(channel->messageQueue()),
+                SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+        QCOMPARE(mLoop->exec(), 0);
+    }
+
+    svcChannel->close();
+}
+
+void TestBaseCmBenchmarks::presenceStorm_data()
+{
+    QTest::addColumn<int>("contacts");
+
+    QTest::newRow("100 contacts") << 100;
+    QTest::newRow("1000 contacts") << 1000;
+}
+
+void TestBaseCmBenchmarks::presenceStorm()
+{
+    QFETCH(int, contacts);
+
+    mSvcConnection->setRosterSize(contacts);
+
+    ConnectionPtr connection = createClientConnection();
+    QVERIFY(waitForReady(connection->becomeReady(
+                    Features() << Connection::FeatureCore << Connection::FeatureRoster)));
+    foreach (const ContactPtr &contact, connection->contactManager()->allKnownContacts()) {
+        connect(contact.data(),
+                SIGNAL(presenceChanged(Tp::Presence)),
+                SLOT(onPendingSignal()));
+    }
+
+    BaseConnectionSimplePresenceInterfacePtr svcPresence = mSvcConnection->simplePresenceInterface();
+    const UIntList handles = mSvcConnection->roster();
+    bool away = false;
+
+    QBENCHMARK {
+        away = !away;
+        SimplePresence presence;
+        presence.type = away ? ConnectionPresenceTypeAway : ConnectionPresenceTypeAvailable;
+        presence.status = away ? QLatin1String("away") : QLatin1String("available");
+
+        // One PresencesChanged signal per contact, as a CM would send while
+        // the server pushes the roster presences after connecting
+        mPendingSignals = handles.size();
+        foreach (uint handle, handles) {
+            SimpleContactPresences presences;
+            presences.insert(handle, presence);
+            svcPresence->setPresences(presences);
+        }
+        QCOMPARE(mLoop->exec(), 0);
+    }
+}
+
+void TestBaseCmBenchmarks::fileTransferThroughput_data()
+{
+    QTest::addColumn<int>("size");
+
+    QTest::newRow("64 KiB") << 64 * 1024;
+    QTest::newRow("1 MiB") << 1024 * 1024;
+    QTest::newRow("8 MiB") << 8 * 1024 * 1024;
+}
+
+void TestBaseCmBenchmarks::fileTransferThroughput()
+{
+    QFETCH(int, size);
+
+    const QByteArray content(size, 'x');
+    uint receiver = mSvcConnection->ensureHandle(HandleTypeContact, QLatin1String("ft@benchmark"));
+    FileTransferChannelCreationProperties properties(QLatin1String("benchmark.bin"),
+            QLatin1String("application/octet-stream"), size);
+
+    QBENCHMARK {
+        PendingChannel *pendingChannel = mCliConnection->lowlevel()->createChannel(
+                properties.createRequest(receiver));
+        connect(pendingChannel,
+                SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+        QCOMPARE(mLoop->exec(), 0);
+
+        OutgoingFileTransferChannelPtr channel =
+            OutgoingFileTransferChannelPtr::qObjectCast(pendingChannel->channel());
+        QVERIFY(channel);
+        QVERIFY(waitForReady(channel->becomeReady(OutgoingFileTransferChannel::FeatureCore)));
+        connect(channel.data(),
+                SIGNAL(stateChanged(Tp::FileTransferState,Tp::FileTransferStateChangeReason)),
+                SLOT(onFileTransferStateChanged(Tp::FileTransferState)));
+
+        mSvcTransferChannel = BaseChannelFileTransferTypePtr::dynamicCast(
+                mSvcConnection->lastChannel()->interface(TP_QT_IFACE_CHANNEL_TYPE_FILE_TRANSFER));
+        QVERIFY(!mSvcTransferChannel.isNull());
+
+        IODevice svcOutput;
+        svcOutput.open(QIODevice::ReadWrite);
+        connect(&svcOutput,
+                SIGNAL(bytesWritten(qint64)),
+                SLOT(onFileTransferBytesWritten(qint64)));
+        mSvcTransferChannel->remoteAcceptFile(&svcOutput, 0);
+
+        QBuffer input;
+        input.setData(content);
+        connect(channel->provideFile(&input),
+                SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(onProvideFileFinished(Tp::PendingOperation*)));
+        while (channel->state() != FileTransferStateCompleted) {
+            QCOMPARE(mLoop->exec(), 0);
+        }
+
+        connect(channel->requestClose(),
+                SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+        QCOMPARE(mLoop->exec(), 0);
+        mSvcTransferChannel.reset();
+    }
+}
+
+void TestBaseCmBenchmarks::cleanup()
+{
+    cleanupImpl();
+}
+
+void TestBaseCmBenchmarks::cleanupTestCase()
+{
+    if (mCliConnection) {
+        connect(mCliConnection->lowlevel()->requestDisconnect(),
+                SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+        mLoop->exec();
+    }
+
+    cleanupTestCaseImpl();
+}
+
+QTEST_MAIN(TestBaseCmBenchmarks)
+#include "_gen/base-cm-benchmarks.cpp.moc.hpp"
@@ -0,0 +1,182 @@
+#include <QtTest/QtTest>
+
+#include <TelepathyQt/Callbacks>
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// Benchmarks of creating, copying, moving and invoking Tp::Callback objects
+// the way the service side classes do for each D-Bus method call. The global
+// operator new is replaced to count the allocations made while doing so, which
+// must be none for functors small enough to be stored inline.
+
+static bool countAllocations = false;
+static int allocationCount = 0;
+
+void *operator new(std::size_t size)
+{
+    if (countAllocations) {
+        ++allocationCount;
+    }
+    void *ptr = std::malloc(size ? size : 1);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+using namespace Tp;
+
+namespace
+{
+
+struct Receiver
+{
+    Receiver() : total(0) {}
+
+    void add(int value) { total += value; }
+
+    int total;
+};
+
+int twice(int value)
+{
+    return 2 * value;
+}
+
+// Stands for a heavier callback, with too much state to be stored inline
+struct BigFunctor
+{
+    BigFunctor(Receiver *receiver) : receiver(receiver)
+    {
+        memset(padding, 0, sizeof(padding));
+    }
+
+    void operator()(int value) const { receiver->add(value + padding[0]); }
+
+    Receiver *receiver;
+    int padding[32];
+};
+
+template <class Callback>
+Callback passAround(const Callback &callback)
+{
+    // stored as a member, then handed over, as the Base* classes do
+    Callback copy(callback);
+    Callback moved(std::move(copy));
+    return moved;
+}
+
+}
+
+class TestCallbacksBenchmarks : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void memberFunction();
+    void pointerFunction();
+    void lambda();
+    void heapFunctor();
+};
+
+void TestCallbacksBenchmarks::memberFunction()
+{
+    Receiver receiver;
+    allocationCount = 0;
+
+    QBENCHMARK {
+        countAllocations = true;
+        Callback1<void, int> callback = memFun(&receiver, &Receiver::add);
+        passAround(callback)(1);
+        countAllocations = false;
+    }
+
+    QCOMPARE(allocationCount, 0);
+    QVERIFY(receiver.total > 0);
+}
+
+void TestCallbacksBenchmarks::pointerFunction()
+{
+    int total = 0;
+    allocationCount = 0;
+
+    QBENCHMARK {
+        countAllocations = true;
+        Callback1<int, int> callback = ptrFun(&twice);
+        total += passAround(callback)(1);
+        countAllocations = false;
+    }
+
+    QCOMPARE(allocationCount, 0);
+    QVERIFY(total > 0);
+}
+
+void TestCallbacksBenchmarks::lambda()
+{
+    Receiver receiver;
+    int offset = 1;
+    allocationCount = 0;
+
+    QBENCHMARK {
+        countAllocations = true;
+        Callback1<void, int> callback = [&receiver, offset](int value) {
+            receiver.add(value + offset);
+        };
+        passAround(callback)(1);
+        countAllocations = false;
+    }
+
+    QCOMPARE(allocationCount, 0);
+    QVERIFY(receiver.total > 0);
+}
+
+void TestCallbacksBenchmarks::heapFunctor()
+{
+    Receiver receiver;
+    int iterations = 0;
+    allocationCount = 0;
+
+    QBENCHMARK {
+        countAllocations = true;
+        Callback1<void, int> callback = BigFunctor(&receiver);
+        passAround(callback)(1);
+        countAllocations = false;
+        ++iterations;
+    }
+
+    // one allocation when created and one for the copy, the move only takes
+    // over the pointer
+    QCOMPARE(allocationCount, 2 * iterations);
+    QVERIFY(receiver.total > 0);
+}
+
+QTEST_MAIN(TestCallbacksBenchmarks)
+
+#include "_gen/callbacks-benchmarks.cpp.moc.hpp"
@@ -2,6 +2,53 @@
 
 #include <TelepathyQt/Callbacks>
 
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// The global operator new is replaced to count allocations, so that
+// testInlineStorage() can check that small functors are stored inline.
+
+static bool countAllocations = false;
+static int allocationCount = 0;
+
+void *operator new(std::size_t size)
+{
+    if (countAllocations) {
+        ++allocationCount;
+    }
+    void *ptr = std::malloc(size ? size : 1);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
 using namespace Tp;
 
 class TestCallbacks : public QObject
@@ -11,6 +58,9 @@ class TestCallbacks : public QObject
 private Q_SLOTS:
     void testMemFun();
     void testPtrFun();
+    void testCopyAndMove();
+    void testFunctors();
+    void testInlineStorage();
 };
 
 struct MyCallbacks
@@ -256,6 +306,178 @@ void TestCallbacks::testPtrFun()
     reset();
 }
 
+void TestCallbacks::testCopyAndMove()
+{
+    MyCallbacks cbs;
+
+    Callback1<void, int> invalid;
+    QVERIFY(!invalid.isValid());
+    Callback1<void, int> invalidCopy(invalid);
+    QVERIFY(!invalidCopy.isValid());
+    invalidCopy(1);
+
+    Callback1<void, int> cbVI1 = memFun(&cbs, &MyCallbacks::testVI1);
+    Callback1<void, int> copy(cbVI1);
+    QVERIFY(copy.isValid());
+    copy(1);
+    cbs.verifyCalled(false, true, false, false, false, false, false, false);
+    cbs.reset();
+
+    Callback1<void, int> moved(std::move(copy));
+    QVERIFY(moved.isValid());
+    QVERIFY(!copy.isValid());
+    // calling a moved-from callback is a no-op, like calling an invalid one
+    copy(1);
+    cbs.verifyCalled(false, false, false, false, false, false, false, false);
+    moved(1);
+    cbs.verifyCalled(false, true, false, false, false, false, false, false);
+    cbs.reset();
+
+    invalid = moved;
+    QVERIFY(invalid.isValid());
+    QVERIFY(moved.isValid());
+    moved = Callback1<void, int>();
+    QVERIFY(!moved.isValid());
+    moved = std::move(invalid);
+    QVERIFY(moved.isValid());
+    QVERIFY(!invalid.isValid());
+    moved(1);
+    cbs.verifyCalled(false, true, false, false, false, false, false, false);
+    cbs.reset();
+}
+
+namespace
+{
+
+struct Counter
+{
+    Counter(int *instances, int *calls)
+        : instances(instances), calls(calls)
+    {
+        ++*instances;
+    }
+
+    Counter(const Counter &other)
+        : instances(other.instances), calls(other.calls)
+    {
+        ++*instances;
+    }
+
+    ~Counter()
+    {
+        --*instances;
+    }
+
+    int operator()(int value) const
+    {
+        ++*calls;
+        return value + 1;
+    }
+
+    int *instances;
+    int *calls;
+};
+
+// too large to be stored inline
+struct BigCounter : public Counter
+{
+    BigCounter(int *instances, int *calls)
+        : Counter(instances, calls)
+    {
+        memset(padding, 0, sizeof(padding));
+    }
+
+    char padding[256];
+};
+
+}
+
+void TestCallbacks::testFunctors()
+{
+    int instances = 0;
+    int calls = 0;
+
+    {
+        Callback1<int, int> small = Counter(&instances, &calls);
+        Callback1<int, int> big = BigCounter(&instances, &calls);
+        QCOMPARE(instances, 2);
+        QCOMPARE(small(1), 2);
+        QCOMPARE(big(2), 3);
+        QCOMPARE(calls, 2);
+
+        Callback1<int, int> smallCopy(small);
+        Callback1<int, int> bigCopy(big);
+        QCOMPARE(instances, 4);
+
+        Callback1<int, int> smallMoved(std::move(smallCopy));
+        Callback1<int, int> bigMoved(std::move(bigCopy));
+        QCOMPARE(instances, 4);
+        QCOMPARE(smallMoved(3), 4);
+        QCOMPARE(bigMoved(4), 5);
+        QCOMPARE(calls, 4);
+
+        smallMoved = big;
+        bigMoved = small;
+        QCOMPARE(instances, 4);
+        QCOMPARE(smallMoved(5), 6);
+        QCOMPARE(bigMoved(6), 7);
+        QCOMPARE(calls, 6);
+
+        int offset = 10;
+        Callback1<int, int> lambda = [offset](int value) { return value + offset; };
+        Callback1<int, int> lambdaCopy(lambda);
+        QCOMPARE(lambdaCopy(1), 11);
+    }
+
+    QCOMPARE(instances, 0);
+}
+
+void TestCallbacks::testInlineStorage()
+{
+    MyCallbacks cbs;
+    int instances = 0;
+    int calls = 0;
+    int offset = 10;
+
+    // Only callbacks which don't use QCOMPARE are invoked while counting, as
+    // QTestLib may allocate to compare values
+    allocationCount = 0;
+    countAllocations = true;
+    {
+        Callback0<void> member = memFun(&cbs, &MyCallbacks::testVV);
+        Callback0<void> pointer = ptrFun(&testVV);
+        Callback1<int, int> functor = Counter(&instances, &calls);
+        Callback1<int, int> lambda = [offset](int value) { return value + offset; };
+
+        Callback0<void> memberCopy(member);
+        Callback1<int, int> functorCopy(functor);
+        Callback1<int, int> lambdaMoved(std::move(lambda));
+        memberCopy();
+        pointer();
+        functorCopy(1);
+        lambdaMoved(1);
+
+        functorCopy = lambdaMoved;
+        memberCopy = std::move(member);
+    }
+    countAllocations = false;
+    QCOMPARE(allocationCount, 0);
+    QCOMPARE(instances, 0);
+    QCOMPARE(calls, 1);
+    cbs.verifyCalled(true, false, false, false, false, false, false, false);
+
+    // Bigger functors do need the heap, which the counting above would notice
+    allocationCount = 0;
+    countAllocations = true;
+    {
+        Callback1<int, int> big = BigCounter(&instances, &calls);
+        Callback1<int, int> bigCopy(big);
+    }
+    countAllocations = false;
+    QCOMPARE(allocationCount, 2);
+    QCOMPARE(instances, 0);
+}
+
 QTEST_MAIN(TestCallbacks)
 
 #include "_gen/callbacks.cpp.moc.hpp"
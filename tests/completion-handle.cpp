@@ -0,0 +1,219 @@
+#include <QtTest/QtTest>
+
+#include <TelepathyQt/CompletionHandle>
+#include <TelepathyQt/PendingComposite>
+#include <TelepathyQt/PendingCompletion>
+#include <TelepathyQt/PendingSuccess>
+
+using namespace Tp;
+
+class TestCompletionHandle : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testFinish();
+    void testFinishWithError();
+    void testThenAfterFinish();
+    void testAll();
+    void testPendingCompletion();
+    void testPendingOperationCompletion();
+    void testPendingComposite();
+};
+
+struct Recorder
+{
+    Recorder(QList<int> *calls, int id)
+        : calls(calls), id(id)
+    {
+    }
+
+    void operator()(const CompletionHandle &handle) const
+    {
+        QVERIFY(handle.isFinished());
+        calls->append(id);
+    }
+
+    QList<int> *calls;
+    int id;
+};
+
+void TestCompletionHandle::testFinish()
+{
+    QList<int> calls;
+    CompletionHandle handle;
+    QVERIFY(!handle.isFinished());
+    QVERIFY(!handle.isValid());
+    QVERIFY(!handle.isError());
+
+    CompletionHandle copy(handle);
+    QVERIFY(copy == handle);
+    copy.then(Recorder(&calls, 1));
+    copy.then(Recorder(&calls, 2));
+    QVERIFY(calls.isEmpty());
+
+    handle.setFinished();
+    QVERIFY(copy.isFinished());
+    QVERIFY(copy.isValid());
+    QVERIFY(!copy.isError());
+    QCOMPARE(calls, QList<int>() << 1 << 2);
+
+    // finishing twice is ignored
+    handle.setFinishedWithError(QLatin1String("org.freedesktop.Telepathy.Error.NotAvailable"),
+            QString());
+    QVERIFY(copy.isValid());
+    QCOMPARE(calls.size(), 2);
+}
+
+void TestCompletionHandle::testFinishWithError()
+{
+    QList<int> calls;
+    CompletionHandle handle;
+    handle.then(Recorder(&calls, 1));
+    handle.setFinishedWithError(QLatin1String("org.freedesktop.Telepathy.Error.NotAvailable"),
+            QLatin1String("Not available"));
+    QVERIFY(handle.isFinished());
+    QVERIFY(!handle.isValid());
+    QVERIFY(handle.isError());
+    QCOMPARE(handle.errorName(), QLatin1String("org.freedesktop.Telepathy.Error.NotAvailable"));
+    QCOMPARE(handle.errorMessage(), QLatin1String("Not available"));
+    QCOMPARE(calls, QList<int>() << 1);
+}
+
+void TestCompletionHandle::testThenAfterFinish()
+{
+    QList<int> calls;
+    CompletionHandle handle = CompletionHandle::succeeded();
+    handle.then(Recorder(&calls, 1));
+    QCOMPARE(calls, QList<int>() << 1);
+
+    CompletionHandle failed = CompletionHandle::failed(
+            QLatin1String("org.freedesktop.Telepathy.Error.NotAvailable"), QString());
+    QVERIFY(failed.isError());
+    failed.then(Recorder(&calls, 2));
+    QCOMPARE(calls, QList<int>() << 1 << 2);
+}
+
+void TestCompletionHandle::testAll()
+{
+    QVERIFY(CompletionHandle::all(QList<CompletionHandle>()).isValid());
+
+    CompletionHandle first;
+    CompletionHandle second;
+    CompletionHandle all = CompletionHandle::all(QList<CompletionHandle>() << first << second);
+    first.setFinished();
+    QVERIFY(!all.isFinished());
+    second.setFinished();
+    QVERIFY(all.isValid());
+
+    first = CompletionHandle();
+    second = CompletionHandle();
+    all = CompletionHandle::all(QList<CompletionHandle>() << first << second);
+    first.setFinishedWithError(QLatin1String("org.freedesktop.Telepathy.Error.NotAvailable"),
+            QString());
+    QVERIFY(all.isError());
+    second.setFinished();
+    QCOMPARE(all.errorName(), QLatin1String("org.freedesktop.Telepathy.Error.NotAvailable"));
+
+    first = CompletionHandle();
+    second = CompletionHandle();
+    all = CompletionHandle::all(QList<CompletionHandle>() << first << second, false);
+    first.setFinishedWithError(QLatin1String("org.freedesktop.Telepathy.Error.NotAvailable"),
+            QString());
+    QVERIFY(!all.isFinished());
+    second.setFinished();
+    QVERIFY(all.isError());
+    QCOMPARE(all.errorName(), QLatin1String("org.freedesktop.Telepathy.Error.NotAvailable"));
+}
+
+void TestCompletionHandle::testPendingCompletion()
+{
+    CompletionHandle handle;
+    PendingCompletion *op = new PendingCompletion(handle, SharedPtr<RefCounted>());
+    QSignalSpy spy(op, SIGNAL(finished(Tp::PendingOperation*)));
+    QCOMPARE(op->handle(), handle);
+    QVERIFY(!op->isFinished());
+
+    handle.setFinishedWithError(QLatin1String("org.freedesktop.Telepathy.Error.NotAvailable"),
+            QString());
+    QVERIFY(op->isError());
+    QCOMPARE(op->errorName(), QLatin1String("org.freedesktop.Telepathy.Error.NotAvailable"));
+    QTRY_COMPARE(spy.count(), 1);
+}
+
+void TestCompletionHandle::testPendingOperationCompletion()
+{
+    QList<int> calls;
+    PendingSuccess *op = new PendingSuccess(SharedPtr<RefCounted>());
+    QSignalSpy spy(op, SIGNAL(finished(Tp::PendingOperation*)));
+
+    // the operation finished in its constructor, so the handle is already done
+    // even though finished() has not been emitted yet
+    CompletionHandle handle = op->completion();
+    QVERIFY(handle.isValid());
+    handle.then(Recorder(&calls, 1));
+    QCOMPARE(calls, QList<int>() << 1);
+    QCOMPARE(spy.count(), 0);
+    QTRY_COMPARE(spy.count(), 1);
+}
+
+void TestCompletionHandle::testPendingComposite()
+{
+    CompletionHandle first;
+    CompletionHandle second;
+    PendingComposite *composite = new PendingComposite(QList<PendingOperation*>()
+            << new PendingCompletion(first, SharedPtr<RefCounted>())
+            << new PendingCompletion(second, SharedPtr<RefCounted>()),
+            SharedPtr<RefCounted>());
+    QSignalSpy spy(composite, SIGNAL(finished(Tp::PendingOperation*)));
+
+    first.setFinished();
+    QVERIFY(!composite->isFinished());
+    // the composite finishes together with its last operation, before any of the
+    // finished() signals went through the event loop
+    second.setFinished();
+    QVERIFY(composite->isValid());
+    QCOMPARE(spy.count(), 0);
+    QTRY_COMPARE(spy.count(), 1);
+
+    // the first error fails the composite straight away by default
+    first = CompletionHandle();
+    second = CompletionHandle();
+    composite = new PendingComposite(QList<PendingOperation*>()
+            << new PendingCompletion(first, SharedPtr<RefCounted>())
+            << new PendingCompletion(second, SharedPtr<RefCounted>()),
+            SharedPtr<RefCounted>());
+    first.setFinishedWithError(QLatin1String("org.freedesktop.Telepathy.Error.NotAvailable"),
+            QString());
+    QVERIFY(composite->isError());
+    QCOMPARE(composite->errorName(), QLatin1String("org.freedesktop.Telepathy.Error.NotAvailable"));
+    second.setFinished();
+
+    // or once all operations finished otherwise
+    first = CompletionHandle();
+    second = CompletionHandle();
+    composite = new PendingComposite(QList<PendingOperation*>()
+            << new PendingCompletion(first, SharedPtr<RefCounted>())
+            << new PendingCompletion(second, SharedPtr<RefCounted>()),
+            false, SharedPtr<RefCounted>());
+    first.setFinishedWithError(QLatin1String("org.freedesktop.Telepathy.Error.NotAvailable"),
+            QString());
+    QVERIFY(!composite->isFinished());
+    second.setFinished();
+    QVERIFY(composite->isError());
+    QCOMPARE(composite->errorName(), QLatin1String("org.freedesktop.Telepathy.Error.NotAvailable"));
+
+    // operations which already finished are taken into account
+    composite = new PendingComposite(QList<PendingOperation*>()
+            << new PendingCompletion(CompletionHandle::succeeded(), SharedPtr<RefCounted>()),
+            SharedPtr<RefCounted>());
+    QVERIFY(composite->isValid());
+
+    // and there is nothing to wait for without any operations
+    composite = new PendingComposite(QList<PendingOperation*>(), SharedPtr<RefCounted>());
+    QVERIFY(composite->isValid());
+}
+
+QTEST_MAIN(TestCompletionHandle)
+
+#include "_gen/completion-handle.cpp.moc.hpp"
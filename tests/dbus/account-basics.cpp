@@ -3,6 +3,7 @@
 #include <tests/lib/glib-helpers/test-conn-helper.h>
 
 #include <tests/lib/glib/echo2/conn.h>
+#include <tests/lib/glib/echo2/connection-manager.h>
 
 #include <TelepathyQt/Account>
 #include <TelepathyQt/AccountManager>
@@ -17,8 +18,28 @@
 
 #include <telepathy-glib/debug.h>
 
+#include <dbus/dbus-glib-lowlevel.h>
+
 using namespace Tp;
 
+namespace
+{
+
+DBusHandlerResult countCMCalls(DBusConnection *connection, DBusMessage *message, void *data)
+{
+    Q_UNUSED(connection);
+
+    // count the introspection calls made on the connection manager object
+    if (dbus_message_get_type(message) == DBUS_MESSAGE_TYPE_METHOD_CALL &&
+            dbus_message_has_path(message,
+                "/org/freedesktop/Telepathy/ConnectionManager/example_echo_2")) {
+        ++*static_cast<int*>(data);
+    }
+    return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+}
+
+}
+
 class TestAccountBasics : public Test
 {
     Q_OBJECT
@@ -27,7 +48,9 @@ public:
     TestAccountBasics(QObject *parent = 0)
         : Test(parent),
           mConn(0),
-          mAccountsCount(0)
+          mCMService(0),
+          mAccountsCount(0),
+          mCMCalls(0)
     { }
 
 protected Q_SLOTS:
@@ -49,6 +72,7 @@ private Q_SLOTS:
     void init();
 
     void testBasics();
+    void testSharedConnectionManager();
 
     void cleanup();
     void cleanupTestCase();
@@ -57,10 +81,14 @@ private:
     QStringList pathsForAccounts(const QList<AccountPtr> &list);
     QStringList pathsForAccounts(const AccountSetPtr &set);
 
+    AccountPtr createEchoAccount(const QString &id);
+
     Tp::AccountManagerPtr mAM;
     TestConnHelper *mConn;
+    TpBaseConnectionManager *mCMService;
     int mAccountsCount;
     bool mCreatingAccount;
+    int mCMCalls;
 
     QHash<QString, QVariant> mProps;
 };
@@ -166,6 +194,15 @@ void TestAccountBasics::initTestCase()
             "protocol", "echo2",
             NULL);
     QVERIFY(mConn->connect());
+
+    mCMService = TP_BASE_CONNECTION_MANAGER(g_object_new(
+        EXAMPLE_TYPE_ECHO_2_CONNECTION_MANAGER,
+        NULL));
+    QVERIFY(mCMService != 0);
+    QVERIFY(tp_base_connection_manager_register(mCMService));
+
+    dbus_connection_add_filter(dbus_g_connection_get_connection(
+                dbus_g_bus_get(DBUS_BUS_STARTER, 0)), countCMCalls, &mCMCalls, 0);
 }
 
 void TestAccountBasics::init()
@@ -581,6 +618,72 @@ void TestAccountBasics::testBasics()
     processDBusQueue(mConn->client().data());
 }
 
+AccountPtr TestAccountBasics::createEchoAccount(const QString &id)
+{
+    QVariantMap parameters;
+    parameters[QLatin1String("account")] = id;
+    PendingAccount *pacc = mAM->createAccount(QLatin1String("example_echo_2"),
+            QLatin1String("example"), id, parameters);
+    if (!connect(pacc,
+                SIGNAL(finished(Tp::PendingOperation *)),
+                SLOT(expectSuccessfulCall(Tp::PendingOperation *))) ||
+            mLoop->exec() != 0) {
+        return AccountPtr();
+    }
+    return pacc->account();
+}
+
+void TestAccountBasics::testSharedConnectionManager()
+{
+    // account creations are waited for here
+    QVERIFY(disconnect(mAM.data(),
+                SIGNAL(newAccount(const Tp::AccountPtr &)),
+                this,
+                SLOT(onNewAccount(const Tp::AccountPtr &))));
+
+    AccountPtr firstAcc = createEchoAccount(QLatin1String("first@example.com"));
+    QVERIFY(!firstAcc.isNull());
+    AccountPtr secondAcc = createEchoAccount(QLatin1String("second@example.com"));
+    QVERIFY(!secondAcc.isNull());
+
+    QVERIFY(connect(firstAcc->becomeReady(Account::FeatureProtocolInfo),
+                    SIGNAL(finished(Tp::PendingOperation *)),
+                    SLOT(expectSuccessfulCall(Tp::PendingOperation *))));
+    QCOMPARE(mLoop->exec(), 0);
+    QVERIFY(firstAcc->protocolInfo().isValid());
+    QVERIFY(mCMCalls > 0);
+
+    // the second account on the same CM shares the ConnectionManager already
+    // introspected for the first one
+    int cmCalls = mCMCalls;
+    QVERIFY(connect(secondAcc->becomeReady(Account::FeatureProtocolInfo),
+                    SIGNAL(finished(Tp::PendingOperation *)),
+                    SLOT(expectSuccessfulCall(Tp::PendingOperation *))));
+    QCOMPARE(mLoop->exec(), 0);
+    QVERIFY(secondAcc->protocolInfo().isValid());
+    QCOMPARE(secondAcc->protocolInfo().name(), firstAcc->protocolInfo().name());
+    QCOMPARE(mCMCalls, cmCalls);
+
+    // once the CM's bus name changes owner, as if the CM was restarted, it is
+    // introspected again for the next account
+    TpDBusDaemon *dbus = tp_dbus_daemon_dup(0);
+    QVERIFY(tp_dbus_daemon_release_name(dbus,
+                TP_CM_BUS_NAME_BASE "example_echo_2", 0));
+    QVERIFY(tp_dbus_daemon_request_name(dbus,
+                TP_CM_BUS_NAME_BASE "example_echo_2", FALSE, 0));
+    g_object_unref(dbus);
+    processDBusQueue(mAM.data());
+
+    AccountPtr thirdAcc = createEchoAccount(QLatin1String("third@example.com"));
+    QVERIFY(!thirdAcc.isNull());
+    QVERIFY(connect(thirdAcc->becomeReady(Account::FeatureProtocolInfo),
+                    SIGNAL(finished(Tp::PendingOperation *)),
+                    SLOT(expectSuccessfulCall(Tp::PendingOperation *))));
+    QCOMPARE(mLoop->exec(), 0);
+    QVERIFY(thirdAcc->protocolInfo().isValid());
+    QVERIFY(mCMCalls > cmCalls);
+}
+
 void TestAccountBasics::cleanup()
 {
     cleanupImpl();
@@ -593,6 +696,12 @@ void TestAccountBasics::cleanupTestCase()
         delete mConn;
     }
 
+    if (mCMService) {
+        dbus_connection_remove_filter(dbus_g_connection_get_connection(
+                    dbus_g_bus_get(DBUS_BUS_STARTER, 0)), countCMCalls, &mCMCalls);
+        g_object_unref(mCMService);
+    }
+
     cleanupTestCaseImpl();
 }
 
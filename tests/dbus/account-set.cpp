@@ -42,6 +42,7 @@ private Q_SLOTS:
 
     void testBasics();
     void testFilters();
+    void testFilterUpdates();
 
     void cleanup();
     void cleanupTestCase();
@@ -397,6 +398,106 @@ void TestAccountSet::testFilters()
     }
 }
 
+void TestAccountSet::testFilterUpdates()
+{
+    // reuse the accounts created by testFilters
+    QCOMPARE(mAM->allAccounts().size(), 2);
+    AccountPtr fooAcc = mAM->accountsByProtocol(QLatin1String("bar"))->accounts().first();
+    AccountPtr spuriousAcc = mAM->accountsByProtocol(QLatin1String("normal"))->accounts().first();
+    QVERIFY(spuriousAcc->isReady(Account::FeatureCapabilities));
+
+    AccountPropertyFilterPtr renamedFilter = AccountPropertyFilter::create();
+    renamedFilter->addProperty(QLatin1String("displayName"), QLatin1String("renamed"));
+    AccountSetPtr renamedAccounts = AccountSetPtr(new AccountSet(mAM, renamedFilter));
+    AccountSetPtr notRenamedAccounts = AccountSetPtr(new AccountSet(mAM,
+                NotFilter<Account>::create(renamedFilter)));
+    QCOMPARE(renamedAccounts->accounts().size(), 0);
+    QCOMPARE(notRenamedAccounts->accounts().size(), 2);
+
+    AccountSetPtr textChatAccounts = mAM->textChatAccounts();
+    QCOMPARE(textChatAccounts->accounts().size(), 1);
+    QVERIFY(textChatAccounts->accounts().contains(spuriousAcc));
+
+    QList<AccountFilterConstPtr> filterChain;
+    AccountPropertyFilterPtr cmNameFilter = AccountPropertyFilter::create();
+    cmNameFilter->addProperty(QLatin1String("cmName"), QLatin1String("spurious"));
+    filterChain.append(cmNameFilter);
+    filterChain.append(AccountCapabilityFilter::create(
+                RequestableChannelClassSpecList() << RequestableChannelClassSpec::textChat()));
+    AccountSetPtr spuriousTextChatAccounts = AccountSetPtr(new AccountSet(mAM,
+                AndFilter<Account>::create(filterChain)));
+    QCOMPARE(spuriousTextChatAccounts->accounts().size(), 1);
+
+    filterChain.clear();
+    filterChain.append(renamedFilter);
+    AccountPropertyFilterPtr serviceNameFilter = AccountPropertyFilter::create();
+    serviceNameFilter->addProperty(QLatin1String("serviceName"), QLatin1String("test-profile"));
+    filterChain.append(serviceNameFilter);
+    AccountSetPtr renamedOrProfiledAccounts = AccountSetPtr(new AccountSet(mAM,
+                OrFilter<Account>::create(filterChain)));
+    QCOMPARE(renamedOrProfiledAccounts->accounts().size(), 0);
+
+    // a property filter follows the property
+    QString oldDisplayName = fooAcc->displayName();
+    QVERIFY(connect(fooAcc->setDisplayName(QLatin1String("renamed")),
+                SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(expectSuccessfulCall(Tp::PendingOperation*))));
+    QCOMPARE(mLoop->exec(), 0);
+    while (fooAcc->displayName() != QLatin1String("renamed")) {
+        mLoop->processEvents();
+    }
+
+    QCOMPARE(renamedAccounts->accounts().size(), 1);
+    QVERIFY(renamedAccounts->accounts().contains(fooAcc));
+    QCOMPARE(notRenamedAccounts->accounts().size(), 1);
+    QVERIFY(notRenamedAccounts->accounts().contains(spuriousAcc));
+    QCOMPARE(renamedOrProfiledAccounts->accounts().size(), 1);
+    QVERIFY(renamedOrProfiledAccounts->accounts().contains(fooAcc));
+
+    // the test profile does not support text chats, so this changes the account capabilities
+    // along with the service name
+    QVERIFY(connect(spuriousAcc->setServiceName(QLatin1String("test-profile")),
+                SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(expectSuccessfulCall(Tp::PendingOperation*))));
+    QCOMPARE(mLoop->exec(), 0);
+    while (spuriousAcc->capabilities().textChats()) {
+        mLoop->processEvents();
+    }
+
+    QCOMPARE(textChatAccounts->accounts().size(), 0);
+    QCOMPARE(spuriousTextChatAccounts->accounts().size(), 0);
+    QCOMPARE(renamedOrProfiledAccounts->accounts().size(), 2);
+    QVERIFY(renamedOrProfiledAccounts->accounts().contains(spuriousAcc));
+
+    // and back
+    QVERIFY(connect(spuriousAcc->setServiceName(QString()),
+                SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(expectSuccessfulCall(Tp::PendingOperation*))));
+    QCOMPARE(mLoop->exec(), 0);
+    while (!spuriousAcc->capabilities().textChats()) {
+        mLoop->processEvents();
+    }
+
+    QCOMPARE(textChatAccounts->accounts().size(), 1);
+    QVERIFY(textChatAccounts->accounts().contains(spuriousAcc));
+    QCOMPARE(spuriousTextChatAccounts->accounts().size(), 1);
+    QVERIFY(spuriousTextChatAccounts->accounts().contains(spuriousAcc));
+    QCOMPARE(renamedOrProfiledAccounts->accounts().size(), 1);
+    QVERIFY(renamedOrProfiledAccounts->accounts().contains(fooAcc));
+
+    QVERIFY(connect(fooAcc->setDisplayName(oldDisplayName),
+                SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(expectSuccessfulCall(Tp::PendingOperation*))));
+    QCOMPARE(mLoop->exec(), 0);
+    while (fooAcc->displayName() != oldDisplayName) {
+        mLoop->processEvents();
+    }
+
+    QCOMPARE(renamedAccounts->accounts().size(), 0);
+    QCOMPARE(notRenamedAccounts->accounts().size(), 2);
+    QCOMPARE(renamedOrProfiledAccounts->accounts().size(), 0);
+}
+
 void TestAccountSet::cleanup()
 {
     cleanupImpl();
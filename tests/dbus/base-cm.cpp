@@ -3,13 +3,21 @@
 
 #define TP_QT_ENABLE_LOWLEVEL_API
 
+#include <TelepathyQt/BaseChannel>
+#include <TelepathyQt/BaseConnection>
 #include <TelepathyQt/BaseConnectionManager>
 #include <TelepathyQt/BaseProtocol>
 #include <TelepathyQt/ConnectionManager>
 #include <TelepathyQt/ConnectionManagerLowlevel>
+#include <TelepathyQt/Connection>
 #include <TelepathyQt/DBusError>
+#include <TelepathyQt/DeferredResult>
 #include <TelepathyQt/PendingReady>
 #include <TelepathyQt/PendingConnection>
+#include <TelepathyQt/PendingVariant>
+
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
 
 using namespace Tp;
 
@@ -27,6 +35,10 @@ private Q_SLOTS:
 
     void testNoProtocols();
     void testProtocols();
+    void testHandleRepository();
+    void testUnresolvableChannelTarget();
+    void testAsyncCallbacks();
+    void testConcurrentEnsureChannel();
 
     void cleanup();
     void cleanupTestCase();
@@ -157,6 +169,335 @@ void TestBaseCM::testProtocols()
     QCOMPARE(mLastError, TP_QT_ERROR_NOT_IMPLEMENTED);
 }
 
+static int normalizeContactIdCalls = 0;
+
+static QString normalizeContactId(uint handleType, const QString &identifier, DBusError *error)
+{
+    Q_UNUSED(handleType);
+
+    ++normalizeContactIdCalls;
+
+    if (!identifier.contains(QLatin1Char('@'))) {
+        error->set(TP_QT_ERROR_INVALID_HANDLE, QLatin1String("Not a contact identifier"));
+        return QString();
+    }
+    return identifier.toLower();
+}
+
+void TestBaseCM::testHandleRepository()
+{
+    BaseConnectionPtr conn = BaseConnection::create(QLatin1String("testcm"),
+            QLatin1String("myprotocol"), QVariantMap());
+    conn->setNormalizeIdentifierCallback(
+            BaseConnection::NormalizeIdentifierCallback(&normalizeContactId));
+
+    DBusError error;
+    UIntList handles = conn->requestHandles(HandleTypeContact, QStringList()
+            << QLatin1String("Alice@example.com")
+            << QLatin1String("bob@example.com")
+            << QLatin1String("alice@EXAMPLE.com"), &error);
+    QVERIFY(!error.isValid());
+    QCOMPARE(handles.size(), 3);
+    QVERIFY(handles[0] != 0);
+    QVERIFY(handles[0] != handles[1]);
+    QCOMPARE(handles[0], handles[2]);
+
+    QCOMPARE(conn->inspectHandles(HandleTypeContact, handles, &error),
+             QStringList() << QLatin1String("alice@example.com")
+                           << QLatin1String("bob@example.com")
+                           << QLatin1String("alice@example.com"));
+    QVERIFY(!error.isValid());
+    QCOMPARE(conn->handleIdentifier(HandleTypeContact, handles[1]), QLatin1String("bob@example.com"));
+    QCOMPARE(conn->ensureHandle(HandleTypeContact, QLatin1String("BOB@example.com")), handles[1]);
+
+    // Handle types have separate repositories
+    QVERIFY(conn->handleIdentifier(HandleTypeRoom, handles[0]).isEmpty());
+
+    conn->requestHandles(HandleTypeContact, QStringList() << QLatin1String("carol"), &error);
+    QCOMPARE(error.name(), TP_QT_ERROR_INVALID_HANDLE);
+
+    DBusError inspectError;
+    conn->inspectHandles(HandleTypeContact, UIntList() << 1000, &inspectError);
+    QCOMPARE(inspectError.name(), TP_QT_ERROR_INVALID_HANDLE);
+
+    // Only contact and room handles are supported
+    DBusError listError;
+    QCOMPARE(conn->ensureHandle(HandleTypeList, QLatin1String("subscribe"), &listError), 0U);
+    QCOMPARE(listError.name(), TP_QT_ERROR_NOT_IMPLEMENTED);
+    DBusError noneError;
+    conn->requestHandles(HandleTypeNone, QStringList() << QLatin1String("alice@example.com"), &noneError);
+    QCOMPARE(noneError.name(), TP_QT_ERROR_INVALID_ARGUMENT);
+    DBusError unknownError;
+    conn->inspectHandles(42, handles, &unknownError);
+    QCOMPARE(unknownError.name(), TP_QT_ERROR_INVALID_ARGUMENT);
+
+    // Identifiers are only normalized once, but the cache doesn't grow forever
+    normalizeContactIdCalls = 0;
+    conn->ensureHandle(HandleTypeContact, QLatin1String("Alice@example.com"));
+    QCOMPARE(normalizeContactIdCalls, 0);
+    for (int i = 0; i < 2000; ++i) {
+        conn->ensureHandle(HandleTypeContact, QString(QLatin1String("contact%1@example.com")).arg(i));
+    }
+    QCOMPARE(normalizeContactIdCalls, 2000);
+    QCOMPARE(conn->ensureHandle(HandleTypeContact, QLatin1String("Alice@example.com")), handles[0]);
+    QCOMPARE(normalizeContactIdCalls, 2001);
+}
+
+template<typename T>
+struct ResultRecorder
+{
+    ResultRecorder(QStringList *log)
+        : log(log)
+    {
+    }
+
+    void operator()(const CompletionHandle &completion, const T &result) const
+    {
+        Q_UNUSED(result);
+        log->append(completion.isError() ? completion.errorName() : QLatin1String("ok"));
+    }
+
+    QStringList *log;
+};
+
+static QStringList inspectNoHandles(uint handleType, const UIntList &handles, DBusError *error)
+{
+    Q_UNUSED(handleType);
+    Q_UNUSED(handles);
+    Q_UNUSED(error);
+
+    // a broken CM, which doesn't know the handles but doesn't say so either
+    return QStringList();
+}
+
+struct TextChannelCreation
+{
+    TextChannelCreation(BaseConnection *connection)
+        : connection(connection)
+    {
+    }
+
+    BaseChannelPtr operator()(const QVariantMap &request, DBusError *error) const
+    {
+        Q_UNUSED(error);
+        return BaseChannel::create(connection, TP_QT_IFACE_CHANNEL_TYPE_TEXT, HandleTypeContact,
+                request.value(TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandle")).toUInt());
+    }
+
+    BaseConnection *connection;
+};
+
+void TestBaseCM::testUnresolvableChannelTarget()
+{
+    BaseConnectionPtr conn = BaseConnection::create(QLatin1String("testcm"),
+            QLatin1String("myprotocol"), QVariantMap());
+    conn->setCreateChannelCallback(TextChannelCreation(conn.data()));
+
+    QVariantMap request;
+    request[TP_QT_IFACE_CHANNEL + QLatin1String(".ChannelType")] = TP_QT_IFACE_CHANNEL_TYPE_TEXT;
+    request[TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandleType")] = uint(HandleTypeContact);
+    request[TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandle")] = 42U;
+
+    // The built-in repository doesn't know the handle
+    DBusError repositoryError;
+    QVERIFY(conn->createChannel(request, false, &repositoryError).isNull());
+    QCOMPARE(repositoryError.name(), TP_QT_ERROR_INVALID_HANDLE);
+
+    // and neither does the CM's callback, even if it doesn't set an error
+    conn->setInspectHandlesCallback(BaseConnection::InspectHandlesCallback(&inspectNoHandles));
+    DBusError callbackError;
+    QVERIFY(conn->createChannel(request, false, &callbackError).isNull());
+    QCOMPARE(callbackError.name(), TP_QT_ERROR_INVALID_HANDLE);
+    QVERIFY(!callbackError.message().isEmpty());
+
+    // with an initiator to resolve as well
+    QVariantMap initiatedRequest = request;
+    initiatedRequest[TP_QT_IFACE_CHANNEL + QLatin1String(".InitiatorHandle")] = 43U;
+    DBusError initiatorError;
+    QVERIFY(conn->createChannel(initiatedRequest, false, &initiatorError).isNull());
+    QCOMPARE(initiatorError.name(), TP_QT_ERROR_INVALID_HANDLE);
+
+    // The requests coming from D-Bus fail the same way, instead of crashing
+    QStringList log;
+    DeferredResultPtr<BaseChannelPtr> channel(
+            new DeferredResult<BaseChannelPtr>(ResultRecorder<BaseChannelPtr>(&log)));
+    conn->createChannel(request, false, channel);
+    QCOMPARE(log, QStringList() << TP_QT_ERROR_INVALID_HANDLE);
+}
+
+struct PendingHandleRequests
+{
+    PendingHandleRequests(QList<DeferredResultPtr<UIntList> > *requests)
+        : requests(requests)
+    {
+    }
+
+    void operator()(uint handleType, const QStringList &identifiers,
+            const DeferredResultPtr<UIntList> &result) const
+    {
+        Q_UNUSED(handleType);
+        Q_UNUSED(identifiers);
+        requests->append(result);
+    }
+
+    QList<DeferredResultPtr<UIntList> > *requests;
+};
+
+struct FailingChannelCreation
+{
+    void operator()(const QVariantMap &request, const DeferredResultPtr<BaseChannelPtr> &result) const
+    {
+        QVERIFY(request.contains(TP_QT_IFACE_CHANNEL + QLatin1String(".Requested")));
+        result->setFinishedWithError(TP_QT_ERROR_NOT_AVAILABLE, QLatin1String("Room is full"));
+    }
+};
+
+struct PendingChannelCreations
+{
+    PendingChannelCreations(QList<DeferredResultPtr<BaseChannelPtr> > *creations)
+        : creations(creations)
+    {
+    }
+
+    void operator()(const QVariantMap &request, const DeferredResultPtr<BaseChannelPtr> &result) const
+    {
+        Q_UNUSED(request);
+        creations->append(result);
+    }
+
+    QList<DeferredResultPtr<BaseChannelPtr> > *creations;
+};
+
+void TestBaseCM::testAsyncCallbacks()
+{
+    BaseConnectionPtr conn = BaseConnection::create(QLatin1String("testcm"),
+            QLatin1String("myprotocol"), QVariantMap());
+
+    QList<DeferredResultPtr<UIntList> > requests;
+    conn->setRequestHandlesAsyncCallback(PendingHandleRequests(&requests));
+
+    QStringList log;
+    DeferredResultPtr<UIntList> first(new DeferredResult<UIntList>(ResultRecorder<UIntList>(&log)));
+    DeferredResultPtr<UIntList> second(new DeferredResult<UIntList>(ResultRecorder<UIntList>(&log)));
+    conn->requestHandles(HandleTypeContact, QStringList() << QLatin1String("alice"), first);
+    conn->requestHandles(HandleTypeContact, QStringList() << QLatin1String("bob"), second);
+
+    // Neither request blocks the other, and they can complete in any order
+    QCOMPARE(requests.size(), 2);
+    QVERIFY(!first->isFinished());
+    QVERIFY(!second->isFinished());
+
+    requests[1]->setFinished(UIntList() << 2);
+    QCOMPARE(log, QStringList() << QLatin1String("ok"));
+    QCOMPARE(second->result(), UIntList() << 2);
+    QVERIFY(!first->isFinished());
+
+    requests[0]->setFinishedWithError(TP_QT_ERROR_INVALID_HANDLE, QString());
+    QCOMPARE(log, QStringList() << QLatin1String("ok") << TP_QT_ERROR_INVALID_HANDLE);
+    QVERIFY(first->isError());
+
+    // The synchronous API cannot serve handles given out asynchronously
+    DBusError error;
+    conn->requestHandles(HandleTypeContact, QStringList() << QLatin1String("carol"), &error);
+    QCOMPARE(error.name(), TP_QT_ERROR_NOT_IMPLEMENTED);
+
+    conn->setCreateChannelAsyncCallback(FailingChannelCreation());
+    QVariantMap request;
+    request[TP_QT_IFACE_CHANNEL + QLatin1String(".ChannelType")] = TP_QT_IFACE_CHANNEL_TYPE_TEXT;
+    log.clear();
+    DeferredResultPtr<BaseChannelPtr> channel(
+            new DeferredResult<BaseChannelPtr>(ResultRecorder<BaseChannelPtr>(&log)));
+    conn->createChannel(request, false, channel);
+    QCOMPARE(log, QStringList() << TP_QT_ERROR_NOT_AVAILABLE);
+    QCOMPARE(channel->errorMessage(), QLatin1String("Room is full"));
+
+    // Dropping a pending result without finishing it fails the request
+    QList<DeferredResultPtr<BaseChannelPtr> > creations;
+    conn->setCreateChannelAsyncCallback(PendingChannelCreations(&creations));
+    log.clear();
+    channel = DeferredResultPtr<BaseChannelPtr>(
+            new DeferredResult<BaseChannelPtr>(ResultRecorder<BaseChannelPtr>(&log)));
+    conn->createChannel(request, false, channel);
+    QCOMPARE(creations.size(), 1);
+    QVERIFY(log.isEmpty());
+    creations.clear();
+    QCOMPARE(log, QStringList() << QLatin1String("org.freedesktop.Telepathy.Qt.ErrorHandlingError"));
+
+    // and the result the continuation gets is the one it was dropped with
+    QStringList droppedLog;
+    DeferredResultPtr<UIntList> dropped(new DeferredResult<UIntList>(ResultRecorder<UIntList>(&droppedLog)));
+    CompletionHandle droppedCompletion = dropped->completion();
+    dropped.reset();
+    QCOMPARE(droppedLog, QStringList() << QLatin1String("org.freedesktop.Telepathy.Qt.ErrorHandlingError"));
+    QVERIFY(droppedCompletion.isError());
+    QCOMPARE(droppedCompletion.errorName(), QLatin1String("org.freedesktop.Telepathy.Qt.ErrorHandlingError"));
+}
+
+void TestBaseCM::testConcurrentEnsureChannel()
+{
+    BaseConnectionPtr conn = BaseConnection::create(QLatin1String("testcm"),
+            QLatin1String("myprotocol"), QVariantMap());
+    BaseConnectionRequestsInterfacePtr requestsIface = BaseConnectionRequestsInterface::create(conn.data());
+    QVERIFY(conn->plugInterface(AbstractConnectionInterfacePtr::dynamicCast(requestsIface)));
+
+    QList<DeferredResultPtr<BaseChannelPtr> > creations;
+    conn->setCreateChannelAsyncCallback(PendingChannelCreations(&creations));
+
+    DBusError error;
+    QVERIFY(conn->registerObject(&error));
+    QVERIFY(!error.isValid());
+
+    const uint handle = conn->ensureHandle(HandleTypeContact, QLatin1String("alice@example.com"));
+    QVariantMap request;
+    request[TP_QT_IFACE_CHANNEL + QLatin1String(".ChannelType")] = TP_QT_IFACE_CHANNEL_TYPE_TEXT;
+    request[TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandleType")] = uint(HandleTypeContact);
+    request[TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandle")] = handle;
+
+    Client::ConnectionInterfaceRequestsInterface requests(conn->busName(), conn->objectPath());
+    QDBusPendingCallWatcher first(requests.EnsureChannel(request));
+    QTRY_COMPARE(creations.size(), 1);
+
+    // The second request for the same target waits for the channel being
+    // created rather than creating another one
+    QDBusPendingCallWatcher second(requests.EnsureChannel(request));
+    connect(requests.requestPropertyChannels(), SIGNAL(finished(Tp::PendingOperation*)),
+            SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(creations.size(), 1);
+    QVERIFY(!first.isFinished());
+    QVERIFY(!second.isFinished());
+
+    creations[0]->setFinished(BaseChannel::create(conn.data(), TP_QT_IFACE_CHANNEL_TYPE_TEXT,
+                HandleTypeContact, handle));
+    QTRY_VERIFY(first.isFinished() && second.isFinished());
+
+    QDBusPendingReply<bool, QDBusObjectPath, QVariantMap> firstReply = first;
+    QDBusPendingReply<bool, QDBusObjectPath, QVariantMap> secondReply = second;
+    QVERIFY(!firstReply.isError());
+    QVERIFY(!secondReply.isError());
+    QCOMPARE(firstReply.argumentAt<0>(), true);
+    QCOMPARE(secondReply.argumentAt<0>(), false);
+    QCOMPARE(secondReply.argumentAt<1>().path(), firstReply.argumentAt<1>().path());
+    QCOMPARE(conn->channelsDetails().size(), 1);
+
+    // A failed creation fails the requests waiting for it as well
+    QVariantMap otherRequest = request;
+    otherRequest[TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandle")] =
+            conn->ensureHandle(HandleTypeContact, QLatin1String("bob@example.com"));
+    QDBusPendingCallWatcher third(requests.EnsureChannel(otherRequest));
+    QTRY_COMPARE(creations.size(), 2);
+    QDBusPendingCallWatcher fourth(requests.EnsureChannel(otherRequest));
+    connect(requests.requestPropertyChannels(), SIGNAL(finished(Tp::PendingOperation*)),
+            SLOT(expectSuccessfulCall(Tp::PendingOperation*)));
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(creations.size(), 2);
+
+    creations[1]->setFinishedWithError(TP_QT_ERROR_NOT_AVAILABLE, QLatin1String("Contact is offline"));
+    QTRY_VERIFY(third.isFinished() && fourth.isFinished());
+    QCOMPARE(third.error().name(), TP_QT_ERROR_NOT_AVAILABLE);
+    QCOMPARE(fourth.error().name(), TP_QT_ERROR_NOT_AVAILABLE);
+}
+
 void TestBaseCM::cleanup()
 {
     cleanupImpl();
@@ -0,0 +1,205 @@
+#include <tests/lib/test.h>
+
+#include <TelepathyQt/BaseDebug>
+#include <TelepathyQt/DBusError>
+
+#include <QSignalSpy>
+
+using namespace Tp;
+
+class TestBaseDebug : public Test
+{
+    Q_OBJECT
+public:
+    TestBaseDebug(QObject *parent = nullptr)
+        : Test(parent)
+    { }
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+
+    void testNoLimit();
+    void testRing();
+    void testChangeLimit();
+    void testMonitoring();
+
+    void cleanup();
+    void cleanupTestCase();
+};
+
+static QStringList messageTexts(const DebugMessageList &messages)
+{
+    QStringList texts;
+    Q_FOREACH (const DebugMessage &message, messages) {
+        texts << message.message;
+    }
+    return texts;
+}
+
+// The object emitting the NewDebugMessage D-Bus signal on behalf of debug
+static QObject *debugAdaptee(BaseDebug *debug)
+{
+    Q_FOREACH (QObject *child, debug->children()) {
+        if (child->metaObject()->indexOfSignal(
+                    "newDebugMessage(double,QString,uint,QString)") >= 0) {
+            return child;
+        }
+    }
+    return 0;
+}
+
+static QStringList signalledTexts(const QSignalSpy &spy)
+{
+    QStringList texts;
+    for (int i = 0; i < spy.count(); ++i) {
+        texts << spy.at(i).at(3).toString();
+    }
+    return texts;
+}
+
+void TestBaseDebug::initTestCase()
+{
+    initTestCaseImpl();
+}
+
+void TestBaseDebug::init()
+{
+    initImpl();
+}
+
+void TestBaseDebug::testNoLimit()
+{
+    BaseDebug debug;
+    debug.newDebugMessage(QLatin1String("test"), DebugLevelDebug, QLatin1String("1"));
+
+    DBusError error;
+    QCOMPARE(debug.getMessages(&error).count(), 0);
+    QVERIFY(error.isValid());
+
+    debug.setGetMessagesLimit(-1);
+    for (int i = 0; i < 100; ++i) {
+        debug.newDebugMessage(QLatin1String("test"), DebugLevelDebug, QString::number(i));
+    }
+    DBusError noError;
+    QCOMPARE(debug.getMessages(&noError).count(), 100);
+    QVERIFY(!noError.isValid());
+}
+
+void TestBaseDebug::testRing()
+{
+    BaseDebug debug;
+    debug.setGetMessagesLimit(3);
+    debug.setNewDebugMessageBatchInterval(50);
+    QCOMPARE(debug.newDebugMessageBatchInterval(), 50);
+
+    DBusError error;
+    for (int i = 1; i <= 5; ++i) {
+        debug.newDebugMessage(QLatin1String("test"), DebugLevelInfo, QString::number(i));
+    }
+    QCOMPARE(messageTexts(debug.getMessages(&error)),
+             QStringList() << QLatin1String("3") << QLatin1String("4") << QLatin1String("5"));
+
+    // The snapshot must not change when more messages arrive
+    DebugMessageList snapshot = debug.getMessages(&error);
+    debug.newDebugMessage(QLatin1String("test"), DebugLevelInfo, QLatin1String("6"));
+    QCOMPARE(messageTexts(snapshot),
+             QStringList() << QLatin1String("3") << QLatin1String("4") << QLatin1String("5"));
+    QCOMPARE(messageTexts(debug.getMessages(&error)),
+             QStringList() << QLatin1String("4") << QLatin1String("5") << QLatin1String("6"));
+
+    debug.clear();
+    QCOMPARE(debug.getMessages(&error).count(), 0);
+    QVERIFY(!error.isValid());
+}
+
+void TestBaseDebug::testChangeLimit()
+{
+    BaseDebug debug;
+    debug.setGetMessagesLimit(4);
+
+    DBusError error;
+    for (int i = 1; i <= 6; ++i) {
+        debug.newDebugMessage(QLatin1String("test"), DebugLevelInfo, QString::number(i));
+    }
+
+    debug.setGetMessagesLimit(2);
+    QCOMPARE(messageTexts(debug.getMessages(&error)),
+             QStringList() << QLatin1String("5") << QLatin1String("6"));
+
+    debug.setGetMessagesLimit(3);
+    debug.newDebugMessage(QLatin1String("test"), DebugLevelInfo, QLatin1String("7"));
+    debug.newDebugMessage(QLatin1String("test"), DebugLevelInfo, QLatin1String("8"));
+    QCOMPARE(messageTexts(debug.getMessages(&error)),
+             QStringList() << QLatin1String("6") << QLatin1String("7") << QLatin1String("8"));
+    QVERIFY(!error.isValid());
+}
+
+void TestBaseDebug::testMonitoring()
+{
+    BaseDebug debug;
+    QObject *adaptee = debugAdaptee(&debug);
+    QVERIFY(adaptee != 0);
+    QSignalSpy spy(adaptee, SIGNAL(newDebugMessage(double,QString,uint,QString)));
+
+    // Nothing is signalled while nobody monitors
+    debug.newDebugMessage(QLatin1String("test"), DebugLevelInfo, QLatin1String("0"));
+    QCOMPARE(spy.count(), 0);
+
+    // Without a batch interval each message is signalled as it arrives
+    debug.setEnabled(true);
+    debug.newDebugMessage(1.5, QLatin1String("test"), DebugLevelWarning, QLatin1String("1"));
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toDouble(), 1.5);
+    QCOMPARE(spy.at(0).at(1).toString(), QLatin1String("test"));
+    QCOMPARE(spy.at(0).at(2).toUInt(), static_cast<uint>(DebugLevelWarning));
+    QCOMPARE(spy.at(0).at(3).toString(), QLatin1String("1"));
+    spy.clear();
+
+    // With a batch interval they are queued and signalled together, in order
+    debug.setNewDebugMessageBatchInterval(50);
+    for (int i = 2; i <= 4; ++i) {
+        debug.newDebugMessage(QLatin1String("test"), DebugLevelInfo, QString::number(i));
+    }
+    QCOMPARE(spy.count(), 0);
+    QVERIFY(spy.wait());
+    QCOMPARE(signalledTexts(spy),
+             QStringList() << QLatin1String("2") << QLatin1String("3") << QLatin1String("4"));
+    spy.clear();
+
+    // A full batch is signalled without waiting for the interval
+    for (int i = 0; i < 1024; ++i) {
+        debug.newDebugMessage(QLatin1String("test"), DebugLevelInfo, QString::number(i));
+    }
+    QCOMPARE(spy.count(), 1024);
+    QCOMPARE(spy.first().at(3).toString(), QLatin1String("0"));
+    QCOMPARE(spy.last().at(3).toString(), QLatin1String("1023"));
+    spy.clear();
+
+    // Dropping the interval flushes the queue right away
+    debug.newDebugMessage(QLatin1String("test"), DebugLevelInfo, QLatin1String("5"));
+    QCOMPARE(spy.count(), 0);
+    debug.setNewDebugMessageBatchInterval(0);
+    QCOMPARE(signalledTexts(spy), QStringList() << QLatin1String("5"));
+    spy.clear();
+
+    // Turning monitoring off drops what is still queued
+    debug.setNewDebugMessageBatchInterval(50);
+    debug.newDebugMessage(QLatin1String("test"), DebugLevelInfo, QLatin1String("6"));
+    debug.setEnabled(false);
+    QVERIFY(!spy.wait(200));
+    QCOMPARE(spy.count(), 0);
+}
+
+void TestBaseDebug::cleanup()
+{
+    cleanupImpl();
+}
+
+void TestBaseDebug::cleanupTestCase()
+{
+    cleanupTestCaseImpl();
+}
+
+QTEST_MAIN(TestBaseDebug)
+#include "_gen/base-debug.cpp.moc.hpp"
@@ -47,6 +47,11 @@
 #include <TelepathyQt/IncomingFileTransferChannel>
 #include <TelepathyQt/OutgoingFileTransferChannel>
 
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QLocalSocket>
+
 static const int c_defaultTimeout = 500;
 
 Tp::RequestableChannelClass createRequestableChannelClassFileTransfer()
@@ -352,6 +357,116 @@ protected:
 
 };
 
+// Gives access to the socket handling, to drive a transfer without a client
+class FileTransferType : public Tp::BaseChannelFileTransferType
+{
+public:
+    FileTransferType(const QVariantMap &request)
+        : Tp::BaseChannelFileTransferType(request)
+    {
+    }
+
+    using Tp::BaseChannelFileTransferType::createSocket;
+    using Tp::BaseChannelFileTransferType::socketAddress;
+    using Tp::BaseChannelFileTransferType::setClientSocket;
+};
+
+// An unbuffered input recording the largest read asked for
+class InputDevice : public QBuffer
+{
+public:
+    InputDevice(const QByteArray &data)
+        : mMaxReadSize(0)
+    {
+        setData(data);
+        open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+    }
+
+    qint64 maxReadSize() const { return mMaxReadSize; }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override
+    {
+        mMaxReadSize = qMax(mMaxReadSize, maxSize);
+        return QBuffer::readData(data, maxSize);
+    }
+
+private:
+    qint64 mMaxReadSize;
+};
+
+// An output keeping what is written as pending until drain() is called, like a
+// socket to a slow peer, unless it drains immediately
+class OutputDevice : public QIODevice
+{
+public:
+    OutputDevice(bool drainImmediately)
+        : mDrainImmediately(drainImmediately)
+    {
+        open(QIODevice::WriteOnly);
+    }
+
+    bool isSequential() const override { return true; }
+    qint64 bytesToWrite() const override { return mPending.size(); }
+
+    QByteArray written() const { return mWritten; }
+
+    qint64 drain()
+    {
+        qint64 count = mPending.size();
+        mWritten.append(mPending);
+        mPending.clear();
+        if (count) {
+            Q_EMIT bytesWritten(count);
+        }
+        return count;
+    }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override
+    {
+        Q_UNUSED(data);
+        Q_UNUSED(maxSize);
+        return -1;
+    }
+
+    qint64 writeData(const char *data, qint64 size) override
+    {
+        if (mDrainImmediately) {
+            mWritten.append(data, size);
+        } else {
+            mPending.append(data, size);
+        }
+        return size;
+    }
+
+private:
+    bool mDrainImmediately;
+    QByteArray mPending;
+    QByteArray mWritten;
+};
+
+// The D-Bus adaptee of a file transfer, which emits TransferredBytesChanged
+static QObject *transferAdaptee(QObject *transfer)
+{
+    Q_FOREACH (QObject *child, transfer->children()) {
+        if (child->metaObject()->indexOfSignal("transferredBytesChanged(qulonglong)") >= 0) {
+            return child;
+        }
+    }
+    return nullptr;
+}
+
+static QVariantMap outgoingTransferRequest(qulonglong size)
+{
+    QVariantMap request;
+    request[TP_QT_IFACE_CHANNEL + QLatin1String(".Requested")] = true;
+    request[TP_QT_IFACE_CHANNEL_TYPE_FILE_TRANSFER + QLatin1String(".Filename")] = QLatin1String("file.txt");
+    request[TP_QT_IFACE_CHANNEL_TYPE_FILE_TRANSFER + QLatin1String(".ContentType")] = c_fileContentType;
+    request[TP_QT_IFACE_CHANNEL_TYPE_FILE_TRANSFER + QLatin1String(".Size")] = size;
+    return request;
+}
+
 } // namespace FTTest
 
 using namespace TestFileTransferCM;
@@ -377,6 +492,10 @@ private Q_SLOTS:
     void testSendFile_data();
     void testReceiveFile();
     void testReceiveFile_data();
+    void testTransferChunks();
+    void testTransferStall();
+    void testTransferredBytesThrottling();
+    void testUnixSocket();
 
     void cleanup();
     void cleanupTestCase();
@@ -529,6 +648,10 @@ void TestBaseFileTranfserChannel::testSendFile()
     QVERIFY(!svcTransferChannel.isNull());
 
     QCOMPARE(int(svcTransferChannel->state()), int(Tp::FileTransferStatePending));
+    QCOMPARE(svcTransferChannel->transferredBytesNotificationInterval(), 1000);
+
+    // The intermediate progress is checked below, so don't throttle it
+    svcTransferChannel->setTransferredBytesNotificationInterval(0);
 
     ClientFileTransferStateSpy spyCliState;
     connect(cliTransferChannel.data(), SIGNAL(stateChanged(Tp::FileTransferState,Tp::FileTransferStateChangeReason)), &spyCliState, SLOT(trigger(Tp::FileTransferState,Tp::FileTransferStateChangeReason)));
@@ -746,6 +869,7 @@ void TestBaseFileTranfserChannel::testReceiveFile()
     QCOMPARE(int(cliTransferChannel->size()), fileSize);
 
     Tp::BaseChannelFileTransferTypePtr svcTransferChannel = Tp::BaseChannelFileTransferTypePtr::dynamicCast(svcTransferBaseChannel->interface(TP_QT_IFACE_CHANNEL_TYPE_FILE_TRANSFER));
+    svcTransferChannel->setTransferredBytesNotificationInterval(0);
 
     Tp::IODevice cliInputDevice;
     cliInputDevice.open(QIODevice::ReadWrite);
@@ -902,6 +1026,148 @@ void TestBaseFileTranfserChannel::testReceiveFile_data()
     QTest::newRow("Cancel in the middle of the data") << 2048 << 0 << int(CancelBeforeComplete)<< true << false;
 }
 
+void TestBaseFileTranfserChannel::testTransferChunks()
+{
+    // More than a single run of doTransfer() copies
+    const QByteArray data = generateFileContent(6 * 1024 * 1024 + 1000);
+    InputDevice input(data);
+    OutputDevice output(/* drainImmediately */ true);
+
+    Tp::SharedPtr<FileTransferType> transfer =
+            Tp::BaseChannelFileTransferType::create<FileTransferType>(outgoingTransferRequest(data.size()));
+    QVERIFY(transfer->remoteAcceptFile(&output, 0));
+    transfer->setClientSocket(&input);
+    QCOMPARE(int(transfer->state()), int(Tp::FileTransferStateOpen));
+
+    // Run the queued transfer once: it reads 64 KiB blocks until 4 MiB are copied
+    QCoreApplication::sendPostedEvents(transfer.data(), QEvent::MetaCall);
+    QCOMPARE(input.maxReadSize(), qint64(64 * 1024));
+    QCOMPARE(output.written(), data.left(4 * 1024 * 1024));
+
+    // then yields to the event loop, to copy the rest on the next run
+    QCoreApplication::sendPostedEvents(transfer.data(), QEvent::MetaCall);
+    QCOMPARE(output.written(), data);
+}
+
+void TestBaseFileTranfserChannel::testTransferStall()
+{
+    const QByteArray data = generateFileContent(3 * 1024 * 1024);
+    InputDevice input(data);
+    OutputDevice output(/* drainImmediately */ false);
+
+    Tp::SharedPtr<FileTransferType> transfer =
+            Tp::BaseChannelFileTransferType::create<FileTransferType>(outgoingTransferRequest(data.size()));
+    QVERIFY(transfer->remoteAcceptFile(&output, 0));
+    transfer->setClientSocket(&input);
+
+    // Copying stops once more than 1 MiB waits to be written
+    static const qint64 stallSize = 1024 * 1024 + 64 * 1024;
+    QCoreApplication::sendPostedEvents(transfer.data(), QEvent::MetaCall);
+    QCOMPARE(output.bytesToWrite(), stallSize);
+    QCOMPARE(input.pos(), stallSize);
+
+    // and nothing is retried until the output makes progress
+    QCoreApplication::processEvents();
+    QCOMPARE(output.bytesToWrite(), stallSize);
+    QCOMPARE(input.pos(), stallSize);
+
+    // Each drain resumes the copy
+    QCOMPARE(output.drain(), stallSize);
+    QCOMPARE(output.bytesToWrite(), stallSize);
+    QCOMPARE(input.pos(), 2 * stallSize);
+
+    while (output.drain() > 0) {
+        QCoreApplication::processEvents();
+    }
+    QCOMPARE(output.written(), data);
+}
+
+void TestBaseFileTranfserChannel::testTransferredBytesThrottling()
+{
+    static const int interval = 200;
+    static const qulonglong size = 1000;
+
+    Tp::SharedPtr<FileTransferType> transfer =
+            Tp::BaseChannelFileTransferType::create<FileTransferType>(outgoingTransferRequest(size));
+    transfer->setTransferredBytesNotificationInterval(interval);
+    QObject *adaptee = transferAdaptee(transfer.data());
+    QVERIFY(adaptee);
+    QSignalSpy spyTransferredBytes(adaptee, SIGNAL(transferredBytesChanged(qulonglong)));
+
+    // The first change is signalled right away
+    transfer->setTransferredBytes(1);
+    QCOMPARE(spyTransferredBytes.count(), 1);
+    QCOMPARE(spyTransferredBytes.last().at(0).toULongLong(), qulonglong(1));
+
+    // and the ones made within the interval are coalesced into a single signal,
+    // carrying the latest count
+    for (qulonglong count = 2; count < size / 2; ++count) {
+        transfer->setTransferredBytes(count);
+    }
+    QCOMPARE(spyTransferredBytes.count(), 1);
+    QTRY_COMPARE_WITH_TIMEOUT(spyTransferredBytes.count(), 2, 2 * interval);
+    QCOMPARE(spyTransferredBytes.last().at(0).toULongLong(), size / 2 - 1);
+
+    // Steady progress is signalled at most once per interval
+    QElapsedTimer elapsed;
+    elapsed.start();
+    qulonglong count = size / 2;
+    while (elapsed.elapsed() < 3 * interval) {
+        transfer->setTransferredBytes(count++);
+        QTest::qWait(5);
+    }
+    QVERIFY(spyTransferredBytes.count() <= 2 + int(elapsed.elapsed() / interval) + 1);
+    QVERIFY(spyTransferredBytes.count() > 2);
+
+    // The final count is always signalled right away, before the completion
+    QSignalSpy spyState(transfer.data(), SIGNAL(stateChanged(uint,uint)));
+    int notifications = spyTransferredBytes.count();
+    transfer->setTransferredBytes(size);
+    QCOMPARE(spyTransferredBytes.count(), notifications + 1);
+    QCOMPARE(spyTransferredBytes.last().at(0).toULongLong(), size);
+    QCOMPARE(spyState.count(), 1);
+    QCOMPARE(spyState.last().at(0).toUInt(), uint(Tp::FileTransferStateCompleted));
+
+    // and no outdated count follows it
+    QTest::qWait(2 * interval);
+    QCOMPARE(spyTransferredBytes.count(), notifications + 1);
+}
+
+void TestBaseFileTranfserChannel::testUnixSocket()
+{
+    const QByteArray data = generateFileContent(256 * 1024);
+    QBuffer output;
+    output.open(QIODevice::WriteOnly);
+
+    Tp::SharedPtr<FileTransferType> transfer =
+            Tp::BaseChannelFileTransferType::create<FileTransferType>(outgoingTransferRequest(data.size()));
+    QVERIFY(transfer->availableSocketTypes().contains(Tp::SocketAddressTypeUnix));
+    QVERIFY(transfer->remoteAcceptFile(&output, 0));
+
+    Tp::DBusError error;
+    QVERIFY(transfer->createSocket(Tp::SocketAddressTypeUnix, Tp::SocketAccessControlLocalhost,
+                QDBusVariant(QVariant(QString())), &error));
+    QVERIFY(!error.isValid());
+
+    // The address is the socket path, as a byte array
+    QByteArray address = transfer->socketAddress().variant().toByteArray();
+    QVERIFY(!address.isEmpty());
+
+    QLocalSocket socket;
+    socket.connectToServer(QFile::decodeName(address));
+    QVERIFY(socket.waitForConnected(c_defaultTimeout));
+    QTRY_COMPARE(int(transfer->state()), int(Tp::FileTransferStateOpen));
+
+    QCOMPARE(socket.write(data), qint64(data.size()));
+    QTRY_COMPARE(output.data().size(), data.size());
+    QCOMPARE(output.data(), data);
+
+    // A second socket can't be created for the same transfer
+    QVERIFY(!transfer->createSocket(Tp::SocketAddressTypeUnix, Tp::SocketAccessControlLocalhost,
+                QDBusVariant(QVariant(QString())), &error));
+    QCOMPARE(error.name(), TP_QT_ERROR_NOT_AVAILABLE);
+}
+
 void TestBaseFileTranfserChannel::cleanup()
 {
     cleanupImpl();
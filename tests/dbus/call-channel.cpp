@@ -59,6 +59,7 @@ private Q_SLOTS:
     void testHold();
     void testHangup();
     void testCallMembers();
+    void testCoalescedCallMembers();
     void testDTMF();
     void testFeatureCore();
 
@@ -75,7 +76,9 @@ private:
     CallState mCallState;
     CallFlags mCallFlags;
     QHash<ContactPtr, CallMemberFlags> mRemoteMemberFlags;
+    QList<QHash<ContactPtr, CallMemberFlags> > mRemoteMemberFlagsChanges;
     Contacts mRemoteMembersRemoved;
+    CallStateReason mRemoteMembersRemovedReason;
     SendingState mLSSCReturn;
     QQueue<uint> mLocalHoldStates;
     QQueue<uint> mLocalHoldStateReasons;
@@ -175,6 +178,7 @@ void TestCallChannel::onRemoteMemberFlagsChanged(
         const CallStateReason &reason)
 {
     mRemoteMemberFlags = remoteMemberFlags;
+    mRemoteMemberFlagsChanges.append(remoteMemberFlags);
     mLoop->exit(0);
 }
 
@@ -182,6 +186,7 @@ void TestCallChannel::onRemoteMembersRemoved(const Tp::Contacts &remoteMembers,
         const Tp::CallStateReason &reason)
 {
     mRemoteMembersRemoved = remoteMembers;
+    mRemoteMembersRemovedReason = reason;
 }
 
 void TestCallChannel::onRemoteSendingStateChanged(
@@ -274,7 +279,9 @@ void TestCallChannel::init()
     mCallState = CallStateUnknown;
     mCallFlags = (CallFlags) nullptr;
     mRemoteMemberFlags.clear();
+    mRemoteMemberFlagsChanges.clear();
     mRemoteMembersRemoved.clear();
+    mRemoteMembersRemovedReason = CallStateReason();
     mLSSCReturn = (Tp::SendingState) -1;
     mLocalHoldStates.clear();
     mLocalHoldStateReasons.clear();
@@ -814,6 +821,89 @@ void TestCallChannel::testCallMembers()
     QCOMPARE(mChan->contents().size(), 0);
 }
 
+void TestCallChannel::testCoalescedCallMembers()
+{
+    QList<ContactPtr> contacts = mConn->contacts(QStringList() << QLatin1String("carol"));
+    QCOMPARE(contacts.size(), 1);
+    ContactPtr otherContact = contacts.at(0);
+
+    QVariantMap request;
+    request.insert(TP_QT_IFACE_CHANNEL + QLatin1String(".ChannelType"),
+                   TP_QT_IFACE_CHANNEL_TYPE_CALL);
+    request.insert(TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandleType"),
+                   (uint) Tp::HandleTypeContact);
+    request.insert(TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandle"),
+                   otherContact->handle()[0]);
+    request.insert(TP_QT_IFACE_CHANNEL_TYPE_CALL + QLatin1String(".InitialAudio"),
+                   true);
+    mChan = CallChannelPtr::qObjectCast(mConn->createChannel(request));
+    QVERIFY(mChan);
+
+    Features features;
+    features << CallChannel::FeatureCallState
+             << CallChannel::FeatureCallMembers
+             << CallChannel::FeatureContents;
+    QVERIFY(connect(mChan->becomeReady(features),
+                    SIGNAL(finished(Tp::PendingOperation*)),
+                    SLOT(expectSuccessfulCall(Tp::PendingOperation*))));
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(mChan->remoteMembers().size(), 1);
+
+    QVERIFY(connect(mChan.data(),
+                    SIGNAL(remoteMemberFlagsChanged(QHash<Tp::ContactPtr,Tp::CallMemberFlags>,Tp::CallStateReason)),
+                    SLOT(onRemoteMemberFlagsChanged(QHash<Tp::ContactPtr,Tp::CallMemberFlags>,Tp::CallStateReason))));
+    QVERIFY(connect(mChan.data(),
+                    SIGNAL(remoteMembersRemoved(Tp::Contacts,Tp::CallStateReason)),
+                    SLOT(onRemoteMembersRemoved(Tp::Contacts,Tp::CallStateReason))));
+
+    // Change the members on the service side several times in a row. The first
+    // change is being resolved, as dave is not known yet, while the others
+    // arrive, so these must be merged into a single net change.
+    TpBaseCallChannel *svcChan = TP_BASE_CALL_CHANNEL(dbus_g_connection_lookup_g_object(
+                dbus_g_bus_get(DBUS_BUS_STARTER, nullptr),
+                mChan->objectPath().toLatin1().constData()));
+    QVERIFY(svcChan != nullptr);
+
+    TpHandleRepoIface *contactRepo = tp_base_connection_get_handles(
+            TP_BASE_CONNECTION(mConn->service()), TP_HANDLE_TYPE_CONTACT);
+    TpHandle carol = otherContact->handle()[0];
+    TpHandle dave = tp_handle_ensure(contactRepo, "dave", nullptr, nullptr);
+    QVERIFY(dave != 0);
+
+    tp_base_call_channel_update_member_flags(svcChan, dave, TP_CALL_MEMBER_FLAG_RINGING,
+            0, TP_CALL_STATE_CHANGE_REASON_PROGRESS_MADE, "", "");
+    tp_base_call_channel_update_member_flags(svcChan, carol, TP_CALL_MEMBER_FLAG_RINGING,
+            0, TP_CALL_STATE_CHANGE_REASON_PROGRESS_MADE, "", "");
+    tp_base_call_channel_remove_member(svcChan, carol,
+            0, TP_CALL_STATE_CHANGE_REASON_REJECTED, "", "");
+    tp_base_call_channel_update_member_flags(svcChan, dave, TP_CALL_MEMBER_FLAG_HELD,
+            0, TP_CALL_STATE_CHANGE_REASON_PROGRESS_MADE, "", "");
+
+    while (mRemoteMembersRemoved.isEmpty()) {
+        QCOMPARE(mLoop->exec(), 0);
+    }
+    processDBusQueue(mChan.data());
+
+    // one update for the first change, and a single one for the rest
+    QCOMPARE(mRemoteMemberFlagsChanges.size(), 2);
+    QCOMPARE(mRemoteMemberFlagsChanges.at(0).size(), 1);
+    QCOMPARE(mRemoteMemberFlagsChanges.at(0).constBegin().key()->id(), QString::fromLatin1("dave"));
+    QCOMPARE(mRemoteMemberFlagsChanges.at(0).constBegin().value(), CallMemberFlags(CallMemberFlagRinging));
+
+    // carol was removed after being updated, so she is only reported as removed
+    QCOMPARE(mRemoteMemberFlagsChanges.at(1).size(), 1);
+    QCOMPARE(mRemoteMemberFlagsChanges.at(1).constBegin().key()->id(), QString::fromLatin1("dave"));
+    QCOMPARE(mRemoteMemberFlagsChanges.at(1).constBegin().value(), CallMemberFlags(CallMemberFlagHeld));
+
+    QCOMPARE(mRemoteMembersRemoved.size(), 1);
+    QCOMPARE((*mRemoteMembersRemoved.constBegin())->id(), QString::fromLatin1("carol"));
+    QCOMPARE(mRemoteMembersRemovedReason.reason, (uint) CallStateChangeReasonRejected);
+
+    QCOMPARE(mChan->remoteMembers().size(), 1);
+    QCOMPARE((*mChan->remoteMembers().constBegin())->id(), QString::fromLatin1("dave"));
+    QVERIFY(mChan->remoteMemberFlags(*mChan->remoteMembers().constBegin()).testFlag(CallMemberFlagHeld));
+}
+
 void TestCallChannel::testDTMF()
 {
     mConn->client()->lowlevel()->setSelfPresence(QLatin1String("away"), QLatin1String("preparing for a test"));
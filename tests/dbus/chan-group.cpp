@@ -38,6 +38,12 @@ protected Q_SLOTS:
             const Tp::Contacts &groupRemotePendingMembersAdded,
             const Tp::Contacts &groupMembersRemoved,
             const Tp::Channel::GroupMemberChangeDetails &details);
+    void onGroupMemberHandlesChanged(
+            const Tp::UIntList &groupMembersAdded,
+            const Tp::UIntList &groupLocalPendingMembersAdded,
+            const Tp::UIntList &groupRemotePendingMembersAdded,
+            const Tp::UIntList &groupMembersRemoved,
+            const QVariantMap &details);
     void onGroupFlagsChanged(Tp::ChannelGroupFlags flags,
             Tp::ChannelGroupFlags added, Tp::ChannelGroupFlags removed);
 
@@ -48,6 +54,7 @@ private Q_SLOTS:
     void testCreateChannel();
     void testMCDGroup();
     void testPropertylessGroup();
+    void testMemberHandles();
     void testLeave();
     void testLeaveWithFallback();
     void testGroupFlagsChange();
@@ -70,6 +77,7 @@ private:
     Contacts mChangedRP;
     Contacts mChangedRemoved;
     Channel::GroupMemberChangeDetails mDetails;
+    UIntList mChangedRemovedHandles;
     UIntList mInitialMembers;
     bool mGotGroupFlagsChanged;
     ChannelGroupFlags mGroupFlags;
@@ -94,6 +102,23 @@ void TestChanGroup::onGroupMembersChanged(
     mLoop->exit(0);
 }
 
+void TestChanGroup::onGroupMemberHandlesChanged(
+        const UIntList &groupMembersAdded,
+        const UIntList &groupLocalPendingMembersAdded,
+        const UIntList &groupRemotePendingMembersAdded,
+        const UIntList &groupMembersRemoved,
+        const QVariantMap &details)
+{
+    Q_UNUSED(groupMembersAdded);
+    Q_UNUSED(groupLocalPendingMembersAdded);
+    Q_UNUSED(groupRemotePendingMembersAdded);
+    Q_UNUSED(details);
+
+    qDebug() << "group member handles changed";
+    mChangedRemovedHandles = groupMembersRemoved;
+    mLoop->exit(0);
+}
+
 void TestChanGroup::onGroupFlagsChanged(Tp::ChannelGroupFlags flags,
         Tp::ChannelGroupFlags added, Tp::ChannelGroupFlags removed)
 {
@@ -156,6 +181,7 @@ void TestChanGroup::init()
     mChangedLP.clear();
     mChangedRP.clear();
     mChangedRemoved.clear();
+    mChangedRemovedHandles.clear();
     mDetails = Channel::GroupMemberChangeDetails();
     mGotGroupFlagsChanged = false;
     mGroupFlags = (ChannelGroupFlags) nullptr;
@@ -320,6 +346,102 @@ void TestChanGroup::commonTest(gboolean properties)
     QCOMPARE(mChan->groupContacts().count(), 3);
 }
 
+void TestChanGroup::testMemberHandles()
+{
+    mChanObjectPath = QString(QLatin1String("%1/ChannelForTpQtHandlesTest"))
+        .arg(mConn->objectPath());
+    QByteArray chanPathLatin1(mChanObjectPath.toLatin1());
+
+    mChanService = TP_TESTS_TEXT_CHANNEL_GROUP(g_object_new(
+                TP_TESTS_TYPE_TEXT_CHANNEL_GROUP,
+                "connection", mConn->service(),
+                "object-path", chanPathLatin1.data(),
+                "detailed", TRUE,
+                "properties", TRUE,
+                NULL));
+    QVERIFY(mChanService != nullptr);
+
+    TpIntSet *members = tp_intset_sized_new(mInitialMembers.length());
+    Q_FOREACH (uint handle, mInitialMembers)
+        tp_intset_add(members, handle);
+
+    QVERIFY(tp_group_mixin_change_members(G_OBJECT(mChanService), "be there or be []",
+                members, nullptr, nullptr, nullptr, 0, TP_CHANNEL_GROUP_CHANGE_REASON_NONE));
+
+    tp_intset_destroy(members);
+
+    mChan = Channel::create(mConn->client(), mChanObjectPath, QVariantMap());
+    QVERIFY(mChan);
+
+    QVERIFY(connect(mChan->becomeReady(Features() << Channel::FeatureGroupMemberHandles),
+                    SIGNAL(finished(Tp::PendingOperation*)),
+                    SLOT(expectSuccessfulCall(Tp::PendingOperation*))));
+    QCOMPARE(mLoop->exec(), 0);
+    QVERIFY(mChan->isReady(Channel::FeatureGroupMemberHandles));
+
+    // No contacts are built for the members
+    QVERIFY(mChan->groupContacts().isEmpty());
+    QCOMPARE(mChan->groupMemberHandles().count(), 4);
+    QVERIFY(mChan->groupMemberHandles().contains(mContacts[0]->handle()[0]));
+    QVERIFY(mChan->groupLocalPendingMemberHandles().isEmpty());
+    QVERIFY(mChan->groupRemotePendingMemberHandles().isEmpty());
+
+    // Contacts can be built on demand for a subset of the members
+    PendingContacts *pc = mChan->groupContactsForHandles(
+            UIntList() << mContacts[0]->handle()[0]);
+    QVERIFY(connect(pc,
+                    SIGNAL(finished(Tp::PendingOperation*)),
+                    SLOT(expectSuccessfulCall(Tp::PendingOperation*))));
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(pc->contacts().size(), 1);
+    QCOMPARE(pc->contacts().first(), mContacts[0]);
+
+    QVERIFY(connect(mChan.data(),
+                    SIGNAL(groupMemberHandlesChanged(
+                            const Tp::UIntList &,
+                            const Tp::UIntList &,
+                            const Tp::UIntList &,
+                            const Tp::UIntList &,
+                            const QVariantMap &)),
+                    SLOT(onGroupMemberHandlesChanged(
+                            const Tp::UIntList &,
+                            const Tp::UIntList &,
+                            const Tp::UIntList &,
+                            const Tp::UIntList &,
+                            const QVariantMap &))));
+    QVERIFY(connect(mChan.data(),
+                    SIGNAL(groupMembersChanged(
+                            const Tp::Contacts &,
+                            const Tp::Contacts &,
+                            const Tp::Contacts &,
+                            const Tp::Contacts &,
+                            const Tp::Channel::GroupMemberChangeDetails &)),
+                    SLOT(onGroupMembersChanged(
+                            const Tp::Contacts &,
+                            const Tp::Contacts &,
+                            const Tp::Contacts &,
+                            const Tp::Contacts &,
+                            const Tp::Channel::GroupMemberChangeDetails &))));
+
+    TpIntSet *remove = tp_intset_new_containing(mContacts[0]->handle()[0]);
+
+    QVERIFY(tp_group_mixin_change_members(G_OBJECT(mChanService), "be a []",
+                nullptr, remove, nullptr, nullptr, 0, TP_CHANNEL_GROUP_CHANGE_REASON_NONE));
+
+    tp_intset_destroy(remove);
+
+    while (mChangedRemovedHandles.isEmpty()) {
+        QCOMPARE(mLoop->exec(), 0);
+    }
+    QCOMPARE(mChangedRemovedHandles, UIntList() << mContacts[0]->handle()[0]);
+    QCOMPARE(mChan->groupMemberHandles().count(), 3);
+
+    // groupMembersChanged is not emitted for members tracked as handles only
+    processDBusQueue(mChan.data());
+    QVERIFY(mChangedRemoved.isEmpty());
+    QVERIFY(mChan->groupContacts().isEmpty());
+}
+
 void TestChanGroup::testLeave()
 {
     mChan = mConn->ensureChannel(TP_QT_IFACE_CHANNEL_TYPE_CONTACT_LIST,
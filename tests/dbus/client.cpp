@@ -11,19 +11,25 @@
 #include <TelepathyQt/AccountManager>
 #include <TelepathyQt/AbstractClientHandler>
 #include <TelepathyQt/AbstractClientObserver>
+#include <TelepathyQt/AccountFactory>
 #include <TelepathyQt/Channel>
 #include <TelepathyQt/ChannelClassSpec>
 #include <TelepathyQt/ChannelDispatchOperation>
+#include <TelepathyQt/ChannelFactory>
 #include <TelepathyQt/ChannelRequest>
 #include <TelepathyQt/ClientHandlerInterface>
 #include <TelepathyQt/ClientInterfaceRequestsInterface>
 #include <TelepathyQt/ClientObserverInterface>
 #include <TelepathyQt/ClientRegistrar>
 #include <TelepathyQt/Connection>
+#include <TelepathyQt/ConnectionFactory>
 #include <TelepathyQt/ConnectionLowlevel>
+#include <TelepathyQt/ContactFactory>
 #include <TelepathyQt/MethodInvocationContext>
 #include <TelepathyQt/PendingAccount>
 #include <TelepathyQt/PendingReady>
+#include <TelepathyQt/ReadinessHelper>
+#include <TelepathyQt/TextChannel>
 
 #include <telepathy-glib/debug.h>
 
@@ -228,6 +234,8 @@ public:
     {
     }
 
+    using AbstractClientObserver::setObserverReadinessTimeout;
+
     void observeChannels(const MethodInvocationContextPtr<> &context,
             const AccountPtr &account,
             const ConnectionPtr &connection,
@@ -340,6 +348,47 @@ Q_SIGNALS:
     void channelClosed();
 };
 
+// A text channel with an extra feature, which never becomes ready for the channel at slowPath
+class SlowTextChannel : public TextChannel
+{
+public:
+    static const Feature FeatureSlow;
+    static QString slowPath;
+
+    static SharedPtr<SlowTextChannel> create(const ConnectionPtr &connection,
+            const QString &objectPath, const QVariantMap &immutableProperties)
+    {
+        return SharedPtr<SlowTextChannel>(new SlowTextChannel(connection, objectPath,
+                    immutableProperties));
+    }
+
+protected:
+    SlowTextChannel(const ConnectionPtr &connection, const QString &objectPath,
+            const QVariantMap &immutableProperties)
+        : TextChannel(connection, objectPath, immutableProperties)
+    {
+        ReadinessHelper::Introspectables introspectables;
+        introspectables[FeatureSlow] = ReadinessHelper::Introspectable(
+                QSet<uint>() << 0,
+                Features() << Channel::FeatureCore,
+                QStringList(),
+                (ReadinessHelper::IntrospectFunc) &SlowTextChannel::introspectSlow,
+                this);
+        readinessHelper()->addIntrospectables(introspectables);
+    }
+
+private:
+    static void introspectSlow(SlowTextChannel *self)
+    {
+        if (self->objectPath() != slowPath) {
+            self->readinessHelper()->setIntrospectCompleted(FeatureSlow, true);
+        }
+    }
+};
+
+const Feature SlowTextChannel::FeatureSlow = Feature(QLatin1String("SlowTextChannel"), 0);
+QString SlowTextChannel::slowPath;
+
 class TestClient : public Test
 {
     Q_OBJECT
@@ -366,6 +415,7 @@ private Q_SLOTS:
     void testRegister();
     void testCapabilities();
     void testObserveChannels();
+    void testObserveChannelsWithReadinessTimeout();
     void testAddDispatchOperation();
     void testRequests();
     void testHandleChannels();
@@ -709,6 +759,88 @@ void TestClient::testObserveChannels()
             mClientObject2BusName, mClientObject2Path);
 }
 
+void TestClient::testObserveChannelsWithReadinessTimeout()
+{
+    MyClient *client = dynamic_cast<MyClient*>(mClientObject1.data());
+    QCOMPARE(client->observerReadinessTimeout(), -1);
+
+    // Everything becomes ready well within the timeout, so the observer should be handed the
+    // same objects as without one
+    client->setObserverReadinessTimeout(5000);
+    QCOMPARE(client->observerReadinessTimeout(), 5000);
+    testObserveChannelsCommon(mClientObject1,
+            mClientObject1BusName, mClientObject1Path);
+    QVERIFY(client->mObserveChannelsAccount->isReady());
+    QVERIFY(client->mObserveChannelsConnection->isReady());
+    QVERIFY(client->mObserveChannelsChannels.first()->isReady());
+
+    // The same account and connection objects are handed over again, even with nothing but the
+    // observer adaptor referencing them in the meantime
+    WeakPtr<Account> acc(client->mObserveChannelsAccount);
+    WeakPtr<Connection> conn(client->mObserveChannelsConnection);
+    client->mObserveChannelsAccount.reset();
+    client->mObserveChannelsConnection.reset();
+    client->mObserveChannelsChannels.clear();
+    client->mObserveChannelsRequestsSatisfied.clear();
+    mLoop->processEvents();
+    QVERIFY(!acc.isNull());
+    QVERIFY(!conn.isNull());
+    testObserveChannelsCommon(mClientObject1,
+            mClientObject1BusName, mClientObject1Path);
+    QCOMPARE(client->mObserveChannelsAccount, AccountPtr(acc));
+    QCOMPARE(client->mObserveChannelsConnection, ConnectionPtr(conn));
+
+    client->setObserverReadinessTimeout(-1);
+
+    // A channel which is still not ready once the timeout passes is left out
+    QDBusConnection bus = mClientRegistrar->dbusConnection();
+    ChannelFactoryPtr chanFactory = ChannelFactory::create(bus);
+    chanFactory->setSubclassForTextChats<SlowTextChannel>();
+    chanFactory->addFeaturesForTextChats(Features() << SlowTextChannel::FeatureSlow);
+    SlowTextChannel::slowPath = mText2ChanPath;
+    ClientRegistrarPtr registrar = ClientRegistrar::create(bus, AccountFactory::create(bus),
+            ConnectionFactory::create(bus), chanFactory, ContactFactory::create());
+
+    AbstractClientPtr slowClientObject = MyClient::create(
+            ChannelClassSpecList() << ChannelClassSpec::textChat(), mClientCapabilities);
+    MyClient *slowClient = dynamic_cast<MyClient*>(slowClientObject.data());
+    slowClient->setObserverReadinessTimeout(1000);
+    QVERIFY(registrar->registerClient(slowClientObject, QLatin1String("slow")));
+    connect(slowClient,
+            SIGNAL(observeChannelsFinished()),
+            SLOT(expectSignalEmission()));
+
+    QVariantMap textChatProperties;
+    textChatProperties.insert(TP_QT_IFACE_CHANNEL + QLatin1String(".ChannelType"),
+            TP_QT_IFACE_CHANNEL_TYPE_TEXT);
+    textChatProperties.insert(TP_QT_IFACE_CHANNEL + QLatin1String(".TargetHandleType"),
+            (uint) Tp::HandleTypeContact);
+    ChannelDetailsList channelDetailsList;
+    ChannelDetails text1Details = { QDBusObjectPath(mText1ChanPath), textChatProperties };
+    ChannelDetails text2Details = { QDBusObjectPath(mText2ChanPath), textChatProperties };
+    channelDetailsList << text1Details << text2Details;
+
+    ClientObserverInterface *observeIface = new ClientObserverInterface(bus,
+            QLatin1String("org.freedesktop.Telepathy.Client.slow"),
+            QLatin1String("/org/freedesktop/Telepathy/Client/slow"), this);
+    observeIface->ObserveChannels(QDBusObjectPath(mAccount->objectPath()),
+            QDBusObjectPath(mConn->objectPath()),
+            channelDetailsList,
+            QDBusObjectPath("/"),
+            ObjectPathList(),
+            QVariantMap());
+    QCOMPARE(mLoop->exec(), 0);
+
+    QCOMPARE(slowClient->mObserveChannelsAccount->objectPath(), mAccount->objectPath());
+    QCOMPARE(slowClient->mObserveChannelsConnection->objectPath(), mConn->objectPath());
+    QCOMPARE(slowClient->mObserveChannelsChannels.size(), 1);
+    QCOMPARE(slowClient->mObserveChannelsChannels.first()->objectPath(), mText1ChanPath);
+    QVERIFY(slowClient->mObserveChannelsChannels.first()->isReady(
+                Features() << SlowTextChannel::FeatureSlow));
+
+    QVERIFY(registrar->unregisterClient(slowClientObject));
+}
+
 void TestClient::testAddDispatchOperation()
 {
     QDBusConnection bus = mClientRegistrar->dbusConnection();
@@ -28,6 +28,7 @@ protected Q_SLOTS:
     void onSearchStateChanged(Tp::ChannelContactSearchState state, const QString &errorName,
         const Tp::ContactSearchChannel::SearchStateChangeDetails &details);
     void onSearchResultReceived(const Tp::ContactSearchChannel::SearchResult &result);
+    void onRawSearchResultReceived(const Tp::ContactSearchResultMap &result);
     void onSearchReturned(Tp::PendingOperation *op);
 
 private Q_SLOTS:
@@ -54,6 +55,7 @@ private:
     TpTestsContactSearchChannel *mChan2Service;
 
     ContactSearchChannel::SearchResult mSearchResult;
+    ContactSearchResultMap mRawSearchResult;
     bool mSearchReturned;
 
     struct SearchStateChangeInfo
@@ -87,6 +89,13 @@ void TestContactSearchChan::onSearchResultReceived(
     mLoop->exit(0);
 }
 
+void TestContactSearchChan::onRawSearchResultReceived(const Tp::ContactSearchResultMap &result)
+{
+    // Delivered before the contacts are built
+    QVERIFY(mSearchResult.isEmpty());
+    mRawSearchResult = result;
+}
+
 void TestContactSearchChan::onSearchReturned(Tp::PendingOperation *op)
 {
     TEST_VERIFY_OP(op);
@@ -135,6 +144,7 @@ void TestContactSearchChan::init()
 {
     initImpl();
     mSearchResult.clear();
+    mRawSearchResult.clear();
     mSearchStateChangeInfoList.clear();
     mSearchReturned = false;
 }
@@ -165,6 +175,9 @@ void TestContactSearchChan::testContactSearch()
     QVERIFY(connect(mChan1.data(),
                 SIGNAL(searchResultReceived(const Tp::ContactSearchChannel::SearchResult &)),
                 SLOT(onSearchResultReceived(const Tp::ContactSearchChannel::SearchResult &))));
+    QVERIFY(connect(mChan1.data(),
+                SIGNAL(rawSearchResultReceived(const Tp::ContactSearchResultMap &)),
+                SLOT(onRawSearchResultReceived(const Tp::ContactSearchResultMap &))));
 
     QVERIFY(connect(mChan1->search(QLatin1String("employer"), QLatin1String("Collabora")),
                 SIGNAL(finished(Tp::PendingOperation *)),
@@ -222,6 +235,10 @@ void TestContactSearchChan::testContactSearch()
     fns.sort();
     QCOMPARE(fns, expectedFns);
 
+    QStringList rawIds = mRawSearchResult.keys();
+    rawIds.sort();
+    QCOMPARE(rawIds, expectedIds);
+
     mChan1.reset();
 }
 
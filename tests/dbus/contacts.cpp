@@ -43,6 +43,7 @@ protected Q_SLOTS:
     void expectConnReady(Tp::ConnectionStatus, Tp::ConnectionStatusReason);
     void expectConnInvalidated();
     void expectPendingContactsFinished(Tp::PendingOperation *);
+    void onContactsChanged(const Tp::Contacts &contacts, const Tp::Features &changedFeatures);
 
 private Q_SLOTS:
     void initTestCase();
@@ -52,6 +53,9 @@ private Q_SLOTS:
     void testSelfContact();
     void testForHandles();
     void testForIdentifiers();
+    void testForIdentifiersCache();
+    void testForIdentifiersBatched();
+    void testForIdentifiersFallback();
     void testFeatures();
     void testFeaturesNotRequested();
     void testUpgrade();
@@ -66,6 +70,7 @@ private:
     ConnectionPtr mConn;
     QList<ContactPtr> mContacts;
     Tp::UIntList mInvalidHandles;
+    QList<QPair<Tp::Contacts, Tp::Features> > mContactsChanged;
 };
 
 void TestContacts::expectConnReady(Tp::ConnectionStatus newStatus,
@@ -91,6 +96,12 @@ void TestContacts::expectConnReady(Tp::ConnectionStatus newStatus,
     }
 }
 
+void TestContacts::onContactsChanged(const Tp::Contacts &contacts,
+        const Tp::Features &changedFeatures)
+{
+    mContactsChanged.append(qMakePair(contacts, changedFeatures));
+}
+
 void TestContacts::expectConnInvalidated()
 {
     mLoop->exit(0);
@@ -413,6 +424,171 @@ void TestContacts::testForIdentifiers()
     processDBusQueue(mConn.data());
 }
 
+void TestContacts::testForIdentifiersCache()
+{
+    // Few enough identifiers to be looked up with GetContactByID, invalid ones included
+    QStringList ids = QStringList() << QLatin1String("Not valid") << QLatin1String("Alice")
+        << QLatin1String("bob");
+    PendingContacts *pending = mConn->contactManager()->contactsForIdentifiers(ids);
+    QVERIFY(!pending->isFinished());
+    QVERIFY(connect(pending,
+                SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(expectPendingContactsFinished(Tp::PendingOperation*))));
+    QCOMPARE(mLoop->exec(), 0);
+
+    QCOMPARE(pending->validIdentifiers(),
+            QStringList() << QLatin1String("Alice") << QLatin1String("bob"));
+    QCOMPARE(pending->invalidIdentifiers().keys(), QStringList() << QLatin1String("Not valid"));
+    QCOMPARE(mContacts.size(), 2);
+    QCOMPARE(mContacts[0]->id(), QString(QLatin1String("alice")));
+    QCOMPARE(mContacts[1]->id(), QString(QLatin1String("bob")));
+    QList<ContactPtr> contacts = mContacts;
+
+    // The contacts are alive, so asking for them again, by the normalized or by the requested
+    // identifier, is answered without a D-Bus call, in the order asked for
+    ids = QStringList() << QLatin1String("bob") << QLatin1String("alice")
+        << QLatin1String("Alice") << QLatin1String("bob");
+    pending = mConn->contactManager()->contactsForIdentifiers(ids);
+    QVERIFY(pending->isFinished());
+    QVERIFY(pending->isValid());
+    QCOMPARE(pending->validIdentifiers(), ids);
+    QVERIFY(pending->invalidIdentifiers().isEmpty());
+    QCOMPARE(pending->contacts().size(), 4);
+    QCOMPARE(pending->contacts()[0], contacts[1]);
+    QCOMPARE(pending->contacts()[1], contacts[0]);
+    QCOMPARE(pending->contacts()[2], contacts[0]);
+    QCOMPARE(pending->contacts()[3], contacts[1]);
+
+    // Unless more features are needed than the contacts have
+    pending = mConn->contactManager()->contactsForIdentifiers(ids,
+            Features() << Contact::FeatureAlias);
+    QVERIFY(!pending->isFinished());
+    QVERIFY(connect(pending,
+                SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(expectPendingContactsFinished(Tp::PendingOperation*))));
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(pending->validIdentifiers(), ids);
+    QCOMPARE(mContacts.size(), 4);
+    QCOMPARE(mContacts[0], contacts[1]);
+    QCOMPARE(mContacts[1], contacts[0]);
+    QCOMPARE(mContacts[2], contacts[0]);
+    QCOMPARE(mContacts[3], contacts[1]);
+    QVERIFY(mContacts[0]->actualFeatures().contains(Contact::FeatureAlias));
+    QVERIFY(mContacts[1]->actualFeatures().contains(Contact::FeatureAlias));
+
+    contacts.clear();
+    mContacts.clear();
+    mLoop->processEvents();
+    processDBusQueue(mConn.data());
+}
+
+void TestContacts::testForIdentifiersBatched()
+{
+    // Too many identifiers for a GetContactByID call each, so they are resolved with a single
+    // RequestHandles, which must give the same results
+    QStringList ids = QStringList() << QLatin1String("Chris") << QLatin1String("Not valid")
+        << QLatin1String("dave") << QLatin1String("Eve") << QLatin1String("chris")
+        << QLatin1String("Frank") << QLatin1String("Not valid either")
+        << QLatin1String("Gina") << QLatin1String("dave");
+    PendingContacts *pending = mConn->contactManager()->contactsForIdentifiers(ids);
+    QVERIFY(connect(pending,
+                SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(expectPendingContactsFinished(Tp::PendingOperation*))));
+    QCOMPARE(mLoop->exec(), 0);
+
+    QStringList validIds = QStringList() << QLatin1String("Chris") << QLatin1String("dave")
+        << QLatin1String("Eve") << QLatin1String("chris") << QLatin1String("Frank")
+        << QLatin1String("Gina") << QLatin1String("dave");
+    QCOMPARE(pending->validIdentifiers(), validIds);
+    QStringList invalidIds = pending->invalidIdentifiers().keys();
+    invalidIds.sort();
+    QCOMPARE(invalidIds, QStringList() << QLatin1String("Not valid")
+            << QLatin1String("Not valid either"));
+
+    QCOMPARE(mContacts.size(), validIds.size());
+    for (int i = 0; i < mContacts.size(); i++) {
+        QCOMPARE(mContacts[i]->id(), validIds[i].toLower());
+    }
+    QCOMPARE(mContacts[3], mContacts[0]);
+    QCOMPARE(mContacts[6], mContacts[1]);
+
+    // The identifiers as requested are now known as well
+    pending = mConn->contactManager()->contactsForIdentifiers(
+            QStringList() << QLatin1String("Gina") << QLatin1String("Chris"));
+    QVERIFY(pending->isFinished());
+    QCOMPARE(pending->contacts().size(), 2);
+    QCOMPARE(pending->contacts()[0], mContacts[5]);
+    QCOMPARE(pending->contacts()[1], mContacts[0]);
+
+    mContacts.clear();
+    mLoop->processEvents();
+    processDBusQueue(mConn.data());
+}
+
+void TestContacts::testForIdentifiersFallback()
+{
+    gchar *name;
+    gchar *connPath;
+    GError *error = nullptr;
+
+    // A CM which does not implement GetContactByID
+    TpTestsContactsConnection *connService = TP_TESTS_CONTACTS_CONNECTION(g_object_new(
+            TP_TESTS_TYPE_NO_CONTACT_BY_ID_CONNECTION,
+            "account", "fallback@example.com",
+            "protocol", "simple",
+            NULL));
+    QVERIFY(connService != nullptr);
+    QVERIFY(tp_base_connection_register(TP_BASE_CONNECTION(connService), "contacts", &name,
+                &connPath, &error));
+    QVERIFY(error == nullptr);
+
+    ConnectionPtr conn = Connection::create(QLatin1String(name), QLatin1String(connPath),
+            ChannelFactory::create(QDBusConnection::sessionBus()),
+            ContactFactory::create());
+    g_free(name);
+    g_free(connPath);
+
+    QVERIFY(connect(conn->lowlevel()->requestConnect(),
+                SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(expectSuccessfulCall(Tp::PendingOperation*))));
+    QCOMPARE(mLoop->exec(), 0);
+    QVERIFY(conn->hasInterface(TP_QT_IFACE_CONNECTION_INTERFACE_CONTACTS));
+
+    // The failed GetContactByID calls fall back to RequestHandles
+    QStringList ids = QStringList() << QLatin1String("Alice") << QLatin1String("Not valid")
+        << QLatin1String("bob") << QLatin1String("alice");
+    PendingContacts *pending = conn->contactManager()->contactsForIdentifiers(ids,
+            Features() << Contact::FeatureAlias);
+    QVERIFY(connect(pending,
+                SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(expectPendingContactsFinished(Tp::PendingOperation*))));
+    QCOMPARE(mLoop->exec(), 0);
+
+    QCOMPARE(pending->validIdentifiers(), QStringList() << QLatin1String("Alice")
+            << QLatin1String("bob") << QLatin1String("alice"));
+    QCOMPARE(pending->invalidIdentifiers().keys(), QStringList() << QLatin1String("Not valid"));
+    QCOMPARE(mContacts.size(), 3);
+    QCOMPARE(mContacts[0]->id(), QString(QLatin1String("alice")));
+    QCOMPARE(mContacts[1]->id(), QString(QLatin1String("bob")));
+    QCOMPARE(mContacts[2], mContacts[0]);
+    QVERIFY(mContacts[0]->actualFeatures().contains(Contact::FeatureAlias));
+    QVERIFY(mContacts[1]->actualFeatures().contains(Contact::FeatureAlias));
+    mContacts.clear();
+
+    tp_tests_simple_connection_inject_disconnect(TP_TESTS_SIMPLE_CONNECTION(connService));
+
+    if (conn->isValid()) {
+        QVERIFY(connect(conn.data(),
+                    SIGNAL(invalidated(Tp::DBusProxy *,
+                            const QString &, const QString &)),
+                    mLoop,
+                    SLOT(quit())));
+        QCOMPARE(mLoop->exec(), 0);
+    }
+
+    g_object_unref(connService);
+}
+
 void TestContacts::testFeatures()
 {
     QStringList ids = QStringList() << QLatin1String("alice")
@@ -515,7 +691,15 @@ void TestContacts::testFeatures()
     QCOMPARE(mContacts[1]->presence().type(), Tp::ConnectionPresenceTypeBusy);
     QCOMPARE(mContacts[2]->presence().type(), Tp::ConnectionPresenceTypeAway);
 
-    // Change some of the contacts to a new set of attributes
+    // Change some of the contacts to a new set of attributes, with the per-contact signals
+    // disabled so that only the batched ones are emitted
+    mContactsChanged.clear();
+    QVERIFY(connect(mConn->contactManager().data(),
+                SIGNAL(contactsChanged(Tp::Contacts,Tp::Features)),
+                SLOT(onContactsChanged(Tp::Contacts,Tp::Features))));
+    QSignalSpy aliasChangedSpy(mContacts[0].data(), SIGNAL(aliasChanged(QString)));
+    mConn->contactManager()->setContactSignalsEnabled(false);
+
     tp_tests_contacts_connection_change_aliases(mConnService, 2, handles.toVector().constData(),
             latterAliases);
     tp_tests_contacts_connection_change_avatar_tokens(mConnService, 2, handles.toVector().constData(),
@@ -525,6 +709,20 @@ void TestContacts::testFeatures()
     mLoop->processEvents();
     processDBusQueue(mConn.data());
 
+    mConn->contactManager()->setContactSignalsEnabled(true);
+    disconnect(mConn->contactManager().data(),
+            SIGNAL(contactsChanged(Tp::Contacts,Tp::Features)),
+            this,
+            SLOT(onContactsChanged(Tp::Contacts,Tp::Features)));
+
+    QCOMPARE(aliasChangedSpy.count(), 0);
+    Contacts changedContacts = Contacts() << mContacts[0] << mContacts[1];
+    QCOMPARE(mContactsChanged.size(), 2);
+    QCOMPARE(mContactsChanged[0].first, changedContacts);
+    QCOMPARE(mContactsChanged[0].second, Features(Contact::FeatureAlias));
+    QCOMPARE(mContactsChanged[1].first, changedContacts);
+    QCOMPARE(mContactsChanged[1].second, Features(Contact::FeatureSimplePresence));
+
     // Check that the attributes were updated in the Contact objects
     for (int i = 0; i < 3; i++) {
         QCOMPARE(mContacts[i]->handle()[0], handles[i]);
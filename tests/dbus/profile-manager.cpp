@@ -13,6 +13,7 @@ class TestProfileManager : public Test
 
 private Q_SLOTS:
     void testProfileManager();
+    void testProfileCache();
 };
 
 void TestProfileManager::testProfileManager()
@@ -81,6 +82,33 @@ void TestProfileManager::testProfileManager()
     mLoop->processEvents();
 }
 
+void TestProfileManager::testProfileCache()
+{
+    ProfileManagerPtr first = ProfileManager::create(QDBusConnection::sessionBus());
+    ProfileManagerPtr second = ProfileManager::create(QDBusConnection::sessionBus());
+    QVERIFY(connect(first->becomeReady(),
+                    SIGNAL(finished(Tp::PendingOperation *)),
+                    SLOT(expectSuccessfulCall(Tp::PendingOperation *))));
+    QCOMPARE(mLoop->exec(), 0);
+    QVERIFY(connect(second->becomeReady(),
+                    SIGNAL(finished(Tp::PendingOperation *)),
+                    SLOT(expectSuccessfulCall(Tp::PendingOperation *))));
+    QCOMPARE(mLoop->exec(), 0);
+
+    // unchanged profile files are parsed only once per process
+    QCOMPARE(second->profiles().count(), first->profiles().count());
+    QCOMPARE(second->profileForService(QLatin1String("test-profile")),
+             first->profileForService(QLatin1String("test-profile")));
+
+    // a manager going away while its profiles are loaded must not crash
+    ProfileManagerPtr third = ProfileManager::create(QDBusConnection::sessionBus());
+    third->becomeReady();
+    third.reset();
+    QTest::qWait(100);
+
+    mLoop->processEvents();
+}
+
 QTEST_MAIN(TestProfileManager)
 
 #include "_gen/profile-manager.cpp.moc.hpp"
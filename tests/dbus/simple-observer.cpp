@@ -142,7 +142,8 @@ class TestSimpleObserver : public Test
 public:
     TestSimpleObserver(QObject *parent = nullptr)
         : Test(parent),
-          mChannelsCount(0), mSMChannelsCount(0)
+          mChannelsCount(0), mSMChannelsCount(0),
+          mBatchedMessagesCount(0), mMisalignedBatches(0), mDroppingTextObserverMessages(0)
     {
         std::memset(mMessagesChanServices, 0, sizeof(mMessagesChanServices));
         std::memset(mCallableChanServices, 0, sizeof(mCallableChanServices));
@@ -157,12 +158,19 @@ protected Q_SLOTS:
     void onObserverStreamedMediaCallEnded(
             const Tp::StreamedMediaChannelPtr &channel,
             const QString &errorMessage, const QString &errorName);
+    void onTextObserverMessageReceived(const Tp::ReceivedMessage &message,
+            const Tp::TextChannelPtr &channel);
+    void onTextObserverMessagesReceived(const QList<Tp::ReceivedMessage> &messages,
+            const Tp::TextChannelPtr &channel);
+    void onDroppingTextObserverMessageReceived(const Tp::ReceivedMessage &message,
+            const Tp::TextChannelPtr &channel);
 
 private Q_SLOTS:
     void initTestCase();
     void init();
 
     void testObserverRegistration();
+    void testTextMessagesReceived();
     void testCrossTalk();
 
     void cleanup();
@@ -196,6 +204,13 @@ private:
 
     int mChannelsCount;
     int mSMChannelsCount;
+
+    QList<ReceivedMessage> mReceivedMessages;
+    QList<QList<ReceivedMessage> > mReceivedBatches;
+    int mBatchedMessagesCount;
+    int mMisalignedBatches;
+    SimpleTextObserverPtr mDroppingTextObserver;
+    int mDroppingTextObserverMessages;
 };
 
 void TestSimpleObserver::onObserverNewChannels(const QList<Tp::ChannelPtr> &channels)
@@ -225,6 +240,37 @@ void TestSimpleObserver::onObserverStreamedMediaCallEnded(const Tp::StreamedMedi
     mSMChannelsCount--;
 }
 
+void TestSimpleObserver::onTextObserverMessageReceived(const Tp::ReceivedMessage &message,
+        const Tp::TextChannelPtr &channel)
+{
+    QVERIFY(!channel.isNull());
+    mReceivedMessages.append(message);
+}
+
+void TestSimpleObserver::onTextObserverMessagesReceived(const QList<Tp::ReceivedMessage> &messages,
+        const Tp::TextChannelPtr &channel)
+{
+    QVERIFY(!channel.isNull());
+
+    // Each batch comes right after the per-message signals for all of its messages
+    mBatchedMessagesCount += messages.size();
+    if (mReceivedMessages.size() != mBatchedMessagesCount) {
+        ++mMisalignedBatches;
+    }
+    mReceivedBatches.append(messages);
+}
+
+void TestSimpleObserver::onDroppingTextObserverMessageReceived(const Tp::ReceivedMessage &message,
+        const Tp::TextChannelPtr &channel)
+{
+    Q_UNUSED(message);
+    Q_UNUSED(channel);
+
+    // Deleting the observer from its own signal must stop the remaining emissions
+    ++mDroppingTextObserverMessages;
+    mDroppingTextObserver.reset();
+}
+
 void TestSimpleObserver::initTestCase()
 {
     initTestCaseImpl();
@@ -478,6 +524,83 @@ void TestSimpleObserver::testObserverRegistration()
     QVERIFY(ourObservers().isEmpty());
 }
 
+void TestSimpleObserver::testTextMessagesReceived()
+{
+    mReceivedMessages.clear();
+    mReceivedBatches.clear();
+    mBatchedMessagesCount = 0;
+    mMisalignedBatches = 0;
+    mDroppingTextObserverMessages = 0;
+
+    SimpleTextObserverPtr textObserver = SimpleTextObserver::create(mAccounts[0], mContacts[0]);
+    QVERIFY(connect(textObserver.data(),
+                    SIGNAL(messageReceived(Tp::ReceivedMessage,Tp::TextChannelPtr)),
+                    SLOT(onTextObserverMessageReceived(Tp::ReceivedMessage,Tp::TextChannelPtr))));
+    QVERIFY(connect(textObserver.data(),
+                    SIGNAL(messagesReceived(QList<Tp::ReceivedMessage>,Tp::TextChannelPtr)),
+                    SLOT(onTextObserverMessagesReceived(QList<Tp::ReceivedMessage>,Tp::TextChannelPtr))));
+
+    mDroppingTextObserver = SimpleTextObserver::create(mAccounts[0], mContacts[0]);
+    QVERIFY(connect(mDroppingTextObserver.data(),
+                    SIGNAL(messageReceived(Tp::ReceivedMessage,Tp::TextChannelPtr)),
+                    SLOT(onDroppingTextObserverMessageReceived(Tp::ReceivedMessage,Tp::TextChannelPtr))));
+
+    QMap<QString, QString> ourObserversMap = ourObservers();
+    QCOMPARE(ourObserversMap.size(), 1);
+    ClientObserverInterface *observerIface = new ClientObserverInterface(
+            ourObserversMap.constBegin().key(), ourObserversMap.constBegin().value(), this);
+    ChannelDetails textChan = {
+        QDBusObjectPath(mTextChans[0]->objectPath()),
+        mTextChans[0]->immutableProperties()
+    };
+    observerIface->ObserveChannels(
+            QDBusObjectPath(mAccounts[0]->objectPath()),
+            QDBusObjectPath(mTextChans[0]->connection()->objectPath()),
+            ChannelDetailsList() << textChan,
+            QDBusObjectPath(QLatin1String("/")),
+            Tp::ObjectPathList(),
+            QVariantMap());
+
+    while (textObserver->textChats().isEmpty()) {
+        mLoop->processEvents();
+    }
+
+    // The echo channel sends every message back to us
+    QStringList texts;
+    texts << QLatin1String("first") << QLatin1String("second") << QLatin1String("third");
+    Q_FOREACH (const QString &text, texts) {
+        QVERIFY(connect(mTextChans[0]->send(text),
+                        SIGNAL(finished(Tp::PendingOperation*)),
+                        SLOT(expectSuccessfulCall(Tp::PendingOperation*))));
+        QCOMPARE(mLoop->exec(), 0);
+    }
+
+    while (mBatchedMessagesCount < texts.size()) {
+        mLoop->processEvents();
+    }
+
+    QCOMPARE(mMisalignedBatches, 0);
+    QCOMPARE(mReceivedMessages.size(), texts.size());
+
+    QList<ReceivedMessage> batched;
+    Q_FOREACH (const QList<ReceivedMessage> &batch, mReceivedBatches) {
+        QVERIFY(!batch.isEmpty());
+        batched << batch;
+    }
+    QCOMPARE(batched.size(), mReceivedMessages.size());
+    for (int i = 0; i < batched.size(); ++i) {
+        QCOMPARE(batched[i].text(), texts[i]);
+        QCOMPARE(mReceivedMessages[i].text(), texts[i]);
+    }
+
+    // The observer which deleted itself on its first message got nothing after that
+    QVERIFY(mDroppingTextObserver.isNull());
+    QCOMPARE(mDroppingTextObserverMessages, 1);
+
+    textObserver.reset();
+    QVERIFY(ourObservers().isEmpty());
+}
+
 void TestSimpleObserver::testCrossTalk()
 {
     SimpleObserverPtr observers[2];
@@ -27,6 +27,7 @@
 #include <TelepathyQt/Debug>
 #include <TelepathyQt/Types>
 #include <TelepathyQt/DBus>
+#include <TelepathyQt/PendingString>
 #include <TelepathyQt/StatefulDBusProxy>
 
 #include "tests/lib/test.h"
@@ -73,6 +74,9 @@ private Q_SLOTS:
 
     void testBasics();
     void testNameOwnerChanged();
+    void testSharedNameOwner();
+    void testUniqueNameFromAsync();
+    void testRecreatedConnection();
 
     void cleanup();
     void cleanupTestCase();
@@ -293,6 +297,119 @@ void TestStatefulProxy::testNameOwnerChanged()
     QCOMPARE(mProxy->invalidationMessage(), mSignalledInvalidationMessage);
 }
 
+void TestStatefulProxy::testSharedNameOwner()
+{
+    QString otherUniqueName = QDBusConnection::connectToBus(
+            QDBusConnection::SessionBus,
+            QLatin1String("yet another unique name")).baseService();
+
+    // both proxies are served by the same name owner tracking
+    mProxy = new MyStatefulDBusProxy(QDBusConnection::sessionBus(),
+            otherUniqueName, objectPath());
+    MyStatefulDBusProxy *otherProxy = new MyStatefulDBusProxy(QDBusConnection::sessionBus(),
+            otherUniqueName, objectPath());
+    QVERIFY(mProxy->isValid());
+    QVERIFY(otherProxy->isValid());
+
+    // a destroyed proxy must not be notified
+    MyStatefulDBusProxy *deletedProxy = new MyStatefulDBusProxy(QDBusConnection::sessionBus(),
+            otherUniqueName, objectPath());
+    delete deletedProxy;
+
+    QVERIFY(connect(mProxy, SIGNAL(invalidated(
+                        Tp::DBusProxy *,
+                        const QString &, const QString &)),
+                this, SLOT(expectInvalidated(
+                        Tp::DBusProxy *,
+                        const QString &, const QString &))));
+    QVERIFY(connect(otherProxy, SIGNAL(invalidated(
+                        Tp::DBusProxy *,
+                        const QString &, const QString &)),
+                this, SLOT(expectInvalidated(
+                        Tp::DBusProxy *,
+                        const QString &, const QString &))));
+    QDBusConnection::disconnectFromBus(QLatin1String("yet another unique name"));
+    while (mInvalidated < 2) {
+        QCOMPARE(mLoop->exec(), EXPECT_INVALIDATED_SUCCESS);
+    }
+
+    QCOMPARE(mInvalidated, 2);
+    QVERIFY(!mProxy->isValid());
+    QVERIFY(!otherProxy->isValid());
+    QCOMPARE(otherProxy->invalidationReason(),
+            TP_QT_DBUS_ERROR_NAME_HAS_NO_OWNER);
+
+    delete otherProxy;
+}
+
+void TestStatefulProxy::testUniqueNameFromAsync()
+{
+    PendingString *ps = StatefulDBusProxy::uniqueNameFromAsync(QDBusConnection::sessionBus(),
+            wellKnownName());
+    QVERIFY(connect(ps, SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(expectSuccessfulCall(Tp::PendingOperation*))));
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(ps->result(), uniqueName());
+
+    // with a proxy bound to the name, the owner is served from the cache
+    mProxy = new MyStatefulDBusProxy(QDBusConnection::sessionBus(),
+            wellKnownName(), objectPath());
+    ps = StatefulDBusProxy::uniqueNameFromAsync(QDBusConnection::sessionBus(),
+            wellKnownName());
+    QVERIFY(connect(ps, SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(expectSuccessfulCall(Tp::PendingOperation*))));
+    QCOMPARE(mLoop->exec(), 0);
+    QCOMPARE(ps->result(), uniqueName());
+    QCOMPARE(StatefulDBusProxy::uniqueNameFrom(QDBusConnection::sessionBus(), wellKnownName()),
+            uniqueName());
+
+    ps = StatefulDBusProxy::uniqueNameFromAsync(QDBusConnection::sessionBus(),
+            QLatin1String("org.freedesktop.Telepathy.Qt.TestStatefulProxy.NoSuchName"));
+    QVERIFY(connect(ps, SIGNAL(finished(Tp::PendingOperation*)),
+                SLOT(expectFailure(Tp::PendingOperation*))));
+    QCOMPARE(mLoop->exec(), 0);
+}
+
+void TestStatefulProxy::testRecreatedConnection()
+{
+    QString ownerName = QDBusConnection::connectToBus(
+            QDBusConnection::SessionBus,
+            QLatin1String("recreated connection owner")).baseService();
+
+    // a proxy on a named connection, which is then disconnected
+    QDBusConnection bus = QDBusConnection::connectToBus(QDBusConnection::SessionBus,
+            QLatin1String("recreated connection"));
+    MyStatefulDBusProxy *oldProxy = new MyStatefulDBusProxy(bus, ownerName, objectPath());
+    QVERIFY(oldProxy->isValid());
+    QDBusConnection::disconnectFromBus(QLatin1String("recreated connection"));
+
+    // a proxy on a new connection of the same name must watch the name on the
+    // new connection, not on the one which went away
+    bus = QDBusConnection::connectToBus(QDBusConnection::SessionBus,
+            QLatin1String("recreated connection"));
+    QVERIFY(bus.isConnected());
+    mProxy = new MyStatefulDBusProxy(bus, ownerName, objectPath());
+    QVERIFY(mProxy->isValid());
+    delete oldProxy;
+
+    QVERIFY(connect(mProxy, SIGNAL(invalidated(
+                        Tp::DBusProxy *,
+                        const QString &, const QString &)),
+                this, SLOT(expectInvalidated(
+                        Tp::DBusProxy *,
+                        const QString &, const QString &))));
+    QDBusConnection::disconnectFromBus(QLatin1String("recreated connection owner"));
+    QCOMPARE(mLoop->exec(), EXPECT_INVALIDATED_SUCCESS);
+
+    QCOMPARE(mInvalidated, 1);
+    QVERIFY(!mProxy->isValid());
+    QCOMPARE(mProxy->invalidationReason(), TP_QT_DBUS_ERROR_NAME_HAS_NO_OWNER);
+
+    delete mProxy;
+    mProxy = nullptr;
+    QDBusConnection::disconnectFromBus(QLatin1String("recreated connection"));
+}
+
 void TestStatefulProxy::cleanup()
 {
     if (mProxy) {
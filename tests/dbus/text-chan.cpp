@@ -45,6 +45,7 @@ public:
 
 protected Q_SLOTS:
     void onMessageReceived(const Tp::ReceivedMessage &);
+    void onMessagesReceived(const QList<Tp::ReceivedMessage> &);
     void onMessageRemoved(const Tp::ReceivedMessage &);
     void onMessageSent(const Tp::Message &,
             Tp::MessageSendingFlags, const QString &);
@@ -75,6 +76,7 @@ private:
     QString mMessagesChanPath;
     QList<SentMessageDetails> sent;
     QList<ReceivedMessage> received;
+    QList<ReceivedMessage> receivedBatched;
     QList<ReceivedMessage> removed;
     bool mGotChatStateChanged;
     ContactPtr mChatStateChangedContact;
@@ -88,6 +90,14 @@ void TestTextChan::onMessageReceived(const ReceivedMessage &message)
     mLoop->exit(0);
 }
 
+void TestTextChan::onMessagesReceived(const QList<ReceivedMessage> &messages)
+{
+    qDebug() << "messages received:" << messages.size();
+    // messageReceived() has already been emitted for each of them
+    QVERIFY(received.size() >= receivedBatched.size() + messages.size());
+    receivedBatched << messages;
+}
+
 void TestTextChan::onMessageRemoved(const ReceivedMessage &message)
 {
     qDebug() << "message removed";
@@ -248,6 +258,9 @@ void TestTextChan::commonTest(bool withMessages)
                 SIGNAL(messageReceived(const Tp::ReceivedMessage &)),
                 SLOT(onMessageReceived(const Tp::ReceivedMessage &))));
     QCOMPARE(received.size(), 0);
+    QVERIFY(connect(mChan.data(),
+                SIGNAL(messagesReceived(const QList<Tp::ReceivedMessage> &)),
+                SLOT(onMessagesReceived(const QList<Tp::ReceivedMessage> &))));
     QVERIFY(connect(mChan.data(),
                 SIGNAL(pendingMessageRemoved(const Tp::ReceivedMessage &)),
                 SLOT(onMessageRemoved(const Tp::ReceivedMessage &))));
@@ -364,6 +377,7 @@ void TestTextChan::commonTest(bool withMessages)
         QCOMPARE(mLoop->exec(), 0);
     }
     QCOMPARE(received.size(), 2);
+    QVERIFY(receivedBatched == received);
     QCOMPARE(mChan->messageQueue().size(), 2);
     QVERIFY(mChan->messageQueue().at(0) == received.at(0));
     QVERIFY(mChan->messageQueue().at(1) == received.at(1));
@@ -537,6 +551,7 @@ void TestTextChan::testLegacyText()
 void TestTextChan::cleanup()
 {
     received.clear();
+    receivedBatched.clear();
     removed.clear();
     sent.clear();
 
@@ -0,0 +1,125 @@
+#include <QtTest/QtTest>
+
+// Have TP_QT_DEBUG() below report to the contacts category, as the contact handling
+// sources of the library do
+#define TP_QT_DEBUG_CATEGORY Tp::DebugCategoryContacts
+
+#include <TelepathyQt/Debug>
+#include <TelepathyQt/debug-internal.h>
+
+using namespace Tp;
+
+namespace {
+
+QStringList messages;
+int evaluations = 0;
+
+void collectMessage(const QString &libraryName, const QString &libraryVersion,
+        QtMsgType type, const QString &msg)
+{
+    Q_UNUSED(libraryName);
+    Q_UNUSED(libraryVersion);
+    Q_UNUSED(type);
+
+    messages << msg;
+}
+
+QString evaluated(const char *text)
+{
+    ++evaluations;
+    return QLatin1String(text);
+}
+
+}
+
+class TestDebugCategories : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestDebugCategories(QObject *parent = nullptr);
+
+private Q_SLOTS:
+    void init();
+
+    void testCategories();
+    void testEnableAll();
+
+    void cleanup();
+};
+
+TestDebugCategories::TestDebugCategories(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void TestDebugCategories::init()
+{
+    messages.clear();
+    evaluations = 0;
+    setDebugCallback(collectMessage);
+    enableDebug(false);
+}
+
+void TestDebugCategories::testCategories()
+{
+#ifndef ENABLE_DEBUG
+    QSKIP("The library is built without debug output");
+#endif
+
+    QCOMPARE(enabledDebugCategories(), DebugCategories());
+
+    // Another category does not enable the contacts one, and what would have
+    // been printed is not even evaluated
+    enableDebug(DebugCategoryChannels | DebugCategoryRoster, true);
+    QCOMPARE(enabledDebugCategories(), DebugCategoryChannels | DebugCategoryRoster);
+    QVERIFY(!isDebugEnabled(DebugCategoryContacts));
+    TP_QT_DEBUG() << evaluated("filtered");
+    QCOMPARE(messages, QStringList());
+    QCOMPARE(evaluations, 0);
+
+    enableDebug(DebugCategoryContacts, true);
+    QVERIFY(isDebugEnabled(DebugCategoryContacts));
+    TP_QT_DEBUG() << evaluated("enabled");
+    QCOMPARE(messages.size(), 1);
+    QVERIFY(messages.first().contains(QLatin1String("enabled")));
+    QCOMPARE(evaluations, 1);
+
+    // Disabling a category leaves the others as they are
+    enableDebug(DebugCategoryContacts, false);
+    QCOMPARE(enabledDebugCategories(), DebugCategoryChannels | DebugCategoryRoster);
+    TP_QT_DEBUG() << evaluated("filtered again");
+    QCOMPARE(messages.size(), 1);
+    QCOMPARE(evaluations, 1);
+
+    // Warnings are not categorized
+    TP_QT_WARNING() << "warning";
+    QCOMPARE(messages.size(), 2);
+}
+
+void TestDebugCategories::testEnableAll()
+{
+#ifndef ENABLE_DEBUG
+    QSKIP("The library is built without debug output");
+#endif
+
+    enableDebug(true);
+    QCOMPARE(enabledDebugCategories(), DebugCategories(DebugCategoryAll));
+    TP_QT_DEBUG() << "all";
+    QCOMPARE(messages.size(), 1);
+
+    enableDebug(false);
+    QCOMPARE(enabledDebugCategories(), DebugCategories());
+    TP_QT_DEBUG() << "none";
+    QCOMPARE(messages.size(), 1);
+}
+
+void TestDebugCategories::cleanup()
+{
+    enableDebug(false);
+    setDebugCallback(nullptr);
+}
+
+QTEST_MAIN(TestDebugCategories)
+
+#include "_gen/debug-categories.cpp.moc.hpp"
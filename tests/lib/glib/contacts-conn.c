@@ -1422,3 +1422,41 @@ tp_tests_no_requests_connection_class_init (
 
   base_class->interfaces_always_present = interfaces_always_present;
 }
+
+/* ============== No GetContactByID, like an older CM ===================== */
+
+static void
+no_contact_by_id_contacts_iface_init (gpointer g_iface,
+    gpointer iface_data)
+{
+  tp_contacts_mixin_iface_init (g_iface, iface_data);
+
+  /* telepathy-glib before 0.20 doesn't know about GetContactByID at all, so
+   * calling it fails with UnknownMethod; with later versions, leaving it
+   * unimplemented makes it fail with NotImplemented */
+#ifdef TP_CHECK_VERSION
+#if TP_CHECK_VERSION (0, 20, 0)
+  tp_svc_connection_interface_contacts_implement_get_contact_by_id (
+      (TpSvcConnectionInterfaceContactsClass *) g_iface, NULL);
+#endif
+#endif
+}
+
+G_DEFINE_TYPE_WITH_CODE (TpTestsNoContactByIdConnection,
+    tp_tests_no_contact_by_id_connection,
+    TP_TESTS_TYPE_CONTACTS_CONNECTION,
+    G_IMPLEMENT_INTERFACE (TP_TYPE_SVC_CONNECTION_INTERFACE_CONTACTS,
+      no_contact_by_id_contacts_iface_init);
+    );
+
+static void
+tp_tests_no_contact_by_id_connection_init (
+    TpTestsNoContactByIdConnection *self)
+{
+}
+
+static void
+tp_tests_no_contact_by_id_connection_class_init (
+    TpTestsNoContactByIdConnectionClass *klass)
+{
+}
@@ -189,6 +189,43 @@ GType tp_tests_no_requests_connection_get_type (void);
   (G_TYPE_INSTANCE_GET_CLASS ((obj), TP_TESTS_TYPE_NO_REQUESTS_CONNECTION, \
                               TpTestsNoRequestsConnectionClass))
 
+/* No GetContactByID version */
+
+typedef struct _TpTestsNoContactByIdConnection TpTestsNoContactByIdConnection;
+typedef struct _TpTestsNoContactByIdConnectionClass
+  TpTestsNoContactByIdConnectionClass;
+typedef struct _TpTestsNoContactByIdConnectionPrivate
+  TpTestsNoContactByIdConnectionPrivate;
+
+struct _TpTestsNoContactByIdConnectionClass {
+    TpTestsContactsConnectionClass parent_class;
+};
+
+struct _TpTestsNoContactByIdConnection {
+    TpTestsContactsConnection parent;
+
+    TpTestsNoContactByIdConnectionPrivate *priv;
+};
+
+GType tp_tests_no_contact_by_id_connection_get_type (void);
+
+/* TYPE MACROS */
+#define TP_TESTS_TYPE_NO_CONTACT_BY_ID_CONNECTION \
+  (tp_tests_no_contact_by_id_connection_get_type ())
+#define TP_TESTS_NO_CONTACT_BY_ID_CONNECTION(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj), TP_TESTS_TYPE_NO_CONTACT_BY_ID_CONNECTION, \
+                              TpTestsNoContactByIdConnection))
+#define TP_TESTS_NO_CONTACT_BY_ID_CONNECTION_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass), TP_TESTS_TYPE_NO_CONTACT_BY_ID_CONNECTION, \
+                           TpTestsNoContactByIdConnectionClass))
+#define TP_TESTS_NO_CONTACT_BY_ID_IS_CONNECTION(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj), TP_TESTS_TYPE_NO_CONTACT_BY_ID_CONNECTION))
+#define TP_TESTS_NO_CONTACT_BY_ID_IS_CONNECTION_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass), TP_TESTS_TYPE_NO_CONTACT_BY_ID_CONNECTION))
+#define TP_TESTS_NO_CONTACT_BY_ID_CONNECTION_GET_CLASS(obj) \
+  (G_TYPE_INSTANCE_GET_CLASS ((obj), TP_TESTS_TYPE_NO_CONTACT_BY_ID_CONNECTION, \
+                              TpTestsNoContactByIdConnectionClass))
+
 G_END_DECLS
 
 #endif /* ifndef __TP_TESTS_CONTACTS_CONN_H__ */